@@ -0,0 +1,188 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_audio.hpp"
+
+#include <random>
+
+// The fixed-point audio kernels of neon_sim_audio.hpp against their scalar
+// twins, with each frame size taken as a sample count:
+//   resample  48 -> 44.1 kHz polyphase FIR, 147 / 160, 32 taps per phase
+//   biquad16  4 stage Q15 cascade on 8 interleaved channels
+//   biquad32  the same in Q31
+//   mix       4 sources with Q15 gains
+// Outputs must match the twins bit for bit. Ends with Msamples/s per case
+// and, for the NEON rows, a projection for a device: the instructions the
+// inner loop issues per sample (counted from the loop, vget_low/high free)
+// against --ghz x --ipc 128 bit operations per second. That is an upper
+// bound that ignores latency chains, which bind the biquads on real cores.
+
+namespace audio = neon_sim_kernels::audio;
+
+static const int kChannels = 8;
+static const int kStages = 4;
+static const int kSources = 4;
+
+template<typename T>
+static std::vector<T> noise(size_t n, unsigned seed)
+{
+    std::vector<T> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (T)(rng() >> 2); // -12 dBFS
+    }
+    return v;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double msamples;
+        double ops_per_sample; // 0 for the scalar twins
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    std::vector<int16_t> taps(147 * 32);
+    for (size_t i = 0; i < taps.size(); i++)
+    {
+        const int d = 2 * (int)i - (int)taps.size() + 1;
+        taps[i] = (int16_t)(30000 / (1 + d * d / 25600));
+    }
+    const audio::PolyphaseQ15 fir = audio::make_polyphase_q15(taps.data(), (int)taps.size(), 147, 160);
+    const audio::BiquadQ15 bq16[kStages] = {
+        { 4096, 8192, 4096, -23170, 9830 },
+        { 15000, -30000, 15000, -29000, 13500 },
+        { 16384, -26000, 16000, -26000, 16000 },
+        { 8000, 0, -8000, -20000, 12000 },
+    };
+    audio::BiquadQ31 bq32[kStages];
+    for (int s = 0; s < kStages; s++)
+    {
+        bq32[s] = { bq16[s].b0 * 65536, bq16[s].b1 * 65536, bq16[s].b2 * 65536, bq16[s].a1 * 65536, bq16[s].a2 * 65536 };
+    }
+    const int16_t gains[kSources] = { 16384, 12000, -8000, 20000 };
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height;
+        auto report = [&](const char* name, double ms_ref, double ms_neon, size_t count, double ops) {
+            const BenchSize counted = { size.name, (int)count, 1 };
+            bench_report(name, "ref", counted, ms_ref);
+            bench_report(name, "neon", counted, ms_neon);
+            rates.push_back({ name, "ref", size.name, count / (ms_ref * 1e3), 0 });
+            rates.push_back({ name, "neon", size.name, count / (ms_neon * 1e3), ops });
+        };
+
+        if (bench_selected(opt, "resample"))
+        {
+            const size_t hist = audio::polyphase_history(fir);
+            const std::vector<int16_t> in = noise<int16_t>(hist + n, 1);
+            std::vector<int16_t> expected(audio::resample_output_size(fir, n)), actual(expected.size());
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                audio::ref::fir_resample_q15(fir, in.data() + hist, n, expected.data());
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                audio::fir_resample_q15(fir, in.data() + hist, n, actual.data());
+            });
+            // per output: 2 x (ld1, ld1, sqdmlal, sqdmlal2) per 8 taps; movi, saddlp, addp, round, store
+            report("resample", ms_ref, ms_neon, expected.size(), fir.taps_per_phase / 2.0 + 5);
+            ok = ok && expected == actual;
+        }
+        if (bench_selected(opt, "biquad16"))
+        {
+            const size_t frames = n / kChannels;
+            const std::vector<int16_t> in = noise<int16_t>(frames * kChannels, 2);
+            std::vector<int16_t> expected(in.size()), actual(in.size());
+            std::vector<int16_t> state(audio::biquad_state_size(kStages, kChannels));
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                std::fill(state.begin(), state.end(), 0);
+                audio::ref::biquad_cascade_q15(bq16, kStages, state.data(), in.data(), expected.data(), frames, kChannels);
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                std::fill(state.begin(), state.end(), 0);
+                audio::biquad_cascade_q15(bq16, kStages, state.data(), in.data(), actual.data(), frames, kChannels);
+            });
+            // per 4 channels and stage: 4 ld1, 5 dup, 5 sqdml*, sqrshrn, 4 st1; ld1 + st1 per frame
+            report("biquad16", ms_ref, ms_neon, in.size(), (19.0 * kStages + 2) / 4);
+            ok = ok && expected == actual;
+        }
+        if (bench_selected(opt, "biquad32"))
+        {
+            const size_t frames = n / kChannels;
+            const std::vector<int32_t> in = noise<int32_t>(frames * kChannels, 3);
+            std::vector<int32_t> expected(in.size()), actual(in.size());
+            std::vector<int32_t> state(audio::biquad_state_size(kStages, kChannels));
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                std::fill(state.begin(), state.end(), 0);
+                audio::ref::biquad_cascade_q31(bq32, kStages, state.data(), in.data(), expected.data(), frames, kChannels);
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                std::fill(state.begin(), state.end(), 0);
+                audio::biquad_cascade_q31(bq32, kStages, state.data(), in.data(), actual.data(), frames, kChannels);
+            });
+            // as biquad16 with both halves: 10 sqdml*, 2 sqrshrn
+            report("biquad32", ms_ref, ms_neon, in.size(), (25.0 * kStages + 2) / 4);
+            ok = ok && expected == actual;
+        }
+        if (bench_selected(opt, "mix"))
+        {
+            std::vector<std::vector<int16_t> > in;
+            std::vector<const int16_t*> srcs;
+            in.reserve(kSources);
+            for (int s = 0; s < kSources; s++)
+            {
+                in.push_back(noise<int16_t>(n, 4 + s));
+                srcs.push_back(in.back().data());
+            }
+            std::vector<int16_t> expected(n), actual(n);
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                audio::ref::mix_q15(srcs.data(), gains, kSources, expected.data(), n);
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                audio::mix_q15(srcs.data(), gains, kSources, actual.data(), n);
+            });
+            // per 8 samples: ld1, sqrdmulh, sqadd per source; movi, st1
+            report("mix", ms_ref, ms_neon, n, (3.0 * kSources + 2) / 8);
+            ok = ok && expected == actual;
+        }
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "a NEON kernel does not match its scalar twin\n");
+    }
+
+    printf("\n%-16s %-8s %-10s %10s %10s %14s\n", "benchmark", "impl", "size", "Msamples/s", "ops/sample",
+           "projected");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        const Rate& r = rates[i];
+        if (r.ops_per_sample > 0)
+        {
+            printf("%-16s %-8s %-10s %10.3f %10.2f %14.1f\n", r.name, r.impl, r.size, r.msamples, r.ops_per_sample,
+                   opt.ghz * 1e3 * opt.ipc / r.ops_per_sample);
+        }
+        else
+        {
+            printf("%-16s %-8s %-10s %10.3f\n", r.name, r.impl, r.size, r.msamples);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,533 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+
+#include <random>
+
+// AES-128-CTR, SHA-256 and SHA-1 with the crypto extension intrinsics against
+// plain scalar code. Each frame size is taken as a byte count; every case
+// checks a known-answer vector before timing and compares the two outputs
+// after. Ends with GB/s per case. The intrinsics run on AES-NI and SHA-NI when
+// built with -DNEON_SIM_CRYPTO_NI=ON.
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+static uint32_t load_be32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t rol32(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+static uint32_t ror32(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+//----- AES-128-CTR
+
+static uint8_t aes_sbox[256];
+
+static uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0;
+    for (; b; b >>= 1)
+    {
+        if (b & 1)
+        {
+            r ^= a;
+        }
+        a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+    }
+    return r;
+}
+
+// multiplicative inverse followed by the FIPS-197 affine map
+static void init_aes_sbox()
+{
+    for (int x = 0; x < 256; x++)
+    {
+        uint8_t inv = 0;
+        for (int y = 1; y < 256 && x; y++)
+        {
+            if (gf_mul((uint8_t)x, (uint8_t)y) == 1)
+            {
+                inv = (uint8_t)y;
+                break;
+            }
+        }
+        uint8_t s = inv;
+        for (int k = 1; k < 5; k++)
+        {
+            s ^= (uint8_t)((inv << k) | (inv >> (8 - k)));
+        }
+        aes_sbox[x] = s ^ 0x63;
+    }
+}
+
+static void aes128_expand_key(const uint8_t key[16], uint8_t rk[176])
+{
+    uint8_t rcon = 1;
+    memcpy(rk, key, 16);
+    for (int i = 16; i < 176; i += 4)
+    {
+        uint8_t t[4] = { rk[i - 4], rk[i - 3], rk[i - 2], rk[i - 1] };
+        if (i % 16 == 0)
+        {
+            const uint8_t t0 = t[0];
+            t[0] = aes_sbox[t[1]] ^ rcon;
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[t0];
+            rcon = gf_mul(rcon, 2);
+        }
+        for (int b = 0; b < 4; b++)
+        {
+            rk[i + b] = rk[i - 16 + b] ^ t[b];
+        }
+    }
+}
+
+static void aes128_encrypt_scalar(const uint8_t rk[176], const uint8_t in[16], uint8_t out[16])
+{
+    uint8_t s[16];
+    for (int b = 0; b < 16; b++)
+    {
+        s[b] = in[b] ^ rk[b];
+    }
+    for (int round = 1; round <= 10; round++)
+    {
+        uint8_t t[16];
+        for (int b = 0; b < 16; b++)
+        {
+            t[b] = aes_sbox[s[(b + 4 * (b % 4)) % 16]];
+        }
+        for (int c = 0; c < 16; c += 4)
+        {
+            const uint8_t a0 = t[c], a1 = t[c + 1], a2 = t[c + 2], a3 = t[c + 3];
+            if (round < 10)
+            {
+                const uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+                s[c] = a0 ^ all ^ gf_mul(a0 ^ a1, 2);
+                s[c + 1] = a1 ^ all ^ gf_mul(a1 ^ a2, 2);
+                s[c + 2] = a2 ^ all ^ gf_mul(a2 ^ a3, 2);
+                s[c + 3] = a3 ^ all ^ gf_mul(a3 ^ a0, 2);
+            }
+            else
+            {
+                memcpy(s + c, t + c, 4);
+            }
+        }
+        for (int b = 0; b < 16; b++)
+        {
+            s[b] ^= rk[16 * round + b];
+        }
+    }
+    memcpy(out, s, 16);
+}
+
+// counter block: 12 byte nonce, 32-bit big-endian block counter
+static void ctr_block(const uint8_t nonce[12], uint32_t counter, uint8_t block[16])
+{
+    memcpy(block, nonce, 12);
+    block[12] = (uint8_t)(counter >> 24);
+    block[13] = (uint8_t)(counter >> 16);
+    block[14] = (uint8_t)(counter >> 8);
+    block[15] = (uint8_t)counter;
+}
+
+static void aes128_ctr_scalar(const uint8_t rk[176], const uint8_t nonce[12], const uint8_t* in, uint8_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; i += 16)
+    {
+        uint8_t block[16], ks[16];
+        ctr_block(nonce, (uint32_t)(i / 16), block);
+        aes128_encrypt_scalar(rk, block, ks);
+        for (size_t b = 0; b < 16 && i + b < n; b++)
+        {
+            out[i + b] = in[i + b] ^ ks[b];
+        }
+    }
+}
+
+static uint8x16_t aes128_encrypt_neon(uint8x16_t s, const uint8x16_t rk[11])
+{
+    for (int i = 0; i < 9; i++)
+    {
+        s = vaesmcq_u8(vaeseq_u8(s, rk[i]));
+    }
+    return veorq_u8(vaeseq_u8(s, rk[9]), rk[10]);
+}
+
+static void aes128_ctr_neon(const uint8_t rk_bytes[176], const uint8_t nonce[12], const uint8_t* in, uint8_t* out, size_t n)
+{
+    uint8x16_t rk[11];
+    for (int r = 0; r < 11; r++)
+    {
+        rk[r] = vld1q_u8(rk_bytes + 16 * r);
+    }
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint8_t block[16];
+        ctr_block(nonce, (uint32_t)(i / 16), block);
+        vst1q_u8(out + i, veorq_u8(vld1q_u8(in + i), aes128_encrypt_neon(vld1q_u8(block), rk)));
+    }
+    if (i < n)
+    {
+        uint8_t block[16], ks[16];
+        ctr_block(nonce, (uint32_t)(i / 16), block);
+        vst1q_u8(ks, aes128_encrypt_neon(vld1q_u8(block), rk));
+        for (size_t b = 0; i + b < n; b++)
+        {
+            out[i + b] = in[i + b] ^ ks[b];
+        }
+    }
+}
+
+//----- SHA-256 and SHA-1
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t sha1_k[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+static void sha256_block_scalar(uint32_t h[8], const uint8_t* p)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = load_be32(p + 4 * i);
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        const uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (int i = 0; i < 64; i++)
+    {
+        const uint32_t t1 = hh + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        const uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += hh;
+}
+
+static uint32x4_t load_be32x4(const uint8_t* p)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+static void sha256_block_neon(uint32_t h[8], const uint8_t* p)
+{
+    uint32x4_t abcd = vld1q_u32(h);
+    uint32x4_t efgh = vld1q_u32(h + 4);
+    const uint32x4_t abcd0 = abcd, efgh0 = efgh;
+    uint32x4_t w[4];
+    for (int i = 0; i < 4; i++)
+    {
+        w[i] = load_be32x4(p + 16 * i);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        const uint32x4_t wk = vaddq_u32(w[i % 4], vld1q_u32(sha256_k + 4 * i));
+        if (i < 12)
+        {
+            w[i % 4] = vsha256su1q_u32(vsha256su0q_u32(w[i % 4], w[(i + 1) % 4]), w[(i + 2) % 4], w[(i + 3) % 4]);
+        }
+        const uint32x4_t abcd_in = abcd;
+        abcd = vsha256hq_u32(abcd, efgh, wk);
+        efgh = vsha256h2q_u32(efgh, abcd_in, wk);
+    }
+    vst1q_u32(h, vaddq_u32(abcd, abcd0));
+    vst1q_u32(h + 4, vaddq_u32(efgh, efgh0));
+}
+
+static void sha1_block_scalar(uint32_t h[5], const uint8_t* p)
+{
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = load_be32(p + 4 * i);
+    }
+    for (int i = 16; i < 80; i++)
+    {
+        w[i] = rol32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++)
+    {
+        uint32_t f;
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d);
+        }
+        else if (i < 40 || i >= 60)
+        {
+            f = b ^ c ^ d;
+        }
+        else
+        {
+            f = (b & c) | (b & d) | (c & d);
+        }
+        const uint32_t t = rol32(a, 5) + f + e + sha1_k[i / 20] + w[i];
+        e = d;
+        d = c;
+        c = rol32(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+static void sha1_block_neon(uint32_t h[5], const uint8_t* p)
+{
+    uint32x4_t abcd = vld1q_u32(h);
+    uint32_t e = h[4];
+    const uint32x4_t abcd0 = abcd;
+    uint32x4_t w[4];
+    for (int i = 0; i < 4; i++)
+    {
+        w[i] = load_be32x4(p + 16 * i);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        const uint32x4_t wk = vaddq_u32(w[i % 4], vdupq_n_u32(sha1_k[i / 5]));
+        const uint32_t e_next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+        if (i < 5)
+        {
+            abcd = vsha1cq_u32(abcd, e, wk);
+        }
+        else if (i < 10 || i >= 15)
+        {
+            abcd = vsha1pq_u32(abcd, e, wk);
+        }
+        else
+        {
+            abcd = vsha1mq_u32(abcd, e, wk);
+        }
+        e = e_next;
+        if (i < 16)
+        {
+            w[i % 4] = vsha1su1q_u32(vsha1su0q_u32(w[i % 4], w[(i + 1) % 4], w[(i + 2) % 4]), w[(i + 3) % 4]);
+        }
+    }
+    vst1q_u32(h, vaddq_u32(abcd, abcd0));
+    h[4] += e;
+}
+
+// Merkle-Damgard padding around a block function; digest words big-endian
+template <int Words, typename Block>
+static void sha_digest(Block block, const uint32_t (&iv)[Words], const uint8_t* p, size_t n, uint8_t* digest)
+{
+    uint32_t h[Words];
+    memcpy(h, iv, sizeof(h));
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        block(h, p + i);
+    }
+    uint8_t tail[128] = { 0 };
+    const size_t rest = n - i;
+    memcpy(tail, p + i, rest);
+    tail[rest] = 0x80;
+    const size_t tail_len = rest < 56 ? 64 : 128;
+    const uint64_t bits = (uint64_t)n * 8;
+    for (int b = 0; b < 8; b++)
+    {
+        tail[tail_len - 1 - b] = (uint8_t)(bits >> (8 * b));
+    }
+    for (size_t t = 0; t < tail_len; t += 64)
+    {
+        block(h, tail + t);
+    }
+    for (int w = 0; w < Words; w++)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            digest[4 * w + b] = (uint8_t)(h[w] >> (24 - 8 * b));
+        }
+    }
+}
+
+static const uint32_t sha256_iv[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+static const uint32_t sha1_iv[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+static bool known_answers()
+{
+    bool ok = true;
+    uint8_t key[16], pt[16], rk[176], ct[16];
+    for (int i = 0; i < 16; i++)
+    {
+        key[i] = (uint8_t)i;
+        pt[i] = (uint8_t)(i * 0x11);
+    }
+    const uint8_t aes_expected[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                       0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+    aes128_expand_key(key, rk);
+    uint8x16_t rkv[11];
+    for (int r = 0; r < 11; r++)
+    {
+        rkv[r] = vld1q_u8(rk + 16 * r);
+    }
+    vst1q_u8(ct, aes128_encrypt_neon(vld1q_u8(pt), rkv));
+    if (memcmp(ct, aes_expected, 16) != 0)
+    {
+        fprintf(stderr, "aes128: FIPS-197 vector failed\n");
+        ok = false;
+    }
+
+    const uint8_t sha256_expected[32] = { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40,
+                                          0xde, 0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17,
+                                          0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad };
+    const uint8_t sha1_expected[20] = { 0xa9, 0x99, 0x3e, 0x36, 0x47, 0x06, 0x81, 0x6a, 0xba, 0x3e,
+                                        0x25, 0x71, 0x78, 0x50, 0xc2, 0x6c, 0x9c, 0xd0, 0xd8, 0x9d };
+    uint8_t digest[32];
+    sha_digest(sha256_block_neon, sha256_iv, (const uint8_t*)"abc", 3, digest);
+    if (memcmp(digest, sha256_expected, 32) != 0)
+    {
+        fprintf(stderr, "sha256: \"abc\" vector failed\n");
+        ok = false;
+    }
+    sha_digest(sha1_block_neon, sha1_iv, (const uint8_t*)"abc", 3, digest);
+    if (memcmp(digest, sha1_expected, 20) != 0)
+    {
+        fprintf(stderr, "sha1: \"abc\" vector failed\n");
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    init_aes_sbox();
+    if (!known_answers())
+    {
+        return 1;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double gbps;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height;
+        const std::vector<uint8_t> data = random_bytes(n, 1);
+
+        if (bench_selected(opt, "aes128-ctr"))
+        {
+            const std::vector<uint8_t> key = random_bytes(16, 2);
+            const std::vector<uint8_t> nonce = random_bytes(12, 3);
+            uint8_t rk[176];
+            aes128_expand_key(key.data(), rk);
+            std::vector<uint8_t> expected(n), actual(n);
+            const double ms_scalar = bench_time_ms(opt.iters, [&] { aes128_ctr_scalar(rk, nonce.data(), data.data(), expected.data(), n); });
+            const double ms_neon = bench_time_ms(opt.iters, [&] { aes128_ctr_neon(rk, nonce.data(), data.data(), actual.data(), n); });
+            bench_report("aes128-ctr", "scalar", size, ms_scalar);
+            bench_report("aes128-ctr", "neon", size, ms_neon);
+            rates.push_back({ "aes128-ctr", "scalar", size.name, n / (ms_scalar * 1e6) });
+            rates.push_back({ "aes128-ctr", "neon", size.name, n / (ms_neon * 1e6) });
+            if (expected != actual)
+            {
+                fprintf(stderr, "aes128-ctr %s: neon and scalar differ\n", size.name);
+                ok = false;
+            }
+        }
+        if (bench_selected(opt, "sha256"))
+        {
+            uint8_t expected[32], actual[32];
+            const double ms_scalar = bench_time_ms(opt.iters, [&] { sha_digest(sha256_block_scalar, sha256_iv, data.data(), n, expected); });
+            const double ms_neon = bench_time_ms(opt.iters, [&] { sha_digest(sha256_block_neon, sha256_iv, data.data(), n, actual); });
+            bench_report("sha256", "scalar", size, ms_scalar);
+            bench_report("sha256", "neon", size, ms_neon);
+            rates.push_back({ "sha256", "scalar", size.name, n / (ms_scalar * 1e6) });
+            rates.push_back({ "sha256", "neon", size.name, n / (ms_neon * 1e6) });
+            if (memcmp(actual, expected, 32) != 0)
+            {
+                fprintf(stderr, "sha256 %s: neon and scalar differ\n", size.name);
+                ok = false;
+            }
+        }
+        if (bench_selected(opt, "sha1"))
+        {
+            uint8_t expected[20], actual[20];
+            const double ms_scalar = bench_time_ms(opt.iters, [&] { sha_digest(sha1_block_scalar, sha1_iv, data.data(), n, expected); });
+            const double ms_neon = bench_time_ms(opt.iters, [&] { sha_digest(sha1_block_neon, sha1_iv, data.data(), n, actual); });
+            bench_report("sha1", "scalar", size, ms_scalar);
+            bench_report("sha1", "neon", size, ms_neon);
+            rates.push_back({ "sha1", "scalar", size.name, n / (ms_scalar * 1e6) });
+            rates.push_back({ "sha1", "neon", size.name, n / (ms_neon * 1e6) });
+            if (memcmp(actual, expected, 20) != 0)
+            {
+                fprintf(stderr, "sha1 %s: neon and scalar differ\n", size.name);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "GB/s");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].gbps);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+
+#include <complex>
+#include <random>
+
+// Radix-4 Stockham FFT (decimation in frequency, out of place) on interleaved
+// complex floats: twiddles by vcmla + vcmla_rot90, the +-j butterfly legs by
+// vcadd_rot90 / vcadd_rot270. Checked against the same algorithm on
+// std::complex, which is first checked against a double precision DFT.
+// Transform sizes are fixed powers of four, --size is ignored; the Mpix/s
+// column counts points. Ends with GFLOPS (5 N log2 N per transform) per case.
+// Build with -DNEON_SIM_AVX2=ON for the FMA3 backend of the complex intrinsics.
+
+typedef std::complex<float> cfloat;
+
+// W_n^p, W_n^2p, W_n^3p for every stage n = N, N/4, ..., 4 and p < n/4
+struct Twiddles
+{
+    std::vector<std::vector<cfloat> > w1, w2, w3;
+
+    explicit Twiddles(int N)
+    {
+        for (int n = N; n >= 4; n /= 4)
+        {
+            std::vector<cfloat> t1(n / 4), t2(n / 4), t3(n / 4);
+            for (int p = 0; p < n / 4; p++)
+            {
+                const double theta = -2.0 * 3.14159265358979323846 * p / n;
+                t1[p] = cfloat((float)cos(theta), (float)sin(theta));
+                t2[p] = cfloat((float)cos(2 * theta), (float)sin(2 * theta));
+                t3[p] = cfloat((float)cos(3 * theta), (float)sin(3 * theta));
+            }
+            w1.push_back(t1);
+            w2.push_back(t2);
+            w3.push_back(t3);
+        }
+    }
+};
+
+static void fft_scalar(const Twiddles& tw, cfloat* x, cfloat* work, int N)
+{
+    cfloat* src = x;
+    cfloat* dst = work;
+    int stage = 0;
+    for (int n = N, s = 1; n >= 4; n /= 4, s *= 4, stage++)
+    {
+        const int m = n / 4;
+        for (int p = 0; p < m; p++)
+        {
+            const cfloat w1 = tw.w1[stage][p], w2 = tw.w2[stage][p], w3 = tw.w3[stage][p];
+            for (int q = 0; q < s; q++)
+            {
+                const cfloat a = src[q + s * p], b = src[q + s * (p + m)];
+                const cfloat c = src[q + s * (p + 2 * m)], d = src[q + s * (p + 3 * m)];
+                const cfloat apc = a + c, amc = a - c, bpd = b + d;
+                const cfloat jbmd = cfloat(0.0f, 1.0f) * (b - d);
+                dst[q + s * (4 * p + 0)] = apc + bpd;
+                dst[q + s * (4 * p + 1)] = w1 * (amc - jbmd);
+                dst[q + s * (4 * p + 2)] = w2 * (apc - bpd);
+                dst[q + s * (4 * p + 3)] = w3 * (amc + jbmd);
+            }
+        }
+        std::swap(src, dst);
+    }
+    if (src != x)
+    {
+        memcpy(x, src, N * sizeof(cfloat));
+    }
+}
+
+// x * w on two complex numbers per register
+static inline float32x4_t cmulq(float32x4_t x, float32x4_t w)
+{
+    return vcmlaq_rot90_f32(vcmlaq_f32(vdupq_n_f32(0.0f), w, x), w, x);
+}
+
+// x * w[lane]
+static inline float32x4_t cmulq_lane(float32x4_t x, float32x4_t w, const int lane)
+{
+    return vcmlaq_rot90_laneq_f32(vcmlaq_laneq_f32(vdupq_n_f32(0.0f), x, w, lane), x, w, lane);
+}
+
+static void fft_neon(const Twiddles& tw, cfloat* x, cfloat* work, int N)
+{
+    cfloat* src = x;
+    cfloat* dst = work;
+    int stage = 0;
+    for (int n = N, s = 1; n >= 4; n /= 4, s *= 4, stage++)
+    {
+        const int m = n / 4;
+        const float* w1 = (const float*)tw.w1[stage].data();
+        const float* w2 = (const float*)tw.w2[stage].data();
+        const float* w3 = (const float*)tw.w3[stage].data();
+        if (s == 1)
+        {
+            // two p per register; the four outputs of p are adjacent, so the
+            // results are stored as a 2x4 transpose of complex numbers
+            for (int p = 0; p < m; p += 2)
+            {
+                const float32x4_t a = vld1q_f32((const float*)(src + p));
+                const float32x4_t b = vld1q_f32((const float*)(src + p + m));
+                const float32x4_t c = vld1q_f32((const float*)(src + p + 2 * m));
+                const float32x4_t d = vld1q_f32((const float*)(src + p + 3 * m));
+                const float32x4_t apc = vaddq_f32(a, c), amc = vsubq_f32(a, c);
+                const float32x4_t bpd = vaddq_f32(b, d), bmd = vsubq_f32(b, d);
+                float y[4][4];
+                vst1q_f32(y[0], vaddq_f32(apc, bpd));
+                vst1q_f32(y[1], cmulq(vcaddq_rot270_f32(amc, bmd), vld1q_f32(w1 + 2 * p)));
+                vst1q_f32(y[2], cmulq(vsubq_f32(apc, bpd), vld1q_f32(w2 + 2 * p)));
+                vst1q_f32(y[3], cmulq(vcaddq_rot90_f32(amc, bmd), vld1q_f32(w3 + 2 * p)));
+                for (int k = 0; k < 4; k++)
+                {
+                    dst[4 * p + k] = cfloat(y[k][0], y[k][1]);
+                    dst[4 * p + 4 + k] = cfloat(y[k][2], y[k][3]);
+                }
+            }
+        }
+        else
+        {
+            for (int p = 0; p < m; p++)
+            {
+                // w1, w2 in one register, w3 in the low half of another
+                const float tw12[4] = { w1[2 * p], w1[2 * p + 1], w2[2 * p], w2[2 * p + 1] };
+                const float tw3[4] = { w3[2 * p], w3[2 * p + 1], 0.0f, 0.0f };
+                const float32x4_t wa = vld1q_f32(tw12);
+                const float32x4_t wb = vld1q_f32(tw3);
+                for (int q = 0; q < s; q += 2)
+                {
+                    const float32x4_t a = vld1q_f32((const float*)(src + q + s * p));
+                    const float32x4_t b = vld1q_f32((const float*)(src + q + s * (p + m)));
+                    const float32x4_t c = vld1q_f32((const float*)(src + q + s * (p + 2 * m)));
+                    const float32x4_t d = vld1q_f32((const float*)(src + q + s * (p + 3 * m)));
+                    const float32x4_t apc = vaddq_f32(a, c), amc = vsubq_f32(a, c);
+                    const float32x4_t bpd = vaddq_f32(b, d), bmd = vsubq_f32(b, d);
+                    vst1q_f32((float*)(dst + q + s * (4 * p + 0)), vaddq_f32(apc, bpd));
+                    vst1q_f32((float*)(dst + q + s * (4 * p + 1)), cmulq_lane(vcaddq_rot270_f32(amc, bmd), wa, 0));
+                    vst1q_f32((float*)(dst + q + s * (4 * p + 2)), cmulq_lane(vsubq_f32(apc, bpd), wa, 1));
+                    vst1q_f32((float*)(dst + q + s * (4 * p + 3)), cmulq_lane(vcaddq_rot90_f32(amc, bmd), wb, 0));
+                }
+            }
+        }
+        std::swap(src, dst);
+    }
+    if (src != x)
+    {
+        memcpy(x, src, N * sizeof(cfloat));
+    }
+}
+
+static double max_error(const cfloat* a, const cfloat* b, int n)
+{
+    double err = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        err = std::max(err, (double)std::abs(a[i] - b[i]));
+    }
+    return err;
+}
+
+// fft_scalar against a direct DFT in double precision
+static bool check_scalar(int N)
+{
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<cfloat> x(N), work(N);
+    for (int i = 0; i < N; i++)
+    {
+        x[i] = cfloat(dist(rng), dist(rng));
+    }
+    std::vector<cfloat> expected(N);
+    for (int k = 0; k < N; k++)
+    {
+        std::complex<double> sum = 0.0;
+        for (int i = 0; i < N; i++)
+        {
+            const double theta = -2.0 * 3.14159265358979323846 * ((long long)i * k % N) / N;
+            sum += std::complex<double>(x[i]) * std::complex<double>(cos(theta), sin(theta));
+        }
+        expected[k] = cfloat((float)sum.real(), (float)sum.imag());
+    }
+    const Twiddles tw(N);
+    fft_scalar(tw, x.data(), work.data(), N);
+    const double err = max_error(x.data(), expected.data(), N);
+    if (err > 1e-4 * N)
+    {
+        fprintf(stderr, "fft_scalar %d: max error %g against the DFT\n", N, err);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    if (!check_scalar(64) || !check_scalar(256))
+    {
+        return 1;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double gflops;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    // powers of four; the batch keeps each timed run near the same work
+    const BenchSize sizes[] = { { "256", 256, 1 }, { "4096", 4096, 1 }, { "65536", 65536, 1 } };
+    bench_header();
+    for (const BenchSize& size : sizes)
+    {
+        if (!bench_selected(opt, "fft"))
+        {
+            break;
+        }
+        const int N = size.width;
+        const int batch = (1 << 20) / N;
+        const Twiddles tw(N);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<cfloat> input(N), expected(N), actual(N), work(N);
+        for (int i = 0; i < N; i++)
+        {
+            input[i] = cfloat(dist(rng), dist(rng));
+        }
+        const double ms_scalar = bench_time_ms(opt.iters, [&] {
+            for (int b = 0; b < batch; b++)
+            {
+                expected = input;
+                fft_scalar(tw, expected.data(), work.data(), N);
+            }
+        });
+        const double ms_neon = bench_time_ms(opt.iters, [&] {
+            for (int b = 0; b < batch; b++)
+            {
+                actual = input;
+                fft_neon(tw, actual.data(), work.data(), N);
+            }
+        });
+        const BenchSize points = { size.name, N * batch, 1 };
+        bench_report("fft", "scalar", points, ms_scalar);
+        bench_report("fft", "neon", points, ms_neon);
+        const double flops = 5.0 * N * log2((double)N) * batch;
+        rates.push_back({ "fft", "scalar", size.name, flops / (ms_scalar * 1e6) });
+        rates.push_back({ "fft", "neon", size.name, flops / (ms_neon * 1e6) });
+        // fused vs separately rounded complex products
+        const double err = max_error(actual.data(), expected.data(), N);
+        if (err > 1e-5 * N)
+        {
+            fprintf(stderr, "fft %s: max error %g between neon and scalar\n", size.name, err);
+            ok = false;
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "GFLOPS");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].gflops);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_compare.hpp"
+#include "neon_sim_filter.hpp"
+
+#include <random>
+
+// The filters of neon_sim_filter.hpp against their scalar twins on a gray
+// frame of each size, with a reflect-101 border:
+//   gaussian3 / gaussian5 / gaussian7   separable Q8 Gaussian, default sigma
+//   box5                                5x5 mean
+//   sobel                               3x3, dx and dy into int16
+//   erode3 / dilate5                    rectangle min / max
+//   resize_down / resize_up             bilinear to half and to 1.5 times the
+//                                       size; Mpix/s counts output pixels
+// Outputs must match the twins bit for bit.
+
+namespace filter = neon_sim_kernels::filter;
+
+static const filter::Border kBorder = filter::BORDER_REFLECT_101;
+
+template<typename T, typename Run>
+static bool bench_filter(const BenchOptions& opt, const BenchSize& size, const char* name, std::vector<T>& expected,
+                         std::vector<T>& actual, Run run)
+{
+    if (!bench_selected(opt, name))
+    {
+        return true;
+    }
+    bench_report(name, "ref", size, bench_time_ms(opt.iters, [&] { run(true, expected.data()); }));
+    bench_report(name, "neon", size, bench_time_ms(opt.iters, [&] { run(false, actual.data()); }));
+
+    CompareResult res = compare_array(expected.data(), actual.data(), expected.size());
+    if (!res.ok())
+    {
+        fprintf(stderr, "%s %s: neon and ref differ\n", name, size.name);
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    bool ok = true;
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int w = size.width;
+        const int h = size.height;
+        std::vector<uint8_t> src((size_t)w * h);
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            src[i] = (uint8_t)rng();
+        }
+        std::vector<uint8_t> out(src.size()), out_b(src.size());
+        std::vector<int16_t> grad(2 * src.size()), grad_b(2 * src.size());
+
+        const int gaussian_sizes[] = { 3, 5, 7 };
+        for (int ksize : gaussian_sizes)
+        {
+            uint8_t kernel[7];
+            filter::gaussian_kernel_q8(ksize, 0.0, kernel);
+            const std::string name = "gaussian" + std::to_string(ksize);
+            ok &= bench_filter(opt, size, name.c_str(), out, out_b, [&](bool ref, uint8_t* dst) {
+                (ref ? filter::ref::separable_filter : filter::separable_filter)(src.data(), w, dst, w, w, h, kernel,
+                                                                                 kernel, ksize, kBorder);
+            });
+        }
+        ok &= bench_filter(opt, size, "box5", out, out_b, [&](bool ref, uint8_t* dst) {
+            (ref ? filter::ref::box_filter : filter::box_filter)(src.data(), w, dst, w, w, h, 5, kBorder);
+        });
+        ok &= bench_filter(opt, size, "sobel", grad, grad_b, [&](bool ref, int16_t* dst) {
+            (ref ? filter::ref::sobel3x3 : filter::sobel3x3)(src.data(), w, dst, w * sizeof(int16_t), dst + src.size(),
+                                                             w * sizeof(int16_t), w, h, kBorder);
+        });
+        ok &= bench_filter(opt, size, "erode3", out, out_b, [&](bool ref, uint8_t* dst) {
+            (ref ? filter::ref::erode : filter::erode)(src.data(), w, dst, w, w, h, 3, kBorder);
+        });
+        ok &= bench_filter(opt, size, "dilate5", out, out_b, [&](bool ref, uint8_t* dst) {
+            (ref ? filter::ref::dilate : filter::dilate)(src.data(), w, dst, w, w, h, 5, kBorder);
+        });
+
+        const BenchSize half = { size.name, w / 2, h / 2 };
+        std::vector<uint8_t> small((size_t)half.width * half.height), small_b(small.size());
+        ok &= bench_filter(opt, half, "resize_down", small, small_b, [&](bool ref, uint8_t* dst) {
+            (ref ? filter::ref::resize_bilinear : filter::resize_bilinear)(src.data(), w, w, h, dst, half.width,
+                                                                           half.width, half.height);
+        });
+        const BenchSize up = { size.name, w * 3 / 2, h * 3 / 2 };
+        std::vector<uint8_t> large((size_t)up.width * up.height), large_b(large.size());
+        ok &= bench_filter(opt, up, "resize_up", large, large_b, [&](bool ref, uint8_t* dst) {
+            (ref ? filter::ref::resize_bilinear : filter::resize_bilinear)(src.data(), w, w, h, dst, up.width,
+                                                                           up.width, up.height);
+        });
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+
+#include <cmath>
+
+// One-pole decay y = a * y + x on 16 channels whose state starts near the
+// bottom of the normal range, so most of the run is spent on subnormals: the
+// AArch64 default FPCR against FZ (NeonSimFpcrScope, MXCSR FTZ + DAZ on
+// x86), which is what AArch32 NEON always does. Each frame size is taken as
+// a sample count. FZ must match the default run to within the flushed
+// range. Ends with Msamples/s per case.
+
+static const int kChannels = 16;
+
+static void decay(float* state, const float* input, size_t n)
+{
+    float32x4_t y[kChannels / 4];
+    for (int c = 0; c < kChannels / 4; c++)
+    {
+        y[c] = vld1q_f32(state + 4 * c);
+    }
+    const float32x4_t a = vdupq_n_f32(0.9999f);
+    for (size_t i = 0; i < n; i++)
+    {
+        const float32x4_t x = vld1q_dup_f32(input + i);
+        for (int c = 0; c < kChannels / 4; c++)
+        {
+            y[c] = vmlaq_f32(x, a, y[c]);
+        }
+    }
+    for (int c = 0; c < kChannels / 4; c++)
+    {
+        vst1q_f32(state + 4 * c, y[c]);
+    }
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double msamples;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        if (!bench_selected(opt, "decay"))
+        {
+            break;
+        }
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height / kChannels;
+        // silence: the tail of a reverb or an envelope after note-off
+        const std::vector<float> input(n, 0.0f);
+        float init[kChannels];
+        for (int c = 0; c < kChannels; c++)
+        {
+            init[c] = 1e-37f * (1.0f + c);
+        }
+
+        float expected[kChannels], actual[kChannels];
+        const double ms_default = bench_time_ms(opt.iters, [&] {
+            memcpy(expected, init, sizeof(init));
+            decay(expected, input.data(), n);
+        });
+        const double ms_fz = bench_time_ms(opt.iters, [&] {
+            NeonSimFpcrScope fz(NEON_SIM_FPCR_FZ);
+            memcpy(actual, init, sizeof(init));
+            decay(actual, input.data(), n);
+        });
+        const BenchSize samples = { size.name, (int)(n * kChannels), 1 };
+        bench_report("decay", "default", samples, ms_default);
+        bench_report("decay", "fz", samples, ms_fz);
+        rates.push_back({ "decay", "default", size.name, n * kChannels / (ms_default * 1e3) });
+        rates.push_back({ "decay", "fz", size.name, n * kChannels / (ms_fz * 1e3) });
+        for (int c = 0; c < kChannels; c++)
+        {
+            if (fabsf(actual[c] - expected[c]) > 1.2e-38f)
+            {
+                fprintf(stderr, "decay %s: channel %d is %g with FZ, %g without\n", size.name, c, actual[c],
+                        expected[c]);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "Msamples/s");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].msamples);
+    }
+    return ok ? 0 : 1;
+}
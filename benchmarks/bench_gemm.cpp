@@ -0,0 +1,188 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_gemm.hpp"
+
+#include <cmath>
+#include <random>
+
+// The microkernels of neon_sim_gemm.hpp against their scalar twins on fixed
+// shapes (--size is not used):
+//   sgemm          square float GEMM, 64, 128 and 256
+//   igemm          the same with int8 operands and int32 results
+//   conv_direct    3x3, 16 -> 16 channels on 56x56
+//   conv_winograd  the same through F(2x2, 3x3), weights transformed once
+// Results must match the twins (Winograd within a tolerance). The Mpix/s
+// column counts output elements. Ends with GFLOP/s per case (GOP/s for
+// igemm; Winograd is credited with the direct flops) and, for the NEON
+// rows, a projection for a device: flops per 128 bit operation of the inner
+// loop times --ghz x --ipc. Per step of k or input channel:
+//   sgemm          24 fmla + 5 ldr for 192 flops
+//   igemm          16 smlal + 2 ldr + 2 sxtl for 128 ops
+//   conv_direct    9 ldr + 9 fmla per 4 outputs, 72 flops
+//   conv_winograd  4 ldr + 4 fmla per 2x2 tile, 72 direct flops; the
+//                  transforms are left out, they amortize over channels
+// That is an upper bound that ignores cache misses and the edge tiles.
+
+namespace gemm = neon_sim_kernels::gemm;
+
+static const int kConvChannels = 16;
+static const int kConvSize = 56;
+
+template<typename T>
+static std::vector<T> random_values(size_t n, unsigned seed);
+
+template<>
+std::vector<float> random_values<float>(size_t n, unsigned seed)
+{
+    std::vector<float> v(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = dist(rng);
+    }
+    return v;
+}
+
+template<>
+std::vector<int8_t> random_values<int8_t>(size_t n, unsigned seed)
+{
+    std::vector<int8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (int8_t)rng();
+    }
+    return v;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        std::string size;
+        double gflops;
+        double flops_per_op; // 0 for the scalar twins
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    auto report = [&](const char* name, const std::string& size, int outputs, double flops, double ms_ref,
+                      double ms_neon, double flops_per_op) {
+        const BenchSize counted = { size.c_str(), outputs, 1 };
+        bench_report(name, "ref", counted, ms_ref);
+        bench_report(name, "neon", counted, ms_neon);
+        rates.push_back({ name, "ref", size, flops / (ms_ref * 1e6), 0 });
+        rates.push_back({ name, "neon", size, flops / (ms_neon * 1e6), flops_per_op });
+    };
+
+    bench_header();
+    const int dims[] = { 64, 128, 256 };
+    for (int d : dims)
+    {
+        const std::string size = std::to_string(d);
+        const double flops = 2.0 * d * d * d;
+        if (bench_selected(opt, "sgemm"))
+        {
+            const std::vector<float> a = random_values<float>((size_t)d * d, 1);
+            const std::vector<float> b = random_values<float>((size_t)d * d, 2);
+            std::vector<float> expected(a.size()), actual(a.size());
+            const size_t step = d * sizeof(float);
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                gemm::ref::sgemm(d, d, d, a.data(), step, b.data(), step, expected.data(), step);
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                gemm::sgemm(d, d, d, a.data(), step, b.data(), step, actual.data(), step);
+            });
+            report("sgemm", size, d * d, flops, ms_ref, ms_neon, 192.0 / 29);
+            ok = ok && expected == actual;
+        }
+        if (bench_selected(opt, "igemm"))
+        {
+            const std::vector<int8_t> a = random_values<int8_t>((size_t)d * d, 3);
+            const std::vector<int8_t> b = random_values<int8_t>((size_t)d * d, 4);
+            std::vector<int32_t> expected(a.size()), actual(a.size());
+            const double ms_ref = bench_time_ms(opt.iters, [&] {
+                gemm::ref::igemm(d, d, d, a.data(), d, b.data(), d, expected.data(), d * sizeof(int32_t));
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                gemm::igemm(d, d, d, a.data(), d, b.data(), d, actual.data(), d * sizeof(int32_t));
+            });
+            report("igemm", size, d * d, flops, ms_ref, ms_neon, 128.0 / 20);
+            ok = ok && expected == actual;
+        }
+    }
+
+    const bool direct = bench_selected(opt, "conv_direct");
+    const bool winograd = bench_selected(opt, "conv_winograd");
+    if (direct || winograd)
+    {
+        const int c = kConvChannels;
+        const int out_size = kConvSize - 2;
+        const std::string size = std::to_string(kConvSize) + "x" + std::to_string(kConvSize);
+        const std::vector<float> in = random_values<float>((size_t)c * kConvSize * kConvSize, 5);
+        const std::vector<float> weights = random_values<float>((size_t)c * c * 9, 6);
+        const std::vector<float> bias = random_values<float>(c, 7);
+        std::vector<float> expected((size_t)c * out_size * out_size), actual(expected.size());
+        const double flops = 2.0 * 9 * c * c * out_size * out_size;
+        const double ms_ref = bench_time_ms(opt.iters, [&] {
+            gemm::ref::conv3x3(in.data(), c, kConvSize, kConvSize, weights.data(), bias.data(), expected.data(), c);
+        });
+        if (direct)
+        {
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                gemm::conv3x3_direct(in.data(), c, kConvSize, kConvSize, weights.data(), bias.data(), actual.data(),
+                                     c);
+            });
+            report("conv_direct", size, (int)expected.size(), flops, ms_ref, ms_neon, 72.0 / 18);
+            ok = ok && expected == actual;
+        }
+        if (winograd)
+        {
+            std::vector<float> transformed(gemm::winograd_weights_size(c, c));
+            gemm::winograd_transform_weights(weights.data(), c, c, transformed.data());
+            const double ms_neon = bench_time_ms(opt.iters, [&] {
+                gemm::conv3x3_winograd(in.data(), c, kConvSize, kConvSize, transformed.data(), bias.data(),
+                                       actual.data(), c);
+            });
+            report("conv_winograd", size, (int)expected.size(), flops, ms_ref, ms_neon, 72.0 / 8);
+            for (size_t i = 0; i < expected.size(); i++)
+            {
+                ok = ok && fabsf(expected[i] - actual[i]) <= 1e-4f * (1.0f + fabsf(expected[i]));
+            }
+        }
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "a NEON kernel does not match its scalar twin\n");
+    }
+
+    printf("\n%-16s %-8s %-10s %10s %10s %14s\n", "benchmark", "impl", "size", "GFLOP/s", "flop/op", "projected");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        const Rate& r = rates[i];
+        if (r.flops_per_op > 0)
+        {
+            printf("%-16s %-8s %-10s %10.3f %10.2f %14.1f\n", r.name, r.impl, r.size.c_str(), r.gflops,
+                   r.flops_per_op, opt.ghz * opt.ipc * r.flops_per_op);
+        }
+        else
+        {
+            printf("%-16s %-8s %-10s %10.3f\n", r.name, r.impl, r.size.c_str(), r.gflops);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_compare.hpp"
+#include "neon_sim_histogram.hpp"
+
+#include <random>
+
+// The kernels of neon_sim_histogram.hpp against their scalar twins:
+//   hist_noise      uniform noise, every bin about equally likely
+//   hist_flat       one gray level, so consecutive pixels hit the same bin
+//   hist_gradient   a horizontal ramp: short runs of equal pixels
+//   integral        the 32 bit integral image
+// Each histogram runs with 1, 2, 4 and 8 banks (impl "banks<n>"). The
+// counting is scalar even through the sim, so the store-forwarding stalls
+// that banking avoids show on the host too: hist_flat speeds up with every
+// bank. The simulated loads tax all bank counts alike. Outputs must match
+// the twins exactly.
+
+namespace histogram = neon_sim_kernels::histogram;
+
+static bool check(const char* name, const BenchSize& size, const std::vector<uint32_t>& expected,
+                  const std::vector<uint32_t>& actual)
+{
+    CompareResult res = compare_array(expected.data(), actual.data(), expected.size());
+    if (!res.ok())
+    {
+        fprintf(stderr, "%s %s: neon and ref differ\n", name, size.name);
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
+}
+
+static bool bench_histogram(const BenchOptions& opt, const BenchSize& size, const char* name,
+                            const std::vector<uint8_t>& src)
+{
+    if (!bench_selected(opt, name))
+    {
+        return true;
+    }
+    const int w = size.width;
+    const int h = size.height;
+    std::vector<uint32_t> expected(256), actual(256);
+    bench_report(name, "ref", size,
+                 bench_time_ms(opt.iters, [&] { histogram::ref::histogram_u8(src.data(), w, w, h, expected.data()); }));
+
+    bool ok = true;
+    const int banks[] = { 1, 2, 4, 8 };
+    for (int b : banks)
+    {
+        const std::string impl = "banks" + std::to_string(b);
+        bench_report(name, impl.c_str(), size, bench_time_ms(opt.iters, [&] {
+                         histogram::histogram_u8(src.data(), w, w, h, actual.data(), b);
+                     }));
+        ok &= check(name, size, expected, actual);
+    }
+    return ok;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    bool ok = true;
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int w = size.width;
+        const int h = size.height;
+        const size_t n = (size_t)w * h;
+
+        std::vector<uint8_t> noise(n), flat(n, 128), gradient(n);
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < n; i++)
+        {
+            noise[i] = (uint8_t)rng();
+            gradient[i] = (uint8_t)((i % w) * 256 / w);
+        }
+        ok &= bench_histogram(opt, size, "hist_noise", noise);
+        ok &= bench_histogram(opt, size, "hist_flat", flat);
+        ok &= bench_histogram(opt, size, "hist_gradient", gradient);
+
+        if (bench_selected(opt, "integral"))
+        {
+            const size_t sum_step = (w + 1) * sizeof(uint32_t);
+            std::vector<uint32_t> expected((size_t)(w + 1) * (h + 1)), actual(expected.size());
+            bench_report("integral", "ref", size, bench_time_ms(opt.iters, [&] {
+                             histogram::ref::integral(noise.data(), w, expected.data(), sum_step, w, h);
+                         }));
+            bench_report("integral", "neon", size, bench_time_ms(opt.iters, [&] {
+                             histogram::integral(noise.data(), w, actual.data(), sum_step, w, h);
+                         }));
+            ok &= check("integral", size, expected, actual);
+        }
+    }
+    return ok ? 0 : 1;
+}
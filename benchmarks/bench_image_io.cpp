@@ -0,0 +1,132 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_image_io.hpp"
+#include "neon_sim_kernels.hpp"
+
+// Cost of getting a frame from disk to a kernel: mapping a PGM/PPM file with
+// MappedImage against reading it into a heap buffer, then rgb2gray (PPM) or
+// threshold (PGM) straight on the mapped view.
+//
+// Without --input, one PPM per --size is generated in the working directory.
+
+namespace nsk = neon_sim_kernels;
+
+static double read_whole_file_ms(const std::string& path, std::vector<uint8_t>& buf)
+{
+    return bench_time_ms(1, [&] {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp)
+        {
+            return;
+        }
+        fseek(fp, 0, SEEK_END);
+        buf.resize((size_t)ftell(fp));
+        fseek(fp, 0, SEEK_SET);
+        buf.resize(fread(buf.data(), 1, buf.size(), fp));
+        fclose(fp);
+    });
+}
+
+// touches every byte, so the mapping really pages the file in
+static unsigned checksum(const nsk::ImageView& v)
+{
+    unsigned sum = 0;
+    for (int y = 0; y < v.height; y++)
+    {
+        const uint8_t* p = v.row(y);
+        for (int i = 0; i < v.width * v.channels; i++)
+        {
+            sum += p[i];
+        }
+    }
+    return sum;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    std::vector<std::string> inputs = opt.inputs;
+    std::vector<std::string> generated;
+    if (inputs.empty())
+    {
+        for (size_t k = 0; k < opt.sizes.size(); k++)
+        {
+            const std::string path = std::string("bench_image_io_") + opt.sizes[k].name + ".ppm";
+            nsk::MappedImage out;
+            if (!out.create_pnm(path, opt.sizes[k].width, opt.sizes[k].height, 3))
+            {
+                fprintf(stderr, "%s\n", out.error().c_str());
+                return 1;
+            }
+            const nsk::MutableImageView v = out.mutable_view();
+            for (int y = 0; y < v.height; y++)
+            {
+                for (int i = 0; i < v.width * 3; i++)
+                {
+                    v.row(y)[i] = (uint8_t)(y + i);
+                }
+            }
+            inputs.push_back(path);
+            generated.push_back(path);
+        }
+    }
+
+    printf("%-32s %-10s %12s %12s\n", "file", "stage", "ms", "MB/s");
+    int status = 0;
+    for (size_t k = 0; k < inputs.size(); k++)
+    {
+        const std::string& path = inputs[k];
+        std::vector<uint8_t> buf;
+        const double fread_ms = read_whole_file_ms(path, buf);
+        const double mb = buf.size() / 1e6;
+        printf("%-32s %-10s %12.3f %12.1f\n", path.c_str(), "fread", fread_ms, mb / (fread_ms / 1000.0));
+
+        nsk::MappedImage img;
+        const double open_ms = bench_time_ms(1, [&] { img.open_pnm(path); });
+        if (img.view().empty())
+        {
+            fprintf(stderr, "%s\n", img.error().c_str());
+            status = 1;
+            continue;
+        }
+        printf("%-32s %-10s %12.3f %12.1f\n", path.c_str(), "mmap", open_ms, mb / (open_ms / 1000.0));
+
+        const nsk::ImageView& v = img.view();
+        volatile unsigned sink = 0;
+        const double touch_ms = bench_time_ms(1, [&] { sink = checksum(v); });
+        printf("%-32s %-10s %12.3f %12.1f\n", path.c_str(), "touch", touch_ms, mb / (touch_ms / 1000.0));
+        (void)sink;
+
+        std::vector<uint8_t> dst((size_t)v.width * v.height);
+        const double kernel_ms = bench_time_ms(opt.iters, [&] {
+            if (v.channels == 3)
+            {
+                nsk::rgb2gray(v.data, v.step, dst.data(), v.width, v.width, v.height);
+            }
+            else
+            {
+                nsk::threshold(v.data, v.step, dst.data(), v.width, v.width, v.height, 128, 0, 255);
+            }
+        });
+        printf("%-32s %-10s %12.3f %12.1f\n", path.c_str(), v.channels == 3 ? "rgb2gray" : "threshold", kernel_ms,
+               mb / (kernel_ms / 1000.0));
+        fflush(stdout);
+    }
+
+    for (size_t k = 0; k < generated.size(); k++)
+    {
+        remove(generated[k].c_str());
+    }
+    return status;
+}
@@ -0,0 +1,115 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_compare.hpp"
+#include "neon_sim_kernels.hpp"
+
+#include <random>
+
+// Times every kernel of neon_sim_kernels, NEON (or simulated NEON) against
+// the scalar reference, and checks that both produce the same output.
+
+namespace nsk = neon_sim_kernels;
+
+struct Frame
+{
+    int width;
+    int height;
+    int channels;
+    size_t step;
+    std::vector<uint8_t> data;
+
+    Frame(int w, int h, int c) : width(w), height(h), channels(c), step((size_t)w * c), data(step * h)
+    {
+    }
+
+    uint8_t* ptr() { return data.data(); }
+};
+
+static Frame random_frame(int w, int h, int c, unsigned seed)
+{
+    Frame f(w, h, c);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < f.data.size(); i++)
+    {
+        f.data[i] = (uint8_t)rng();
+    }
+    return f;
+}
+
+template<typename Run>
+static bool bench_kernel(const BenchOptions& opt, const BenchSize& size, const char* name,
+                         Frame& expected, Frame& actual, Run run)
+{
+    if (!bench_selected(opt, name))
+    {
+        return true;
+    }
+    bench_report(name, "ref", size, bench_time_ms(opt.iters, [&] { run(true, expected); }));
+    bench_report(name, "neon", size, bench_time_ms(opt.iters, [&] { run(false, actual); }));
+
+    CompareResult res = compare_array(expected.data.data(), actual.data.data(), expected.data.size());
+    if (!res.ok())
+    {
+        fprintf(stderr, "%s %s: neon and ref differ\n", name, size.name);
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    uint8_t table[256];
+    for (int i = 0; i < 256; i++)
+    {
+        table[i] = (uint8_t)(255 - i);
+    }
+
+    bool ok = true;
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int w = size.width;
+        const int h = size.height;
+        Frame rgb = random_frame(w, h, 3, 1);
+        Frame gray = random_frame(w, h, 1, 2);
+        Frame gray2 = random_frame(w, h, 1, 3);
+        Frame alpha = random_frame(w, h, 1, 4);
+        Frame out1(w, h, 1), out1b(w, h, 1);
+        Frame out3(w, h, 3), out3b(w, h, 3);
+        Frame outt(h, w, 1), outtb(h, w, 1);
+
+        ok &= bench_kernel(opt, size, "rgb2gray", out1, out1b, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::rgb2gray : nsk::rgb2gray)(rgb.ptr(), rgb.step, dst.ptr(), dst.step, w, h);
+        });
+        ok &= bench_kernel(opt, size, "rgb2bgr", out3, out3b, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::rgb2bgr : nsk::rgb2bgr)(rgb.ptr(), rgb.step, dst.ptr(), dst.step, w, h);
+        });
+        ok &= bench_kernel(opt, size, "threshold", out1, out1b, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::threshold : nsk::threshold)(gray.ptr(), gray.step, dst.ptr(), dst.step, w, h, 60, 0, 255);
+        });
+        ok &= bench_kernel(opt, size, "transpose", outt, outtb, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::transpose : nsk::transpose)(gray.ptr(), gray.step, dst.ptr(), dst.step, w, h);
+        });
+        ok &= bench_kernel(opt, size, "alpha_blend", out1, out1b, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::alpha_blend : nsk::alpha_blend)(gray.ptr(), gray.step, gray2.ptr(), gray2.step,
+                                                             alpha.ptr(), alpha.step, dst.ptr(), dst.step, w, h);
+        });
+        ok &= bench_kernel(opt, size, "lut", out1, out1b, [&](bool ref, Frame& dst) {
+            (ref ? nsk::ref::lut : nsk::lut)(gray.ptr(), gray.step, dst.ptr(), dst.step, w, h, table);
+        });
+    }
+    return ok ? 0 : 1;
+}
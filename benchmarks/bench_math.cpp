@@ -0,0 +1,109 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// The array forms of neon_sim_math.hpp against a loop over the float libm
+// function (expf, logf, ...; sigmoid is 1 / (1 + expf(-x))), one float per
+// pixel of each frame size. Inputs are uniform over the range each function
+// is usually fed. Every NEON result is checked against libm in double
+// precision with the documented ULP bound. Ends with Mval/s per case.
+
+namespace nsm = neon_sim_kernels::math;
+
+struct Domain
+{
+    const char* name;
+    float lo, hi;
+};
+
+static const Domain kDomains[] = {
+    { "exp", -20.0f, 20.0f },  { "log", 1e-6f, 1e6f },     { "sin", -100.0f, 100.0f }, { "cos", -100.0f, 100.0f },
+    { "tanh", -8.0f, 8.0f },   { "sigmoid", -8.0f, 8.0f }, { "erf", -4.0f, 4.0f },
+};
+
+static double max_ulp(const nsm::Function& f, const std::vector<float>& in, const std::vector<float>& out)
+{
+    double worst = 0;
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        const double exact = f.reference(in[i]);
+        int e;
+        frexp(exact, &e);
+        worst = std::max(worst, fabs((double)out[i] - exact) / ldexp(1.0, std::max(e - 24, -149)));
+    }
+    return worst;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double mvals;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height;
+        for (const Domain& d : kDomains)
+        {
+            if (!bench_selected(opt, d.name))
+            {
+                continue;
+            }
+            const nsm::Function& f = *nsm::find_function(d.name);
+            std::vector<float> in(n), expected(n), actual(n);
+            std::mt19937 rng(1);
+            std::uniform_real_distribution<float> dist(d.lo, d.hi);
+            for (size_t i = 0; i < n; i++)
+            {
+                in[i] = dist(rng);
+            }
+            const double ms_libm = bench_time_ms(opt.iters, [&] {
+                for (size_t i = 0; i < n; i++)
+                {
+                    expected[i] = f.libm(in[i]);
+                }
+            });
+            const double ms_neon = bench_time_ms(opt.iters, [&] { f.array(in.data(), actual.data(), n); });
+            bench_report(d.name, "libm", size, ms_libm);
+            bench_report(d.name, "neon", size, ms_neon);
+            rates.push_back({ d.name, "libm", size.name, n / (ms_libm * 1e3) });
+            rates.push_back({ d.name, "neon", size.name, n / (ms_neon * 1e3) });
+            const double err = max_ulp(f, in, actual);
+            if (err > f.max_ulp)
+            {
+                fprintf(stderr, "%s %s: %.3f ulp, bound %.1f\n", d.name, size.name, err, f.max_ulp);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "Mval/s");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].mvals);
+    }
+    return ok ? 0 : 1;
+}
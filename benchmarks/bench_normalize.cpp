@@ -0,0 +1,147 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+
+#include <cmath>
+#include <random>
+
+// Normalizes one 3-vector per pixel (x, y, z planes) three ways: scalar
+// x / sqrtf(len2), vsqrtq + vdivq, and vrsqrteq refined by two vrsqrtsq
+// Newton steps. vdivq must match the scalar loop to within the rounding of
+// the squared length, the estimate path to a few ulps. Ends with Mvec/s per
+// case. The q forms run on divps / sqrtps; build with
+// -DNEON_SIM_AVX2=ON to run vrsqrtsq on FMA3.
+
+struct Planes
+{
+    std::vector<float> x, y, z;
+    explicit Planes(size_t n) : x(n), y(n), z(n) {}
+};
+
+static void normalize_scalar(const Planes& in, Planes& out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        const float len = sqrtf(in.x[i] * in.x[i] + in.y[i] * in.y[i] + in.z[i] * in.z[i]);
+        out.x[i] = in.x[i] / len;
+        out.y[i] = in.y[i] / len;
+        out.z[i] = in.z[i] / len;
+    }
+}
+
+static void normalize_div(const Planes& in, Planes& out, size_t n)
+{
+    for (size_t i = 0; i < n; i += 4)
+    {
+        const float32x4_t x = vld1q_f32(&in.x[i]);
+        const float32x4_t y = vld1q_f32(&in.y[i]);
+        const float32x4_t z = vld1q_f32(&in.z[i]);
+        const float32x4_t len2 = vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z));
+        const float32x4_t len = vsqrtq_f32(len2);
+        vst1q_f32(&out.x[i], vdivq_f32(x, len));
+        vst1q_f32(&out.y[i], vdivq_f32(y, len));
+        vst1q_f32(&out.z[i], vdivq_f32(z, len));
+    }
+}
+
+static void normalize_rsqrt(const Planes& in, Planes& out, size_t n)
+{
+    for (size_t i = 0; i < n; i += 4)
+    {
+        const float32x4_t x = vld1q_f32(&in.x[i]);
+        const float32x4_t y = vld1q_f32(&in.y[i]);
+        const float32x4_t z = vld1q_f32(&in.z[i]);
+        const float32x4_t len2 = vaddq_f32(vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y)), vmulq_f32(z, z));
+        float32x4_t inv = vrsqrteq_f32(len2);
+        inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(len2, inv), inv));
+        inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(len2, inv), inv));
+        vst1q_f32(&out.x[i], vmulq_f32(x, inv));
+        vst1q_f32(&out.y[i], vmulq_f32(y, inv));
+        vst1q_f32(&out.z[i], vmulq_f32(z, inv));
+    }
+}
+
+static double max_error(const Planes& a, const Planes& b, size_t n)
+{
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        err = std::max(err, (double)fabsf(a.x[i] - b.x[i]));
+        err = std::max(err, (double)fabsf(a.y[i] - b.y[i]));
+        err = std::max(err, (double)fabsf(a.z[i] - b.z[i]));
+    }
+    return err;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double mvecs;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        if (!bench_selected(opt, "normalize"))
+        {
+            break;
+        }
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = ((size_t)size.width * size.height + 3) & ~(size_t)3;
+        Planes in(n), expected(n), actual(n);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (size_t i = 0; i < n; i++)
+        {
+            in.x[i] = dist(rng);
+            in.y[i] = dist(rng);
+            in.z[i] = dist(rng) + 2.0f; // keeps every length away from 0
+        }
+        const double ms_scalar = bench_time_ms(opt.iters, [&] { normalize_scalar(in, expected, n); });
+        bench_report("normalize", "scalar", size, ms_scalar);
+        rates.push_back({ "normalize", "scalar", size.name, n / (ms_scalar * 1e3) });
+
+        // the scalar length may be contracted into FMAs, so allow an ulp
+        const struct
+        {
+            const char* impl;
+            void (*fn)(const Planes&, Planes&, size_t);
+            double tolerance;
+        } variants[] = { { "div", normalize_div, 2e-7 }, { "rsqrt", normalize_rsqrt, 1e-6 } };
+        for (const auto& v : variants)
+        {
+            const double ms = bench_time_ms(opt.iters, [&] { v.fn(in, actual, n); });
+            bench_report("normalize", v.impl, size, ms);
+            rates.push_back({ "normalize", v.impl, size.name, n / (ms * 1e3) });
+            const double err = max_error(actual, expected, n);
+            if (err > v.tolerance)
+            {
+                fprintf(stderr, "normalize %s %s: max error %g against scalar\n", v.impl, size.name, err);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "Mvec/s");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].mvecs);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_compare.hpp"
+#include "neon_sim_kernels.hpp"
+#include "neon_sim_parallel.hpp"
+
+#include <random>
+#include <thread>
+
+// Scaling of the neon_sim_kernels through parallel_rows / parallel_tiles,
+// from 1 thread up to --threads (default: one per core).
+
+namespace nsk = neon_sim_kernels;
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+static std::vector<int> thread_counts(int max_threads)
+{
+    std::vector<int> counts;
+    for (int n = 1; n < max_threads; n *= 2)
+    {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    const int max_threads = opt.threads > 0 ? opt.threads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    uint8_t table[256];
+    for (int i = 0; i < 256; i++)
+    {
+        table[i] = (uint8_t)(i * 7);
+    }
+
+    bool ok = true;
+    printf("%-16s %-8s %-10s %12s %12s %10s %8s\n", "benchmark", "threads", "size", "ms", "Mpix/s", "speedup", "steals");
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int w = size.width;
+        const int h = size.height;
+        const std::vector<uint8_t> rgb = random_bytes((size_t)w * h * 3, 1);
+        const std::vector<uint8_t> gray = random_bytes((size_t)w * h, 2);
+        std::vector<uint8_t> expected((size_t)w * h);
+        std::vector<uint8_t> actual((size_t)w * h);
+
+        struct Case
+        {
+            const char* name;
+            std::function<void(int, int)> serial;         // full frame, y0 = 0, y1 = h
+            std::function<void(nsk::ThreadPool&, nsk::ParallelStats*)> parallel;
+        };
+        std::vector<Case> cases;
+        cases.push_back({ "rgb2gray",
+            [&](int, int) { nsk::rgb2gray(rgb.data(), w * 3, expected.data(), w, w, h); },
+            [&](nsk::ThreadPool& pool, nsk::ParallelStats* st) {
+                nsk::parallel_rows(pool, h, 0, [&](int y0, int y1, int) {
+                    nsk::rgb2gray(rgb.data() + (size_t)y0 * w * 3, w * 3, actual.data() + (size_t)y0 * w, w, w, y1 - y0);
+                }, st);
+            } });
+        cases.push_back({ "threshold",
+            [&](int, int) { nsk::threshold(gray.data(), w, expected.data(), w, w, h, 100, 0, 255); },
+            [&](nsk::ThreadPool& pool, nsk::ParallelStats* st) {
+                nsk::parallel_rows(pool, h, 0, [&](int y0, int y1, int) {
+                    nsk::threshold(gray.data() + (size_t)y0 * w, w, actual.data() + (size_t)y0 * w, w, w, y1 - y0, 100, 0, 255);
+                }, st);
+            } });
+        cases.push_back({ "lut",
+            [&](int, int) { nsk::lut(gray.data(), w, expected.data(), w, w, h, table); },
+            [&](nsk::ThreadPool& pool, nsk::ParallelStats* st) {
+                nsk::parallel_rows(pool, h, 0, [&](int y0, int y1, int) {
+                    nsk::lut(gray.data() + (size_t)y0 * w, w, actual.data() + (size_t)y0 * w, w, w, y1 - y0, table);
+                }, st);
+            } });
+        cases.push_back({ "transpose",
+            [&](int, int) { nsk::transpose(gray.data(), w, expected.data(), h, w, h); },
+            [&](nsk::ThreadPool& pool, nsk::ParallelStats* st) {
+                nsk::parallel_tiles(pool, w, h, 64, 64, [&](int x0, int y0, int x1, int y1, int) {
+                    nsk::transpose(gray.data() + (size_t)y0 * w + x0, w, actual.data() + (size_t)x0 * h + y0, h, x1 - x0, y1 - y0);
+                }, st);
+            } });
+
+        for (size_t c = 0; c < cases.size(); c++)
+        {
+            if (!bench_selected(opt, cases[c].name))
+            {
+                continue;
+            }
+            cases[c].serial(0, h);
+            double base_ms = 0;
+            const std::vector<int> counts = thread_counts(max_threads);
+            for (size_t t = 0; t < counts.size(); t++)
+            {
+                nsk::ThreadPool pool(counts[t]);
+                nsk::ParallelStats stats;
+                const double ms = bench_time_ms(opt.iters, [&] { cases[c].parallel(pool, &stats); });
+                if (t == 0)
+                {
+                    base_ms = ms;
+                }
+                const double mpix = (double)w * h / 1e6;
+                printf("%-16s %-8d %-10s %12.3f %12.2f %9.2fx %8zu\n", cases[c].name, counts[t], size.name, ms,
+                       mpix / (ms / 1000.0), base_ms / ms, stats.steals());
+                fflush(stdout);
+
+                if (!compare_array(expected.data(), actual.data(), expected.size()).ok())
+                {
+                    fprintf(stderr, "%s %s: %d threads differ from the serial run\n", cases[c].name, size.name, counts[t]);
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
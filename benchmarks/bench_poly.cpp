@@ -0,0 +1,248 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+
+#include <random>
+
+// CRC-32 (IEEE) by PMULL folding against the byte table, and GHASH by PMULL
+// Karatsuba against the bit-serial definition of SP 800-38D. Each frame size
+// is taken as a byte count. Ends with GB/s per case. vmull_p64 runs on
+// PCLMULQDQ when built with -DNEON_SIM_PCLMUL=ON.
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+//----- CRC-32
+
+static uint32_t crc_table[256];
+
+static void init_crc_table()
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[i] = c;
+    }
+}
+
+// raw reflected update: no initial value or final xor
+static uint32_t crc_update(uint32_t crc, const uint8_t* p, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        crc = crc_table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint32_t crc32_table(const uint8_t* p, size_t n)
+{
+    return ~crc_update(0xffffffffu, p, n);
+}
+
+// folds 16 byte blocks into a 128-bit remainder: x' = x.lo * x^160 + x.hi * x^96 + next (mod P, reflected)
+static uint32_t crc32_pmull(const uint8_t* p, size_t n)
+{
+    uint32_t crc = 0xffffffffu;
+    if (n >= 32)
+    {
+        static const poly64_t k[2] = { 0x1751997d0ull, 0x0ccaa009eull };
+        const poly64x2_t fold = vld1q_p64(k);
+        uint8_t init[16] = { 0xff, 0xff, 0xff, 0xff };
+        uint8x16_t x = veorq_u8(vld1q_u8(p), vld1q_u8(init));
+        p += 16;
+        n -= 16;
+        while (n >= 16)
+        {
+            const poly64x2_t x64 = vreinterpretq_p64_u8(x);
+            const uint8x16_t lo = vreinterpretq_u8_p128(vmull_p64(vgetq_lane_p64(x64, 0), vgetq_lane_p64(fold, 0)));
+            const uint8x16_t hi = vreinterpretq_u8_p128(vmull_high_p64(x64, fold));
+            x = veorq_u8(veorq_u8(lo, hi), vld1q_u8(p));
+            p += 16;
+            n -= 16;
+        }
+        uint8_t rest[16];
+        vst1q_u8(rest, x);
+        crc = crc_update(0, rest, 16);
+    }
+    return ~crc_update(crc, p, n);
+}
+
+//----- GHASH
+
+// SP 800-38D algorithm 1 on big-endian blocks: Z = X * Y in GF(2^128)
+static void gf128_mul_bitwise(const uint8_t* x, const uint8_t* y, uint8_t* z)
+{
+    uint8_t v[16];
+    uint8_t r[16] = { 0 };
+    memcpy(v, y, 16);
+    for (int i = 0; i < 128; i++)
+    {
+        if (x[i / 8] & (0x80 >> (i % 8)))
+        {
+            for (int b = 0; b < 16; b++)
+            {
+                r[b] ^= v[b];
+            }
+        }
+        const bool lsb = v[15] & 1;
+        for (int b = 15; b > 0; b--)
+        {
+            v[b] = (uint8_t)((v[b] >> 1) | (v[b - 1] << 7));
+        }
+        v[0] >>= 1;
+        if (lsb)
+        {
+            v[0] ^= 0xe1;
+        }
+    }
+    memcpy(z, r, 16);
+}
+
+static void ghash_bitwise(const uint8_t* h, const uint8_t* p, size_t n, uint8_t* y)
+{
+    memset(y, 0, 16);
+    for (size_t i = 0; i + 16 <= n; i += 16)
+    {
+        uint8_t t[16];
+        for (int b = 0; b < 16; b++)
+        {
+            t[b] = y[b] ^ p[i + b];
+        }
+        gf128_mul_bitwise(t, h, y);
+    }
+}
+
+// a block as a 128-bit big-endian integer, lane 1 the high half
+static uint64x2_t load_be128(const uint8_t* p)
+{
+    const poly64x2_t r = vreinterpretq_p64_u8(vrev64q_u8(vld1q_u8(p)));
+    const uint64_t swapped[2] = { vgetq_lane_p64(r, 1), vgetq_lane_p64(r, 0) };
+    return vld1q_u64(swapped);
+}
+
+static void store_be128(uint8_t* p, uint64x2_t v)
+{
+    const uint64_t swapped[2] = { vgetq_lane_u64(v, 1), vgetq_lane_u64(v, 0) };
+    vst1q_u8(p, vrev64q_u8(vreinterpretq_u8_p64(vld1q_p64(swapped))));
+}
+
+// Karatsuba product, shift by one for the bit reflection, then the shift-xor
+// reduction by x^128 + x^7 + x^2 + x + 1 (Gueron and Kounavis)
+static uint64x2_t gf128_mul_pmull(uint64x2_t a, uint64x2_t b)
+{
+    const uint64x2_t c = vreinterpretq_u64_p128(vmull_p64(vgetq_lane_u64(a, 0), vgetq_lane_u64(b, 0)));
+    const uint64x2_t d = vreinterpretq_u64_p128(vmull_high_p64(a, b));
+    const uint64x2_t e = vreinterpretq_u64_p128(vmull_p64(vgetq_lane_u64(a, 0) ^ vgetq_lane_u64(a, 1),
+                                                          vgetq_lane_u64(b, 0) ^ vgetq_lane_u64(b, 1)));
+    const uint64x2_t m = veorq_u64(veorq_u64(e, c), d);
+    uint64_t x0 = vgetq_lane_u64(c, 0);
+    uint64_t x1 = vgetq_lane_u64(c, 1) ^ vgetq_lane_u64(m, 0);
+    uint64_t x2 = vgetq_lane_u64(d, 0) ^ vgetq_lane_u64(m, 1);
+    uint64_t x3 = vgetq_lane_u64(d, 1);
+
+    x3 = (x3 << 1) | (x2 >> 63);
+    x2 = (x2 << 1) | (x1 >> 63);
+    x1 = (x1 << 1) | (x0 >> 63);
+    x0 <<= 1;
+
+    const uint64_t dd = x1 ^ (x0 << 63) ^ (x0 << 62) ^ (x0 << 57);
+    const uint64_t h0 = x0 ^ ((x0 >> 1) | (dd << 63)) ^ ((x0 >> 2) | (dd << 62)) ^ ((x0 >> 7) | (dd << 57));
+    const uint64_t h1 = dd ^ (dd >> 1) ^ (dd >> 2) ^ (dd >> 7);
+    const uint64_t r[2] = { x2 ^ h0, x3 ^ h1 };
+    return vld1q_u64(r);
+}
+
+static void ghash_pmull(const uint8_t* h, const uint8_t* p, size_t n, uint8_t* y)
+{
+    const uint64x2_t hv = load_be128(h);
+    uint64x2_t acc = vdupq_n_p64(0);
+    for (size_t i = 0; i + 16 <= n; i += 16)
+    {
+        acc = gf128_mul_pmull(veorq_u64(acc, load_be128(p + i)), hv);
+    }
+    store_be128(y, acc);
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    init_crc_table();
+    struct Rate
+    {
+        const char* name;
+        const char* impl;
+        const char* size;
+        double gbps;
+    };
+    std::vector<Rate> rates;
+    bool ok = true;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height;
+        const std::vector<uint8_t> data = random_bytes(n, 1);
+        const std::vector<uint8_t> key = random_bytes(16, 2);
+
+        if (bench_selected(opt, "crc32"))
+        {
+            uint32_t expected = 0, actual = 0;
+            const double ms_table = bench_time_ms(opt.iters, [&] { expected = crc32_table(data.data(), n); });
+            const double ms_pmull = bench_time_ms(opt.iters, [&] { actual = crc32_pmull(data.data(), n); });
+            bench_report("crc32", "table", size, ms_table);
+            bench_report("crc32", "pmull", size, ms_pmull);
+            rates.push_back({ "crc32", "table", size.name, n / (ms_table * 1e6) });
+            rates.push_back({ "crc32", "pmull", size.name, n / (ms_pmull * 1e6) });
+            if (actual != expected)
+            {
+                fprintf(stderr, "crc32 %s: pmull %08x, table %08x\n", size.name, actual, expected);
+                ok = false;
+            }
+        }
+        if (bench_selected(opt, "ghash"))
+        {
+            uint8_t expected[16], actual[16];
+            const double ms_bitwise = bench_time_ms(opt.iters, [&] { ghash_bitwise(key.data(), data.data(), n, expected); });
+            const double ms_pmull = bench_time_ms(opt.iters, [&] { ghash_pmull(key.data(), data.data(), n, actual); });
+            bench_report("ghash", "bitwise", size, ms_bitwise);
+            bench_report("ghash", "pmull", size, ms_pmull);
+            rates.push_back({ "ghash", "bitwise", size.name, n / (ms_bitwise * 1e6) });
+            rates.push_back({ "ghash", "pmull", size.name, n / (ms_pmull * 1e6) });
+            if (memcmp(actual, expected, 16) != 0)
+            {
+                fprintf(stderr, "ghash %s: pmull and bitwise differ\n", size.name);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-16s %-8s %-10s %10s\n", "benchmark", "impl", "size", "GB/s");
+    for (size_t i = 0; i < rates.size(); i++)
+    {
+        printf("%-16s %-8s %-10s %10.3f\n", rates[i].name, rates[i].impl, rates[i].size, rates[i].gbps);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#define NEON_SIM_IMPLEMENTATION
+#include "arm_sme_sim.hpp"
+
+#include "bench_util.hpp"
+
+#include <cmath>
+#include <random>
+
+// Square single precision GEMM written as an SME micro-kernel (2x2 ZA tiles of
+// FMOPA per k step) against a scalar loop with the same fused order, at every
+// streaming vector length. Matrix sizes are fixed, --size is ignored; the
+// Mpix/s column counts output elements. Ends with GFLOPS per case.
+
+// C = A * B, At is A transposed (K x M) as SME kernels pack it
+static void sme_sgemm(const float* At, const float* B, float* C, int n)
+{
+    SmeStreamingScope streaming;
+    const int dim = (int)svcntsw();
+    for (int i0 = 0; i0 < n; i0 += 2 * dim)
+    {
+        const svbool_t pn0 = svwhilelt_b32_s32(i0, n);
+        const svbool_t pn1 = svwhilelt_b32_s32(i0 + dim, n);
+        for (int j0 = 0; j0 < n; j0 += 2 * dim)
+        {
+            const svbool_t pm0 = svwhilelt_b32_s32(j0, n);
+            const svbool_t pm1 = svwhilelt_b32_s32(j0 + dim, n);
+            svzero_za();
+            for (int k = 0; k < n; k++)
+            {
+                const svfloat32_t a0 = svld1_f32(pn0, At + k * n + i0);
+                const svfloat32_t a1 = svld1_f32(pn1, At + k * n + i0 + dim);
+                const svfloat32_t b0 = svld1_f32(pm0, B + k * n + j0);
+                const svfloat32_t b1 = svld1_f32(pm1, B + k * n + j0 + dim);
+                svmopa_za32_f32_m(0, pn0, pm0, a0, b0);
+                svmopa_za32_f32_m(1, pn0, pm1, a0, b1);
+                svmopa_za32_f32_m(2, pn1, pm0, a1, b0);
+                svmopa_za32_f32_m(3, pn1, pm1, a1, b1);
+            }
+            for (int r = 0; r < dim; r++)
+            {
+                if (i0 + r < n)
+                {
+                    svst1_hor_za32(0, (uint32_t)r, pm0, C + (i0 + r) * n + j0);
+                    svst1_hor_za32(1, (uint32_t)r, pm1, C + (i0 + r) * n + j0 + dim);
+                }
+                if (i0 + dim + r < n)
+                {
+                    svst1_hor_za32(2, (uint32_t)r, pm0, C + (i0 + dim + r) * n + j0);
+                    svst1_hor_za32(3, (uint32_t)r, pm1, C + (i0 + dim + r) * n + j0 + dim);
+                }
+            }
+        }
+    }
+}
+
+static void ref_sgemm(const float* A, const float* B, float* C, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        float* c = C + i * n;
+        for (int j = 0; j < n; j++)
+        {
+            c[j] = 0.0f;
+        }
+        for (int k = 0; k < n; k++)
+        {
+            const float a = A[i * n + k];
+            for (int j = 0; j < n; j++)
+            {
+                c[j] = std::fma(a, B[k * n + j], c[j]);
+            }
+        }
+    }
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    const BenchSize sizes[] = { { "128x128", 128, 128 }, { "256x256", 256, 256 }, { "512x512", 512, 512 } };
+    const int svls[] = { 128, 256, 512, 1024, 2048 };
+    struct Flops
+    {
+        const char* impl;
+        const char* size;
+        double gflops;
+    };
+    std::vector<Flops> flops;
+    bool ok = true;
+
+    bench_header();
+    for (const BenchSize& size : sizes)
+    {
+        const int n = size.width;
+        std::vector<float> A((size_t)n * n), At((size_t)n * n), B((size_t)n * n);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        for (size_t i = 0; i < A.size(); i++)
+        {
+            A[i] = dist(rng);
+            B[i] = dist(rng);
+        }
+        for (int i = 0; i < n; i++)
+        {
+            for (int k = 0; k < n; k++)
+            {
+                At[(size_t)k * n + i] = A[(size_t)i * n + k];
+            }
+        }
+        const double ops = 2.0 * n * n * n;
+        std::vector<float> expected((size_t)n * n);
+        if (bench_selected(opt, "sgemm"))
+        {
+            const double ms = bench_time_ms(opt.iters, [&] { ref_sgemm(A.data(), B.data(), expected.data(), n); });
+            bench_report("sgemm", "ref", size, ms);
+            flops.push_back({ "ref", size.name, ops / (ms * 1e6) });
+        }
+        for (size_t s = 0; s < sizeof(svls) / sizeof(svls[0]) && bench_selected(opt, "sgemm"); s++)
+        {
+            sme_sim_set_svl(svls[s]);
+            static char impls[sizeof(svls) / sizeof(svls[0])][16];
+            char* impl = impls[s];
+            snprintf(impl, sizeof(impls[s]), "sme%d", svls[s]);
+            std::vector<float> C((size_t)n * n);
+            const double ms = bench_time_ms(opt.iters, [&] { sme_sgemm(At.data(), B.data(), C.data(), n); });
+            bench_report("sgemm", impl, size, ms);
+            flops.push_back({ impl, size.name, ops / (ms * 1e6) });
+            if (memcmp(C.data(), expected.data(), C.size() * sizeof(float)) != 0)
+            {
+                fprintf(stderr, "sgemm %s %s: sme and ref differ\n", impl, size.name);
+                ok = false;
+            }
+        }
+    }
+
+    printf("\n%-8s %-10s %10s\n", "impl", "size", "GFLOPS");
+    for (size_t i = 0; i < flops.size(); i++)
+    {
+        printf("%-8s %-10s %10.3f\n", flops[i].impl, flops[i].size, flops[i].gflops);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#define NEON_SIM_IMPLEMENTATION
+#include "arm_neon_sim.hpp"
+
+#include "bench_util.hpp"
+
+#include <algorithm>
+#include <random>
+
+// The sim against the NEON_SIM_FAST_SSE routes of neon_sim_sse_routes.inc.
+// Each case streams a frame (taken as a byte count) through one intrinsic:
+// impl "sim" calls `(name)(...)`, which always reaches the sim, impl "sse"
+// calls `name(...)`, which expands to the NEON_2_SSE bridge. The two must
+// write the same bytes. Only built with -DNEON_SIM_FAST_SSE=ON; use a release
+// build, the bridge call is what is being measured.
+
+#if !NEON_SIM_FAST_SSE
+#error bench_sse_routes needs NEON_SIM_FAST_SSE
+#endif
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+// dst = op(a, b) over n bytes of V registers. The registers are reached
+// through plain pointers rather than vld1/vst1, so only the intrinsic is timed.
+#define BENCH_OP_2(fn, V) \
+    [&](uint8_t* dst) \
+    { \
+        const V* va = (const V*)a.data(); \
+        const V* vb = (const V*)b.data(); \
+        V* vd = (V*)dst; \
+        for (size_t i = 0; i < n / sizeof(V); i++) \
+        { \
+            vd[i] = fn(va[i], vb[i]); \
+        } \
+    }
+
+// dst = op(dst, a, b) for the widening accumulators: W is twice the size of V
+#define BENCH_OP_3(fn, V, W) \
+    [&](uint8_t* dst) \
+    { \
+        const V* va = (const V*)a.data(); \
+        const V* vb = (const V*)b.data(); \
+        W* vd = (W*)dst; \
+        for (size_t i = 0; i < n / sizeof(W); i++) \
+        { \
+            vd[i] = fn(vd[i], va[i], vb[i]); \
+        } \
+    }
+
+template<typename Sim, typename Sse>
+static bool bench_route(const BenchOptions& opt, const BenchSize& size, const char* name, size_t n, Sim sim, Sse sse)
+{
+    if (!bench_selected(opt, name))
+    {
+        return true;
+    }
+    std::vector<uint8_t> expected(n), actual(n);
+    bench_report(name, "sim", size, bench_time_ms(opt.iters, [&] { sim(expected.data()); }));
+    bench_report(name, "sse", size, bench_time_ms(opt.iters, [&] { sse(actual.data()); }));
+
+    // the accumulating cases ran a different number of times, so compare one fresh pass
+    std::fill(expected.begin(), expected.end(), 0);
+    std::fill(actual.begin(), actual.end(), 0);
+    sim(expected.data());
+    sse(actual.data());
+    if (expected != actual)
+    {
+        fprintf(stderr, "%s %s: sim and sse differ\n", name, size.name);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    bool ok = true;
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const size_t n = (size_t)size.width * size.height;
+        const std::vector<uint8_t> a = random_bytes(n, 1);
+        const std::vector<uint8_t> b = random_bytes(n, 2);
+
+        ok &= bench_route(opt, size, "vaddq_u8", n, BENCH_OP_2((vaddq_u8), uint8x16_t),
+                          BENCH_OP_2(vaddq_u8, uint8x16_t));
+        ok &= bench_route(opt, size, "vqsubq_s16", n, BENCH_OP_2((vqsubq_s16), int16x8_t),
+                          BENCH_OP_2(vqsubq_s16, int16x8_t));
+        ok &= bench_route(opt, size, "vmulq_s16", n, BENCH_OP_2((vmulq_s16), int16x8_t),
+                          BENCH_OP_2(vmulq_s16, int16x8_t));
+        ok &= bench_route(opt, size, "vmaxq_u8", n, BENCH_OP_2((vmaxq_u8), uint8x16_t),
+                          BENCH_OP_2(vmaxq_u8, uint8x16_t));
+        ok &= bench_route(opt, size, "vhsub_u8", n, BENCH_OP_2((vhsub_u8), uint8x8_t),
+                          BENCH_OP_2(vhsub_u8, uint8x8_t));
+        ok &= bench_route(opt, size, "vmlal_u8", n, BENCH_OP_3((vmlal_u8), uint8x8_t, uint16x8_t),
+                          BENCH_OP_3(vmlal_u8, uint8x8_t, uint16x8_t));
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#define NEON_SIM_IMPLEMENTATION
+#include "arm_sve_sim.hpp"
+
+#include "bench_util.hpp"
+
+#include <random>
+
+// Vector-length scaling of SVE kernels: each kernel runs at 128 to 2048 bits.
+// "ms" is the simulation time; the loop trip count per frame that follows
+// the table is what shrinks on wider hardware.
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+// dst = src > thresh ? hi : lo; returns the vector loop trips
+static size_t sve_threshold(const uint8_t* src, uint8_t* dst, int64_t n, uint8_t thresh, uint8_t hi, uint8_t lo)
+{
+    size_t trips = 0;
+    const svuint8_t vhi = svdup_n_u8(hi);
+    const svuint8_t vlo = svdup_n_u8(lo);
+    for (int64_t i = 0; i < n; i += svcntb())
+    {
+        const svbool_t pg = svwhilelt_b8_s64(i, n);
+        const svuint8_t v = svld1_u8(pg, src + i);
+        svst1_u8(pg, dst + i, svsel_u8(svcmpgt_n_u8(pg, v, thresh), vhi, vlo));
+        trips++;
+    }
+    return trips;
+}
+
+// y = a * x + y over floats
+static size_t sve_saxpy(float a, const float* x, float* y, int64_t n)
+{
+    size_t trips = 0;
+    for (int64_t i = 0; i < n; i += svcntw())
+    {
+        const svbool_t pg = svwhilelt_b32_s64(i, n);
+        svst1_f32(pg, y + i, svmla_n_f32_x(pg, svld1_f32(pg, y + i), svld1_f32(pg, x + i), a));
+        trips++;
+    }
+    return trips;
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+    const int vls[] = { 128, 256, 512, 1024, 2048 };
+    struct Trips
+    {
+        const char* name;
+        const char* size;
+        int vl;
+        size_t trips;
+    };
+    std::vector<Trips> trips;
+
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int64_t n = (int64_t)size.width * size.height;
+        const std::vector<uint8_t> gray = random_bytes((size_t)n, 1);
+        std::vector<uint8_t> dst((size_t)n);
+        std::vector<float> x((size_t)n, 0.5f);
+        std::vector<float> y((size_t)n, 2.0f);
+        for (int vl : vls)
+        {
+            sve_sim_set_vl(vl);
+            char impl[16];
+            snprintf(impl, sizeof(impl), "sve%d", vl);
+            if (bench_selected(opt, "threshold"))
+            {
+                size_t t = 0;
+                bench_report("threshold", impl, size,
+                             bench_time_ms(opt.iters, [&] { t = sve_threshold(gray.data(), dst.data(), n, 60, 255, 0); }));
+                trips.push_back({ "threshold", size.name, vl, t });
+            }
+            if (bench_selected(opt, "saxpy"))
+            {
+                size_t t = 0;
+                bench_report("saxpy", impl, size, bench_time_ms(opt.iters, [&] { t = sve_saxpy(1.5f, x.data(), y.data(), n); }));
+                trips.push_back({ "saxpy", size.name, vl, t });
+            }
+        }
+    }
+
+    printf("\n%-16s %-10s %8s %14s\n", "benchmark", "size", "vl", "trips/frame");
+    for (size_t i = 0; i < trips.size(); i++)
+    {
+        printf("%-16s %-10s %8d %14zu\n", trips[i].name, trips[i].size, trips[i].vl, trips[i].trips);
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+//
+// Shared helpers for the benchmark executables: command line parsing, the
+// standard frame sizes and a min-of-N timer.
+//
+// usage:
+// BenchOptions opt;
+// if (!bench_parse(argc, argv, opt)) return 2;
+// for (const BenchSize& size : opt.sizes) {
+//     double ms = bench_time_ms(opt.iters, [&] { kernel(...); });
+//     bench_report("rgb2gray", "sim", size, ms);
+// }
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct BenchSize
+{
+    const char* name;
+    int width;
+    int height;
+};
+
+struct BenchOptions
+{
+    int iters = 3;
+    int threads = 0;                 // upper bound for scaling runs, 0 for one per core
+    std::string filter;              // substring of the benchmark name, empty runs all
+    std::vector<BenchSize> sizes;
+    std::vector<std::string> inputs; // image files, for benchmarks that read from disk
+    double ghz = 2.0;                // clock of the device a projection is made for
+    double ipc = 2.0;                // its 128 bit NEON operations per cycle
+};
+
+static inline std::vector<BenchSize> bench_default_sizes()
+{
+    std::vector<BenchSize> sizes;
+    sizes.push_back({ "720p", 1280, 720 });
+    sizes.push_back({ "1080p", 1920, 1080 });
+    sizes.push_back({ "4k", 3840, 2160 });
+    return sizes;
+}
+
+static inline void bench_usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [--iters=N] [--threads=N] [--filter=NAME] [--size=720p|1080p|4k|WxH]... [--input=PATH]...\n"
+            "       [--ghz=F] [--ipc=F]\n"
+            "  --iters   runs per case, the fastest one is reported (default 3)\n"
+            "  --threads largest thread count of scaling runs (default one per core)\n"
+            "  --filter  only run benchmarks whose name contains NAME\n"
+            "  --size    frame size, may be repeated (default 720p, 1080p and 4k)\n"
+            "  --input   image file, may be repeated (benchmarks that read from disk)\n"
+            "  --ghz     clock of the projected device (default 2.0)\n"
+            "  --ipc     128 bit NEON operations per cycle of that device (default 2.0)\n",
+            prog);
+}
+
+/// @brief parse the common options. Returns false (after printing usage) on bad input.
+static inline bool bench_parse(int argc, const char* const argv[], BenchOptions& opt)
+{
+    const std::vector<BenchSize> known = bench_default_sizes();
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--iters=", 8) == 0)
+        {
+            opt.iters = atoi(arg + 8);
+            if (opt.iters < 1)
+            {
+                bench_usage(argv[0]);
+                return false;
+            }
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0)
+        {
+            opt.threads = atoi(arg + 10);
+            if (opt.threads < 1)
+            {
+                bench_usage(argv[0]);
+                return false;
+            }
+        }
+        else if (strncmp(arg, "--input=", 8) == 0)
+        {
+            opt.inputs.push_back(arg + 8);
+        }
+        else if (strncmp(arg, "--ghz=", 6) == 0)
+        {
+            opt.ghz = atof(arg + 6);
+            if (opt.ghz <= 0)
+            {
+                bench_usage(argv[0]);
+                return false;
+            }
+        }
+        else if (strncmp(arg, "--ipc=", 6) == 0)
+        {
+            opt.ipc = atof(arg + 6);
+            if (opt.ipc <= 0)
+            {
+                bench_usage(argv[0]);
+                return false;
+            }
+        }
+        else if (strncmp(arg, "--filter=", 9) == 0)
+        {
+            opt.filter = arg + 9;
+        }
+        else if (strncmp(arg, "--size=", 7) == 0)
+        {
+            const char* v = arg + 7;
+            bool found = false;
+            for (size_t k = 0; k < known.size(); k++)
+            {
+                if (strcmp(v, known[k].name) == 0)
+                {
+                    opt.sizes.push_back(known[k]);
+                    found = true;
+                }
+            }
+            int w = 0;
+            int h = 0;
+            if (!found && sscanf(v, "%dx%d", &w, &h) == 2 && w > 0 && h > 0)
+            {
+                opt.sizes.push_back({ v, w, h });
+                found = true;
+            }
+            if (!found)
+            {
+                bench_usage(argv[0]);
+                return false;
+            }
+        }
+        else
+        {
+            bench_usage(argv[0]);
+            return false;
+        }
+    }
+    if (opt.sizes.empty())
+    {
+        opt.sizes = known;
+    }
+    return true;
+}
+
+static inline bool bench_selected(const BenchOptions& opt, const std::string& name)
+{
+    return opt.filter.empty() || name.find(opt.filter) != std::string::npos;
+}
+
+/// @brief run fn `iters` times, return the fastest run in milliseconds
+template<typename Fn>
+static double bench_time_ms(int iters, Fn fn)
+{
+    double best = 0;
+    for (int i = 0; i < iters; i++)
+    {
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        if (i == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+static inline void bench_header()
+{
+    printf("%-16s %-8s %-10s %12s %12s\n", "benchmark", "impl", "size", "ms", "Mpix/s");
+}
+
+static inline void bench_report(const char* name, const char* impl, const BenchSize& size, double ms)
+{
+    const double mpix = (double)size.width * size.height / 1e6;
+    printf("%-16s %-8s %-10s %12.3f %12.2f\n", name, impl, size.name, ms, ms > 0 ? mpix / (ms / 1000.0) : 0.0);
+    fflush(stdout);
+}
@@ -0,0 +1,144 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "bench_util.hpp"
+#include "neon_sim_compare.hpp"
+#include "neon_sim_yuv.hpp"
+
+#include <random>
+
+// The conversions of neon_sim_yuv.hpp against their scalar twins on a
+// random frame of each size, BT.601 limited range:
+//   nv21_bgr / nv12_rgba / i420_bgr   4:2:0 to packed RGB
+//   p010_rgb                          10 bit semi-planar to RGB
+//   bgr_nv21 / rgba_i420              RGB to 4:2:0
+//   rgb_p010                          RGB to 10 bit semi-planar
+// Mpix/s counts luma pixels. Outputs must match the twins bit for bit.
+
+namespace yuv = neon_sim_kernels::yuv;
+
+static const yuv::ColorSpace kSpace = yuv::BT601_LIMITED;
+
+template<typename Run>
+static bool bench_yuv(const BenchOptions& opt, const BenchSize& size, const char* name, std::vector<uint8_t>& expected,
+                      std::vector<uint8_t>& actual, Run run)
+{
+    if (!bench_selected(opt, name))
+    {
+        return true;
+    }
+    bench_report(name, "ref", size, bench_time_ms(opt.iters, [&] { run(true, expected.data()); }));
+    bench_report(name, "neon", size, bench_time_ms(opt.iters, [&] { run(false, actual.data()); }));
+
+    CompareResult res = compare_array(expected.data(), actual.data(), expected.size());
+    if (!res.ok())
+    {
+        fprintf(stderr, "%s %s: neon and ref differ\n", name, size.name);
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
+}
+
+int main(int argc, const char* const argv[])
+{
+    BenchOptions opt;
+    if (!bench_parse(argc, argv, opt))
+    {
+        return 2;
+    }
+
+    bool ok = true;
+    bench_header();
+    for (size_t k = 0; k < opt.sizes.size(); k++)
+    {
+        const BenchSize& size = opt.sizes[k];
+        const int w = size.width;
+        const int h = size.height;
+        const size_t n = (size_t)w * h;
+        std::mt19937 rng(1);
+
+        // one 4:2:0 frame, Y then the chroma plane(s), and its P010 twin
+        std::vector<uint8_t> frame(n * 3 / 2);
+        std::vector<uint16_t> frame10(frame.size());
+        for (size_t i = 0; i < frame.size(); i++)
+        {
+            frame[i] = (uint8_t)rng();
+            frame10[i] = (uint16_t)(rng() << 6);
+        }
+        const uint8_t* y = frame.data();
+        const uint8_t* chroma = y + n;
+        std::vector<uint8_t> rgb(n * 4), rgb_b(n * 4);
+        for (size_t i = 0; i < rgb.size(); i++)
+        {
+            rgb[i] = (uint8_t)rng();
+        }
+
+        std::vector<uint8_t> out(n * 4), out_b(n * 4);
+        ok &= bench_yuv(opt, size, "nv21_bgr", out, out_b, [&](bool ref, uint8_t* dst) {
+            if (ref)
+            {
+                yuv::ref::yuv420_to_rgb(y, w, chroma + 1, chroma, w, 2, dst, w * 3, w, h, yuv::LAYOUT_BGR, kSpace);
+            }
+            else
+            {
+                yuv::nv21_to_rgb(y, w, chroma, w, dst, w * 3, w, h, yuv::LAYOUT_BGR, kSpace);
+            }
+        });
+        ok &= bench_yuv(opt, size, "nv12_rgba", out, out_b, [&](bool ref, uint8_t* dst) {
+            if (ref)
+            {
+                yuv::ref::yuv420_to_rgb(y, w, chroma, chroma + 1, w, 2, dst, w * 4, w, h, yuv::LAYOUT_RGBA, kSpace);
+            }
+            else
+            {
+                yuv::nv12_to_rgb(y, w, chroma, w, dst, w * 4, w, h, yuv::LAYOUT_RGBA, kSpace);
+            }
+        });
+        const uint8_t* u = chroma;
+        const uint8_t* v = chroma + n / 4;
+        ok &= bench_yuv(opt, size, "i420_bgr", out, out_b, [&](bool ref, uint8_t* dst) {
+            if (ref)
+            {
+                yuv::ref::yuv420_to_rgb(y, w, u, v, w / 2, 1, dst, w * 3, w, h, yuv::LAYOUT_BGR, kSpace);
+            }
+            else
+            {
+                yuv::i420_to_rgb(y, w, u, v, w / 2, dst, w * 3, w, h, yuv::LAYOUT_BGR, kSpace);
+            }
+        });
+        ok &= bench_yuv(opt, size, "p010_rgb", out, out_b, [&](bool ref, uint8_t* dst) {
+            (ref ? yuv::ref::p010_to_rgb : yuv::p010_to_rgb)(frame10.data(), w * 2, frame10.data() + n, w * 2, dst,
+                                                             w * 3, w, h, yuv::LAYOUT_RGB, kSpace);
+        });
+
+        std::vector<uint8_t> yuv_out(n * 3 / 2), yuv_out_b(yuv_out.size());
+        ok &= bench_yuv(opt, size, "bgr_nv21", yuv_out, yuv_out_b, [&](bool ref, uint8_t* dst) {
+            if (ref)
+            {
+                yuv::ref::rgb_to_yuv420(rgb.data(), w * 3, yuv::LAYOUT_BGR, dst, w, dst + n + 1, dst + n, w, 2, w, h,
+                                        kSpace);
+            }
+            else
+            {
+                yuv::rgb_to_nv21(rgb.data(), w * 3, yuv::LAYOUT_BGR, dst, w, dst + n, w, w, h, kSpace);
+            }
+        });
+        ok &= bench_yuv(opt, size, "rgba_i420", yuv_out, yuv_out_b, [&](bool ref, uint8_t* dst) {
+            (ref ? yuv::ref::rgb_to_yuv420 : yuv::rgb_to_yuv420)(rgb.data(), w * 4, yuv::LAYOUT_RGBA, dst, w, dst + n,
+                                                                 dst + n + n / 4, w / 2, 1, w, h, kSpace);
+        });
+
+        // 16 bit Y then UV, compared as bytes
+        std::vector<uint8_t> p010_out(n * 3), p010_out_b(p010_out.size());
+        ok &= bench_yuv(opt, size, "rgb_p010", p010_out, p010_out_b, [&](bool ref, uint8_t* dst) {
+            uint16_t* y10 = (uint16_t*)dst;
+            (ref ? yuv::ref::rgb_to_p010 : yuv::rgb_to_p010)(rgb.data(), w * 3, yuv::LAYOUT_RGB, y10, w * 2, y10 + n,
+                                                             w * 2, w, h, kSpace);
+        });
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "neon_sim_kernels.hpp"
+#include "neon_sim_pipeline.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+
+// Runs a dataset of PGM/PPM files through a neon_sim kernel and its scalar
+// reference, compares the outputs and prints per-stage throughput.
+// Exit code: 0 all images match, 1 mismatches or load errors, 2 bad usage.
+
+namespace nsk = neon_sim_kernels;
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s --kernel=NAME [options] [FILE]...\n"
+            "  --kernel=NAME        rgb2gray, rgb2bgr (PPM input) or threshold, lut (PGM input)\n"
+            "  --list=PATH          read file names from PATH, one per line\n"
+            "  --generate=N         write N synthetic 1080p images and run on them\n"
+            "  --load-threads=N     (default 1)\n"
+            "  --sim-threads=N      (default one per core)\n"
+            "  --ref-threads=N      (default 1)\n"
+            "  --compare-threads=N  (default 1)\n"
+            "  --queue=N            capacity of each queue between stages (default 4)\n"
+            "  --eps=E              absolute tolerance (default 0, bit exact)\n",
+            prog);
+}
+
+static bool make_kernel(const std::string& name, nsk::DatasetKernel& k, int& input_channels)
+{
+    static uint8_t table[256];
+    for (int i = 0; i < 256; i++)
+    {
+        table[i] = (uint8_t)(255 - i);
+    }
+    k.name = name;
+    if (name == "rgb2gray")
+    {
+        input_channels = 3;
+        k.output_channels = 1;
+        k.sim = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::rgb2gray(in.data, in.step, out.data, out.step, in.width, in.height); };
+        k.ref = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::ref::rgb2gray(in.data, in.step, out.data, out.step, in.width, in.height); };
+    }
+    else if (name == "rgb2bgr")
+    {
+        input_channels = 3;
+        k.output_channels = 3;
+        k.sim = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::rgb2bgr(in.data, in.step, out.data, out.step, in.width, in.height); };
+        k.ref = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::ref::rgb2bgr(in.data, in.step, out.data, out.step, in.width, in.height); };
+    }
+    else if (name == "threshold")
+    {
+        input_channels = 1;
+        k.output_channels = 1;
+        k.sim = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::threshold(in.data, in.step, out.data, out.step, in.width, in.height, 128, 0, 255); };
+        k.ref = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::ref::threshold(in.data, in.step, out.data, out.step, in.width, in.height, 128, 0, 255); };
+    }
+    else if (name == "lut")
+    {
+        input_channels = 1;
+        k.output_channels = 1;
+        k.sim = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::lut(in.data, in.step, out.data, out.step, in.width, in.height, table); };
+        k.ref = [](const nsk::ImageView& in, const nsk::MutableImageView& out) { nsk::ref::lut(in.data, in.step, out.data, out.step, in.width, in.height, table); };
+    }
+    else
+    {
+        return false;
+    }
+    // reject images with the wrong channel count at load time
+    const int channels = input_channels;
+    k.open = [channels](const std::string& path, nsk::MappedImage& img) {
+        return img.open_pnm(path) && img.view().channels == channels;
+    };
+    return true;
+}
+
+int main(int argc, const char* const argv[])
+{
+    nsk::PipelineOptions opt;
+    std::string kernel_name;
+    std::vector<std::string> paths;
+    int generate = 0;
+    double eps = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* v = strchr(arg, '=');
+        v = v ? v + 1 : "";
+        if (strncmp(arg, "--kernel=", 9) == 0) kernel_name = v;
+        else if (strncmp(arg, "--list=", 7) == 0)
+        {
+            std::ifstream list(v);
+            if (!list)
+            {
+                fprintf(stderr, "cannot read %s\n", v);
+                return 2;
+            }
+            std::string line;
+            while (std::getline(list, line))
+            {
+                if (!line.empty())
+                {
+                    paths.push_back(line);
+                }
+            }
+        }
+        else if (strncmp(arg, "--generate=", 11) == 0) generate = atoi(v);
+        else if (strncmp(arg, "--load-threads=", 15) == 0) opt.load_threads = atoi(v);
+        else if (strncmp(arg, "--sim-threads=", 14) == 0) opt.sim_threads = atoi(v);
+        else if (strncmp(arg, "--ref-threads=", 14) == 0) opt.ref_threads = atoi(v);
+        else if (strncmp(arg, "--compare-threads=", 18) == 0) opt.compare_threads = atoi(v);
+        else if (strncmp(arg, "--queue=", 8) == 0) opt.queue_capacity = (size_t)atoi(v);
+        else if (strncmp(arg, "--eps=", 6) == 0) eps = atof(v);
+        else if (strncmp(arg, "--", 2) == 0)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        else paths.push_back(arg);
+    }
+
+    nsk::DatasetKernel kernel;
+    int input_channels = 0;
+    if (!make_kernel(kernel_name, kernel, input_channels))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    kernel.tolerance.abs_eps = eps;
+
+    std::vector<std::string> generated;
+    for (int i = 0; i < generate; i++)
+    {
+        const std::string path = "dataset_runner_" + std::to_string(i) + (input_channels == 3 ? ".ppm" : ".pgm");
+        nsk::MappedImage out;
+        if (!out.create_pnm(path, 1920, 1080, input_channels))
+        {
+            fprintf(stderr, "%s\n", out.error().c_str());
+            return 1;
+        }
+        const nsk::MutableImageView img = out.mutable_view();
+        for (int y = 0; y < img.height; y++)
+        {
+            for (int x = 0; x < img.width * img.channels; x++)
+            {
+                img.row(y)[x] = (uint8_t)(x * 3 + y * 5 + i);
+            }
+        }
+        paths.push_back(path);
+        generated.push_back(path);
+    }
+    if (paths.empty())
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    nsk::DatasetReport rep = nsk::run_dataset(paths, kernel, opt);
+    std::cout << "kernel: " << kernel.name << std::endl;
+    nsk::print_report(std::cout, rep);
+
+    for (size_t i = 0; i < generated.size(); i++)
+    {
+        remove(generated[i].c_str());
+    }
+    return rep.ok() ? 0 : 1;
+}
@@ -0,0 +1,345 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "neon_sim_parallel.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+
+// Sweeps floats through vrecpeq_f32 / vrsqrteq_f32 followed by 0-3 Newton
+// steps (vrecpsq_f32 / vrsqrtsq_f32) and reports the max and mean ULP error
+// against a double precision reference, next to the latency of the
+// dependent instruction chain under a simple cycle model. vdivq_f32 and
+// vsqrtq_f32 + vdivq_f32 are measured the same way as the exact baseline.
+// By default every one of the 2^32 bit patterns is visited, split over the
+// thread pool; --samples draws from a distribution instead.
+// Exit code: 0 done, 2 bad usage.
+
+namespace nsk = neon_sim_kernels;
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --op=NAME            recip, rsqrt or all (default all)\n"
+            "  --steps=N            Newton steps to report, 0 to 3 (default 3)\n"
+            "  --samples=N          N random inputs instead of all 2^32 floats\n"
+            "  --dist=KIND:LO:HI    uniform or log (log-uniform magnitude), default log:1e-30:1e30\n"
+            "  --stride=N           visit every Nth bit pattern of the full sweep (default 1)\n"
+            "  --threads=N          (default one per core)\n"
+            "  --cost=E,S,M,D,Q     cycles of estimate, step, fmul, fdiv, fsqrt (default 3,4,3,10,11)\n",
+            prog);
+}
+
+// Latencies of the 128-bit forms on a Cortex-A76-class core, rounded; the
+// chains are dependent, so their sum is what one refinement costs.
+struct CostModel
+{
+    int estimate = 3;
+    int step = 4;
+    int mul = 3;
+    int div = 10;
+    int sqrt = 11;
+};
+
+struct ErrorStats
+{
+    uint64_t count = 0;
+    uint64_t rounded = 0;   // results equal to the reference rounded to float
+    uint64_t nonfinite = 0; // inf or NaN where the reference is finite
+    double sum_ulp = 0;
+    double max_ulp = 0;
+    float worst = 0;        // input with the largest error
+
+    void add(float input, float approx, double exact)
+    {
+        count++;
+        if (!std::isfinite(approx))
+        {
+            nonfinite++;
+            return;
+        }
+        if (approx == (float)exact)
+        {
+            rounded++;
+        }
+        // ulp of a float in [2^(e-1), 2^e), subnormals included
+        int e;
+        frexp(exact, &e);
+        const double ulp = ldexp(1.0, std::max(e - 24, -149));
+        const double err = fabs((double)approx - exact) / ulp;
+        sum_ulp += err;
+        if (err > max_ulp)
+        {
+            max_ulp = err;
+            worst = input;
+        }
+    }
+
+    void merge(const ErrorStats& o)
+    {
+        count += o.count;
+        rounded += o.rounded;
+        nonfinite += o.nonfinite;
+        sum_ulp += o.sum_ulp;
+        if (o.max_ulp > max_ulp)
+        {
+            max_ulp = o.max_ulp;
+            worst = o.worst;
+        }
+    }
+};
+
+enum { kMaxSteps = 3, kRows = kMaxSteps + 2 }; // estimate, 3 steps, exact baseline
+
+struct OpStats
+{
+    ErrorStats recip[kRows];
+    ErrorStats rsqrt[kRows];
+    uint64_t skipped = 0; // NaN, inf, zero, negative and overflowing inputs
+};
+
+struct Options
+{
+    bool recip = true;
+    bool rsqrt = true;
+    int steps = kMaxSteps;
+    uint64_t samples = 0;
+    bool log_dist = true;
+    double lo = 1e-30;
+    double hi = 1e30;
+    uint64_t stride = 1;
+    int threads = 0;
+    CostModel cost;
+};
+
+// 4 inputs through every row of both ops
+static void run_block(const Options& opt, const float* in, OpStats& st)
+{
+    const float32x4_t v = vld1q_f32(in);
+    float out[kRows][4];
+    bool recip_ok[4], rsqrt_ok[4];
+    for (int i = 0; i < 4; i++)
+    {
+        // a ULP error needs a finite input and a reference inside the float
+        // range; below 2^-128 the reciprocal overflows
+        const bool finite = std::isfinite(in[i]) && in[i] != 0.0f;
+        recip_ok[i] = finite && std::isfinite((float)(1.0 / (double)in[i]));
+        rsqrt_ok[i] = finite && in[i] > 0.0f;
+        if (!(opt.recip && recip_ok[i]) && !(opt.rsqrt && rsqrt_ok[i]))
+        {
+            st.skipped++;
+        }
+    }
+    if (opt.recip)
+    {
+        float32x4_t x = vrecpeq_f32(v);
+        vst1q_f32(out[0], x);
+        for (int s = 1; s <= opt.steps; s++)
+        {
+            x = vmulq_f32(vrecpsq_f32(v, x), x);
+            vst1q_f32(out[s], x);
+        }
+        vst1q_f32(out[kRows - 1], vdivq_f32(vdupq_n_f32(1.0f), v));
+        for (int i = 0; i < 4; i++)
+        {
+            if (!recip_ok[i])
+            {
+                continue;
+            }
+            const double exact = 1.0 / (double)in[i];
+            for (int s = 0; s <= opt.steps; s++)
+            {
+                st.recip[s].add(in[i], out[s][i], exact);
+            }
+            st.recip[kRows - 1].add(in[i], out[kRows - 1][i], exact);
+        }
+    }
+    if (opt.rsqrt)
+    {
+        float32x4_t x = vrsqrteq_f32(v);
+        vst1q_f32(out[0], x);
+        for (int s = 1; s <= opt.steps; s++)
+        {
+            x = vmulq_f32(x, vrsqrtsq_f32(vmulq_f32(v, x), x));
+            vst1q_f32(out[s], x);
+        }
+        vst1q_f32(out[kRows - 1], vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(v)));
+        for (int i = 0; i < 4; i++)
+        {
+            if (!rsqrt_ok[i])
+            {
+                continue;
+            }
+            const double exact = 1.0 / sqrt((double)in[i]);
+            for (int s = 0; s <= opt.steps; s++)
+            {
+                st.rsqrt[s].add(in[i], out[s][i], exact);
+            }
+            st.rsqrt[kRows - 1].add(in[i], out[kRows - 1][i], exact);
+        }
+    }
+}
+
+static bool parse_cost(const char* v, CostModel& c)
+{
+    return sscanf(v, "%d,%d,%d,%d,%d", &c.estimate, &c.step, &c.mul, &c.div, &c.sqrt) == 5;
+}
+
+static bool parse_dist(const char* v, Options& opt)
+{
+    char kind[16];
+    if (sscanf(v, "%15[a-z]:%lf:%lf", kind, &opt.lo, &opt.hi) != 3 || !(opt.lo < opt.hi))
+    {
+        return false;
+    }
+    opt.log_dist = strcmp(kind, "log") == 0;
+    return opt.log_dist ? opt.lo > 0 : strcmp(kind, "uniform") == 0;
+}
+
+static void print_rows(const char* op, const ErrorStats* rows, int steps, const int* cycles, const char* exact_name)
+{
+    for (int s = 0; s < kRows; s++)
+    {
+        if (s > steps && s != kRows - 1)
+        {
+            continue;
+        }
+        const ErrorStats& e = rows[s];
+        if (e.count == 0)
+        {
+            continue;
+        }
+        char impl[32];
+        if (s == kRows - 1)
+        {
+            snprintf(impl, sizeof(impl), "%s", exact_name);
+        }
+        else
+        {
+            snprintf(impl, sizeof(impl), "est+%d", s);
+        }
+        const uint64_t finite = e.count - e.nonfinite;
+        printf("%-6s %-10s %7d %12.3f %12.4f %9.3f%% %10llu %14.7g\n", op, impl, cycles[s], e.max_ulp,
+               finite ? e.sum_ulp / finite : 0.0, 100.0 * e.rounded / e.count, (unsigned long long)e.nonfinite,
+               e.worst);
+    }
+}
+
+int main(int argc, const char* const argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* v = strchr(arg, '=');
+        v = v ? v + 1 : "";
+        bool ok = true;
+        if (strncmp(arg, "--op=", 5) == 0)
+        {
+            opt.recip = strcmp(v, "recip") == 0 || strcmp(v, "all") == 0;
+            opt.rsqrt = strcmp(v, "rsqrt") == 0 || strcmp(v, "all") == 0;
+            ok = opt.recip || opt.rsqrt;
+        }
+        else if (strncmp(arg, "--steps=", 8) == 0)
+        {
+            opt.steps = atoi(v);
+            ok = opt.steps >= 0 && opt.steps <= kMaxSteps;
+        }
+        else if (strncmp(arg, "--samples=", 10) == 0) opt.samples = strtoull(v, NULL, 10);
+        else if (strncmp(arg, "--dist=", 7) == 0) ok = parse_dist(v, opt);
+        else if (strncmp(arg, "--stride=", 9) == 0)
+        {
+            opt.stride = strtoull(v, NULL, 10);
+            ok = opt.stride > 0;
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0) opt.threads = atoi(v);
+        else if (strncmp(arg, "--cost=", 7) == 0) ok = parse_cost(v, opt.cost);
+        else ok = false;
+        if (!ok)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    nsk::ThreadPool pool(opt.threads);
+    nsk::PerThread<OpStats> stats(pool);
+
+    // one task per 2^20 bit patterns, or per 2^16 samples; a ragged tail of
+    // fewer than 4 inputs is dropped
+    const uint64_t total = (opt.samples ? opt.samples : (1ull << 32) / opt.stride) & ~3ull;
+    const uint64_t chunk = opt.samples ? (1u << 16) : (1u << 20);
+    const size_t tasks = (size_t)((total + chunk - 1) / chunk);
+    const auto t0 = std::chrono::steady_clock::now();
+    pool.run(tasks, [&](size_t task, int worker) {
+        OpStats& st = stats.local(worker);
+        const uint64_t begin = task * chunk;
+        const uint64_t end = std::min(total, begin + chunk);
+        std::mt19937_64 rng(task + 1);
+        std::uniform_real_distribution<double> dist(opt.log_dist ? log(opt.lo) : opt.lo,
+                                                    opt.log_dist ? log(opt.hi) : opt.hi);
+        float in[4];
+        for (uint64_t k = begin; k + 4 <= end; k += 4)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                if (opt.samples)
+                {
+                    in[i] = (float)(opt.log_dist ? exp(dist(rng)) : dist(rng));
+                }
+                else
+                {
+                    const uint32_t bits = (uint32_t)((k + i) * opt.stride);
+                    memcpy(&in[i], &bits, sizeof(float));
+                }
+            }
+            run_block(opt, in, st);
+        }
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const OpStats sum = stats.merge(OpStats(), [](OpStats acc, const OpStats& s) {
+        for (int r = 0; r < kRows; r++)
+        {
+            acc.recip[r].merge(s.recip[r]);
+            acc.rsqrt[r].merge(s.rsqrt[r]);
+        }
+        acc.skipped += s.skipped;
+        return acc;
+    });
+
+    const CostModel& c = opt.cost;
+    int recip_cycles[kRows], rsqrt_cycles[kRows];
+    for (int s = 0; s <= kMaxSteps; s++)
+    {
+        recip_cycles[s] = c.estimate + s * (c.step + c.mul);
+        rsqrt_cycles[s] = c.estimate + s * (c.mul + c.step + c.mul);
+    }
+    recip_cycles[kRows - 1] = c.div;
+    rsqrt_cycles[kRows - 1] = c.sqrt + c.div;
+
+    printf("%llu inputs (%llu skipped) on %d threads in %.1f s\n\n",
+           (unsigned long long)total, (unsigned long long)sum.skipped,
+           pool.num_threads(), seconds);
+    printf("%-6s %-10s %7s %12s %12s %10s %10s %14s\n", "op", "impl", "cycles", "max ulp", "mean ulp", "rounded",
+           "nonfinite", "worst input");
+    if (opt.recip)
+    {
+        print_rows("recip", sum.recip, opt.steps, recip_cycles, "fdiv");
+    }
+    if (opt.rsqrt)
+    {
+        print_rows("rsqrt", sum.rsqrt, opt.steps, rsqrt_cycles, "fsqrt+fdiv");
+    }
+    return 0;
+}
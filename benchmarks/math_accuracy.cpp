@@ -0,0 +1,183 @@
+#define NEON_SIM_IMPLEMENTATION
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include "neon_sim_math.hpp"
+#include "neon_sim_parallel.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Runs every float through the functions of neon_sim_math.hpp and checks the
+// results against libm in double precision: the max ULP error must stay
+// within the documented bound, NaN must come out exactly where the reference
+// is NaN and infinities exactly where it overflows the float range. The
+// 2^32 bit patterns are split over the thread pool; --stride thins them out.
+// Exit code: 0 all within bounds, 1 a bound or special case failed, 2 bad usage.
+
+namespace nsk = neon_sim_kernels;
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --func=NAME          exp, log, sin, cos, tanh, sigmoid, erf or all (default all)\n"
+            "  --stride=N           visit every Nth bit pattern (default 1)\n"
+            "  --threads=N          (default one per core)\n",
+            prog);
+}
+
+struct ErrorStats
+{
+    uint64_t count = 0;
+    uint64_t rounded = 0;    // results equal to the reference rounded to float
+    uint64_t mismatched = 0; // NaN or inf where the reference is not, or the other way
+    double sum_ulp = 0;
+    double max_ulp = 0;
+    float worst = 0;         // input with the largest error
+    float mismatch = 0;      // one of the mismatched inputs
+
+    void add(float input, float approx, double exact)
+    {
+        count++;
+        const float rounded_exact = (float)exact;
+        if (std::isnan(exact) || std::isinf(rounded_exact) || !std::isfinite(approx))
+        {
+            const bool same = std::isnan(exact) ? std::isnan(approx) : approx == rounded_exact;
+            if (!same)
+            {
+                mismatched++;
+                mismatch = input;
+            }
+            rounded += same;
+            return;
+        }
+        if (approx == rounded_exact)
+        {
+            rounded++;
+        }
+        // ulp of a float in [2^(e-1), 2^e), subnormals included
+        int e;
+        frexp(exact, &e);
+        const double ulp = ldexp(1.0, std::max(e - 24, -149));
+        const double err = fabs((double)approx - exact) / ulp;
+        sum_ulp += err;
+        if (err > max_ulp)
+        {
+            max_ulp = err;
+            worst = input;
+        }
+    }
+
+    void merge(const ErrorStats& o)
+    {
+        count += o.count;
+        rounded += o.rounded;
+        if (o.mismatched)
+        {
+            mismatched += o.mismatched;
+            mismatch = o.mismatch;
+        }
+        sum_ulp += o.sum_ulp;
+        if (o.max_ulp > max_ulp)
+        {
+            max_ulp = o.max_ulp;
+            worst = o.worst;
+        }
+    }
+};
+
+int main(int argc, const char* const argv[])
+{
+    const char* func = "all";
+    uint64_t stride = 1;
+    int threads = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* v = strchr(arg, '=');
+        v = v ? v + 1 : "";
+        bool ok = true;
+        if (strncmp(arg, "--func=", 7) == 0)
+        {
+            func = v;
+            ok = strcmp(v, "all") == 0 || nsk::math::find_function(v) != NULL;
+        }
+        else if (strncmp(arg, "--stride=", 9) == 0)
+        {
+            stride = strtoull(v, NULL, 10);
+            ok = stride > 0;
+        }
+        else if (strncmp(arg, "--threads=", 10) == 0) threads = atoi(v);
+        else ok = false;
+        if (!ok)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    nsk::ThreadPool pool(threads);
+    const uint64_t total = ((1ull << 32) + stride - 1) / stride;
+    const uint64_t chunk = 1u << 20;
+    const size_t tasks = (size_t)((total + chunk - 1) / chunk);
+    printf("%llu inputs per function on %d threads\n\n", (unsigned long long)total, pool.num_threads());
+    printf("%-8s %10s %12s %10s %10s %14s %8s\n", "func", "max ulp", "mean ulp", "rounded", "mismatch",
+           "worst input", "bound");
+
+    bool pass = true;
+    const std::vector<nsk::math::Function>& table = nsk::math::functions();
+    for (size_t f = 0; f < table.size(); f++)
+    {
+        const nsk::math::Function& fn = table[f];
+        if (strcmp(func, "all") != 0 && strcmp(func, fn.name) != 0)
+        {
+            continue;
+        }
+        nsk::PerThread<ErrorStats> stats(pool);
+        const auto t0 = std::chrono::steady_clock::now();
+        pool.run(tasks, [&](size_t task, int worker) {
+            ErrorStats& st = stats.local(worker);
+            const uint64_t begin = task * chunk;
+            const uint64_t end = std::min(total, begin + chunk);
+            float in[4], out[4];
+            for (uint64_t k = begin; k < end; k += 4)
+            {
+                const int n = (int)std::min<uint64_t>(4, end - k);
+                for (int i = 0; i < 4; i++)
+                {
+                    const uint32_t bits = (uint32_t)((k + std::min(i, n - 1)) * stride);
+                    memcpy(&in[i], &bits, sizeof(float));
+                }
+                vst1q_f32(out, fn.vec(vld1q_f32(in)));
+                for (int i = 0; i < n; i++)
+                {
+                    st.add(in[i], out[i], fn.reference((double)in[i]));
+                }
+            }
+        });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        const ErrorStats e = stats.merge(ErrorStats(), [](ErrorStats acc, const ErrorStats& s) {
+            acc.merge(s);
+            return acc;
+        });
+        const bool ok = e.max_ulp <= fn.max_ulp && e.mismatched == 0;
+        pass = pass && ok;
+        printf("%-8s %10.3f %12.4f %9.3f%% %10llu %14.9g %8.1f %s (%.1f s)\n", fn.name, e.max_ulp,
+               e.count ? e.sum_ulp / e.count : 0.0, 100.0 * e.rounded / e.count, (unsigned long long)e.mismatched,
+               e.worst, fn.max_ulp, ok ? "ok" : "FAIL", seconds);
+        if (e.mismatched)
+        {
+            fprintf(stderr, "%s(%.9g): NaN or inf does not match the reference\n", fn.name, e.mismatch);
+        }
+        fflush(stdout);
+    }
+    return pass ? 0 : 1;
+}
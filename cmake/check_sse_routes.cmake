@@ -0,0 +1,14 @@
+# Runs neon_sim_sse_table with the defaults and fails when its output differs
+# from the checked-in routing table.
+#   cmake -DTABLE_EXECUTABLE=<neon_sim_sse_table> -DROUTES=<neon_sim_sse_routes.inc> -P check_sse_routes.cmake
+execute_process(COMMAND ${TABLE_EXECUTABLE} OUTPUT_VARIABLE generated RESULT_VARIABLE result)
+if(NOT "${result}" STREQUAL "0")
+    message(FATAL_ERROR "neon_sim_sse_table failed with return value '${result}'")
+endif()
+file(READ ${ROUTES} checked_in)
+if(NOT generated STREQUAL checked_in)
+    get_filename_component(generated_path "${ROUTES}" NAME)
+    file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/${generated_path}.generated "${generated}")
+    message(FATAL_ERROR "${ROUTES} is out of date, compare it with ${CMAKE_CURRENT_BINARY_DIR}/${generated_path}.generated "
+                        "or regenerate it: ./neon_sim_sse_table > ${ROUTES}")
+endif()
@@ -0,0 +1,437 @@
+#include "neon_sim_audio.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <algorithm>
+
+namespace neon_sim_kernels {
+namespace audio {
+
+namespace {
+
+// One lane of each instruction, for the scalar twins and the vector tails.
+// Intermediates are wide enough that only the final saturation is visible.
+
+inline int16_t sat16(int64_t v)
+{
+    return (int16_t)std::min<int64_t>(std::max<int64_t>(v, INT16_MIN), INT16_MAX);
+}
+
+inline int32_t sat32(int64_t v)
+{
+    return (int32_t)std::min<int64_t>(std::max<int64_t>(v, INT32_MIN), INT32_MAX);
+}
+
+inline int64_t sat_add64(int64_t a, int64_t b)
+{
+    if (b > 0 && a > INT64_MAX - b)
+    {
+        return INT64_MAX;
+    }
+    if (b < 0 && a < INT64_MIN - b)
+    {
+        return INT64_MIN;
+    }
+    return a + b;
+}
+
+// SQDMULL / SQDMLAL / SQDMLSL
+inline int32_t qdmull(int16_t a, int16_t b)
+{
+    return sat32(2 * (int64_t)a * b);
+}
+
+inline int32_t qdmlal(int32_t acc, int16_t a, int16_t b)
+{
+    return sat32((int64_t)acc + qdmull(a, b));
+}
+
+inline int32_t qdmlsl(int32_t acc, int16_t a, int16_t b)
+{
+    return sat32((int64_t)acc - qdmull(a, b));
+}
+
+inline int64_t qdmull(int32_t a, int32_t b)
+{
+    // 2 * a * b fits in int64 except for INT32_MIN * INT32_MIN
+    return (a == INT32_MIN && b == INT32_MIN) ? INT64_MAX : 2 * (int64_t)a * b;
+}
+
+inline int64_t qdmlal(int64_t acc, int32_t a, int32_t b)
+{
+    return sat_add64(acc, qdmull(a, b));
+}
+
+inline int64_t qdmlsl(int64_t acc, int32_t a, int32_t b)
+{
+    return sat_add64(acc, -qdmull(a, b));
+}
+
+// SQRSHRN #15 and #31: round half up, then saturate
+inline int16_t qrshrn15(int32_t v)
+{
+    return sat16(((int64_t)v + (1 << 14)) >> 15);
+}
+
+inline int32_t qrshrn31(int64_t v)
+{
+    // v + 2^30 could overflow; add the rounding bit after the shift instead
+    return sat32((v >> 31) + ((v >> 30) & 1));
+}
+
+// SQRDMULH, SQADD
+inline int16_t qrdmulh(int16_t a, int16_t b)
+{
+    return sat16((2 * (int64_t)a * b + (1 << 15)) >> 16);
+}
+
+inline int16_t qadd16(int16_t a, int16_t b)
+{
+    return sat16((int32_t)a + b);
+}
+
+// the four SQDMLAL accumulators of the vector loop, added exactly, to Q15
+inline int16_t fir_round(int64_t sum)
+{
+    return sat16((sum + (1 << 15)) >> 16);
+}
+
+// State is stored [stage][x1, x2, y1, y2][channel]; a group of up to four
+// channels is copied to a padded, lane-major scratch copy for the vector loop.
+template<typename T>
+void gather_state(const T* state, int num_stages, int channels, int c0, int lanes, T* local)
+{
+    for (int k = 0; k < num_stages * 4; k++)
+    {
+        for (int l = 0; l < 4; l++)
+        {
+            local[k * 4 + l] = l < lanes ? state[(size_t)k * channels + c0 + l] : 0;
+        }
+    }
+}
+
+template<typename T>
+void scatter_state(const T* local, int num_stages, int channels, int c0, int lanes, T* state)
+{
+    for (int k = 0; k < num_stages * 4; k++)
+    {
+        for (int l = 0; l < lanes; l++)
+        {
+            state[(size_t)k * channels + c0 + l] = local[k * 4 + l];
+        }
+    }
+}
+
+template<typename T>
+void load_frame(const T* src, int lanes, T* frame)
+{
+    for (int l = 0; l < 4; l++)
+    {
+        frame[l] = l < lanes ? src[l] : 0;
+    }
+}
+
+} // namespace
+
+PolyphaseQ15 make_polyphase_q15(const int16_t* taps, int num_taps, int up, int down)
+{
+    PolyphaseQ15 f;
+    f.up = up;
+    f.down = down;
+    f.taps_per_phase = ((num_taps + up - 1) / up + 7) / 8 * 8;
+    f.coeffs.assign((size_t)up * f.taps_per_phase, 0);
+    for (int p = 0; p < up; p++)
+    {
+        int16_t* row = &f.coeffs[(size_t)p * f.taps_per_phase];
+        for (int k = 0; p + k * up < num_taps; k++)
+        {
+            row[f.taps_per_phase - 1 - k] = taps[p + k * up];
+        }
+    }
+    return f;
+}
+
+size_t polyphase_history(const PolyphaseQ15& f)
+{
+    return (size_t)f.taps_per_phase - 1;
+}
+
+size_t resample_output_size(const PolyphaseQ15& f, size_t n)
+{
+    return (n * f.up + f.down - 1) / f.down;
+}
+
+size_t fir_resample_q15(const PolyphaseQ15& f, const int16_t* src, size_t n, int16_t* dst)
+{
+    const size_t out_n = resample_output_size(f, n);
+    const int taps = f.taps_per_phase;
+    size_t t = 0;
+    int phase = 0;
+    for (size_t m = 0; m < out_n; m++)
+    {
+        // the reversed phase row lines up with x[t - taps + 1 .. t]
+        const int16_t* h = &f.coeffs[(size_t)phase * taps];
+        const int16_t* x = src + t - (taps - 1);
+        int32x4_t acc = vdupq_n_s32(0);
+        for (int j = 0; j < taps; j += 8)
+        {
+            const int16x8_t vx = vld1q_s16(x + j);
+            const int16x8_t vh = vld1q_s16(h + j);
+            acc = vqdmlal_s16(acc, vget_low_s16(vx), vget_low_s16(vh));
+            acc = vqdmlal_s16(acc, vget_high_s16(vx), vget_high_s16(vh));
+        }
+        const int64x2_t sum = vpaddlq_s32(acc);
+        dst[m] = fir_round(vgetq_lane_s64(sum, 0) + vgetq_lane_s64(sum, 1));
+        phase += f.down;
+        t += phase / f.up;
+        phase %= f.up;
+    }
+    return out_n;
+}
+
+size_t biquad_state_size(int num_stages, int channels)
+{
+    return (size_t)num_stages * 4 * channels;
+}
+
+void biquad_cascade_q15(const BiquadQ15* stages, int num_stages, int16_t* state, const int16_t* src,
+                        int16_t* dst, size_t frames, int channels)
+{
+    std::vector<int16_t> local((size_t)num_stages * 16);
+    for (int c0 = 0; c0 < channels; c0 += 4)
+    {
+        const int lanes = std::min(4, channels - c0);
+        gather_state(state, num_stages, channels, c0, lanes, local.data());
+        for (size_t i = 0; i < frames; i++)
+        {
+            int16_t frame[4];
+            int16x4_t x;
+            if (lanes == 4)
+            {
+                x = vld1_s16(src + i * channels + c0);
+            }
+            else
+            {
+                load_frame(src + i * channels + c0, lanes, frame);
+                x = vld1_s16(frame);
+            }
+            for (int s = 0; s < num_stages; s++)
+            {
+                int16_t* st = &local[(size_t)s * 16];
+                const int16x4_t x1 = vld1_s16(st);
+                const int16x4_t x2 = vld1_s16(st + 4);
+                const int16x4_t y1 = vld1_s16(st + 8);
+                const int16x4_t y2 = vld1_s16(st + 12);
+                int32x4_t acc = vqdmull_s16(x, vdup_n_s16(stages[s].b0));
+                acc = vqdmlal_s16(acc, x1, vdup_n_s16(stages[s].b1));
+                acc = vqdmlal_s16(acc, x2, vdup_n_s16(stages[s].b2));
+                acc = vqdmlsl_s16(acc, y1, vdup_n_s16(stages[s].a1));
+                acc = vqdmlsl_s16(acc, y2, vdup_n_s16(stages[s].a2));
+                const int16x4_t y = vqrshrn_n_s32(acc, 15);
+                vst1_s16(st + 4, x1);
+                vst1_s16(st, x);
+                vst1_s16(st + 12, y1);
+                vst1_s16(st + 8, y);
+                x = y;
+            }
+            if (lanes == 4)
+            {
+                vst1_s16(dst + i * channels + c0, x);
+            }
+            else
+            {
+                vst1_s16(frame, x);
+                std::copy(frame, frame + lanes, dst + i * channels + c0);
+            }
+        }
+        scatter_state(local.data(), num_stages, channels, c0, lanes, state);
+    }
+}
+
+void biquad_cascade_q31(const BiquadQ31* stages, int num_stages, int32_t* state, const int32_t* src,
+                        int32_t* dst, size_t frames, int channels)
+{
+    std::vector<int32_t> local((size_t)num_stages * 16);
+    for (int c0 = 0; c0 < channels; c0 += 4)
+    {
+        const int lanes = std::min(4, channels - c0);
+        gather_state(state, num_stages, channels, c0, lanes, local.data());
+        for (size_t i = 0; i < frames; i++)
+        {
+            int32_t frame[4];
+            int32x4_t x;
+            if (lanes == 4)
+            {
+                x = vld1q_s32(src + i * channels + c0);
+            }
+            else
+            {
+                load_frame(src + i * channels + c0, lanes, frame);
+                x = vld1q_s32(frame);
+            }
+            for (int s = 0; s < num_stages; s++)
+            {
+                int32_t* st = &local[(size_t)s * 16];
+                const int32x4_t x1 = vld1q_s32(st);
+                const int32x4_t x2 = vld1q_s32(st + 4);
+                const int32x4_t y1 = vld1q_s32(st + 8);
+                const int32x4_t y2 = vld1q_s32(st + 12);
+                const int32x2_t b0 = vdup_n_s32(stages[s].b0);
+                const int32x2_t b1 = vdup_n_s32(stages[s].b1);
+                const int32x2_t b2 = vdup_n_s32(stages[s].b2);
+                const int32x2_t a1 = vdup_n_s32(stages[s].a1);
+                const int32x2_t a2 = vdup_n_s32(stages[s].a2);
+                int64x2_t lo = vqdmull_s32(vget_low_s32(x), b0);
+                int64x2_t hi = vqdmull_s32(vget_high_s32(x), b0);
+                lo = vqdmlal_s32(lo, vget_low_s32(x1), b1);
+                hi = vqdmlal_s32(hi, vget_high_s32(x1), b1);
+                lo = vqdmlal_s32(lo, vget_low_s32(x2), b2);
+                hi = vqdmlal_s32(hi, vget_high_s32(x2), b2);
+                lo = vqdmlsl_s32(lo, vget_low_s32(y1), a1);
+                hi = vqdmlsl_s32(hi, vget_high_s32(y1), a1);
+                lo = vqdmlsl_s32(lo, vget_low_s32(y2), a2);
+                hi = vqdmlsl_s32(hi, vget_high_s32(y2), a2);
+                const int32x4_t y = vcombine_s32(vqrshrn_n_s64(lo, 31), vqrshrn_n_s64(hi, 31));
+                vst1q_s32(st + 4, x1);
+                vst1q_s32(st, x);
+                vst1q_s32(st + 12, y1);
+                vst1q_s32(st + 8, y);
+                x = y;
+            }
+            if (lanes == 4)
+            {
+                vst1q_s32(dst + i * channels + c0, x);
+            }
+            else
+            {
+                vst1q_s32(frame, x);
+                std::copy(frame, frame + lanes, dst + i * channels + c0);
+            }
+        }
+        scatter_state(local.data(), num_stages, channels, c0, lanes, state);
+    }
+}
+
+void mix_q15(const int16_t* const* srcs, const int16_t* gains, int num_srcs, int16_t* dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        int16x8_t acc = vdupq_n_s16(0);
+        for (int s = 0; s < num_srcs; s++)
+        {
+            acc = vqaddq_s16(acc, vqrdmulhq_n_s16(vld1q_s16(srcs[s] + i), gains[s]));
+        }
+        vst1q_s16(dst + i, acc);
+    }
+    for (; i < n; i++)
+    {
+        int16_t acc = 0;
+        for (int s = 0; s < num_srcs; s++)
+        {
+            acc = qadd16(acc, qrdmulh(srcs[s][i], gains[s]));
+        }
+        dst[i] = acc;
+    }
+}
+
+namespace ref {
+
+size_t fir_resample_q15(const PolyphaseQ15& f, const int16_t* src, size_t n, int16_t* dst)
+{
+    const size_t out_n = resample_output_size(f, n);
+    const int taps = f.taps_per_phase;
+    for (size_t m = 0; m < out_n; m++)
+    {
+        const size_t t = m * f.down / f.up;
+        const int phase = (int)(m * f.down % f.up);
+        const int16_t* h = &f.coeffs[(size_t)phase * taps];
+        const int16_t* x = src + t - (taps - 1);
+        // tap j goes to accumulator j % 4, in increasing j, as in the vector loop
+        int32_t acc[4] = { 0, 0, 0, 0 };
+        for (int j = 0; j < taps; j++)
+        {
+            acc[j % 4] = qdmlal(acc[j % 4], x[j], h[j]);
+        }
+        dst[m] = fir_round((int64_t)acc[0] + acc[1] + acc[2] + acc[3]);
+    }
+    return out_n;
+}
+
+void biquad_cascade_q15(const BiquadQ15* stages, int num_stages, int16_t* state, const int16_t* src,
+                        int16_t* dst, size_t frames, int channels)
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            int16_t x = src[i * channels + c];
+            for (int s = 0; s < num_stages; s++)
+            {
+                int16_t* st = state + (size_t)s * 4 * channels + c;
+                int32_t acc = qdmull(x, stages[s].b0);
+                acc = qdmlal(acc, st[0], stages[s].b1);
+                acc = qdmlal(acc, st[channels], stages[s].b2);
+                acc = qdmlsl(acc, st[2 * channels], stages[s].a1);
+                acc = qdmlsl(acc, st[3 * channels], stages[s].a2);
+                const int16_t y = qrshrn15(acc);
+                st[channels] = st[0];
+                st[0] = x;
+                st[3 * channels] = st[2 * channels];
+                st[2 * channels] = y;
+                x = y;
+            }
+            dst[i * channels + c] = x;
+        }
+    }
+}
+
+void biquad_cascade_q31(const BiquadQ31* stages, int num_stages, int32_t* state, const int32_t* src,
+                        int32_t* dst, size_t frames, int channels)
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            int32_t x = src[i * channels + c];
+            for (int s = 0; s < num_stages; s++)
+            {
+                int32_t* st = state + (size_t)s * 4 * channels + c;
+                int64_t acc = qdmull(x, stages[s].b0);
+                acc = qdmlal(acc, st[0], stages[s].b1);
+                acc = qdmlal(acc, st[channels], stages[s].b2);
+                acc = qdmlsl(acc, st[2 * channels], stages[s].a1);
+                acc = qdmlsl(acc, st[3 * channels], stages[s].a2);
+                const int32_t y = qrshrn31(acc);
+                st[channels] = st[0];
+                st[0] = x;
+                st[3 * channels] = st[2 * channels];
+                st[2 * channels] = y;
+                x = y;
+            }
+            dst[i * channels + c] = x;
+        }
+    }
+}
+
+void mix_q15(const int16_t* const* srcs, const int16_t* gains, int num_srcs, int16_t* dst, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        int16_t acc = 0;
+        for (int s = 0; s < num_srcs; s++)
+        {
+            acc = qadd16(acc, qrdmulh(srcs[s][i], gains[s]));
+        }
+        dst[i] = acc;
+    }
+}
+
+} // namespace ref
+
+} // namespace audio
+} // namespace neon_sim_kernels
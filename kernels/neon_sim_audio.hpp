@@ -0,0 +1,108 @@
+#pragma once
+
+//
+// Fixed-point audio kernels written with NEON intrinsics: a polyphase FIR
+// resampler, biquad cascades and a saturating mixer on Q15 / Q31 samples.
+//
+// usage:
+// #include "neon_sim_audio.hpp"
+//
+// audio::PolyphaseQ15 f = audio::make_polyphase_q15(taps, num_taps, 3, 2); // 32 kHz -> 48 kHz
+// std::vector<int16_t> in(audio::polyphase_history(f) + n);                // history, then n new samples
+// audio::fir_resample_q15(f, in.data() + audio::polyphase_history(f), n, out);
+//
+// All arithmetic is the saturating, rounding integer arithmetic of the NEON
+// instructions used (SQDMLAL, SQRDMULH, SQRSHRN, SQADD), so results do not
+// depend on the target. Every kernel has a scalar twin in `audio::ref` that
+// follows the same operation order and is bit-exact with it; tests compare
+// the two and benchmarks use the twin as the baseline.
+//
+// Multichannel buffers are interleaved: sample i of channel c is at
+// src[i * channels + c]. The biquads run four channels per vector, a partial
+// group of channels in a padded vector.
+//
+// As with neon_sim_kernels.hpp, the library does not define
+// NEON_SIM_IMPLEMENTATION on x86.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace neon_sim_kernels {
+namespace audio {
+
+/// @brief a prototype low-pass FIR split into `up` phases for rational resampling
+struct PolyphaseQ15
+{
+    int up = 1;                  // output rate = input rate * up / down
+    int down = 1;
+    int taps_per_phase = 0;      // rounded up to a multiple of 8, zero padded
+    std::vector<int16_t> coeffs; // `up` rows of taps_per_phase, each in reverse order
+};
+
+/// @brief split `taps` (Q15, designed at the input rate times `up`) into phases.
+/// up and down must be at least 1; num_taps at least 1.
+PolyphaseQ15 make_polyphase_q15(const int16_t* taps, int num_taps, int up, int down);
+
+/// @brief samples before src[0] that fir_resample_q15 reads: taps_per_phase - 1
+size_t polyphase_history(const PolyphaseQ15& f);
+
+/// @brief outputs written for n inputs: ceil(n * up / down)
+size_t resample_output_size(const PolyphaseQ15& f, size_t n);
+
+/// @brief y[m] = sat16(round(sum_k 2 * h[p + k * up] * x[t - k] / 2^16)), t = m * down / up,
+/// p = m * down % up, where the products are summed with Q31 saturation in four
+/// accumulators (SQDMLAL) that are added exactly at the end.
+/// src[-polyphase_history(f)] .. src[-1] must be readable: they are the end of
+/// the previous block, or zeros at the start of a stream. Each call starts at
+/// phase 0, so blocks streamed through one filter should be multiples of `down`
+/// samples long. Returns resample_output_size(f, n).
+size_t fir_resample_q15(const PolyphaseQ15& f, const int16_t* src, size_t n, int16_t* dst);
+
+/// @brief y = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2], direct form I.
+/// Coefficients are Q14 (value / 16384, so |a1| < 2 fits); a0 is 1.
+struct BiquadQ15
+{
+    int16_t b0, b1, b2, a1, a2;
+};
+
+/// @brief Q31 samples, Q30 coefficients (value / 2^30)
+struct BiquadQ31
+{
+    int32_t b0, b1, b2, a1, a2;
+};
+
+/// @brief elements of state for a cascade: 4 (x1, x2, y1, y2) per stage and channel
+size_t biquad_state_size(int num_stages, int channels);
+
+/// @brief run `frames` interleaved frames through num_stages biquads in series.
+/// Each stage accumulates with SQDMULL / SQDMLAL / SQDMLSL in Q31 and narrows
+/// with one rounding, saturating shift (SQRSHRN #15). `state` holds
+/// biquad_state_size() elements, zero for a fresh filter, and is updated so
+/// that consecutive calls stream. src and dst may be the same buffer.
+void biquad_cascade_q15(const BiquadQ15* stages, int num_stages, int16_t* state, const int16_t* src,
+                        int16_t* dst, size_t frames, int channels);
+
+/// @brief the same in Q31, with 64 bit accumulators and SQRSHRN #31
+void biquad_cascade_q31(const BiquadQ31* stages, int num_stages, int32_t* state, const int32_t* src,
+                        int32_t* dst, size_t frames, int channels);
+
+/// @brief dst[i] = sum over s of sqrdmulh(srcs[s][i], gains[s]), added in source
+/// order with int16 saturation after every step. Gains are Q15; 32767 is the
+/// closest to unity. num_srcs may be 0 (dst is cleared); dst may alias srcs[0].
+void mix_q15(const int16_t* const* srcs, const int16_t* gains, int num_srcs, int16_t* dst, size_t n);
+
+namespace ref {
+
+size_t fir_resample_q15(const PolyphaseQ15& f, const int16_t* src, size_t n, int16_t* dst);
+void biquad_cascade_q15(const BiquadQ15* stages, int num_stages, int16_t* state, const int16_t* src,
+                        int16_t* dst, size_t frames, int channels);
+void biquad_cascade_q31(const BiquadQ31* stages, int num_stages, int32_t* state, const int32_t* src,
+                        int32_t* dst, size_t frames, int channels);
+void mix_q15(const int16_t* const* srcs, const int16_t* gains, int num_srcs, int16_t* dst, size_t n);
+
+} // namespace ref
+
+} // namespace audio
+} // namespace neon_sim_kernels
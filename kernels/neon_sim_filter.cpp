@@ -0,0 +1,626 @@
+#include "neon_sim_filter.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <string.h>
+
+namespace neon_sim_kernels {
+namespace filter {
+
+namespace {
+
+template<typename T>
+inline const T* row(const T* base, size_t step, int y)
+{
+    return (const T*)((const uint8_t*)base + y * step);
+}
+
+template<typename T>
+inline T* row(T* base, size_t step, int y)
+{
+    return (T*)((uint8_t*)base + y * step);
+}
+
+// round(n / (k * k)) = ((n + k * k / 2) * m) >> s for every window sum n of
+// an odd k <= 15, with m < 2^16; checked exhaustively over n <= 255 * k * k
+struct Reciprocal
+{
+    uint16_t m;
+    int s;
+};
+const Reciprocal kBoxReciprocal[8] = {
+    { 1, 0 }, { 58255, 19 }, { 41944, 20 }, { 42800, 21 }, { 51782, 22 }, { 34664, 22 }, { 49637, 23 }, { 37283, 23 },
+};
+
+// width + 2 * radius pixels of source row `y` (a zero row for a constant
+// border, or when y is NULL), starting at x = -radius
+void pad_row(const uint8_t* y, int width, int radius, Border border, uint8_t* out)
+{
+    for (int i = -radius; i < 0; i++)
+    {
+        const int x = border_index(i, width, border);
+        out[i + radius] = x < 0 || !y ? 0 : y[x];
+    }
+    if (y)
+    {
+        memcpy(out + radius, y, width);
+    }
+    else
+    {
+        memset(out + radius, 0, width);
+    }
+    for (int i = width; i < width + radius; i++)
+    {
+        const int x = border_index(i, width, border);
+        out[i + radius] = x < 0 || !y ? 0 : y[x];
+    }
+}
+
+// The separable filter loop. Source rows -r .. height - 1 + r go through
+// `horizontal(padded_row, out)` once each, into a ring of ksize buffers of
+// row_len elements; then `vertical(rows, y)` sees the ksize buffers of
+// output row y, top to bottom.
+template<typename T, typename Horizontal, typename Vertical>
+void sliding_window(const uint8_t* src, size_t src_step, int width, int height, int ksize, Border border,
+                    size_t row_len, Horizontal horizontal, Vertical vertical)
+{
+    const int radius = ksize / 2;
+    std::vector<uint8_t> padded(width + 2 * radius);
+    std::vector<T> ring(ksize * row_len);
+    std::vector<const T*> rows(ksize);
+    auto fill = [&](int v) {
+        const int sy = border_index(v, height, border);
+        pad_row(sy < 0 ? NULL : row(src, src_step, sy), width, radius, border, padded.data());
+        horizontal(padded.data(), &ring[((v + radius) % ksize) * row_len]);
+    };
+    for (int v = -radius; v < radius; v++)
+    {
+        fill(v);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        fill(y + radius);
+        for (int j = 0; j < ksize; j++)
+        {
+            rows[j] = &ring[((y + j) % ksize) * row_len];
+        }
+        vertical(rows.data(), y);
+    }
+}
+
+template<bool is_max>
+inline uint8x16_t extremum(uint8x16_t a, uint8x16_t b)
+{
+    return is_max ? vmaxq_u8(a, b) : vminq_u8(a, b);
+}
+
+template<bool is_max>
+inline uint8_t extremum(uint8_t a, uint8_t b)
+{
+    return is_max ? std::max(a, b) : std::min(a, b);
+}
+
+template<bool is_max>
+void morphology(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+                Border border)
+{
+    auto horizontal = [&](const uint8_t* p, uint8_t* out) {
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t m = vld1q_u8(p + x);
+            for (int i = 1; i < ksize; i++)
+            {
+                m = extremum<is_max>(m, vld1q_u8(p + x + i));
+            }
+            vst1q_u8(out + x, m);
+        }
+        for (; x < width; x++)
+        {
+            uint8_t m = p[x];
+            for (int i = 1; i < ksize; i++)
+            {
+                m = extremum<is_max>(m, p[x + i]);
+            }
+            out[x] = m;
+        }
+    };
+    auto vertical = [&](const uint8_t* const* rows, int y) {
+        uint8_t* dp = row(dst, dst_step, y);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t m = vld1q_u8(rows[0] + x);
+            for (int j = 1; j < ksize; j++)
+            {
+                m = extremum<is_max>(m, vld1q_u8(rows[j] + x));
+            }
+            vst1q_u8(dp + x, m);
+        }
+        for (; x < width; x++)
+        {
+            uint8_t m = rows[0][x];
+            for (int j = 1; j < ksize; j++)
+            {
+                m = extremum<is_max>(m, rows[j][x]);
+            }
+            dp[x] = m;
+        }
+    };
+    sliding_window<uint8_t>(src, src_step, width, height, ksize, border, width, horizontal, vertical);
+}
+
+// Q8 source coordinate of destination pixel d with centers aligned, clamped
+// to [0, n - 1]: the index of the left (top) neighbour and its blend weight
+void resize_coordinate(int d, int src_n, int dst_n, int& i0, int& i1, int& w)
+{
+    const int64_t pos = ((int64_t)(2 * d + 1) * src_n * 128) / dst_n - 128;
+    const int q8 = pos < 0 ? 0 : (int)pos;
+    i0 = q8 >> 8;
+    w = q8 & 255;
+    if (i0 >= src_n - 1)
+    {
+        i0 = src_n - 1;
+        w = 0;
+    }
+    i1 = std::min(i0 + 1, src_n - 1);
+}
+
+} // namespace
+
+int border_index(int i, int n, Border border)
+{
+    if (i >= 0 && i < n)
+    {
+        return i;
+    }
+    switch (border)
+    {
+    case BORDER_REPLICATE:
+        return i < 0 ? 0 : n - 1;
+    case BORDER_REFLECT_101:
+        if (n == 1)
+        {
+            return 0;
+        }
+        while (i < 0 || i >= n)
+        {
+            i = i < 0 ? -i : 2 * n - 2 - i;
+        }
+        return i;
+    default:
+        return -1;
+    }
+}
+
+void gaussian_kernel_q8(int ksize, double sigma, uint8_t* kernel)
+{
+    const int radius = ksize / 2;
+    if (sigma <= 0)
+    {
+        sigma = 0.3 * ((ksize - 1) * 0.5 - 1) + 0.8;
+    }
+    std::vector<double> g(ksize);
+    double total = 0;
+    for (int i = 0; i < ksize; i++)
+    {
+        g[i] = exp(-(double)(i - radius) * (i - radius) / (2 * sigma * sigma));
+        total += g[i];
+    }
+    int sum = 0;
+    for (int i = 0; i < ksize; i++)
+    {
+        kernel[i] = i == radius ? 0 : (uint8_t)lround(g[i] / total * 256);
+        sum += kernel[i];
+    }
+    // the center takes the rounding error; past 255 it spills onto its
+    // neighbours, which keeps the kernel symmetric (the excess is even)
+    int center = 256 - sum;
+    if (center > 255)
+    {
+        const int spill = (center - 254) / 2;
+        kernel[radius - 1] += spill;
+        kernel[radius + 1] += spill;
+        center = 254;
+    }
+    kernel[radius] = (uint8_t)center;
+}
+
+void separable_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                      const uint8_t* kernel_x, const uint8_t* kernel_y, int ksize, Border border)
+{
+    // 255 * 256 fits the 16 bit rows, 255 * 256 * 256 the 32 bit sums
+    auto horizontal = [&](const uint8_t* p, uint16_t* out) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint16x8_t acc = vmull_u8(vld1_u8(p + x), vdup_n_u8(kernel_x[0]));
+            for (int i = 1; i < ksize; i++)
+            {
+                acc = vmlal_u8(acc, vld1_u8(p + x + i), vdup_n_u8(kernel_x[i]));
+            }
+            vst1q_u16(out + x, acc);
+        }
+        for (; x < width; x++)
+        {
+            uint16_t acc = 0;
+            for (int i = 0; i < ksize; i++)
+            {
+                acc += kernel_x[i] * p[x + i];
+            }
+            out[x] = acc;
+        }
+    };
+    auto vertical = [&](const uint16_t* const* rows, int y) {
+        uint8_t* dp = row(dst, dst_step, y);
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            const uint16x8_t r = vld1q_u16(rows[0] + x);
+            uint32x4_t lo = vmull_n_u16(vget_low_u16(r), kernel_y[0]);
+            uint32x4_t hi = vmull_n_u16(vget_high_u16(r), kernel_y[0]);
+            for (int j = 1; j < ksize; j++)
+            {
+                const uint16x8_t rj = vld1q_u16(rows[j] + x);
+                lo = vmlal_n_u16(lo, vget_low_u16(rj), kernel_y[j]);
+                hi = vmlal_n_u16(hi, vget_high_u16(rj), kernel_y[j]);
+            }
+            vst1_u8(dp + x, vmovn_u16(vcombine_u16(vrshrn_n_u32(lo, 16), vrshrn_n_u32(hi, 16))));
+        }
+        for (; x < width; x++)
+        {
+            uint32_t acc = 0;
+            for (int j = 0; j < ksize; j++)
+            {
+                acc += kernel_y[j] * rows[j][x];
+            }
+            dp[x] = (uint8_t)((acc + (1 << 15)) >> 16);
+        }
+    };
+    sliding_window<uint16_t>(src, src_step, width, height, ksize, border, width, horizontal, vertical);
+}
+
+void gaussian_blur(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                   int ksize, double sigma, Border border)
+{
+    std::vector<uint8_t> kernel(ksize);
+    gaussian_kernel_q8(ksize, sigma, kernel.data());
+    separable_filter(src, src_step, dst, dst_step, width, height, kernel.data(), kernel.data(), ksize, border);
+}
+
+void box_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                int ksize, Border border)
+{
+    const Reciprocal rcp = kBoxReciprocal[ksize / 2];
+    const uint16_t half = (uint16_t)(ksize * ksize / 2);
+    auto horizontal = [&](const uint8_t* p, uint16_t* out) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint16x8_t acc = vmovl_u8(vld1_u8(p + x));
+            for (int i = 1; i < ksize; i++)
+            {
+                acc = vaddw_u8(acc, vld1_u8(p + x + i));
+            }
+            vst1q_u16(out + x, acc);
+        }
+        for (; x < width; x++)
+        {
+            uint16_t acc = 0;
+            for (int i = 0; i < ksize; i++)
+            {
+                acc += p[x + i];
+            }
+            out[x] = acc;
+        }
+    };
+    const uint16x8_t vhalf = vdupq_n_u16(half);
+    const int32x4_t vshift = vdupq_n_s32(-rcp.s);
+    auto vertical = [&](const uint16_t* const* rows, int y) {
+        uint8_t* dp = row(dst, dst_step, y);
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint16x8_t sum = vaddq_u16(vld1q_u16(rows[0] + x), vhalf);
+            for (int j = 1; j < ksize; j++)
+            {
+                sum = vaddq_u16(sum, vld1q_u16(rows[j] + x));
+            }
+            const uint32x4_t lo = vshlq_u32(vmull_n_u16(vget_low_u16(sum), rcp.m), vshift);
+            const uint32x4_t hi = vshlq_u32(vmull_n_u16(vget_high_u16(sum), rcp.m), vshift);
+            vst1_u8(dp + x, vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))));
+        }
+        for (; x < width; x++)
+        {
+            uint32_t sum = half;
+            for (int j = 0; j < ksize; j++)
+            {
+                sum += rows[j][x];
+            }
+            dp[x] = (uint8_t)((sum * rcp.m) >> rcp.s);
+        }
+    };
+    sliding_window<uint16_t>(src, src_step, width, height, ksize, border, width, horizontal, vertical);
+}
+
+void sobel3x3(const uint8_t* src, size_t src_step, int16_t* dx, size_t dx_step, int16_t* dy, size_t dy_step,
+              int width, int height, Border border)
+{
+    // each row buffer holds the horizontal difference (for dx), then the
+    // horizontal [1 2 1] smoothing (for dy)
+    auto horizontal = [&](const uint8_t* p, int16_t* out) {
+        int16_t* smooth = out + width;
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            const uint8x8_t a = vld1_u8(p + x);
+            const uint8x8_t b = vld1_u8(p + x + 1);
+            const uint8x8_t c = vld1_u8(p + x + 2);
+            vst1q_s16(out + x, vreinterpretq_s16_u16(vsubl_u8(c, a)));
+            vst1q_s16(smooth + x, vreinterpretq_s16_u16(vaddq_u16(vaddl_u8(a, c), vshll_n_u8(b, 1))));
+        }
+        for (; x < width; x++)
+        {
+            out[x] = (int16_t)(p[x + 2] - p[x]);
+            smooth[x] = (int16_t)(p[x] + 2 * p[x + 1] + p[x + 2]);
+        }
+    };
+    auto vertical = [&](const int16_t* const* rows, int y) {
+        int16_t* dxp = dx ? row(dx, dx_step, y) : NULL;
+        int16_t* dyp = dy ? row(dy, dy_step, y) : NULL;
+        const int16_t* s0 = rows[0] + width;
+        const int16_t* s2 = rows[2] + width;
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            if (dxp)
+            {
+                const int16x8_t outer = vaddq_s16(vld1q_s16(rows[0] + x), vld1q_s16(rows[2] + x));
+                vst1q_s16(dxp + x, vaddq_s16(outer, vshlq_n_s16(vld1q_s16(rows[1] + x), 1)));
+            }
+            if (dyp)
+            {
+                vst1q_s16(dyp + x, vsubq_s16(vld1q_s16(s2 + x), vld1q_s16(s0 + x)));
+            }
+        }
+        for (; x < width; x++)
+        {
+            if (dxp)
+            {
+                dxp[x] = (int16_t)(rows[0][x] + 2 * rows[1][x] + rows[2][x]);
+            }
+            if (dyp)
+            {
+                dyp[x] = (int16_t)(s2[x] - s0[x]);
+            }
+        }
+    };
+    sliding_window<int16_t>(src, src_step, width, height, 3, border, 2 * width, horizontal, vertical);
+}
+
+void erode(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+           Border border)
+{
+    morphology<false>(src, src_step, dst, dst_step, width, height, ksize, border);
+}
+
+void dilate(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+            Border border)
+{
+    morphology<true>(src, src_step, dst, dst_step, width, height, ksize, border);
+}
+
+void resize_bilinear(const uint8_t* src, size_t src_step, int src_width, int src_height, uint8_t* dst,
+                     size_t dst_step, int dst_width, int dst_height)
+{
+    std::vector<int> x0(dst_width), x1(dst_width);
+    std::vector<uint16_t> ax(dst_width);
+    for (int x = 0; x < dst_width; x++)
+    {
+        int w;
+        resize_coordinate(x, src_width, dst_width, x0[x], x1[x], w);
+        ax[x] = (uint16_t)w;
+    }
+
+    // two horizontally interpolated rows, kept while consecutive output rows
+    // share their source rows
+    std::vector<uint16_t> buffers(2 * dst_width);
+    uint16_t* rows[2] = { &buffers[0], &buffers[dst_width] };
+    int cached[2] = { -1, -1 };
+    auto interpolate = [&](int sy, uint16_t* out) {
+        const uint8_t* sp = row(src, src_step, sy);
+        for (int x = 0; x < dst_width; x++)
+        {
+            out[x] = (uint16_t)((256 - ax[x]) * sp[x0[x]] + ax[x] * sp[x1[x]]);
+        }
+    };
+
+    for (int y = 0; y < dst_height; y++)
+    {
+        int y0, y1, b;
+        resize_coordinate(y, src_height, dst_height, y0, y1, b);
+        if (cached[0] != y0 && cached[1] == y0)
+        {
+            std::swap(rows[0], rows[1]);
+            std::swap(cached[0], cached[1]);
+        }
+        if (cached[0] != y0)
+        {
+            interpolate(y0, rows[0]);
+            cached[0] = y0;
+        }
+        if (cached[1] != y1)
+        {
+            interpolate(y1, rows[1]);
+            cached[1] = y1;
+        }
+
+        uint8_t* dp = row(dst, dst_step, y);
+        const uint16_t b0 = (uint16_t)(256 - b);
+        const uint16_t b1 = (uint16_t)b;
+        int x = 0;
+        for (; x + 8 <= dst_width; x += 8)
+        {
+            const uint16x8_t r0 = vld1q_u16(rows[0] + x);
+            const uint16x8_t r1 = vld1q_u16(rows[1] + x);
+            const uint32x4_t lo = vmlal_n_u16(vmull_n_u16(vget_low_u16(r0), b0), vget_low_u16(r1), b1);
+            const uint32x4_t hi = vmlal_n_u16(vmull_n_u16(vget_high_u16(r0), b0), vget_high_u16(r1), b1);
+            vst1_u8(dp + x, vmovn_u16(vcombine_u16(vrshrn_n_u32(lo, 16), vrshrn_n_u32(hi, 16))));
+        }
+        for (; x < dst_width; x++)
+        {
+            dp[x] = (uint8_t)((b0 * rows[0][x] + b1 * rows[1][x] + (1u << 15)) >> 16);
+        }
+    }
+}
+
+namespace ref {
+
+void separable_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                      const uint8_t* kernel_x, const uint8_t* kernel_y, int ksize, Border border)
+{
+    const int r = ksize / 2;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t acc = 0;
+            for (int j = 0; j < ksize; j++)
+            {
+                const int sy = border_index(y + j - r, height, border);
+                for (int i = 0; i < ksize; i++)
+                {
+                    const int sx = border_index(x + i - r, width, border);
+                    const uint32_t p = sy < 0 || sx < 0 ? 0 : row(src, src_step, sy)[sx];
+                    acc += kernel_y[j] * kernel_x[i] * p;
+                }
+            }
+            row(dst, dst_step, y)[x] = (uint8_t)((acc + (1 << 15)) >> 16);
+        }
+    }
+}
+
+void box_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                int ksize, Border border)
+{
+    const int r = ksize / 2;
+    const int area = ksize * ksize;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int sum = 0;
+            for (int j = -r; j <= r; j++)
+            {
+                const int sy = border_index(y + j, height, border);
+                for (int i = -r; i <= r; i++)
+                {
+                    const int sx = border_index(x + i, width, border);
+                    sum += sy < 0 || sx < 0 ? 0 : row(src, src_step, sy)[sx];
+                }
+            }
+            row(dst, dst_step, y)[x] = (uint8_t)((sum + area / 2) / area);
+        }
+    }
+}
+
+void sobel3x3(const uint8_t* src, size_t src_step, int16_t* dx, size_t dx_step, int16_t* dy, size_t dy_step,
+              int width, int height, Border border)
+{
+    static const int kx[3][3] = { { -1, 0, 1 }, { -2, 0, 2 }, { -1, 0, 1 } };
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int gx = 0;
+            int gy = 0;
+            for (int j = 0; j < 3; j++)
+            {
+                const int sy = border_index(y + j - 1, height, border);
+                for (int i = 0; i < 3; i++)
+                {
+                    const int sx = border_index(x + i - 1, width, border);
+                    const int p = sy < 0 || sx < 0 ? 0 : row(src, src_step, sy)[sx];
+                    gx += kx[j][i] * p;
+                    gy += kx[i][j] * p;
+                }
+            }
+            if (dx)
+            {
+                row(dx, dx_step, y)[x] = (int16_t)gx;
+            }
+            if (dy)
+            {
+                row(dy, dy_step, y)[x] = (int16_t)gy;
+            }
+        }
+    }
+}
+
+template<bool is_max>
+static void morphology(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                       int ksize, Border border)
+{
+    const int r = ksize / 2;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint8_t m = is_max ? 0 : 255;
+            for (int j = -r; j <= r; j++)
+            {
+                const int sy = border_index(y + j, height, border);
+                for (int i = -r; i <= r; i++)
+                {
+                    const int sx = border_index(x + i, width, border);
+                    m = extremum<is_max>(m, sy < 0 || sx < 0 ? (uint8_t)0 : row(src, src_step, sy)[sx]);
+                }
+            }
+            row(dst, dst_step, y)[x] = m;
+        }
+    }
+}
+
+void erode(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+           Border border)
+{
+    morphology<false>(src, src_step, dst, dst_step, width, height, ksize, border);
+}
+
+void dilate(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+            Border border)
+{
+    morphology<true>(src, src_step, dst, dst_step, width, height, ksize, border);
+}
+
+void resize_bilinear(const uint8_t* src, size_t src_step, int src_width, int src_height, uint8_t* dst,
+                     size_t dst_step, int dst_width, int dst_height)
+{
+    for (int y = 0; y < dst_height; y++)
+    {
+        int y0, y1, b;
+        resize_coordinate(y, src_height, dst_height, y0, y1, b);
+        const uint8_t* r0 = row(src, src_step, y0);
+        const uint8_t* r1 = row(src, src_step, y1);
+        for (int x = 0; x < dst_width; x++)
+        {
+            int x0, x1, a;
+            resize_coordinate(x, src_width, dst_width, x0, x1, a);
+            const uint32_t top = (256 - a) * r0[x0] + a * r0[x1];
+            const uint32_t bottom = (256 - a) * r1[x0] + a * r1[x1];
+            row(dst, dst_step, y)[x] = (uint8_t)(((256 - b) * top + b * bottom + (1u << 15)) >> 16);
+        }
+    }
+}
+
+} // namespace ref
+
+} // namespace filter
+} // namespace neon_sim_kernels
@@ -0,0 +1,103 @@
+#pragma once
+
+//
+// Separable 8-bit image filters and a bilinear resize written with NEON
+// intrinsics, the widening / narrowing work of a camera pipeline: rows are
+// widened with vmull_u8 / vmovl_u8, accumulated in 16 and 32 bits and
+// narrowed back with vrshrn_n_u32 / vmovn.
+//
+// usage:
+// #include "neon_sim_filter.hpp"
+//
+// filter::gaussian_blur(src, src_step, dst, dst_step, width, height, 5, 0.0, filter::BORDER_REFLECT_101);
+// filter::sobel3x3(src, src_step, dx, dx_step, dy, dy_step, width, height, filter::BORDER_REPLICATE);
+//
+// The filters run a horizontal pass over each source row into a sliding
+// window of ksize row buffers, so every row is filtered horizontally once,
+// then a vertical pass over the window for each output row. Pixels outside
+// the image come from the border mode. As in neon_sim_kernels.hpp, `*_step`
+// is the row stride in bytes, source and destination must not overlap, and
+// every kernel has a bit-exact scalar twin in `filter::ref` (written as
+// plain 2D loops) used by tests and benchmarks.
+//
+// As with neon_sim_kernels.hpp, the library does not define
+// NEON_SIM_IMPLEMENTATION on x86.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace neon_sim_kernels {
+namespace filter {
+
+enum Border
+{
+    BORDER_REPLICATE,   ///< aaa|abcd|ddd
+    BORDER_REFLECT_101, ///< cb|abcd|cb
+    BORDER_CONSTANT,    ///< 000|abcd|000
+};
+
+/// @brief source index of coordinate i on an axis of n pixels, -1 for a
+/// constant border
+int border_index(int i, int n, Border border);
+
+/// @brief a Gaussian of odd ksize >= 3 in Q8: taps that sum to 256, each at
+/// most 255. sigma <= 0 picks 0.3 * ((ksize - 1) / 2 - 1) + 0.8, as OpenCV does.
+void gaussian_kernel_q8(int ksize, double sigma, uint8_t* kernel);
+
+/// @brief dst = (sum of ky[j] * kx[i] * src(y + j - r, x + i - r) + 2^15) >> 16
+/// for Q8 kernels of odd ksize that sum to 256 each (r = ksize / 2). The
+/// horizontal pass is vmull_u8 / vmlal_u8 into 16 bits, the vertical one
+/// vmlal_n_u16 into 32 bits, narrowed by vrshrn_n_u32.
+void separable_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                      const uint8_t* kernel_x, const uint8_t* kernel_y, int ksize, Border border);
+
+/// @brief separable_filter with gaussian_kernel_q8 in both directions
+void gaussian_blur(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                   int ksize, double sigma, Border border);
+
+/// @brief mean of the ksize x ksize window, rounded to nearest, for odd
+/// ksize <= 15: 16 bit window sums, then a 16 x 16 bit reciprocal multiply
+/// that is exact over the whole range of sums
+void box_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                int ksize, Border border);
+
+/// @brief 3x3 Sobel into int16: dx = [1 2 1]^T [-1 0 1], dy = [-1 0 1]^T [1 2 1].
+/// Either output may be NULL.
+void sobel3x3(const uint8_t* src, size_t src_step, int16_t* dx, size_t dx_step, int16_t* dy, size_t dy_step,
+              int width, int height, Border border);
+
+/// @brief minimum (erode) / maximum (dilate) over a ksize x ksize rectangle,
+/// odd ksize, as a row pass and a column pass of vminq_u8 / vmaxq_u8
+void erode(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+           Border border);
+void dilate(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+            Border border);
+
+/// @brief bilinear resize with pixel centers aligned (OpenCV INTER_LINEAR).
+/// Source positions are computed in Q8 with integer arithmetic and clamped
+/// to the image; each source row is interpolated horizontally once into a
+/// 16 bit row buffer, the vertical blend is vmull_n_u16 / vmlal_n_u16 and
+/// vrshrn_n_u32 by 16.
+void resize_bilinear(const uint8_t* src, size_t src_step, int src_width, int src_height, uint8_t* dst,
+                     size_t dst_step, int dst_width, int dst_height);
+
+namespace ref {
+
+void separable_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                      const uint8_t* kernel_x, const uint8_t* kernel_y, int ksize, Border border);
+void box_filter(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+                int ksize, Border border);
+void sobel3x3(const uint8_t* src, size_t src_step, int16_t* dx, size_t dx_step, int16_t* dy, size_t dy_step,
+              int width, int height, Border border);
+void erode(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+           Border border);
+void dilate(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height, int ksize,
+            Border border);
+void resize_bilinear(const uint8_t* src, size_t src_step, int src_width, int src_height, uint8_t* dst,
+                     size_t dst_step, int dst_width, int dst_height);
+
+} // namespace ref
+
+} // namespace filter
+} // namespace neon_sim_kernels
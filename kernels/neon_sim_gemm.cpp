@@ -0,0 +1,519 @@
+#include "neon_sim_gemm.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace neon_sim_kernels {
+namespace gemm {
+
+namespace {
+
+template<typename T>
+inline const T* row(const T* base, size_t step, int y)
+{
+    return (const T*)((const uint8_t*)base + y * step);
+}
+
+template<typename T>
+inline T* row(T* base, size_t step, int y)
+{
+    return (T*)((uint8_t*)base + y * step);
+}
+
+inline int round_up(int v, int to)
+{
+    return (v + to - 1) / to * to;
+}
+
+// Lane indices must be constants for the native intrinsics, hence one
+// instantiation per row of the tile.
+template<int lane>
+inline void fma_row(float32x4_t acc[3], float32x4_t b0, float32x4_t b1, float32x4_t b2, float32x4_t a)
+{
+    acc[0] = vfmaq_laneq_f32(acc[0], b0, a, lane);
+    acc[1] = vfmaq_laneq_f32(acc[1], b1, a, lane);
+    acc[2] = vfmaq_laneq_f32(acc[2], b2, a, lane);
+}
+
+template<int lane>
+inline void mlal_row(int32x4_t acc[2], int16x4_t b0, int16x4_t b1, int16x4_t a)
+{
+    acc[0] = vmlal_lane_s16(acc[0], b0, a, lane);
+    acc[1] = vmlal_lane_s16(acc[1], b1, a, lane);
+}
+
+// the 8 x 8 int32 tile of C = A panel * B panel
+void igemm_kernel_8x8(int k, const int8_t* a, const int8_t* b, int32_t* c, size_t c_step)
+{
+    int32x4_t acc[8][2];
+    for (int r = 0; r < 8; r++)
+    {
+        acc[r][0] = vdupq_n_s32(0);
+        acc[r][1] = vdupq_n_s32(0);
+    }
+    for (int p = 0; p < k; p++)
+    {
+        const int16x8_t va = vmovl_s8(vld1_s8(a));
+        const int16x8_t vb = vmovl_s8(vld1_s8(b));
+        const int16x4_t a_lo = vget_low_s16(va);
+        const int16x4_t a_hi = vget_high_s16(va);
+        const int16x4_t b_lo = vget_low_s16(vb);
+        const int16x4_t b_hi = vget_high_s16(vb);
+        mlal_row<0>(acc[0], b_lo, b_hi, a_lo);
+        mlal_row<1>(acc[1], b_lo, b_hi, a_lo);
+        mlal_row<2>(acc[2], b_lo, b_hi, a_lo);
+        mlal_row<3>(acc[3], b_lo, b_hi, a_lo);
+        mlal_row<0>(acc[4], b_lo, b_hi, a_hi);
+        mlal_row<1>(acc[5], b_lo, b_hi, a_hi);
+        mlal_row<2>(acc[6], b_lo, b_hi, a_hi);
+        mlal_row<3>(acc[7], b_lo, b_hi, a_hi);
+        a += kIgemmMR;
+        b += kIgemmNR;
+    }
+    for (int r = 0; r < 8; r++)
+    {
+        int32_t* cp = row(c, c_step, r);
+        vst1q_s32(cp, acc[r][0]);
+        vst1q_s32(cp + 4, acc[r][1]);
+    }
+}
+
+// Packs rows [0, m) x columns [0, k) of a row-major matrix into panels of
+// `mr` rows stored k-major, or (transposed = false) columns [0, n) of a k x n
+// matrix into panels of `nr` columns. Padding is zero.
+template<typename T>
+void pack_rows(const T* a, size_t a_step, int m, int k, int mr, T* packed)
+{
+    for (int i0 = 0; i0 < m; i0 += mr)
+    {
+        for (int p = 0; p < k; p++)
+        {
+            for (int r = 0; r < mr; r++)
+            {
+                *packed++ = i0 + r < m ? row(a, a_step, i0 + r)[p] : T(0);
+            }
+        }
+    }
+}
+
+template<typename T>
+void pack_columns(const T* b, size_t b_step, int k, int n, int nr, T* packed)
+{
+    for (int j0 = 0; j0 < n; j0 += nr)
+    {
+        const int cols = std::min(nr, n - j0);
+        for (int p = 0; p < k; p++)
+        {
+            const T* bp = row(b, b_step, p) + j0;
+            std::copy(bp, bp + cols, packed);
+            std::fill(packed + cols, packed + nr, T(0));
+            packed += nr;
+        }
+    }
+}
+
+// Runs `kernel` over every mr x nr tile of C; tiles that stick out of m x n
+// are computed into a scratch tile and the valid part is copied.
+template<typename T, typename S, typename Kernel>
+void for_each_tile(int m, int n, int k, const S* packed_a, const S* packed_b, int mr, int nr, T* c, size_t c_step,
+                   Kernel kernel)
+{
+    T scratch[8 * 12];
+    for (int i0 = 0; i0 < m; i0 += mr)
+    {
+        const S* a_panel = packed_a + (size_t)i0 * k;
+        for (int j0 = 0; j0 < n; j0 += nr)
+        {
+            const S* b_panel = packed_b + (size_t)j0 * k;
+            const int rows = std::min(mr, m - i0);
+            const int cols = std::min(nr, n - j0);
+            if (rows == mr && cols == nr)
+            {
+                kernel(k, a_panel, b_panel, row(c, c_step, i0) + j0, c_step);
+                continue;
+            }
+            kernel(k, a_panel, b_panel, scratch, nr * sizeof(T));
+            for (int r = 0; r < rows; r++)
+            {
+                std::copy(scratch + r * nr, scratch + r * nr + cols, row(c, c_step, i0 + r) + j0);
+            }
+        }
+    }
+}
+
+// 4 x 4 transpose of the rows r[0..3]
+inline void transpose4(float32x4_t r[4])
+{
+    const float32x4x2_t t01 = vtrnq_f32(r[0], r[1]);
+    const float32x4x2_t t23 = vtrnq_f32(r[2], r[3]);
+    r[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+// rows of B^T d for a 4 x 4 tile d: (d0 - d2, d1 + d2, d2 - d1, d1 - d3)
+inline void winograd_bt(float32x4_t d[4])
+{
+    const float32x4_t t0 = vsubq_f32(d[0], d[2]);
+    const float32x4_t t1 = vaddq_f32(d[1], d[2]);
+    const float32x4_t t2 = vsubq_f32(d[2], d[1]);
+    const float32x4_t t3 = vsubq_f32(d[1], d[3]);
+    d[0] = t0;
+    d[1] = t1;
+    d[2] = t2;
+    d[3] = t3;
+}
+
+} // namespace
+
+size_t sgemm_packed_a_size(int m, int k)
+{
+    return (size_t)round_up(m, kSgemmMR) * k;
+}
+
+size_t sgemm_packed_b_size(int k, int n)
+{
+    return (size_t)round_up(n, kSgemmNR) * k;
+}
+
+void sgemm_pack_a(const float* a, size_t a_step, int m, int k, float* packed)
+{
+    pack_rows(a, a_step, m, k, kSgemmMR, packed);
+}
+
+void sgemm_pack_b(const float* b, size_t b_step, int k, int n, float* packed)
+{
+    pack_columns(b, b_step, k, n, kSgemmNR, packed);
+}
+
+void sgemm_kernel_8x12(int k, const float* a, const float* b, float* c, size_t c_step)
+{
+    float32x4_t acc[8][3];
+    for (int r = 0; r < 8; r++)
+    {
+        acc[r][0] = acc[r][1] = acc[r][2] = vdupq_n_f32(0.0f);
+    }
+    for (int p = 0; p < k; p++)
+    {
+        const float32x4_t a0 = vld1q_f32(a);
+        const float32x4_t a1 = vld1q_f32(a + 4);
+        const float32x4_t b0 = vld1q_f32(b);
+        const float32x4_t b1 = vld1q_f32(b + 4);
+        const float32x4_t b2 = vld1q_f32(b + 8);
+        fma_row<0>(acc[0], b0, b1, b2, a0);
+        fma_row<1>(acc[1], b0, b1, b2, a0);
+        fma_row<2>(acc[2], b0, b1, b2, a0);
+        fma_row<3>(acc[3], b0, b1, b2, a0);
+        fma_row<0>(acc[4], b0, b1, b2, a1);
+        fma_row<1>(acc[5], b0, b1, b2, a1);
+        fma_row<2>(acc[6], b0, b1, b2, a1);
+        fma_row<3>(acc[7], b0, b1, b2, a1);
+        a += kSgemmMR;
+        b += kSgemmNR;
+    }
+    for (int r = 0; r < 8; r++)
+    {
+        float* cp = row(c, c_step, r);
+        vst1q_f32(cp, acc[r][0]);
+        vst1q_f32(cp + 4, acc[r][1]);
+        vst1q_f32(cp + 8, acc[r][2]);
+    }
+}
+
+void sgemm_packed(int m, int n, int k, const float* packed_a, const float* packed_b, float* c, size_t c_step)
+{
+    for_each_tile(m, n, k, packed_a, packed_b, kSgemmMR, kSgemmNR, c, c_step, sgemm_kernel_8x12);
+}
+
+void sgemm(int m, int n, int k, const float* a, size_t a_step, const float* b, size_t b_step, float* c,
+           size_t c_step)
+{
+    std::vector<float> packed_a(sgemm_packed_a_size(m, k));
+    std::vector<float> packed_b(sgemm_packed_b_size(k, n));
+    sgemm_pack_a(a, a_step, m, k, packed_a.data());
+    sgemm_pack_b(b, b_step, k, n, packed_b.data());
+    sgemm_packed(m, n, k, packed_a.data(), packed_b.data(), c, c_step);
+}
+
+size_t igemm_packed_a_size(int m, int k)
+{
+    return (size_t)round_up(m, kIgemmMR) * k;
+}
+
+size_t igemm_packed_b_size(int k, int n)
+{
+    return (size_t)round_up(n, kIgemmNR) * k;
+}
+
+void igemm_pack_a(const int8_t* a, size_t a_step, int m, int k, int8_t* packed)
+{
+    pack_rows(a, a_step, m, k, kIgemmMR, packed);
+}
+
+void igemm_pack_b(const int8_t* b, size_t b_step, int k, int n, int8_t* packed)
+{
+    pack_columns(b, b_step, k, n, kIgemmNR, packed);
+}
+
+void igemm(int m, int n, int k, const int8_t* a, size_t a_step, const int8_t* b, size_t b_step, int32_t* c,
+           size_t c_step)
+{
+    std::vector<int8_t> packed_a(igemm_packed_a_size(m, k));
+    std::vector<int8_t> packed_b(igemm_packed_b_size(k, n));
+    igemm_pack_a(a, a_step, m, k, packed_a.data());
+    igemm_pack_b(b, b_step, k, n, packed_b.data());
+    for_each_tile(m, n, k, packed_a.data(), packed_b.data(), kIgemmMR, kIgemmNR, c, c_step, igemm_kernel_8x8);
+}
+
+void conv3x3_direct(const float* in, int channels, int height, int width, const float* weights, const float* bias,
+                    float* out, int out_channels)
+{
+    const int out_h = height - 2;
+    const int out_w = width - 2;
+    const size_t plane = (size_t)height * width;
+    for (int o = 0; o < out_channels; o++)
+    {
+        const float b = bias ? bias[o] : 0.0f;
+        const float* w = weights + (size_t)o * channels * 9;
+        float* op = out + (size_t)o * out_h * out_w;
+        for (int y = 0; y < out_h; y++)
+        {
+            int x = 0;
+            for (; x + 4 <= out_w; x += 4)
+            {
+                float32x4_t acc = vdupq_n_f32(b);
+                for (int c = 0; c < channels; c++)
+                {
+                    const float* k = w + c * 9;
+                    const float32x4_t k0 = vld1q_f32(k);
+                    const float32x4_t k1 = vld1q_f32(k + 4);
+                    const float* r0 = in + c * plane + (size_t)y * width + x;
+                    const float* r1 = r0 + width;
+                    const float* r2 = r1 + width;
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r0), k0, 0);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r0 + 1), k0, 1);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r0 + 2), k0, 2);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r1), k0, 3);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r1 + 1), k1, 0);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r1 + 2), k1, 1);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r2), k1, 2);
+                    acc = vfmaq_laneq_f32(acc, vld1q_f32(r2 + 1), k1, 3);
+                    acc = vfmaq_n_f32(acc, vld1q_f32(r2 + 2), k[8]);
+                }
+                vst1q_f32(op + (size_t)y * out_w + x, acc);
+            }
+            for (; x < out_w; x++)
+            {
+                float acc = b;
+                for (int c = 0; c < channels; c++)
+                {
+                    for (int i = 0; i < 9; i++)
+                    {
+                        acc = std::fma(in[c * plane + (size_t)(y + i / 3) * width + x + i % 3], w[c * 9 + i], acc);
+                    }
+                }
+                op[(size_t)y * out_w + x] = acc;
+            }
+        }
+    }
+}
+
+size_t winograd_weights_size(int channels, int out_channels)
+{
+    return (size_t)channels * out_channels * 16;
+}
+
+void winograd_transform_weights(const float* weights, int channels, int out_channels, float* transformed)
+{
+    for (size_t t = 0; t < (size_t)channels * out_channels; t++)
+    {
+        const float* g = weights + t * 9;
+        // G g: rows g0, (g0 + g1 + g2) / 2, (g0 - g1 + g2) / 2, g2
+        float gg[4][3];
+        for (int j = 0; j < 3; j++)
+        {
+            gg[0][j] = g[j];
+            gg[1][j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+            gg[2][j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+            gg[3][j] = g[6 + j];
+        }
+        // (G g) G^T, stored transposed to match the transposed input tiles
+        float* u = transformed + t * 16;
+        for (int i = 0; i < 4; i++)
+        {
+            u[0 * 4 + i] = gg[i][0];
+            u[1 * 4 + i] = 0.5f * (gg[i][0] + gg[i][1] + gg[i][2]);
+            u[2 * 4 + i] = 0.5f * (gg[i][0] - gg[i][1] + gg[i][2]);
+            u[3 * 4 + i] = gg[i][2];
+        }
+    }
+}
+
+void conv3x3_winograd(const float* in, int channels, int height, int width, const float* transformed,
+                      const float* bias, float* out, int out_channels)
+{
+    const int out_h = height - 2;
+    const int out_w = width - 2;
+    const int tiles_y = (out_h + 1) / 2;
+    const int tiles_x = (out_w + 1) / 2;
+    const size_t tiles = (size_t)tiles_y * tiles_x;
+    const size_t plane = (size_t)height * width;
+
+    // V^T = B^T (B^T d)^T for every 4 x 4 input tile (stride 2) and channel
+    std::vector<float> v(tiles * channels * 16);
+    for (int ty = 0; ty < tiles_y; ty++)
+    {
+        for (int tx = 0; tx < tiles_x; tx++)
+        {
+            const int y0 = 2 * ty;
+            const int x0 = 2 * tx;
+            const bool inside = y0 + 4 <= height && x0 + 4 <= width;
+            for (int c = 0; c < channels; c++)
+            {
+                const float* src = in + c * plane + (size_t)y0 * width + x0;
+                float pad[16];
+                size_t step = width;
+                if (!inside)
+                {
+                    // the last row or column of tiles when the output size is odd
+                    for (int i = 0; i < 4; i++)
+                    {
+                        for (int j = 0; j < 4; j++)
+                        {
+                            pad[i * 4 + j] = y0 + i < height && x0 + j < width ? src[i * width + j] : 0.0f;
+                        }
+                    }
+                    src = pad;
+                    step = 4;
+                }
+                float32x4_t d[4];
+                for (int i = 0; i < 4; i++)
+                {
+                    d[i] = vld1q_f32(src + i * step);
+                }
+                winograd_bt(d);
+                transpose4(d);
+                winograd_bt(d);
+                float* vp = &v[(((size_t)ty * tiles_x + tx) * channels + c) * 16];
+                for (int i = 0; i < 4; i++)
+                {
+                    vst1q_f32(vp + i * 4, d[i]);
+                }
+            }
+        }
+    }
+
+    for (int o = 0; o < out_channels; o++)
+    {
+        const float b = bias ? bias[o] : 0.0f;
+        const float* u = transformed + (size_t)o * channels * 16;
+        float* op = out + (size_t)o * out_h * out_w;
+        for (size_t t = 0; t < tiles; t++)
+        {
+            // M^T = sum over channels of U^T * V^T, element-wise
+            float32x4_t m[4] = { vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f) };
+            const float* vp = &v[t * channels * 16];
+            for (int c = 0; c < channels; c++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    m[i] = vfmaq_f32(m[i], vld1q_f32(u + c * 16 + i * 4), vld1q_f32(vp + c * 16 + i * 4));
+                }
+            }
+            // S = A^T M^T (2 x 4), then Y = (S A)^T
+            float s[2][4];
+            vst1q_f32(s[0], vaddq_f32(vaddq_f32(m[0], m[1]), m[2]));
+            vst1q_f32(s[1], vsubq_f32(vsubq_f32(m[1], m[2]), m[3]));
+            const int y0 = 2 * (int)(t / tiles_x);
+            const int x0 = 2 * (int)(t % tiles_x);
+            for (int i = 0; i < 2 && y0 + i < out_h; i++)
+            {
+                for (int j = 0; j < 2 && x0 + j < out_w; j++)
+                {
+                    const float* sj = s[j];
+                    const float z = i == 0 ? sj[0] + sj[1] + sj[2] : sj[1] - sj[2] - sj[3];
+                    op[(size_t)(y0 + i) * out_w + x0 + j] = z + b;
+                }
+            }
+        }
+    }
+}
+
+namespace ref {
+
+void sgemm(int m, int n, int k, const float* a, size_t a_step, const float* b, size_t b_step, float* c,
+           size_t c_step)
+{
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            float acc = 0.0f;
+            for (int p = 0; p < k; p++)
+            {
+                acc = std::fma(row(a, a_step, i)[p], row(b, b_step, p)[j], acc);
+            }
+            row(c, c_step, i)[j] = acc;
+        }
+    }
+}
+
+void igemm(int m, int n, int k, const int8_t* a, size_t a_step, const int8_t* b, size_t b_step, int32_t* c,
+           size_t c_step)
+{
+    for (int i = 0; i < m; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            int32_t acc = 0;
+            for (int p = 0; p < k; p++)
+            {
+                acc += row(a, a_step, i)[p] * row(b, b_step, p)[j];
+            }
+            row(c, c_step, i)[j] = acc;
+        }
+    }
+}
+
+void conv3x3(const float* in, int channels, int height, int width, const float* weights, const float* bias,
+             float* out, int out_channels)
+{
+    const int out_h = height - 2;
+    const int out_w = width - 2;
+    for (int o = 0; o < out_channels; o++)
+    {
+        for (int y = 0; y < out_h; y++)
+        {
+            for (int x = 0; x < out_w; x++)
+            {
+                float acc = bias ? bias[o] : 0.0f;
+                for (int c = 0; c < channels; c++)
+                {
+                    const float* w = weights + ((size_t)o * channels + c) * 9;
+                    const float* src = in + (size_t)c * height * width;
+                    for (int i = 0; i < 3; i++)
+                    {
+                        for (int j = 0; j < 3; j++)
+                        {
+                            acc = std::fma(src[(size_t)(y + i) * width + x + j], w[i * 3 + j], acc);
+                        }
+                    }
+                }
+                out[((size_t)o * out_h + y) * out_w + x] = acc;
+            }
+        }
+    }
+}
+
+} // namespace ref
+
+} // namespace gemm
+} // namespace neon_sim_kernels
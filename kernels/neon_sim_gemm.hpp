@@ -0,0 +1,104 @@
+#pragma once
+
+//
+// GEMM and 3x3 convolution microkernels written with NEON intrinsics, laid
+// out the way ncnn / XNNPACK do it: operands are packed into panels once,
+// and a register-blocked microkernel streams through the panels.
+//
+// usage:
+// #include "neon_sim_gemm.hpp"
+//
+// gemm::sgemm(m, n, k, a, a_step, b, b_step, c, c_step);   // C = A * B, row-major floats
+//
+// std::vector<float> packed_a(gemm::sgemm_packed_a_size(m, k));
+// gemm::sgemm_pack_a(a, a_step, m, k, packed_a.data());  // reuse across many B
+//
+// As in neon_sim_kernels.hpp, `*_step` is the row stride in bytes. The
+// scalar twins in `gemm::ref` follow the summation order of the vector code
+// with one fused multiply-add per term, so sgemm, igemm and conv3x3_direct
+// are bit-exact with them. conv3x3_winograd rounds differently (it trades
+// multiplies for adds) and is compared with a tolerance.
+//
+// As with neon_sim_kernels.hpp, the library does not define
+// NEON_SIM_IMPLEMENTATION on x86.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace neon_sim_kernels {
+namespace gemm {
+
+// register tiles: 8 x 12 floats (24 accumulators), 8 x 8 int32 (16)
+const int kSgemmMR = 8;
+const int kSgemmNR = 12;
+const int kIgemmMR = 8;
+const int kIgemmNR = 8;
+
+/// @brief floats in a packed A: m rounded up to 8, times k
+size_t sgemm_packed_a_size(int m, int k);
+
+/// @brief floats in a packed B: n rounded up to 12, times k
+size_t sgemm_packed_b_size(int k, int n);
+
+/// @brief A (m x k) into panels of 8 rows, stored k-major; missing rows are zero
+void sgemm_pack_a(const float* a, size_t a_step, int m, int k, float* packed);
+
+/// @brief B (k x n) into panels of 12 columns, stored k-major; missing columns are zero
+void sgemm_pack_b(const float* b, size_t b_step, int k, int n, float* packed);
+
+/// @brief the microkernel: the 8 x 12 tile of C = A panel * B panel, written
+/// in full; one vfmaq_laneq_f32 per row and 4 columns per step of k
+void sgemm_kernel_8x12(int k, const float* a_panel, const float* b_panel, float* c, size_t c_step);
+
+/// @brief C (m x n) = A (m x k) * B (k x n), packing both operands
+void sgemm(int m, int n, int k, const float* a, size_t a_step, const float* b, size_t b_step, float* c,
+           size_t c_step);
+
+/// @brief the same for packed operands; edge tiles go through a scratch tile
+void sgemm_packed(int m, int n, int k, const float* packed_a, const float* packed_b, float* c, size_t c_step);
+
+/// @brief int8 operands, packed like the float ones with panels of 8 and 8
+size_t igemm_packed_a_size(int m, int k);
+size_t igemm_packed_b_size(int k, int n);
+void igemm_pack_a(const int8_t* a, size_t a_step, int m, int k, int8_t* packed);
+void igemm_pack_b(const int8_t* b, size_t b_step, int k, int n, int8_t* packed);
+
+/// @brief C (m x n, int32) = A (m x k, int8) * B (k x n, int8). Operands are
+/// widened with vmovl_s8 and accumulated with vmlal_lane_s16; exact while
+/// k <= 2^17 (no int32 overflow)
+void igemm(int m, int n, int k, const int8_t* a, size_t a_step, const int8_t* b, size_t b_step, int32_t* c,
+           size_t c_step);
+
+/// @brief 3x3, stride 1, no padding:
+/// out[o](y, x) = bias[o] + sum over c, i, j of w[o][c][i][j] * in[c](y + i, x + j)
+/// `in` is `channels` contiguous planes of height x width, `out` is
+/// out_channels planes of (height - 2) x (width - 2), `weights` is
+/// [out_channels][channels][3][3]; bias may be NULL. height, width >= 3.
+void conv3x3_direct(const float* in, int channels, int height, int width, const float* weights, const float* bias,
+                    float* out, int out_channels);
+
+/// @brief floats of Winograd-transformed weights: 16 per output and input channel
+size_t winograd_weights_size(int channels, int out_channels);
+
+/// @brief U = G g G^T for every 3x3 kernel g, for conv3x3_winograd
+void winograd_transform_weights(const float* weights, int channels, int out_channels, float* transformed);
+
+/// @brief conv3x3_direct through Winograd F(2x2, 3x3): 16 multiplies per 2 x 2
+/// outputs and input channel instead of 36, plus the input and output transforms
+void conv3x3_winograd(const float* in, int channels, int height, int width, const float* transformed,
+                      const float* bias, float* out, int out_channels);
+
+namespace ref {
+
+void sgemm(int m, int n, int k, const float* a, size_t a_step, const float* b, size_t b_step, float* c,
+           size_t c_step);
+void igemm(int m, int n, int k, const int8_t* a, size_t a_step, const int8_t* b, size_t b_step, int32_t* c,
+           size_t c_step);
+void conv3x3(const float* in, int channels, int height, int width, const float* weights, const float* bias,
+             float* out, int out_channels);
+
+} // namespace ref
+
+} // namespace gemm
+} // namespace neon_sim_kernels
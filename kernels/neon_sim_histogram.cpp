@@ -0,0 +1,163 @@
+#include "neon_sim_histogram.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <string.h>
+
+namespace neon_sim_kernels {
+namespace histogram {
+
+namespace {
+
+template<typename T>
+inline const T* row(const T* base, size_t step, int y)
+{
+    return (const T*)((const uint8_t*)base + y * step);
+}
+
+template<typename T>
+inline T* row(T* base, size_t step, int y)
+{
+    return (T*)((uint8_t*)base + y * step);
+}
+
+// 8 pixels packed in a 64 bit lane; byte i goes to bank i % B
+template<int B>
+inline void count8(uint64_t pixels, uint32_t (*bank)[256])
+{
+    for (int i = 0; i < 8; i++)
+    {
+        bank[i % B][(pixels >> (8 * i)) & 0xff]++;
+    }
+}
+
+template<int B>
+void count_banked(const uint8_t* src, size_t src_step, int width, int height, uint32_t* hist)
+{
+    uint32_t bank[B][256];
+    memset(bank, 0, sizeof(bank));
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* s = row(src, src_step, y);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            const uint64x2_t v = vreinterpretq_u64_u8(vld1q_u8(s + x));
+            count8<B>(vgetq_lane_u64(v, 0), bank);
+            count8<B>(vgetq_lane_u64(v, 1), bank);
+        }
+        for (; x < width; x++)
+        {
+            bank[x % B][s[x]]++;
+        }
+    }
+
+    for (int i = 0; i < 256; i += 4)
+    {
+        uint32x4_t total = vld1q_u32(bank[0] + i);
+        for (int b = 1; b < B; b++)
+        {
+            total = vaddq_u32(total, vld1q_u32(bank[b] + i));
+        }
+        vst1q_u32(hist + i, total);
+    }
+}
+
+} // namespace
+
+void histogram_u8(const uint8_t* src, size_t src_step, int width, int height, uint32_t* hist, int banks)
+{
+    switch (banks)
+    {
+    case 1:
+        count_banked<1>(src, src_step, width, height, hist);
+        break;
+    case 2:
+        count_banked<2>(src, src_step, width, height, hist);
+        break;
+    case 4:
+        count_banked<4>(src, src_step, width, height, hist);
+        break;
+    default:
+        count_banked<8>(src, src_step, width, height, hist);
+        break;
+    }
+}
+
+void integral(const uint8_t* src, size_t src_step, uint32_t* sum, size_t sum_step, int width, int height)
+{
+    memset(sum, 0, (width + 1) * sizeof(uint32_t));
+    const uint16x8_t zero = vdupq_n_u16(0);
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* s = row(src, src_step, y);
+        const uint32_t* above = row(sum, sum_step, y) + 1;
+        uint32_t* out = row(sum, sum_step, y + 1);
+        out[0] = 0;
+        out++;
+
+        uint32x4_t carry = vdupq_n_u32(0);
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            // prefix sum of 8 pixels, at most 8 * 255 in 16 bits
+            uint16x8_t p = vmovl_u8(vld1_u8(s + x));
+            p = vaddq_u16(p, vextq_u16(zero, p, 7));
+            p = vaddq_u16(p, vextq_u16(zero, p, 6));
+            p = vaddq_u16(p, vextq_u16(zero, p, 4));
+
+            const uint32x4_t lo = vaddq_u32(vmovl_u16(vget_low_u16(p)), carry);
+            const uint32x4_t hi = vaddq_u32(vmovl_u16(vget_high_u16(p)), carry);
+            vst1q_u32(out + x, vaddq_u32(lo, vld1q_u32(above + x)));
+            vst1q_u32(out + x + 4, vaddq_u32(hi, vld1q_u32(above + x + 4)));
+            carry = vdupq_n_u32(vgetq_lane_u32(hi, 3));
+        }
+        uint32_t total = vgetq_lane_u32(carry, 0);
+        for (; x < width; x++)
+        {
+            total += s[x];
+            out[x] = above[x] + total;
+        }
+    }
+}
+
+namespace ref {
+
+void histogram_u8(const uint8_t* src, size_t src_step, int width, int height, uint32_t* hist)
+{
+    memset(hist, 0, 256 * sizeof(uint32_t));
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            hist[src[y * src_step + x]]++;
+        }
+    }
+}
+
+void integral(const uint8_t* src, size_t src_step, uint32_t* sum, size_t sum_step, int width, int height)
+{
+    for (int y = 0; y <= height; y++)
+    {
+        uint32_t* out = row(sum, sum_step, y);
+        for (int x = 0; x <= width; x++)
+        {
+            if (x == 0 || y == 0)
+            {
+                out[x] = 0;
+                continue;
+            }
+            const uint32_t* above = row(sum, sum_step, y - 1);
+            out[x] = src[(y - 1) * src_step + x - 1] + out[x - 1] + above[x] - above[x - 1];
+        }
+    }
+}
+
+} // namespace ref
+
+} // namespace histogram
+} // namespace neon_sim_kernels
@@ -0,0 +1,57 @@
+#pragma once
+
+//
+// 8-bit histograms and integral images written with NEON intrinsics, the
+// per-frame statistics of auto-exposure and box-feature detectors.
+//
+// usage:
+// #include "neon_sim_histogram.hpp"
+//
+// uint32_t hist[256];
+// histogram::histogram_u8(src, src_step, width, height, hist, 4);
+// histogram::integral(src, src_step, sum, (width + 1) * sizeof(uint32_t), width, height);
+//
+// NEON has no scatter, so the counting itself is scalar: 16 pixels are
+// loaded at once and moved out of the vector as two 64 bit lanes. A single
+// table serializes on runs of equal pixels (each increment waits for the
+// store of the previous one to the same bin); with `banks` tables pixel i
+// counts into table i % banks, so neighbours never touch the same counter.
+// The tables are merged with vaddq_u32 at the end. Flat images are the
+// worst case for one bank and the best case for banking; noise is the
+// opposite, as the extra tables only cost cache.
+//
+// The integral image computes the prefix sum of 8 pixels in 16 bits with
+// three vextq_u16 shift-and-add steps, widens it, adds the running row
+// total (the carry of the previous 8 pixels) and the row above.
+//
+// Every kernel has a scalar twin in `histogram::ref`. As in
+// neon_sim_kernels.hpp, `*_step` is the row stride in bytes.
+//
+// As with neon_sim_kernels.hpp, the library does not define
+// NEON_SIM_IMPLEMENTATION on x86.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace neon_sim_kernels {
+namespace histogram {
+
+/// @brief the 256 bin histogram of a width x height 8-bit image into hist
+/// (overwritten), counting into `banks` sub-histograms: 1, 2, 4 or 8
+void histogram_u8(const uint8_t* src, size_t src_step, int width, int height, uint32_t* hist, int banks);
+
+/// @brief cv::integral layout: sum is (width + 1) x (height + 1), the first
+/// row and column are 0 and sum(x + 1, y + 1) is the total of src over
+/// [0, x] x [0, y]. 32 bit totals hold images of up to 16843009 pixels.
+void integral(const uint8_t* src, size_t src_step, uint32_t* sum, size_t sum_step, int width, int height);
+
+namespace ref {
+
+void histogram_u8(const uint8_t* src, size_t src_step, int width, int height, uint32_t* hist);
+void integral(const uint8_t* src, size_t src_step, uint32_t* sum, size_t sum_step, int width, int height);
+
+} // namespace ref
+
+} // namespace histogram
+} // namespace neon_sim_kernels
@@ -0,0 +1,480 @@
+#include "neon_sim_image_io.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+
+#if __unix__ || __APPLE__
+#define NEON_SIM_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define NEON_SIM_HAS_MMAP 0
+#endif
+
+namespace neon_sim_kernels {
+
+#if !NEON_SIM_HAS_MMAP
+static const size_t BUFFER_ALIGN = 4096;
+
+// page aligned like a mapping; without _aligned_malloc the block is
+// over-allocated and the malloc pointer kept just before the aligned start
+static uint8_t* buffer_alloc(size_t size)
+{
+#if _WIN32
+    return (uint8_t*)_aligned_malloc(size, BUFFER_ALIGN);
+#else
+    uint8_t* raw = (uint8_t*)malloc(size + BUFFER_ALIGN + sizeof(void*));
+    if (!raw)
+    {
+        return NULL;
+    }
+    uint8_t* p = raw + sizeof(void*);
+    p += (BUFFER_ALIGN - ((uintptr_t)p & (BUFFER_ALIGN - 1))) & (BUFFER_ALIGN - 1);
+    memcpy(p - sizeof(void*), &raw, sizeof(void*));
+    return p;
+#endif
+}
+
+static void buffer_free(uint8_t* p)
+{
+#if _WIN32
+    _aligned_free(p);
+#else
+    void* raw;
+    memcpy(&raw, p - sizeof(void*), sizeof(void*));
+    free(raw);
+#endif
+}
+#endif // !NEON_SIM_HAS_MMAP
+
+// pixel data of the PNM files we write starts at this offset
+static const size_t PNM_DATA_ALIGN = 64;
+
+MappedImage::MappedImage()
+{
+}
+
+MappedImage::~MappedImage()
+{
+    close();
+}
+
+MappedImage::MappedImage(MappedImage&& other)
+{
+    *this = std::move(other);
+}
+
+MappedImage& MappedImage::operator=(MappedImage&& other)
+{
+    if (this != &other)
+    {
+        close();
+        base_ = other.base_;
+        size_ = other.size_;
+        writable_ = other.writable_;
+        path_ = other.path_;
+        planes_[0] = other.planes_[0];
+        planes_[1] = other.planes_[1];
+        plane_count_ = other.plane_count_;
+        frame_count_ = other.frame_count_;
+        error_ = other.error_;
+        other.base_ = NULL;
+        other.size_ = 0;
+        other.close();
+    }
+    return *this;
+}
+
+void MappedImage::close()
+{
+    if (base_)
+    {
+#if NEON_SIM_HAS_MMAP
+        munmap(base_, size_);
+#else
+        if (writable_)
+        {
+            FILE* fp = fopen(path_.c_str(), "wb");
+            if (fp)
+            {
+                fwrite(base_, 1, size_, fp);
+                fclose(fp);
+            }
+        }
+        buffer_free(base_);
+#endif
+    }
+    base_ = NULL;
+    size_ = 0;
+    writable_ = false;
+    path_.clear();
+    planes_[0] = ImageView();
+    planes_[1] = ImageView();
+    plane_count_ = 0;
+    frame_count_ = 0;
+}
+
+MutableImageView MappedImage::mutable_view() const
+{
+    if (!writable_)
+    {
+        return MutableImageView();
+    }
+    // the pixels of a writable mapping belong to base_, which is not const
+    MutableImageView v;
+    v.data = base_ + (planes_[0].data - base_);
+    v.step = planes_[0].step;
+    v.width = planes_[0].width;
+    v.height = planes_[0].height;
+    v.channels = planes_[0].channels;
+    return v;
+}
+
+bool MappedImage::fail(const std::string& path, const std::string& what)
+{
+    close();
+    error_ = path + ": " + what;
+    return false;
+}
+
+// create_size == 0 maps an existing file read only, otherwise the file is
+// created with that size and mapped writable.
+bool MappedImage::map(const std::string& path, size_t create_size)
+{
+    close();
+    error_.clear();
+    const bool create = create_size > 0;
+#if NEON_SIM_HAS_MMAP
+    const int fd = create ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644) : ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return fail(path, strerror(errno));
+    }
+    size_t size = create_size;
+    if (create)
+    {
+        if (ftruncate(fd, (off_t)size) != 0)
+        {
+            const std::string msg = strerror(errno);
+            ::close(fd);
+            return fail(path, msg);
+        }
+    }
+    else
+    {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            const std::string msg = strerror(errno);
+            ::close(fd);
+            return fail(path, msg);
+        }
+        size = (size_t)st.st_size;
+    }
+    if (size == 0)
+    {
+        ::close(fd);
+        return fail(path, "empty file");
+    }
+    void* p = mmap(NULL, size, create ? (PROT_READ | PROT_WRITE) : PROT_READ, create ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        return fail(path, strerror(errno));
+    }
+    base_ = (uint8_t*)p;
+    size_ = size;
+#else
+    size_t size = create_size;
+    if (!create)
+    {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp)
+        {
+            return fail(path, "cannot open");
+        }
+        fseek(fp, 0, SEEK_END);
+        size = (size_t)ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        if (size == 0)
+        {
+            fclose(fp);
+            return fail(path, "empty file");
+        }
+        base_ = buffer_alloc(size);
+        const size_t got = fread(base_, 1, size, fp);
+        fclose(fp);
+        if (got != size)
+        {
+            return fail(path, "short read");
+        }
+    }
+    else
+    {
+        base_ = buffer_alloc(size);
+        memset(base_, 0, size);
+    }
+    size_ = size;
+#endif
+    writable_ = create;
+    path_ = path;
+    return true;
+}
+
+// Parses "P5|P6 <ws> width <ws> height <ws> maxval <single ws>", with # comments.
+static bool parse_pnm_header(const uint8_t* p, size_t size, int& channels, int& width, int& height, size_t& offset)
+{
+    if (size < 2 || p[0] != 'P' || (p[1] != '5' && p[1] != '6'))
+    {
+        return false;
+    }
+    channels = p[1] == '5' ? 1 : 3;
+    size_t i = 2;
+    int fields[3];
+    for (int f = 0; f < 3; f++)
+    {
+        for (;;)
+        {
+            while (i < size && isspace(p[i]))
+            {
+                i++;
+            }
+            if (i < size && p[i] == '#')
+            {
+                while (i < size && p[i] != '\n')
+                {
+                    i++;
+                }
+                continue;
+            }
+            break;
+        }
+        if (i >= size || !isdigit(p[i]))
+        {
+            return false;
+        }
+        long v = 0;
+        while (i < size && isdigit(p[i]))
+        {
+            v = v * 10 + (p[i] - '0');
+            if (v > (1 << 30))
+            {
+                return false;
+            }
+            i++;
+        }
+        fields[f] = (int)v;
+    }
+    if (i >= size || !isspace(p[i]))
+    {
+        return false;
+    }
+    width = fields[0];
+    height = fields[1];
+    offset = i + 1;
+    return fields[2] > 0 && fields[2] <= 255 && width > 0 && height > 0;
+}
+
+bool MappedImage::open_pnm(const std::string& path)
+{
+    if (!map(path, 0))
+    {
+        return false;
+    }
+    int channels;
+    int width;
+    int height;
+    size_t offset;
+    if (!parse_pnm_header(base_, size_, channels, width, height, offset))
+    {
+        return fail(path, "not a binary 8-bit PGM/PPM file");
+    }
+    const size_t step = (size_t)width * channels;
+    if (size_ - offset < step * height)
+    {
+        return fail(path, "truncated pixel data");
+    }
+    ImageView& v = planes_[0];
+    v.data = base_ + offset;
+    v.step = step;
+    v.width = width;
+    v.height = height;
+    v.channels = channels;
+    plane_count_ = 1;
+    frame_count_ = 1;
+    return true;
+}
+
+bool MappedImage::open_raw(const std::string& path, int width, int height, int channels, int frame)
+{
+    if (width <= 0 || height <= 0 || channels <= 0 || frame < 0)
+    {
+        error_ = path + ": bad raw image geometry";
+        return false;
+    }
+    if (!map(path, 0))
+    {
+        return false;
+    }
+    const size_t step = (size_t)width * channels;
+    const size_t frame_size = step * height;
+    frame_count_ = (int)(size_ / frame_size);
+    if (frame >= frame_count_)
+    {
+        return fail(path, "frame " + std::to_string(frame) + " is out of range");
+    }
+    ImageView& v = planes_[0];
+    v.data = base_ + frame_size * frame;
+    v.step = step;
+    v.width = width;
+    v.height = height;
+    v.channels = channels;
+    plane_count_ = 1;
+    return true;
+}
+
+bool MappedImage::open_nv21(const std::string& path, int width, int height, int frame)
+{
+    if (width <= 0 || height <= 0 || (width & 1) || (height & 1) || frame < 0)
+    {
+        error_ = path + ": bad NV21 geometry";
+        return false;
+    }
+    if (!map(path, 0))
+    {
+        return false;
+    }
+    const size_t y_size = (size_t)width * height;
+    const size_t frame_size = y_size + y_size / 2;
+    frame_count_ = (int)(size_ / frame_size);
+    if (frame >= frame_count_)
+    {
+        return fail(path, "frame " + std::to_string(frame) + " is out of range");
+    }
+    uint8_t* p = base_ + frame_size * frame;
+    planes_[0].data = p;
+    planes_[0].step = width;
+    planes_[0].width = width;
+    planes_[0].height = height;
+    planes_[0].channels = 1;
+    planes_[1].data = p + y_size;
+    planes_[1].step = width;
+    planes_[1].width = width / 2;
+    planes_[1].height = height / 2;
+    planes_[1].channels = 2;
+    plane_count_ = 2;
+    return true;
+}
+
+// "P5\n# ...padding...\nW H\n255\n", exactly PNM_DATA_ALIGN bytes long when it fits
+static std::string pnm_header(int width, int height, int channels)
+{
+    const std::string tail = "\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    const std::string magic = channels == 1 ? "P5" : "P6";
+    std::string header = magic + tail;
+    const size_t comment_min = 3; // "\n# "
+    if (header.size() + comment_min <= PNM_DATA_ALIGN)
+    {
+        header = magic + "\n#" + std::string(PNM_DATA_ALIGN - magic.size() - 2 - tail.size(), ' ') + tail;
+    }
+    return header;
+}
+
+bool MappedImage::create_pnm(const std::string& path, int width, int height, int channels)
+{
+    if (width <= 0 || height <= 0 || (channels != 1 && channels != 3))
+    {
+        error_ = path + ": PNM needs 1 or 3 channels and a positive size";
+        return false;
+    }
+    const std::string header = pnm_header(width, height, channels);
+    const size_t step = (size_t)width * channels;
+    if (!map(path, header.size() + step * height))
+    {
+        return false;
+    }
+    memcpy(base_, header.data(), header.size());
+    ImageView& v = planes_[0];
+    v.data = base_ + header.size();
+    v.step = step;
+    v.width = width;
+    v.height = height;
+    v.channels = channels;
+    plane_count_ = 1;
+    frame_count_ = 1;
+    return true;
+}
+
+ImageView aligned(const ImageView& src, size_t alignment, AlignedImage& tmp)
+{
+    const size_t row_bytes = (size_t)src.width * src.channels;
+    if (((uintptr_t)src.data & (alignment - 1)) == 0 && (src.step & (alignment - 1)) == 0)
+    {
+        return src;
+    }
+    const size_t step = (row_bytes + alignment - 1) & ~(alignment - 1);
+    tmp.storage.resize(step * src.height + alignment);
+    uint8_t* base = tmp.storage.data();
+    base += (alignment - ((uintptr_t)base & (alignment - 1))) & (alignment - 1);
+    for (int y = 0; y < src.height; y++)
+    {
+        memcpy(base + y * step, src.row(y), row_bytes);
+    }
+    tmp.view = src;
+    tmp.view.data = base;
+    tmp.view.step = step;
+    return tmp.view;
+}
+
+static bool write_rows(FILE* fp, const ImageView& img)
+{
+    const size_t row_bytes = (size_t)img.width * img.channels;
+    for (int y = 0; y < img.height; y++)
+    {
+        if (fwrite(img.row(y), 1, row_bytes, fp) != row_bytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool save_pnm(const std::string& path, const ImageView& img)
+{
+    if (img.empty() || (img.channels != 1 && img.channels != 3))
+    {
+        return false;
+    }
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp)
+    {
+        return false;
+    }
+    const std::string header = pnm_header(img.width, img.height, img.channels);
+    bool ok = fwrite(header.data(), 1, header.size(), fp) == header.size() && write_rows(fp, img);
+    ok = (fclose(fp) == 0) && ok;
+    return ok;
+}
+
+bool save_raw(const std::string& path, const ImageView& img)
+{
+    if (img.empty())
+    {
+        return false;
+    }
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp)
+    {
+        return false;
+    }
+    bool ok = write_rows(fp, img);
+    ok = (fclose(fp) == 0) && ok;
+    return ok;
+}
+
+} // namespace neon_sim_kernels
@@ -0,0 +1,164 @@
+#pragma once
+
+//
+// Zero-dependency image I/O for benchmarks and dataset runs: binary PGM (P5),
+// PPM (P6), raw 8-bit planes and raw NV21 frames are memory-mapped and handed
+// to kernels as strided views, without decoding or copying.
+//
+// usage:
+// #include "neon_sim_image_io.hpp"
+//
+// neon_sim_kernels::MappedImage img;
+// if (!img.open_pnm("frame.ppm")) { fprintf(stderr, "%s\n", img.error().c_str()); return 1; }
+// const neon_sim_kernels::ImageView& rgb = img.view();
+// neon_sim_kernels::rgb2gray(rgb.data, rgb.step, gray, gray_step, rgb.width, rgb.height);
+//
+// Files opened for reading are mapped read only, so view() and plane() hand
+// out const pixels. Only create_pnm() maps writable; mutable_view() gives
+// write access to that image.
+//
+// The mapping is page aligned, so raw files are aligned views as they are.
+// PNM pixel data starts after a text header; save_pnm() and create_pnm() pad
+// that header with a comment so the pixels start at a 64 byte offset, which
+// makes the files they write aligned views too. aligned() copies only when a
+// view does not meet the requested alignment.
+//
+// On platforms without mmap the file is read into a page aligned heap buffer.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace neon_sim_kernels {
+
+/// @brief strided 8-bit image; T is const uint8_t for read-only pixels
+template<typename T>
+struct BasicImageView
+{
+    T* data = NULL;
+    size_t step = 0;  // row stride in bytes
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    BasicImageView()
+    {
+    }
+
+    /// @brief a writable view converts to a read-only one, not the other way round
+    template<typename U>
+    BasicImageView(const BasicImageView<U>& other)
+        : data(other.data), step(other.step), width(other.width), height(other.height), channels(other.channels)
+    {
+    }
+
+    T* row(int y) const
+    {
+        return data + y * step;
+    }
+
+    bool empty() const
+    {
+        return data == NULL;
+    }
+};
+
+typedef BasicImageView<const uint8_t> ImageView;
+typedef BasicImageView<uint8_t> MutableImageView;
+
+class MappedImage
+{
+public:
+    MappedImage();
+    ~MappedImage();
+    MappedImage(MappedImage&& other);
+    MappedImage& operator=(MappedImage&& other);
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    /// @brief map a binary PGM (P5, 1 channel) or PPM (P6, 3 channels) file with maxval <= 255, read only
+    bool open_pnm(const std::string& path);
+
+    /// @brief map frame `frame` of a raw file holding height rows of width * channels bytes per frame
+    bool open_raw(const std::string& path, int width, int height, int channels = 1, int frame = 0);
+
+    /// @brief map frame `frame` of a raw NV21 file: a width x height Y plane followed by a
+    /// width/2 x height/2 interleaved VU plane. width and height must be even.
+    bool open_nv21(const std::string& path, int width, int height, int frame = 0);
+
+    /// @brief create (or truncate) a PGM/PPM file of the given size and map it writable
+    /// The pixels are written to disk when the image is closed or destroyed.
+    bool create_pnm(const std::string& path, int width, int height, int channels);
+
+    void close();
+
+    /// @brief the image, or the Y plane for NV21
+    const ImageView& view() const
+    {
+        return planes_[0];
+    }
+
+    /// @brief plane 0 is Y, plane 1 is VU (2 channels) for NV21; other formats have one plane
+    const ImageView& plane(int i) const
+    {
+        return planes_[i];
+    }
+
+    /// @brief write access to the image of create_pnm(); empty for read-only mappings
+    MutableImageView mutable_view() const;
+
+    int plane_count() const
+    {
+        return plane_count_;
+    }
+
+    /// @brief number of whole frames in a raw / NV21 file, 1 for PNM
+    int frame_count() const
+    {
+        return frame_count_;
+    }
+
+    bool writable() const
+    {
+        return writable_;
+    }
+
+    const std::string& error() const
+    {
+        return error_;
+    }
+
+private:
+    bool map(const std::string& path, size_t create_size);
+    bool fail(const std::string& path, const std::string& what);
+
+    uint8_t* base_ = NULL;
+    size_t size_ = 0;
+    bool writable_ = false;
+    std::string path_;     // without mmap, writable buffers are written back here on close()
+    ImageView planes_[2];
+    int plane_count_ = 0;
+    int frame_count_ = 0;
+    std::string error_;
+};
+
+/// @brief owning, row-padded image with aligned rows
+struct AlignedImage
+{
+    ImageView view;
+    std::vector<uint8_t> storage;
+};
+
+/// @brief return `src` itself when data and step are multiples of `alignment`, otherwise
+/// copy it into `tmp` with aligned rows and return that. alignment must be a power of two.
+ImageView aligned(const ImageView& src, size_t alignment, AlignedImage& tmp);
+
+/// @brief write a 1 channel view as PGM (P5) or a 3 channel view as PPM (P6)
+bool save_pnm(const std::string& path, const ImageView& img);
+
+/// @brief write the rows of a view back to back, without header
+bool save_raw(const std::string& path, const ImageView& img);
+
+} // namespace neon_sim_kernels
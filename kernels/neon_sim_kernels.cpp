@@ -0,0 +1,359 @@
+#include "neon_sim_kernels.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <algorithm>
+
+namespace neon_sim_kernels {
+
+// 定点版本的权值
+static const uint8_t R2Y = 77;
+static const uint8_t G2Y = 151;
+static const uint8_t B2Y = 28;
+static const int GRAY_SHIFT = 8;
+
+static inline const uint8_t* row_ptr(const uint8_t* base, size_t step, int y)
+{
+    return base + y * step;
+}
+
+static inline uint8_t* row_ptr(uint8_t* base, size_t step, int y)
+{
+    return base + y * step;
+}
+
+// round(x / 255) for x in [0, 255 * 255], exact
+static inline uint8_t div255(uint32_t x)
+{
+    return (uint8_t)((x + ((x + 128) >> 8) + 128) >> 8);
+}
+
+void rgb2gray(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    uint8x8_t v_r2y = vdup_n_u8(R2Y);
+    uint8x8_t v_g2y = vdup_n_u8(G2Y);
+    uint8x8_t v_b2y = vdup_n_u8(B2Y);
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint8x8x3_t v_src = vld3_u8(sp);
+            uint16x8_t v_tmp = vmull_u8(v_src.val[0], v_r2y);
+            v_tmp = vmlal_u8(v_tmp, v_src.val[1], v_g2y);
+            v_tmp = vmlal_u8(v_tmp, v_src.val[2], v_b2y);
+            vst1_u8(dp, vshrn_n_u16(v_tmp, GRAY_SHIFT));
+            sp += 8 * 3;
+            dp += 8;
+        }
+        for (; x < width; x++)
+        {
+            *dp++ = (R2Y * sp[0] + G2Y * sp[1] + B2Y * sp[2]) >> GRAY_SHIFT;
+            sp += 3;
+        }
+    }
+}
+
+void rgb2bgr(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint8x8x3_t v_pixel = vld3_u8(sp);
+            uint8x8_t tmp = v_pixel.val[0];
+            v_pixel.val[0] = v_pixel.val[2];
+            v_pixel.val[2] = tmp;
+            vst3_u8(dp, v_pixel);
+            sp += 24;
+            dp += 24;
+        }
+        for (; x < width; x++)
+        {
+            // read the whole pixel first, so that src == dst works
+            const uint8_t c0 = sp[0];
+            const uint8_t c2 = sp[2];
+            dp[0] = c2;
+            dp[1] = sp[1];
+            dp[2] = c0;
+            sp += 3;
+            dp += 3;
+        }
+    }
+}
+
+void threshold(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+               uint8_t thresh, uint8_t minval, uint8_t maxval)
+{
+    if (minval > maxval)
+    {
+        std::swap(minval, maxval);
+    }
+
+    uint8x16_t vthresh = vdupq_n_u8(thresh);
+    uint8x16_t vmaxval = vdupq_n_u8(maxval);
+    uint8x16_t vminval = vdupq_n_u8(minval);
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t v1 = vld1q_u8(sp);
+            uint8x16_t vmask_gt = vcgtq_u8(v1, vthresh);
+            vst1q_u8(dp, vbslq_u8(vmask_gt, vmaxval, vminval));
+            sp += 16;
+            dp += 16;
+        }
+        for (; x < width; x++)
+        {
+            *dp++ = (*sp++ > thresh) ? maxval : minval;
+        }
+    }
+}
+
+// 8x8 u8 方阵转置: vtrn_u8 -> vtrn_u16 -> vtrn_u32
+static inline void transpose_8x8(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step)
+{
+    uint8x8_t d0 = vld1_u8(src + 0 * src_step);
+    uint8x8_t d1 = vld1_u8(src + 1 * src_step);
+    uint8x8_t d2 = vld1_u8(src + 2 * src_step);
+    uint8x8_t d3 = vld1_u8(src + 3 * src_step);
+    uint8x8_t d4 = vld1_u8(src + 4 * src_step);
+    uint8x8_t d5 = vld1_u8(src + 5 * src_step);
+    uint8x8_t d6 = vld1_u8(src + 6 * src_step);
+    uint8x8_t d7 = vld1_u8(src + 7 * src_step);
+
+    // phase1
+    uint8x8x2_t d01 = vtrn_u8(d0, d1);
+    uint8x8x2_t d23 = vtrn_u8(d2, d3);
+    uint8x8x2_t d45 = vtrn_u8(d4, d5);
+    uint8x8x2_t d67 = vtrn_u8(d6, d7);
+
+    // phase2
+    uint16x4x2_t v02 = vtrn_u16(vreinterpret_u16_u8(d01.val[0]), vreinterpret_u16_u8(d23.val[0]));
+    uint16x4x2_t v13 = vtrn_u16(vreinterpret_u16_u8(d01.val[1]), vreinterpret_u16_u8(d23.val[1]));
+    uint16x4x2_t v46 = vtrn_u16(vreinterpret_u16_u8(d45.val[0]), vreinterpret_u16_u8(d67.val[0]));
+    uint16x4x2_t v57 = vtrn_u16(vreinterpret_u16_u8(d45.val[1]), vreinterpret_u16_u8(d67.val[1]));
+
+    // phase3
+    uint32x2x2_t w04 = vtrn_u32(vreinterpret_u32_u16(v02.val[0]), vreinterpret_u32_u16(v46.val[0]));
+    uint32x2x2_t w15 = vtrn_u32(vreinterpret_u32_u16(v13.val[0]), vreinterpret_u32_u16(v57.val[0]));
+    uint32x2x2_t w26 = vtrn_u32(vreinterpret_u32_u16(v02.val[1]), vreinterpret_u32_u16(v46.val[1]));
+    uint32x2x2_t w37 = vtrn_u32(vreinterpret_u32_u16(v13.val[1]), vreinterpret_u32_u16(v57.val[1]));
+
+    vst1_u8(dst + 0 * dst_step, vreinterpret_u8_u32(w04.val[0]));
+    vst1_u8(dst + 1 * dst_step, vreinterpret_u8_u32(w15.val[0]));
+    vst1_u8(dst + 2 * dst_step, vreinterpret_u8_u32(w26.val[0]));
+    vst1_u8(dst + 3 * dst_step, vreinterpret_u8_u32(w37.val[0]));
+    vst1_u8(dst + 4 * dst_step, vreinterpret_u8_u32(w04.val[1]));
+    vst1_u8(dst + 5 * dst_step, vreinterpret_u8_u32(w15.val[1]));
+    vst1_u8(dst + 6 * dst_step, vreinterpret_u8_u32(w26.val[1]));
+    vst1_u8(dst + 7 * dst_step, vreinterpret_u8_u32(w37.val[1]));
+}
+
+void transpose(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    int y = 0;
+    for (; y + 8 <= height; y += 8)
+    {
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            transpose_8x8(src + y * src_step + x, src_step, dst + x * dst_step + y, dst_step);
+        }
+        for (; x < width; x++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                dst[x * dst_step + y + k] = src[(y + k) * src_step + x];
+            }
+        }
+    }
+    for (; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            dst[x * dst_step + y] = src[y * src_step + x];
+        }
+    }
+}
+
+void alpha_blend(const uint8_t* fg, size_t fg_step, const uint8_t* bg, size_t bg_step,
+                 const uint8_t* alpha, size_t alpha_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    uint8x8_t v_255 = vdup_n_u8(255);
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* fp = row_ptr(fg, fg_step, y);
+        const uint8_t* bp = row_ptr(bg, bg_step, y);
+        const uint8_t* ap = row_ptr(alpha, alpha_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint8x8_t va = vld1_u8(ap + x);
+            uint16x8_t v_sum = vmull_u8(vld1_u8(fp + x), va);
+            v_sum = vmlal_u8(v_sum, vld1_u8(bp + x), vsub_u8(v_255, va));
+            // (x + ((x + 128) >> 8) + 128) >> 8 == round(x / 255)
+            v_sum = vaddq_u16(v_sum, vrshrq_n_u16(v_sum, 8));
+            vst1_u8(dp + x, vrshrn_n_u16(v_sum, 8));
+        }
+        for (; x < width; x++)
+        {
+            dp[x] = div255(ap[x] * fp[x] + (255 - ap[x]) * bp[x]);
+        }
+    }
+}
+
+void lut(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+         const uint8_t* table)
+{
+    // 256 个表项拆成 8 段, 每段 32 个: vtbl4 查第一段, vtbx4 依次查后面的段
+    // 索引每次减 32, 已经查过的元素下溢到 >= 224, vtbx4 不会改动它们
+    uint8x8x4_t v_table[8];
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            v_table[i].val[j] = vld1_u8(table + i * 32 + j * 8);
+        }
+    }
+    uint8x8_t v_32 = vdup_n_u8(32);
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            uint8x8_t v_idx = vld1_u8(sp + x);
+            uint8x8_t v_res = vtbl4_u8(v_table[0], v_idx);
+            for (int i = 1; i < 8; i++)
+            {
+                v_idx = vsub_u8(v_idx, v_32);
+                v_res = vtbx4_u8(v_res, v_table[i], v_idx);
+            }
+            vst1_u8(dp + x, v_res);
+        }
+        for (; x < width; x++)
+        {
+            dp[x] = table[sp[x]];
+        }
+    }
+}
+
+namespace ref {
+
+void rgb2gray(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+        for (int x = 0; x < width; x++)
+        {
+            dp[x] = (R2Y * sp[3 * x] + G2Y * sp[3 * x + 1] + B2Y * sp[3 * x + 2]) >> GRAY_SHIFT;
+        }
+    }
+}
+
+void rgb2bgr(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+        for (int x = 0; x < width; x++)
+        {
+            const uint8_t c0 = sp[3 * x];
+            const uint8_t c1 = sp[3 * x + 1];
+            const uint8_t c2 = sp[3 * x + 2];
+            dp[3 * x] = c2;
+            dp[3 * x + 1] = c1;
+            dp[3 * x + 2] = c0;
+        }
+    }
+}
+
+void threshold(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+               uint8_t thresh, uint8_t minval, uint8_t maxval)
+{
+    if (minval > maxval)
+    {
+        std::swap(minval, maxval);
+    }
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+        for (int x = 0; x < width; x++)
+        {
+            dp[x] = (sp[x] > thresh) ? maxval : minval;
+        }
+    }
+}
+
+void transpose(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            dst[x * dst_step + y] = src[y * src_step + x];
+        }
+    }
+}
+
+void alpha_blend(const uint8_t* fg, size_t fg_step, const uint8_t* bg, size_t bg_step,
+                 const uint8_t* alpha, size_t alpha_step, uint8_t* dst, size_t dst_step, int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* fp = row_ptr(fg, fg_step, y);
+        const uint8_t* bp = row_ptr(bg, bg_step, y);
+        const uint8_t* ap = row_ptr(alpha, alpha_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+        for (int x = 0; x < width; x++)
+        {
+            dp[x] = div255(ap[x] * fp[x] + (255 - ap[x]) * bp[x]);
+        }
+    }
+}
+
+void lut(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+         const uint8_t* table)
+{
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* sp = row_ptr(src, src_step, y);
+        uint8_t* dp = row_ptr(dst, dst_step, y);
+        for (int x = 0; x < width; x++)
+        {
+            dp[x] = table[sp[x]];
+        }
+    }
+}
+
+} // namespace ref
+
+} // namespace neon_sim_kernels
@@ -0,0 +1,58 @@
+#pragma once
+
+//
+// Reusable image kernels written with NEON intrinsics, promoted from the
+// OpenCV-based experiments in legacy/tests.
+//
+// Every kernel works on plain strided buffers: `*_step` is the row stride in
+// bytes, so sub-images and padded rows work without copies. Each kernel has a
+// scalar twin in `neon_sim_kernels::ref` that produces bit-exact identical
+// output and serves as the reference in tests and benchmarks.
+//
+// On x86 the kernels are compiled against arm_neon_sim.hpp. The library does
+// not define NEON_SIM_IMPLEMENTATION; the executable that links it must do so
+// in exactly one translation unit.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace neon_sim_kernels {
+
+/// @brief RGB (3 channels, interleaved) to gray: (77 * R + 151 * G + 28 * B) >> 8
+void rgb2gray(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+
+/// @brief swap channel 0 and channel 2 of an interleaved 3 channel image
+void rgb2bgr(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+
+/// @brief dst = (src > thresh) ? maxval : minval; minval and maxval are swapped when minval > maxval
+void threshold(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+               uint8_t thresh, uint8_t minval, uint8_t maxval);
+
+/// @brief dst(x, y) = src(y, x). src is height x width, dst is width x height
+void transpose(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+
+/// @brief dst = round((alpha * fg + (255 - alpha) * bg) / 255), element-wise
+/// For interleaved images pass width * channels and an alpha plane of the same layout.
+void alpha_blend(const uint8_t* fg, size_t fg_step, const uint8_t* bg, size_t bg_step,
+                 const uint8_t* alpha, size_t alpha_step, uint8_t* dst, size_t dst_step, int width, int height);
+
+/// @brief dst = lut[src], lut has 256 entries
+void lut(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+         const uint8_t* table);
+
+namespace ref {
+
+void rgb2gray(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+void rgb2bgr(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+void threshold(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+               uint8_t thresh, uint8_t minval, uint8_t maxval);
+void transpose(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height);
+void alpha_blend(const uint8_t* fg, size_t fg_step, const uint8_t* bg, size_t bg_step,
+                 const uint8_t* alpha, size_t alpha_step, uint8_t* dst, size_t dst_step, int width, int height);
+void lut(const uint8_t* src, size_t src_step, uint8_t* dst, size_t dst_step, int width, int height,
+         const uint8_t* table);
+
+} // namespace ref
+
+} // namespace neon_sim_kernels
@@ -0,0 +1,421 @@
+#include "neon_sim_math.hpp"
+
+#include <math.h>
+#include <string.h>
+
+namespace neon_sim_kernels {
+namespace math {
+
+namespace {
+
+// a + b * c and a - b * c, with one rounding where the target has it
+inline float32x4_t mla(float32x4_t a, float32x4_t b, float32x4_t c)
+{
+#if __aarch64__ || defined(__ARM_FEATURE_FMA)
+    return vfmaq_f32(a, b, c);
+#else
+    return vmlaq_f32(a, b, c);
+#endif
+}
+
+inline float32x4_t mls(float32x4_t a, float32x4_t b, float32x4_t c)
+{
+#if __aarch64__ || defined(__ARM_FEATURE_FMA)
+    return vfmsq_f32(a, b, c);
+#else
+    return vmlsq_f32(a, b, c);
+#endif
+}
+
+inline float32x4_t divq(float32x4_t a, float32x4_t b)
+{
+#if __aarch64__
+    return vdivq_f32(a, b);
+#else
+    float32x4_t r = vrecpeq_f32(b);
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    return vmulq_f32(a, r);
+#endif
+}
+
+inline bool any(uint32x4_t m)
+{
+#if __aarch64__
+    return vmaxvq_u32(m) != 0;
+#else
+    const uint32x2_t t = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+    return (vget_lane_u32(t, 0) | vget_lane_u32(t, 1)) != 0;
+#endif
+}
+
+// the magnitude of a with the sign of b
+inline float32x4_t copysignq(float32x4_t a, float32x4_t b)
+{
+    const uint32x4_t sign = vdupq_n_u32(0x80000000u);
+    return vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(a), vmvnq_u32(sign)),
+                                           vandq_u32(vreinterpretq_u32_f32(b), sign)));
+}
+
+// Adding 1.5 * 2^23 rounds a float below 2^22 in magnitude to an integer and
+// leaves that integer in the low mantissa bits of the sum.
+const float kShift = 12582912.0f;
+const int32_t kShiftBits = 0x4b400000;
+
+// c[0] + v * (c[1] + v * (... + v * c[n - 1]))
+template <size_t N>
+inline float32x4_t horner(float32x4_t v, const float (&c)[N])
+{
+    float32x4_t p = vdupq_n_f32(c[N - 1]);
+    for (size_t i = N - 1; i-- > 0;)
+    {
+        p = mla(vdupq_n_f32(c[i]), p, v);
+    }
+    return p;
+}
+
+// y * 2^n for integer n in [-252, 254], 2^n as two factors that are each normal
+inline float32x4_t scale(float32x4_t y, int32x4_t n)
+{
+    const int32x4_t n1 = vshrq_n_s32(n, 1);
+    const int32x4_t n2 = vsubq_s32(n, n1);
+    const float32x4_t s1 = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n1, vdupq_n_s32(127)), 23));
+    const float32x4_t s2 = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n2, vdupq_n_s32(127)), 23));
+    return vmulq_f32(vmulq_f32(y, s1), s2);
+}
+
+// lanes of `mask` recomputed by the scalar f
+inline float32x4_t scalar_lanes(float32x4_t r, float32x4_t x, uint32x4_t mask, float (*f)(float))
+{
+    float in[4], out[4];
+    uint32_t m[4];
+    vst1q_f32(in, x);
+    vst1q_f32(out, r);
+    vst1q_u32(m, mask);
+    for (int i = 0; i < 4; i++)
+    {
+        if (m[i])
+        {
+            out[i] = f(in[i]);
+        }
+    }
+    return vld1q_f32(out);
+}
+
+// exp(r) - 1 - r over |r| <= ln2 / 2, divided by r^2 (Cephes expf)
+const float kExpPoly[] = { 5.0000001201e-1f, 1.6666665459e-1f, 4.1665795894e-2f,
+                           8.3334519073e-3f, 1.3981999507e-3f, 1.9875691500e-4f };
+
+// (log(1 + r) - r + r^2 / 2) / r^3 over sqrt(1/2) - 1 <= r < sqrt(2) - 1 (Cephes logf)
+const float kLogPoly[] = { 3.3333331174e-1f, -2.4999993993e-1f, 2.0000714765e-1f,
+                           -1.6668057665e-1f, 1.4249322787e-1f, -1.2420140846e-1f,
+                           1.1676998740e-1f, -1.1514610310e-1f, 7.0376836292e-2f };
+
+// (sin(r) - r) / r^3 and (cos(r) - 1 + r^2 / 2) / r^4 in r^2, |r| <= pi / 4 (Cephes sinf, cosf)
+const float kSinPoly[] = { -1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f };
+const float kCosPoly[] = { 4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f };
+
+// (tanh(x) - x) / x^3 in x^2, |x| < 0.625 (Cephes tanhf)
+const float kTanhPoly[] = { -3.33332819422e-1f, 1.33314422036e-1f, -5.37397155531e-2f,
+                            2.06390887954e-2f, -5.70498872745e-3f };
+
+// erf(x) / x - 1 in x^2, |x| < 1; Chebyshev interpolant of degree 7. The -1
+// keeps 2 / sqrt(pi) from costing a rounding of its own
+const float kErfPoly[] = { 0.128379166f, -0.376126379f, 0.112837821f, -0.0268654302f,
+                           0.00522103161f, -0.000848408032f, 0.000112659589f, -9.66704465e-06f };
+
+// erfc(a) * exp(a^2) in a - 2.5, 1 <= a <= 4; Chebyshev interpolant of degree 11
+const float kErfcPoly[] = { 0.210806355f, -0.074347347f, 0.0249381997f, -0.00800161716f,
+                            0.00246599969f, -0.000733344874f, 0.000212950472f, -5.93273035e-05f,
+                            1.43646821e-05f, -3.83463203e-06f, 1.66983671e-06f, -4.12314279e-07f };
+
+// sin(x) and cos(x) need the Cody-Waite reduction below to lose no more than
+// a few bits; beyond this the lane goes to libm
+const float kTrigLimit = 131072.0f;
+
+float32x4_t sincosq(float32x4_t x, bool cos)
+{
+    // x = n * pi/2 + r, pi/2 in three parts whose products with n are exact
+    const float32x4_t shift = vdupq_n_f32(kShift);
+    const float32x4_t z = mla(shift, x, vdupq_n_f32(0.636619772f));
+    const float32x4_t n = vsubq_f32(z, shift);
+    float32x4_t r = mls(x, n, vdupq_n_f32(1.57079625129699707031f));
+    r = mls(r, n, vdupq_n_f32(7.54978941586159635335e-08f));
+    r = mls(r, n, vdupq_n_f32(5.39030252995776476554e-15f));
+
+    // cos(x) = sin(x + pi/2): one quadrant on
+    int32x4_t q = vsubq_s32(vreinterpretq_s32_f32(z), vdupq_n_s32(kShiftBits));
+    if (cos)
+    {
+        q = vaddq_s32(q, vdupq_n_s32(1));
+    }
+    const float32x4_t r2 = vmulq_f32(r, r);
+    const float32x4_t s = mla(r, vmulq_f32(r, r2), horner(r2, kSinPoly));
+    const float32x4_t c = mla(mls(vdupq_n_f32(1.0f), r2, vdupq_n_f32(0.5f)), vmulq_f32(r2, r2), horner(r2, kCosPoly));
+
+    // odd quadrants take the cosine, quadrants 2 and 3 flip the sign
+    const uint32x4_t odd = vreinterpretq_u32_s32(vshrq_n_s32(vshlq_n_s32(q, 31), 31));
+    const uint32x4_t sign = vshlq_n_u32(vandq_u32(vreinterpretq_u32_s32(q), vdupq_n_u32(2)), 30);
+    float32x4_t y = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(odd, c, s)), sign));
+    if (!cos)
+    {
+        // r + r^3 * P(r^2) is +0 for r = -0
+        y = vbslq_f32(vceqq_f32(x, vdupq_n_f32(0.0f)), x, y);
+    }
+
+    const uint32x4_t large = vcgeq_f32(vabsq_f32(x), vdupq_n_f32(kTrigLimit));
+    if (any(large))
+    {
+        return scalar_lanes(y, x, large, cos ? ::cosf : ::sinf);
+    }
+    return y;
+}
+
+float sigmoidf(float x)
+{
+    return 1.0f / (1.0f + expf(-x));
+}
+
+double sigmoid(double x)
+{
+    return 1.0 / (1.0 + exp(-x));
+}
+
+template <float32x4_t (*F)(float32x4_t)>
+void apply(const float* src, float* dst, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(dst + i, F(vld1q_f32(src + i)));
+    }
+    if (i < n)
+    {
+        float tail[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        memcpy(tail, src + i, (n - i) * sizeof(float));
+        vst1q_f32(tail, F(vld1q_f32(tail)));
+        memcpy(dst + i, tail, (n - i) * sizeof(float));
+    }
+}
+
+} // namespace
+
+float32x4_t expq_f32(float32x4_t x)
+{
+    // outside [-104, 89] the result is 0 or inf anyway; x goes second so a
+    // NaN passes the clamp
+    x = vminq_f32(vdupq_n_f32(89.0f), vmaxq_f32(vdupq_n_f32(-104.0f), x));
+
+    // x = n * ln2 + r, ln2 in two parts; n * 0.693145751953125 is exact
+    const float32x4_t shift = vdupq_n_f32(kShift);
+    const float32x4_t z = mla(shift, x, vdupq_n_f32(1.44269504f));
+    const float32x4_t n = vsubq_f32(z, shift);
+    float32x4_t r = mls(x, n, vdupq_n_f32(0.693145751953125f));
+    r = mls(r, n, vdupq_n_f32(1.42860676533018704e-06f));
+
+    const float32x4_t r2 = vmulq_f32(r, r);
+    const float32x4_t y = vaddq_f32(vdupq_n_f32(1.0f), mla(r, r2, horner(r, kExpPoly)));
+    return scale(y, vsubq_s32(vreinterpretq_s32_f32(z), vdupq_n_s32(kShiftBits)));
+}
+
+float32x4_t logq_f32(float32x4_t x)
+{
+    // subnormals are scaled by 2^23 first, the exponent takes it back
+    const uint32x4_t tiny = vcltq_f32(x, vdupq_n_f32(1.17549435e-38f));
+    const float32x4_t xs = vbslq_f32(tiny, vmulq_f32(x, vdupq_n_f32(8388608.0f)), x);
+
+    // x = 2^e * m, sqrt(1/2) <= m < sqrt(2)
+    const int32_t kSqrtHalf = 0x3f3504f3;
+    const int32x4_t ix = vsubq_s32(vreinterpretq_s32_f32(xs), vdupq_n_s32(kSqrtHalf));
+    int32x4_t ie = vshrq_n_s32(ix, 23);
+    ie = vsubq_s32(ie, vandq_s32(vreinterpretq_s32_u32(tiny), vdupq_n_s32(23)));
+    const float32x4_t e = vcvtq_f32_s32(ie);
+    const float32x4_t m = vreinterpretq_f32_s32(vaddq_s32(vandq_s32(ix, vdupq_n_s32(0x007fffff)), vdupq_n_s32(kSqrtHalf)));
+
+    // log(x) = e * ln2 + log1p(r); ln2 = 0.693359375 - 2.12194440e-4
+    const float32x4_t r = vsubq_f32(m, vdupq_n_f32(1.0f));
+    const float32x4_t r2 = vmulq_f32(r, r);
+    float32x4_t y = vmulq_f32(vmulq_f32(horner(r, kLogPoly), r), r2);
+    y = mla(y, e, vdupq_n_f32(-2.12194440e-4f));
+    y = mls(y, r2, vdupq_n_f32(0.5f));
+    y = mla(vaddq_f32(r, y), e, vdupq_n_f32(0.693359375f));
+
+    // 0 < x < inf above; log(+inf) = inf, log(NaN) = NaN, log(+-0) = -inf, log(x < 0) = NaN
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t inf = vdupq_n_f32(INFINITY);
+    const uint32x4_t finite_positive = vandq_u32(vcgtq_f32(x, zero), vcltq_f32(x, inf));
+    float32x4_t special = vbslq_f32(vcltq_f32(x, zero), vdupq_n_f32(NAN), x);
+    special = vbslq_f32(vceqq_f32(x, zero), vdupq_n_f32(-INFINITY), special);
+    return vbslq_f32(finite_positive, y, special);
+}
+
+float32x4_t sinq_f32(float32x4_t x)
+{
+    return sincosq(x, false);
+}
+
+float32x4_t cosq_f32(float32x4_t x)
+{
+    return sincosq(x, true);
+}
+
+float32x4_t tanhq_f32(float32x4_t x)
+{
+    const float32x4_t a = vabsq_f32(x);
+
+    // |x| < 0.625: a + a^3 * P(a^2)
+    const float32x4_t a2 = vmulq_f32(a, a);
+    const float32x4_t small = mla(a, vmulq_f32(a, a2), horner(a2, kTanhPoly));
+
+    // otherwise (1 - e) / (1 + e), e = exp(-2|x|); 1 from |x| > 9 on, NaN stays NaN
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t e = expq_f32(vmulq_f32(a, vdupq_n_f32(-2.0f)));
+    const float32x4_t large = divq(vsubq_f32(one, e), vaddq_f32(one, e));
+
+    return copysignq(vbslq_f32(vcltq_f32(a, vdupq_n_f32(0.625f)), small, large), x);
+}
+
+float32x4_t sigmoidq_f32(float32x4_t x)
+{
+    // 1 / (1 + e) for x >= 0 and e / (1 + e) below, e = exp(-|x|) <= 1, so
+    // neither overflows and tiny results keep their precision
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t e = expq_f32(vnegq_f32(vabsq_f32(x)));
+    const float32x4_t num = vbslq_f32(vcgeq_f32(x, vdupq_n_f32(0.0f)), one, e);
+    return divq(num, vaddq_f32(one, e));
+}
+
+float32x4_t erfq_f32(float32x4_t x)
+{
+    const float32x4_t a = vabsq_f32(x);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    // |x| < 1: x + x * P(x^2)
+    const float32x4_t small = mla(x, x, horner(vmulq_f32(x, x), kErfPoly));
+    const uint32x4_t ge1 = vcgeq_f32(a, one);
+    if (!any(ge1))
+    {
+        return small;
+    }
+
+    // otherwise 1 - exp(-a^2) * Q(a - 2.5), a clamped to 4 where erf rounds to 1
+    const float32x4_t ac = vminq_f32(vdupq_n_f32(4.0f), a);
+    const float32x4_t q = horner(vsubq_f32(ac, vdupq_n_f32(2.5f)), kErfcPoly);
+    const float32x4_t e = expq_f32(vnegq_f32(vmulq_f32(ac, ac)));
+    const float32x4_t large = copysignq(mls(one, e, q), x);
+    return vbslq_f32(ge1, large, small);
+}
+
+void exp_f32(const float* src, float* dst, size_t n)
+{
+    apply<expq_f32>(src, dst, n);
+}
+
+void log_f32(const float* src, float* dst, size_t n)
+{
+    apply<logq_f32>(src, dst, n);
+}
+
+void sin_f32(const float* src, float* dst, size_t n)
+{
+    apply<sinq_f32>(src, dst, n);
+}
+
+void cos_f32(const float* src, float* dst, size_t n)
+{
+    apply<cosq_f32>(src, dst, n);
+}
+
+void tanh_f32(const float* src, float* dst, size_t n)
+{
+    apply<tanhq_f32>(src, dst, n);
+}
+
+void sigmoid_f32(const float* src, float* dst, size_t n)
+{
+    apply<sigmoidq_f32>(src, dst, n);
+}
+
+void erf_f32(const float* src, float* dst, size_t n)
+{
+    apply<erfq_f32>(src, dst, n);
+}
+
+#if defined(NEON_SIM_MATH_HAS_F16)
+namespace {
+
+template <float32x4_t (*F)(float32x4_t)>
+float16x8_t widen(float16x8_t x)
+{
+    const float32x4_t lo = F(vcvt_f32_f16(vget_low_f16(x)));
+    const float32x4_t hi = F(vcvt_f32_f16(vget_high_f16(x)));
+    return vcombine_f16(vcvt_f16_f32(lo), vcvt_f16_f32(hi));
+}
+
+} // namespace
+
+float16x8_t expq_f16(float16x8_t x)
+{
+    return widen<expq_f32>(x);
+}
+
+float16x8_t logq_f16(float16x8_t x)
+{
+    return widen<logq_f32>(x);
+}
+
+float16x8_t sinq_f16(float16x8_t x)
+{
+    return widen<sinq_f32>(x);
+}
+
+float16x8_t cosq_f16(float16x8_t x)
+{
+    return widen<cosq_f32>(x);
+}
+
+float16x8_t tanhq_f16(float16x8_t x)
+{
+    return widen<tanhq_f32>(x);
+}
+
+float16x8_t sigmoidq_f16(float16x8_t x)
+{
+    return widen<sigmoidq_f32>(x);
+}
+
+float16x8_t erfq_f16(float16x8_t x)
+{
+    return widen<erfq_f32>(x);
+}
+#endif // NEON_SIM_MATH_HAS_F16
+
+const std::vector<Function>& functions()
+{
+    static const std::vector<Function> table = {
+        { "exp", expq_f32, exp_f32, ::exp, ::expf, 1.1 },
+        { "log", logq_f32, log_f32, ::log, ::logf, 1.0 },
+        { "sin", sinq_f32, sin_f32, ::sin, ::sinf, 1.6 },
+        { "cos", cosq_f32, cos_f32, ::cos, ::cosf, 1.6 },
+        { "tanh", tanhq_f32, tanh_f32, ::tanh, ::tanhf, 1.6 },
+        { "sigmoid", sigmoidq_f32, sigmoid_f32, sigmoid, sigmoidf, 2.5 },
+        { "erf", erfq_f32, erf_f32, ::erf, ::erff, 1.1 },
+    };
+    return table;
+}
+
+const Function* find_function(const char* name)
+{
+    const std::vector<Function>& table = functions();
+    for (size_t i = 0; i < table.size(); i++)
+    {
+        if (strcmp(table[i].name, name) == 0)
+        {
+            return &table[i];
+        }
+    }
+    return NULL;
+}
+
+} // namespace math
+} // namespace neon_sim_kernels
@@ -0,0 +1,98 @@
+#pragma once
+
+//
+// Vectorized float math written with NEON intrinsics only, so the same source
+// builds natively on ARM and through arm_neon_sim.hpp on x86.
+//
+// usage:
+// #include "neon_sim_math.hpp"
+//
+// float32x4_t y = neon_sim_kernels::math::expq_f32(x);
+// neon_sim_kernels::math::tanh_f32(src, dst, n);   // any n, no alignment needed
+//
+// Error bounds, in ULP of the exact result over every one of the 2^32 float
+// inputs with round-to-nearest (FPCR.RMode = RN, FZ = 0):
+//
+//   expq_f32      1.1   results below FLT_MIN are subnormal, not flushed
+//   logq_f32      1.0   log(0) = -inf, log(x < 0) = NaN
+//   sinq_f32      1.6   |x| >= 2^17 is handed to the libm sinf of the lane
+//   cosq_f32      1.6   likewise cosf
+//   tanhq_f32     1.6
+//   sigmoidq_f32  2.5   1 / (1 + exp(-x))
+//   erfq_f32      1.1
+//
+// NaN in gives NaN out, infinities give the limits of the function. The
+// bounds are the max_ulp column of functions(); the measured worst cases come
+// from neon_sim_math_accuracy, which sweeps all floats on a thread pool.
+// Where the target has no fused multiply-add (ARMv7 without VFPv4) the
+// polynomials fall back to vmla and the bounds are not guaranteed.
+//
+// float16x8_t forms exist when the compiler has the IEEE half precision
+// format (__ARM_FP16_FORMAT_IEEE, native builds only; the simulator has no
+// half precision registers). They widen to float, evaluate, and narrow, so
+// they are within 1 ULP of half precision.
+//
+
+// __ARM_ARCH comes from the compiler; arm_neon_sim.hpp defines __ARM_NEON
+// itself, so that alone would not tell a second include apart
+#if defined(__ARM_ARCH) && __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <stddef.h>
+#include <vector>
+
+#if __ARM_NEON && defined(__ARM_FP16_FORMAT_IEEE)
+#define NEON_SIM_MATH_HAS_F16 1
+#endif
+
+namespace neon_sim_kernels {
+namespace math {
+
+float32x4_t expq_f32(float32x4_t x);
+float32x4_t logq_f32(float32x4_t x);
+float32x4_t sinq_f32(float32x4_t x);
+float32x4_t cosq_f32(float32x4_t x);
+float32x4_t tanhq_f32(float32x4_t x);
+float32x4_t sigmoidq_f32(float32x4_t x);
+float32x4_t erfq_f32(float32x4_t x);
+
+/// @brief dst[i] = f(src[i]) for i < n; src and dst may be the same array
+void exp_f32(const float* src, float* dst, size_t n);
+void log_f32(const float* src, float* dst, size_t n);
+void sin_f32(const float* src, float* dst, size_t n);
+void cos_f32(const float* src, float* dst, size_t n);
+void tanh_f32(const float* src, float* dst, size_t n);
+void sigmoid_f32(const float* src, float* dst, size_t n);
+void erf_f32(const float* src, float* dst, size_t n);
+
+#if defined(NEON_SIM_MATH_HAS_F16)
+float16x8_t expq_f16(float16x8_t x);
+float16x8_t logq_f16(float16x8_t x);
+float16x8_t sinq_f16(float16x8_t x);
+float16x8_t cosq_f16(float16x8_t x);
+float16x8_t tanhq_f16(float16x8_t x);
+float16x8_t sigmoidq_f16(float16x8_t x);
+float16x8_t erfq_f16(float16x8_t x);
+#endif // NEON_SIM_MATH_HAS_F16
+
+/// @brief one entry per function, for tests, benchmarks and the accuracy sweep
+struct Function
+{
+    const char* name;
+    float32x4_t (*vec)(float32x4_t);
+    void (*array)(const float* src, float* dst, size_t n);
+    double (*reference)(double); // libm in double precision
+    float (*libm)(float);        // the scalar float baseline
+    double max_ulp;              // documented bound, see above
+};
+
+const std::vector<Function>& functions();
+
+/// @brief the entry called `name`, or NULL
+const Function* find_function(const char* name);
+
+} // namespace math
+} // namespace neon_sim_kernels
@@ -0,0 +1,374 @@
+#pragma once
+
+//
+// Work-stealing thread pool and row/tile executors for running kernels across
+// all cores.
+//
+// usage:
+// #include "neon_sim_parallel.hpp"
+//
+// neon_sim_kernels::ThreadPool& pool = neon_sim_kernels::default_thread_pool();
+// neon_sim_kernels::parallel_rows(pool, height, 0, [&](int y0, int y1, int worker) {
+//     neon_sim_kernels::rgb2gray(src + y0 * src_step, src_step, dst + y0 * dst_step, dst_step, width, y1 - y0);
+// });
+//
+// Each worker owns a contiguous range of task indices. A worker whose range
+// runs dry steals the back half of another worker's range, so uneven rows
+// (e.g. a slow simulated tail) do not leave cores idle. The calling thread
+// takes part as worker 0.
+//
+// Per-worker state, such as instrumentation counters, goes into PerThread<T>:
+// each worker only touches its own slot, and the slots are merged once the
+// run is over, so no locking or atomics are needed inside kernels.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neon_sim_kernels {
+
+struct WorkerStats
+{
+    size_t tasks = 0;   // tasks run by this worker
+    size_t steals = 0;  // successful steals from other workers
+    double busy_ms = 0; // time spent running tasks and stealing
+};
+
+struct ParallelStats
+{
+    std::vector<WorkerStats> workers;
+
+    size_t tasks() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            n += workers[i].tasks;
+        }
+        return n;
+    }
+
+    size_t steals() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            n += workers[i].steals;
+        }
+        return n;
+    }
+};
+
+class ThreadPool
+{
+public:
+    /// @param num_threads number of workers including the calling thread, 0 for one per core
+    explicit ThreadPool(int num_threads = 0)
+    {
+        if (num_threads <= 0)
+        {
+            num_threads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        num_threads_ = num_threads;
+        queues_.reset(new Queue[num_threads]);
+        worker_stats_.resize(num_threads);
+        for (int i = 1; i < num_threads; i++)
+        {
+            threads_.push_back(std::thread(&ThreadPool::worker_loop, this, i));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < threads_.size(); i++)
+        {
+            threads_[i].join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int num_threads() const
+    {
+        return num_threads_;
+    }
+
+    /// @brief call fn(task, worker) for every task in [0, num_tasks) and wait for all of them
+    /// worker is in [0, num_threads()). The first exception thrown by a task is rethrown here,
+    /// the remaining tasks are skipped. Must not be called from inside a task.
+    void run(size_t num_tasks, const std::function<void(size_t, int)>& fn, ParallelStats* stats = NULL)
+    {
+        if (in_task())
+        {
+            fprintf(stderr, "%s: nested parallel run is not supported\n", __FUNCTION__);
+            abort();
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        for (int i = 0; i < num_threads_; i++)
+        {
+            queues_[i].begin = num_tasks * i / num_threads_;
+            queues_[i].end = num_tasks * (i + 1) / num_threads_;
+            worker_stats_[i] = WorkerStats();
+        }
+        task_ = &fn;
+        failed_ = false;
+        error_ = std::exception_ptr();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_ = num_threads_ - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+        work(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+        }
+        task_ = NULL;
+
+        if (stats)
+        {
+            stats->workers = worker_stats_;
+        }
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    // owner pops from begin, thieves take from end
+    struct Queue
+    {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+        char pad[64];
+    };
+
+    static bool& in_task()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    bool pop(int worker, size_t& task)
+    {
+        Queue& q = queues_[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.begin < q.end)
+        {
+            task = q.begin++;
+            return true;
+        }
+        return false;
+    }
+
+    bool steal(int thief, size_t& task)
+    {
+        for (int k = 1; k < num_threads_; k++)
+        {
+            Queue& victim = queues_[(thief + k) % num_threads_];
+            size_t first;
+            size_t last;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (victim.begin >= victim.end)
+                {
+                    continue;
+                }
+                const size_t remain = victim.end - victim.begin;
+                last = victim.end;
+                first = last - (remain + 1) / 2;
+                victim.end = first;
+            }
+            Queue& own = queues_[thief];
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin = first + 1;
+                own.end = last;
+            }
+            worker_stats_[thief].steals++;
+            task = first;
+            return true;
+        }
+        return false;
+    }
+
+    void work(int worker)
+    {
+        WorkerStats& st = worker_stats_[worker];
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        in_task() = true;
+        size_t task;
+        while (pop(worker, task) || steal(worker, task))
+        {
+            if (failed_.load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+            try
+            {
+                (*task_)(task, worker);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                {
+                    error_ = std::current_exception();
+                }
+                failed_ = true;
+            }
+            st.tasks++;
+        }
+        in_task() = false;
+        st.busy_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void worker_loop(int worker)
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                {
+                    return;
+                }
+                seen = generation_;
+            }
+            work(worker);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--active_ == 0)
+                {
+                    done_.notify_one();
+                }
+            }
+        }
+    }
+
+    int num_threads_ = 1;
+    std::unique_ptr<Queue[]> queues_;
+    std::vector<WorkerStats> worker_stats_;
+    std::vector<std::thread> threads_;
+
+    std::mutex run_mutex_; // one run() at a time
+    std::mutex mutex_;     // guards the fields below
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;
+    int active_ = 0;
+    bool stop_ = false;
+
+    const std::function<void(size_t, int)>* task_ = NULL;
+    std::atomic<bool> failed_{ false };
+    std::exception_ptr error_;
+};
+
+/// @brief process wide pool, sized by the NEON_SIM_THREADS environment variable (default: one per core)
+static inline ThreadPool& default_thread_pool()
+{
+    static ThreadPool pool(getenv("NEON_SIM_THREADS") ? atoi(getenv("NEON_SIM_THREADS")) : 0);
+    return pool;
+}
+
+/// @brief one value per worker, padded so that neighbouring workers never share a cache line
+template<typename T>
+class PerThread
+{
+public:
+    explicit PerThread(const ThreadPool& pool, const T& init = T())
+        : slots_(pool.num_threads(), Slot(init))
+    {
+    }
+
+    T& local(int worker)
+    {
+        return slots_[worker].value;
+    }
+
+    /// @brief fold all slots into acc with acc = merge(acc, slot)
+    template<typename Merge>
+    T merge(T acc, Merge merge_fn) const
+    {
+        for (size_t i = 0; i < slots_.size(); i++)
+        {
+            acc = merge_fn(acc, slots_[i].value);
+        }
+        return acc;
+    }
+
+private:
+    struct Slot
+    {
+        explicit Slot(const T& v) : value(v) {}
+        T value;
+        char pad[64];
+    };
+    std::vector<Slot> slots_;
+};
+
+/// @brief split [0, height) into bands of `grain` rows and call fn(y_begin, y_end, worker) for each
+/// The last band holds the remaining rows. grain <= 0 picks about 8 bands per worker.
+template<typename Fn>
+void parallel_rows(ThreadPool& pool, int height, int grain, Fn fn, ParallelStats* stats = NULL)
+{
+    if (height <= 0)
+    {
+        return;
+    }
+    if (grain <= 0)
+    {
+        grain = std::max(1, height / (pool.num_threads() * 8));
+    }
+    const size_t bands = (size_t)((height + grain - 1) / grain);
+    pool.run(bands, [&](size_t band, int worker) {
+        const int y0 = (int)band * grain;
+        fn(y0, std::min(height, y0 + grain), worker);
+    }, stats);
+}
+
+/// @brief split a width x height image into tile_w x tile_h tiles and call fn(x0, y0, x1, y1, worker) for each
+/// Tiles on the right and bottom edges are clipped to the image.
+template<typename Fn>
+void parallel_tiles(ThreadPool& pool, int width, int height, int tile_w, int tile_h, Fn fn,
+                    ParallelStats* stats = NULL)
+{
+    if (width <= 0 || height <= 0 || tile_w <= 0 || tile_h <= 0)
+    {
+        return;
+    }
+    const size_t tiles_x = (size_t)((width + tile_w - 1) / tile_w);
+    const size_t tiles_y = (size_t)((height + tile_h - 1) / tile_h);
+    pool.run(tiles_x * tiles_y, [&](size_t tile, int worker) {
+        const int x0 = (int)(tile % tiles_x) * tile_w;
+        const int y0 = (int)(tile / tiles_x) * tile_h;
+        fn(x0, y0, std::min(width, x0 + tile_w), std::min(height, y0 + tile_h), worker);
+    }, stats);
+}
+
+} // namespace neon_sim_kernels
@@ -0,0 +1,318 @@
+#include "neon_sim_pipeline.hpp"
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+namespace neon_sim_kernels {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+static double ms_since(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+struct Work
+{
+    DatasetResult result;
+    MappedImage input;
+    std::vector<uint8_t> sim_data;
+    std::vector<uint8_t> ref_data;
+    MutableImageView sim_out;
+    MutableImageView ref_out;
+};
+
+typedef std::unique_ptr<Work> WorkPtr;
+typedef BoundedQueue<WorkPtr> WorkQueue;
+
+static MutableImageView make_output(const ImageView& in, int channels, std::vector<uint8_t>& storage)
+{
+    MutableImageView out;
+    out.width = in.width;
+    out.height = in.height;
+    out.channels = channels;
+    out.step = (size_t)in.width * channels;
+    storage.resize(out.step * in.height);
+    out.data = storage.data();
+    return out;
+}
+
+// Per-thread timers, summed into the stage after the thread ends.
+struct StageTimer
+{
+    size_t items = 0;
+    double busy_ms = 0;
+    double blocked_ms = 0;
+    double starved_ms = 0;
+};
+
+class Stage
+{
+public:
+    Stage(const std::string& name, int threads)
+    {
+        stats_.name = name;
+        stats_.threads = std::max(1, threads);
+    }
+
+    // run body on every thread; `done` is called once, after the last thread of the stage ends
+    template<typename Body>
+    void start(Body body, std::function<void()> done)
+    {
+        remaining_ = stats_.threads;
+        for (int i = 0; i < stats_.threads; i++)
+        {
+            threads_.push_back(std::thread([this, body, done] {
+                StageTimer t;
+                body(t);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stats_.items += t.items;
+                    stats_.busy_ms += t.busy_ms;
+                    stats_.blocked_ms += t.blocked_ms;
+                    stats_.starved_ms += t.starved_ms;
+                }
+                if (--remaining_ == 0)
+                {
+                    done();
+                }
+            }));
+        }
+    }
+
+    void join()
+    {
+        for (size_t i = 0; i < threads_.size(); i++)
+        {
+            threads_[i].join();
+        }
+    }
+
+    const StageStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    StageStats stats_;
+    std::vector<std::thread> threads_;
+    std::atomic<int> remaining_{ 0 };
+    std::mutex mutex_;
+};
+
+static bool timed_pop(WorkQueue& q, WorkPtr& w, StageTimer& t)
+{
+    const Clock::time_point t0 = Clock::now();
+    const bool got = q.pop(w);
+    t.starved_ms += ms_since(t0);
+    return got;
+}
+
+static void timed_push(WorkQueue& q, WorkPtr w, StageTimer& t)
+{
+    const Clock::time_point t0 = Clock::now();
+    q.push(std::move(w));
+    t.blocked_ms += ms_since(t0);
+}
+
+// what a user callback threw, for DatasetResult::error
+static std::string exception_message(const std::string& where)
+{
+    try
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        return where + ": " + e.what();
+    }
+    catch (...)
+    {
+        return where + ": unknown exception";
+    }
+}
+
+// sim / ref stage body: apply `fn` to every loaded image. An exception fails
+// that image only, the stage keeps draining so the queues still close.
+static void kernel_stage(WorkQueue& in, WorkQueue& out, StageTimer& t, bool sim, const DatasetKernel& kernel)
+{
+    WorkPtr w;
+    while (timed_pop(in, w, t))
+    {
+        const Clock::time_point t0 = Clock::now();
+        if (w->result.loaded && !w->result.kernel_failed)
+        {
+            try
+            {
+                if (sim)
+                {
+                    w->sim_out = make_output(w->input.view(), kernel.output_channels, w->sim_data);
+                    kernel.sim(w->input.view(), w->sim_out);
+                }
+                else
+                {
+                    w->ref_out = make_output(w->input.view(), kernel.output_channels, w->ref_data);
+                    kernel.ref(w->input.view(), w->ref_out);
+                }
+            }
+            catch (...)
+            {
+                w->result.kernel_failed = true;
+                w->result.error = exception_message(w->result.path + ": " + kernel.name + (sim ? " sim" : " ref"));
+            }
+            t.items++;
+        }
+        t.busy_ms += ms_since(t0);
+        timed_push(out, std::move(w), t);
+    }
+}
+
+} // namespace
+
+DatasetReport run_dataset(const std::vector<std::string>& paths, const DatasetKernel& kernel,
+                          const PipelineOptions& opt, const std::function<void(const DatasetResult&)>& on_result)
+{
+    const Clock::time_point start = Clock::now();
+    const int cores = std::max(1, (int)std::thread::hardware_concurrency());
+
+    WorkQueue loaded(opt.queue_capacity);
+    WorkQueue simulated(opt.queue_capacity);
+    WorkQueue referenced(opt.queue_capacity);
+
+    Stage load("load", opt.load_threads);
+    Stage sim("sim", opt.sim_threads > 0 ? opt.sim_threads : cores);
+    Stage ref("ref", opt.ref_threads);
+    Stage cmp("compare", opt.compare_threads);
+
+    DatasetReport rep;
+    std::mutex report_mutex;
+    std::atomic<size_t> next_index(0);
+
+    load.start([&](StageTimer& t) {
+        for (size_t i = next_index++; i < paths.size(); i = next_index++)
+        {
+            const Clock::time_point t0 = Clock::now();
+            WorkPtr w(new Work());
+            w->result.index = i;
+            w->result.path = paths[i];
+            try
+            {
+                w->result.loaded = kernel.open ? kernel.open(paths[i], w->input) : w->input.open_pnm(paths[i]);
+                if (!w->result.loaded)
+                {
+                    w->result.error = w->input.error().empty() ? paths[i] + ": cannot open" : w->input.error();
+                }
+            }
+            catch (...)
+            {
+                w->result.loaded = false;
+                w->result.error = exception_message(paths[i]);
+            }
+            t.items++;
+            t.busy_ms += ms_since(t0);
+            timed_push(loaded, std::move(w), t);
+        }
+    }, [&] { loaded.close(); });
+
+    sim.start([&](StageTimer& t) { kernel_stage(loaded, simulated, t, true, kernel); }, [&] { simulated.close(); });
+    ref.start([&](StageTimer& t) { kernel_stage(simulated, referenced, t, false, kernel); }, [&] { referenced.close(); });
+
+    cmp.start([&](StageTimer& t) {
+        WorkPtr w;
+        while (timed_pop(referenced, w, t))
+        {
+            const Clock::time_point t0 = Clock::now();
+            DatasetResult& r = w->result;
+            if (r.loaded && !r.kernel_failed)
+            {
+                const ImageView& e = w->ref_out;
+                const ImageView& a = w->sim_out;
+                r.compare = compare_image(e.data, e.step, a.data, a.step, e.height, e.width, e.channels,
+                                          kernel.tolerance, opt.max_locations);
+                t.items++;
+            }
+            // release the mapping and buffers before waiting on the report lock
+            w->input.close();
+            std::vector<uint8_t>().swap(w->sim_data);
+            std::vector<uint8_t>().swap(w->ref_data);
+            t.busy_ms += ms_since(t0);
+
+            std::lock_guard<std::mutex> lock(report_mutex);
+            rep.images++;
+            if (!r.loaded)
+            {
+                rep.load_errors++;
+                rep.failures.push_back(r);
+            }
+            else if (r.kernel_failed)
+            {
+                rep.kernel_errors++;
+                rep.failures.push_back(r);
+            }
+            else if (!r.compare.ok())
+            {
+                rep.mismatched_images++;
+                rep.failures.push_back(r);
+            }
+            if (on_result)
+            {
+                on_result(r);
+            }
+        }
+    }, [] {});
+
+    load.join();
+    sim.join();
+    ref.join();
+    cmp.join();
+
+    rep.stages.push_back(load.stats());
+    rep.stages.push_back(sim.stats());
+    rep.stages.push_back(ref.stats());
+    rep.stages.push_back(cmp.stats());
+    std::sort(rep.failures.begin(), rep.failures.end(),
+              [](const DatasetResult& a, const DatasetResult& b) { return a.index < b.index; });
+    rep.wall_ms = ms_since(start);
+    return rep;
+}
+
+void print_report(std::ostream& os, const DatasetReport& rep)
+{
+    char line[256];
+    snprintf(line, sizeof(line), "%-10s %8s %8s %12s %12s %12s %12s", "stage", "threads", "items", "busy ms",
+             "blocked ms", "starved ms", "items/s");
+    os << line << std::endl;
+    for (size_t i = 0; i < rep.stages.size(); i++)
+    {
+        const StageStats& s = rep.stages[i];
+        // throughput the stage could sustain on its own: items over busy time per thread
+        const double per_thread_ms = s.busy_ms / s.threads;
+        snprintf(line, sizeof(line), "%-10s %8d %8zu %12.1f %12.1f %12.1f %12.1f", s.name.c_str(), s.threads, s.items,
+                 s.busy_ms, s.blocked_ms, s.starved_ms, per_thread_ms > 0 ? s.items / (per_thread_ms / 1000.0) : 0.0);
+        os << line << std::endl;
+    }
+    snprintf(line, sizeof(line), "%zu images in %.1f ms (%.1f images/s), %zu load errors, %zu kernel errors, %zu mismatched",
+             rep.images, rep.wall_ms, rep.wall_ms > 0 ? rep.images / (rep.wall_ms / 1000.0) : 0.0, rep.load_errors,
+             rep.kernel_errors, rep.mismatched_images);
+    os << line << std::endl;
+    for (size_t i = 0; i < rep.failures.size(); i++)
+    {
+        const DatasetResult& r = rep.failures[i];
+        if (!r.loaded || r.kernel_failed)
+        {
+            os << "  " << r.error << std::endl;
+        }
+        else
+        {
+            os << "  " << r.path << ": " << r.compare << std::endl;
+        }
+    }
+}
+
+} // namespace neon_sim_kernels
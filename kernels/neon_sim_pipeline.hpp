@@ -0,0 +1,167 @@
+#pragma once
+
+//
+// Pipelined dataset runner: images flow through load -> sim kernel ->
+// reference kernel -> compare stages, each with its own threads, connected by
+// bounded queues. A full queue blocks its producer (backpressure), so at most
+// about (capacity + threads) images per stage are in memory at any time.
+//
+// usage:
+// #include "neon_sim_pipeline.hpp"
+//
+// neon_sim_kernels::DatasetKernel k;
+// k.name = "rgb2gray";
+// k.output_channels = 1;
+// k.sim = [](const ImageView& in, const MutableImageView& out) { rgb2gray(in.data, in.step, out.data, out.step, in.width, in.height); };
+// k.ref = ...;
+// neon_sim_kernels::DatasetReport rep = neon_sim_kernels::run_dataset(paths, k, neon_sim_kernels::PipelineOptions());
+// neon_sim_kernels::print_report(std::cout, rep);
+//
+// Outputs are compared with compare_image() from neon_sim_compare.hpp, the same
+// helper behind test_util.hpp and opencv_helper.hpp.
+//
+
+#include <stddef.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "neon_sim_compare.hpp"
+#include "neon_sim_image_io.hpp"
+
+namespace neon_sim_kernels {
+
+/// @brief blocking FIFO with a fixed capacity
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    /// @brief wait for room, then append. Returns false (and drops v) if the queue was closed.
+    bool push(T v)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_)
+        {
+            return false;
+        }
+        items_.push_back(std::move(v));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /// @brief wait for an item. Returns false once the queue is closed and drained.
+    bool pop(T& v)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty())
+        {
+            return false;
+        }
+        v = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /// @brief no more pushes; consumers drain what is left
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+struct DatasetKernel
+{
+    std::string name;
+    int output_channels = 1;    // output is input width x height x output_channels
+    CompareTolerance tolerance; // exact by default
+    std::function<void(const ImageView& in, const MutableImageView& out)> sim;
+    std::function<void(const ImageView& in, const MutableImageView& out)> ref;
+    // how to open one dataset file; default MappedImage::open_pnm
+    std::function<bool(const std::string& path, MappedImage& img)> open;
+};
+
+struct PipelineOptions
+{
+    int load_threads = 1;
+    int sim_threads = 0;  // 0: one per core
+    int ref_threads = 1;
+    int compare_threads = 1;
+    size_t queue_capacity = 4; // per queue between two stages
+    size_t max_locations = 8;  // mismatch locations kept per image
+};
+
+struct StageStats
+{
+    std::string name;
+    int threads = 0;
+    size_t items = 0;
+    double busy_ms = 0;      // summed over the stage's threads
+    double blocked_ms = 0;   // waiting on a full output queue (backpressure)
+    double starved_ms = 0;   // waiting on an empty input queue
+};
+
+struct DatasetResult
+{
+    size_t index = 0;
+    std::string path;
+    bool loaded = false;
+    bool kernel_failed = false; // kernel.sim or kernel.ref threw, the image is not compared
+    std::string error;          // load error, or what the kernel threw
+    CompareResult compare;
+};
+
+struct DatasetReport
+{
+    std::vector<StageStats> stages; // load, sim, ref, compare
+    size_t images = 0;
+    size_t load_errors = 0;
+    size_t kernel_errors = 0;
+    size_t mismatched_images = 0;
+    double wall_ms = 0;
+    std::vector<DatasetResult> failures; // load errors, kernel errors and mismatching images, by index
+
+    bool ok() const
+    {
+        return load_errors == 0 && kernel_errors == 0 && mismatched_images == 0;
+    }
+};
+
+/// @brief run every file of `paths` through the pipeline and wait for the last image
+/// on_result, if given, is called once per image (serialized, in completion order).
+/// A kernel or open callback that throws fails only the image it was given.
+DatasetReport run_dataset(const std::vector<std::string>& paths, const DatasetKernel& kernel,
+                          const PipelineOptions& opt,
+                          const std::function<void(const DatasetResult&)>& on_result = nullptr);
+
+/// @brief per-stage items, busy/blocked/starved time and throughput
+void print_report(std::ostream& os, const DatasetReport& rep);
+
+} // namespace neon_sim_kernels
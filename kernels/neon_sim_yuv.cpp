@@ -0,0 +1,639 @@
+#include "neon_sim_yuv.hpp"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#else
+#include "arm_neon_sim.hpp"
+#endif
+
+#include <algorithm>
+
+namespace neon_sim_kernels {
+namespace yuv {
+
+namespace {
+
+template<typename T>
+inline const T* row(const T* base, size_t step, int y)
+{
+    return (const T*)((const uint8_t*)base + y * step);
+}
+
+template<typename T>
+inline T* row(T* base, size_t step, int y)
+{
+    return (T*)((uint8_t*)base + y * step);
+}
+
+// r = (max(0, Y - y_offset) * cy + cvr * V' + 2^19) >> 20, with U' = U - uv_offset
+// and V' = V - uv_offset; g uses cvg and cug, b uses cub
+struct Decode
+{
+    int32_t cy, cvr, cvg, cug, cub;
+    int y_offset;
+    int uv_offset;
+};
+
+// Q20; BT601_LIMITED is OpenCV's ITUR_BT_601_CY, _CVR, _CVG, _CUG, _CUB
+const Decode kDecode[4] = {
+    { 1220542, 1673527, -852492, -409993, 2116026, 16, 128 },
+    { 1048576, 1470104, -748826, -360853, 1858077, 0, 128 },
+    { 1220945, 1879825, -558796, -223607, 2215014, 16, 128 },
+    { 1048576, 1651297, -490864, -196424, 1945738, 0, 128 },
+};
+
+// 10 bit samples are 4 times the 8 bit ones: Q18 coefficients keep the
+// products in 32 bits and the same >> 20
+Decode p010_coeffs(ColorSpace cs)
+{
+    Decode k = kDecode[cs];
+    k.cy = (k.cy + 2) >> 2;
+    k.cvr = (k.cvr + 2) >> 2;
+    k.cvg = (k.cvg + 2) >> 2;
+    k.cug = (k.cug + 2) >> 2;
+    k.cub = (k.cub + 2) >> 2;
+    k.y_offset *= 4;
+    k.uv_offset *= 4;
+    return k;
+}
+
+// Y = (y . rgb + (y_offset << 14) + 2^13) >> 14 per pixel and
+// U = sat((u . rgb4 + (128 << 16) + 2^15) >> 16) on the sums rgb4 of a 2x2
+// block (and the same for V); Q14, every chroma row sums to 0. P010 keeps
+// two more bits: the same sums shifted by 12 and 14.
+struct Encode
+{
+    int16_t y[3];
+    int16_t u[3];
+    int16_t v[3];
+    int y_offset;
+};
+
+const Encode kEncode[4] = {
+    { { 4207, 8260, 1604 }, { -2428, -4768, 7196 }, { 7196, -6026, -1170 }, 16 },
+    { { 4899, 9617, 1868 }, { -2765, -5427, 8192 }, { 8192, -6860, -1332 }, 0 },
+    { { 2991, 10064, 1016 }, { -1649, -5547, 7196 }, { 7196, -6536, -660 }, 16 },
+    { { 3483, 11718, 1183 }, { -1877, -6315, 8192 }, { 8192, -7441, -751 }, 0 },
+};
+
+inline uint8_t sat_u8(int v)
+{
+    return (uint8_t)std::min(std::max(v, 0), 255);
+}
+
+inline bool blue_first(Layout layout)
+{
+    return layout == LAYOUT_BGR || layout == LAYOUT_BGRA;
+}
+
+inline void write_rgb(uint8_t* d, Layout layout, uint8_t r, uint8_t g, uint8_t b)
+{
+    d[0] = blue_first(layout) ? b : r;
+    d[1] = g;
+    d[2] = blue_first(layout) ? r : b;
+    if (layout_channels(layout) == 4)
+    {
+        d[3] = 255;
+    }
+}
+
+inline void read_rgb(const uint8_t* s, Layout layout, int rgb[3])
+{
+    rgb[0] = blue_first(layout) ? s[2] : s[0];
+    rgb[1] = s[1];
+    rgb[2] = blue_first(layout) ? s[0] : s[2];
+}
+
+// one pixel from its offset luma and chroma samples
+inline void decode_pixel(int y, int u, int v, const Decode& k, uint8_t* d, Layout layout)
+{
+    const int luma = std::max(y - k.y_offset, 0) * k.cy + (1 << 19);
+    u -= k.uv_offset;
+    v -= k.uv_offset;
+    write_rgb(d, layout, sat_u8((luma + k.cvr * v) >> 20), sat_u8((luma + k.cvg * v + k.cug * u) >> 20),
+              sat_u8((luma + k.cub * u) >> 20));
+}
+
+// encoded samples: 8 bit, or P010's 10 bits in the high bits of a uint16_t
+template<typename T>
+struct SampleBits
+{
+    static const int bits = sizeof(T) == 1 ? 8 : 10;
+    static const int pad = (int)sizeof(T) * 8 - bits;
+};
+
+template<typename T>
+inline T encode_luma(const int rgb[3], const Encode& k)
+{
+    const int shift = 22 - SampleBits<T>::bits;
+    const int dot = k.y[0] * rgb[0] + k.y[1] * rgb[1] + k.y[2] * rgb[2] + (k.y_offset << 14) + (1 << (shift - 1));
+    return (T)((dot >> shift) << SampleBits<T>::pad);
+}
+
+template<typename T>
+inline T encode_chroma(const int16_t c[3], const int sum[3])
+{
+    const int shift = 24 - SampleBits<T>::bits;
+    const int dot = c[0] * sum[0] + c[1] * sum[1] + c[2] * sum[2] + (128 << 16) + (1 << (shift - 1));
+    return (T)(std::min(std::max(dot >> shift, 0), (1 << SampleBits<T>::bits) - 1) << SampleBits<T>::pad);
+}
+
+// the 2x2 block of columns x0, x1 of rows s0, s1; at an odd right or bottom
+// edge x1 == x0 or s1 == s0 (and y1 == y0), so the last pixel counts twice
+template<typename T>
+void encode_block(const uint8_t* s0, const uint8_t* s1, int x0, int x1, Layout layout, const Encode& k, T* y0, T* y1,
+                  T* u, T* v)
+{
+    const int cn = layout_channels(layout);
+    const uint8_t* px[4] = { s0 + x0 * cn, s0 + x1 * cn, s1 + x0 * cn, s1 + x1 * cn };
+    T luma[4];
+    int sum[3] = { 0, 0, 0 };
+    for (int i = 0; i < 4; i++)
+    {
+        int rgb[3];
+        read_rgb(px[i], layout, rgb);
+        luma[i] = encode_luma<T>(rgb, k);
+        sum[0] += rgb[0];
+        sum[1] += rgb[1];
+        sum[2] += rgb[2];
+    }
+    y0[x0] = luma[0];
+    y0[x1] = luma[1];
+    y1[x0] = luma[2];
+    y1[x1] = luma[3];
+    *u = encode_chroma<T>(k.u, sum);
+    *v = encode_chroma<T>(k.v, sum);
+}
+
+// 16 offset luma samples (two u16 vectors) times cy, 4 lanes per vector
+inline void luma_products(uint16x8_t lo, uint16x8_t hi, int32_t cy, int32x4_t out[4])
+{
+    out[0] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))), cy);
+    out[1] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))), cy);
+    out[2] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))), cy);
+    out[3] = vmulq_n_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi))), cy);
+}
+
+inline void luma_products_u8(const uint8_t* y, uint8x16_t offset, int32_t cy, int32x4_t out[4])
+{
+    const uint8x16_t v = vqsubq_u8(vld1q_u8(y), offset);
+    luma_products(vmovl_u8(vget_low_u8(v)), vmovl_u8(vget_high_u8(v)), cy, out);
+}
+
+inline void luma_products_p010(const uint16_t* y, uint16x8_t offset, int32_t cy, int32x4_t out[4])
+{
+    luma_products(vqsubq_u16(vshrq_n_u16(vld1q_u16(y), 6), offset),
+                  vqsubq_u16(vshrq_n_u16(vld1q_u16(y + 8), 6), offset), cy, out);
+}
+
+// 8 chroma terms, 4 per vector, each repeated for the two pixels it covers
+inline void chroma_pairs(int32x4_t lo, int32x4_t hi, int32x4_t out[4])
+{
+    const int32x4x2_t a = vzipq_s32(lo, lo);
+    const int32x4x2_t b = vzipq_s32(hi, hi);
+    out[0] = a.val[0];
+    out[1] = a.val[1];
+    out[2] = b.val[0];
+    out[3] = b.val[1];
+}
+
+// sat((luma + chroma + 2^19) >> 20); vqrshrun_n shifts by at most 16, and
+// ((s >> 4) + 2^15) >> 16 == (s + 2^19) >> 20 for any s
+inline uint8x16_t narrow_channel(const int32x4_t luma[4], const int32x4_t chroma[4])
+{
+    uint16x4_t n[4];
+    for (int i = 0; i < 4; i++)
+    {
+        n[i] = vqrshrun_n_s32(vshrq_n_s32(vaddq_s32(luma[i], chroma[i]), 4), 16);
+    }
+    return vcombine_u8(vqmovn_u16(vcombine_u16(n[0], n[1])), vqmovn_u16(vcombine_u16(n[2], n[3])));
+}
+
+inline void store_pixels(uint8_t* d, Layout layout, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+    const uint8x16_t first = blue_first(layout) ? b : r;
+    const uint8x16_t last = blue_first(layout) ? r : b;
+    if (layout_channels(layout) == 4)
+    {
+        uint8x16x4_t px;
+        px.val[0] = first;
+        px.val[1] = g;
+        px.val[2] = last;
+        px.val[3] = vdupq_n_u8(255);
+        vst4q_u8(d, px);
+    }
+    else
+    {
+        uint8x16x3_t px;
+        px.val[0] = first;
+        px.val[1] = g;
+        px.val[2] = last;
+        vst3q_u8(d, px);
+    }
+}
+
+inline void load_pixels(const uint8_t* s, Layout layout, uint8x16_t rgb[3])
+{
+    uint8x16_t first, g, last;
+    if (layout_channels(layout) == 4)
+    {
+        const uint8x16x4_t px = vld4q_u8(s);
+        first = px.val[0];
+        g = px.val[1];
+        last = px.val[2];
+    }
+    else
+    {
+        const uint8x16x3_t px = vld3q_u8(s);
+        first = px.val[0];
+        g = px.val[1];
+        last = px.val[2];
+    }
+    rgb[0] = blue_first(layout) ? last : first;
+    rgb[1] = g;
+    rgb[2] = blue_first(layout) ? first : last;
+}
+
+// 16 pixels of two rows sharing 8 chroma samples (already minus uv_offset)
+void decode16x2(const int32x4_t y0[4], const int32x4_t y1[4], int16x8_t u, int16x8_t v, const Decode& k,
+                uint8_t* d0, uint8_t* d1, Layout layout)
+{
+    const int32x4_t u_lo = vmovl_s16(vget_low_s16(u)), u_hi = vmovl_s16(vget_high_s16(u));
+    const int32x4_t v_lo = vmovl_s16(vget_low_s16(v)), v_hi = vmovl_s16(vget_high_s16(v));
+    int32x4_t cr[4], cg[4], cb[4];
+    chroma_pairs(vmulq_n_s32(v_lo, k.cvr), vmulq_n_s32(v_hi, k.cvr), cr);
+    chroma_pairs(vmlaq_n_s32(vmulq_n_s32(v_lo, k.cvg), u_lo, k.cug),
+                 vmlaq_n_s32(vmulq_n_s32(v_hi, k.cvg), u_hi, k.cug), cg);
+    chroma_pairs(vmulq_n_s32(u_lo, k.cub), vmulq_n_s32(u_hi, k.cub), cb);
+
+    store_pixels(d0, layout, narrow_channel(y0, cr), narrow_channel(y0, cg), narrow_channel(y0, cb));
+    store_pixels(d1, layout, narrow_channel(y1, cr), narrow_channel(y1, cg), narrow_channel(y1, cb));
+}
+
+inline int16x8_t center_u8(uint8x8_t c)
+{
+    return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(128));
+}
+
+inline int16x8_t center_p010(uint16x8_t c, int uv_offset)
+{
+    return vsubq_s16(vreinterpretq_s16_u16(vshrq_n_u16(c, 6)), vdupq_n_s16((int16_t)uv_offset));
+}
+
+// the Q14 chroma sums of 8 blocks from the 2x2 sums of each channel, biased by 128
+inline void chroma_dot8(const int16x8_t sum[3], const int16_t c[3], int32x4_t out[2])
+{
+    const int32x4_t bias = vdupq_n_s32(128 << 16);
+    int32x4_t lo = vmull_n_s16(vget_low_s16(sum[0]), c[0]);
+    lo = vmlal_n_s16(lo, vget_low_s16(sum[1]), c[1]);
+    lo = vmlal_n_s16(lo, vget_low_s16(sum[2]), c[2]);
+    int32x4_t hi = vmull_n_s16(vget_high_s16(sum[0]), c[0]);
+    hi = vmlal_n_s16(hi, vget_high_s16(sum[1]), c[1]);
+    hi = vmlal_n_s16(hi, vget_high_s16(sum[2]), c[2]);
+    out[0] = vaddq_s32(lo, bias);
+    out[1] = vaddq_s32(hi, bias);
+}
+
+inline uint8x8_t chroma_block8(const int16x8_t sum[3], const int16_t c[3])
+{
+    int32x4_t d[2];
+    chroma_dot8(sum, c, d);
+    return vqmovn_u16(vcombine_u16(vqrshrun_n_s32(d[0], 16), vqrshrun_n_s32(d[1], 16)));
+}
+
+// P010: 10 bits, clamped to 1023 and moved to the high bits
+inline uint16x8_t chroma_block8_p010(const int16x8_t sum[3], const int16_t c[3])
+{
+    int32x4_t d[2];
+    chroma_dot8(sum, c, d);
+    const uint16x8_t c10 = vcombine_u16(vqrshrun_n_s32(d[0], 14), vqrshrun_n_s32(d[1], 14));
+    return vshlq_n_u16(vminq_u16(c10, vdupq_n_u16(1023)), 6);
+}
+
+// the Q14 luma sums of 8 pixels plus the offset; every coefficient is positive
+inline void luma_dot8(uint8x8_t r, uint8x8_t g, uint8x8_t b, const Encode& k, uint32x4_t out[2])
+{
+    const uint32x4_t bias = vdupq_n_u32((uint32_t)k.y_offset << 14);
+    const uint16x8_t r16 = vmovl_u8(r), g16 = vmovl_u8(g), b16 = vmovl_u8(b);
+    uint32x4_t lo = vmull_n_u16(vget_low_u16(r16), (uint16_t)k.y[0]);
+    lo = vmlal_n_u16(lo, vget_low_u16(g16), (uint16_t)k.y[1]);
+    lo = vmlal_n_u16(lo, vget_low_u16(b16), (uint16_t)k.y[2]);
+    uint32x4_t hi = vmull_n_u16(vget_high_u16(r16), (uint16_t)k.y[0]);
+    hi = vmlal_n_u16(hi, vget_high_u16(g16), (uint16_t)k.y[1]);
+    hi = vmlal_n_u16(hi, vget_high_u16(b16), (uint16_t)k.y[2]);
+    out[0] = vaddq_u32(lo, bias);
+    out[1] = vaddq_u32(hi, bias);
+}
+
+inline uint8x8_t luma8(uint8x8_t r, uint8x8_t g, uint8x8_t b, const Encode& k)
+{
+    uint32x4_t d[2];
+    luma_dot8(r, g, b, k, d);
+    return vqmovn_u16(vcombine_u16(vrshrn_n_u32(d[0], 14), vrshrn_n_u32(d[1], 14)));
+}
+
+// P010: at most 1020, so no clamp before moving to the high bits
+inline uint16x8_t luma8_p010(uint8x8_t r, uint8x8_t g, uint8x8_t b, const Encode& k)
+{
+    uint32x4_t d[2];
+    luma_dot8(r, g, b, k, d);
+    return vshlq_n_u16(vcombine_u16(vrshrn_n_u32(d[0], 12), vrshrn_n_u32(d[1], 12)), 6);
+}
+
+inline uint8x16_t luma16(const uint8x16_t rgb[3], const Encode& k)
+{
+    return vcombine_u8(luma8(vget_low_u8(rgb[0]), vget_low_u8(rgb[1]), vget_low_u8(rgb[2]), k),
+                       luma8(vget_high_u8(rgb[0]), vget_high_u8(rgb[1]), vget_high_u8(rgb[2]), k));
+}
+
+// the 2x2 sums of each channel of 16 pixels on two rows
+inline void block_sums8(const uint8x16_t p0[3], const uint8x16_t p1[3], int16x8_t sum[3])
+{
+    for (int c = 0; c < 3; c++)
+    {
+        sum[c] = vreinterpretq_s16_u16(vaddq_u16(vpaddlq_u8(p0[c]), vpaddlq_u8(p1[c])));
+    }
+}
+
+} // namespace
+
+int layout_channels(Layout layout)
+{
+    return layout == LAYOUT_BGRA || layout == LAYOUT_RGBA ? 4 : 3;
+}
+
+void yuv420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step,
+                   int uv_pixel_stride, uint8_t* dst, size_t dst_step, int width, int height, Layout layout,
+                   ColorSpace cs)
+{
+    const Decode& k = kDecode[cs];
+    const int cn = layout_channels(layout);
+    const uint8x16_t y_offset = vdupq_n_u8((uint8_t)k.y_offset);
+    const bool u_first = u < v;
+    for (int j = 0; j < height; j += 2)
+    {
+        // an odd last row is converted twice into the same destination row
+        const int j1 = std::min(j + 1, height - 1);
+        const uint8_t* y0 = row(y, y_step, j);
+        const uint8_t* y1 = row(y, y_step, j1);
+        const uint8_t* u_row = row(u, uv_step, j / 2);
+        const uint8_t* v_row = row(v, uv_step, j / 2);
+        uint8_t* d0 = row(dst, dst_step, j);
+        uint8_t* d1 = row(dst, dst_step, j1);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x8_t u8, v8;
+            if (uv_pixel_stride == 2)
+            {
+                const uint8x8x2_t c = vld2_u8((u_first ? u_row : v_row) + x);
+                u8 = c.val[u_first ? 0 : 1];
+                v8 = c.val[u_first ? 1 : 0];
+            }
+            else
+            {
+                u8 = vld1_u8(u_row + x / 2);
+                v8 = vld1_u8(v_row + x / 2);
+            }
+            int32x4_t l0[4], l1[4];
+            luma_products_u8(y0 + x, y_offset, k.cy, l0);
+            luma_products_u8(y1 + x, y_offset, k.cy, l1);
+            decode16x2(l0, l1, center_u8(u8), center_u8(v8), k, d0 + x * cn, d1 + x * cn, layout);
+        }
+        for (; x < width; x++)
+        {
+            const int c = (x / 2) * uv_pixel_stride;
+            decode_pixel(y0[x], u_row[c], v_row[c], k, d0 + x * cn, layout);
+            decode_pixel(y1[x], u_row[c], v_row[c], k, d1 + x * cn, layout);
+        }
+    }
+}
+
+void nv21_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* vu, size_t vu_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs)
+{
+    yuv420_to_rgb(y, y_step, vu + 1, vu, vu_step, 2, dst, dst_step, width, height, layout, cs);
+}
+
+void nv12_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs)
+{
+    yuv420_to_rgb(y, y_step, uv, uv + 1, uv_step, 2, dst, dst_step, width, height, layout, cs);
+}
+
+void i420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step, uint8_t* dst,
+                 size_t dst_step, int width, int height, Layout layout, ColorSpace cs)
+{
+    yuv420_to_rgb(y, y_step, u, v, uv_step, 1, dst, dst_step, width, height, layout, cs);
+}
+
+void p010_to_rgb(const uint16_t* y, size_t y_step, const uint16_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs)
+{
+    const Decode k = p010_coeffs(cs);
+    const int cn = layout_channels(layout);
+    const uint16x8_t y_offset = vdupq_n_u16((uint16_t)k.y_offset);
+    for (int j = 0; j < height; j += 2)
+    {
+        const int j1 = std::min(j + 1, height - 1);
+        const uint16_t* y0 = row(y, y_step, j);
+        const uint16_t* y1 = row(y, y_step, j1);
+        const uint16_t* uv_row = row(uv, uv_step, j / 2);
+        uint8_t* d0 = row(dst, dst_step, j);
+        uint8_t* d1 = row(dst, dst_step, j1);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            const uint16x8x2_t c = vld2q_u16(uv_row + x);
+            int32x4_t l0[4], l1[4];
+            luma_products_p010(y0 + x, y_offset, k.cy, l0);
+            luma_products_p010(y1 + x, y_offset, k.cy, l1);
+            decode16x2(l0, l1, center_p010(c.val[0], k.uv_offset), center_p010(c.val[1], k.uv_offset), k,
+                       d0 + x * cn, d1 + x * cn, layout);
+        }
+        for (; x < width; x++)
+        {
+            const int c = (x / 2) * 2;
+            decode_pixel(y0[x] >> 6, uv_row[c] >> 6, uv_row[c + 1] >> 6, k, d0 + x * cn, layout);
+            decode_pixel(y1[x] >> 6, uv_row[c] >> 6, uv_row[c + 1] >> 6, k, d1 + x * cn, layout);
+        }
+    }
+}
+
+void rgb_to_yuv420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                   uint8_t* v, size_t uv_step, int uv_pixel_stride, int width, int height, ColorSpace cs)
+{
+    const Encode& k = kEncode[cs];
+    const int cn = layout_channels(layout);
+    const bool u_first = u < v;
+    for (int j = 0; j < height; j += 2)
+    {
+        // an odd last row is its own second row: the block sums count it twice
+        const int j1 = std::min(j + 1, height - 1);
+        const uint8_t* s0 = row(src, src_step, j);
+        const uint8_t* s1 = row(src, src_step, j1);
+        uint8_t* y0 = row(y, y_step, j);
+        uint8_t* y1 = row(y, y_step, j1);
+        uint8_t* u_row = row(u, uv_step, j / 2);
+        uint8_t* v_row = row(v, uv_step, j / 2);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t p0[3], p1[3];
+            load_pixels(s0 + x * cn, layout, p0);
+            load_pixels(s1 + x * cn, layout, p1);
+            vst1q_u8(y0 + x, luma16(p0, k));
+            vst1q_u8(y1 + x, luma16(p1, k));
+
+            int16x8_t sum[3];
+            block_sums8(p0, p1, sum);
+            const uint8x8_t u8 = chroma_block8(sum, k.u);
+            const uint8x8_t v8 = chroma_block8(sum, k.v);
+            if (uv_pixel_stride == 2)
+            {
+                uint8x8x2_t c;
+                c.val[0] = u_first ? u8 : v8;
+                c.val[1] = u_first ? v8 : u8;
+                vst2_u8((u_first ? u_row : v_row) + x, c);
+            }
+            else
+            {
+                vst1_u8(u_row + x / 2, u8);
+                vst1_u8(v_row + x / 2, v8);
+            }
+        }
+        for (; x < width; x += 2)
+        {
+            const int c = (x / 2) * uv_pixel_stride;
+            encode_block(s0, s1, x, std::min(x + 1, width - 1), layout, k, y0, y1, u_row + c, v_row + c);
+        }
+    }
+}
+
+void rgb_to_p010(const uint8_t* src, size_t src_step, Layout layout, uint16_t* y, size_t y_step, uint16_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs)
+{
+    const Encode& k = kEncode[cs];
+    const int cn = layout_channels(layout);
+    for (int j = 0; j < height; j += 2)
+    {
+        const int j1 = std::min(j + 1, height - 1);
+        const uint8_t* s0 = row(src, src_step, j);
+        const uint8_t* s1 = row(src, src_step, j1);
+        uint16_t* y0 = row(y, y_step, j);
+        uint16_t* y1 = row(y, y_step, j1);
+        uint16_t* uv_row = row(uv, uv_step, j / 2);
+        int x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            uint8x16_t p0[3], p1[3];
+            load_pixels(s0 + x * cn, layout, p0);
+            load_pixels(s1 + x * cn, layout, p1);
+            vst1q_u16(y0 + x, luma8_p010(vget_low_u8(p0[0]), vget_low_u8(p0[1]), vget_low_u8(p0[2]), k));
+            vst1q_u16(y0 + x + 8, luma8_p010(vget_high_u8(p0[0]), vget_high_u8(p0[1]), vget_high_u8(p0[2]), k));
+            vst1q_u16(y1 + x, luma8_p010(vget_low_u8(p1[0]), vget_low_u8(p1[1]), vget_low_u8(p1[2]), k));
+            vst1q_u16(y1 + x + 8, luma8_p010(vget_high_u8(p1[0]), vget_high_u8(p1[1]), vget_high_u8(p1[2]), k));
+
+            int16x8_t sum[3];
+            block_sums8(p0, p1, sum);
+            uint16x8x2_t c;
+            c.val[0] = chroma_block8_p010(sum, k.u);
+            c.val[1] = chroma_block8_p010(sum, k.v);
+            vst2q_u16(uv_row + x, c);
+        }
+        for (; x < width; x += 2)
+        {
+            encode_block(s0, s1, x, std::min(x + 1, width - 1), layout, k, y0, y1, uv_row + x, uv_row + x + 1);
+        }
+    }
+}
+
+void rgb_to_nv21(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* vu,
+                 size_t vu_step, int width, int height, ColorSpace cs)
+{
+    rgb_to_yuv420(src, src_step, layout, y, y_step, vu + 1, vu, vu_step, 2, width, height, cs);
+}
+
+void rgb_to_nv12(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs)
+{
+    rgb_to_yuv420(src, src_step, layout, y, y_step, uv, uv + 1, uv_step, 2, width, height, cs);
+}
+
+void rgb_to_i420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                 uint8_t* v, size_t uv_step, int width, int height, ColorSpace cs)
+{
+    rgb_to_yuv420(src, src_step, layout, y, y_step, u, v, uv_step, 1, width, height, cs);
+}
+
+namespace ref {
+
+void yuv420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step,
+                   int uv_pixel_stride, uint8_t* dst, size_t dst_step, int width, int height, Layout layout,
+                   ColorSpace cs)
+{
+    const Decode& k = kDecode[cs];
+    const int cn = layout_channels(layout);
+    for (int j = 0; j < height; j++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const size_t c = (j / 2) * uv_step + (x / 2) * uv_pixel_stride;
+            decode_pixel(y[j * y_step + x], u[c], v[c], k, dst + j * dst_step + x * cn, layout);
+        }
+    }
+}
+
+void p010_to_rgb(const uint16_t* y, size_t y_step, const uint16_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs)
+{
+    const Decode k = p010_coeffs(cs);
+    const int cn = layout_channels(layout);
+    for (int j = 0; j < height; j++)
+    {
+        const uint16_t* y_row = row(y, y_step, j);
+        const uint16_t* uv_row = row(uv, uv_step, j / 2);
+        for (int x = 0; x < width; x++)
+        {
+            const int c = (x / 2) * 2;
+            decode_pixel(y_row[x] >> 6, uv_row[c] >> 6, uv_row[c + 1] >> 6, k, dst + j * dst_step + x * cn, layout);
+        }
+    }
+}
+
+void rgb_to_yuv420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                   uint8_t* v, size_t uv_step, int uv_pixel_stride, int width, int height, ColorSpace cs)
+{
+    const Encode& k = kEncode[cs];
+    for (int j = 0; j < height; j += 2)
+    {
+        const int j1 = std::min(j + 1, height - 1);
+        for (int x = 0; x < width; x += 2)
+        {
+            const size_t c = (j / 2) * uv_step + (x / 2) * uv_pixel_stride;
+            encode_block(src + j * src_step, src + j1 * src_step, x, std::min(x + 1, width - 1), layout, k,
+                         y + j * y_step, y + j1 * y_step, u + c, v + c);
+        }
+    }
+}
+
+void rgb_to_p010(const uint8_t* src, size_t src_step, Layout layout, uint16_t* y, size_t y_step, uint16_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs)
+{
+    const Encode& k = kEncode[cs];
+    for (int j = 0; j < height; j += 2)
+    {
+        const int j1 = std::min(j + 1, height - 1);
+        uint16_t* uv_row = row(uv, uv_step, j / 2);
+        for (int x = 0; x < width; x += 2)
+        {
+            encode_block(src + j * src_step, src + j1 * src_step, x, std::min(x + 1, width - 1), layout, k,
+                         row(y, y_step, j), row(y, y_step, j1), uv_row + x, uv_row + x + 1);
+        }
+    }
+}
+
+} // namespace ref
+
+} // namespace yuv
+} // namespace neon_sim_kernels
@@ -0,0 +1,118 @@
+#pragma once
+
+//
+// YUV 4:2:0 <-> RGB conversions written with NEON intrinsics, for the
+// camera formats: NV21 (Android default), NV12, I420 and P010 (10 bit), in
+// both directions.
+//
+// usage:
+// #include "neon_sim_yuv.hpp"
+//
+// yuv::nv21_to_rgb(y, width, vu, width, bgr, width * 3, width, height, yuv::LAYOUT_BGR, yuv::BT601_LIMITED);
+// yuv::rgb_to_nv21(rgba, width * 4, yuv::LAYOUT_RGBA, y, width, vu, width, width, height, yuv::BT709_FULL);
+//
+// Decoding follows OpenCV's cvtColor (COLOR_YUV2BGR_NV21 and friends):
+//   r = sat((max(0, Y - 16) * CY + CVR * (V - 128) + 2^19) >> 20), ...
+// with 20 bit coefficients. For BT601_LIMITED they are OpenCV's own
+// ITUR_BT_601_* constants, so the output is bit-exact with cvtColor; the
+// other color spaces use the same formula with their own matrices. The
+// coefficients do not fit 16 bit lanes, so the products are 32 bit
+// (vmulq_n_s32); chroma is deinterleaved with vld2_u8, computed once per
+// two pixels and two rows, and narrowed with vqrshrun_n_s32 / vqmovn_u16.
+//
+// Encoding has no OpenCV counterpart for the semi-planar formats; it uses
+// 14 bit coefficients (vmull_n_u16 for luma, vmull_n_s16 on 2x2 sums for
+// chroma) and averages each 2x2 block for U and V. Odd widths and heights
+// replicate the last column / row into the block.
+//
+// Every kernel has a scalar twin in `yuv::ref` that is bit-exact with it.
+// As in neon_sim_kernels.hpp, `*_step` is the row stride in bytes.
+//
+// As with neon_sim_kernels.hpp, the library does not define
+// NEON_SIM_IMPLEMENTATION on x86.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace neon_sim_kernels {
+namespace yuv {
+
+/// @brief the interleaved RGB side; alpha is written as 255
+enum Layout
+{
+    LAYOUT_BGR,
+    LAYOUT_RGB,
+    LAYOUT_BGRA,
+    LAYOUT_RGBA,
+};
+
+/// @brief matrix and range: limited is Y in [16, 235], UV in [16, 240]
+enum ColorSpace
+{
+    BT601_LIMITED,
+    BT601_FULL,
+    BT709_LIMITED,
+    BT709_FULL,
+};
+
+/// @brief 3 or 4
+int layout_channels(Layout layout);
+
+/// @brief any 4:2:0 layout. Sample i of a chroma row is u[i * uv_pixel_stride]
+/// (and the same for v): 1 for planar I420 / YV12, 2 for NV12 / NV21. Both
+/// chroma planes share uv_step.
+void yuv420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step,
+                   int uv_pixel_stride, uint8_t* dst, size_t dst_step, int width, int height, Layout layout,
+                   ColorSpace cs);
+
+/// @brief semi-planar, V first (Android camera)
+void nv21_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* vu, size_t vu_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs);
+
+/// @brief semi-planar, U first
+void nv12_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs);
+
+/// @brief planar Y, U, V
+void i420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step, uint8_t* dst,
+                 size_t dst_step, int width, int height, Layout layout, ColorSpace cs);
+
+/// @brief P010: NV12 with 16 bit samples holding 10 bits in the high bits,
+/// to 8 bit RGB. The coefficients are the 8 bit ones rounded to 18 bits, so
+/// 10 bit products stay within 32 bits.
+void p010_to_rgb(const uint16_t* y, size_t y_step, const uint16_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs);
+
+/// @brief RGB to any 4:2:0 layout, see yuv420_to_rgb for the chroma addressing
+void rgb_to_yuv420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                   uint8_t* v, size_t uv_step, int uv_pixel_stride, int width, int height, ColorSpace cs);
+
+void rgb_to_nv21(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* vu,
+                 size_t vu_step, int width, int height, ColorSpace cs);
+void rgb_to_nv12(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs);
+void rgb_to_i420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                 uint8_t* v, size_t uv_step, int width, int height, ColorSpace cs);
+
+/// @brief 8 bit RGB to P010: the 8 bit encode keeping two more bits, so the
+/// samples are about 4 times the NV12 ones before the shift into the high bits
+void rgb_to_p010(const uint8_t* src, size_t src_step, Layout layout, uint16_t* y, size_t y_step, uint16_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs);
+
+namespace ref {
+
+void yuv420_to_rgb(const uint8_t* y, size_t y_step, const uint8_t* u, const uint8_t* v, size_t uv_step,
+                   int uv_pixel_stride, uint8_t* dst, size_t dst_step, int width, int height, Layout layout,
+                   ColorSpace cs);
+void p010_to_rgb(const uint16_t* y, size_t y_step, const uint16_t* uv, size_t uv_step, uint8_t* dst, size_t dst_step,
+                 int width, int height, Layout layout, ColorSpace cs);
+void rgb_to_yuv420(const uint8_t* src, size_t src_step, Layout layout, uint8_t* y, size_t y_step, uint8_t* u,
+                   uint8_t* v, size_t uv_step, int uv_pixel_stride, int width, int height, ColorSpace cs);
+void rgb_to_p010(const uint8_t* src, size_t src_step, Layout layout, uint16_t* y, size_t y_step, uint16_t* uv,
+                 size_t uv_step, int width, int height, ColorSpace cs);
+
+} // namespace ref
+
+} // namespace yuv
+} // namespace neon_sim_kernels
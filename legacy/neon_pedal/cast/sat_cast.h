@@ -168,12 +168,12 @@ template<> inline uchar sat_cast<uchar>(uint64 v)       { return (uchar)std::min
 
 template<> inline schar sat_cast<schar>(uchar v)        { return (schar)std::min((int)v, SCHAR_MAX); }
 template<> inline schar sat_cast<schar>(ushort v)       { return (schar)std::min((unsigned)v, (unsigned)SCHAR_MAX); }
-template<> inline schar sat_cast<schar>(int v)          { return (schar)((unsigned)(v-SCHAR_MIN) <= (unsigned)UCHAR_MAX ? v : v > 0 ? SCHAR_MAX : SCHAR_MIN); }
+template<> inline schar sat_cast<schar>(int v)          { return (schar)((unsigned)v - (unsigned)SCHAR_MIN <= (unsigned)UCHAR_MAX ? v : v > 0 ? SCHAR_MAX : SCHAR_MIN); }
 template<> inline schar sat_cast<schar>(short v)        { return sat_cast<schar>((int)v); }
 template<> inline schar sat_cast<schar>(unsigned v)     { return (schar)std::min(v, (unsigned)SCHAR_MAX); }
 template<> inline schar sat_cast<schar>(float v)        { int iv = std::round(v); return sat_cast<schar>(iv); }
 template<> inline schar sat_cast<schar>(double v)       { int iv = std::round(v); return sat_cast<schar>(iv); }
-template<> inline schar sat_cast<schar>(int64 v)        { return (schar)((uint64)((int64)v-SCHAR_MIN) <= (uint64)UCHAR_MAX ? v : v > 0 ? SCHAR_MAX : SCHAR_MIN); }
+template<> inline schar sat_cast<schar>(int64 v)        { return (schar)((uint64)v - (uint64)SCHAR_MIN <= (uint64)UCHAR_MAX ? v : v > 0 ? SCHAR_MAX : SCHAR_MIN); }
 template<> inline schar sat_cast<schar>(uint64 v)       { return (schar)std::min(v, (uint64)SCHAR_MAX); }
 
 template<> inline ushort sat_cast<ushort>(schar v)      { return (ushort)std::max((int)v, 0); }
@@ -186,15 +186,15 @@ template<> inline ushort sat_cast<ushort>(int64 v)      { return (ushort)((uint6
 template<> inline ushort sat_cast<ushort>(uint64 v)     { return (ushort)std::min(v, (uint64)USHRT_MAX); }
 
 template<> inline short sat_cast<short>(ushort v)       { return (short)std::min((int)v, SHRT_MAX); }
-template<> inline short sat_cast<short>(int v)          { return (short)((unsigned)(v - SHRT_MIN) <= (unsigned)USHRT_MAX ? v : v > 0 ? SHRT_MAX : SHRT_MIN); }
+template<> inline short sat_cast<short>(int v)          { return (short)((unsigned)v - (unsigned)SHRT_MIN <= (unsigned)USHRT_MAX ? v : v > 0 ? SHRT_MAX : SHRT_MIN); }
 template<> inline short sat_cast<short>(unsigned v)     { return (short)std::min(v, (unsigned)SHRT_MAX); }
 template<> inline short sat_cast<short>(float v)        { int iv = std::round(v); return sat_cast<short>(iv); }
 template<> inline short sat_cast<short>(double v)       { int iv = std::round(v); return sat_cast<short>(iv); }
-template<> inline short sat_cast<short>(int64 v)        { return (short)((uint64)((int64)v - SHRT_MIN) <= (uint64)USHRT_MAX ? v : v > 0 ? SHRT_MAX : SHRT_MIN); }
+template<> inline short sat_cast<short>(int64 v)        { return (short)((uint64)v - (uint64)SHRT_MIN <= (uint64)USHRT_MAX ? v : v > 0 ? SHRT_MAX : SHRT_MIN); }
 template<> inline short sat_cast<short>(uint64 v)       { return (short)std::min(v, (uint64)SHRT_MAX); }
 
 template<> inline int sat_cast<int>(unsigned v)         { return (int)std::min(v, (unsigned)INT_MAX); }
-template<> inline int sat_cast<int>(int64 v)            { return (int)((uint64)(v - INT_MIN) <= (uint64)UINT_MAX ? v : v > 0 ? INT_MAX : INT_MIN); }
+template<> inline int sat_cast<int>(int64 v)            { return (int)((uint64)v - (uint64)INT_MIN <= (uint64)UINT_MAX ? v : v > 0 ? INT_MAX : INT_MIN); }
 template<> inline int sat_cast<int>(uint64 v)           { return (int)std::min(v, (uint64)INT_MAX); }
 template<> inline int sat_cast<int>(float v)            { return std::round(v); }
 template<> inline int sat_cast<int>(double v)           { return std::round(v); }
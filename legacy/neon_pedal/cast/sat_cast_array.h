@@ -0,0 +1,426 @@
+#ifndef SAT_CAST_ARRAY_H
+#define SAT_CAST_ARRAY_H
+
+/**
+ * 提供了批量版本的 sat_cast, 逐元素结果和 sat_cast.h 中的标量 sat_cast<Tp>(v) 一致:
+ *
+ *   sat_cast<Dst>(const Src* src, Dst* dst, size_t n);                  // 连续数组
+ *   sat_cast<Dst>(const Src* src, size_t src_step, Dst* dst, size_t dst_step,
+ *                 size_t width, size_t height);                          // 带 stride 的二维 buffer
+ *
+ * width 是每行的元素个数(已包含通道), step 是每行字节数。
+ *
+ * - <= 32 bit 的整数之间: 在 int64 中 clamp, 无分支
+ * - float/double 到 uchar/schar/ushort/short/int/unsigned: 先 clamp 再 round-half-away-from-zero
+ *   (与 std::round 一致), 无分支
+ * - 常用的图像类型组合有 SSE2 / aarch64 NEON 实现
+ *   (float->uchar/short/ushort, int->uchar/short, short->uchar, ushort->uchar)
+ * - 其余组合逐元素调用标量 sat_cast
+ *
+ * 注意: 标量版本对 NaN 和超出 int 范围的浮点数是未定义行为(依赖平台的 float->int 转换);
+ * 批量版本对超出范围的值做饱和, NaN 的结果未指定。
+ */
+
+#include "sat_cast.h"
+#include <stddef.h>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SAT_CAST_USE_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(NEON_SIM_IMPLEMENTATION)
+#include <arm_neon.h>
+#define SAT_CAST_USE_NEON 1
+#endif
+
+namespace sat_cast_detail {
+
+template<typename T>
+struct is_int32_or_narrower
+{
+    static const bool value = std::is_integral<T>::value && sizeof(T) <= 4;
+};
+
+enum Kind
+{
+    KIND_SCALAR,      // fall back to the scalar sat_cast
+    KIND_CLAMP_INT,   // integer -> integer, both <= 32 bit
+    KIND_ROUND_FLOAT, // float/double -> integer, both <= 32 bit
+};
+
+template<typename Dst, typename Src>
+struct kind_of
+{
+    static const Kind value =
+        (is_int32_or_narrower<Src>::value && is_int32_or_narrower<Dst>::value) ? KIND_CLAMP_INT :
+        (std::is_floating_point<Src>::value && is_int32_or_narrower<Dst>::value) ? KIND_ROUND_FLOAT :
+        KIND_SCALAR;
+};
+
+template<typename Dst, typename Src, Kind K = kind_of<Dst, Src>::value>
+struct Row;
+
+template<typename Dst, typename Src>
+struct Row<Dst, Src, KIND_SCALAR>
+{
+    static inline void run(const Src* src, Dst* dst, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            dst[i] = sat_cast<Dst>(src[i]);
+        }
+    }
+};
+
+template<typename Dst, typename Src>
+struct Row<Dst, Src, KIND_CLAMP_INT>
+{
+    static inline void run(const Src* src, Dst* dst, size_t n)
+    {
+        // narrow types clamp in int32 so the loop vectorizes with 4 lanes or more
+        typedef typename std::conditional<(sizeof(Src) < 4 && sizeof(Dst) < 4), int, int64>::type wide_t;
+        const wide_t lo = (wide_t)std::numeric_limits<Dst>::min();
+        const wide_t hi = (wide_t)std::numeric_limits<Dst>::max();
+        for (size_t i = 0; i < n; i++)
+        {
+            wide_t v = (wide_t)src[i];
+            v = v < lo ? lo : v;
+            v = v > hi ? hi : v;
+            dst[i] = (Dst)v;
+        }
+    }
+};
+
+// sat_cast<unsigned>(float) wraps negative values (see sat_cast.h), so it is
+// computed as an int and reinterpreted; every other destination is clamped.
+template<typename Dst, typename Src>
+struct Row<Dst, Src, KIND_ROUND_FLOAT>
+{
+    typedef typename std::conditional<std::is_same<Dst, unsigned>::value, int, Dst>::type sat_t;
+
+    static inline void run(const Src* src, Dst* dst, size_t n)
+    {
+        // for int, hi is the largest Src value that still converts without overflow
+        const bool is_int = sizeof(sat_t) == 4;
+        const Src lo = (Src)std::numeric_limits<sat_t>::min();
+        const Src hi = !is_int ? (Src)std::numeric_limits<sat_t>::max()
+                               : (Src)(std::is_same<Src, float>::value ? 2147483520.0 : 2147483647.0);
+        const Src int_overflow = (Src)2147483648.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            Src v = src[i];
+            v = v > lo ? v : lo; // NaN -> lo
+            v = v < hi ? v : hi;
+            int iv = (int)v;
+            const Src frac = v - (Src)iv;
+            iv += (frac >= (Src)0.5) - (frac <= (Src)-0.5);
+            iv = (is_int && src[i] >= int_overflow) ? INT_MAX : iv;
+            dst[i] = (Dst)(sat_t)iv;
+        }
+    }
+};
+
+template<typename Dst, typename Src>
+struct Simd
+{
+    // number of elements handled, the tail is left to Row<>
+    static inline size_t run(const Src*, Dst*, size_t)
+    {
+        return 0;
+    }
+};
+
+#if SAT_CAST_USE_SSE2
+// v -> round-half-away(clamp(v, lo, hi)) as int32
+static inline __m128i round_clamp_ps(__m128 v, __m128 lo, __m128 hi)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 neg_half = _mm_set1_ps(-0.5f);
+    v = _mm_min_ps(_mm_max_ps(v, lo), hi); // maxps returns lo for NaN
+    __m128i iv = _mm_cvttps_epi32(v);
+    const __m128 frac = _mm_sub_ps(v, _mm_cvtepi32_ps(iv));
+    iv = _mm_sub_epi32(iv, _mm_castps_si128(_mm_cmpge_ps(frac, half)));
+    iv = _mm_add_epi32(iv, _mm_castps_si128(_mm_cmple_ps(frac, neg_half)));
+    return iv;
+}
+
+template<>
+struct Simd<uchar, float>
+{
+    static inline size_t run(const float* src, uchar* dst, size_t n)
+    {
+        const __m128 lo = _mm_set1_ps(0.f);
+        const __m128 hi = _mm_set1_ps(255.f);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i a = round_clamp_ps(_mm_loadu_ps(src + i), lo, hi);
+            __m128i b = round_clamp_ps(_mm_loadu_ps(src + i + 4), lo, hi);
+            __m128i c = round_clamp_ps(_mm_loadu_ps(src + i + 8), lo, hi);
+            __m128i d = round_clamp_ps(_mm_loadu_ps(src + i + 12), lo, hi);
+            __m128i ab = _mm_packs_epi32(a, b);
+            __m128i cd = _mm_packs_epi32(c, d);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(ab, cd));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<short, float>
+{
+    static inline size_t run(const float* src, short* dst, size_t n)
+    {
+        const __m128 lo = _mm_set1_ps(-32768.f);
+        const __m128 hi = _mm_set1_ps(32767.f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = round_clamp_ps(_mm_loadu_ps(src + i), lo, hi);
+            __m128i b = round_clamp_ps(_mm_loadu_ps(src + i + 4), lo, hi);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<ushort, float>
+{
+    static inline size_t run(const float* src, ushort* dst, size_t n)
+    {
+        // SSE2 has no packus_epi32: bias into the signed range, pack, unbias
+        const __m128 lo = _mm_set1_ps(0.f);
+        const __m128 hi = _mm_set1_ps(65535.f);
+        const __m128i bias32 = _mm_set1_epi32(32768);
+        const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_sub_epi32(round_clamp_ps(_mm_loadu_ps(src + i), lo, hi), bias32);
+            __m128i b = _mm_sub_epi32(round_clamp_ps(_mm_loadu_ps(src + i + 4), lo, hi), bias32);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(_mm_packs_epi32(a, b), bias16));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, int>
+{
+    static inline size_t run(const int* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            __m128i c = _mm_loadu_si128((const __m128i*)(src + i + 8));
+            __m128i d = _mm_loadu_si128((const __m128i*)(src + i + 12));
+            __m128i ab = _mm_packs_epi32(a, b);
+            __m128i cd = _mm_packs_epi32(c, d);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(ab, cd));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<short, int>
+{
+    static inline size_t run(const int* src, short* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(a, b));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, short>
+{
+    static inline size_t run(const short* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, ushort>
+{
+    static inline size_t run(const ushort* src, uchar* dst, size_t n)
+    {
+        // min(v, 255) == v - subs_epu16(v, 255)
+        const __m128i max8 = _mm_set1_epi16(255);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+            a = _mm_sub_epi16(a, _mm_subs_epu16(a, max8));
+            b = _mm_sub_epi16(b, _mm_subs_epu16(b, max8));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+        }
+        return i;
+    }
+};
+#endif // SAT_CAST_USE_SSE2
+
+#if SAT_CAST_USE_NEON
+// vcvtaq rounds half away from zero, the same as std::round
+template<>
+struct Simd<uchar, float>
+{
+    static inline size_t run(const float* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            int32x4_t a = vcvtaq_s32_f32(vld1q_f32(src + i));
+            int32x4_t b = vcvtaq_s32_f32(vld1q_f32(src + i + 4));
+            int32x4_t c = vcvtaq_s32_f32(vld1q_f32(src + i + 8));
+            int32x4_t d = vcvtaq_s32_f32(vld1q_f32(src + i + 12));
+            int16x8_t ab = vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+            int16x8_t cd = vcombine_s16(vqmovn_s32(c), vqmovn_s32(d));
+            vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(ab), vqmovun_s16(cd)));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<short, float>
+{
+    static inline size_t run(const float* src, short* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            int32x4_t a = vcvtaq_s32_f32(vld1q_f32(src + i));
+            int32x4_t b = vcvtaq_s32_f32(vld1q_f32(src + i + 4));
+            vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<ushort, float>
+{
+    static inline size_t run(const float* src, ushort* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            int32x4_t a = vcvtaq_s32_f32(vld1q_f32(src + i));
+            int32x4_t b = vcvtaq_s32_f32(vld1q_f32(src + i + 4));
+            vst1q_u16(dst + i, vcombine_u16(vqmovun_s32(a), vqmovun_s32(b)));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, int>
+{
+    static inline size_t run(const int* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            uint16x4_t a = vqmovun_s32(vld1q_s32(src + i));
+            uint16x4_t b = vqmovun_s32(vld1q_s32(src + i + 4));
+            vst1_u8(dst + i, vqmovn_u16(vcombine_u16(a, b)));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<short, int>
+{
+    static inline size_t run(const int* src, short* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            int16x4_t a = vqmovn_s32(vld1q_s32(src + i));
+            int16x4_t b = vqmovn_s32(vld1q_s32(src + i + 4));
+            vst1q_s16(dst + i, vcombine_s16(a, b));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, short>
+{
+    static inline size_t run(const short* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x8_t a = vqmovun_s16(vld1q_s16(src + i));
+            uint8x8_t b = vqmovun_s16(vld1q_s16(src + i + 8));
+            vst1q_u8(dst + i, vcombine_u8(a, b));
+        }
+        return i;
+    }
+};
+
+template<>
+struct Simd<uchar, ushort>
+{
+    static inline size_t run(const ushort* src, uchar* dst, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x8_t a = vqmovn_u16(vld1q_u16(src + i));
+            uint8x8_t b = vqmovn_u16(vld1q_u16(src + i + 8));
+            vst1q_u8(dst + i, vcombine_u8(a, b));
+        }
+        return i;
+    }
+};
+#endif // SAT_CAST_USE_NEON
+
+} // namespace sat_cast_detail
+
+template<typename Dst, typename Src>
+static inline void sat_cast(const Src* src, Dst* dst, size_t n)
+{
+    const size_t done = sat_cast_detail::Simd<Dst, Src>::run(src, dst, n);
+    sat_cast_detail::Row<Dst, Src>::run(src + done, dst + done, n - done);
+}
+
+template<typename Dst, typename Src>
+static inline void sat_cast(const Src* src, size_t src_step, Dst* dst, size_t dst_step, size_t width, size_t height)
+{
+    if (src_step == width * sizeof(Src) && dst_step == width * sizeof(Dst))
+    {
+        sat_cast<Dst>(src, dst, width * height);
+        return;
+    }
+    for (size_t y = 0; y < height; y++)
+    {
+        const Src* s = (const Src*)((const uchar*)src + y * src_step);
+        Dst* d = (Dst*)((uchar*)dst + y * dst_step);
+        sat_cast<Dst>(s, d, width);
+    }
+}
+
+#endif // SAT_CAST_ARRAY_H
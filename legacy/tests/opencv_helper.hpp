@@ -19,6 +19,7 @@
 #include <opencv2/core/core_c.h>  // cvarrToMat
 #include <iostream>
 #include <string>
+#include "neon_sim_compare.hpp"
 
 namespace och {
 
@@ -162,15 +163,16 @@ static bool almostEqual(const cv::Mat& expected, const cv::Mat& actual, double e
         return false;
     }
 
-    const int height = expected.rows;
-    const int cn = expected.channels();
-    for (int y = 0; y < height; ++y)
+    // 整幅图一次比较（带 stride），只对出错的行逐元素统计
+    CompareTolerance tol;
+    tol.abs_eps = eps;
+    const CompareResult res = compare_image<T>(expected.ptr<T>(), expected.step, actual.ptr<T>(), actual.step,
+                                               expected.rows, expected.cols, expected.channels(), tol);
+    if (!res.ok())
     {
-        auto res = assertAlmostEqual<T, PT>(expected.ptr(y), actual.ptr(y), y, expected.cols, cn, eps);
-        if (!res)
-            return res;
+        std::cerr << res << ", EPS = " << eps << std::endl;
     }
-    return true;
+    return res.ok();
 }
 
 static bool almostEqual(const cv::Mat& expected, const cv::Mat& actual, double eps = 0)
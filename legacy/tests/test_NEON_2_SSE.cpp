@@ -2,7 +2,7 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #else
-#include "NEON_2_SSE.h"
+#include "../../src/NEON_2_SSE.h"
 #endif
 
 int main()
@@ -0,0 +1,172 @@
+#pragma once
+
+//
+// arm_acle.h companion of arm_neon_sim.hpp: the CRC32 / CRC32C intrinsics,
+// so checksum code written against __crc32cd and friends runs off-device.
+//
+// usage:
+// #if __ARM_FEATURE_CRC32
+// #include <arm_acle.h>
+// #else
+// #include "arm_acle_sim.hpp"
+// #endif
+//
+// uint32_t crc = 0xffffffff;
+// for (; n >= 8; n -= 8, p += 8)
+// {
+//     uint64_t v;
+//     memcpy(&v, p, 8);
+//     crc = __crc32cd(crc, v);
+// }
+// ...
+// crc = ~crc;
+//
+// As on hardware the intrinsics neither invert the input nor the result, and
+// the data is taken LSB first (reflected). __crc32* use the IEEE 802.3
+// polynomial 0x04C11DB7, __crc32c* the Castagnoli polynomial 0x1EDC6F41.
+//
+// __crc32c* run on the SSE4.2 crc32 instruction when __SSE4_2__ is defined
+// (-DNEON_SIM_CRC32=ON adds -msse4.2 to the neon_sim target). Everything else
+// uses byte tables, slicing-by-8 for the 64-bit forms. x86 has no instruction
+// for the IEEE polynomial; a per-call PCLMULQDQ Barrett reduction is slower
+// than slicing-by-8 for these serially dependent one-word updates, so
+// carry-less folding is left to whole-buffer code (see bench_poly.cpp).
+//
+// Header only, no NEON_SIM_IMPLEMENTATION part.
+//
+
+#include <stdint.h>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif // __SSE4_2__
+
+#define __ARM_FEATURE_CRC32 1
+
+namespace neon_sim_crc {
+
+// reflected byte tables for the reflected polynomial poly; t[k][i] is byte i
+// followed by k zero bytes, for slicing-by-8 in the 64-bit forms
+struct Table
+{
+    uint32_t t[8][256];
+    explicit Table(uint32_t poly)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? poly ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (int k = 1; k < 8; k++)
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                t[k][i] = t[0][t[k - 1][i] & 0xff] ^ (t[k - 1][i] >> 8);
+            }
+        }
+    }
+};
+
+inline const Table& crc32_table()
+{
+    static const Table table(0xedb88320u);
+    return table;
+}
+
+inline const Table& crc32c_table()
+{
+    static const Table table(0x82f63b78u);
+    return table;
+}
+
+template <int Bytes>
+inline uint32_t update(const Table& table, uint32_t crc, uint64_t data)
+{
+    for (int i = 0; i < Bytes; i++)
+    {
+        crc = table.t[0][(crc ^ (uint32_t)(data >> (8 * i))) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+template <>
+inline uint32_t update<8>(const Table& table, uint32_t crc, uint64_t data)
+{
+    const uint64_t x = data ^ crc;
+    uint32_t r = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        r ^= table.t[7 - i][(x >> (8 * i)) & 0xff];
+    }
+    return r;
+}
+
+} // namespace neon_sim_crc
+
+//----------------------------------------------------------------------
+// CRC32, polynomial 0x04C11DB7
+//----------------------------------------------------------------------
+inline uint32_t __crc32b(uint32_t a, uint8_t b)
+{
+    return neon_sim_crc::update<1>(neon_sim_crc::crc32_table(), a, b);
+}
+
+inline uint32_t __crc32h(uint32_t a, uint16_t b)
+{
+    return neon_sim_crc::update<2>(neon_sim_crc::crc32_table(), a, b);
+}
+
+inline uint32_t __crc32w(uint32_t a, uint32_t b)
+{
+    return neon_sim_crc::update<4>(neon_sim_crc::crc32_table(), a, b);
+}
+
+inline uint32_t __crc32d(uint32_t a, uint64_t b)
+{
+    return neon_sim_crc::update<8>(neon_sim_crc::crc32_table(), a, b);
+}
+
+//----------------------------------------------------------------------
+// CRC32C, polynomial 0x1EDC6F41
+//----------------------------------------------------------------------
+inline uint32_t __crc32cb(uint32_t a, uint8_t b)
+{
+#if defined(__SSE4_2__)
+    return _mm_crc32_u8(a, b);
+#else
+    return neon_sim_crc::update<1>(neon_sim_crc::crc32c_table(), a, b);
+#endif // __SSE4_2__
+}
+
+inline uint32_t __crc32ch(uint32_t a, uint16_t b)
+{
+#if defined(__SSE4_2__)
+    return _mm_crc32_u16(a, b);
+#else
+    return neon_sim_crc::update<2>(neon_sim_crc::crc32c_table(), a, b);
+#endif // __SSE4_2__
+}
+
+inline uint32_t __crc32cw(uint32_t a, uint32_t b)
+{
+#if defined(__SSE4_2__)
+    return _mm_crc32_u32(a, b);
+#else
+    return neon_sim_crc::update<4>(neon_sim_crc::crc32c_table(), a, b);
+#endif // __SSE4_2__
+}
+
+inline uint32_t __crc32cd(uint32_t a, uint64_t b)
+{
+#if defined(__SSE4_2__) && defined(__x86_64__)
+    return (uint32_t)_mm_crc32_u64(a, b);
+#elif defined(__SSE4_2__)
+    return _mm_crc32_u32(_mm_crc32_u32(a, (uint32_t)b), (uint32_t)(b >> 32));
+#else
+    return neon_sim_crc::update<8>(neon_sim_crc::crc32c_table(), a, b);
+#endif // __SSE4_2__
+}
@@ -168,6 +168,44 @@ using float16x8_t = TxN<__fp16, 8>;
 using float32x4_t = TxN<float, 4>;
 using float64x2_t = TxN<double, 2>;
 
+// Polynomial registers. The poly scalars are the unsigned integers, as in
+// clang's arm_neon.h; the register lanes wrap them in PolyLane so that
+// poly8x8_t and uint8x8_t are different types, as on the hardware.
+typedef uint8_t poly8_t;
+typedef uint16_t poly16_t;
+typedef uint64_t poly64_t;
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 poly128_t;
+#endif // __SIZEOF_INT128__
+
+/// @brief lane of a polynomial register: the bits of U, converting to and from U.
+/// Trivial like the integer lanes, so registers can still be copied with memcpy.
+template<class U>
+struct PolyLane
+{
+    U bits;
+
+    PolyLane() = default;
+    PolyLane(U v) : bits(v) {}
+
+    operator U() const
+    {
+        return bits;
+    }
+
+    friend std::ostream& operator <<(std::ostream& os, const PolyLane& p)
+    {
+        return os << +p.bits;
+    }
+};
+
+using poly8x8_t = TxN<PolyLane<poly8_t>, 8>;
+using poly16x4_t = TxN<PolyLane<poly16_t>, 4>;
+using poly64x1_t = TxN<PolyLane<poly64_t>, 1>;
+using poly8x16_t = TxN<PolyLane<poly8_t>, 16>;
+using poly16x8_t = TxN<PolyLane<poly16_t>, 8>;
+using poly64x2_t = TxN<PolyLane<poly64_t>, 2>;
+
 
 //-------
 //vector register array types
@@ -478,6 +516,10 @@ uint32x4_t	vld1q_u32	(uint32_t const * ptr);
 uint64x2_t	vld1q_u64	(uint64_t const * ptr);
 float32x4_t	vld1q_f32	(float32_t const * ptr);
 float64x2_t	vld1q_f64	(float64_t const * ptr);
+poly8x8_t	vld1_p8	(poly8_t const * ptr);
+poly8x16_t	vld1q_p8	(poly8_t const * ptr);
+poly16x8_t	vld1q_p16	(poly16_t const * ptr);
+poly64x2_t	vld1q_p64	(poly64_t const * ptr);
 
 // vld1_lane_type
 int8x8_t	vld1_lane_s8	(int8_t const * ptr, int8x8_t src, const int lane);
@@ -730,6 +772,10 @@ void	vst1q_u32	(uint32_t * ptr, uint32x4_t val);
 void	vst1q_u64	(uint64_t * ptr, uint64x2_t val);
 void	vst1q_f32	(float32_t * ptr, float32x4_t val);
 void	vst1q_f64	(float64_t * ptr, float64x2_t val);
+void	vst1_p8	(poly8_t * ptr, poly8x8_t val);
+void	vst1q_p8	(poly8_t * ptr, poly8x16_t val);
+void	vst1q_p16	(poly16_t * ptr, poly16x8_t val);
+void	vst1q_p64	(poly64_t * ptr, poly64x2_t val);
 
 // vst1_lane_type
 void	vst1_lane_s8	(int8_t * ptr, int8x8_t val, const int lane);
@@ -1210,6 +1256,7 @@ int64x1_t	vdup_n_s64	(int64_t value);
 uint8x8_t	vdup_n_u8	(uint8_t value);
 uint16x4_t	vdup_n_u16	(uint16_t value);
 uint32x2_t	vdup_n_u32	(uint32_t value);
+poly8x8_t	vdup_n_p8	(poly8_t value);
 uint64x1_t	vdup_n_u64	(uint64_t value);
 float32x2_t	vdup_n_f32	(float32_t value);
 float64x1_t	vdup_n_f64	(float64_t value);
@@ -1235,6 +1282,8 @@ uint16x8_t	vdupq_n_u16	(uint16_t value);
 uint32x4_t	vdupq_n_u32	(uint32_t value);
 uint64x2_t	vdupq_n_u64	(uint64_t value);
 float32x4_t	vdupq_n_f32	(float32_t value);
+poly8x16_t	vdupq_n_p8	(poly8_t value);
+poly64x2_t	vdupq_n_p64	(poly64_t value);
 float64x2_t	vdupq_n_f64	(float64_t value);
 
 // vmovq_n_type:
@@ -1724,6 +1773,9 @@ int32_t	vgetq_lane_s32	(int32x4_t v, const int lane);
 int64_t	vgetq_lane_s64	(int64x2_t v, const int lane);
 float32_t	vgetq_lane_f32	(float32x4_t v, const int lane);
 float64_t	vgetq_lane_f64	(float64x2_t v, const int lane);
+poly8_t	vgetq_lane_p8	(poly8x16_t v, const int lane);
+poly16_t	vgetq_lane_p16	(poly16x8_t v, const int lane);
+poly64_t	vgetq_lane_p64	(poly64x2_t v, const int lane);
 
 // vset_lane_type:
 uint8x8_t	vset_lane_u8	(uint8_t a, uint8x8_t v, const int lane);
@@ -1946,6 +1998,7 @@ uint32x4_t	vcombine_u32	(uint32x2_t low, uint32x2_t high);
 uint64x2_t	vcombine_u64	(uint64x1_t low, uint64x1_t high);
 float32x4_t	vcombine_f32	(float32x2_t low, float32x2_t high);
 float64x2_t	vcombine_f64	(float64x1_t low, float64x1_t high);
+poly8x16_t	vcombine_p8	(poly8x8_t low, poly8x8_t high);
 
 // vbsl_type:
 int8x8_t	vbsl_s8	(uint8x8_t a, int8x8_t b, int8x8_t c);
@@ -2238,6 +2291,22 @@ uint8x16_t	vreinterpretq_u8_f16	(float16x8_t a);
 #endif // __fp16
 uint8x16_t	vreinterpretq_u8_f64	(float64x2_t a);
 
+// vreinterpretq between the poly and unsigned registers
+poly8x16_t	vreinterpretq_p8_u8	(uint8x16_t a);
+uint8x16_t	vreinterpretq_u8_p8	(poly8x16_t a);
+poly16x8_t	vreinterpretq_p16_u16	(uint16x8_t a);
+uint16x8_t	vreinterpretq_u16_p16	(poly16x8_t a);
+poly64x2_t	vreinterpretq_p64_u64	(uint64x2_t a);
+uint64x2_t	vreinterpretq_u64_p64	(poly64x2_t a);
+poly64x2_t	vreinterpretq_p64_u8	(uint8x16_t a);
+uint8x16_t	vreinterpretq_u8_p64	(poly64x2_t a);
+#if defined(__SIZEOF_INT128__)
+uint8x16_t	vreinterpretq_u8_p128	(poly128_t a);
+uint64x2_t	vreinterpretq_u64_p128	(poly128_t a);
+poly128_t	vreinterpretq_p128_u8	(uint8x16_t a);
+poly128_t	vreinterpretq_p128_u64	(uint64x2_t a);
+#endif // __SIZEOF_INT128__
+
 // vreinterpretq_u16_type
 uint16x8_t	vreinterpretq_u16_s8	(int8x16_t a);
 uint16x8_t	vreinterpretq_u16_s16	(int16x8_t a);
@@ -2428,6 +2497,27 @@ uint16x8_t	vmull_u8	(uint8x8_t a, uint8x8_t b);
 uint32x4_t	vmull_u16	(uint16x4_t a, uint16x4_t b);
 uint64x2_t	vmull_u32	(uint32x2_t a, uint32x2_t b);
 
+// vmul_p8 / vmull_p8 / vmull_p64: carry-less (polynomial over GF(2)) multiply
+poly8x8_t	vmul_p8	(poly8x8_t a, poly8x8_t b);
+poly8x16_t	vmulq_p8	(poly8x16_t a, poly8x16_t b);
+poly16x8_t	vmull_p8	(poly8x8_t a, poly8x8_t b);
+poly16x8_t	vmull_high_p8	(poly8x16_t a, poly8x16_t b);
+#if defined(__SIZEOF_INT128__)
+poly128_t	vmull_p64	(poly64_t a, poly64_t b);
+poly128_t	vmull_high_p64	(poly64x2_t a, poly64x2_t b);
+#endif // __SIZEOF_INT128__
+
+// vadd_p*: polynomial addition is xor
+poly8x8_t	vadd_p8	(poly8x8_t a, poly8x8_t b);
+poly8x16_t	vaddq_p8	(poly8x16_t a, poly8x16_t b);
+poly16x4_t	vadd_p16	(poly16x4_t a, poly16x4_t b);
+poly16x8_t	vaddq_p16	(poly16x8_t a, poly16x8_t b);
+poly64x1_t	vadd_p64	(poly64x1_t a, poly64x1_t b);
+poly64x2_t	vaddq_p64	(poly64x2_t a, poly64x2_t b);
+#if defined(__SIZEOF_INT128__)
+poly128_t	vaddq_p128	(poly128_t a, poly128_t b);
+#endif // __SIZEOF_INT128__
+
 // vmull_n_type:
 int32x4_t	vmull_n_s16	(int16x4_t a, int16_t b);
 int64x2_t	vmull_n_s32	(int32x2_t a, int32_t b);
@@ -2679,8 +2769,26 @@ int64x2_t	vmlsl_lane_s32	(int64x2_t a, int32x2_t b, int32x2_t v, const int lane)
 uint32x4_t	vmlsl_lane_u16	(uint32x4_t a, uint16x4_t b, uint16x4_t v, const int lane);
 uint64x2_t	vmlsl_lane_u32	(uint64x2_t a, uint32x2_t b, uint32x2_t v, const int lane);
 
+// vfma_type: ri = ai + bi * ci, fused: the product is not rounded before the add
+float32x2_t	vfma_f32	(float32x2_t a, float32x2_t b, float32x2_t c);
+float64x1_t	vfma_f64	(float64x1_t a, float64x1_t b, float64x1_t c);
+
+// vfmaq_type:
+float32x4_t	vfmaq_f32	(float32x4_t a, float32x4_t b, float32x4_t c);
+float64x2_t	vfmaq_f64	(float64x2_t a, float64x2_t b, float64x2_t c);
+
+// vfmaq_lane_type: ri = ai + bi * v[lane], fused
+float32x4_t	vfmaq_lane_f32	(float32x4_t a, float32x4_t b, float32x2_t v, const int lane);
+float32x4_t	vfmaq_laneq_f32	(float32x4_t a, float32x4_t b, float32x4_t v, const int lane);
+float32x4_t	vfmaq_n_f32	(float32x4_t a, float32x4_t b, float32_t n);
+
 // vfms_f32:ri = ai - bi * ci 在减法之前,bi、ci 相乘的结果不会被四舍五入
 float32x2_t	vfms_f32	(float32x2_t a, float32x2_t b, float32x2_t c);
+float64x1_t	vfms_f64	(float64x1_t a, float64x1_t b, float64x1_t c);
+
+// vfmsq_type:
+float32x4_t	vfmsq_f32	(float32x4_t a, float32x4_t b, float32x4_t c);
+float64x2_t	vfmsq_f64	(float64x2_t a, float64x2_t b, float64x2_t c);
 
 // vqdmlsl_type: ri = sat(ai – 2 * bi * ci) bi/ci 的元素大小是 ai 的一半
 int32x4_t	vqdmlsl_s16	(int32x4_t a, int16x4_t b, int16x4_t c);
@@ -3158,6 +3266,22 @@ int16x8_t	vqabsq_s16	(int16x8_t a);
 int32x4_t	vqabsq_s32	(int32x4_t a);
 int64x2_t	vqabsq_s64	(int64x2_t a);
 
+// vneg_type: ri = -ai
+int8x8_t	vneg_s8	(int8x8_t a);
+int16x4_t	vneg_s16	(int16x4_t a);
+int32x2_t	vneg_s32	(int32x2_t a);
+float32x2_t	vneg_f32	(float32x2_t a);
+int64x1_t	vneg_s64	(int64x1_t a);
+float64x1_t	vneg_f64	(float64x1_t a);
+
+// vnegq_type:
+int8x16_t	vnegq_s8	(int8x16_t a);
+int16x8_t	vnegq_s16	(int16x8_t a);
+int32x4_t	vnegq_s32	(int32x4_t a);
+float32x4_t	vnegq_f32	(float32x4_t a);
+int64x2_t	vnegq_s64	(int64x2_t a);
+float64x2_t	vnegq_f64	(float64x2_t a);
+
 // vabd_type: ri = |ai - bi|
 int8x8_t	vabd_s8	(int8x8_t a, int8x8_t b);
 int16x4_t	vabd_s16	(int16x4_t a, int16x4_t b);
@@ -3372,7 +3496,7 @@ int32x2_t	vmvn_s32	(int32x2_t a);
 uint8x8_t	vmvn_u8	(uint8x8_t a);
 uint16x4_t	vmvn_u16	(uint16x4_t a);
 uint32x2_t	vmvn_u32	(uint32x2_t a);
-//poly8x8_t	vmvn_p8	(poly8x8_t a)
+poly8x8_t	vmvn_p8	(poly8x8_t a);
 // vmvnq_type
 int8x16_t	vmvnq_s8	(int8x16_t a);
 int16x8_t	vmvnq_s16	(int16x8_t a);
@@ -3380,7 +3504,7 @@ int32x4_t	vmvnq_s32	(int32x4_t a);
 uint8x16_t	vmvnq_u8	(uint8x16_t a);
 uint16x8_t	vmvnq_u16	(uint16x8_t a);
 uint32x4_t	vmvnq_u32	(uint32x4_t a);
-//poly8x16_t	vmvnq_p8	(poly8x16_t a);
+poly8x16_t	vmvnq_p8	(poly8x16_t a);
 
 
 // Vector arithmetic / Division
@@ -3397,14 +3521,296 @@ float64x2_t	vdivq_f64	(float64x2_t a, float64x2_t b);
 #if __fp16
 float16x8_t	vdivq_f16	(float16x8_t a, float16x8_t b);
 #endif // __fp16
+
+// Vector arithmetic / Square root
+// vsqrt_type
+float32x2_t	vsqrt_f32	(float32x2_t a);
+float64x1_t	vsqrt_f64	(float64x1_t a);
+#if __fp16
+float16x4_t	vsqrt_f16	(float16x4_t a);
+#endif // __fp16
+// vsqrtq_type
+float32x4_t	vsqrtq_f32	(float32x4_t a);
+float64x2_t	vsqrtq_f64	(float64x2_t a);
+#if __fp16
+float16x8_t	vsqrtq_f16	(float16x8_t a);
+#endif // __fp16
 #endif // __aarch64__
 
+//----------------------------------------------------------------------
+// 18. Cryptography
+//----------------------------------------------------------------------
+#define __ARM_FEATURE_CRYPTO 1
+#define __ARM_FEATURE_AES 1
+#define __ARM_FEATURE_SHA2 1
+
+// AES single round steps; state and key bytes in FIPS-197 order, lane i = byte i
+// vaeseq: SubBytes(ShiftRows(data ^ key))
+uint8x16_t	vaeseq_u8	(uint8x16_t data, uint8x16_t key);
+// vaesdq: InvSubBytes(InvShiftRows(data ^ key))
+uint8x16_t	vaesdq_u8	(uint8x16_t data, uint8x16_t key);
+// vaesmcq: MixColumns
+uint8x16_t	vaesmcq_u8	(uint8x16_t data);
+// vaesimcq: InvMixColumns
+uint8x16_t	vaesimcq_u8	(uint8x16_t data);
+
+// SHA-1: four rounds with choose / parity / majority, wk = w + k
+uint32x4_t	vsha1cq_u32	(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk);
+uint32x4_t	vsha1pq_u32	(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk);
+uint32x4_t	vsha1mq_u32	(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk);
+// vsha1h: rotate left by 30
+uint32_t	vsha1h_u32	(uint32_t hash_e);
+// message schedule
+uint32x4_t	vsha1su0q_u32	(uint32x4_t w0_3, uint32x4_t w4_7, uint32x4_t w8_11);
+uint32x4_t	vsha1su1q_u32	(uint32x4_t tw0_3, uint32x4_t w12_15);
+
+// SHA-256: four rounds, h returns the new abcd, h2 the new efgh
+uint32x4_t	vsha256hq_u32	(uint32x4_t hash_abcd, uint32x4_t hash_efgh, uint32x4_t wk);
+uint32x4_t	vsha256h2q_u32	(uint32x4_t hash_efgh, uint32x4_t hash_abcd, uint32x4_t wk);
+// message schedule
+uint32x4_t	vsha256su0q_u32	(uint32x4_t w0_3, uint32x4_t w4_7);
+uint32x4_t	vsha256su1q_u32	(uint32x4_t tw0_3, uint32x4_t w8_11, uint32x4_t w12_15);
+
+//----------------------------------------------------------------------
+// 19. Complex arithmetic
+//----------------------------------------------------------------------
+#define __ARM_FEATURE_COMPLEX 1
+
+// Vectors hold interleaved complex numbers: lane 2k is the real part, 2k+1 the imaginary part.
+// vcmla_type: r + a.re * b                  (r.re += a.re*b.re, r.im += a.re*b.im)
+// vcmla_rot90_type: r + a.im * (j*b)        (r.re -= a.im*b.im, r.im += a.im*b.re)
+// vcmla_rot180_type: r - a.re * b
+// vcmla_rot270_type: r - a.im * (j*b)
+// each product is fused with its add; vcmla + vcmla_rot90 is r + a*b, vcmla + vcmla_rot270 is r + conj(a)*b
+float32x2_t	vcmla_f32	(float32x2_t r, float32x2_t a, float32x2_t b);
+float32x4_t	vcmlaq_f32	(float32x4_t r, float32x4_t a, float32x4_t b);
+float64x2_t	vcmlaq_f64	(float64x2_t r, float64x2_t a, float64x2_t b);
+float32x2_t	vcmla_rot90_f32	(float32x2_t r, float32x2_t a, float32x2_t b);
+float32x4_t	vcmlaq_rot90_f32	(float32x4_t r, float32x4_t a, float32x4_t b);
+float64x2_t	vcmlaq_rot90_f64	(float64x2_t r, float64x2_t a, float64x2_t b);
+float32x2_t	vcmla_rot180_f32	(float32x2_t r, float32x2_t a, float32x2_t b);
+float32x4_t	vcmlaq_rot180_f32	(float32x4_t r, float32x4_t a, float32x4_t b);
+float64x2_t	vcmlaq_rot180_f64	(float64x2_t r, float64x2_t a, float64x2_t b);
+float32x2_t	vcmla_rot270_f32	(float32x2_t r, float32x2_t a, float32x2_t b);
+float32x4_t	vcmlaq_rot270_f32	(float32x4_t r, float32x4_t a, float32x4_t b);
+float64x2_t	vcmlaq_rot270_f64	(float64x2_t r, float64x2_t a, float64x2_t b);
+// _lane / _laneq: every complex number of a is multiplied by complex number `lane` of b
+float32x2_t	vcmla_lane_f32	(float32x2_t r, float32x2_t a, float32x2_t b, const int lane);
+float32x2_t	vcmla_laneq_f32	(float32x2_t r, float32x2_t a, float32x4_t b, const int lane);
+float32x4_t	vcmlaq_lane_f32	(float32x4_t r, float32x4_t a, float32x2_t b, const int lane);
+float32x4_t	vcmlaq_laneq_f32	(float32x4_t r, float32x4_t a, float32x4_t b, const int lane);
+float32x2_t	vcmla_rot90_lane_f32	(float32x2_t r, float32x2_t a, float32x2_t b, const int lane);
+float32x2_t	vcmla_rot90_laneq_f32	(float32x2_t r, float32x2_t a, float32x4_t b, const int lane);
+float32x4_t	vcmlaq_rot90_lane_f32	(float32x4_t r, float32x4_t a, float32x2_t b, const int lane);
+float32x4_t	vcmlaq_rot90_laneq_f32	(float32x4_t r, float32x4_t a, float32x4_t b, const int lane);
+float32x2_t	vcmla_rot180_lane_f32	(float32x2_t r, float32x2_t a, float32x2_t b, const int lane);
+float32x2_t	vcmla_rot180_laneq_f32	(float32x2_t r, float32x2_t a, float32x4_t b, const int lane);
+float32x4_t	vcmlaq_rot180_lane_f32	(float32x4_t r, float32x4_t a, float32x2_t b, const int lane);
+float32x4_t	vcmlaq_rot180_laneq_f32	(float32x4_t r, float32x4_t a, float32x4_t b, const int lane);
+float32x2_t	vcmla_rot270_lane_f32	(float32x2_t r, float32x2_t a, float32x2_t b, const int lane);
+float32x2_t	vcmla_rot270_laneq_f32	(float32x2_t r, float32x2_t a, float32x4_t b, const int lane);
+float32x4_t	vcmlaq_rot270_lane_f32	(float32x4_t r, float32x4_t a, float32x2_t b, const int lane);
+float32x4_t	vcmlaq_rot270_laneq_f32	(float32x4_t r, float32x4_t a, float32x4_t b, const int lane);
+
+// vcadd_rot90_type: a + j*b                (r.re = a.re - b.im, r.im = a.im + b.re)
+// vcadd_rot270_type: a - j*b               (r.re = a.re + b.im, r.im = a.im - b.re)
+float32x2_t	vcadd_rot90_f32	(float32x2_t a, float32x2_t b);
+float32x4_t	vcaddq_rot90_f32	(float32x4_t a, float32x4_t b);
+float64x2_t	vcaddq_rot90_f64	(float64x2_t a, float64x2_t b);
+float32x2_t	vcadd_rot270_f32	(float32x2_t a, float32x2_t b);
+float32x4_t	vcaddq_rot270_f32	(float32x4_t a, float32x4_t b);
+float64x2_t	vcaddq_rot270_f64	(float64x2_t a, float64x2_t b);
+
+//----------------------------------------------------------------------
+// 20. Floating-point control
+//----------------------------------------------------------------------
+// Per-thread FPCR honoured by the float intrinsics, bits at their AArch64
+// positions. FZ and the rounding mode go to the host MXCSR (FTZ + DAZ, RC)
+// when they are set, so arithmetic runs at full speed with no per-lane
+// checks; DN and results that bypass host arithmetic (min/max, estimates)
+// are fixed up per lane only while the bit is set. A new thread starts from
+// the default (or the AArch32 profile) value, not from its creator's.
+//
+// NeonSimFpcrScope fz(NEON_SIM_FPCR_FZ);   // denormals flush as on device
+// iir_decay(state, x, n);
+//
+// With NEON_SIM_AARCH32_FP defined (CMake -DNEON_SIM_AARCH32_FP=ON) every
+// thread runs with the AArch32 Advanced SIMD standard value: FZ and DN are
+// always on and the rounding mode is always to nearest.
+#define NEON_SIM_FPCR_RN (0u << 22) // round to nearest, ties to even
+#define NEON_SIM_FPCR_RP (1u << 22) // towards +inf
+#define NEON_SIM_FPCR_RM (2u << 22) // towards -inf
+#define NEON_SIM_FPCR_RZ (3u << 22) // towards zero
+#define NEON_SIM_FPCR_RMODE_MASK (3u << 22)
+#define NEON_SIM_FPCR_FZ (1u << 24) // flush subnormal inputs and results to zero
+#define NEON_SIM_FPCR_DN (1u << 25) // every NaN result is the default NaN
+#define NEON_SIM_FPCR_AARCH32 (NEON_SIM_FPCR_FZ | NEON_SIM_FPCR_DN | NEON_SIM_FPCR_RN)
+
+uint64_t	neon_sim_get_fpcr	();
+void	neon_sim_set_fpcr	(uint64_t fpcr);
+
+/// @brief FPCR of the calling thread set to `fpcr` for the lifetime of the object
+class NeonSimFpcrScope
+{
+public:
+    explicit NeonSimFpcrScope(uint64_t fpcr) : saved_(neon_sim_get_fpcr()) { neon_sim_set_fpcr(fpcr); }
+    ~NeonSimFpcrScope() { neon_sim_set_fpcr(saved_); }
+
+private:
+    NeonSimFpcrScope(const NeonSimFpcrScope&);
+    NeonSimFpcrScope& operator=(const NeonSimFpcrScope&);
+
+    uint64_t saved_;
+};
+
 #if defined(NEON_SIM_IMPLEMENTATION)
 
+#if defined(__PCLMUL__) || defined(__AES__)
+#include <wmmintrin.h> // vmull_p64, vaes*
+#endif // __PCLMUL__ || __AES__
+#if defined(__SHA__) || defined(__FMA__)
+#include <immintrin.h> // vsha1*, vsha256*, vcmla*, vrecpsq, vrsqrtsq
+#endif // __SHA__ || __FMA__
+#if defined(__SSE2__)
+#include <emmintrin.h> // vdivq, vsqrtq
+#endif // __SSE2__
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h> // MXCSR
+#else
+#include <cfenv> // fesetround
+#endif // __SSE__ || _M_X64
+#include <cmath> // std::fma
+#include <limits> // quiet_NaN
+
 //----------------------------------------------------------------------
 // 2. Intrinsics implementation
 //----------------------------------------------------------------------
 
+////// FPCR
+#if defined(NEON_SIM_AARCH32_FP)
+#define NEON_SIM_FPCR_INIT NEON_SIM_FPCR_AARCH32
+#else
+#define NEON_SIM_FPCR_INIT 0u
+#endif // NEON_SIM_AARCH32_FP
+
+// bit 31: not applied to this thread's host control register yet. Threads
+// start with MXCSR at its power-on value, which matches an FPCR of 0.
+static const uint32_t neon_sim_fpcr_pending = 1u << 31;
+static thread_local uint32_t neon_sim_fpcr_state = NEON_SIM_FPCR_INIT ? NEON_SIM_FPCR_INIT | neon_sim_fpcr_pending : 0u;
+
+static void neon_sim_fpcr_apply(uint32_t fpcr)
+{
+#if defined(__SSE__) || defined(_M_X64)
+    // MXCSR: DAZ bit 6, rounding control bits 13-14 (nearest, down, up, zero), FTZ bit 15
+    static const unsigned int rc[4] = { 0u << 13, 2u << 13, 1u << 13, 3u << 13 };
+    unsigned int csr = _mm_getcsr() & ~((1u << 6) | (3u << 13) | (1u << 15));
+    csr |= rc[(fpcr >> 22) & 3];
+    if (fpcr & NEON_SIM_FPCR_FZ) {
+        csr |= (1u << 6) | (1u << 15);
+    }
+    _mm_setcsr(csr);
+#else
+    // no host flush-to-zero here, only the rounding mode
+    static const int modes[4] = { FE_TONEAREST, FE_UPWARD, FE_DOWNWARD, FE_TOWARDZERO };
+    fesetround(modes[(fpcr >> 22) & 3]);
+#endif // __SSE__ || _M_X64
+}
+
+// FPCR of the calling thread, read at the start of every float intrinsic
+static inline uint32_t neon_sim_fpcr()
+{
+    uint32_t fpcr = neon_sim_fpcr_state;
+    if (fpcr & neon_sim_fpcr_pending) {
+        fpcr &= ~neon_sim_fpcr_pending;
+        neon_sim_fpcr_apply(fpcr);
+        neon_sim_fpcr_state = fpcr;
+    }
+    return fpcr;
+}
+
+uint64_t neon_sim_get_fpcr()
+{
+    return neon_sim_fpcr();
+}
+
+void neon_sim_set_fpcr(uint64_t fpcr)
+{
+    uint32_t v = (uint32_t)fpcr & (NEON_SIM_FPCR_RMODE_MASK | NEON_SIM_FPCR_FZ | NEON_SIM_FPCR_DN);
+#if defined(NEON_SIM_AARCH32_FP)
+    v = NEON_SIM_FPCR_AARCH32;
+#endif // NEON_SIM_AARCH32_FP
+    neon_sim_fpcr_apply(v);
+    neon_sim_fpcr_state = v;
+}
+
+// by the bits: with DAZ set, comparisons (and so std::fpclassify) see zero
+static inline bool neon_sim_is_subnormal(float x)
+{
+    uint32_t b;
+    memcpy(&b, &x, sizeof(b));
+    return (b & 0x7f800000u) == 0 && (b & 0x007fffffu) != 0;
+}
+
+static inline bool neon_sim_is_subnormal(double x)
+{
+    uint64_t b;
+    memcpy(&b, &x, sizeof(b));
+    return (b & 0x7ff0000000000000ull) == 0 && (b & 0x000fffffffffffffull) != 0;
+}
+
+// DN turns every NaN lane into the default NaN. `flush` is for results that
+// did not come out of host arithmetic, which MXCSR.FTZ does not reach.
+template <typename T, size_t N>
+static inline TxN<T, N> neon_sim_fp_result(TxN<T, N> r, uint32_t fpcr, bool flush = false)
+{
+    if (fpcr & NEON_SIM_FPCR_DN) {
+        for (size_t i = 0; i < N; i++) {
+            if (r[i] != r[i]) {
+                r[i] = std::numeric_limits<T>::quiet_NaN();
+            }
+        }
+    }
+    if (flush && (fpcr & NEON_SIM_FPCR_FZ)) {
+        for (size_t i = 0; i < N; i++) {
+            if (neon_sim_is_subnormal(r[i])) {
+                r[i] = std::copysign(T(0), r[i]);
+            }
+        }
+    }
+    return r;
+}
+
+// x86 turns an invalid operation into a negative NaN, ARM into the positive
+// default NaN; a NaN operand is passed on (quieted) by both.
+template <typename T>
+static inline T neon_sim_default_nan(T r, T a, T b)
+{
+    return (r != r && a == a && b == b) ? std::numeric_limits<T>::quiet_NaN() : r;
+}
+
+#if defined(__SSE2__)
+// lanes where r is a NaN made from non-NaN operands
+static inline __m128 neon_sim_invalid_ps(__m128 r, __m128 a, __m128 b)
+{
+    return _mm_andnot_ps(_mm_cmpunord_ps(a, b), _mm_cmpunord_ps(r, r));
+}
+
+static inline __m128d neon_sim_invalid_pd(__m128d r, __m128d a, __m128d b)
+{
+    return _mm_andnot_pd(_mm_cmpunord_pd(a, b), _mm_cmpunord_pd(r, r));
+}
+
+static inline __m128 neon_sim_select_ps(__m128 mask, __m128 x, __m128 y)
+{
+    return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+}
+
+static inline __m128d neon_sim_select_pd(__m128d mask, __m128d x, __m128d y)
+{
+    return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, y));
+}
+#endif // __SSE2__
+
 ////// Load
 // vld1
 uint8x8_t vld1_u8(uint8_t const* ptr)
@@ -3551,6 +3957,22 @@ uint64x2_t vld1q_u64(uint64_t const* ptr)
     }
     return r;
 }
+poly8x8_t vld1_p8(poly8_t const* ptr)
+{
+    return vld1_u8(ptr);
+}
+poly8x16_t vld1q_p8(poly8_t const* ptr)
+{
+    return vld1q_u8(ptr);
+}
+poly16x8_t vld1q_p16(poly16_t const* ptr)
+{
+    return vld1q_u16(ptr);
+}
+poly64x2_t vld1q_p64(poly64_t const* ptr)
+{
+    return vld1q_u64(ptr);
+}
 float32x4_t vld1q_f32(float32_t const* ptr)
 {
     float32x4_t r;
@@ -4174,6 +4596,22 @@ void vst1q_u64(uint64_t* ptr, uint64x2_t val)
         ptr[i] = val[i];
     }
 }
+void vst1_p8(poly8_t* ptr, poly8x8_t val)
+{
+    vst1_u8(ptr, val);
+}
+void vst1q_p8(poly8_t* ptr, poly8x16_t val)
+{
+    vst1q_u8(ptr, val);
+}
+void vst1q_p16(poly16_t* ptr, poly16x8_t val)
+{
+    vst1q_u16(ptr, val);
+}
+void vst1q_p64(poly64_t* ptr, poly64x2_t val)
+{
+    vst1q_u64(ptr, val);
+}
 void vst1q_f32(float32_t* ptr, float32x4_t val)
 {
     for (int i = 0; i < 4; i++) {
@@ -4526,9 +4964,9 @@ int32x4_t vmaxq_s32(int32x4_t N, int32x4_t M)
     return D;
 }
 
-int8x16_t vmaxq_u8(int8x16_t N, int8x16_t M)
+uint8x16_t vmaxq_u8(uint8x16_t N, uint8x16_t M)
 {
-    int8x16_t D;
+    uint8x16_t D;
     for (int i=0; i<16; i++)
     {
         D[i] = N[i] > M[i] ? N[i] : M[i];
@@ -4536,9 +4974,9 @@ int8x16_t vmaxq_u8(int8x16_t N, int8x16_t M)
     return D;
 }
 
-int16x8_t vmaxq_u16(int16x8_t N, int16x8_t M)
+uint16x8_t vmaxq_u16(uint16x8_t N, uint16x8_t M)
 {
-    int16x8_t D;
+    uint16x8_t D;
     for (int i=0; i<8; i++)
     {
         D[i] = N[i] > M[i] ? N[i] : M[i];
@@ -4546,9 +4984,9 @@ int16x8_t vmaxq_u16(int16x8_t N, int16x8_t M)
     return D;
 }
 
-int32x4_t vmaxq_u32(int32x4_t N, int32x4_t M)
+uint32x4_t vmaxq_u32(uint32x4_t N, uint32x4_t M)
 {
-    int32x4_t D;
+    uint32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] > M[i] ? N[i] : M[i];
@@ -4558,12 +4996,23 @@ int32x4_t vmaxq_u32(int32x4_t N, int32x4_t M)
 
 float32x4_t vmaxq_f32(float32x4_t N, float32x4_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] > M[i] ? N[i] : M[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr, true);
+}
+
+uint32_t vmaxvq_u32(uint32x4_t a)
+{
+    uint32_t m = a[0];
+    for (int i = 1; i < 4; i++)
+    {
+        m = a[i] > m ? a[i] : m;
+    }
+    return m;
 }
 
 
@@ -4923,11 +5372,12 @@ uint32x4_t vaddq_u32(uint32x4_t N, uint32x4_t M)
 }
 float32x4_t vaddq_f32(float32x4_t a, float32x4_t b)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t r;
     for (int i = 0; i < 4; i++) {
         r[i] = a[i] + b[i];
     }
-    return r;
+    return neon_sim_fp_result(r, fpcr);
 }
 
 uint64x2_t vaddq_u64(uint64x2_t N, uint64x2_t M)
@@ -5042,6 +5492,28 @@ uint8x16_t vqaddq_u8(uint8x16_t N, uint8x16_t M)
     return D;
 }
 
+int16x8_t vqaddq_s16(int16x8_t N, int16x8_t M)
+{
+    int16x8_t D;
+    for (size_t i=0; i<8; i++)
+    {
+        int32_t temp = (int32_t)N[i] + (int32_t)M[i];
+        D[i] = std::min(std::max(temp, INT16_MIN), INT16_MAX);
+    }
+    return D;
+}
+
+int32x4_t vqaddq_s32(int32x4_t N, int32x4_t M)
+{
+    int32x4_t D;
+    for (size_t i=0; i<4; i++)
+    {
+        int64_t temp = (int64_t)N[i] + (int64_t)M[i];
+        D[i] = std::min<int64_t>(std::max<int64_t>(temp, INT32_MIN), INT32_MAX);
+    }
+    return D;
+}
+
 uint16x4_t vpaddl_u8(uint8x8_t a)
 {
     uint16x4_t r;
@@ -5069,6 +5541,15 @@ uint32x4_t vpaddlq_u16(uint16x8_t a)
     return r;
 }
 
+int64x2_t vpaddlq_s32(int32x4_t a)
+{
+    int64x2_t r;
+    for (int i = 0; i < 2; i++){
+        r[i] = (int64_t)a[2*i] + a[2*i+1];
+    }
+    return r;
+}
+
 // sub
 int8x8_t vsub_s8(int8x8_t N, int8x8_t M)
 {
@@ -5145,22 +5626,24 @@ uint64x1_t vsub_u64(uint64x1_t N, uint64x1_t M)
 
 float32x2_t vsub_f32(float32x2_t N, float32x2_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x2_t D;
     for (size_t i=0; i<2; i++)
     {
         D[i] = N[i] - M[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
-float64x1_t vsub_f32(float64x1_t N, float64x1_t M)
+float64x1_t vsub_f64(float64x1_t N, float64x1_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float64x1_t D;
     for (size_t i=0; i<1; i++)
     {
         D[i] = N[i] - M[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
 // vsubq_type
@@ -5239,12 +5722,13 @@ uint64x2_t vsubq_u64(uint64x2_t N, uint64x2_t M)
 
 float32x4_t vsubq_f32(float32x4_t N, float32x4_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (size_t i=0; i<4; i++)
     {
         D[i] = N[i] - M[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
 
@@ -5536,7 +6020,7 @@ int32x4_t vsubl_s16(int16x4_t N, int16x4_t M)
     return D;
 }
 
-int64x2_t vsubl_s32(int32x4_t N, int32x2_t M)
+int64x2_t vsubl_s32(int32x2_t N, int32x2_t M)
 {
     int64x2_t D;
     for (size_t i=0; i<2; i++)
@@ -5567,7 +6051,7 @@ uint32x4_t vsubl_u16(uint16x4_t N, uint16x4_t M)
     return D;
 }
 
-uint64x2_t vsubl_u32(uint32x4_t N, uint32x2_t M)
+uint64x2_t vsubl_u32(uint32x2_t N, uint32x2_t M)
 {
     uint64x2_t D;
     for (size_t i=0; i<2; i++)
@@ -6056,12 +6540,13 @@ uint32x4_t vmulq_u32(uint32x4_t N, uint32x4_t M)
 
 float32x4_t vmulq_f32(float32x4_t a, float32x4_t b)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t r;
     for (int i = 0; i < 4; i++)
     {
         r[i] = a[i] * b[i];
     }
-    return r;
+    return neon_sim_fp_result(r, fpcr);
 }
 
 // vmul_n
@@ -6107,23 +6592,25 @@ uint32x2_t vmul_n_u32(uint32x2_t N, uint32_t M)
 
 float32x2_t vmul_n_f32(float32x2_t N, float32_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x2_t D;
     for (int i=0; i<2; i++)
     {
         D[i] = N[i] * M;
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
 #if __aarch64__
 float64x1_t vmul_n_f64(float64x1_t N, float64_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float64x1_t D;
     for (int i=0; i<1; i++)
     {
         D[i] = N[i] * M;
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 #endif // __aarch64__
 
@@ -6170,23 +6657,25 @@ uint32x4_t vmulq_n_u32(uint32x4_t N, uint32_t M)
 
 float32x4_t vmulq_n_f32(float32x4_t N, float32_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] * M;
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
 #if __aarch64__
 float64x2_t vmulq_n_f64(float64x2_t N, float64_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float64x2_t D;
     for (int i=0; i<2; i++)
     {
         D[i] = N[i] * M;
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 #endif // __aarch64__
 
@@ -6216,6 +6705,127 @@ uint64x2_t vmull_u32(uint32x2_t a, uint32x2_t b)
     return r;
 }
 
+// PMUL / PMULL: carry-less multiply, partial products combined with xor
+static uint16_t neon_sim_clmul8(uint8_t a, uint8_t b)
+{
+    uint16_t r = 0;
+    for (int i = 0; i < 8; i++) {
+        if (b & (1 << i)) {
+            r ^= (uint16_t)(a << i);
+        }
+    }
+    return r;
+}
+poly8x8_t vmul_p8(poly8x8_t a, poly8x8_t b)
+{
+    poly8x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = (poly8_t)neon_sim_clmul8(a[i], b[i]);
+    }
+    return r;
+}
+poly8x16_t vmulq_p8(poly8x16_t a, poly8x16_t b)
+{
+    poly8x16_t r;
+    for (int i = 0; i < 16; i++) {
+        r[i] = (poly8_t)neon_sim_clmul8(a[i], b[i]);
+    }
+    return r;
+}
+poly16x8_t vmull_p8(poly8x8_t a, poly8x8_t b)
+{
+    poly16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = neon_sim_clmul8(a[i], b[i]);
+    }
+    return r;
+}
+poly16x8_t vmull_high_p8(poly8x16_t a, poly8x16_t b)
+{
+    poly16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = neon_sim_clmul8(a[i + 8], b[i + 8]);
+    }
+    return r;
+}
+#if defined(__SIZEOF_INT128__)
+// PMULL.1Q: PCLMULQDQ when the host has it (-mpclmul), else shift and xor
+poly128_t vmull_p64(poly64_t a, poly64_t b)
+{
+#if defined(__PCLMUL__)
+    const __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a), _mm_cvtsi64_si128((long long)b), 0x00);
+    poly128_t r;
+    memcpy(&r, &p, sizeof(r));
+    return r;
+#else
+    poly128_t r = 0;
+    for (int i = 0; i < 64; i++) {
+        if ((b >> i) & 1) {
+            r ^= (poly128_t)a << i;
+        }
+    }
+    return r;
+#endif // __PCLMUL__
+}
+poly128_t vmull_high_p64(poly64x2_t a, poly64x2_t b)
+{
+    return vmull_p64(a[1], b[1]);
+}
+#endif // __SIZEOF_INT128__
+
+poly8x8_t vadd_p8(poly8x8_t a, poly8x8_t b)
+{
+    poly8x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = a[i] ^ b[i];
+    }
+    return r;
+}
+poly8x16_t vaddq_p8(poly8x16_t a, poly8x16_t b)
+{
+    poly8x16_t r;
+    for (int i = 0; i < 16; i++) {
+        r[i] = a[i] ^ b[i];
+    }
+    return r;
+}
+poly16x4_t vadd_p16(poly16x4_t a, poly16x4_t b)
+{
+    poly16x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] ^ b[i];
+    }
+    return r;
+}
+poly16x8_t vaddq_p16(poly16x8_t a, poly16x8_t b)
+{
+    poly16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = a[i] ^ b[i];
+    }
+    return r;
+}
+poly64x1_t vadd_p64(poly64x1_t a, poly64x1_t b)
+{
+    poly64x1_t r;
+    r[0] = a[0] ^ b[0];
+    return r;
+}
+poly64x2_t vaddq_p64(poly64x2_t a, poly64x2_t b)
+{
+    poly64x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = a[i] ^ b[i];
+    }
+    return r;
+}
+#if defined(__SIZEOF_INT128__)
+poly128_t vaddq_p128(poly128_t a, poly128_t b)
+{
+    return a ^ b;
+}
+#endif // __SIZEOF_INT128__
+
 int16x8_t vmull_s8(int8x8_t a, int8x8_t b)
 {
     int16x8_t r;
@@ -6300,52 +6910,176 @@ int32x4_t vqdmull_s16(int16x4_t M, int16x4_t N)
     return D;
 }
 
-// vmlal_type
-int16x8_t vmlal_s8(int16x8_t N, int8x8_t M, int8x8_t P)
+int64x2_t vqdmull_s32(int32x2_t M, int32x2_t N)
 {
-    int16x8_t D;
-    for (int i=0; i<8; i++)
+    int64x2_t D;
+    for (int i=0; i<2; i++)
     {
-        D[i] = N[i] + (M[i] * P[i]);
+        // 2 * M * N fits in int64 except for INT32_MIN * INT32_MIN
+        if (N[i] == INT32_MIN && M[i] == INT32_MIN) {
+            D[i] = INT64_MAX;
+        }
+        else {
+            D[i] = (int64_t)M[i] * N[i] * 2;
+        }
     }
     return D;
 }
 
-int32x4_t vmlal_s16(int32x4_t N, int16x4_t M, int16x4_t P)
+static inline int64_t neon_sim_sat_add_s64(int64_t a, int64_t b)
 {
-    int32x4_t D;
-    for (int i=0; i<4; i++)
-    {
-        D[i] = N[i] + (M[i] * P[i]);
+    if (b > 0 && a > INT64_MAX - b) {
+        return INT64_MAX;
     }
-    return D;
+    if (b < 0 && a < INT64_MIN - b) {
+        return INT64_MIN;
+    }
+    return a + b;
 }
 
-int64x2_t vmlal_s32(int64x2_t N, int32x2_t M, int32x2_t P)
+// vqdmlal, vqdmlsl: the doubled product and the accumulation both saturate
+int32x4_t vqdmlal_s16(int32x4_t a, int16x4_t b, int16x4_t c)
 {
-    int64x2_t D;
-    for (int i=0; i<2; i++)
+    const int32x4_t p = vqdmull_s16(b, c);
+    int32x4_t r;
+    for (int i = 0; i < 4; i++)
     {
-        D[i] = N[i] + (M[i] * P[i]);
+        r[i] = std::min<int64_t>(std::max<int64_t>((int64_t)a[i] + p[i], INT32_MIN), INT32_MAX);
     }
-    return D;
+    return r;
 }
 
-uint16x8_t vmlal_u8(uint16x8_t N, uint8x8_t M, uint8x8_t P)
+int64x2_t vqdmlal_s32(int64x2_t a, int32x2_t b, int32x2_t c)
 {
-    uint16x8_t D;
-    for (int i=0; i<8; i++)
+    const int64x2_t p = vqdmull_s32(b, c);
+    int64x2_t r;
+    for (int i = 0; i < 2; i++)
     {
-        D[i] = N[i] + (M[i] * P[i]);
+        r[i] = neon_sim_sat_add_s64(a[i], p[i]);
     }
-    return D;
+    return r;
 }
 
-uint32x4_t vmlal_u16(uint32x4_t N, uint16x4_t M, uint16x4_t P)
+int32x4_t vqdmlsl_s16(int32x4_t a, int16x4_t b, int16x4_t c)
 {
-    uint32x4_t D;
-    for (int i=0; i<4; i++)
-    {
+    const int32x4_t p = vqdmull_s16(b, c);
+    int32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = std::min<int64_t>(std::max<int64_t>((int64_t)a[i] - p[i], INT32_MIN), INT32_MAX);
+    }
+    return r;
+}
+
+int64x2_t vqdmlsl_s32(int64x2_t a, int32x2_t b, int32x2_t c)
+{
+    const int64x2_t p = vqdmull_s32(b, c);
+    int64x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        // p > INT64_MIN, so -p does not overflow
+        r[i] = neon_sim_sat_add_s64(a[i], -p[i]);
+    }
+    return r;
+}
+
+// vqrdmulh: high half of 2 * a * b, rounded; only INT_MIN * INT_MIN saturates
+int16x4_t vqrdmulh_s16(int16x4_t a, int16x4_t b)
+{
+    int16x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = std::min<int64_t>((2 * (int64_t)a[i] * b[i] + (1 << 15)) >> 16, INT16_MAX);
+    }
+    return r;
+}
+
+int16x8_t vqrdmulhq_s16(int16x8_t a, int16x8_t b)
+{
+    int16x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r[i] = std::min<int64_t>((2 * (int64_t)a[i] * b[i] + (1 << 15)) >> 16, INT16_MAX);
+    }
+    return r;
+}
+
+int16x8_t vqrdmulhq_n_s16(int16x8_t a, int16_t b)
+{
+    return vqrdmulhq_s16(a, vdupq_n_s16(b));
+}
+
+int32x4_t vqrdmulhq_s32(int32x4_t a, int32x4_t b)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        if (a[i] == INT32_MIN && b[i] == INT32_MIN) {
+            r[i] = INT32_MAX;
+        }
+        else {
+            r[i] = (int32_t)(((int64_t)a[i] * b[i] + (1ll << 30)) >> 31);
+        }
+    }
+    return r;
+}
+
+// vmlal_type
+int16x8_t vmlal_s8(int16x8_t N, int8x8_t M, int8x8_t P)
+{
+    int16x8_t D;
+    for (int i=0; i<8; i++)
+    {
+        D[i] = N[i] + (M[i] * P[i]);
+    }
+    return D;
+}
+
+int32x4_t vmlal_s16(int32x4_t N, int16x4_t M, int16x4_t P)
+{
+    int32x4_t D;
+    for (int i=0; i<4; i++)
+    {
+        D[i] = N[i] + (M[i] * P[i]);
+    }
+    return D;
+}
+
+int32x4_t vmlal_lane_s16(int32x4_t a, int16x4_t b, int16x4_t v, const int lane)
+{
+    if (lane < 0 || lane > 3)
+    {
+        fprintf(stderr, "%s: lane is out of range [0, 3]\n", __FUNCTION__);
+        abort();
+    }
+    return vmlal_s16(a, b, vdup_n_s16(v[lane]));
+}
+
+int64x2_t vmlal_s32(int64x2_t N, int32x2_t M, int32x2_t P)
+{
+    int64x2_t D;
+    for (int i=0; i<2; i++)
+    {
+        D[i] = N[i] + (M[i] * P[i]);
+    }
+    return D;
+}
+
+uint16x8_t vmlal_u8(uint16x8_t N, uint8x8_t M, uint8x8_t P)
+{
+    uint16x8_t D;
+    for (int i=0; i<8; i++)
+    {
+        D[i] = N[i] + (M[i] * P[i]);
+    }
+    return D;
+}
+
+uint32x4_t vmlal_u16(uint32x4_t N, uint16x4_t M, uint16x4_t P)
+{
+    uint32x4_t D;
+    for (int i=0; i<4; i++)
+    {
         D[i] = N[i] + (M[i] * P[i]);
     }
     return D;
@@ -6361,6 +7095,26 @@ uint64x2_t vmlal_u32(uint64x2_t N, uint32x2_t M, uint32x2_t P)
     return D;
 }
 
+int32x4_t vmlal_n_s16(int32x4_t N, int16x4_t M, int16_t P)
+{
+    int32x4_t D;
+    for (int i=0; i<4; i++)
+    {
+        D[i] = (int32_t)((uint32_t)N[i] + (uint32_t)(M[i] * P));
+    }
+    return D;
+}
+
+uint32x4_t vmlal_n_u16(uint32x4_t N, uint16x4_t M, uint16_t P)
+{
+    uint32x4_t D;
+    for (int i=0; i<4; i++)
+    {
+        D[i] = N[i] + (uint32_t)M[i] * P;
+    }
+    return D;
+}
+
 // vmlsl_type
 int16x8_t vmlsl_s8(int16x8_t N, int8x8_t M, int8x8_t P)
 {
@@ -6485,23 +7239,164 @@ uint32x4_t vmlaq_u32(uint32x4_t N, uint32x4_t M, uint32x4_t P)
 
 float32x4_t vmlaq_f32(float32x4_t N, float32x4_t M, float32x4_t P)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] + M[i] * P[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
 // vmlaq_n
+int32x4_t vmlaq_n_s32(int32x4_t a, int32x4_t b, int32_t c)
+{
+    int32x4_t D;
+    for (int i=0; i<4; i++)
+    {
+        D[i] = (int32_t)((uint32_t)a[i] + (uint32_t)b[i] * (uint32_t)c);
+    }
+    return D;
+}
+
 float32x4_t vmlaq_n_f32(float32x4_t a, float32x4_t b, float32_t c)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = a[i] + b[i] * c;
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
+}
+
+// vfma / vfms: one rounding; 0 * inf gives the default NaN unless a is a NaN
+template <typename T, size_t N>
+static TxN<T, N> neon_sim_fma(const TxN<T, N>& a, const TxN<T, N>& b, const TxN<T, N>& c, bool sub)
+{
+    TxN<T, N> r;
+    for (size_t i = 0; i < N; i++)
+    {
+        const T p = sub ? -b[i] : b[i];
+        const T d = std::fma(p, c[i], a[i]);
+        r[i] = a[i] == a[i] ? neon_sim_default_nan(d, b[i], c[i]) : d;
+    }
+    return r;
+}
+
+#if defined(__FMA__)
+template <bool sub>
+static float32x4_t neon_sim_fmaq_f32_fma(float32x4_t a, float32x4_t b, float32x4_t c)
+{
+    const __m128 va = _mm_loadu_ps(a.val);
+    const __m128 vb = _mm_loadu_ps(b.val);
+    const __m128 vc = _mm_loadu_ps(c.val);
+    const __m128 r = sub ? _mm_fnmadd_ps(vb, vc, va) : _mm_fmadd_ps(vb, vc, va);
+    const __m128 invalid = _mm_andnot_ps(_mm_cmpunord_ps(va, va), neon_sim_invalid_ps(r, vb, vc));
+    _mm_storeu_ps(a.val, neon_sim_select_ps(invalid, _mm_set1_ps(std::numeric_limits<float>::quiet_NaN()), r));
+    return a;
+}
+
+template <bool sub>
+static float64x2_t neon_sim_fmaq_f64_fma(float64x2_t a, float64x2_t b, float64x2_t c)
+{
+    const __m128d va = _mm_loadu_pd(a.val);
+    const __m128d vb = _mm_loadu_pd(b.val);
+    const __m128d vc = _mm_loadu_pd(c.val);
+    const __m128d r = sub ? _mm_fnmadd_pd(vb, vc, va) : _mm_fmadd_pd(vb, vc, va);
+    const __m128d invalid = _mm_andnot_pd(_mm_cmpunord_pd(va, va), neon_sim_invalid_pd(r, vb, vc));
+    _mm_storeu_pd(a.val, neon_sim_select_pd(invalid, _mm_set1_pd(std::numeric_limits<double>::quiet_NaN()), r));
+    return a;
+}
+#endif // __FMA__
+
+float32x2_t vfma_f32(float32x2_t a, float32x2_t b, float32x2_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, false), fpcr);
+}
+
+float64x1_t vfma_f64(float64x1_t a, float64x1_t b, float64x1_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, false), fpcr);
+}
+
+float32x4_t vfmaq_f32(float32x4_t a, float32x4_t b, float32x4_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_fmaq_f32_fma<false>(a, b, c), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, false), fpcr);
+#endif // __FMA__
+}
+
+float64x2_t vfmaq_f64(float64x2_t a, float64x2_t b, float64x2_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_fmaq_f64_fma<false>(a, b, c), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, false), fpcr);
+#endif // __FMA__
+}
+
+float32x2_t vfms_f32(float32x2_t a, float32x2_t b, float32x2_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, true), fpcr);
+}
+
+float64x1_t vfms_f64(float64x1_t a, float64x1_t b, float64x1_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, true), fpcr);
+}
+
+float32x4_t vfmsq_f32(float32x4_t a, float32x4_t b, float32x4_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_fmaq_f32_fma<true>(a, b, c), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, true), fpcr);
+#endif // __FMA__
+}
+
+float64x2_t vfmsq_f64(float64x2_t a, float64x2_t b, float64x2_t c)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_fmaq_f64_fma<true>(a, b, c), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_fma(a, b, c, true), fpcr);
+#endif // __FMA__
+}
+
+float32x4_t vfmaq_lane_f32(float32x4_t a, float32x4_t b, float32x2_t v, const int lane)
+{
+    if (lane < 0 || lane > 1)
+    {
+        fprintf(stderr, "%s: lane is out of range [0, 1]\n", __FUNCTION__);
+        abort();
+    }
+    return vfmaq_f32(a, b, vdupq_n_f32(v[lane]));
+}
+
+float32x4_t vfmaq_laneq_f32(float32x4_t a, float32x4_t b, float32x4_t v, const int lane)
+{
+    if (lane < 0 || lane > 3)
+    {
+        fprintf(stderr, "%s: lane is out of range [0, 3]\n", __FUNCTION__);
+        abort();
+    }
+    return vfmaq_f32(a, b, vdupq_n_f32(v[lane]));
+}
+
+float32x4_t vfmaq_n_f32(float32x4_t a, float32x4_t b, float32_t n)
+{
+    return vfmaq_f32(a, b, vdupq_n_f32(n));
 }
 
 // Vector manipulation 
@@ -6556,6 +7451,11 @@ uint8x8_t vdup_n_u8(uint8_t N)
     return D;
 }
 
+poly8x8_t vdup_n_p8(poly8_t N)
+{
+    return vdup_n_u8(N);
+}
+
 uint16x4_t vdup_n_u16(uint16_t N)
 {
     uint16x4_t D;
@@ -6595,6 +7495,18 @@ uint8x16_t vdupq_n_u8(uint8_t value)
     }
     return r;
 }
+poly8x16_t vdupq_n_p8(poly8_t value)
+{
+    return vdupq_n_u8(value);
+}
+poly64x2_t vdupq_n_p64(poly64_t value)
+{
+    poly64x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = value;
+    }
+    return r;
+}
 int8x16_t vdupq_n_s8(int8_t value)
 {
     uint8x16_t r;
@@ -6812,18 +7724,20 @@ uint8x8_t vget_high_u8 (uint8x16_t a)
 
 float32x2_t vpmax_f32(float32x2_t a, float32x2_t b)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x2_t r;
     r[0] = a[0] > a[1] ? a[0] : a[1];
     r[1] = b[0] > b[1] ? b[0] : b[1];
-    return r;
+    return neon_sim_fp_result(r, fpcr, true);
 }
 
 float32x2_t vpmin_f32(float32x2_t a, float32x2_t b)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x2_t r;
     r[0] = a[0] < a[1] ? a[0] : a[1];
     r[1] = b[0] < b[1] ? b[0] : b[1];
-    return r;
+    return neon_sim_fp_result(r, fpcr, true);
 }
 
 float32_t vget_lane_f32(float32x2_t v, const int lane)
@@ -6862,6 +7776,21 @@ uint64_t	vgetq_lane_u64	(uint64x2_t v, const int lane)
     return v[lane];
 }
 
+poly8_t	vgetq_lane_p8	(poly8x16_t v, const int lane)
+{
+    return v[lane];
+}
+
+poly16_t	vgetq_lane_p16	(poly16x8_t v, const int lane)
+{
+    return v[lane];
+}
+
+poly64_t	vgetq_lane_p64	(poly64x2_t v, const int lane)
+{
+    return v[lane];
+}
+
 int8_t	vgetq_lane_s8	(int8x16_t v, const int lane)
 {
     return v[lane];
@@ -6918,9 +7847,9 @@ int32x4_t vminq_s32(int32x4_t N, int32x4_t M)
     return D;
 }
 
-int8x16_t vminq_u8(int8x16_t N, int8x16_t M)
+uint8x16_t vminq_u8(uint8x16_t N, uint8x16_t M)
 {
-    int8x16_t D;
+    uint8x16_t D;
     for (int i=0; i<16; i++)
     {
         D[i] = N[i] < M[i] ? N[i] : M[i];
@@ -6928,9 +7857,9 @@ int8x16_t vminq_u8(int8x16_t N, int8x16_t M)
     return D;
 }
 
-int16x8_t vminq_u16(int16x8_t N, int16x8_t M)
+uint16x8_t vminq_u16(uint16x8_t N, uint16x8_t M)
 {
-    int16x8_t D;
+    uint16x8_t D;
     for (int i=0; i<8; i++)
     {
         D[i] = N[i] < M[i] ? N[i] : M[i];
@@ -6938,9 +7867,9 @@ int16x8_t vminq_u16(int16x8_t N, int16x8_t M)
     return D;
 }
 
-int32x4_t vminq_u32(int32x4_t N, int32x4_t M)
+uint32x4_t vminq_u32(uint32x4_t N, uint32x4_t M)
 {
-    int32x4_t D;
+    uint32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] < M[i] ? N[i] : M[i];
@@ -6950,12 +7879,13 @@ int32x4_t vminq_u32(int32x4_t N, int32x4_t M)
 
 float32x4_t vminq_f32(float32x4_t N, float32x4_t M)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
         D[i] = N[i] < M[i] ? N[i] : M[i];
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr, true);
 }
 
 uint32x4_t vcltq_f32(float32x4_t N, float32x4_t M)
@@ -6972,61 +7902,207 @@ uint32x4_t vcltq_f32(float32x4_t N, float32x4_t M)
     return D;
 }
 
-float32x4_t vbslq_f32(uint32x4_t mask, float32x4_t a, float32x4_t b)
+uint32x4_t vcleq_f32(float32x4_t a, float32x4_t b)
 {
-    float32x4_t r;
-    for (int i = 0; i < 4; i++)
-    {
-        r[i] = mask[i] ? a[i] : b[i];
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] <= b[i] ? 0xFFFFFFFF : 0;
     }
     return r;
 }
 
-// shift right
-int8x8_t vshrn_n_s16(int16x8_t a, const int n)
+uint32x4_t vcgtq_f32(float32x4_t a, float32x4_t b)
 {
-    if (n<1 || n>8) {
-        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
-        abort();
-    }
-
-    int8x8_t r;
-    for (int i = 0; i < 8; i++) {
-        r[i] = a[i] >> n;
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] > b[i] ? 0xFFFFFFFF : 0;
     }
     return r;
 }
 
-uint16x4_t vshr_n_u16(uint16x4_t v, const int n)
+uint32x4_t vcgeq_f32(float32x4_t a, float32x4_t b)
 {
-    if (n<1 || n>8) {
-        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
-        abort();
-    }
-
-    uint16x4_t D;
-    for (int i=0; i<4; i++)
-    {
-        D[i] = v[i] >> n;
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] >= b[i] ? 0xFFFFFFFF : 0;
     }
-    return D;
+    return r;
 }
 
-int16x4_t vshrn_n_s32(int32x4_t a, const int n)
+uint32x4_t vceqq_f32(float32x4_t a, float32x4_t b)
 {
-    if (n<1 || n>16) {
-        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
-        abort();
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] == b[i] ? 0xFFFFFFFF : 0;
     }
+    return r;
+}
 
-    int16x4_t r;
+// vabsq: clears the sign bit, NaNs included; FZ and DN do not apply
+float32x4_t vabsq_f32(float32x4_t a)
+{
+    float32x4_t r;
     for (int i = 0; i < 4; i++) {
-        r[i] = a[i] >> n;
+        r[i] = std::fabs(a[i]);
     }
     return r;
 }
 
-int32x2_t vshrn_n_s64(int64x2_t a, const int n)
+// vneg/vnegq: integers wrap, so the most negative value stays as it is
+int8x8_t vneg_s8(int8x8_t a)
+{
+    int8x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = (int8_t)(0 - (uint8_t)a[i]);
+    }
+    return r;
+}
+int16x4_t vneg_s16(int16x4_t a)
+{
+    int16x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = (int16_t)(0 - (uint16_t)a[i]);
+    }
+    return r;
+}
+int32x2_t vneg_s32(int32x2_t a)
+{
+    int32x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = (int32_t)(0 - (uint32_t)a[i]);
+    }
+    return r;
+}
+int64x1_t vneg_s64(int64x1_t a)
+{
+    int64x1_t r;
+    for (int i = 0; i < 1; i++) {
+        r[i] = (int64_t)(0 - (uint64_t)a[i]);
+    }
+    return r;
+}
+int8x16_t vnegq_s8(int8x16_t a)
+{
+    int8x16_t r;
+    for (int i = 0; i < 16; i++) {
+        r[i] = (int8_t)(0 - (uint8_t)a[i]);
+    }
+    return r;
+}
+int16x8_t vnegq_s16(int16x8_t a)
+{
+    int16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = (int16_t)(0 - (uint16_t)a[i]);
+    }
+    return r;
+}
+int32x4_t vnegq_s32(int32x4_t a)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = (int32_t)(0 - (uint32_t)a[i]);
+    }
+    return r;
+}
+int64x2_t vnegq_s64(int64x2_t a)
+{
+    int64x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = (int64_t)(0 - (uint64_t)a[i]);
+    }
+    return r;
+}
+
+// float vneg flips the sign bit, NaNs included; FZ and DN do not apply
+float32x2_t vneg_f32(float32x2_t a)
+{
+    float32x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = -a[i];
+    }
+    return r;
+}
+float64x1_t vneg_f64(float64x1_t a)
+{
+    float64x1_t r;
+    for (int i = 0; i < 1; i++) {
+        r[i] = -a[i];
+    }
+    return r;
+}
+float32x4_t vnegq_f32(float32x4_t a)
+{
+    float32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = -a[i];
+    }
+    return r;
+}
+float64x2_t vnegq_f64(float64x2_t a)
+{
+    float64x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r[i] = -a[i];
+    }
+    return r;
+}
+
+float32x4_t vbslq_f32(uint32x4_t mask, float32x4_t a, float32x4_t b)
+{
+    float32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = mask[i] ? a[i] : b[i];
+    }
+    return r;
+}
+
+// shift right
+int8x8_t vshrn_n_s16(int16x8_t a, const int n)
+{
+    if (n<1 || n>8) {
+        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
+        abort();
+    }
+
+    int8x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = a[i] >> n;
+    }
+    return r;
+}
+
+uint16x4_t vshr_n_u16(uint16x4_t v, const int n)
+{
+    if (n<1 || n>8) {
+        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
+        abort();
+    }
+
+    uint16x4_t D;
+    for (int i=0; i<4; i++)
+    {
+        D[i] = v[i] >> n;
+    }
+    return D;
+}
+
+int16x4_t vshrn_n_s32(int32x4_t a, const int n)
+{
+    if (n<1 || n>16) {
+        fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
+        abort();
+    }
+
+    int16x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] >> n;
+    }
+    return r;
+}
+
+int32x2_t vshrn_n_s64(int64x2_t a, const int n)
 {
     if (n<1 || n>32) {
         fprintf(stderr, "%s: param n not in range [1, 8]\n", __FUNCTION__);
@@ -7113,12 +8189,13 @@ uint16x4_t vqshrun_n_s32(int32x4_t v, const int n)
     }
     uint16x4_t D;
     for (int i=0; i<4; i++) {
-        int32_t temp = ( v[i] + (1<<(n-1) ) ) >> n;
+        int32_t temp = v[i] >> n;
         if (temp > UINT16_MAX) {
             temp = UINT16_MAX;
         } else if (temp < 0) {
             temp = 0;
         }
+        D[i] = temp;
     }
     return D;
 }
@@ -7133,12 +8210,13 @@ uint32x2_t vqshrun_n_s64(int64x2_t v, const int n)
     }
     uint32x2_t D;
     for (int i=0; i<2; i++) {
-        int64_t temp = ( v[i] + (1<<(n-1) ) ) >> n;
+        int64_t temp = v[i] >> n;
         if (temp > UINT32_MAX) {
             temp = UINT32_MAX;
         } else if (temp < 0) {
             temp = 0;
         }
+        D[i] = temp;
     }
     return D;
 }
@@ -7152,7 +8230,7 @@ uint8x8_t vqrshrun_n_s16(int16x8_t v, const int n)
     }
     uint8x8_t D;
     for (int i=0; i<8; i++) {
-        int16_t temp = ( v[i] + (1<<(n-1) ) ) >> n;
+        int32_t temp = ( v[i] + (1<<(n-1) ) ) >> n;
         if (temp > UINT8_MAX) {
             temp = UINT8_MAX;
         } else if (temp < 0) {
@@ -7163,6 +8241,25 @@ uint8x8_t vqrshrun_n_s16(int16x8_t v, const int n)
     return D;
 }
 
+uint16x4_t vqrshrun_n_s32(int32x4_t v, const int n)
+{
+    if (n<1 || n>16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+    uint16x4_t D;
+    for (int i=0; i<4; i++) {
+        int64_t temp = ( (int64_t)v[i] + (1<<(n-1) ) ) >> n;
+        if (temp > UINT16_MAX) {
+            temp = UINT16_MAX;
+        } else if (temp < 0) {
+            temp = 0;
+        }
+        D[i] = temp;
+    }
+    return D;
+}
+
 uint8x8_t vrshrn_n_u16(uint16x8_t a, const int n)
 {
     uint8x8_t r;
@@ -7173,6 +8270,50 @@ uint8x8_t vrshrn_n_u16(uint16x8_t a, const int n)
     return r;
 }
 
+uint16x4_t vrshrn_n_u32(uint32x4_t a, const int n)
+{
+    if (n < 1 || n > 16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+    uint16x4_t r;
+    const uint64_t delta = (1ull << (n-1));
+    for (int i = 0; i < 4; i++) {
+        r[i] = (uint16_t)((a[i] + delta) >> n);
+    }
+    return r;
+}
+
+uint16x4_t vrshr_n_u16(uint16x4_t a, const int n)
+{
+    if (n < 1 || n > 16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+
+    uint16x4_t r;
+    const uint32_t delta = (1u << (n-1));
+    for (int i = 0; i < 4; i++) {
+        r[i] = (a[i] + delta) >> n;
+    }
+    return r;
+}
+
+uint16x8_t vrshrq_n_u16(uint16x8_t a, const int n)
+{
+    if (n < 1 || n > 16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+
+    uint16x8_t r;
+    const uint32_t delta = (1u << (n-1));
+    for (int i = 0; i < 8; i++) {
+        r[i] = (a[i] + delta) >> n;
+    }
+    return r;
+}
+
 int32x4_t vsraq_n_s32(int32x4_t a, int32x4_t b, const int n)
 {
     int32x4_t r;
@@ -7183,6 +8324,32 @@ int32x4_t vsraq_n_s32(int32x4_t a, int32x4_t b, const int n)
 }
 
 // shift left
+int16x8_t vshlq_n_s16(int16x8_t a, const int n)
+{
+    if (n<0 || n>15) {
+        fprintf(stderr, "%s: param n not in range [0, 15]\n", __FUNCTION__);
+        abort();
+    }
+    int16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = (int16_t)((uint16_t)a[i] << n);
+    }
+    return r;
+}
+
+uint16x8_t vshlq_n_u16(uint16x8_t a, const int n)
+{
+    if (n<0 || n>15) {
+        fprintf(stderr, "%s: param n not in range [0, 15]\n", __FUNCTION__);
+        abort();
+    }
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = (uint16_t)(a[i] << n);
+    }
+    return r;
+}
+
 int32x4_t vshlq_n_s32(int32x4_t M, const int n)
 {
     int32x4_t D;
@@ -7192,6 +8359,70 @@ int32x4_t vshlq_n_s32(int32x4_t M, const int n)
     return D;
 }
 
+uint32x4_t vshlq_n_u32(uint32x4_t a, const int n)
+{
+    if (n<0 || n>31) {
+        fprintf(stderr, "%s: param n not in range [0, 31]\n", __FUNCTION__);
+        abort();
+    }
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] << n;
+    }
+    return r;
+}
+
+// shift by register: the signed low byte of each lane of b, negative shifts right
+uint32x4_t vshlq_u32(uint32x4_t a, int32x4_t b)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        const int n = (int8_t)b[i];
+        r[i] = n >= 32 || n <= -32 ? 0 : n >= 0 ? a[i] << n : a[i] >> -n;
+    }
+    return r;
+}
+
+// shift right by immediate; arithmetic for the signed types
+int32x4_t vshrq_n_s32(int32x4_t a, const int n)
+{
+    if (n<1 || n>32) {
+        fprintf(stderr, "%s: param n not in range [1, 32]\n", __FUNCTION__);
+        abort();
+    }
+    int32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = n == 32 ? (a[i] < 0 ? -1 : 0) : a[i] >> n;
+    }
+    return r;
+}
+
+uint16x8_t vshrq_n_u16(uint16x8_t a, const int n)
+{
+    if (n<1 || n>16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++) {
+        r[i] = n == 16 ? 0 : a[i] >> n;
+    }
+    return r;
+}
+
+uint32x4_t vshrq_n_u32(uint32x4_t a, const int n)
+{
+    if (n<1 || n>32) {
+        fprintf(stderr, "%s: param n not in range [1, 32]\n", __FUNCTION__);
+        abort();
+    }
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = n == 32 ? 0 : a[i] >> n;
+    }
+    return r;
+}
+
 uint16x8_t vshll_n_u8(uint8x8_t a, const int n)
 {
     uint16x8_t r;
@@ -7288,46 +8519,116 @@ uint8x16_t	vreinterpretq_u8_u64	(uint64x2_t a)
     return a;
 }
 
-uint8x16_t	vreinterpretq_u8_s64	(int64x2_t a)
+poly8x16_t	vreinterpretq_p8_u8	(uint8x16_t a)
 {
     return a;
 }
 
-#if __fp16
-uint8x16_t	vreinterpretq_u8_f16	(float16x8_t a)
+uint8x16_t	vreinterpretq_u8_p8	(poly8x16_t a)
 {
     return a;
 }
-#endif // __fp16
 
-uint8x16_t	vreinterpretq_u8_f64	(float64x2_t a)
+poly16x8_t	vreinterpretq_p16_u16	(uint16x8_t a)
 {
     return a;
 }
 
-
-// vreinterpretq_u32_type
-uint32x4_t	vreinterpretq_u32_s8	(int8x16_t a)
+uint16x8_t	vreinterpretq_u16_p16	(poly16x8_t a)
 {
     return a;
 }
 
-uint32x4_t	vreinterpretq_u32_s16	(int16x8_t a)
+poly64x2_t	vreinterpretq_p64_u64	(uint64x2_t a)
 {
     return a;
 }
 
-uint32x4_t	vreinterpretq_u32_s32	(int32x4_t a)
+uint64x2_t	vreinterpretq_u64_p64	(poly64x2_t a)
 {
     return a;
 }
 
-uint32x4_t	vreinterpretq_u32_f32	(float32x4_t a)
+poly64x2_t	vreinterpretq_p64_u8	(uint8x16_t a)
 {
     return a;
 }
 
-uint32x4_t	vreinterpretq_u32_u8	(uint8x16_t a)
+uint8x16_t	vreinterpretq_u8_p64	(poly64x2_t a)
+{
+    return a;
+}
+
+#if defined(__SIZEOF_INT128__)
+// poly128_t is little-endian in the register, low 64 bits in lane 0
+uint8x16_t	vreinterpretq_u8_p128	(poly128_t a)
+{
+    uint8x16_t r;
+    memcpy(r.val, &a, sizeof(a));
+    return r;
+}
+
+uint64x2_t	vreinterpretq_u64_p128	(poly128_t a)
+{
+    uint64x2_t r;
+    r[0] = (uint64_t)a;
+    r[1] = (uint64_t)(a >> 64);
+    return r;
+}
+
+poly128_t	vreinterpretq_p128_u8	(uint8x16_t a)
+{
+    poly128_t r;
+    memcpy(&r, a.val, sizeof(r));
+    return r;
+}
+
+poly128_t	vreinterpretq_p128_u64	(uint64x2_t a)
+{
+    return ((poly128_t)a[1] << 64) | a[0];
+}
+#endif // __SIZEOF_INT128__
+
+uint8x16_t	vreinterpretq_u8_s64	(int64x2_t a)
+{
+    return a;
+}
+
+#if __fp16
+uint8x16_t	vreinterpretq_u8_f16	(float16x8_t a)
+{
+    return a;
+}
+#endif // __fp16
+
+uint8x16_t	vreinterpretq_u8_f64	(float64x2_t a)
+{
+    return a;
+}
+
+
+// vreinterpretq_u32_type
+uint32x4_t	vreinterpretq_u32_s8	(int8x16_t a)
+{
+    return a;
+}
+
+uint32x4_t	vreinterpretq_u32_s16	(int16x8_t a)
+{
+    return a;
+}
+
+uint32x4_t	vreinterpretq_u32_s32	(int32x4_t a)
+{
+    return a;
+}
+
+uint32x4_t	vreinterpretq_u32_f32	(float32x4_t a)
+{
+    return a;
+}
+
+uint32x4_t	vreinterpretq_u32_u8	(uint8x16_t a)
 {
     return a;
 }
@@ -7359,6 +8660,34 @@ uint32x4_t	vreinterpretq_u32_f64	(float64x2_t a)
     return a;
 }
 
+// vreinterpretq_u64_type
+uint64x2_t	vreinterpretq_u64_u8	(uint8x16_t a)
+{
+    return a;
+}
+
+// vreinterpretq_s32_type
+int32x4_t	vreinterpretq_s32_u32	(uint32x4_t a)
+{
+    return a;
+}
+
+int32x4_t	vreinterpretq_s32_f32	(float32x4_t a)
+{
+    return a;
+}
+
+// vreinterpretq_f32_type
+float32x4_t	vreinterpretq_f32_s32	(int32x4_t a)
+{
+    return a;
+}
+
+float32x4_t	vreinterpretq_f32_u32	(uint32x4_t a)
+{
+    return a;
+}
+
 float32x4_t vcvtq_f32_s32(int32x4_t a)
 {
     float32x4_t r;
@@ -7425,13 +8754,58 @@ uint32_t RecipEstimate(uint32_t a) {
     return (b + 1) / 2;
 }
 
-float FPRecipEstimate(float operand) {
-    float_parts parts{operand};
-    parts.exp = 253 - parts.exp;
-    uint32_t scaled = 0x100 | ((parts.fraction >> 15) & 0xFF);
-    uint32_t estimate = RecipEstimate(scaled);
-    parts.fraction = (estimate & 0xff) << 15;
-    return float(parts);
+// Tiny operands overflow to inf or the largest float as the rounding mode
+// says, huge ones give a subnormal estimate. FZ flushes both to zero first.
+float FPRecipEstimate(float operand, uint32_t fpcr = 0) {
+    if (operand != operand) {
+        return operand + operand; // quiet NaN
+    }
+    if (std::isinf(operand)) {
+        return std::signbit(operand) ? -0.0f : 0.0f;
+    }
+    uint32_t v_bits;
+    memcpy(&v_bits, &operand, sizeof(float));
+    const bool sign = (v_bits >> 31) != 0;
+    uint32_t fraction = v_bits & ((1 << 23) - 1);
+    int exp = (int)((v_bits >> 23) & 0xff);
+    if (exp == 0 && (fraction == 0 || (fpcr & NEON_SIM_FPCR_FZ))) {
+        return sign ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    }
+    if (exp == 0 && fraction < (1 << 21)) { // below 2^-128
+        bool overflow_to_inf;
+        switch (fpcr & NEON_SIM_FPCR_RMODE_MASK) {
+        case NEON_SIM_FPCR_RN: overflow_to_inf = true; break;
+        case NEON_SIM_FPCR_RP: overflow_to_inf = !sign; break;
+        case NEON_SIM_FPCR_RM: overflow_to_inf = sign; break;
+        default: overflow_to_inf = false; break;
+        }
+        const float r = overflow_to_inf ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::max();
+        return sign ? -r : r;
+    }
+    if (exp >= 253 && (fpcr & NEON_SIM_FPCR_FZ)) {
+        return sign ? -0.0f : 0.0f;
+    }
+    if (exp == 0) {
+        if ((fraction & (1 << 22)) == 0) {
+            exp = -1;
+            fraction = (fraction << 2) & ((1 << 23) - 1);
+        } else {
+            fraction = (fraction << 1) & ((1 << 23) - 1);
+        }
+    }
+    uint32_t scaled = 0x100 | (fraction >> 15);
+    int result_exp = 253 - exp;
+    fraction = (RecipEstimate(scaled) & 0xff) << 15;
+    if (result_exp == 0) {
+        fraction = (1 << 22) | (fraction >> 1);
+    } else if (result_exp == -1) {
+        fraction = (1 << 21) | (fraction >> 2);
+        result_exp = 0;
+    }
+    uint32_t r_bits = (v_bits & 0x80000000u) | ((uint32_t)result_exp << 23) | fraction;
+    float result;
+    memcpy(&result, &r_bits, sizeof(float));
+    return result;
 }
 
 float_parts::float_parts(float v) {
@@ -7466,24 +8840,226 @@ float_parts::operator float() const {
 
 float32x4_t vrecpeq_f32(float32x4_t N)
 {
+    const uint32_t fpcr = neon_sim_fpcr();
     float32x4_t D;
     for (int i=0; i<4; i++)
     {
-        D[i] = FPRecipEstimate(N[i]);
+        D[i] = FPRecipEstimate(N[i], fpcr);
     }
-    return D;
+    return neon_sim_fp_result(D, fpcr);
 }
 
-float32x4_t vrecpsq_f32(float32x4_t a, float32x4_t b)
+float32x2_t vrecpe_f32(float32x2_t N)
 {
-    float32x4_t r;
-    for (int i = 0; i < 4; i++)
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x2_t D;
+    for (int i=0; i<2; i++)
+    {
+        D[i] = FPRecipEstimate(N[i], fpcr);
+    }
+    return neon_sim_fp_result(D, fpcr);
+}
+
+// a in [128, 511]: 9 bits of the operand scaled to [0.25, 1)
+uint32_t RecipSqrtEstimate(uint32_t a) {
+    if (a < 256) {
+        a = a * 2 + 1;
+    } else {
+        a = (a >> 1) << 1;
+        a = (a + 1) * 2;
+    }
+    uint32_t b = 512;
+    while (a * (b + 1) * (b + 1) < (1u << 28)) {
+        b = b + 1;
+    }
+    return (b + 1) / 2;
+}
+
+// works on the raw bits with RecipSqrtEstimate tabulated once, so that
+// vrsqrteq costs about as much as the Newton steps after it
+float FPRSqrtEstimate(float operand, uint32_t fpcr = 0) {
+    static const struct Table {
+        uint8_t t[512];
+        Table() {
+            for (uint32_t a = 128; a < 512; a++) {
+                t[a] = (uint8_t)RecipSqrtEstimate(a);
+            }
+        }
+    } table;
+    if (operand != operand) {
+        return operand + operand; // quiet NaN
+    }
+    if (operand == 0.0f || ((fpcr & NEON_SIM_FPCR_FZ) && neon_sim_is_subnormal(operand))) {
+        return std::signbit(operand) ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    }
+    if (operand < 0.0f) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (std::isinf(operand)) {
+        return 0.0f;
+    }
+    uint32_t v_bits;
+    memcpy(&v_bits, &operand, sizeof(float));
+    uint32_t fraction = v_bits & ((1 << 23) - 1);
+    int exp = (int)(v_bits >> 23);
+    if (exp == 0) { // subnormal: normalize the fraction
+        while ((fraction & (1 << 22)) == 0) {
+            fraction <<= 1;
+            exp--;
+        }
+        fraction = (fraction << 1) & ((1 << 23) - 1);
+    }
+    uint32_t scaled = (exp & 1) == 0 ? 0x100 | (fraction >> 15) : 0x80 | (fraction >> 16);
+    uint32_t estimate = table.t[scaled];
+    uint32_t r_bits = ((uint32_t)((380 - exp) / 2) << 23) | (estimate << 15);
+    float result;
+    memcpy(&result, &r_bits, sizeof(float));
+    return result;
+}
+
+float32x2_t vrsqrte_f32(float32x2_t N)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x2_t D;
+    for (int i=0; i<2; i++)
+    {
+        D[i] = FPRSqrtEstimate(N[i], fpcr);
+    }
+    return neon_sim_fp_result(D, fpcr);
+}
+
+float32x4_t vrsqrteq_f32(float32x4_t N)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x4_t D;
+    for (int i=0; i<4; i++)
     {
-        r[i] = 2.0 - (a[i] * b[i]);
+        D[i] = FPRSqrtEstimate(N[i], fpcr);
+    }
+    return neon_sim_fp_result(D, fpcr);
+}
+
+// FRECPS and FRSQRTS: 2 - a*b and (3 - a*b) / 2 with a single rounding.
+// 0 * inf gives exactly 2 and 1.5, so a Newton step keeps an estimate of
+// 0 or inf. 3 - a*b is either zero or far above the subnormal range, so
+// halving the fused result is exact.
+template <typename T, size_t N>
+static TxN<T, N> neon_sim_recps(const TxN<T, N>& a, const TxN<T, N>& b)
+{
+    TxN<T, N> r;
+    for (size_t i = 0; i < N; i++) {
+        const bool zero_inf = (std::isinf(a[i]) && b[i] == 0) || (a[i] == 0 && std::isinf(b[i]));
+        r[i] = zero_inf ? T(2) : std::fma(-a[i], b[i], T(2));
+    }
+    return r;
+}
+
+template <typename T, size_t N>
+static TxN<T, N> neon_sim_rsqrts(const TxN<T, N>& a, const TxN<T, N>& b)
+{
+    TxN<T, N> r;
+    for (size_t i = 0; i < N; i++) {
+        const bool zero_inf = (std::isinf(a[i]) && b[i] == 0) || (a[i] == 0 && std::isinf(b[i]));
+        r[i] = zero_inf ? T(1.5) : std::fma(-a[i], b[i], T(3)) / 2;
     }
     return r;
 }
 
+#if defined(__FMA__)
+// the only NaN vfnmadd makes from non-NaN operands is 0 * inf
+template <bool rsqrt>
+static float32x4_t neon_sim_stepq_f32_fma(float32x4_t a, float32x4_t b)
+{
+    const __m128 va = _mm_loadu_ps(a.val);
+    const __m128 vb = _mm_loadu_ps(b.val);
+    __m128 r = _mm_fnmadd_ps(va, vb, _mm_set1_ps(rsqrt ? 3.0f : 2.0f));
+    if (rsqrt) {
+        r = _mm_mul_ps(r, _mm_set1_ps(0.5f));
+    }
+    r = neon_sim_select_ps(neon_sim_invalid_ps(r, va, vb), _mm_set1_ps(rsqrt ? 1.5f : 2.0f), r);
+    _mm_storeu_ps(a.val, r);
+    return a;
+}
+
+template <bool rsqrt>
+static float64x2_t neon_sim_stepq_f64_fma(float64x2_t a, float64x2_t b)
+{
+    const __m128d va = _mm_loadu_pd(a.val);
+    const __m128d vb = _mm_loadu_pd(b.val);
+    __m128d r = _mm_fnmadd_pd(va, vb, _mm_set1_pd(rsqrt ? 3.0 : 2.0));
+    if (rsqrt) {
+        r = _mm_mul_pd(r, _mm_set1_pd(0.5));
+    }
+    r = neon_sim_select_pd(neon_sim_invalid_pd(r, va, vb), _mm_set1_pd(rsqrt ? 1.5 : 2.0), r);
+    _mm_storeu_pd(a.val, r);
+    return a;
+}
+#endif // __FMA__
+
+float32x2_t vrecps_f32(float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_recps(a, b), fpcr);
+}
+
+float64x1_t vrecps_f64(float64x1_t a, float64x1_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_recps(a, b), fpcr);
+}
+
+float32x4_t vrecpsq_f32(float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_stepq_f32_fma<false>(a, b), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_recps(a, b), fpcr);
+#endif // __FMA__
+}
+
+float64x2_t vrecpsq_f64(float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_stepq_f64_fma<false>(a, b), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_recps(a, b), fpcr);
+#endif // __FMA__
+}
+
+float32x2_t vrsqrts_f32(float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_rsqrts(a, b), fpcr);
+}
+
+float64x1_t vrsqrts_f64(float64x1_t a, float64x1_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_rsqrts(a, b), fpcr);
+}
+
+float32x4_t vrsqrtsq_f32(float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_stepq_f32_fma<true>(a, b), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_rsqrts(a, b), fpcr);
+#endif // __FMA__
+}
+
+float64x2_t vrsqrtsq_f64(float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+#if defined(__FMA__)
+    return neon_sim_fp_result(neon_sim_stepq_f64_fma<true>(a, b), fpcr);
+#else
+    return neon_sim_fp_result(neon_sim_rsqrts(a, b), fpcr);
+#endif // __FMA__
+}
+
 /// transpose
 int8x8x2_t vtrn_s8(int8x8_t a, int8x8_t b)
 {
@@ -7598,6 +9174,20 @@ uint32x4x2_t vtrnq_u32(uint32x4_t a, uint32x4_t b)
     return r;
 }
 
+float32x4x2_t vtrnq_f32(float32x4_t a, float32x4_t b)
+{
+    float32x4x2_t r;
+    for (int i = 0; i < 2; i++) {
+        r.val[0][2*i] = a[2*i];
+        r.val[0][2*i+1] = b[2*i];
+    }
+    for (int i = 0; i < 2; i++) {
+        r.val[1][2*i] = a[2*i+1];
+        r.val[1][2*i+1] = b[2*i+1];
+    }
+    return r;
+}
+
 int16x8x2_t vtrnq_s16(int16x8_t a, int16x8_t b)
 {
     int16x8x2_t r;
@@ -7628,6 +9218,21 @@ int16x4x2_t vzip_s16(int16x4_t a, int16x4_t b)
     return r;
 }
 
+int32x4x2_t vzipq_s32(int32x4_t a, int32x4_t b)
+{
+    int32x4x2_t r;
+    const int n = 2;
+    for (int i = 0; i < n; i++) {
+        r.val[0][2*i] = a[i];
+        r.val[0][2*i+1] = b[i];
+    }
+    for (int i = 0; i < n; i++) {
+        r.val[1][2*i] = a[n + i];
+        r.val[1][2*i+1] = b[n + i];
+    }
+    return r;
+}
+
 // combine
 uint8x16_t vcombine_u8(uint8x8_t low, uint8x8_t high)
 {
@@ -7641,6 +9246,18 @@ uint8x16_t vcombine_u8(uint8x8_t low, uint8x8_t high)
     }
     return r;
 }
+poly8x16_t vcombine_p8(poly8x8_t low, poly8x8_t high)
+{
+    poly8x16_t r;
+    const int n = 8;
+    for (int i = 0; i < n; i++) {
+        r[i] = low[i];
+    }
+    for (int i = 0; i < n; i++) {
+        r[n + i] = high[i];
+    }
+    return r;
+}
 uint16x8_t vcombine_u16(uint16x4_t low, uint16x4_t high)
 {
     uint16x8_t r;
@@ -7703,6 +9320,19 @@ int32x4_t vcombine_s32(int32x2_t low, int32x2_t high)
     return r;
 }
 
+float32x4_t vcombine_f32(float32x2_t low, float32x2_t high)
+{
+    float32x4_t r;
+    const int n = 2;
+    for (int i = 0; i < n; i++) {
+        r[i] = low[i];
+    }
+    for (int i = 0; i < n; i++) {
+        r[n + i] = high[i];
+    }
+    return r;
+}
+
 // vmov
 int16x4_t vmovn_s32(int32x4_t a)
 {
@@ -7978,6 +9608,54 @@ uint8x8_t vtbl2_u8(uint8x8x2_t a, uint8x8_t idx)
     return r;
 }
 
+// vtbx: 与 vtbl 相同, 只是索引越界时保留 a 中对应的元素, 而不是置 0
+uint8x8_t vtbx1_u8(uint8x8_t a, uint8x8_t b, uint8x8_t idx)
+{
+    uint8x8_t r = a;
+    for (int i = 0; i < 8; i++) {
+        if (idx.val[i] < 8) {
+            r[i] = b.val[idx.val[i]];
+        }
+    }
+    return r;
+}
+
+uint8x8_t vtbx2_u8(uint8x8_t a, uint8x8x2_t b, uint8x8_t idx)
+{
+    uint8x8_t r = a;
+    for (int i = 0; i < 8; i++) {
+        const int index = idx.val[i];
+        if (index < 16) {
+            r[i] = b.val[index / 8][index % 8];
+        }
+    }
+    return r;
+}
+
+uint8x8_t vtbx3_u8(uint8x8_t a, uint8x8x3_t b, uint8x8_t idx)
+{
+    uint8x8_t r = a;
+    for (int i = 0; i < 8; i++) {
+        const int index = idx.val[i];
+        if (index < 24) {
+            r[i] = b.val[index / 8][index % 8];
+        }
+    }
+    return r;
+}
+
+uint8x8_t vtbx4_u8(uint8x8_t a, uint8x8x4_t b, uint8x8_t idx)
+{
+    uint8x8_t r = a;
+    for (int i = 0; i < 8; i++) {
+        const int index = idx.val[i];
+        if (index < 32) {
+            r[i] = b.val[index / 8][index % 8];
+        }
+    }
+    return r;
+}
+
 
 // vand_type:
 int8x8_t vand_s8(int8x8_t a, int8x8_t b)
@@ -8577,9 +10255,19 @@ uint8x16_t vmvnq_u8 (uint8x16_t a)
     return r;
 }
 
-uint16x8_t vmvnq_u16 (uint16x8_t a)
+poly8x8_t vmvn_p8 (poly8x8_t a)
 {
-    uint16x8_t r;
+    return vmvn_u8(a);
+}
+
+poly8x16_t vmvnq_p8 (poly8x16_t a)
+{
+    return vmvnq_u8(a);
+}
+
+uint16x8_t vmvnq_u16 (uint16x8_t a)
+{
+    uint16x8_t r;
     for (int i = 0; i < 8; i++)
     {
         r[i] = ~a[i];
@@ -8724,8 +10412,8 @@ uint8x16_t	vrev16q_u8	(uint8x16_t vec)
 // vrev32_type:
 int8x8_t	vrev32_s8	(int8x8_t vec)
 {
-    int8x16_t r;
-    for (int i = 0; i < 16; i+=4)
+    int8x8_t r;
+    for (int i = 0; i < 8; i+=4)
     {
         r[i + 0] = vec[i + 3];
         r[i + 1] = vec[i + 2];
@@ -8795,325 +10483,1063 @@ int16x8_t	vrev32q_s16	(int16x8_t vec)
     return r;
 }
 
-uint8x16_t	vrev32q_u8	(uint8x16_t vec)
+uint8x16_t	vrev32q_u8	(uint8x16_t vec)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i+=4)
+    {
+        r[i + 0] = vec[i + 3];
+        r[i + 1] = vec[i + 2];
+        r[i + 2] = vec[i + 1];
+        r[i + 3] = vec[i + 0];
+    }
+    return r;
+}
+
+uint16x8_t	vrev32q_u16	(uint16x8_t vec)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+// vrev64_type:
+int8x8_t	vrev64_s8	(int8x8_t vec)
+{
+    int8x8_t r;
+    for (int i = 0; i < 8; i+=8)
+    {
+        r[i + 0] = vec[i + 7];
+        r[i + 1] = vec[i + 6];
+        r[i + 2] = vec[i + 5];
+        r[i + 3] = vec[i + 4];
+        r[i + 4] = vec[i + 3];
+        r[i + 5] = vec[i + 2];
+        r[i + 6] = vec[i + 1];
+        r[i + 7] = vec[i + 0];
+    }
+    return r;
+}
+
+int16x4_t	vrev64_s16	(int16x4_t vec)
+{
+    int16x4_t r;
+    for (int i = 0; i < 4; i+=4)
+    {
+        r[i + 0] = vec[i + 3];
+        r[i + 1] = vec[i + 2];
+        r[i + 2] = vec[i + 1];
+        r[i + 3] = vec[i + 0];
+    }
+    return r;
+}
+
+int32x2_t	vrev64_s32	(int32x2_t vec)
+{
+    int32x2_t r;
+    for (int i = 0; i < 2; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+uint8x8_t	vrev64_u8	(uint8x8_t vec)
+{
+    uint8x8_t r;
+    for (int i = 0; i < 8; i+=8)
+    {
+        r[i + 0] = vec[i + 7];
+        r[i + 1] = vec[i + 6];
+        r[i + 2] = vec[i + 5];
+        r[i + 3] = vec[i + 4];
+        r[i + 4] = vec[i + 3];
+        r[i + 5] = vec[i + 2];
+        r[i + 6] = vec[i + 1];
+        r[i + 7] = vec[i + 0];
+    }
+    return r;
+}
+
+uint16x4_t	vrev64_u16	(uint16x4_t vec)
+{
+    uint16x4_t r;
+    for (int i = 0; i < 4; i+=4)
+    {
+        r[i + 0] = vec[i + 3];
+        r[i + 1] = vec[i + 2];
+        r[i + 2] = vec[i + 1];
+        r[i + 3] = vec[i + 0];
+    }
+    return r;
+}
+
+uint32x2_t	vrev64_u32	(uint32x2_t vec)
+{
+    uint32x2_t r;
+    for (int i = 0; i < 2; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+float32x2_t	vrev64_f32	(float32x2_t vec)
+{
+    float32x2_t r;
+    for (int i = 0; i < 2; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+// vrev64q_type:
+int8x16_t	vrev64q_s8	(int8x16_t vec)
+{
+    int8x16_t r;
+    for (int i = 0; i < 8; i+=8)
+    {
+        r[i + 0] = vec[i + 7];
+        r[i + 1] = vec[i + 6];
+        r[i + 2] = vec[i + 5];
+        r[i + 3] = vec[i + 4];
+        r[i + 4] = vec[i + 3];
+        r[i + 5] = vec[i + 2];
+        r[i + 6] = vec[i + 1];
+        r[i + 7] = vec[i + 0];
+    }
+    return r;
+}
+
+int16x8_t	vrev64q_s16	(int16x8_t vec)
+{
+    int16x8_t r;
+    for (int i = 0; i < 4; i+=4)
+    {
+        r[i + 0] = vec[i + 3];
+        r[i + 1] = vec[i + 2];
+        r[i + 2] = vec[i + 1];
+        r[i + 3] = vec[i + 0];
+    }
+    return r;
+}
+
+int32x4_t	vrev64q_s32	(int32x4_t vec)
+{
+    int32x4_t r;
+    for (int i = 0; i < 4; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+uint8x16_t	vrev64q_u8	(uint8x16_t vec)
+{
+    uint8x16_t r;
+    for (int i = 0; i < 16; i+=8)
+    {
+        r[i + 0] = vec[i + 7];
+        r[i + 1] = vec[i + 6];
+        r[i + 2] = vec[i + 5];
+        r[i + 3] = vec[i + 4];
+        r[i + 4] = vec[i + 3];
+        r[i + 5] = vec[i + 2];
+        r[i + 6] = vec[i + 1];
+        r[i + 7] = vec[i + 0];
+    }
+    return r;
+}
+
+uint16x8_t	vrev64q_u16	(uint16x8_t vec)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i+=4)
+    {
+        r[i + 0] = vec[i + 3];
+        r[i + 1] = vec[i + 2];
+        r[i + 2] = vec[i + 1];
+        r[i + 3] = vec[i + 0];
+    }
+    return r;
+}
+
+uint32x4_t	vrev64q_u32	(uint32x4_t vec)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+float32x4_t	vrev64q_f32	(float32x4_t vec)
+{
+    float32x4_t r;
+    for (int i = 0; i < 4; i+=2)
+    {
+        r[i + 0] = vec[i + 1];
+        r[i + 1] = vec[i + 0];
+    }
+    return r;
+}
+
+
+// Vector arithmetic / Division
+#if __aarch64__
+// The q forms are one divps / divpd (sqrtps / sqrtpd) on SSE2 hosts; IEEE
+// division and square root round the same everywhere, only the NaN of an
+// invalid operation needs fixing up.
+// vdiv_type
+float32x2_t	vdiv_f32	(float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = neon_sim_default_nan(a[i] / b[i], a[i], b[i]);
+    }
+    return neon_sim_fp_result(r, fpcr);
+}
+
+float64x1_t	vdiv_f64	(float64x1_t a, float64x1_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float64x1_t r;
+    for (int i = 0; i < 1; i++)
+    {
+        r[i] = neon_sim_default_nan(a[i] / b[i], a[i], b[i]);
+    }
+    return neon_sim_fp_result(r, fpcr);
+}
+
+//float16x4_t	vdiv_f16	(float16x4_t a, float16x4_t b);
+
+// vdivq_type
+float32x4_t	vdivq_f32	(float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x4_t r;
+#if defined(__SSE2__)
+    const __m128 va = _mm_loadu_ps(a.val);
+    const __m128 vb = _mm_loadu_ps(b.val);
+    const __m128 q = _mm_div_ps(va, vb);
+    _mm_storeu_ps(r.val, neon_sim_select_ps(neon_sim_invalid_ps(q, va, vb), _mm_set1_ps(std::numeric_limits<float>::quiet_NaN()), q));
+#else
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = neon_sim_default_nan(a[i] / b[i], a[i], b[i]);
+    }
+#endif // __SSE2__
+    return neon_sim_fp_result(r, fpcr);
+}
+
+float64x2_t	vdivq_f64	(float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float64x2_t r;
+#if defined(__SSE2__)
+    const __m128d va = _mm_loadu_pd(a.val);
+    const __m128d vb = _mm_loadu_pd(b.val);
+    const __m128d q = _mm_div_pd(va, vb);
+    _mm_storeu_pd(r.val, neon_sim_select_pd(neon_sim_invalid_pd(q, va, vb), _mm_set1_pd(std::numeric_limits<double>::quiet_NaN()), q));
+#else
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = neon_sim_default_nan(a[i] / b[i], a[i], b[i]);
+    }
+#endif // __SSE2__
+    return neon_sim_fp_result(r, fpcr);
+}
+
+//float16x8_t	vdivq_f16	(float16x8_t a, float16x8_t b);
+
+// Vector arithmetic / Square root
+// vsqrt_type
+float32x2_t	vsqrt_f32	(float32x2_t a)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = neon_sim_default_nan(std::sqrt(a[i]), a[i], a[i]);
+    }
+    return neon_sim_fp_result(r, fpcr);
+}
+
+float64x1_t	vsqrt_f64	(float64x1_t a)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float64x1_t r;
+    for (int i = 0; i < 1; i++)
+    {
+        r[i] = neon_sim_default_nan(std::sqrt(a[i]), a[i], a[i]);
+    }
+    return neon_sim_fp_result(r, fpcr);
+}
+
+// vsqrtq_type
+float32x4_t	vsqrtq_f32	(float32x4_t a)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float32x4_t r;
+#if defined(__SSE2__)
+    const __m128 va = _mm_loadu_ps(a.val);
+    const __m128 s = _mm_sqrt_ps(va);
+    _mm_storeu_ps(r.val, neon_sim_select_ps(neon_sim_invalid_ps(s, va, va), _mm_set1_ps(std::numeric_limits<float>::quiet_NaN()), s));
+#else
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = neon_sim_default_nan(std::sqrt(a[i]), a[i], a[i]);
+    }
+#endif // __SSE2__
+    return neon_sim_fp_result(r, fpcr);
+}
+
+float64x2_t	vsqrtq_f64	(float64x2_t a)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    float64x2_t r;
+#if defined(__SSE2__)
+    const __m128d va = _mm_loadu_pd(a.val);
+    const __m128d s = _mm_sqrt_pd(va);
+    _mm_storeu_pd(r.val, neon_sim_select_pd(neon_sim_invalid_pd(s, va, va), _mm_set1_pd(std::numeric_limits<double>::quiet_NaN()), s));
+#else
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = neon_sim_default_nan(std::sqrt(a[i]), a[i], a[i]);
+    }
+#endif // __SSE2__
+    return neon_sim_fp_result(r, fpcr);
+}
+#endif // __aarch64__
+
+// saturated shift right and narrow
+int8x8_t vqshrn_n_s16 (int16x8_t a, const int n)
+{
+    int8x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r[i] = std::min(std::max(a[i] >> n, INT8_MIN), INT8_MAX);
+    }
+    return r;
+}
+
+int16x4_t vqshrn_n_s32 (int32x4_t a, const int n)
+{
+    int16x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = std::min(std::max(a[i] >> n, INT16_MIN), INT16_MAX);
+    }
+    return r;
+}
+
+int32x2_t vqshrn_n_s64 (int64x2_t a, const int n)
+{
+    int32x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = std::min<int32_t>(std::max<int64_t>(a[i] >> n, INT32_MIN), INT32_MAX);
+    }
+    return r;
+}
+
+// saturated rounding shift right and narrow; the rounding add does not wrap
+int16x4_t vqrshrn_n_s32 (int32x4_t a, const int n)
+{
+    if (n < 1 || n > 16) {
+        fprintf(stderr, "%s: param n not in range [1, 16]\n", __FUNCTION__);
+        abort();
+    }
+    int16x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = std::min<int64_t>(std::max<int64_t>(((int64_t)a[i] + (1ll << (n - 1))) >> n, INT16_MIN), INT16_MAX);
+    }
+    return r;
+}
+
+int32x2_t vqrshrn_n_s64 (int64x2_t a, const int n)
+{
+    if (n < 1 || n > 32) {
+        fprintf(stderr, "%s: param n not in range [1, 32]\n", __FUNCTION__);
+        abort();
+    }
+    int32x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        // (a >> n) plus the last bit shifted out is a + 2^(n-1) >> n without the overflow
+        r[i] = std::min<int64_t>(std::max<int64_t>((a[i] >> n) + ((a[i] >> (n - 1)) & 1), INT32_MIN), INT32_MAX);
+    }
+    return r;
+}
+
+uint8x8_t vqshrn_n_u16 (uint16x8_t a, const int n)
+{
+    uint8x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r[i] = std::min(a[i] >> n, UINT8_MAX);
+    }
+    return r;
+}
+
+uint16x4_t vqshrn_n_u32 (uint32x4_t a, const int n)
+{
+    uint16x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r[i] = std::min<uint32_t>(a[i] >> n, UINT16_MAX);
+    }
+    return r;
+}
+
+uint32x2_t vqshrn_n_u64 (uint64x2_t a, const int n)
+{
+    uint32x2_t r;
+    for (int i = 0; i < 2; i++)
+    {
+        r[i] = std::min<uint64_t>(a[i] >> n, UINT32_MAX);
+    }
+    return r;
+}
+
+
+//----------------------------------------------------------------------
+// 4. Complex arithmetic
+//----------------------------------------------------------------------
+// With FMA3 (NEON_SIM_AVX2) the q forms are one vfmadd on a duplicated
+// real or imaginary part and a pair-swapped, sign-flipped b; flipping a sign
+// is exact, so the result is the same fused product-sum as the scalar path.
+
+// element2 of FCMLA for lanes 2k / 2k+1 at rotation rot, negation included
+template <int rot, typename T, size_t N>
+static TxN<T, N> neon_sim_cmla(TxN<T, N> r, const TxN<T, N>& a, const TxN<T, N>& b)
+{
+    for (size_t i = 0; i < N; i += 2) {
+        const T e = (rot == 0 || rot == 180) ? a[i] : a[i + 1];
+        T re, im;
+        switch (rot) {
+        case 0: re = b[i]; im = b[i + 1]; break;
+        case 90: re = -b[i + 1]; im = b[i]; break;
+        case 180: re = -b[i]; im = -b[i + 1]; break;
+        default: re = b[i + 1]; im = -b[i]; break;
+        }
+        r[i] = std::fma(e, re, r[i]);
+        r[i + 1] = std::fma(e, im, r[i + 1]);
+    }
+    return r;
+}
+
+// complex number `lane` of b repeated N / 2 times
+template <size_t N, typename T, size_t M>
+static TxN<T, N> neon_sim_dup_complex(const TxN<T, M>& b, int lane)
+{
+    if (lane < 0 || 2 * lane + 1 >= (int)M) {
+        fprintf(stderr, "%s: lane %d is out of range [0, %d]\n", __FUNCTION__, lane, (int)M / 2 - 1);
+        abort();
+    }
+    TxN<T, N> r;
+    for (size_t i = 0; i < N; i += 2) {
+        r[i] = b[2 * lane];
+        r[i + 1] = b[2 * lane + 1];
+    }
+    return r;
+}
+
+#if defined(__FMA__)
+template <int rot>
+static float32x4_t neon_sim_cmlaq_f32_fma(float32x4_t r, float32x4_t a, float32x4_t b)
+{
+    const __m128 va = _mm_loadu_ps(a.val);
+    const __m128 vb = _mm_loadu_ps(b.val);
+    const __m128 e = (rot == 0 || rot == 180) ? _mm_moveldup_ps(va) : _mm_movehdup_ps(va);
+    __m128 s;
+    switch (rot) {
+    case 0: s = vb; break;
+    case 90: s = _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f)); break;
+    case 180: s = _mm_xor_ps(vb, _mm_set1_ps(-0.0f)); break;
+    default: s = _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f)); break;
+    }
+    _mm_storeu_ps(r.val, _mm_fmadd_ps(e, s, _mm_loadu_ps(r.val)));
+    return r;
+}
+
+template <int rot>
+static float64x2_t neon_sim_cmlaq_f64_fma(float64x2_t r, float64x2_t a, float64x2_t b)
+{
+    const __m128d va = _mm_loadu_pd(a.val);
+    const __m128d vb = _mm_loadu_pd(b.val);
+    const __m128d e = (rot == 0 || rot == 180) ? _mm_unpacklo_pd(va, va) : _mm_unpackhi_pd(va, va);
+    __m128d s;
+    switch (rot) {
+    case 0: s = vb; break;
+    case 90: s = _mm_xor_pd(_mm_shuffle_pd(vb, vb, 1), _mm_set_pd(0.0, -0.0)); break;
+    case 180: s = _mm_xor_pd(vb, _mm_set1_pd(-0.0)); break;
+    default: s = _mm_xor_pd(_mm_shuffle_pd(vb, vb, 1), _mm_set_pd(-0.0, 0.0)); break;
+    }
+    _mm_storeu_pd(r.val, _mm_fmadd_pd(e, s, _mm_loadu_pd(r.val)));
+    return r;
+}
+#define neon_sim_cmlaq_f32 neon_sim_cmlaq_f32_fma
+#define neon_sim_cmlaq_f64 neon_sim_cmlaq_f64_fma
+#else
+#define neon_sim_cmlaq_f32 neon_sim_cmla
+#define neon_sim_cmlaq_f64 neon_sim_cmla
+#endif // __FMA__
+
+float32x2_t vcmla_f32(float32x2_t r, float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<0>(r, a, b), fpcr);
+}
+
+float32x4_t vcmlaq_f32(float32x4_t r, float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<0>(r, a, b), fpcr);
+}
+
+float64x2_t vcmlaq_f64(float64x2_t r, float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f64<0>(r, a, b), fpcr);
+}
+
+float32x2_t vcmla_rot90_f32(float32x2_t r, float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<90>(r, a, b), fpcr);
+}
+
+float32x4_t vcmlaq_rot90_f32(float32x4_t r, float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<90>(r, a, b), fpcr);
+}
+
+float64x2_t vcmlaq_rot90_f64(float64x2_t r, float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f64<90>(r, a, b), fpcr);
+}
+
+float32x2_t vcmla_rot180_f32(float32x2_t r, float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<180>(r, a, b), fpcr);
+}
+
+float32x4_t vcmlaq_rot180_f32(float32x4_t r, float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<180>(r, a, b), fpcr);
+}
+
+float64x2_t vcmlaq_rot180_f64(float64x2_t r, float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f64<180>(r, a, b), fpcr);
+}
+
+float32x2_t vcmla_rot270_f32(float32x2_t r, float32x2_t a, float32x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<270>(r, a, b), fpcr);
+}
+
+float32x4_t vcmlaq_rot270_f32(float32x4_t r, float32x4_t a, float32x4_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<270>(r, a, b), fpcr);
+}
+
+float64x2_t vcmlaq_rot270_f64(float64x2_t r, float64x2_t a, float64x2_t b)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f64<270>(r, a, b), fpcr);
+}
+
+float32x2_t vcmla_lane_f32(float32x2_t r, float32x2_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<0>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_laneq_f32(float32x2_t r, float32x2_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<0>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_lane_f32(float32x4_t r, float32x4_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<0>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_laneq_f32(float32x4_t r, float32x4_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<0>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot90_lane_f32(float32x2_t r, float32x2_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<90>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot90_laneq_f32(float32x2_t r, float32x2_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<90>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot90_lane_f32(float32x4_t r, float32x4_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<90>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot90_laneq_f32(float32x4_t r, float32x4_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<90>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot180_lane_f32(float32x2_t r, float32x2_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<180>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot180_laneq_f32(float32x2_t r, float32x2_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<180>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot180_lane_f32(float32x4_t r, float32x4_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<180>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot180_laneq_f32(float32x4_t r, float32x4_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<180>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot270_lane_f32(float32x2_t r, float32x2_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<270>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x2_t vcmla_rot270_laneq_f32(float32x2_t r, float32x2_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmla<270>(r, a, neon_sim_dup_complex<2>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot270_lane_f32(float32x4_t r, float32x4_t a, float32x2_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<270>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+float32x4_t vcmlaq_rot270_laneq_f32(float32x4_t r, float32x4_t a, float32x4_t b, const int lane)
+{
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cmlaq_f32<270>(r, a, neon_sim_dup_complex<4>(b, lane)), fpcr);
+}
+
+// FCADD adds the negated element, rot 90 (a + j*b) or 270 (a - j*b)
+template <int rot, typename T, size_t N>
+static TxN<T, N> neon_sim_cadd(const TxN<T, N>& a, const TxN<T, N>& b)
 {
-    uint8x16_t r;
-    for (int i = 0; i < 16; i+=4)
-    {
-        r[i + 0] = vec[i + 3];
-        r[i + 1] = vec[i + 2];
-        r[i + 2] = vec[i + 1];
-        r[i + 3] = vec[i + 0];
+    TxN<T, N> r;
+    for (size_t i = 0; i < N; i += 2) {
+        r[i] = a[i] + (rot == 90 ? -b[i + 1] : b[i + 1]);
+        r[i + 1] = a[i + 1] + (rot == 90 ? b[i] : -b[i]);
     }
     return r;
 }
 
-uint16x8_t	vrev32q_u16	(uint16x8_t vec)
+#if defined(__FMA__)
+template <int rot>
+static float32x4_t neon_sim_caddq_f32_sse(float32x4_t a, float32x4_t b)
 {
-    uint16x8_t r;
-    for (int i = 0; i < 8; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
-    }
+    const __m128 vb = _mm_loadu_ps(b.val);
+    const __m128 sign = rot == 90 ? _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f) : _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    const __m128 s = _mm_xor_ps(_mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1)), sign);
+    float32x4_t r;
+    _mm_storeu_ps(r.val, _mm_add_ps(_mm_loadu_ps(a.val), s));
     return r;
 }
+#define neon_sim_caddq_f32 neon_sim_caddq_f32_sse
+#else
+#define neon_sim_caddq_f32 neon_sim_cadd
+#endif // __FMA__
 
-// vrev64_type:
-int8x8_t	vrev64_s8	(int8x8_t vec)
+float32x2_t vcadd_rot90_f32(float32x2_t a, float32x2_t b)
 {
-    int8x8_t r;
-    for (int i = 0; i < 8; i+=8)
-    {
-        r[i + 0] = vec[i + 7];
-        r[i + 1] = vec[i + 6];
-        r[i + 2] = vec[i + 5];
-        r[i + 3] = vec[i + 4];
-        r[i + 4] = vec[i + 3];
-        r[i + 5] = vec[i + 2];
-        r[i + 6] = vec[i + 1];
-        r[i + 7] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cadd<90>(a, b), fpcr);
 }
 
-int16x4_t	vrev64_s16	(int16x4_t vec)
+float32x4_t vcaddq_rot90_f32(float32x4_t a, float32x4_t b)
 {
-    int16x4_t r;
-    for (int i = 0; i < 4; i+=4)
-    {
-        r[i + 0] = vec[i + 3];
-        r[i + 1] = vec[i + 2];
-        r[i + 2] = vec[i + 1];
-        r[i + 3] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_caddq_f32<90>(a, b), fpcr);
 }
 
-int32x2_t	vrev64_s32	(int32x2_t vec)
+float64x2_t vcaddq_rot90_f64(float64x2_t a, float64x2_t b)
 {
-    int32x2_t r;
-    for (int i = 0; i < 2; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cadd<90>(a, b), fpcr);
 }
 
-uint8x8_t	vrev64_u8	(uint8x8_t vec)
+float32x2_t vcadd_rot270_f32(float32x2_t a, float32x2_t b)
 {
-    uint8x8_t r;
-    for (int i = 0; i < 8; i+=8)
-    {
-        r[i + 0] = vec[i + 7];
-        r[i + 1] = vec[i + 6];
-        r[i + 2] = vec[i + 5];
-        r[i + 3] = vec[i + 4];
-        r[i + 4] = vec[i + 3];
-        r[i + 5] = vec[i + 2];
-        r[i + 6] = vec[i + 1];
-        r[i + 7] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cadd<270>(a, b), fpcr);
 }
 
-uint16x4_t	vrev64_u16	(uint16x4_t vec)
+float32x4_t vcaddq_rot270_f32(float32x4_t a, float32x4_t b)
 {
-    uint16x4_t r;
-    for (int i = 0; i < 4; i+=4)
-    {
-        r[i + 0] = vec[i + 3];
-        r[i + 1] = vec[i + 2];
-        r[i + 2] = vec[i + 1];
-        r[i + 3] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_caddq_f32<270>(a, b), fpcr);
 }
 
-uint32x2_t	vrev64_u32	(uint32x2_t vec)
+float64x2_t vcaddq_rot270_f64(float64x2_t a, float64x2_t b)
 {
-    uint32x2_t r;
-    for (int i = 0; i < 2; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
-    }
-    return r;
+    const uint32_t fpcr = neon_sim_fpcr();
+    return neon_sim_fp_result(neon_sim_cadd<270>(a, b), fpcr);
 }
 
-float32x2_t	vrev64_f32	(float32x2_t vec)
+
+//----------------------------------------------------------------------
+// 5. Cryptography
+//----------------------------------------------------------------------
+// Built with -maes / -msha (NEON_SIM_CRYPTO_NI) the rounds run on AES-NI and
+// SHA-NI. x86 rounds end with AddRoundKey where ARM starts with it, and x86
+// has no bare MixColumns, so both paths are composed to give the ARM result.
+
+static const uint8_t neon_sim_aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static const uint8_t neon_sim_aes_inv_sbox[256] = {
+    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d,
+};
+
+#if defined(__AES__) || defined(__SHA__)
+static inline __m128i neon_sim_to_m128i(const uint8x16_t& a)
 {
-    float32x2_t r;
-    for (int i = 0; i < 2; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
-    }
-    return r;
+    return _mm_loadu_si128((const __m128i*)a.val);
 }
 
-// vrev64q_type:
-int8x16_t	vrev64q_s8	(int8x16_t vec)
+static inline uint8x16_t neon_sim_from_m128i(__m128i a)
 {
-    int8x16_t r;
-    for (int i = 0; i < 8; i+=8)
-    {
-        r[i + 0] = vec[i + 7];
-        r[i + 1] = vec[i + 6];
-        r[i + 2] = vec[i + 5];
-        r[i + 3] = vec[i + 4];
-        r[i + 4] = vec[i + 3];
-        r[i + 5] = vec[i + 2];
-        r[i + 6] = vec[i + 1];
-        r[i + 7] = vec[i + 0];
-    }
+    uint8x16_t r;
+    _mm_storeu_si128((__m128i*)r.val, a);
     return r;
 }
+#endif // __AES__ || __SHA__
 
-int16x8_t	vrev64q_s16	(int16x8_t vec)
+// multiply by x in GF(2^8) mod x^8 + x^4 + x^3 + x + 1
+static inline uint8_t neon_sim_aes_xtime(uint8_t b)
 {
-    int16x8_t r;
-    for (int i = 0; i < 4; i+=4)
-    {
-        r[i + 0] = vec[i + 3];
-        r[i + 1] = vec[i + 2];
-        r[i + 2] = vec[i + 1];
-        r[i + 3] = vec[i + 0];
-    }
-    return r;
+    return (uint8_t)((b << 1) ^ ((b & 0x80) ? 0x1b : 0));
 }
 
-int32x4_t	vrev64q_s32	(int32x4_t vec)
+// MixColumns on column c: each byte becomes 2 a_i + 3 a_i+1 + a_i+2 + a_i+3
+static inline void neon_sim_aes_mix_column(uint8_t* r, const uint8_t* a)
 {
-    int32x4_t r;
-    for (int i = 0; i < 4; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
+    const uint8_t all = a[0] ^ a[1] ^ a[2] ^ a[3];
+    for (int i = 0; i < 4; i++) {
+        r[i] = a[i] ^ all ^ neon_sim_aes_xtime(a[i] ^ a[(i + 1) % 4]);
     }
-    return r;
 }
 
-uint8x16_t	vrev64q_u8	(uint8x16_t vec)
+uint8x16_t vaeseq_u8(uint8x16_t data, uint8x16_t key)
 {
+#if defined(__AES__)
+    // AESENCLAST = AddRoundKey(ShiftRows(SubBytes(s)), k): xor the key first, last key zero
+    const __m128i s = _mm_xor_si128(neon_sim_to_m128i(data), neon_sim_to_m128i(key));
+    return neon_sim_from_m128i(_mm_aesenclast_si128(s, _mm_setzero_si128()));
+#else
     uint8x16_t r;
-    for (int i = 0; i < 16; i+=8)
-    {
-        r[i + 0] = vec[i + 7];
-        r[i + 1] = vec[i + 6];
-        r[i + 2] = vec[i + 5];
-        r[i + 3] = vec[i + 4];
-        r[i + 4] = vec[i + 3];
-        r[i + 5] = vec[i + 2];
-        r[i + 6] = vec[i + 1];
-        r[i + 7] = vec[i + 0];
+    for (int i = 0; i < 16; i++) {
+        // ShiftRows: row i % 4 of column i / 4 comes from column (i / 4 + i % 4) % 4
+        const int src = (i + 4 * (i % 4)) % 16;
+        r[i] = neon_sim_aes_sbox[data[src] ^ key[src]];
     }
     return r;
+#endif // __AES__
 }
 
-uint16x8_t	vrev64q_u16	(uint16x8_t vec)
+uint8x16_t vaesdq_u8(uint8x16_t data, uint8x16_t key)
 {
-    uint16x8_t r;
-    for (int i = 0; i < 8; i+=4)
-    {
-        r[i + 0] = vec[i + 3];
-        r[i + 1] = vec[i + 2];
-        r[i + 2] = vec[i + 1];
-        r[i + 3] = vec[i + 0];
+#if defined(__AES__)
+    const __m128i s = _mm_xor_si128(neon_sim_to_m128i(data), neon_sim_to_m128i(key));
+    return neon_sim_from_m128i(_mm_aesdeclast_si128(s, _mm_setzero_si128()));
+#else
+    uint8x16_t r;
+    for (int i = 0; i < 16; i++) {
+        // InvShiftRows: row i % 4 of column i / 4 comes from column (i / 4 - i % 4) % 4
+        const int src = (i + 16 - 4 * (i % 4)) % 16;
+        r[i] = neon_sim_aes_inv_sbox[data[src] ^ key[src]];
     }
     return r;
+#endif // __AES__
 }
 
-uint32x4_t	vrev64q_u32	(uint32x4_t vec)
+uint8x16_t vaesmcq_u8(uint8x16_t data)
 {
-    uint32x4_t r;
-    for (int i = 0; i < 4; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
+#if defined(__AES__)
+    // AESDECLAST undoes ShiftRows and SubBytes, AESENC redoes them and adds MixColumns
+    const __m128i zero = _mm_setzero_si128();
+    return neon_sim_from_m128i(_mm_aesenc_si128(_mm_aesdeclast_si128(neon_sim_to_m128i(data), zero), zero));
+#else
+    uint8x16_t r;
+    for (int c = 0; c < 16; c += 4) {
+        neon_sim_aes_mix_column(&r[c], &data[c]);
     }
     return r;
+#endif // __AES__
 }
 
-float32x4_t	vrev64q_f32	(float32x4_t vec)
+uint8x16_t vaesimcq_u8(uint8x16_t data)
 {
-    float32x4_t r;
-    for (int i = 0; i < 4; i+=2)
-    {
-        r[i + 0] = vec[i + 1];
-        r[i + 1] = vec[i + 0];
+#if defined(__AES__)
+    return neon_sim_from_m128i(_mm_aesimc_si128(neon_sim_to_m128i(data)));
+#else
+    // InvMixColumns = MixColumns after adding 4 (a_i + a_i+2) to a_i
+    uint8x16_t r;
+    for (int c = 0; c < 16; c += 4) {
+        const uint8_t u = neon_sim_aes_xtime(neon_sim_aes_xtime(data[c] ^ data[c + 2]));
+        const uint8_t v = neon_sim_aes_xtime(neon_sim_aes_xtime(data[c + 1] ^ data[c + 3]));
+        const uint8_t t[4] = { (uint8_t)(data[c] ^ u), (uint8_t)(data[c + 1] ^ v), (uint8_t)(data[c + 2] ^ u), (uint8_t)(data[c + 3] ^ v) };
+        neon_sim_aes_mix_column(&r[c], t);
     }
     return r;
+#endif // __AES__
 }
 
+static inline uint32_t neon_sim_rol32(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
 
-// Vector arithmetic / Division
-#if __aarch64__
-// vdiv_type
-float32x2_t	vdiv_f32	(float32x2_t a, float32x2_t b)
+static inline uint32_t neon_sim_ror32(uint32_t x, int n)
 {
-    float32x2_t r;
-    for (int i = 0; i < 2; i++)
-    {
-        r[i] = a[i] / b[i];
-    }
-    return r;
+    return (x >> n) | (x << (32 - n));
 }
 
-float64x1_t	vdiv_f64	(float64x1_t a, float64x1_t b)
+// SHA1C / SHA1P / SHA1M: f is 0 choose, 1 parity, 2 majority
+static uint32x4_t neon_sim_sha1_rounds(uint32x4_t x, uint32_t y, uint32x4_t w, int f)
 {
-    float64x1_t r;
-    for (int i = 0; i < 1; i++)
-    {
-        r[i] = a[i] / b[i];
+#if defined(__SHA__)
+    // SHA1RNDS4 keeps A in the top dword, adds K itself and takes E in the top message dword
+    static const uint32_t k[3] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc };
+    const __m128i abcd = _mm_set_epi32((int)x[0], (int)x[1], (int)x[2], (int)x[3]);
+    const __m128i msg = _mm_set_epi32((int)(w[0] - k[f] + y), (int)(w[1] - k[f]), (int)(w[2] - k[f]), (int)(w[3] - k[f]));
+    __m128i r;
+    switch (f) {
+    case 0: r = _mm_sha1rnds4_epu32(abcd, msg, 0); break;
+    case 1: r = _mm_sha1rnds4_epu32(abcd, msg, 1); break;
+    default: r = _mm_sha1rnds4_epu32(abcd, msg, 2); break;
     }
-    return r;
+    uint32_t out[4];
+    _mm_storeu_si128((__m128i*)out, r);
+    uint32x4_t d;
+    for (int i = 0; i < 4; i++) {
+        d[i] = out[3 - i];
+    }
+    return d;
+#else
+    for (int e = 0; e < 4; e++) {
+        uint32_t t;
+        if (f == 0) {
+            t = (x[1] & x[2]) | (~x[1] & x[3]);
+        } else if (f == 1) {
+            t = x[1] ^ x[2] ^ x[3];
+        } else {
+            t = (x[1] & x[2]) | (x[1] & x[3]) | (x[2] & x[3]);
+        }
+        y = y + neon_sim_rol32(x[0], 5) + t + w[e];
+        x[1] = neon_sim_rol32(x[1], 30);
+        // <y, x> = ROL(y : x, 32)
+        const uint32_t top = x[3];
+        x[3] = x[2];
+        x[2] = x[1];
+        x[1] = x[0];
+        x[0] = y;
+        y = top;
+    }
+    return x;
+#endif // __SHA__
 }
 
-//float16x4_t	vdiv_f16	(float16x4_t a, float16x4_t b);
+uint32x4_t vsha1cq_u32(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk)
+{
+    return neon_sim_sha1_rounds(hash_abcd, hash_e, wk, 0);
+}
 
-// vdivq_type
-float32x4_t	vdivq_f32	(float32x4_t a, float32x4_t b)
+uint32x4_t vsha1pq_u32(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk)
 {
-    float32x4_t r;
-    for (int i = 0; i < 4; i++)
-    {
-        r[i] = a[i] / b[i];
-    }
-    return r;
+    return neon_sim_sha1_rounds(hash_abcd, hash_e, wk, 1);
 }
 
-float64x2_t	vdivq_f64	(float64x2_t a, float64x2_t b)
+uint32x4_t vsha1mq_u32(uint32x4_t hash_abcd, uint32_t hash_e, uint32x4_t wk)
 {
-    float64x2_t r;
-    for (int i = 0; i < 2; i++)
-    {
-        r[i] = a[i] / b[i];
-    }
-    return r;
+    return neon_sim_sha1_rounds(hash_abcd, hash_e, wk, 2);
 }
 
-//float16x8_t	vdivq_f16	(float16x8_t a, float16x8_t b);
-#endif // __aarch64__
+uint32_t vsha1h_u32(uint32_t hash_e)
+{
+    return neon_sim_rol32(hash_e, 30);
+}
 
-// saturated shift right and narrow
-int8x8_t vqshrn_n_s16 (int16x8_t a, const int n)
+uint32x4_t vsha1su0q_u32(uint32x4_t w0_3, uint32x4_t w4_7, uint32x4_t w8_11)
 {
-    int8x8_t r;
-    for (int i = 0; i < 8; i++)
-    {
-        r[i] = std::min(std::max(a[i] >> n, INT8_MIN), INT8_MAX);
+    // {w2, w3, w4, w5} ^ w0_3 ^ w8_11
+    const uint32_t t[4] = { w0_3[2], w0_3[3], w4_7[0], w4_7[1] };
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = t[i] ^ w0_3[i] ^ w8_11[i];
     }
     return r;
 }
 
-int16x4_t vqshrn_n_s32 (int32x4_t a, const int n)
+uint32x4_t vsha1su1q_u32(uint32x4_t tw0_3, uint32x4_t w12_15)
 {
-    int16x4_t r;
-    for (int i = 0; i < 4; i++)
-    {
-        r[i] = std::min(std::max(a[i] >> n, INT16_MIN), INT16_MAX);
+    const uint32_t t[4] = { tw0_3[0] ^ w12_15[1], tw0_3[1] ^ w12_15[2], tw0_3[2] ^ w12_15[3], tw0_3[3] };
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = neon_sim_rol32(t[i], 1);
     }
+    r[3] ^= neon_sim_rol32(t[0], 2);
     return r;
 }
 
-int32x2_t vqshrn_n_s64 (int64x2_t a, const int n)
+// four SHA-256 rounds on x = abcd, y = efgh; returns the new abcd (part1) or efgh
+static uint32x4_t neon_sim_sha256_rounds(uint32x4_t x, uint32x4_t y, uint32x4_t w, bool part1)
 {
-    int32x2_t r;
-    for (int i = 0; i < 2; i++)
-    {
-        r[i] = std::min<int32_t>(std::max<int64_t>(a[i] >> n, INT32_MIN), INT32_MAX);
+#if defined(__SHA__)
+    // SHA256RNDS2 runs two rounds on ABEF / CDGH with A and C in the top dwords
+    const __m128i abef = _mm_set_epi32((int)x[0], (int)x[1], (int)y[0], (int)y[1]);
+    const __m128i cdgh = _mm_set_epi32((int)x[2], (int)x[3], (int)y[2], (int)y[3]);
+    const __m128i wk = _mm_loadu_si128((const __m128i*)w.val);
+    const __m128i abef2 = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    const __m128i abef4 = _mm_sha256rnds2_epu32(abef, abef2, _mm_shuffle_epi32(wk, 0x0e));
+    uint32_t hi[4], lo[4];
+    _mm_storeu_si128((__m128i*)hi, abef4);
+    _mm_storeu_si128((__m128i*)lo, abef2);
+    uint32x4_t r;
+    if (part1) {
+        r[0] = hi[3]; r[1] = hi[2]; r[2] = lo[3]; r[3] = lo[2];
+    } else {
+        r[0] = hi[1]; r[1] = hi[0]; r[2] = lo[1]; r[3] = lo[0];
+    }
+    return r;
+#else
+    for (int e = 0; e < 4; e++) {
+        const uint32_t chs = (y[0] & y[1]) | (~y[0] & y[2]);
+        const uint32_t maj = (x[0] & x[1]) | (x[0] & x[2]) | (x[1] & x[2]);
+        const uint32_t sigma1 = neon_sim_ror32(y[0], 6) ^ neon_sim_ror32(y[0], 11) ^ neon_sim_ror32(y[0], 25);
+        const uint32_t sigma0 = neon_sim_ror32(x[0], 2) ^ neon_sim_ror32(x[0], 13) ^ neon_sim_ror32(x[0], 22);
+        const uint32_t t = y[3] + sigma1 + chs + w[e];
+        x[3] = t + x[3];
+        y[3] = t + sigma0 + maj;
+        // <y, x> = ROL(y : x, 32)
+        const uint32_t x3 = x[3];
+        const uint32_t y3 = y[3];
+        for (int i = 3; i > 0; i--) {
+            x[i] = x[i - 1];
+            y[i] = y[i - 1];
+        }
+        x[0] = y3;
+        y[0] = x3;
     }
-    return r;
+    return part1 ? x : y;
+#endif // __SHA__
 }
 
-uint8x8_t vqshrn_n_u16 (uint16x8_t a, const int n)
+uint32x4_t vsha256hq_u32(uint32x4_t hash_abcd, uint32x4_t hash_efgh, uint32x4_t wk)
 {
-    uint8x8_t r;
-    for (int i = 0; i < 8; i++)
-    {
-        r[i] = std::min(a[i] >> n, UINT8_MAX);
-    }
-    return r;
+    return neon_sim_sha256_rounds(hash_abcd, hash_efgh, wk, true);
 }
 
-uint16x4_t vqshrn_n_u32 (uint32x4_t a, const int n)
+uint32x4_t vsha256h2q_u32(uint32x4_t hash_efgh, uint32x4_t hash_abcd, uint32x4_t wk)
 {
-    uint16x4_t r;
-    for (int i = 0; i < 4; i++)
-    {
-        r[i] = std::min<uint32_t>(a[i] >> n, UINT16_MAX);
+    return neon_sim_sha256_rounds(hash_abcd, hash_efgh, wk, false);
+}
+
+uint32x4_t vsha256su0q_u32(uint32x4_t w0_3, uint32x4_t w4_7)
+{
+    const uint32_t t[4] = { w0_3[1], w0_3[2], w0_3[3], w4_7[0] };
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        r[i] = (neon_sim_ror32(t[i], 7) ^ neon_sim_ror32(t[i], 18) ^ (t[i] >> 3)) + w0_3[i];
     }
     return r;
 }
 
-uint32x2_t vqshrn_n_u64 (uint64x2_t a, const int n)
+uint32x4_t vsha256su1q_u32(uint32x4_t tw0_3, uint32x4_t w8_11, uint32x4_t w12_15)
 {
-    uint32x2_t r;
-    for (int i = 0; i < 2; i++)
-    {
-        r[i] = std::min<uint64_t>(a[i] >> n, UINT32_MAX);
+    const uint32_t t0[4] = { w8_11[1], w8_11[2], w8_11[3], w12_15[0] };
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++) {
+        // the upper two words use the two just computed
+        const uint32_t t1 = i < 2 ? w12_15[i + 2] : r[i - 2];
+        r[i] = (neon_sim_ror32(t1, 17) ^ neon_sim_ror32(t1, 19) ^ (t1 >> 10)) + tw0_3[i] + t0[i];
     }
     return r;
 }
@@ -9495,3 +11921,53 @@ std::ostream& operator <<(std::ostream& os, const float64x2x4_t& v_data)
 
 
 #endif // NEON_SIM_IMPLEMENTATION
+
+//----------------------------------------------------------------------
+// 7. NEON_SIM_FAST_SSE: route bit-exact intrinsics through NEON_2_SSE.h
+//----------------------------------------------------------------------
+// neon_sim_sse.cpp compiles NEON_2_SSE.h in its own TU and exports one
+// neon_sim_sse_<name>() per entry of neon_sim_sse.inc. neon_sim_fast_<name>()
+// wraps it with the sim register types. neon_sim_sse_routes.inc, generated by
+// neon_sim_sse_table, then redirects the intrinsics that matched the sim
+// bit for bit; `(vaddq_u8)(a, b)` still calls the sim.
+#if NEON_SIM_FAST_SSE
+
+#define NEON_SIM_SSE_1(name, R, A) \
+    void neon_sim_sse_##name(const void* a, void* r); \
+    static inline R neon_sim_fast_##name(A a) \
+    { \
+        R r; \
+        neon_sim_sse_##name(a.val, r.val); \
+        return r; \
+    }
+
+#define NEON_SIM_SSE_2(name, R, A, B) \
+    void neon_sim_sse_##name(const void* a, const void* b, void* r); \
+    static inline R neon_sim_fast_##name(A a, B b) \
+    { \
+        R r; \
+        neon_sim_sse_##name(a.val, b.val, r.val); \
+        return r; \
+    }
+
+#define NEON_SIM_SSE_3(name, R, A, B, C) \
+    void neon_sim_sse_##name(const void* a, const void* b, const void* c, void* r); \
+    static inline R neon_sim_fast_##name(A a, B b, C c) \
+    { \
+        R r; \
+        neon_sim_sse_##name(a.val, b.val, c.val, r.val); \
+        return r; \
+    }
+
+#include "neon_sim_sse.inc"
+
+#undef NEON_SIM_SSE_1
+#undef NEON_SIM_SSE_2
+#undef NEON_SIM_SSE_3
+
+// neon_sim_sse_table defines this to compare the sim against every candidate
+#ifndef NEON_SIM_SSE_NO_ROUTES
+#include "neon_sim_sse_routes.inc"
+#endif // NEON_SIM_SSE_NO_ROUTES
+
+#endif // NEON_SIM_FAST_SSE
@@ -0,0 +1,637 @@
+#pragma once
+
+//
+// SME companion of arm_sve_sim.hpp: streaming mode, the ZA tile array and the
+// outer-product-accumulate intrinsics, so SME GEMM micro-kernels can be
+// written and checked off-device.
+//
+// usage:
+//#define NEON_SIM_IMPLEMENTATION   // in one .cpp, as for arm_neon_sim.hpp
+//
+// #if __ARM_FEATURE_SME
+// #include <arm_sme.h>
+// #else
+// #include "arm_sme_sim.hpp"
+// #endif
+//
+// sme_sim_set_svl(512);               // or NEON_SIM_SME_SVL=512 in the environment, default 512
+// SmeStreamingScope streaming;        // SMSTART ... SMSTOP, stands in for __arm_streaming / __arm_new("za")
+// svzero_za();
+// for (int k = 0; k < K; k++)
+// {
+//     svfloat32_t a = svld1_f32(pn, At + k * M);       // column k of A, packed
+//     svfloat32_t b = svld1_f32(pm, B + k * N);        // row k of B
+//     svmopa_za32_f32_m(0, pn, pm, a, b);
+// }
+// for (uint32_t r = 0; r < svcntsw(); r++)
+// {
+//     svst1_hor_za32(0, r, pm, C + r * N);
+// }
+//
+// ZA is an SVL x SVL byte array per thread. A tile of element size E bytes is
+// every E-th ZA row: horizontal slice i of ZAt is ZA row i * E + t, so ZA0.S
+// shares its rows with ZA0.D and ZA4.D exactly as on hardware. ZA
+// intrinsics abort unless the thread is in streaming mode with ZA enabled.
+//
+// In streaming mode the SVE intrinsics run at the streaming vector length
+// (svcntb() == svcntsb()); sme_sim_smstop() restores the non-streaming one.
+//
+// FMOPA is fused per product. BFMOPA adds the two exact bf16 products of a
+// pair to the fp32 accumulator in order; SMOPA / UMOPA / SUMOPA / USMOPA add
+// four 8-bit products to int32, wrapping. A product only counts when both its
+// row (pn) and column (pm) element are active.
+//
+// Covered: svcnts*, svzero_za / svzero_mask_za, svld1 / svst1 hor / ver for
+// za8..za64, svldr_za / svstr_za, svread / svwrite hor / ver, svmopa / svmops
+// za32 f32 bf16 s8 u8, svsumopa / svusmopa, za64 f64, svaddha / svaddva za32.
+//
+
+#include "arm_sve_sim.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+#define __ARM_FEATURE_SME 1
+#define __ARM_FEATURE_SME_F64F64 1
+#define __ARM_FEATURE_SVE_BF16 1
+
+//----------------------------------------------------------------------
+// 1. bfloat16
+//----------------------------------------------------------------------
+
+/// @brief brain float: the top half of an IEEE fp32, converted with round to nearest even
+struct bfloat16_t
+{
+    uint16_t bits;
+
+    bfloat16_t() : bits(0) {}
+
+    bfloat16_t(float f)
+    {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        if ((u & 0x7fffffff) > 0x7f800000)
+        {
+            bits = (uint16_t)((u >> 16) | 0x40); // quiet NaN
+        }
+        else
+        {
+            bits = (uint16_t)((u + 0x7fff + ((u >> 16) & 1)) >> 16);
+        }
+    }
+
+    operator float() const
+    {
+        const uint32_t u = (uint32_t)bits << 16;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+};
+
+using svbfloat16_t = TxN<bfloat16_t, SVE_SIM_MAX_BYTES / 2>;
+
+inline svbfloat16_t svdup_n_bf16(bfloat16_t v)
+{
+    svbfloat16_t r;
+    sve_sim_detail::for_lanes<bfloat16_t>([&](size_t i) { r.val[i] = v; });
+    return r;
+}
+
+inline svbfloat16_t svld1_bf16(svbool_t pg, const bfloat16_t* base)
+{
+    svbfloat16_t r;
+    sve_sim_detail::for_lanes<bfloat16_t>([&](size_t i) {
+        if (sve_sim_detail::active<bfloat16_t>(pg, i))
+        {
+            r.val[i] = base[i];
+        }
+    });
+    return r;
+}
+
+inline void svst1_bf16(svbool_t pg, bfloat16_t* base, svbfloat16_t v)
+{
+    sve_sim_detail::for_lanes<bfloat16_t>([&](size_t i) {
+        if (sve_sim_detail::active<bfloat16_t>(pg, i))
+        {
+            base[i] = v.val[i];
+        }
+    });
+}
+
+inline svbfloat16_t svld1(svbool_t pg, const bfloat16_t* base) { return svld1_bf16(pg, base); }
+inline void svst1(svbool_t pg, bfloat16_t* base, svbfloat16_t v) { svst1_bf16(pg, base, v); }
+
+//----------------------------------------------------------------------
+// 2. streaming mode
+//----------------------------------------------------------------------
+
+/// @brief set this thread's streaming vector length, a power of two in [128, 2048] bits; aborts otherwise or when streaming
+void sme_sim_set_svl(int bits);
+
+/// @brief this thread's streaming vector length in bits
+int sme_sim_get_svl();
+
+/// @brief SMSTART: enter streaming mode, the SVE vector length becomes SVL, and enable ZA zeroed if it was off
+void sme_sim_smstart();
+
+/// @brief SMSTOP: leave streaming mode, restore the vector length and turn ZA off
+void sme_sim_smstop();
+
+namespace sme_sim_detail {
+extern thread_local int svl_bytes;
+extern thread_local bool streaming;
+extern thread_local bool za_enabled;
+extern thread_local unsigned char za[SVE_SIM_MAX_BYTES * SVE_SIM_MAX_BYTES];
+int init_svl();
+void za_unavailable(const char* fn);
+void bad_tile(const char* fn, uint64_t tile);
+} // namespace sme_sim_detail
+
+inline uint64_t svcntsb()
+{
+    const int svl = sme_sim_detail::svl_bytes;
+    return (uint64_t)(svl ? svl : sme_sim_detail::init_svl());
+}
+
+inline uint64_t svcntsh()
+{
+    return svcntsb() / 2;
+}
+
+inline uint64_t svcntsw()
+{
+    return svcntsb() / 4;
+}
+
+inline uint64_t svcntsd()
+{
+    return svcntsb() / 8;
+}
+
+inline bool __arm_has_sme()
+{
+    return true;
+}
+
+inline bool __arm_in_streaming_mode()
+{
+    return sme_sim_detail::streaming;
+}
+
+/// @brief streaming mode with ZA for the lifetime of the object
+class SmeStreamingScope
+{
+public:
+    SmeStreamingScope() { sme_sim_smstart(); }
+    ~SmeStreamingScope() { sme_sim_smstop(); }
+
+private:
+    SmeStreamingScope(const SmeStreamingScope&);
+    SmeStreamingScope& operator=(const SmeStreamingScope&);
+};
+
+//----------------------------------------------------------------------
+// 3. ZA helpers
+//----------------------------------------------------------------------
+
+namespace sme_sim_detail {
+
+inline void check_za(const char* fn)
+{
+    if (!streaming || !za_enabled)
+    {
+        za_unavailable(fn);
+    }
+}
+
+/// @brief ZA row of horizontal slice `slice` of tile `tile` with E = sizeof(T); the slice index wraps like Wv + offs
+template<typename T>
+inline unsigned char* za_row(const char* fn, uint64_t tile, uint32_t slice)
+{
+    if (tile >= sizeof(T))
+    {
+        bad_tile(fn, tile);
+    }
+    const size_t dim = svcntsb() / sizeof(T);
+    return za + ((slice % dim) * sizeof(T) + tile) * SVE_SIM_MAX_BYTES;
+}
+
+/// @brief f(i, row) on a copy of every horizontal slice i of a T tile, written back afterwards
+template<typename T, typename F>
+inline void update_rows(const char* fn, uint64_t tile, F f)
+{
+    check_za(fn);
+    const size_t bytes = svcntsb();
+    const size_t dim = bytes / sizeof(T);
+    T row[SVE_SIM_MAX_BYTES / sizeof(T)];
+    unsigned char* p = za_row<T>(fn, tile, 0);
+    for (size_t i = 0; i < dim; i++, p += sizeof(T) * SVE_SIM_MAX_BYTES)
+    {
+        memcpy((void*)row, p, bytes);
+        if (f(i, row))
+        {
+            memcpy(p, (const void*)row, bytes);
+        }
+    }
+}
+
+template<typename T>
+inline bool all_active(const svbool_t& pg)
+{
+    bool all = true;
+    sve_sim_detail::for_lanes<T>([&](size_t i) { all = all && sve_sim_detail::active<T>(pg, i); });
+    return all;
+}
+
+// FMOPA / FMOPS: ZA[i][j] = fma(+-zn[i], zm[j], ZA[i][j])
+template<typename T, size_t N>
+inline void fmopa(const char* fn, uint64_t tile, const svbool_t& pn, const svbool_t& pm, const TxN<T, N>& zn,
+                  const TxN<T, N>& zm, bool subtract)
+{
+    const bool all_cols = all_active<T>(pm);
+    update_rows<T>(fn, tile, [&](size_t i, T* row) {
+        if (!sve_sim_detail::active<T>(pn, i))
+        {
+            return false;
+        }
+        const T a = subtract ? -zn.val[i] : zn.val[i];
+        if (all_cols)
+        {
+            sve_sim_detail::for_lanes<T>([&](size_t j) { row[j] = std::fma(a, zm.val[j], row[j]); });
+        }
+        else
+        {
+            sve_sim_detail::for_lanes<T>([&](size_t j) {
+                if (sve_sim_detail::active<T>(pm, j))
+                {
+                    row[j] = std::fma(a, zm.val[j], row[j]);
+                }
+            });
+        }
+        return true;
+    });
+}
+
+// sum of outer products: ZA[i][j] +-= sum over k < G of zn[G * i + k] * zm[G * j + k], in k order
+template<typename TA, size_t G, typename TN, size_t NN, typename TM, size_t NM>
+inline void mopa_sum(const char* fn, uint64_t tile, const svbool_t& pn, const svbool_t& pm, const TxN<TN, NN>& zn,
+                     const TxN<TM, NM>& zm, bool subtract)
+{
+    update_rows<TA>(fn, tile, [&](size_t i, TA* row) {
+        bool any = false;
+        for (size_t k = 0; k < G; k++)
+        {
+            any = any || sve_sim_detail::active<TN>(pn, G * i + k);
+        }
+        if (!any)
+        {
+            return false;
+        }
+        sve_sim_detail::for_lanes<TA>([&](size_t j) {
+            TA acc = row[j];
+            for (size_t k = 0; k < G; k++)
+            {
+                if (sve_sim_detail::active<TN>(pn, G * i + k) && sve_sim_detail::active<TM>(pm, G * j + k))
+                {
+                    const TA p = (TA)zn.val[G * i + k] * (TA)zm.val[G * j + k];
+                    acc = subtract ? sve_sim_detail::Arith<TA>::sub(acc, p) : sve_sim_detail::Arith<TA>::add(acc, p);
+                }
+            }
+            row[j] = acc;
+        });
+        return true;
+    });
+}
+
+// LD1 / ST1 to / from a slice: inactive elements load as zero and are not stored
+template<typename T>
+inline void load_slice(const char* fn, uint64_t tile, uint32_t slice, const svbool_t& pg, const void* ptr, bool vertical)
+{
+    check_za(fn);
+    const T* src = (const T*)ptr;
+    const size_t dim = svcntsb() / sizeof(T);
+    for (size_t j = 0; j < dim; j++)
+    {
+        const T v = sve_sim_detail::active<T>(pg, j) ? src[j] : (T)0;
+        if (vertical)
+        {
+            memcpy(za_row<T>(fn, tile, (uint32_t)j) + (slice % dim) * sizeof(T), &v, sizeof(T));
+        }
+        else
+        {
+            memcpy(za_row<T>(fn, tile, slice) + j * sizeof(T), &v, sizeof(T));
+        }
+    }
+}
+
+template<typename T>
+inline void store_slice(const char* fn, uint64_t tile, uint32_t slice, const svbool_t& pg, void* ptr, bool vertical)
+{
+    check_za(fn);
+    T* dst = (T*)ptr;
+    const size_t dim = svcntsb() / sizeof(T);
+    for (size_t j = 0; j < dim; j++)
+    {
+        if (sve_sim_detail::active<T>(pg, j))
+        {
+            const unsigned char* p = vertical ? za_row<T>(fn, tile, (uint32_t)j) + (slice % dim) * sizeof(T)
+                                              : za_row<T>(fn, tile, slice) + j * sizeof(T);
+            memcpy((void*)&dst[j], p, sizeof(T));
+        }
+    }
+}
+
+// MOVA: a slice to a vector (inactive lanes keep zd) and back (inactive elements unchanged)
+template<typename T, size_t N>
+inline TxN<T, N> read_slice(const char* fn, TxN<T, N> zd, const svbool_t& pg, uint64_t tile, uint32_t slice,
+                            bool vertical)
+{
+    check_za(fn);
+    const size_t dim = svcntsb() / sizeof(T);
+    for (size_t j = 0; j < dim; j++)
+    {
+        if (sve_sim_detail::active<T>(pg, j))
+        {
+            const unsigned char* p = vertical ? za_row<T>(fn, tile, (uint32_t)j) + (slice % dim) * sizeof(T)
+                                              : za_row<T>(fn, tile, slice) + j * sizeof(T);
+            memcpy((void*)&zd.val[j], p, sizeof(T));
+        }
+    }
+    return zd;
+}
+
+template<typename T, size_t N>
+inline void write_slice(const char* fn, uint64_t tile, uint32_t slice, const svbool_t& pg, const TxN<T, N>& zn,
+                        bool vertical)
+{
+    check_za(fn);
+    const size_t dim = svcntsb() / sizeof(T);
+    for (size_t j = 0; j < dim; j++)
+    {
+        if (sve_sim_detail::active<T>(pg, j))
+        {
+            unsigned char* p = vertical ? za_row<T>(fn, tile, (uint32_t)j) + (slice % dim) * sizeof(T)
+                                        : za_row<T>(fn, tile, slice) + j * sizeof(T);
+            memcpy(p, (const void*)&zn.val[j], sizeof(T));
+        }
+    }
+}
+
+} // namespace sme_sim_detail
+
+//----------------------------------------------------------------------
+// 4. ZA intrinsics
+//----------------------------------------------------------------------
+
+/// @brief ZERO { za }
+inline void svzero_za()
+{
+    sme_sim_detail::check_za(__FUNCTION__);
+    memset(sme_sim_detail::za, 0, sizeof(sme_sim_detail::za));
+}
+
+/// @brief ZERO of the 64-bit tiles whose bit is set in mask: ZA row r belongs to ZA(r % 8).D
+inline void svzero_mask_za(uint64_t mask)
+{
+    sme_sim_detail::check_za(__FUNCTION__);
+    for (size_t r = 0; r < svcntsb(); r++)
+    {
+        if (mask & (1u << (r % 8)))
+        {
+            memset(sme_sim_detail::za + r * SVE_SIM_MAX_BYTES, 0, SVE_SIM_MAX_BYTES);
+        }
+    }
+}
+
+/// @brief LDR ZA[slice]: one ZA array row of svcntsb() bytes
+inline void svldr_za(uint32_t slice, const void* ptr)
+{
+    sme_sim_detail::check_za(__FUNCTION__);
+    memcpy(sme_sim_detail::za + (slice % svcntsb()) * SVE_SIM_MAX_BYTES, ptr, svcntsb());
+}
+
+/// @brief STR ZA[slice]
+inline void svstr_za(uint32_t slice, void* ptr)
+{
+    sme_sim_detail::check_za(__FUNCTION__);
+    memcpy(ptr, sme_sim_detail::za + (slice % svcntsb()) * SVE_SIM_MAX_BYTES, svcntsb());
+}
+
+#define SME_SIM_LDST(bits, T) \
+    inline void svld1_hor_za##bits(uint64_t tile, uint32_t slice, svbool_t pg, const void* ptr) { sme_sim_detail::load_slice<T>(__FUNCTION__, tile, slice, pg, ptr, false); } \
+    inline void svld1_ver_za##bits(uint64_t tile, uint32_t slice, svbool_t pg, const void* ptr) { sme_sim_detail::load_slice<T>(__FUNCTION__, tile, slice, pg, ptr, true); } \
+    inline void svst1_hor_za##bits(uint64_t tile, uint32_t slice, svbool_t pg, void* ptr) { sme_sim_detail::store_slice<T>(__FUNCTION__, tile, slice, pg, ptr, false); } \
+    inline void svst1_ver_za##bits(uint64_t tile, uint32_t slice, svbool_t pg, void* ptr) { sme_sim_detail::store_slice<T>(__FUNCTION__, tile, slice, pg, ptr, true); }
+
+SME_SIM_LDST(8, uint8_t)
+SME_SIM_LDST(16, uint16_t)
+SME_SIM_LDST(32, uint32_t)
+SME_SIM_LDST(64, uint64_t)
+
+#undef SME_SIM_LDST
+
+#define SME_SIM_MOVA(bits, sfx, V, T) \
+    inline V svread_hor_za##bits##_##sfx##_m(V zd, svbool_t pg, uint64_t tile, uint32_t slice) { return sme_sim_detail::read_slice<T>(__FUNCTION__, zd, pg, tile, slice, false); } \
+    inline V svread_ver_za##bits##_##sfx##_m(V zd, svbool_t pg, uint64_t tile, uint32_t slice) { return sme_sim_detail::read_slice<T>(__FUNCTION__, zd, pg, tile, slice, true); } \
+    inline void svwrite_hor_za##bits##_##sfx##_m(uint64_t tile, uint32_t slice, svbool_t pg, V zn) { sme_sim_detail::write_slice<T>(__FUNCTION__, tile, slice, pg, zn, false); } \
+    inline void svwrite_ver_za##bits##_##sfx##_m(uint64_t tile, uint32_t slice, svbool_t pg, V zn) { sme_sim_detail::write_slice<T>(__FUNCTION__, tile, slice, pg, zn, true); } \
+    inline V svread_hor_za##bits##_m(V zd, svbool_t pg, uint64_t tile, uint32_t slice) { return svread_hor_za##bits##_##sfx##_m(zd, pg, tile, slice); } \
+    inline V svread_ver_za##bits##_m(V zd, svbool_t pg, uint64_t tile, uint32_t slice) { return svread_ver_za##bits##_##sfx##_m(zd, pg, tile, slice); } \
+    inline void svwrite_hor_za##bits##_m(uint64_t tile, uint32_t slice, svbool_t pg, V zn) { svwrite_hor_za##bits##_##sfx##_m(tile, slice, pg, zn); } \
+    inline void svwrite_ver_za##bits##_m(uint64_t tile, uint32_t slice, svbool_t pg, V zn) { svwrite_ver_za##bits##_##sfx##_m(tile, slice, pg, zn); }
+
+SME_SIM_MOVA(8, s8, svint8_t, int8_t)
+SME_SIM_MOVA(8, u8, svuint8_t, uint8_t)
+SME_SIM_MOVA(16, s16, svint16_t, int16_t)
+SME_SIM_MOVA(16, u16, svuint16_t, uint16_t)
+SME_SIM_MOVA(16, bf16, svbfloat16_t, bfloat16_t)
+SME_SIM_MOVA(32, s32, svint32_t, int32_t)
+SME_SIM_MOVA(32, u32, svuint32_t, uint32_t)
+SME_SIM_MOVA(32, f32, svfloat32_t, float32_t)
+SME_SIM_MOVA(64, s64, svint64_t, int64_t)
+SME_SIM_MOVA(64, u64, svuint64_t, uint64_t)
+SME_SIM_MOVA(64, f64, svfloat64_t, float64_t)
+
+#undef SME_SIM_MOVA
+
+// FMOPA / FMOPS, non-widening
+#define SME_SIM_FMOPA(bits, sfx, V, T) \
+    inline void svmopa_za##bits##_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn, V zm) { sme_sim_detail::fmopa<T>(__FUNCTION__, tile, pn, pm, zn, zm, false); } \
+    inline void svmops_za##bits##_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn, V zm) { sme_sim_detail::fmopa<T>(__FUNCTION__, tile, pn, pm, zn, zm, true); } \
+    inline void svmopa_za##bits##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn, V zm) { svmopa_za##bits##_##sfx##_m(tile, pn, pm, zn, zm); } \
+    inline void svmops_za##bits##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn, V zm) { svmops_za##bits##_##sfx##_m(tile, pn, pm, zn, zm); }
+
+SME_SIM_FMOPA(32, f32, svfloat32_t, float32_t)
+SME_SIM_FMOPA(64, f64, svfloat64_t, float64_t)
+
+#undef SME_SIM_FMOPA
+
+// BFMOPA / SMOPA / UMOPA / SUMOPA / USMOPA: widening sums of 2 or 4 products per za32 element
+#define SME_SIM_MOPA_SUM(name, sfx, G, VN, VM) \
+    inline void sv##name##a_za32_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, VN zn, VM zm) { sme_sim_detail::mopa_sum<sme_sim_detail::acc_##sfx, G>(__FUNCTION__, tile, pn, pm, zn, zm, false); } \
+    inline void sv##name##s_za32_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, VN zn, VM zm) { sme_sim_detail::mopa_sum<sme_sim_detail::acc_##sfx, G>(__FUNCTION__, tile, pn, pm, zn, zm, true); } \
+    inline void sv##name##a_za32_m(uint64_t tile, svbool_t pn, svbool_t pm, VN zn, VM zm) { sv##name##a_za32_##sfx##_m(tile, pn, pm, zn, zm); } \
+    inline void sv##name##s_za32_m(uint64_t tile, svbool_t pn, svbool_t pm, VN zn, VM zm) { sv##name##s_za32_##sfx##_m(tile, pn, pm, zn, zm); }
+
+namespace sme_sim_detail {
+// accumulator element per source suffix; USMOPA sums into the same int32 bits through uint32
+typedef float32_t acc_bf16;
+typedef int32_t acc_s8;
+typedef uint32_t acc_u8;
+} // namespace sme_sim_detail
+
+SME_SIM_MOPA_SUM(mop, bf16, 2, svbfloat16_t, svbfloat16_t)
+SME_SIM_MOPA_SUM(mop, s8, 4, svint8_t, svint8_t)
+SME_SIM_MOPA_SUM(mop, u8, 4, svuint8_t, svuint8_t)
+SME_SIM_MOPA_SUM(sumop, s8, 4, svint8_t, svuint8_t)
+SME_SIM_MOPA_SUM(usmop, u8, 4, svuint8_t, svint8_t)
+
+#undef SME_SIM_MOPA_SUM
+
+// ADDHA / ADDVA: zn added to every active row (horizontal) or column (vertical) of a za32 tile
+#define SME_SIM_ADDA(sfx, V, T) \
+    inline void svaddha_za32_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn) \
+    { \
+        sme_sim_detail::update_rows<T>(__FUNCTION__, tile, [&](size_t i, T* row) { \
+            if (!sve_sim_detail::active<T>(pn, i)) \
+            { \
+                return false; \
+            } \
+            sve_sim_detail::for_lanes<T>([&](size_t j) { \
+                if (sve_sim_detail::active<T>(pm, j)) \
+                { \
+                    row[j] = sve_sim_detail::Arith<T>::add(row[j], zn.val[j]); \
+                } \
+            }); \
+            return true; \
+        }); \
+    } \
+    inline void svaddva_za32_##sfx##_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn) \
+    { \
+        sme_sim_detail::update_rows<T>(__FUNCTION__, tile, [&](size_t i, T* row) { \
+            if (!sve_sim_detail::active<T>(pn, i)) \
+            { \
+                return false; \
+            } \
+            sve_sim_detail::for_lanes<T>([&](size_t j) { \
+                if (sve_sim_detail::active<T>(pm, j)) \
+                { \
+                    row[j] = sve_sim_detail::Arith<T>::add(row[j], zn.val[i]); \
+                } \
+            }); \
+            return true; \
+        }); \
+    } \
+    inline void svaddha_za32_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn) { svaddha_za32_##sfx##_m(tile, pn, pm, zn); } \
+    inline void svaddva_za32_m(uint64_t tile, svbool_t pn, svbool_t pm, V zn) { svaddva_za32_##sfx##_m(tile, pn, pm, zn); }
+
+SME_SIM_ADDA(s32, svint32_t, int32_t)
+SME_SIM_ADDA(u32, svuint32_t, uint32_t)
+
+#undef SME_SIM_ADDA
+
+//----------------------------------------------------------------------
+// implementation
+//----------------------------------------------------------------------
+
+#if defined(NEON_SIM_IMPLEMENTATION)
+
+namespace sme_sim_detail {
+
+thread_local int svl_bytes = 0;
+thread_local bool streaming = false;
+thread_local bool za_enabled = false;
+thread_local unsigned char za[SVE_SIM_MAX_BYTES * SVE_SIM_MAX_BYTES];
+
+// non-streaming vector length to restore at SMSTOP
+static thread_local int saved_vl_bytes = 0;
+
+static bool valid_svl(int bits)
+{
+    return bits >= 128 && bits <= SVE_SIM_MAX_VL && (bits & (bits - 1)) == 0;
+}
+
+// NEON_SIM_SME_SVL for threads that never called sme_sim_set_svl()
+int init_svl()
+{
+    static const int process_default = []() {
+        const char* env = getenv("NEON_SIM_SME_SVL");
+        const int bits = env ? atoi(env) : 512;
+        if (!valid_svl(bits))
+        {
+            fprintf(stderr, "%s: NEON_SIM_SME_SVL=%s is not a power of two in [128, %d], using 512\n", __FUNCTION__,
+                    env, SVE_SIM_MAX_VL);
+            return 64;
+        }
+        return bits / 8;
+    }();
+    svl_bytes = process_default;
+    return svl_bytes;
+}
+
+void za_unavailable(const char* fn)
+{
+    fprintf(stderr, "%s: ZA is only accessible in streaming mode with ZA enabled, call sme_sim_smstart() first\n", fn);
+    abort();
+}
+
+void bad_tile(const char* fn, uint64_t tile)
+{
+    fprintf(stderr, "%s: tile %llu does not exist for this element size\n", fn, (unsigned long long)tile);
+    abort();
+}
+
+} // namespace sme_sim_detail
+
+void sme_sim_set_svl(int bits)
+{
+    if (!sme_sim_detail::valid_svl(bits))
+    {
+        fprintf(stderr, "%s: streaming vector length %d is not a power of two in [128, %d]\n", __FUNCTION__, bits,
+                SVE_SIM_MAX_VL);
+        abort();
+    }
+    if (sme_sim_detail::streaming)
+    {
+        fprintf(stderr, "%s: the streaming vector length cannot change in streaming mode\n", __FUNCTION__);
+        abort();
+    }
+    sme_sim_detail::svl_bytes = bits / 8;
+}
+
+int sme_sim_get_svl()
+{
+    return (int)svcntsb() * 8;
+}
+
+void sme_sim_smstart()
+{
+    if (!sme_sim_detail::streaming)
+    {
+        sme_sim_detail::saved_vl_bytes = sve_sim_detail::vl_bytes;
+        sve_sim_detail::vl_bytes = (int)svcntsb();
+        sme_sim_detail::streaming = true;
+    }
+    if (!sme_sim_detail::za_enabled)
+    {
+        memset(sme_sim_detail::za, 0, sizeof(sme_sim_detail::za));
+        sme_sim_detail::za_enabled = true;
+    }
+}
+
+void sme_sim_smstop()
+{
+    if (sme_sim_detail::streaming)
+    {
+        sve_sim_detail::vl_bytes = sme_sim_detail::saved_vl_bytes;
+        sme_sim_detail::streaming = false;
+    }
+    sme_sim_detail::za_enabled = false;
+}
+
+#endif // NEON_SIM_IMPLEMENTATION
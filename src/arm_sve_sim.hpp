@@ -0,0 +1,913 @@
+#pragma once
+
+//
+// SVE / SVE2 companion of arm_neon_sim.hpp: scalable vector and predicate
+// types on the same TxN register model, with the vector length chosen at
+// run time so one kernel can be checked at 128, 256, 512... bits.
+//
+// usage:
+//#define NEON_SIM_IMPLEMENTATION   // in one .cpp, as for arm_neon_sim.hpp
+//
+// #if __ARM_FEATURE_SVE
+// #include <arm_sve.h>
+// #else
+// #include "arm_sve_sim.hpp"
+// #endif
+//
+// sve_sim_set_vl(512);                // or NEON_SIM_SVE_VL=512 in the environment, default 128
+// for (int64_t i = 0; i < n; i += svcntw())
+// {
+//     svbool_t pg = svwhilelt_b32_s64(i, n);
+//     svfloat32_t x = svld1_f32(pg, src + i);
+//     svst1_f32(pg, dst + i, svmla_n_f32_x(pg, svld1_f32(pg, dst + i), x, a));
+// }
+//
+// Registers hold SVE_SIM_MAX_VL (2048) bits; lanes past the current vector
+// length are always zero. A predicate keeps one flag per vector byte like the
+// hardware P registers: lane i of a T vector is active when byte i * sizeof(T)
+// is set. _m keeps the first vector operand in inactive lanes, _z zeroes them,
+// _x computes every lane.
+//
+// The vector length is per thread, like prctl(PR_SVE_SET_VL). Lane loops run
+// with a compile time trip count for 128, 256 and 512-bit vectors, which the
+// host compiler turns into SSE / AVX code; other lengths loop over svcntb().
+//
+// Covered: svcnt*, svptrue / svpfalse / svwhilelt / svptest / svcntp and
+// predicate logic, svld1 / svst1 (vnum, gather / scatter by index or offset),
+// svdup / svindex / svsel, svadd svsub svmul svdiv svmax svmin svabd svand
+// svorr sveor svmla svmls (all _m _x _z, vector and _n), svneg svabs svsqrt,
+// svqadd svqsub, svcmp*, svcvt, svaddv svadda svmaxv svminv, and the SVE2
+// svmullb / svmullt / svaddp.
+//
+
+#include "arm_neon_sim.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#define __ARM_FEATURE_SVE 1
+#define __ARM_FEATURE_SVE2 1
+
+#define SVE_SIM_MAX_VL 2048
+#define SVE_SIM_MAX_BYTES (SVE_SIM_MAX_VL / 8)
+
+//----------------------------------------------------------------------
+// 1. scalable vector and predicate types
+//----------------------------------------------------------------------
+
+using svint8_t = TxN<int8_t, SVE_SIM_MAX_BYTES>;
+using svint16_t = TxN<int16_t, SVE_SIM_MAX_BYTES / 2>;
+using svint32_t = TxN<int32_t, SVE_SIM_MAX_BYTES / 4>;
+using svint64_t = TxN<int64_t, SVE_SIM_MAX_BYTES / 8>;
+using svuint8_t = TxN<uint8_t, SVE_SIM_MAX_BYTES>;
+using svuint16_t = TxN<uint16_t, SVE_SIM_MAX_BYTES / 2>;
+using svuint32_t = TxN<uint32_t, SVE_SIM_MAX_BYTES / 4>;
+using svuint64_t = TxN<uint64_t, SVE_SIM_MAX_BYTES / 8>;
+using svfloat32_t = TxN<float32_t, SVE_SIM_MAX_BYTES / 4>;
+using svfloat64_t = TxN<float64_t, SVE_SIM_MAX_BYTES / 8>;
+
+/// @brief predicate register, one flag per vector byte
+using svbool_t = TxN<bool, SVE_SIM_MAX_BYTES>;
+
+//----------------------------------------------------------------------
+// 2. vector length
+//----------------------------------------------------------------------
+
+/// @brief set this thread's vector length, a multiple of 128 in [128, 2048] bits; aborts otherwise
+void sve_sim_set_vl(int bits);
+
+/// @brief this thread's vector length in bits
+int sve_sim_get_vl();
+
+namespace sve_sim_detail {
+extern thread_local int vl_bytes;
+int init_vl();
+} // namespace sve_sim_detail
+
+inline uint64_t svcntb()
+{
+    const int vl = sve_sim_detail::vl_bytes;
+    return (uint64_t)(vl ? vl : sve_sim_detail::init_vl());
+}
+
+inline uint64_t svcnth()
+{
+    return svcntb() / 2;
+}
+
+inline uint64_t svcntw()
+{
+    return svcntb() / 4;
+}
+
+inline uint64_t svcntd()
+{
+    return svcntb() / 8;
+}
+
+//----------------------------------------------------------------------
+// 3. lane helpers
+//----------------------------------------------------------------------
+
+namespace sve_sim_detail {
+
+/// @brief f(i) for every lane of a T vector; constant trip counts for the common lengths
+template<typename T, typename F>
+inline void for_lanes(F f)
+{
+    switch (svcntb())
+    {
+    case 16:
+        for (size_t i = 0; i < 16 / sizeof(T); i++)
+        {
+            f(i);
+        }
+        break;
+    case 32:
+        for (size_t i = 0; i < 32 / sizeof(T); i++)
+        {
+            f(i);
+        }
+        break;
+    case 64:
+        for (size_t i = 0; i < 64 / sizeof(T); i++)
+        {
+            f(i);
+        }
+        break;
+    default:
+    {
+        const size_t n = svcntb() / sizeof(T);
+        for (size_t i = 0; i < n; i++)
+        {
+            f(i);
+        }
+        break;
+    }
+    }
+}
+
+template<typename T>
+inline bool active(const svbool_t& pg, size_t i)
+{
+    return pg.val[i * sizeof(T)];
+}
+
+// integer arithmetic goes through the unsigned type, so it wraps like the hardware
+template<typename T, bool = std::is_integral<T>::value>
+struct Arith
+{
+    typedef typename std::make_unsigned<T>::type U;
+    static T add(T a, T b) { return (T)(U)((U)a + (U)b); }
+    static T sub(T a, T b) { return (T)(U)((U)a - (U)b); }
+    static T mul(T a, T b) { return (T)(U)((uint64_t)(U)a * (uint64_t)(U)b); }
+    static T mla(T acc, T a, T b) { return add(acc, mul(a, b)); }
+    static T mls(T acc, T a, T b) { return sub(acc, mul(a, b)); }
+    static T div(T a, T b)
+    {
+        // SDIV / UDIV: x / 0 = 0, INT_MIN / -1 = INT_MIN
+        if (b == 0)
+        {
+            return 0;
+        }
+        if (std::is_signed<T>::value && a == std::numeric_limits<T>::min() && b == (T)-1)
+        {
+            return a;
+        }
+        return (T)(a / b);
+    }
+    static T max(T a, T b) { return a > b ? a : b; }
+    static T min(T a, T b) { return a < b ? a : b; }
+    static T abd(T a, T b) { return a > b ? sub(a, b) : sub(b, a); }
+    static T neg(T a) { return sub(0, a); }
+    static T abs(T a) { return a < 0 ? neg(a) : a; }
+};
+
+template<typename T>
+struct Arith<T, false>
+{
+    static T add(T a, T b) { return a + b; }
+    static T sub(T a, T b) { return a - b; }
+    static T mul(T a, T b) { return a * b; }
+    static T mla(T acc, T a, T b) { return std::fma(a, b, acc); }
+    static T mls(T acc, T a, T b) { return std::fma(-a, b, acc); }
+    static T div(T a, T b) { return a / b; }
+    // FMAX / FMIN: a NaN operand gives NaN
+    static T max(T a, T b) { return (a != a || b != b) ? a + b : (a == 0 && b == 0) ? (std::signbit(a) ? b : a) : (a > b ? a : b); }
+    static T min(T a, T b) { return (a != a || b != b) ? a + b : (a == 0 && b == 0) ? (std::signbit(a) ? a : b) : (a < b ? a : b); }
+    static T abd(T a, T b) { return std::fabs(a - b); }
+    static T neg(T a) { return -a; }
+    static T abs(T a) { return std::fabs(a); }
+};
+
+template<typename T>
+inline T sat_add(T a, T b)
+{
+    const T lo = std::numeric_limits<T>::min();
+    const T hi = std::numeric_limits<T>::max();
+    if (std::is_signed<T>::value)
+    {
+        if (b > 0 && a > hi - b)
+        {
+            return hi;
+        }
+        if (b < 0 && a < lo - b)
+        {
+            return lo;
+        }
+        return (T)(a + b);
+    }
+    const T r = (T)(a + b);
+    return r < a ? hi : r;
+}
+
+template<typename T>
+inline T sat_sub(T a, T b)
+{
+    const T lo = std::numeric_limits<T>::min();
+    const T hi = std::numeric_limits<T>::max();
+    if (std::is_signed<T>::value)
+    {
+        if (b < 0 && a > hi + b)
+        {
+            return hi;
+        }
+        if (b > 0 && a < lo + b)
+        {
+            return lo;
+        }
+        return (T)(a - b);
+    }
+    return a > b ? (T)(a - b) : (T)0;
+}
+
+enum Merge
+{
+    MERGE_M, ///< inactive lanes keep op1
+    MERGE_X, ///< every lane computed
+    MERGE_Z, ///< inactive lanes zeroed
+};
+
+template<typename T, size_t N, typename F>
+inline TxN<T, N> binary(Merge mode, const svbool_t& pg, const TxN<T, N>& a, const TxN<T, N>& b, F f)
+{
+    TxN<T, N> r;
+    for_lanes<T>([&](size_t i) {
+        if (mode == MERGE_X || active<T>(pg, i))
+        {
+            r.val[i] = f(a.val[i], b.val[i]);
+        }
+        else
+        {
+            r.val[i] = mode == MERGE_M ? a.val[i] : (T)0;
+        }
+    });
+    return r;
+}
+
+template<typename T, size_t N, typename F>
+inline TxN<T, N> unary(Merge mode, const svbool_t& pg, const TxN<T, N>& inactive, const TxN<T, N>& a, F f)
+{
+    TxN<T, N> r;
+    for_lanes<T>([&](size_t i) {
+        if (mode == MERGE_X || active<T>(pg, i))
+        {
+            r.val[i] = f(a.val[i]);
+        }
+        else
+        {
+            r.val[i] = mode == MERGE_M ? inactive.val[i] : (T)0;
+        }
+    });
+    return r;
+}
+
+template<typename T, size_t N>
+inline TxN<T, N> splat(T v)
+{
+    TxN<T, N> r;
+    for_lanes<T>([&](size_t i) { r.val[i] = v; });
+    return r;
+}
+
+template<typename T, size_t N, typename F>
+inline svbool_t compare(const svbool_t& pg, const TxN<T, N>& a, const TxN<T, N>& b, F f)
+{
+    svbool_t r;
+    for_lanes<T>([&](size_t i) { r.val[i * sizeof(T)] = active<T>(pg, i) && f(a.val[i], b.val[i]); });
+    return r;
+}
+
+template<typename T>
+inline svbool_t ptrue()
+{
+    svbool_t r;
+    for_lanes<T>([&](size_t i) { r.val[i * sizeof(T)] = true; });
+    return r;
+}
+
+// WHILELT: lane i active while op1 + i < op2
+template<typename T, typename I>
+inline svbool_t whilelt(I op1, I op2)
+{
+    svbool_t r;
+    const size_t n = svcntb() / sizeof(T);
+    for (size_t i = 0; i < n && op1 < op2; i++, op1++)
+    {
+        r.val[i * sizeof(T)] = true;
+    }
+    return r;
+}
+
+// FADDV: pairwise tree over the lanes padded to a power of two with +0.0
+template<typename T>
+inline T tree_sum(const T* v, size_t n)
+{
+    if (n == 1)
+    {
+        return v[0];
+    }
+    size_t half = 1;
+    while (half * 2 < n)
+    {
+        half *= 2;
+    }
+    return tree_sum(v, half) + tree_sum(v + half, n - half);
+}
+
+template<typename TD, typename TS, size_t ND, size_t NS>
+inline TxN<TD, ND> widen_mul(const TxN<TS, NS>& a, const TxN<TS, NS>& b, size_t odd)
+{
+    TxN<TD, ND> r;
+    for_lanes<TD>([&](size_t i) { r.val[i] = Arith<TD>::mul((TD)a.val[2 * i + odd], (TD)b.val[2 * i + odd]); });
+    return r;
+}
+
+// FCVTZS / FCVTZU: toward zero, saturating, NaN -> 0
+template<typename TI, typename TF>
+inline TI fp_to_int(TF x)
+{
+    if (x != x)
+    {
+        return 0;
+    }
+    if (x <= (TF)std::numeric_limits<TI>::min())
+    {
+        return std::numeric_limits<TI>::min();
+    }
+    if (x >= (TF)std::numeric_limits<TI>::max())
+    {
+        return std::numeric_limits<TI>::max();
+    }
+    return (TI)x;
+}
+
+} // namespace sve_sim_detail
+
+//----------------------------------------------------------------------
+// 4. predicates
+//----------------------------------------------------------------------
+
+inline svbool_t svptrue_b8() { return sve_sim_detail::ptrue<uint8_t>(); }
+inline svbool_t svptrue_b16() { return sve_sim_detail::ptrue<uint16_t>(); }
+inline svbool_t svptrue_b32() { return sve_sim_detail::ptrue<uint32_t>(); }
+inline svbool_t svptrue_b64() { return sve_sim_detail::ptrue<uint64_t>(); }
+inline svbool_t svpfalse_b() { return svbool_t(); }
+
+#define SVE_SIM_WHILELT(bits, T) \
+    inline svbool_t svwhilelt_b##bits##_s32(int32_t a, int32_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits##_s64(int64_t a, int64_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits##_u32(uint32_t a, uint32_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits##_u64(uint64_t a, uint64_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits(int32_t a, int32_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits(int64_t a, int64_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits(uint32_t a, uint32_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline svbool_t svwhilelt_b##bits(uint64_t a, uint64_t b) { return sve_sim_detail::whilelt<T>(a, b); } \
+    inline uint64_t svcntp_b##bits(svbool_t pg, svbool_t op) \
+    { \
+        uint64_t n = 0; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { n += sve_sim_detail::active<T>(pg, i) && sve_sim_detail::active<T>(op, i); }); \
+        return n; \
+    }
+
+SVE_SIM_WHILELT(8, uint8_t)
+SVE_SIM_WHILELT(16, uint16_t)
+SVE_SIM_WHILELT(32, uint32_t)
+SVE_SIM_WHILELT(64, uint64_t)
+
+#undef SVE_SIM_WHILELT
+
+/// @brief true when op has any flag set under pg
+inline bool svptest_any(svbool_t pg, svbool_t op)
+{
+    for (size_t i = 0; i < svcntb(); i++)
+    {
+        if (pg.val[i] && op.val[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief op at the first flag set in pg
+inline bool svptest_first(svbool_t pg, svbool_t op)
+{
+    for (size_t i = 0; i < svcntb(); i++)
+    {
+        if (pg.val[i])
+        {
+            return op.val[i];
+        }
+    }
+    return false;
+}
+
+/// @brief op at the last flag set in pg
+inline bool svptest_last(svbool_t pg, svbool_t op)
+{
+    for (size_t i = svcntb(); i-- > 0;)
+    {
+        if (pg.val[i])
+        {
+            return op.val[i];
+        }
+    }
+    return false;
+}
+
+#define SVE_SIM_PRED_LOGIC(name, expr) \
+    inline svbool_t name##_b_z(svbool_t pg, svbool_t a, svbool_t b) \
+    { \
+        svbool_t r; \
+        for (size_t i = 0; i < svcntb(); i++) \
+        { \
+            r.val[i] = pg.val[i] && (expr); \
+        } \
+        return r; \
+    }
+
+SVE_SIM_PRED_LOGIC(svand, a.val[i] && b.val[i])
+SVE_SIM_PRED_LOGIC(svorr, a.val[i] || b.val[i])
+SVE_SIM_PRED_LOGIC(sveor, a.val[i] != b.val[i])
+SVE_SIM_PRED_LOGIC(svbic, a.val[i] && !b.val[i])
+
+#undef SVE_SIM_PRED_LOGIC
+
+inline svbool_t svnot_b_z(svbool_t pg, svbool_t op)
+{
+    svbool_t r;
+    for (size_t i = 0; i < svcntb(); i++)
+    {
+        r.val[i] = pg.val[i] && !op.val[i];
+    }
+    return r;
+}
+
+//----------------------------------------------------------------------
+// 5. per element type intrinsics
+//----------------------------------------------------------------------
+
+// arithmetic with _m / _x / _z, vector and scalar (_n) second operand
+#define SVE_SIM_BINARY(name, fn, sfx, V, T) \
+    inline V name##_##sfx##_m(svbool_t pg, V a, V b) { return sve_sim_detail::binary(sve_sim_detail::MERGE_M, pg, a, b, fn); } \
+    inline V name##_##sfx##_x(svbool_t pg, V a, V b) { return sve_sim_detail::binary(sve_sim_detail::MERGE_X, pg, a, b, fn); } \
+    inline V name##_##sfx##_z(svbool_t pg, V a, V b) { return sve_sim_detail::binary(sve_sim_detail::MERGE_Z, pg, a, b, fn); } \
+    inline V name##_n_##sfx##_m(svbool_t pg, V a, T b) { return name##_##sfx##_m(pg, a, svdup_n_##sfx(b)); } \
+    inline V name##_n_##sfx##_x(svbool_t pg, V a, T b) { return name##_##sfx##_x(pg, a, svdup_n_##sfx(b)); } \
+    inline V name##_n_##sfx##_z(svbool_t pg, V a, T b) { return name##_##sfx##_z(pg, a, svdup_n_##sfx(b)); } \
+    inline V name##_m(svbool_t pg, V a, V b) { return name##_##sfx##_m(pg, a, b); } \
+    inline V name##_x(svbool_t pg, V a, V b) { return name##_##sfx##_x(pg, a, b); } \
+    inline V name##_z(svbool_t pg, V a, V b) { return name##_##sfx##_z(pg, a, b); } \
+    inline V name##_m(svbool_t pg, V a, T b) { return name##_##sfx##_m(pg, a, svdup_n_##sfx(b)); } \
+    inline V name##_x(svbool_t pg, V a, T b) { return name##_##sfx##_x(pg, a, svdup_n_##sfx(b)); } \
+    inline V name##_z(svbool_t pg, V a, T b) { return name##_##sfx##_z(pg, a, svdup_n_##sfx(b)); }
+
+// svmla / svmls: acc +- a * b, inactive lanes keep acc for _m
+#define SVE_SIM_TERNARY(name, fn, sfx, V, T) \
+    inline V name##_##sfx##_impl(sve_sim_detail::Merge mode, svbool_t pg, V acc, V a, V b) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (mode == sve_sim_detail::MERGE_X || sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r.val[i] = sve_sim_detail::Arith<T>::fn(acc.val[i], a.val[i], b.val[i]); \
+            } \
+            else \
+            { \
+                r.val[i] = mode == sve_sim_detail::MERGE_M ? acc.val[i] : (T)0; \
+            } \
+        }); \
+        return r; \
+    } \
+    inline V name##_##sfx##_m(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_impl(sve_sim_detail::MERGE_M, pg, acc, a, b); } \
+    inline V name##_##sfx##_x(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_impl(sve_sim_detail::MERGE_X, pg, acc, a, b); } \
+    inline V name##_##sfx##_z(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_impl(sve_sim_detail::MERGE_Z, pg, acc, a, b); } \
+    inline V name##_n_##sfx##_m(svbool_t pg, V acc, V a, T b) { return name##_##sfx##_m(pg, acc, a, svdup_n_##sfx(b)); } \
+    inline V name##_n_##sfx##_x(svbool_t pg, V acc, V a, T b) { return name##_##sfx##_x(pg, acc, a, svdup_n_##sfx(b)); } \
+    inline V name##_n_##sfx##_z(svbool_t pg, V acc, V a, T b) { return name##_##sfx##_z(pg, acc, a, svdup_n_##sfx(b)); } \
+    inline V name##_m(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_m(pg, acc, a, b); } \
+    inline V name##_x(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_x(pg, acc, a, b); } \
+    inline V name##_z(svbool_t pg, V acc, V a, V b) { return name##_##sfx##_z(pg, acc, a, b); }
+
+#define SVE_SIM_UNARY(name, fn, sfx, V, T) \
+    inline V name##_##sfx##_m(V inactive, svbool_t pg, V a) { return sve_sim_detail::unary(sve_sim_detail::MERGE_M, pg, inactive, a, fn); } \
+    inline V name##_##sfx##_x(svbool_t pg, V a) { return sve_sim_detail::unary(sve_sim_detail::MERGE_X, pg, a, a, fn); } \
+    inline V name##_##sfx##_z(svbool_t pg, V a) { return sve_sim_detail::unary(sve_sim_detail::MERGE_Z, pg, a, a, fn); } \
+    inline V name##_x(svbool_t pg, V a) { return name##_##sfx##_x(pg, a); } \
+    inline V name##_z(svbool_t pg, V a) { return name##_##sfx##_z(pg, a); }
+
+#define SVE_SIM_COMPARE(name, op, sfx, V, T) \
+    inline svbool_t name##_##sfx(svbool_t pg, V a, V b) { return sve_sim_detail::compare(pg, a, b, [](T x, T y) { return x op y; }); } \
+    inline svbool_t name##_n_##sfx(svbool_t pg, V a, T b) { return name##_##sfx(pg, a, svdup_n_##sfx(b)); } \
+    inline svbool_t name(svbool_t pg, V a, V b) { return name##_##sfx(pg, a, b); } \
+    inline svbool_t name(svbool_t pg, V a, T b) { return name##_##sfx(pg, a, svdup_n_##sfx(b)); }
+
+// intrinsics every element type has
+#define SVE_SIM_COMMON(sfx, V, T) \
+    inline V svdup_n_##sfx(T v) { return sve_sim_detail::splat<T, sizeof(V) / sizeof(T)>(v); } \
+    inline V svdup_##sfx(T v) { return svdup_n_##sfx(v); } \
+    inline V svdup_n_##sfx##_z(svbool_t pg, T v) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { r.val[i] = sve_sim_detail::active<T>(pg, i) ? v : (T)0; }); \
+        return r; \
+    } \
+    inline V svundef_##sfx() { return V(); } \
+    /* contiguous load / store: inactive lanes read as zero and are not written */ \
+    inline V svld1_##sfx(svbool_t pg, const T* base) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r.val[i] = base[i]; \
+            } \
+        }); \
+        return r; \
+    } \
+    inline V svld1(svbool_t pg, const T* base) { return svld1_##sfx(pg, base); } \
+    inline V svld1_vnum_##sfx(svbool_t pg, const T* base, int64_t vnum) { return svld1_##sfx(pg, base + vnum * (int64_t)(svcntb() / sizeof(T))); } \
+    inline void svst1_##sfx(svbool_t pg, T* base, V v) \
+    { \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                base[i] = v.val[i]; \
+            } \
+        }); \
+    } \
+    inline void svst1(svbool_t pg, T* base, V v) { svst1_##sfx(pg, base, v); } \
+    inline void svst1_vnum_##sfx(svbool_t pg, T* base, int64_t vnum, V v) { svst1_##sfx(pg, base + vnum * (int64_t)(svcntb() / sizeof(T)), v); } \
+    inline V svsel_##sfx(svbool_t pg, V a, V b) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { r.val[i] = sve_sim_detail::active<T>(pg, i) ? a.val[i] : b.val[i]; }); \
+        return r; \
+    } \
+    inline V svsel(svbool_t pg, V a, V b) { return svsel_##sfx(pg, a, b); } \
+    SVE_SIM_BINARY(svadd, sve_sim_detail::Arith<T>::add, sfx, V, T) \
+    SVE_SIM_BINARY(svsub, sve_sim_detail::Arith<T>::sub, sfx, V, T) \
+    SVE_SIM_BINARY(svmul, sve_sim_detail::Arith<T>::mul, sfx, V, T) \
+    SVE_SIM_BINARY(svmax, sve_sim_detail::Arith<T>::max, sfx, V, T) \
+    SVE_SIM_BINARY(svmin, sve_sim_detail::Arith<T>::min, sfx, V, T) \
+    SVE_SIM_BINARY(svabd, sve_sim_detail::Arith<T>::abd, sfx, V, T) \
+    SVE_SIM_TERNARY(svmla, mla, sfx, V, T) \
+    SVE_SIM_TERNARY(svmls, mls, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmpeq, ==, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmpne, !=, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmpgt, >, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmpge, >=, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmplt, <, sfx, V, T) \
+    SVE_SIM_COMPARE(svcmple, <=, sfx, V, T) \
+    inline T svmaxv_##sfx(svbool_t pg, V a) \
+    { \
+        T r = std::is_integral<T>::value ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::infinity(); \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r = sve_sim_detail::Arith<T>::max(r, a.val[i]); \
+            } \
+        }); \
+        return r; \
+    } \
+    inline T svminv_##sfx(svbool_t pg, V a) \
+    { \
+        T r = std::is_integral<T>::value ? std::numeric_limits<T>::max() : std::numeric_limits<T>::infinity(); \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r = sve_sim_detail::Arith<T>::min(r, a.val[i]); \
+            } \
+        }); \
+        return r; \
+    } \
+    inline T svmaxv(svbool_t pg, V a) { return svmaxv_##sfx(pg, a); } \
+    inline T svminv(svbool_t pg, V a) { return svminv_##sfx(pg, a); }
+
+// integer only: division (32 / 64-bit below), bitwise ops, saturating add / sub, index, widening sum
+#define SVE_SIM_INTEGER(sfx, V, T, R) \
+    SVE_SIM_BINARY(svand, [](T x, T y) { return (T)(x & y); }, sfx, V, T) \
+    SVE_SIM_BINARY(svorr, [](T x, T y) { return (T)(x | y); }, sfx, V, T) \
+    SVE_SIM_BINARY(sveor, [](T x, T y) { return (T)(x ^ y); }, sfx, V, T) \
+    inline V svqadd_##sfx(V a, V b) { return sve_sim_detail::binary(sve_sim_detail::MERGE_X, svbool_t(), a, b, sve_sim_detail::sat_add<T>); } \
+    inline V svqsub_##sfx(V a, V b) { return sve_sim_detail::binary(sve_sim_detail::MERGE_X, svbool_t(), a, b, sve_sim_detail::sat_sub<T>); } \
+    inline V svqadd_n_##sfx(V a, T b) { return svqadd_##sfx(a, svdup_n_##sfx(b)); } \
+    inline V svqsub_n_##sfx(V a, T b) { return svqsub_##sfx(a, svdup_n_##sfx(b)); } \
+    inline V svqadd(V a, V b) { return svqadd_##sfx(a, b); } \
+    inline V svqsub(V a, V b) { return svqsub_##sfx(a, b); } \
+    inline V svindex_##sfx(T base, T step) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { r.val[i] = (T)((R)base + (R)i * (R)step); }); \
+        return r; \
+    } \
+    /* UADDV / SADDV: 64-bit sum of the active lanes */ \
+    inline R svaddv_##sfx(svbool_t pg, V a) \
+    { \
+        R r = 0; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r = (R)((uint64_t)r + (uint64_t)(R)a.val[i]); \
+            } \
+        }); \
+        return r; \
+    } \
+    inline R svaddv(svbool_t pg, V a) { return svaddv_##sfx(pg, a); }
+
+#define SVE_SIM_SIGNED(sfx, V, T) \
+    SVE_SIM_UNARY(svneg, sve_sim_detail::Arith<T>::neg, sfx, V, T) \
+    SVE_SIM_UNARY(svabs, sve_sim_detail::Arith<T>::abs, sfx, V, T)
+
+#define SVE_SIM_DIVIDE(sfx, V, T) \
+    SVE_SIM_BINARY(svdiv, sve_sim_detail::Arith<T>::div, sfx, V, T)
+
+#define SVE_SIM_FLOAT(sfx, V, T) \
+    SVE_SIM_DIVIDE(sfx, V, T) \
+    SVE_SIM_SIGNED(sfx, V, T) \
+    SVE_SIM_UNARY(svsqrt, [](T x) { return std::sqrt(x); }, sfx, V, T) \
+    /* FADDV: pairwise tree, inactive lanes add +0.0 */ \
+    inline T svaddv_##sfx(svbool_t pg, V a) \
+    { \
+        const size_t n = svcntb() / sizeof(T); \
+        T lanes[SVE_SIM_MAX_BYTES / sizeof(T)]; \
+        for (size_t i = 0; i < n; i++) \
+        { \
+            lanes[i] = sve_sim_detail::active<T>(pg, i) ? a.val[i] : (T)0; \
+        } \
+        return sve_sim_detail::tree_sum(lanes, n); \
+    } \
+    inline T svaddv(svbool_t pg, V a) { return svaddv_##sfx(pg, a); } \
+    /* FADDA: strictly ordered from `init` */ \
+    inline T svadda_##sfx(svbool_t pg, T init, V a) \
+    { \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                init += a.val[i]; \
+            } \
+        }); \
+        return init; \
+    } \
+    inline T svadda(svbool_t pg, T init, V a) { return svadda_##sfx(pg, init, a); }
+
+SVE_SIM_COMMON(s8, svint8_t, int8_t)
+SVE_SIM_COMMON(s16, svint16_t, int16_t)
+SVE_SIM_COMMON(s32, svint32_t, int32_t)
+SVE_SIM_COMMON(s64, svint64_t, int64_t)
+SVE_SIM_COMMON(u8, svuint8_t, uint8_t)
+SVE_SIM_COMMON(u16, svuint16_t, uint16_t)
+SVE_SIM_COMMON(u32, svuint32_t, uint32_t)
+SVE_SIM_COMMON(u64, svuint64_t, uint64_t)
+SVE_SIM_COMMON(f32, svfloat32_t, float32_t)
+SVE_SIM_COMMON(f64, svfloat64_t, float64_t)
+
+SVE_SIM_INTEGER(s8, svint8_t, int8_t, int64_t)
+SVE_SIM_INTEGER(s16, svint16_t, int16_t, int64_t)
+SVE_SIM_INTEGER(s32, svint32_t, int32_t, int64_t)
+SVE_SIM_INTEGER(s64, svint64_t, int64_t, int64_t)
+SVE_SIM_INTEGER(u8, svuint8_t, uint8_t, uint64_t)
+SVE_SIM_INTEGER(u16, svuint16_t, uint16_t, uint64_t)
+SVE_SIM_INTEGER(u32, svuint32_t, uint32_t, uint64_t)
+SVE_SIM_INTEGER(u64, svuint64_t, uint64_t, uint64_t)
+
+SVE_SIM_SIGNED(s8, svint8_t, int8_t)
+SVE_SIM_SIGNED(s16, svint16_t, int16_t)
+SVE_SIM_SIGNED(s32, svint32_t, int32_t)
+SVE_SIM_SIGNED(s64, svint64_t, int64_t)
+
+SVE_SIM_DIVIDE(s32, svint32_t, int32_t)
+SVE_SIM_DIVIDE(s64, svint64_t, int64_t)
+SVE_SIM_DIVIDE(u32, svuint32_t, uint32_t)
+SVE_SIM_DIVIDE(u64, svuint64_t, uint64_t)
+
+SVE_SIM_FLOAT(f32, svfloat32_t, float32_t)
+SVE_SIM_FLOAT(f64, svfloat64_t, float64_t)
+
+//----------------------------------------------------------------------
+// 6. gather / scatter
+//----------------------------------------------------------------------
+
+// svld1_gather_<I>index_<sfx>(pg, base, indices) reads base[indices[i]],
+// svld1_gather_<I>offset_<sfx> reads at byte offsets; indices have the element width
+#define SVE_SIM_GATHER(isfx, IV, I, sfx, V, T) \
+    inline V svld1_gather_##isfx##index_##sfx(svbool_t pg, const T* base, IV indices) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                r.val[i] = base[(int64_t)indices.val[i]]; \
+            } \
+        }); \
+        return r; \
+    } \
+    inline V svld1_gather_##isfx##offset_##sfx(svbool_t pg, const T* base, IV offsets) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                memcpy(&r.val[i], (const uint8_t*)base + (int64_t)offsets.val[i], sizeof(T)); \
+            } \
+        }); \
+        return r; \
+    } \
+    inline void svst1_scatter_##isfx##index_##sfx(svbool_t pg, T* base, IV indices, V v) \
+    { \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                base[(int64_t)indices.val[i]] = v.val[i]; \
+            } \
+        }); \
+    } \
+    inline void svst1_scatter_##isfx##offset_##sfx(svbool_t pg, T* base, IV offsets, V v) \
+    { \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            if (sve_sim_detail::active<T>(pg, i)) \
+            { \
+                memcpy((uint8_t*)base + (int64_t)offsets.val[i], &v.val[i], sizeof(T)); \
+            } \
+        }); \
+    } \
+    inline V svld1_gather_index(svbool_t pg, const T* base, IV indices) { return svld1_gather_##isfx##index_##sfx(pg, base, indices); } \
+    inline void svst1_scatter_index(svbool_t pg, T* base, IV indices, V v) { svst1_scatter_##isfx##index_##sfx(pg, base, indices, v); }
+
+#define SVE_SIM_GATHER_32(sfx, V, T) \
+    SVE_SIM_GATHER(s32, svint32_t, int32_t, sfx, V, T) \
+    SVE_SIM_GATHER(u32, svuint32_t, uint32_t, sfx, V, T)
+
+#define SVE_SIM_GATHER_64(sfx, V, T) \
+    SVE_SIM_GATHER(s64, svint64_t, int64_t, sfx, V, T) \
+    SVE_SIM_GATHER(u64, svuint64_t, uint64_t, sfx, V, T)
+
+SVE_SIM_GATHER_32(s32, svint32_t, int32_t)
+SVE_SIM_GATHER_32(u32, svuint32_t, uint32_t)
+SVE_SIM_GATHER_32(f32, svfloat32_t, float32_t)
+SVE_SIM_GATHER_64(s64, svint64_t, int64_t)
+SVE_SIM_GATHER_64(u64, svuint64_t, uint64_t)
+SVE_SIM_GATHER_64(f64, svfloat64_t, float64_t)
+
+//----------------------------------------------------------------------
+// 7. conversion and SVE2 widening
+//----------------------------------------------------------------------
+
+#define SVE_SIM_CONVERT(name, VD, TD, VS, TS, expr) \
+    inline VD name##_x(svbool_t /*pg*/, VS a) \
+    { \
+        VD r; \
+        sve_sim_detail::for_lanes<TD>([&](size_t i) { const TS x = a.val[i]; r.val[i] = (expr); }); \
+        return r; \
+    } \
+    inline VD name##_z(svbool_t pg, VS a) \
+    { \
+        VD r; \
+        sve_sim_detail::for_lanes<TD>([&](size_t i) { \
+            const TS x = a.val[i]; \
+            r.val[i] = sve_sim_detail::active<TD>(pg, i) ? (TD)(expr) : (TD)0; \
+        }); \
+        return r; \
+    } \
+    inline VD name##_m(VD inactive, svbool_t pg, VS a) \
+    { \
+        VD r; \
+        sve_sim_detail::for_lanes<TD>([&](size_t i) { \
+            const TS x = a.val[i]; \
+            r.val[i] = sve_sim_detail::active<TD>(pg, i) ? (TD)(expr) : inactive.val[i]; \
+        }); \
+        return r; \
+    }
+
+SVE_SIM_CONVERT(svcvt_f32_s32, svfloat32_t, float32_t, svint32_t, int32_t, (float32_t)x)
+SVE_SIM_CONVERT(svcvt_f32_u32, svfloat32_t, float32_t, svuint32_t, uint32_t, (float32_t)x)
+SVE_SIM_CONVERT(svcvt_s32_f32, svint32_t, int32_t, svfloat32_t, float32_t, (sve_sim_detail::fp_to_int<int32_t, float32_t>(x)))
+SVE_SIM_CONVERT(svcvt_u32_f32, svuint32_t, uint32_t, svfloat32_t, float32_t, (sve_sim_detail::fp_to_int<uint32_t, float32_t>(x)))
+SVE_SIM_CONVERT(svcvt_f64_s64, svfloat64_t, float64_t, svint64_t, int64_t, (float64_t)x)
+SVE_SIM_CONVERT(svcvt_s64_f64, svint64_t, int64_t, svfloat64_t, float64_t, (sve_sim_detail::fp_to_int<int64_t, float64_t>(x)))
+
+#undef SVE_SIM_CONVERT
+
+// SMULLB / SMULLT: widening multiply of the even (bottom) / odd (top) lanes
+#define SVE_SIM_MULL_PAIR(sfx, VD, TD, VS, TS) \
+    inline VD svmullb_##sfx(VS a, VS b) { return sve_sim_detail::widen_mul<TD, TS, sizeof(VD) / sizeof(TD)>(a, b, 0); } \
+    inline VD svmullt_##sfx(VS a, VS b) { return sve_sim_detail::widen_mul<TD, TS, sizeof(VD) / sizeof(TD)>(a, b, 1); } \
+    inline VD svmullb(VS a, VS b) { return svmullb_##sfx(a, b); } \
+    inline VD svmullt(VS a, VS b) { return svmullt_##sfx(a, b); }
+
+SVE_SIM_MULL_PAIR(s16, svint16_t, int16_t, svint8_t, int8_t)
+SVE_SIM_MULL_PAIR(s32, svint32_t, int32_t, svint16_t, int16_t)
+SVE_SIM_MULL_PAIR(s64, svint64_t, int64_t, svint32_t, int32_t)
+SVE_SIM_MULL_PAIR(u16, svuint16_t, uint16_t, svuint8_t, uint8_t)
+SVE_SIM_MULL_PAIR(u32, svuint32_t, uint32_t, svuint16_t, uint16_t)
+SVE_SIM_MULL_PAIR(u64, svuint64_t, uint64_t, svuint32_t, uint32_t)
+
+#undef SVE_SIM_MULL_PAIR
+
+// ADDP / FADDP (SVE2): lane pairs of a into the even lanes, of b into the odd ones
+#define SVE_SIM_ADDP(sfx, V, T) \
+    inline V svaddp_##sfx##_m(svbool_t pg, V a, V b) \
+    { \
+        V r; \
+        sve_sim_detail::for_lanes<T>([&](size_t i) { \
+            const V& src = (i & 1) ? b : a; \
+            r.val[i] = sve_sim_detail::active<T>(pg, i) ? sve_sim_detail::Arith<T>::add(src.val[i & ~(size_t)1], src.val[i | 1]) \
+                                                        : a.val[i]; \
+        }); \
+        return r; \
+    } \
+    inline V svaddp_##sfx##_x(svbool_t /*pg*/, V a, V b) { return svaddp_##sfx##_m(svptrue_b8(), a, b); }
+
+SVE_SIM_ADDP(s32, svint32_t, int32_t)
+SVE_SIM_ADDP(u32, svuint32_t, uint32_t)
+SVE_SIM_ADDP(f32, svfloat32_t, float32_t)
+
+#undef SVE_SIM_ADDP
+#undef SVE_SIM_GATHER
+#undef SVE_SIM_GATHER_32
+#undef SVE_SIM_GATHER_64
+#undef SVE_SIM_COMMON
+#undef SVE_SIM_INTEGER
+#undef SVE_SIM_SIGNED
+#undef SVE_SIM_DIVIDE
+#undef SVE_SIM_FLOAT
+#undef SVE_SIM_BINARY
+#undef SVE_SIM_TERNARY
+#undef SVE_SIM_UNARY
+#undef SVE_SIM_COMPARE
+
+#if defined(NEON_SIM_IMPLEMENTATION)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace sve_sim_detail {
+
+thread_local int vl_bytes = 0;
+
+static bool valid_vl(int bits)
+{
+    return bits >= 128 && bits <= SVE_SIM_MAX_VL && bits % 128 == 0;
+}
+
+// NEON_SIM_SVE_VL for threads that never called sve_sim_set_vl()
+int init_vl()
+{
+    static const int process_default = []() {
+        const char* env = getenv("NEON_SIM_SVE_VL");
+        const int bits = env ? atoi(env) : 128;
+        if (!valid_vl(bits))
+        {
+            fprintf(stderr, "%s: NEON_SIM_SVE_VL=%s is not a multiple of 128 in [128, %d], using 128\n", __FUNCTION__,
+                    env, SVE_SIM_MAX_VL);
+            return 16;
+        }
+        return bits / 8;
+    }();
+    vl_bytes = process_default;
+    return vl_bytes;
+}
+
+} // namespace sve_sim_detail
+
+void sve_sim_set_vl(int bits)
+{
+    if (!sve_sim_detail::valid_vl(bits))
+    {
+        fprintf(stderr, "%s: vector length %d is not a multiple of 128 in [128, %d]\n", __FUNCTION__, bits,
+                SVE_SIM_MAX_VL);
+        abort();
+    }
+    sve_sim_detail::vl_bytes = bits / 8;
+}
+
+int sve_sim_get_vl()
+{
+    return (int)svcntb() * 8;
+}
+
+#endif // NEON_SIM_IMPLEMENTATION
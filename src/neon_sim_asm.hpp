@@ -0,0 +1,4553 @@
+#pragma once
+
+//
+// AArch64 assembly micro-interpreter for kernels written as `asm volatile`
+// blocks (ncnn style), which the intrinsic sim cannot compile. It runs the
+// AdvSIMD subset those blocks use plus the scalar, load/store and branch
+// instructions around it, on a register file that converts to and from the
+// same TxN vector types.
+//
+// usage:
+// // in the one .cpp that defines NEON_SIM_IMPLEMENTATION, after arm_neon_sim.hpp
+// #include "neon_sim_asm.hpp"
+//
+// // asm volatile("0: ld1 {v0.4s}, [%0], #16 \n fmul v0.4s, v0.4s, %4.4s \n st1 {v0.4s}, [%1], #16 \n"
+// //              "subs %w2, %w2, #1 \n b.ne 0b" : "+r"(src), "+r"(dst), "+r"(nn) : "0"(src), "w"(scale) : ...);
+// neon_sim_asm("0: ld1 {v0.4s}, [%0], #16 \n fmul v0.4s, v0.4s, %3.4s \n st1 {v0.4s}, [%1], #16 \n"
+//              "subs %w2, %w2, #1 \n b.ne 0b",
+//              { asm_inout(src), asm_inout(dst), asm_inout(nn), asm_in(scale) });
+//
+// // or with a register file of its own
+// AsmProgram prog;
+// if (!prog.assemble("fmla v0.4s, v1.4s, v2.s[1]")) { puts(prog.error().c_str()); }
+// AsmState s;
+// s.set_v(1, a);
+// s.set_v(2, b);
+// prog.run(s);
+// float32x4_t acc = s.get_v<float32x4_t>(0);
+//
+// Text (or encoded instruction words, AsmProgram::decode) is predecoded once
+// into an array of micro-ops: handler pointer, resolved registers, element
+// size and lane count, branch target index. neon_sim_asm() keeps the programs
+// in a cache keyed by block text and operand kinds, so calling a kernel again
+// does not decode again.
+//
+// Supported:
+// - vector: add sub mul mla mls and orr eor bic orn bsl bit bif not/mvn neg abs
+//   umax umin smax smin uabd sabd cmeq cmhi cmhs cmgt cmge cmtst uqadd sqadd
+//   uqsub sqsub addp, fadd fsub fmul fdiv fmax fmin fabd fmla fmls faddp fcmeq
+//   fcmge fcmgt fneg fabs fsqrt scvtf ucvtf fcvtzs fcvtzu, by element:
+//   mul mla mls fmul fmla fmls
+// - widen / narrow: [us]mull [us]mlal [us]mlsl (also by element), [us]addl [us]subl [us]addw
+//   [us]subw [us]shll [us]xtl, xtn sqxtn uqxtn shrn rshrn ("2" forms too)
+// - shift: shl ushr sshr urshr srshr usra ssra
+// - permute / move: zip1 zip2 uzp1 uzp2 trn1 trn2 ext tbl tbx rev16 rev32
+//   rev64 dup ins umov mov movi mvni, reductions addv [us]maxv [us]minv
+//   fmaxv fminv faddp (scalar)
+// - load / store: ld1-ld4 st1-st4 (lists, single lanes), ld1r, ldr str ldur
+//   stur ldp stp (q d s h b w x, offset / pre / post / register), ldrb ldrh
+//   strb strh, prfm (no-op)
+// - scalar: add adds sub subs cmp cmn neg and ands orr eor bic orn eon bics tst
+//   mov mvn movz movn movk mul madd msub udiv sdiv lsl lsr asr ror
+// - branch: b b.<cond> (and b<cond>) cbz cbnz tbz tbnz ret nop, labels
+//   `name:` and numeric local labels `1:` referenced as `1b` / `1f`
+//
+// Not modelled: sp, FPCR / FPSR (fp ops round to nearest with the host's NaN
+// handling), exclusive and atomic memory accesses.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// @brief AArch64 register file the interpreter runs on
+struct AsmState
+{
+    uint8_t v[32][16]; ///< V0-V31, little-endian lane order like TxN::val
+    uint64_t x[32];    ///< X0-X30, x[31] reads as xzr / wzr and ignores writes
+    bool flag_n;
+    bool flag_z;
+    bool flag_c;
+    bool flag_v;
+
+    AsmState()
+    {
+        memset(v, 0, sizeof(v));
+        memset(x, 0, sizeof(x));
+        flag_n = flag_z = flag_c = flag_v = false;
+    }
+
+    /// @brief read Vi as a 64 or 128-bit vector
+    template<typename V>
+    V get_v(int i) const
+    {
+        static_assert(sizeof(V) == 8 || sizeof(V) == 16, "get_v: V must be a 64 or 128-bit vector type");
+        V r;
+        memcpy((void*)&r, v[i], sizeof(V));
+        return r;
+    }
+
+    /// @brief write Vi, a 64-bit vector clears the upper half like a D register write does
+    template<typename V>
+    void set_v(int i, const V& value)
+    {
+        static_assert(sizeof(V) == 8 || sizeof(V) == 16, "set_v: V must be a 64 or 128-bit vector type");
+        memset(v[i], 0, 16);
+        memcpy(v[i], (const void*)&value, sizeof(V));
+    }
+};
+
+namespace neon_sim_asm_detail {
+
+struct AsmOp;
+
+/// @brief micro-op handler, returns true when the branch to AsmOp::target is taken
+typedef bool (*AsmFn)(const AsmOp& op, AsmState& s);
+
+const uint8_t NO_REG = 0xFF;
+
+/// @brief one predecoded instruction
+struct AsmOp
+{
+    AsmFn fn;
+    int64_t imm;     ///< immediate, byte offset or replicated pattern
+    uint32_t target; ///< branch target, micro-op index
+    int line;        ///< source line, or word index for decoded blocks
+    uint8_t d;       ///< registers, NO_REG when unused
+    uint8_t n;
+    uint8_t m;
+    uint8_t a;
+    uint8_t esize;   ///< element bytes
+    uint8_t lanes;   ///< elements processed
+    uint8_t index;   ///< element index, "2" half, shift amount
+    uint8_t index2;  ///< second element index, shift type
+    uint8_t count;   ///< registers in a list, container bytes
+    uint8_t kind;    ///< handler variant: condition, structure, permute kind
+    uint8_t wide;    ///< X (1) or W (0) scalar register
+    uint8_t mode;    ///< addressing mode, set flags
+};
+
+} // namespace neon_sim_asm_detail
+
+/// @brief a predecoded block of AArch64 code
+class AsmProgram
+{
+public:
+    /// @brief assemble GNU syntax text with named registers; false, and error() set, on the first bad line
+    bool assemble(const std::string& text);
+
+    /// @brief predecode little-endian instruction words; branches may target any word or the end of the block
+    bool decode(const uint32_t* words, size_t count);
+
+    bool ok() const
+    {
+        return ok_;
+    }
+
+    const std::string& error() const
+    {
+        return error_;
+    }
+
+    /// @brief number of micro-ops, one per instruction
+    size_t size() const
+    {
+        return ops_.size();
+    }
+
+    /// @brief run until control falls off the end of the block or reaches ret
+    void run(AsmState& s) const;
+
+private:
+    bool assemble(const std::string& text, const uint32_t* words);
+
+    std::vector<neon_sim_asm_detail::AsmOp> ops_;
+    std::string error_;
+    bool ok_ = false;
+};
+
+/// @brief disassemble one instruction word of the supported subset, "" when it is not supported
+/// @note branch targets are printed as byte offsets, `b.ne #-16`, which assemble() accepts
+std::string asm_disassemble(uint32_t word);
+
+/// @brief an operand of neon_sim_asm(), like one entry of an extended asm operand list
+struct AsmOperand
+{
+    void* ptr;
+    size_t size;
+    bool vector; ///< "w" constraint (V register), otherwise "r" (X register)
+    bool input;
+    bool output;
+};
+
+namespace neon_sim_asm_detail {
+
+template<typename T>
+AsmOperand make_operand(const T* v, bool input, bool output)
+{
+    const bool general = std::is_integral<T>::value || std::is_pointer<T>::value || std::is_enum<T>::value;
+    static_assert(sizeof(T) <= 16, "neon_sim_asm: operand does not fit a register");
+    AsmOperand o;
+    o.ptr = (void*)v;
+    o.size = sizeof(T);
+    o.vector = !general;
+    o.input = input;
+    o.output = output;
+    return o;
+}
+
+} // namespace neon_sim_asm_detail
+
+/// @brief "r"(v) / "w"(v): integers and pointers go to X registers, vectors and floats to V registers
+template<typename T>
+AsmOperand asm_in(const T& v)
+{
+    return neon_sim_asm_detail::make_operand(&v, true, false);
+}
+
+/// @brief "=r"(v) / "=w"(v)
+template<typename T>
+AsmOperand asm_out(T& v)
+{
+    return neon_sim_asm_detail::make_operand(&v, false, true);
+}
+
+/// @brief "+r"(v) / "+w"(v)
+template<typename T>
+AsmOperand asm_inout(T& v)
+{
+    return neon_sim_asm_detail::make_operand(&v, true, true);
+}
+
+/// @brief run an `asm volatile` block on the interpreter
+/// @param text block text; %N, %xN, %wN name the X register of operand N, %N, %qN, %dN, %sN, %hN, %bN its V register
+/// @param operands in the order of the asm operand list; registers the text names itself are never assigned to them
+/// @note aborts with the assembler message when the text does not assemble
+void neon_sim_asm(const char* text, std::initializer_list<AsmOperand> operands);
+
+struct AsmCacheStats
+{
+    size_t lookups; ///< neon_sim_asm() calls
+    size_t decodes; ///< blocks assembled, at most one per distinct text and operand kinds
+};
+
+AsmCacheStats asm_cache_stats();
+
+#if defined(NEON_SIM_IMPLEMENTATION)
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace neon_sim_asm_detail {
+
+//----------------------------------------------------------------------
+// 1. lane access and arithmetic helpers
+//----------------------------------------------------------------------
+
+template<typename T>
+static inline T lane(const AsmState& s, int r, int i)
+{
+    T v;
+    memcpy(&v, &s.v[r][i * sizeof(T)], sizeof(T));
+    return v;
+}
+
+template<typename T>
+static inline void put(uint8_t* out, int i, T v)
+{
+    memcpy(out + i * sizeof(T), &v, sizeof(T));
+}
+
+static inline uint64_t xr(const AsmState& s, int r, bool wide)
+{
+    if (r == 31)
+    {
+        return 0;
+    }
+    return wide ? s.x[r] : (uint32_t)s.x[r];
+}
+
+static inline void xw(AsmState& s, int r, bool wide, uint64_t v)
+{
+    if (r != 31)
+    {
+        s.x[r] = wide ? v : (uint32_t)v;
+    }
+}
+
+// integer lane arithmetic goes through the unsigned type, so it wraps like the hardware
+template<typename T>
+static inline T wrap_add(T a, T b)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    return (T)(U)((U)a + (U)b);
+}
+
+template<typename T>
+static inline T wrap_sub(T a, T b)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    return (T)(U)((U)a - (U)b);
+}
+
+template<typename T>
+static inline T wrap_mul(T a, T b)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    return (T)(U)((uint64_t)(U)a * (uint64_t)(U)b);
+}
+
+template<typename T>
+static inline T mask_of(bool b)
+{
+    T v;
+    memset(&v, b ? 0xFF : 0, sizeof(T));
+    return v;
+}
+
+// shift right by 1..bits, arithmetic for signed T
+template<typename T>
+static inline T shr(T a, int sh)
+{
+    if (sh >= (int)sizeof(T) * 8)
+    {
+        return (T)(std::is_signed<T>::value && a < 0 ? -1 : 0);
+    }
+    return (T)(a >> sh);
+}
+
+template<typename T>
+static inline T fp_max(T a, T b)
+{
+    if (a != a || b != b)
+    {
+        return a != a ? a : b;
+    }
+    if (a == 0 && b == 0)
+    {
+        return std::signbit(a) ? b : a;
+    }
+    return a > b ? a : b;
+}
+
+template<typename T>
+static inline T fp_min(T a, T b)
+{
+    if (a != a || b != b)
+    {
+        return a != a ? a : b;
+    }
+    if (a == 0 && b == 0)
+    {
+        return std::signbit(a) ? a : b;
+    }
+    return a < b ? a : b;
+}
+
+// fcvtz*: round toward zero, saturate, NaN -> 0
+template<typename TF, typename TI>
+static inline TI fp_to_int(TF x)
+{
+    if (x != x)
+    {
+        return 0;
+    }
+    if (x <= (TF)std::numeric_limits<TI>::min())
+    {
+        return std::numeric_limits<TI>::min();
+    }
+    if (x >= (TF)std::numeric_limits<TI>::max())
+    {
+        return std::numeric_limits<TI>::max();
+    }
+    return (TI)x;
+}
+
+//----------------------------------------------------------------------
+// 2. lane operations
+//----------------------------------------------------------------------
+
+template<typename T> struct OpAdd { static T apply(T a, T b) { return wrap_add(a, b); } };
+template<typename T> struct OpSub { static T apply(T a, T b) { return wrap_sub(a, b); } };
+template<typename T> struct OpMul { static T apply(T a, T b) { return wrap_mul(a, b); } };
+template<typename T> struct OpAnd { static T apply(T a, T b) { return (T)(a & b); } };
+template<typename T> struct OpOrr { static T apply(T a, T b) { return (T)(a | b); } };
+template<typename T> struct OpEor { static T apply(T a, T b) { return (T)(a ^ b); } };
+template<typename T> struct OpBic { static T apply(T a, T b) { return (T)(a & ~b); } };
+template<typename T> struct OpOrn { static T apply(T a, T b) { return (T)(a | ~b); } };
+template<typename T> struct OpMax { static T apply(T a, T b) { return a > b ? a : b; } };
+template<typename T> struct OpMin { static T apply(T a, T b) { return a < b ? a : b; } };
+template<typename T> struct OpAbd { static T apply(T a, T b) { return a > b ? wrap_sub(a, b) : wrap_sub(b, a); } };
+template<typename T> struct OpCmeq { static T apply(T a, T b) { return mask_of<T>(a == b); } };
+template<typename T> struct OpCmgt { static T apply(T a, T b) { return mask_of<T>(a > b); } };
+template<typename T> struct OpCmge { static T apply(T a, T b) { return mask_of<T>(a >= b); } };
+template<typename T> struct OpCmtst { static T apply(T a, T b) { return mask_of<T>((a & b) != 0); } };
+
+template<typename T>
+struct OpQAdd
+{
+    static T apply(T a, T b)
+    {
+        const T lo = std::numeric_limits<T>::min();
+        const T hi = std::numeric_limits<T>::max();
+        if (std::is_signed<T>::value)
+        {
+            if (b > 0 && a > hi - b)
+            {
+                return hi;
+            }
+            if (b < 0 && a < lo - b)
+            {
+                return lo;
+            }
+            return (T)(a + b);
+        }
+        const T r = (T)(a + b);
+        return r < a ? hi : r;
+    }
+};
+
+template<typename T>
+struct OpQSub
+{
+    static T apply(T a, T b)
+    {
+        const T lo = std::numeric_limits<T>::min();
+        const T hi = std::numeric_limits<T>::max();
+        if (std::is_signed<T>::value)
+        {
+            if (b < 0 && a > hi + b)
+            {
+                return hi;
+            }
+            if (b > 0 && a < lo + b)
+            {
+                return lo;
+            }
+            return (T)(a - b);
+        }
+        return a > b ? (T)(a - b) : (T)0;
+    }
+};
+
+// accumulating: apply(d, n, m)
+template<typename T> struct OpMla { static T apply(T d, T n, T m) { return wrap_add(d, wrap_mul(n, m)); } };
+template<typename T> struct OpMls { static T apply(T d, T n, T m) { return wrap_sub(d, wrap_mul(n, m)); } };
+template<typename T> struct OpBsl { static T apply(T d, T n, T m) { return (T)((d & n) | (~d & m)); } };
+template<typename T> struct OpBit { static T apply(T d, T n, T m) { return (T)((n & m) | (d & ~m)); } };
+template<typename T> struct OpBif { static T apply(T d, T n, T m) { return (T)((d & m) | (n & ~m)); } };
+
+template<typename T> struct OpFAdd { static T apply(T a, T b) { return a + b; } };
+template<typename T> struct OpFSub { static T apply(T a, T b) { return a - b; } };
+template<typename T> struct OpFMul { static T apply(T a, T b) { return a * b; } };
+template<typename T> struct OpFDiv { static T apply(T a, T b) { return a / b; } };
+template<typename T> struct OpFMax { static T apply(T a, T b) { return fp_max(a, b); } };
+template<typename T> struct OpFMin { static T apply(T a, T b) { return fp_min(a, b); } };
+template<typename T> struct OpFAbd { static T apply(T a, T b) { return std::fabs(a - b); } };
+template<typename T> struct OpFCmeq { static T apply(T a, T b) { return mask_of<T>(a == b); } };
+template<typename T> struct OpFCmge { static T apply(T a, T b) { return mask_of<T>(a >= b); } };
+template<typename T> struct OpFCmgt { static T apply(T a, T b) { return mask_of<T>(a > b); } };
+template<typename T> struct OpFmla { static T apply(T d, T n, T m) { return std::fma(n, m, d); } };
+template<typename T> struct OpFmls { static T apply(T d, T n, T m) { return std::fma(-n, m, d); } };
+
+template<typename T> struct OpNot { static T apply(T a) { return (T)~a; } };
+template<typename T> struct OpNeg { static T apply(T a) { return wrap_sub((T)0, a); } };
+template<typename T> struct OpAbs { static T apply(T a) { return a < 0 ? wrap_sub((T)0, a) : a; } };
+template<typename T> struct OpFNeg { static T apply(T a) { return -a; } };
+template<typename T> struct OpFAbs { static T apply(T a) { return std::fabs(a); } };
+template<typename T> struct OpFSqrt { static T apply(T a) { return std::sqrt(a); } };
+
+template<typename TS, typename TD> struct CvtToFp { static TD apply(TS a) { return (TD)a; } };
+template<typename TS, typename TD> struct CvtToInt { static TD apply(TS a) { return fp_to_int<TS, TD>(a); } };
+
+// shift by immediate: apply(d, n, shift)
+template<typename T> struct OpShl { static T apply(T, T a, int sh) { return (T)((uint64_t)a << sh); } };
+template<typename T> struct OpShr { static T apply(T, T a, int sh) { return shr(a, sh); } };
+template<typename T> struct OpRshr { static T apply(T, T a, int sh) { return wrap_add(shr(a, sh), (T)((a >> (sh - 1)) & 1)); } };
+template<typename T> struct OpSra { static T apply(T d, T a, int sh) { return wrap_add(d, shr(a, sh)); } };
+
+// widening: apply(d, n, m) on the wide type
+template<typename T> struct WMul { static T apply(T, T a, T b) { return wrap_mul(a, b); } };
+template<typename T> struct WMla { static T apply(T d, T a, T b) { return wrap_add(d, wrap_mul(a, b)); } };
+template<typename T> struct WMls { static T apply(T d, T a, T b) { return wrap_sub(d, wrap_mul(a, b)); } };
+template<typename T> struct WAdd { static T apply(T, T a, T b) { return wrap_add(a, b); } };
+template<typename T> struct WSub { static T apply(T, T a, T b) { return wrap_sub(a, b); } };
+
+// narrowing: apply(wide value, shift)
+template<typename TS, typename TD> struct NXtn { static TD apply(TS a, int) { return (TD)a; } };
+template<typename TS, typename TD>
+struct NSat
+{
+    static TD apply(TS a, int)
+    {
+        if (a > (TS)std::numeric_limits<TD>::max())
+        {
+            return std::numeric_limits<TD>::max();
+        }
+        if (a < (TS)std::numeric_limits<TD>::min())
+        {
+            return std::numeric_limits<TD>::min();
+        }
+        return (TD)a;
+    }
+};
+template<typename TS, typename TD> struct NShrn { static TD apply(TS a, int sh) { return (TD)((uint64_t)a >> sh); } };
+template<typename TS, typename TD>
+struct NRshrn
+{
+    static TD apply(TS a, int sh)
+    {
+        return (TD)(((uint64_t)a + (1ull << (sh - 1))) >> sh);
+    }
+};
+
+//----------------------------------------------------------------------
+// 3. vector handlers
+//----------------------------------------------------------------------
+
+template<typename T, typename F>
+struct Binary
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.n, i), lane<T>(s, op.m, i)));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename T, typename F>
+struct Ternary
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.d, i), lane<T>(s, op.n, i), lane<T>(s, op.m, i)));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename T, typename F>
+struct BinaryElem
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        const T b = lane<T>(s, op.m, op.index);
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.n, i), b));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename T, typename F>
+struct TernaryElem
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        const T b = lane<T>(s, op.m, op.index);
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.d, i), lane<T>(s, op.n, i), b));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+// addp / faddp: pairs of Vn, then pairs of Vm
+template<typename T, typename F>
+struct Pairwise
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        const int half = op.lanes / 2;
+        for (int i = 0; i < half; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.n, 2 * i), lane<T>(s, op.n, 2 * i + 1)));
+            put<T>(out, half + i, F::apply(lane<T>(s, op.m, 2 * i), lane<T>(s, op.m, 2 * i + 1)));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename T, typename F>
+struct Unary
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.n, i)));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename TS, typename TD>
+struct Convert
+{
+    template<template<typename, typename> class F>
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<TD>(out, i, F<TS, TD>::apply(lane<TS>(s, op.n, i)));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+// addv / [us]maxv / fmaxv / scalar faddp: fold the lanes into element 0
+template<typename T, typename F>
+struct Reduce
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        T acc = lane<T>(s, op.n, 0);
+        for (int i = 1; i < op.lanes; i++)
+        {
+            acc = F::apply(acc, lane<T>(s, op.n, i));
+        }
+        put<T>(out, 0, acc);
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename T, typename F>
+struct ShiftImm
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<T>(out, i, F::apply(lane<T>(s, op.d, i), lane<T>(s, op.n, i), (int)op.imm));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+// lanes = destination lanes, index = 1 for the "2" forms reading the upper half
+template<typename TS, typename TD, typename F, bool WideN>
+struct Widen
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        const int base = op.index * op.lanes;
+        for (int i = 0; i < op.lanes; i++)
+        {
+            const TD a = WideN ? lane<TD>(s, op.n, i) : (TD)lane<TS>(s, op.n, base + i);
+            const TD b = (TD)lane<TS>(s, op.m, base + i);
+            put<TD>(out, i, F::apply(lane<TD>(s, op.d, i), a, b));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+// by element: Vm lane `index2` for every lane
+template<typename TS, typename TD, typename F>
+struct WidenElem
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        uint8_t out[16] = { 0 };
+        const int base = op.index * op.lanes;
+        const TD b = (TD)lane<TS>(s, op.m, op.index2);
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<TD>(out, i, F::apply(lane<TD>(s, op.d, i), (TD)lane<TS>(s, op.n, base + i), b));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+template<typename TS, typename TD>
+struct WidenShift
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        typedef typename std::make_unsigned<TD>::type U;
+        uint8_t out[16] = { 0 };
+        const int base = op.index * op.lanes;
+        for (int i = 0; i < op.lanes; i++)
+        {
+            put<TD>(out, i, (TD)(U)((U)(TD)lane<TS>(s, op.n, base + i) << op.imm));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+// index = 1 for the "2" forms writing the upper half and keeping the lower one
+template<typename TS, typename TD, typename F>
+struct Narrow
+{
+    static bool run(const AsmOp& op, AsmState& s)
+    {
+        const int n_lanes = 16 / sizeof(TS);
+        uint8_t out[16] = { 0 };
+        if (op.index)
+        {
+            memcpy(out, s.v[op.d], 8);
+        }
+        for (int i = 0; i < n_lanes; i++)
+        {
+            put<TD>(out, op.index * n_lanes + i, F::apply(lane<TS>(s, op.n, i), (int)op.imm));
+        }
+        memcpy(s.v[op.d], out, 16);
+        return false;
+    }
+};
+
+typedef AsmFn (*Picker)(int esize);
+typedef AsmFn (*SignedPicker)(int esize, bool is_signed);
+
+template<template<typename, typename> class H, template<typename> class F>
+static AsmFn pick_u(int esize)
+{
+    switch (esize)
+    {
+    case 1: return &H<uint8_t, F<uint8_t> >::run;
+    case 2: return &H<uint16_t, F<uint16_t> >::run;
+    case 4: return &H<uint32_t, F<uint32_t> >::run;
+    case 8: return &H<uint64_t, F<uint64_t> >::run;
+    }
+    return NULL;
+}
+
+template<template<typename, typename> class H, template<typename> class F>
+static AsmFn pick_s(int esize)
+{
+    switch (esize)
+    {
+    case 1: return &H<int8_t, F<int8_t> >::run;
+    case 2: return &H<int16_t, F<int16_t> >::run;
+    case 4: return &H<int32_t, F<int32_t> >::run;
+    case 8: return &H<int64_t, F<int64_t> >::run;
+    }
+    return NULL;
+}
+
+template<template<typename, typename> class H, template<typename> class F>
+static AsmFn pick_f(int esize)
+{
+    switch (esize)
+    {
+    case 4: return &H<float, F<float> >::run;
+    case 8: return &H<double, F<double> >::run;
+    }
+    return NULL;
+}
+
+// bitwise ops only come with 8b / 16b
+template<template<typename, typename> class H, template<typename> class F>
+static AsmFn pick_b(int esize)
+{
+    return esize == 1 ? &H<uint8_t, F<uint8_t> >::run : NULL;
+}
+
+template<template<typename> class F, bool WideN>
+static AsmFn pick_widen(int src_esize, bool is_signed)
+{
+    switch (src_esize)
+    {
+    case 1: return is_signed ? &Widen<int8_t, int16_t, F<int16_t>, WideN>::run : &Widen<uint8_t, uint16_t, F<uint16_t>, WideN>::run;
+    case 2: return is_signed ? &Widen<int16_t, int32_t, F<int32_t>, WideN>::run : &Widen<uint16_t, uint32_t, F<uint32_t>, WideN>::run;
+    case 4: return is_signed ? &Widen<int32_t, int64_t, F<int64_t>, WideN>::run : &Widen<uint32_t, uint64_t, F<uint64_t>, WideN>::run;
+    }
+    return NULL;
+}
+
+template<template<typename> class F>
+static AsmFn pick_widen_elem(int src_esize, bool is_signed)
+{
+    switch (src_esize)
+    {
+    case 2: return is_signed ? &WidenElem<int16_t, int32_t, F<int32_t> >::run : &WidenElem<uint16_t, uint32_t, F<uint32_t> >::run;
+    case 4: return is_signed ? &WidenElem<int32_t, int64_t, F<int64_t> >::run : &WidenElem<uint32_t, uint64_t, F<uint64_t> >::run;
+    }
+    return NULL;
+}
+
+static AsmFn pick_widen_shift(int src_esize, bool is_signed)
+{
+    switch (src_esize)
+    {
+    case 1: return is_signed ? &WidenShift<int8_t, int16_t>::run : &WidenShift<uint8_t, uint16_t>::run;
+    case 2: return is_signed ? &WidenShift<int16_t, int32_t>::run : &WidenShift<uint16_t, uint32_t>::run;
+    case 4: return is_signed ? &WidenShift<int32_t, int64_t>::run : &WidenShift<uint32_t, uint64_t>::run;
+    }
+    return NULL;
+}
+
+template<template<typename, typename> class F>
+static AsmFn pick_narrow(int dst_esize, bool is_signed)
+{
+    switch (dst_esize)
+    {
+    case 1: return is_signed ? &Narrow<int16_t, int8_t, F<int16_t, int8_t> >::run : &Narrow<uint16_t, uint8_t, F<uint16_t, uint8_t> >::run;
+    case 2: return is_signed ? &Narrow<int32_t, int16_t, F<int32_t, int16_t> >::run : &Narrow<uint32_t, uint16_t, F<uint32_t, uint16_t> >::run;
+    case 4: return is_signed ? &Narrow<int64_t, int32_t, F<int64_t, int32_t> >::run : &Narrow<uint64_t, uint32_t, F<uint64_t, uint32_t> >::run;
+    }
+    return NULL;
+}
+
+static AsmFn pick_scvtf(int esize)
+{
+    return esize == 4 ? &Convert<int32_t, float>::run<CvtToFp> : esize == 8 ? &Convert<int64_t, double>::run<CvtToFp> : NULL;
+}
+
+static AsmFn pick_ucvtf(int esize)
+{
+    return esize == 4 ? &Convert<uint32_t, float>::run<CvtToFp> : esize == 8 ? &Convert<uint64_t, double>::run<CvtToFp> : NULL;
+}
+
+static AsmFn pick_fcvtzs(int esize)
+{
+    return esize == 4 ? &Convert<float, int32_t>::run<CvtToInt> : esize == 8 ? &Convert<double, int64_t>::run<CvtToInt> : NULL;
+}
+
+static AsmFn pick_fcvtzu(int esize)
+{
+    return esize == 4 ? &Convert<float, uint32_t>::run<CvtToInt> : esize == 8 ? &Convert<double, uint64_t>::run<CvtToInt> : NULL;
+}
+
+enum PermuteKind
+{
+    ZIP1, ZIP2, UZP1, UZP2, TRN1, TRN2
+};
+
+static bool h_permute(const AsmOp& op, AsmState& s)
+{
+    const int e = op.esize;
+    const int n = op.lanes;
+    const int half = n / 2;
+    uint8_t cat[32];
+    memcpy(cat, s.v[op.n], n * e);
+    memcpy(cat + n * e, s.v[op.m], n * e);
+    const uint8_t* vn = s.v[op.n];
+    const uint8_t* vm = s.v[op.m];
+    uint8_t out[16] = { 0 };
+    for (int i = 0; i < half; i++)
+    {
+        switch (op.kind)
+        {
+        case ZIP1:
+        case ZIP2:
+        {
+            const int k = op.kind == ZIP1 ? i : half + i;
+            memcpy(out + (2 * i) * e, vn + k * e, e);
+            memcpy(out + (2 * i + 1) * e, vm + k * e, e);
+            break;
+        }
+        case TRN1:
+        case TRN2:
+        {
+            const int k = 2 * i + (op.kind == TRN2);
+            memcpy(out + (2 * i) * e, vn + k * e, e);
+            memcpy(out + (2 * i + 1) * e, vm + k * e, e);
+            break;
+        }
+        default:
+        {
+            const int odd = op.kind == UZP2;
+            memcpy(out + i * e, cat + (2 * i + odd) * e, e);
+            memcpy(out + (half + i) * e, cat + (2 * (half + i) + odd) * e, e);
+            break;
+        }
+        }
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_ext(const AsmOp& op, AsmState& s)
+{
+    const int bytes = op.lanes;
+    uint8_t cat[32];
+    memcpy(cat, s.v[op.n], bytes);
+    memcpy(cat + bytes, s.v[op.m], bytes);
+    uint8_t out[16] = { 0 };
+    memcpy(out, cat + op.imm, bytes);
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+// tbl / tbx (kind 1): table Vn..Vn+count-1, indexes in Vm
+static bool h_tbl(const AsmOp& op, AsmState& s)
+{
+    uint8_t table[64];
+    for (int r = 0; r < op.count; r++)
+    {
+        memcpy(table + 16 * r, s.v[(op.n + r) & 31], 16);
+    }
+    uint8_t out[16] = { 0 };
+    for (int i = 0; i < op.lanes; i++)
+    {
+        const int idx = s.v[op.m][i];
+        out[i] = idx < 16 * op.count ? table[idx] : (op.kind ? s.v[op.d][i] : 0);
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+// rev16 / rev32 / rev64: reverse the elements inside each `count`-byte container
+static bool h_rev(const AsmOp& op, AsmState& s)
+{
+    const int e = op.esize;
+    const int c = op.count;
+    const int bytes = op.lanes * e;
+    uint8_t out[16] = { 0 };
+    for (int base = 0; base < bytes; base += c)
+    {
+        for (int j = 0; j < c / e; j++)
+        {
+            memcpy(out + base + j * e, s.v[op.n] + base + (c / e - 1 - j) * e, e);
+        }
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_dup_elem(const AsmOp& op, AsmState& s)
+{
+    uint8_t value[8];
+    memcpy(value, s.v[op.n] + op.index * op.esize, op.esize);
+    uint8_t out[16] = { 0 };
+    for (int i = 0; i < op.lanes; i++)
+    {
+        memcpy(out + i * op.esize, value, op.esize);
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_dup_gen(const AsmOp& op, AsmState& s)
+{
+    const uint64_t value = xr(s, op.n, true);
+    uint8_t out[16] = { 0 };
+    for (int i = 0; i < op.lanes; i++)
+    {
+        memcpy(out + i * op.esize, &value, op.esize);
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_ins_gen(const AsmOp& op, AsmState& s)
+{
+    const uint64_t value = xr(s, op.n, true);
+    memcpy(s.v[op.d] + op.index * op.esize, &value, op.esize);
+    return false;
+}
+
+static bool h_ins_elem(const AsmOp& op, AsmState& s)
+{
+    uint8_t value[8];
+    memcpy(value, s.v[op.n] + op.index2 * op.esize, op.esize);
+    memcpy(s.v[op.d] + op.index * op.esize, value, op.esize);
+    return false;
+}
+
+static bool h_umov(const AsmOp& op, AsmState& s)
+{
+    uint64_t value = 0;
+    memcpy(&value, s.v[op.n] + op.index * op.esize, op.esize);
+    xw(s, op.d, op.wide != 0, value);
+    return false;
+}
+
+// movi / mvni: imm holds the 64-bit pattern
+static bool h_movi(const AsmOp& op, AsmState& s)
+{
+    uint8_t out[16] = { 0 };
+    const uint64_t pattern = (uint64_t)op.imm;
+    for (int i = 0; i < op.lanes * op.esize; i++)
+    {
+        out[i] = (uint8_t)(pattern >> (8 * (i & 7)));
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+//----------------------------------------------------------------------
+// 4. load / store handlers
+//----------------------------------------------------------------------
+
+enum AddressMode
+{
+    MODE_OFFSET,   ///< [xn, #imm]
+    MODE_PRE,      ///< [xn, #imm]!
+    MODE_POST,     ///< [xn], #imm
+    MODE_REG,      ///< [xn, xm, lsl #index2]
+    MODE_POST_REG, ///< [xn], xm
+};
+
+// effective address; applies the pre / post index write back
+static inline uint8_t* address(const AsmOp& op, AsmState& s)
+{
+    const uint64_t base = s.x[op.n];
+    switch (op.mode)
+    {
+    case MODE_OFFSET:
+        return (uint8_t*)(uintptr_t)(base + op.imm);
+    case MODE_PRE:
+        s.x[op.n] = base + op.imm;
+        return (uint8_t*)(uintptr_t)(base + op.imm);
+    case MODE_POST:
+        s.x[op.n] = base + op.imm;
+        return (uint8_t*)(uintptr_t)base;
+    case MODE_REG:
+        return (uint8_t*)(uintptr_t)(base + (xr(s, op.m, true) << op.index2));
+    default:
+        s.x[op.n] = base + xr(s, op.m, true);
+        return (uint8_t*)(uintptr_t)base;
+    }
+}
+
+// ld1 (kind 1, count consecutive registers) / ld2-ld4 (kind = count, interleaved)
+static bool h_ld_struct(const AsmOp& op, AsmState& s)
+{
+    const uint8_t* p = address(op, s);
+    const int e = op.esize;
+    const int bytes = op.lanes * e;
+    uint8_t out[4][16];
+    memset(out, 0, sizeof(out));
+    if (op.kind == 1)
+    {
+        for (int r = 0; r < op.count; r++)
+        {
+            memcpy(out[r], p + r * bytes, bytes);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < op.lanes; i++)
+        {
+            for (int k = 0; k < op.kind; k++)
+            {
+                memcpy(out[k] + i * e, p + (i * op.kind + k) * e, e);
+            }
+        }
+    }
+    for (int r = 0; r < op.count; r++)
+    {
+        memcpy(s.v[(op.d + r) & 31], out[r], 16);
+    }
+    return false;
+}
+
+static bool h_st_struct(const AsmOp& op, AsmState& s)
+{
+    uint8_t* p = address(op, s);
+    const int e = op.esize;
+    const int bytes = op.lanes * e;
+    if (op.kind == 1)
+    {
+        for (int r = 0; r < op.count; r++)
+        {
+            memcpy(p + r * bytes, s.v[(op.d + r) & 31], bytes);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < op.lanes; i++)
+        {
+            for (int k = 0; k < op.kind; k++)
+            {
+                memcpy(p + (i * op.kind + k) * e, s.v[(op.d + k) & 31] + i * e, e);
+            }
+        }
+    }
+    return false;
+}
+
+static bool h_ld1r(const AsmOp& op, AsmState& s)
+{
+    const uint8_t* p = address(op, s);
+    uint8_t out[16] = { 0 };
+    for (int i = 0; i < op.lanes; i++)
+    {
+        memcpy(out + i * op.esize, p, op.esize);
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_ld1_lane(const AsmOp& op, AsmState& s)
+{
+    const uint8_t* p = address(op, s);
+    memcpy(s.v[op.d] + op.index * op.esize, p, op.esize);
+    return false;
+}
+
+static bool h_st1_lane(const AsmOp& op, AsmState& s)
+{
+    uint8_t* p = address(op, s);
+    memcpy(p, s.v[op.d] + op.index * op.esize, op.esize);
+    return false;
+}
+
+// ldr / ldp of b h s d q registers: Vd, and Va for the pair
+static bool h_ldr_v(const AsmOp& op, AsmState& s)
+{
+    const uint8_t* p = address(op, s);
+    uint8_t out[16] = { 0 };
+    memcpy(out, p, op.esize);
+    if (op.count == 2)
+    {
+        uint8_t out2[16] = { 0 };
+        memcpy(out2, p + op.esize, op.esize);
+        memcpy(s.v[op.a], out2, 16);
+    }
+    memcpy(s.v[op.d], out, 16);
+    return false;
+}
+
+static bool h_str_v(const AsmOp& op, AsmState& s)
+{
+    uint8_t* p = address(op, s);
+    memcpy(p, s.v[op.d], op.esize);
+    if (op.count == 2)
+    {
+        memcpy(p + op.esize, s.v[op.a], op.esize);
+    }
+    return false;
+}
+
+static bool h_ldr_x(const AsmOp& op, AsmState& s)
+{
+    const uint8_t* p = address(op, s);
+    uint64_t v = 0;
+    memcpy(&v, p, op.esize);
+    if (op.count == 2)
+    {
+        uint64_t v2 = 0;
+        memcpy(&v2, p + op.esize, op.esize);
+        xw(s, op.a, op.wide != 0, v2);
+    }
+    xw(s, op.d, op.wide != 0, v);
+    return false;
+}
+
+static bool h_str_x(const AsmOp& op, AsmState& s)
+{
+    const uint64_t v = xr(s, op.d, true);
+    const uint64_t v2 = op.count == 2 ? xr(s, op.a, true) : 0;
+    uint8_t* p = address(op, s);
+    memcpy(p, &v, op.esize);
+    if (op.count == 2)
+    {
+        memcpy(p + op.esize, &v2, op.esize);
+    }
+    return false;
+}
+
+static bool h_nop(const AsmOp&, AsmState&)
+{
+    return false;
+}
+
+//----------------------------------------------------------------------
+// 5. scalar and branch handlers
+//----------------------------------------------------------------------
+
+enum ShiftType
+{
+    SHIFT_LSL, SHIFT_LSR, SHIFT_ASR, SHIFT_ROR
+};
+
+static inline uint64_t shift_value(uint64_t v, int type, int amount, bool wide)
+{
+    const int bits = wide ? 64 : 32;
+    if (!wide)
+    {
+        v = (uint32_t)v;
+    }
+    if (amount == 0)
+    {
+        return v;
+    }
+    switch (type)
+    {
+    case SHIFT_LSL:
+        v <<= amount;
+        break;
+    case SHIFT_LSR:
+        v >>= amount;
+        break;
+    case SHIFT_ASR:
+        v = wide ? (uint64_t)((int64_t)v >> amount) : (uint64_t)(uint32_t)((int32_t)(uint32_t)v >> amount);
+        break;
+    default:
+        v = (v >> amount) | (v << (bits - amount));
+        break;
+    }
+    return wide ? v : (uint32_t)v;
+}
+
+// second operand: imm when m is NO_REG, else Xm shifted by (index2, index)
+static inline uint64_t operand2(const AsmOp& op, const AsmState& s)
+{
+    if (op.m == NO_REG)
+    {
+        return op.wide ? (uint64_t)op.imm : (uint32_t)op.imm;
+    }
+    return shift_value(xr(s, op.m, op.wide != 0), op.index2, op.index, op.wide != 0);
+}
+
+// add / sub (kind 1), mode 1 sets the flags
+static bool h_addsub(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const uint64_t a = xr(s, op.n, wide);
+    const uint64_t b = operand2(op, s);
+    const uint64_t raw = op.kind ? a - b : a + b;
+    const uint64_t r = wide ? raw : (uint32_t)raw;
+    if (op.mode)
+    {
+        const int top = wide ? 63 : 31;
+        s.flag_n = ((r >> top) & 1) != 0;
+        s.flag_z = r == 0;
+        if (op.kind)
+        {
+            s.flag_c = a >= b;
+            s.flag_v = ((((a ^ b) & (a ^ r)) >> top) & 1) != 0;
+        }
+        else
+        {
+            s.flag_c = wide ? raw < a : raw > 0xFFFFFFFFull;
+            s.flag_v = (((~(a ^ b) & (a ^ r)) >> top) & 1) != 0;
+        }
+    }
+    xw(s, op.d, wide, r);
+    return false;
+}
+
+enum LogicKind
+{
+    LOGIC_AND, LOGIC_ORR, LOGIC_EOR, LOGIC_BIC, LOGIC_ORN, LOGIC_EON
+};
+
+// mode 1 (ands / bics / tst) sets N and Z, clears C and V
+static bool h_logic(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const uint64_t a = xr(s, op.n, wide);
+    const uint64_t b = operand2(op, s);
+    uint64_t r;
+    switch (op.kind)
+    {
+    case LOGIC_AND: r = a & b; break;
+    case LOGIC_ORR: r = a | b; break;
+    case LOGIC_EOR: r = a ^ b; break;
+    case LOGIC_BIC: r = a & ~b; break;
+    case LOGIC_ORN: r = a | ~b; break;
+    default: r = a ^ ~b; break;
+    }
+    if (!wide)
+    {
+        r = (uint32_t)r;
+    }
+    if (op.mode)
+    {
+        s.flag_n = ((r >> (wide ? 63 : 31)) & 1) != 0;
+        s.flag_z = r == 0;
+        s.flag_c = false;
+        s.flag_v = false;
+    }
+    xw(s, op.d, wide, r);
+    return false;
+}
+
+// madd / msub (kind 1): d = a +- n * m
+static bool h_madd(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const uint64_t p = xr(s, op.n, wide) * xr(s, op.m, wide);
+    const uint64_t acc = xr(s, op.a, wide);
+    xw(s, op.d, wide, op.kind ? acc - p : acc + p);
+    return false;
+}
+
+// udiv / sdiv (kind 1), division by zero gives 0
+static bool h_div(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const uint64_t a = xr(s, op.n, wide);
+    const uint64_t b = xr(s, op.m, wide);
+    uint64_t r = 0;
+    if (b != 0)
+    {
+        if (!op.kind)
+        {
+            r = a / b;
+        }
+        else if (wide)
+        {
+            const int64_t sa = (int64_t)a;
+            const int64_t sb = (int64_t)b;
+            r = (sa == std::numeric_limits<int64_t>::min() && sb == -1) ? a : (uint64_t)(sa / sb);
+        }
+        else
+        {
+            const int32_t sa = (int32_t)(uint32_t)a;
+            const int32_t sb = (int32_t)(uint32_t)b;
+            r = (sa == std::numeric_limits<int32_t>::min() && sb == -1) ? a : (uint64_t)(uint32_t)(sa / sb);
+        }
+    }
+    xw(s, op.d, wide, r);
+    return false;
+}
+
+// lsl / lsr / asr / ror by register, kind is the shift type
+static bool h_shiftv(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const int amount = (int)(xr(s, op.m, true) & (wide ? 63 : 31));
+    xw(s, op.d, wide, shift_value(xr(s, op.n, wide), op.kind, amount, wide));
+    return false;
+}
+
+static bool h_movk(const AsmOp& op, AsmState& s)
+{
+    const bool wide = op.wide != 0;
+    const uint64_t mask = 0xFFFFull << op.index;
+    xw(s, op.d, wide, (xr(s, op.d, wide) & ~mask) | ((uint64_t)op.imm << op.index));
+    return false;
+}
+
+static inline bool condition_holds(const AsmState& s, int cond)
+{
+    bool r;
+    switch (cond >> 1)
+    {
+    case 0: r = s.flag_z; break;                                    // eq
+    case 1: r = s.flag_c; break;                                    // cs
+    case 2: r = s.flag_n; break;                                    // mi
+    case 3: r = s.flag_v; break;                                    // vs
+    case 4: r = s.flag_c && !s.flag_z; break;                       // hi
+    case 5: r = s.flag_n == s.flag_v; break;                        // ge
+    case 6: r = !s.flag_z && s.flag_n == s.flag_v; break;           // gt
+    default: return true;                                           // al, nv
+    }
+    return (cond & 1) ? !r : r;
+}
+
+static bool h_b(const AsmOp&, AsmState&)
+{
+    return true;
+}
+
+static bool h_bcond(const AsmOp& op, AsmState& s)
+{
+    return condition_holds(s, op.kind);
+}
+
+// cbz / cbnz (kind 1)
+static bool h_cbz(const AsmOp& op, AsmState& s)
+{
+    return (xr(s, op.d, op.wide != 0) == 0) != (op.kind != 0);
+}
+
+// tbz / tbnz (kind 1), bit number in index
+static bool h_tbz(const AsmOp& op, AsmState& s)
+{
+    return (((xr(s, op.d, true) >> op.index) & 1) == 0) != (op.kind != 0);
+}
+
+//----------------------------------------------------------------------
+// 6. text front end
+//----------------------------------------------------------------------
+
+struct Arg
+{
+    enum Kind
+    {
+        VREG,  ///< v3.4s
+        VELEM, ///< v3.s[1]
+        VLIST, ///< {v0.4s, v1.4s}, {v0.s}[1]
+        XREG,  ///< x3, w3, xzr, sp
+        FREG,  ///< q3 d3 s3 h3 b3
+        IMM,   ///< #16, #1.5, #0x10
+        MEM,   ///< [x0], [x0, #16]!, [x0, x1, lsl #2]
+        SHIFT, ///< lsl #12
+        NAME,  ///< label or prefetch operation
+    };
+
+    Kind kind = NAME;
+    int reg = 0;
+    int count = 1;         ///< VLIST registers
+    int esize = 0;         ///< element bytes, FREG bytes
+    int lanes = 0;         ///< VREG / VLIST lanes, 0 for element lists
+    int index = -1;        ///< VELEM / lane list index
+    bool wide = true;      ///< XREG: x (true) or w
+    bool sp = false;
+    bool is_float = false; ///< IMM written with a fraction or exponent
+    int64_t imm = 0;       ///< IMM, MEM offset, SHIFT amount
+    double fimm = 0;
+    int offset_reg = -1;   ///< MEM register offset
+    int shift = 0;         ///< MEM register offset shift, SHIFT type
+    bool pre = false;      ///< MEM with write back
+    std::string name;
+};
+
+static std::string trim(const std::string& s)
+{
+    size_t b = 0;
+    size_t e = s.size();
+    while (b < e && isspace((unsigned char)s[b]))
+    {
+        b++;
+    }
+    while (e > b && isspace((unsigned char)s[e - 1]))
+    {
+        e--;
+    }
+    return s.substr(b, e - b);
+}
+
+static std::string lower(std::string s)
+{
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        s[i] = (char)tolower((unsigned char)s[i]);
+    }
+    return s;
+}
+
+static std::string format(const char* fmt, ...)
+{
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+// commas outside [] and {}
+static std::vector<std::string> split_operands(const std::string& s)
+{
+    std::vector<std::string> out;
+    int depth = 0;
+    size_t start = 0;
+    for (size_t i = 0; i <= s.size(); i++)
+    {
+        const char c = i < s.size() ? s[i] : ',';
+        if (c == '[' || c == '{')
+        {
+            depth++;
+        }
+        else if (c == ']' || c == '}')
+        {
+            depth--;
+        }
+        else if (c == ',' && depth <= 0)
+        {
+            const std::string t = trim(s.substr(start, i - start));
+            if (!t.empty() || i < s.size())
+            {
+                out.push_back(t);
+            }
+            start = i + 1;
+        }
+    }
+    return out;
+}
+
+static bool parse_int(const std::string& t, int64_t& v)
+{
+    const char* p = t.c_str();
+    bool neg = false;
+    if (*p == '-' || *p == '+')
+    {
+        neg = *p == '-';
+        p++;
+    }
+    if (!isdigit((unsigned char)*p))
+    {
+        return false;
+    }
+    char* end = NULL;
+    const unsigned long long u = strtoull(p, &end, 0);
+    if (*end)
+    {
+        return false;
+    }
+    v = neg ? -(int64_t)u : (int64_t)u;
+    return true;
+}
+
+static bool parse_regnum(const std::string& t, size_t from, int& r)
+{
+    if (from >= t.size() || t.size() - from > 2)
+    {
+        return false;
+    }
+    r = 0;
+    for (size_t i = from; i < t.size(); i++)
+    {
+        if (!isdigit((unsigned char)t[i]))
+        {
+            return false;
+        }
+        r = r * 10 + (t[i] - '0');
+    }
+    return r < 32;
+}
+
+static bool parse_arrangement(const std::string& t, int& esize, int& lanes)
+{
+    static const struct
+    {
+        const char* name;
+        int esize;
+        int lanes;
+    } table[] = {
+        { "8b", 1, 8 }, { "16b", 1, 16 }, { "4h", 2, 4 }, { "8h", 2, 8 },
+        { "2s", 4, 2 }, { "4s", 4, 4 }, { "1d", 8, 1 }, { "2d", 8, 2 },
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+    {
+        if (t == table[i].name)
+        {
+            esize = table[i].esize;
+            lanes = table[i].lanes;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int element_size(char c)
+{
+    switch (c)
+    {
+    case 'b': return 1;
+    case 'h': return 2;
+    case 's': return 4;
+    case 'd': return 8;
+    case 'q': return 16;
+    }
+    return 0;
+}
+
+// "[2]" -> 2
+static bool parse_lane_index(const std::string& t, int& index)
+{
+    int64_t v;
+    if (t.size() < 3 || t[0] != '[' || t[t.size() - 1] != ']' || !parse_int(t.substr(1, t.size() - 2), v) || v < 0)
+    {
+        return false;
+    }
+    index = (int)v;
+    return true;
+}
+
+// v3.4s, v3.s[1], v3.s (inside lane lists)
+static bool parse_vector(const std::string& t, Arg& a, std::string& err)
+{
+    const size_t dot = t.find('.');
+    if (dot == std::string::npos || !parse_regnum(t.substr(0, dot), 1, a.reg))
+    {
+        err = "bad vector register '" + t + "'";
+        return false;
+    }
+    const std::string suffix = t.substr(dot + 1);
+    const size_t bracket = suffix.find('[');
+    if (bracket == std::string::npos && parse_arrangement(suffix, a.esize, a.lanes))
+    {
+        a.kind = Arg::VREG;
+        return true;
+    }
+    const std::string elem = suffix.substr(0, bracket);
+    if (elem.size() != 1 || element_size(elem[0]) == 0 || elem[0] == 'q')
+    {
+        err = "bad arrangement '" + t + "'";
+        return false;
+    }
+    a.kind = Arg::VELEM;
+    a.esize = element_size(elem[0]);
+    a.lanes = 0;
+    if (bracket != std::string::npos)
+    {
+        if (!parse_lane_index(suffix.substr(bracket), a.index) || a.index >= 16 / a.esize)
+        {
+            err = "bad element index '" + t + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+// {v0.4s, v1.4s}, {v0.4s-v3.4s}, {v0.s, v1.s}[1]
+static bool parse_list(const std::string& t, Arg& a, std::string& err)
+{
+    const size_t close = t.find('}');
+    if (close == std::string::npos)
+    {
+        err = "missing '}' in '" + t + "'";
+        return false;
+    }
+    std::vector<std::string> items = split_operands(t.substr(1, close - 1));
+    std::vector<Arg> regs;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const size_t dash = items[i].find('-');
+        Arg first;
+        if (!parse_vector(trim(items[i].substr(0, dash)), first, err))
+        {
+            return false;
+        }
+        regs.push_back(first);
+        if (dash != std::string::npos)
+        {
+            Arg last;
+            if (!parse_vector(trim(items[i].substr(dash + 1)), last, err))
+            {
+                return false;
+            }
+            for (int r = (first.reg + 1) & 31; r != ((last.reg + 1) & 31); r = (r + 1) & 31)
+            {
+                Arg next = first;
+                next.reg = r;
+                regs.push_back(next);
+                if (regs.size() > 4)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    if (regs.empty() || regs.size() > 4)
+    {
+        err = "register list needs 1 to 4 registers: '" + t + "'";
+        return false;
+    }
+    for (size_t i = 1; i < regs.size(); i++)
+    {
+        if (regs[i].reg != ((regs[0].reg + (int)i) & 31) || regs[i].esize != regs[0].esize ||
+            regs[i].lanes != regs[0].lanes || regs[i].kind != regs[0].kind)
+        {
+            err = "register list must be consecutive registers of one arrangement: '" + t + "'";
+            return false;
+        }
+    }
+    if (regs[0].kind == Arg::VELEM && regs[0].index >= 0)
+    {
+        err = "lane index goes after the list: '" + t + "'";
+        return false;
+    }
+    a.kind = Arg::VLIST;
+    a.reg = regs[0].reg;
+    a.count = (int)regs.size();
+    a.esize = regs[0].esize;
+    a.lanes = regs[0].lanes;
+    a.index = -1;
+    const std::string rest = trim(t.substr(close + 1));
+    if (!rest.empty())
+    {
+        if (regs[0].kind != Arg::VELEM || !parse_lane_index(rest, a.index) || a.index >= 16 / a.esize)
+        {
+            err = "bad lane index in '" + t + "'";
+            return false;
+        }
+    }
+    else if (regs[0].kind == Arg::VELEM)
+    {
+        err = "missing lane index in '" + t + "'";
+        return false;
+    }
+    return true;
+}
+
+static bool parse_arg(const std::string& raw, Arg& a, std::string& err);
+
+// [x0], [x0, #16], [x0, #16]!, [x0, x1], [x0, x1, lsl #4]
+static bool parse_mem(const std::string& t, Arg& a, std::string& err)
+{
+    const size_t close = t.find(']');
+    if (close == std::string::npos)
+    {
+        err = "missing ']' in '" + t + "'";
+        return false;
+    }
+    const std::string rest = trim(t.substr(close + 1));
+    if (!rest.empty() && rest != "!")
+    {
+        err = "unexpected '" + rest + "' after address";
+        return false;
+    }
+    std::vector<std::string> parts = split_operands(t.substr(1, close - 1));
+    Arg base;
+    if (parts.empty() || parts.size() > 3 || !parse_arg(parts[0], base, err))
+    {
+        if (err.empty())
+        {
+            err = "bad address '" + t + "'";
+        }
+        return false;
+    }
+    if (base.kind != Arg::XREG || !base.wide || base.reg == 31)
+    {
+        err = base.sp ? "sp is not supported" : "address base must be an x register: '" + t + "'";
+        return false;
+    }
+    a.kind = Arg::MEM;
+    a.reg = base.reg;
+    a.pre = rest == "!";
+    if (parts.size() >= 2)
+    {
+        Arg off;
+        if (!parse_arg(parts[1], off, err))
+        {
+            return false;
+        }
+        if (off.kind == Arg::IMM && !off.is_float && parts.size() == 2)
+        {
+            a.imm = off.imm;
+        }
+        else if (off.kind == Arg::XREG && off.wide && !off.sp && !a.pre)
+        {
+            a.offset_reg = off.reg;
+            if (parts.size() == 3)
+            {
+                Arg sh;
+                if (!parse_arg(parts[2], sh, err) || sh.kind != Arg::SHIFT || sh.shift != SHIFT_LSL)
+                {
+                    err = "register offset only takes lsl: '" + t + "'";
+                    return false;
+                }
+                a.shift = (int)sh.imm;
+            }
+        }
+        else
+        {
+            err = "bad address '" + t + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_arg(const std::string& raw, Arg& a, std::string& err)
+{
+    const std::string t = lower(trim(raw));
+    a = Arg();
+    if (t.empty())
+    {
+        err = "empty operand";
+        return false;
+    }
+    if (t[0] == '{')
+    {
+        return parse_list(t, a, err);
+    }
+    if (t[0] == '[')
+    {
+        return parse_mem(t, a, err);
+    }
+    static const char* shifts[] = { "lsl", "lsr", "asr", "ror", "msl" };
+    for (int k = 0; k < 5; k++)
+    {
+        if (t.compare(0, 3, shifts[k]) == 0 && t.size() > 3 && isspace((unsigned char)t[3]))
+        {
+            std::string amount = trim(t.substr(4));
+            if (!amount.empty() && amount[0] == '#')
+            {
+                amount = amount.substr(1);
+            }
+            if (!parse_int(amount, a.imm) || a.imm < 0 || a.imm > 63)
+            {
+                err = "bad shift '" + t + "'";
+                return false;
+            }
+            a.kind = Arg::SHIFT;
+            a.shift = k;
+            return true;
+        }
+    }
+    if (t[0] == '#' || t[0] == '-' || t[0] == '+' || isdigit((unsigned char)t[0]))
+    {
+        const std::string num = t[0] == '#' ? trim(t.substr(1)) : t;
+        // numeric local label reference: 1b, 2f
+        if (t[0] != '#' && num.size() >= 2 && (num[num.size() - 1] == 'b' || num[num.size() - 1] == 'f'))
+        {
+            bool digits = true;
+            for (size_t i = 0; i + 1 < num.size(); i++)
+            {
+                digits = digits && isdigit((unsigned char)num[i]);
+            }
+            if (digits)
+            {
+                a.kind = Arg::NAME;
+                a.name = num;
+                return true;
+            }
+        }
+        a.kind = Arg::IMM;
+        if (parse_int(num, a.imm))
+        {
+            a.fimm = (double)a.imm;
+            return true;
+        }
+        char* end = NULL;
+        a.fimm = strtod(num.c_str(), &end);
+        if (!num.empty() && *end == '\0' && num.find("0x") == std::string::npos)
+        {
+            a.is_float = true;
+            return true;
+        }
+        err = "bad immediate '" + t + "'";
+        return false;
+    }
+    if (t == "xzr" || t == "wzr")
+    {
+        a.kind = Arg::XREG;
+        a.reg = 31;
+        a.wide = t[0] == 'x';
+        return true;
+    }
+    if (t == "sp" || t == "wsp")
+    {
+        a.kind = Arg::XREG;
+        a.reg = 31;
+        a.sp = true;
+        a.wide = t == "sp";
+        return true;
+    }
+    if ((t[0] == 'x' || t[0] == 'w') && parse_regnum(t, 1, a.reg) && a.reg < 31)
+    {
+        a.kind = Arg::XREG;
+        a.wide = t[0] == 'x';
+        return true;
+    }
+    if (t[0] == 'v' && t.size() > 1 && isdigit((unsigned char)t[1]))
+    {
+        return parse_vector(t, a, err);
+    }
+    if (element_size(t[0]) && parse_regnum(t, 1, a.reg))
+    {
+        a.kind = Arg::FREG;
+        a.esize = element_size(t[0]);
+        return true;
+    }
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        if (!isalnum((unsigned char)t[i]) && t[i] != '_' && t[i] != '.' && t[i] != '$')
+        {
+            err = "bad operand '" + raw + "'";
+            return false;
+        }
+    }
+    a.kind = Arg::NAME;
+    a.name = t;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// 7. instruction builders
+//----------------------------------------------------------------------
+
+static const char* const kConditions[16] = {
+    "eq", "ne", "cs", "cc", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le", "al", "nv",
+};
+
+static int parse_condition(const std::string& c)
+{
+    if (c == "hs")
+    {
+        return 2;
+    }
+    if (c == "lo")
+    {
+        return 3;
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        if (c == kConditions[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+struct Builder
+{
+    std::string mn;
+    std::vector<Arg> args;
+    AsmOp op;
+    bool branch = false;
+    std::string label;    ///< branch target label, empty for a relative #offset
+    int64_t relative = 0; ///< branch byte offset
+    std::string error;
+
+    Builder()
+    {
+        memset(&op, 0, sizeof(op));
+        op.d = op.n = op.m = op.a = NO_REG;
+        op.wide = 1;
+    }
+
+    bool fail(const std::string& msg)
+    {
+        error = msg;
+        return false;
+    }
+
+    bool expect_args(size_t lo, size_t hi)
+    {
+        if (args.size() < lo || args.size() > hi)
+        {
+            return fail(lo == hi ? format("'%s' takes %d operands", mn.c_str(), (int)lo)
+                                 : format("'%s' takes %d to %d operands", mn.c_str(), (int)lo, (int)hi));
+        }
+        return true;
+    }
+
+    bool is(size_t i, Arg::Kind k) const
+    {
+        return i < args.size() && args[i].kind == k;
+    }
+
+    bool is_x(size_t i) const
+    {
+        return is(i, Arg::XREG) && !args[i].sp;
+    }
+
+    bool same_arrangement(size_t i, size_t j) const
+    {
+        return args[i].esize == args[j].esize && args[i].lanes == args[j].lanes;
+    }
+
+    bool vector_op(AsmFn fn)
+    {
+        if (!fn)
+        {
+            return fail("'" + mn + "' does not take this arrangement");
+        }
+        op.fn = fn;
+        return true;
+    }
+
+    bool build();
+    bool build_branch();
+    bool build_scalar();
+    bool build_load_store();
+    bool build_vector();
+    bool build_target(size_t i);
+};
+
+bool Builder::build_target(size_t i)
+{
+    branch = true;
+    if (is(i, Arg::NAME))
+    {
+        label = args[i].name;
+        return true;
+    }
+    if (is(i, Arg::IMM) && !args[i].is_float && args[i].imm % 4 == 0)
+    {
+        relative = args[i].imm;
+        return true;
+    }
+    return fail("'" + mn + "' needs a label or a #byte offset");
+}
+
+bool Builder::build_branch()
+{
+    if (mn == "b")
+    {
+        op.fn = &h_b;
+        return expect_args(1, 1) && build_target(0);
+    }
+    if (mn == "ret")
+    {
+        if (!expect_args(0, 1))
+        {
+            return false;
+        }
+        op.fn = &h_b;
+        branch = true;
+        label = ".end";
+        return true;
+    }
+    if (mn == "cbz" || mn == "cbnz")
+    {
+        if (!expect_args(2, 2) || !is_x(0))
+        {
+            return fail("'" + mn + "' needs a register and a label");
+        }
+        op.fn = &h_cbz;
+        op.kind = mn == "cbnz";
+        op.d = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        return build_target(1);
+    }
+    if (mn == "tbz" || mn == "tbnz")
+    {
+        if (!expect_args(3, 3) || !is_x(0) || !is(1, Arg::IMM) || args[1].imm < 0 ||
+            args[1].imm >= (args[0].wide ? 64 : 32))
+        {
+            return fail("'" + mn + "' needs a register, a bit number and a label");
+        }
+        op.fn = &h_tbz;
+        op.kind = mn == "tbnz";
+        op.d = (uint8_t)args[0].reg;
+        op.index = (uint8_t)args[1].imm;
+        return build_target(2);
+    }
+    // b.cond and the bcond spelling
+    std::string cond;
+    if (mn.size() > 2 && mn.compare(0, 2, "b.") == 0)
+    {
+        cond = mn.substr(2);
+    }
+    else if (mn.size() == 3 && mn[0] == 'b' && parse_condition(mn.substr(1)) >= 0)
+    {
+        cond = mn.substr(1);
+    }
+    if (cond.empty())
+    {
+        return false;
+    }
+    const int c = parse_condition(cond);
+    if (c < 0)
+    {
+        return fail("unknown condition '" + cond + "'");
+    }
+    op.fn = &h_bcond;
+    op.kind = (uint8_t)c;
+    return expect_args(1, 1) && build_target(0);
+}
+
+bool Builder::build_scalar()
+{
+    // operand 2: #imm or register with an optional shift, at args[i]
+    struct Local
+    {
+        static bool operand2(Builder& b, size_t i, bool allow_shift_imm)
+        {
+            if (b.is(i, Arg::IMM) && !b.args[i].is_float)
+            {
+                b.op.imm = b.args[i].imm;
+                if (b.is(i + 1, Arg::SHIFT))
+                {
+                    if (!allow_shift_imm || b.args[i + 1].shift != SHIFT_LSL ||
+                        (b.args[i + 1].imm != 0 && b.args[i + 1].imm != 12))
+                    {
+                        return b.fail("'" + b.mn + "': immediate shift must be lsl #0 or lsl #12");
+                    }
+                    b.op.imm <<= b.args[i + 1].imm;
+                }
+                return b.args.size() <= i + 2 ? true : b.fail("too many operands");
+            }
+            if (b.is_x(i))
+            {
+                if (b.args[i].wide != (b.op.wide != 0))
+                {
+                    return b.fail("'" + b.mn + "': mixed x and w registers");
+                }
+                b.op.m = (uint8_t)b.args[i].reg;
+                if (b.is(i + 1, Arg::SHIFT))
+                {
+                    if (b.args[i + 1].shift > SHIFT_ROR || b.args[i + 1].imm >= (b.op.wide ? 64 : 32))
+                    {
+                        return b.fail("'" + b.mn + "': bad shift");
+                    }
+                    b.op.index2 = (uint8_t)b.args[i + 1].shift;
+                    b.op.index = (uint8_t)b.args[i + 1].imm;
+                }
+                return b.args.size() <= i + 2 ? true : b.fail("too many operands");
+            }
+            return b.fail("'" + b.mn + "' needs a register or an immediate");
+        }
+    };
+
+    // d, n must be general registers of one width; sets op.d / op.n / op.wide
+    const bool dn = is_x(0) && is_x(1) && args[0].wide == args[1].wide;
+    if (is(0, Arg::XREG) && args[0].sp)
+    {
+        return fail("sp is not supported");
+    }
+    if (is(1, Arg::XREG) && args[1].sp)
+    {
+        return fail("sp is not supported");
+    }
+
+    static const struct
+    {
+        const char* name;
+        int kind;
+        int flags;
+    } addsub[] = {
+        { "add", 0, 0 }, { "adds", 0, 1 }, { "sub", 1, 0 }, { "subs", 1, 1 },
+    };
+    for (size_t k = 0; k < 4; k++)
+    {
+        if (mn == addsub[k].name)
+        {
+            if (!expect_args(3, 4) || !dn)
+            {
+                return fail("'" + mn + "' needs two registers of one width and an operand");
+            }
+            op.fn = &h_addsub;
+            op.kind = (uint8_t)addsub[k].kind;
+            op.mode = (uint8_t)addsub[k].flags;
+            op.d = (uint8_t)args[0].reg;
+            op.n = (uint8_t)args[1].reg;
+            op.wide = args[0].wide;
+            return Local::operand2(*this, 2, true);
+        }
+    }
+    if (mn == "cmp" || mn == "cmn")
+    {
+        if (!expect_args(2, 3) || !is_x(0))
+        {
+            return fail("'" + mn + "' needs a register and an operand");
+        }
+        op.fn = &h_addsub;
+        op.kind = mn == "cmp";
+        op.mode = 1;
+        op.d = 31;
+        op.n = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        return Local::operand2(*this, 1, true);
+    }
+    if (mn == "neg")
+    {
+        if (!expect_args(2, 3) || !is_x(0))
+        {
+            return fail("'neg' needs two registers");
+        }
+        op.fn = &h_addsub;
+        op.kind = 1;
+        op.d = (uint8_t)args[0].reg;
+        op.n = 31;
+        op.wide = args[0].wide;
+        return Local::operand2(*this, 1, false);
+    }
+
+    static const struct
+    {
+        const char* name;
+        int kind;
+        int flags;
+    } logic[] = {
+        { "and", LOGIC_AND, 0 }, { "ands", LOGIC_AND, 1 }, { "orr", LOGIC_ORR, 0 }, { "eor", LOGIC_EOR, 0 },
+        { "bic", LOGIC_BIC, 0 }, { "bics", LOGIC_BIC, 1 }, { "orn", LOGIC_ORN, 0 }, { "eon", LOGIC_EON, 0 },
+    };
+    for (size_t k = 0; k < 8; k++)
+    {
+        if (mn == logic[k].name && is(0, Arg::XREG))
+        {
+            if (!expect_args(3, 4) || !dn)
+            {
+                return fail("'" + mn + "' needs two registers of one width and an operand");
+            }
+            op.fn = &h_logic;
+            op.kind = (uint8_t)logic[k].kind;
+            op.mode = (uint8_t)logic[k].flags;
+            op.d = (uint8_t)args[0].reg;
+            op.n = (uint8_t)args[1].reg;
+            op.wide = args[0].wide;
+            return Local::operand2(*this, 2, false);
+        }
+    }
+    if (mn == "tst")
+    {
+        if (!expect_args(2, 3) || !is_x(0))
+        {
+            return fail("'tst' needs a register and an operand");
+        }
+        op.fn = &h_logic;
+        op.kind = LOGIC_AND;
+        op.mode = 1;
+        op.d = 31;
+        op.n = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        return Local::operand2(*this, 1, false);
+    }
+    if ((mn == "mov" || mn == "mvn") && is(0, Arg::XREG))
+    {
+        if (!expect_args(2, 3) || !is_x(0))
+        {
+            return fail("'" + mn + "' needs a register and an operand");
+        }
+        op.fn = &h_logic;
+        op.kind = mn == "mov" ? LOGIC_ORR : LOGIC_ORN;
+        op.d = (uint8_t)args[0].reg;
+        op.n = 31;
+        op.wide = args[0].wide;
+        return Local::operand2(*this, 1, false);
+    }
+    if (mn == "movz" || mn == "movn" || mn == "movk")
+    {
+        if (!expect_args(2, 3) || !is_x(0) || !is(1, Arg::IMM) || args[1].imm < 0 || args[1].imm > 0xFFFF)
+        {
+            return fail("'" + mn + "' needs a register and a 16-bit immediate");
+        }
+        int sh = 0;
+        if (args.size() == 3)
+        {
+            if (!is(2, Arg::SHIFT) || args[2].shift != SHIFT_LSL || args[2].imm % 16 ||
+                args[2].imm >= (args[0].wide ? 64 : 32))
+            {
+                return fail("'" + mn + "': shift must be lsl #0, #16, #32 or #48");
+            }
+            sh = (int)args[2].imm;
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        if (mn == "movk")
+        {
+            op.fn = &h_movk;
+            op.imm = args[1].imm;
+            op.index = (uint8_t)sh;
+            return true;
+        }
+        op.fn = &h_logic;
+        op.kind = LOGIC_ORR;
+        op.n = 31;
+        op.imm = (int64_t)((uint64_t)args[1].imm << sh);
+        if (mn == "movn")
+        {
+            op.imm = ~op.imm;
+        }
+        return true;
+    }
+    if (mn == "mul" || mn == "madd" || mn == "msub")
+    {
+        const bool mul = mn == "mul";
+        if (!expect_args(mul ? 3 : 4, mul ? 3 : 4) || !dn || !is_x(2) || args[2].wide != args[0].wide ||
+            (!mul && (!is_x(3) || args[3].wide != args[0].wide)))
+        {
+            return fail("'" + mn + "' needs registers of one width");
+        }
+        op.fn = &h_madd;
+        op.kind = mn == "msub";
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        op.a = mul ? 31 : (uint8_t)args[3].reg;
+        op.wide = args[0].wide;
+        return true;
+    }
+    if (mn == "udiv" || mn == "sdiv")
+    {
+        if (!expect_args(3, 3) || !dn || !is_x(2) || args[2].wide != args[0].wide)
+        {
+            return fail("'" + mn + "' needs registers of one width");
+        }
+        op.fn = &h_div;
+        op.kind = mn == "sdiv";
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        op.wide = args[0].wide;
+        return true;
+    }
+    static const char* shift_names[] = { "lsl", "lsr", "asr", "ror" };
+    for (int k = 0; k < 4; k++)
+    {
+        if (mn != shift_names[k])
+        {
+            continue;
+        }
+        if (!expect_args(3, 3) || !dn)
+        {
+            return fail("'" + mn + "' needs two registers of one width and an amount");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        if (is(2, Arg::IMM))
+        {
+            if (args[2].imm < 0 || args[2].imm >= (op.wide ? 64 : 32))
+            {
+                return fail("'" + mn + "': shift amount out of range");
+            }
+            // orr d, zr, n, <shift> #imm
+            op.fn = &h_logic;
+            op.kind = LOGIC_ORR;
+            op.n = 31;
+            op.m = (uint8_t)args[1].reg;
+            op.index2 = (uint8_t)k;
+            op.index = (uint8_t)args[2].imm;
+            return true;
+        }
+        if (!is_x(2))
+        {
+            return fail("'" + mn + "' needs an immediate or a register amount");
+        }
+        op.fn = &h_shiftv;
+        op.kind = (uint8_t)k;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        return true;
+    }
+    return false;
+}
+
+bool Builder::build_load_store()
+{
+    // ld1-ld4 / st1-st4 / ld1r
+    if (mn.size() >= 3 && (mn.compare(0, 2, "ld") == 0 || mn.compare(0, 2, "st") == 0) && mn[2] >= '1' &&
+        mn[2] <= '4' && (mn.size() == 3 || mn == "ld1r"))
+    {
+        const bool load = mn[0] == 'l';
+        const int structure = mn[2] - '0';
+        const bool replicate = mn == "ld1r";
+        if (!expect_args(2, 3) || !is(0, Arg::VLIST) || !is(1, Arg::MEM) || args[1].imm != 0 || args[1].pre ||
+            args[1].offset_reg >= 0)
+        {
+            return fail("'" + mn + "' needs a register list and [xn]");
+        }
+        const Arg& list = args[0];
+        op.d = (uint8_t)list.reg;
+        op.n = (uint8_t)args[1].reg;
+        op.count = (uint8_t)list.count;
+        op.esize = (uint8_t)list.esize;
+        op.lanes = (uint8_t)list.lanes;
+        op.mode = MODE_OFFSET;
+        int bytes;
+        if (list.index >= 0)
+        {
+            if (structure != 1 || list.count != 1)
+            {
+                return fail("'" + mn + "': only single register ld1 / st1 lanes are supported");
+            }
+            op.fn = load ? &h_ld1_lane : &h_st1_lane;
+            op.index = (uint8_t)list.index;
+            bytes = list.esize;
+        }
+        else if (list.lanes == 0)
+        {
+            return fail("'" + mn + "': list needs an arrangement");
+        }
+        else if (replicate)
+        {
+            if (list.count != 1)
+            {
+                return fail("'ld1r' takes one register");
+            }
+            op.fn = &h_ld1r;
+            bytes = list.esize;
+        }
+        else
+        {
+            if (structure > 1 && (list.count != structure || (list.esize == 8 && list.lanes == 1)))
+            {
+                return fail(format("'%s' needs %d registers of a 8b/16b/4h/8h/2s/4s/2d arrangement", mn.c_str(),
+                                   structure));
+            }
+            op.fn = load ? &h_ld_struct : &h_st_struct;
+            op.kind = (uint8_t)structure;
+            bytes = list.count * list.lanes * list.esize;
+        }
+        if (args.size() == 3)
+        {
+            if (is(2, Arg::IMM))
+            {
+                if (args[2].imm != bytes)
+                {
+                    return fail(format("'%s': post-index immediate must be #%d", mn.c_str(), bytes));
+                }
+                op.mode = MODE_POST;
+                op.imm = bytes;
+            }
+            else if (is_x(2) && args[2].wide && args[2].reg != 31)
+            {
+                op.mode = MODE_POST_REG;
+                op.m = (uint8_t)args[2].reg;
+            }
+            else
+            {
+                return fail("'" + mn + "': post-index must be #imm or an x register");
+            }
+        }
+        return true;
+    }
+
+    static const struct
+    {
+        const char* name;
+        bool load;
+        int size; ///< 0: from the register
+        bool pair;
+    } scalar[] = {
+        { "ldr", true, 0, false }, { "str", false, 0, false }, { "ldur", true, 0, false }, { "stur", false, 0, false },
+        { "ldp", true, 0, true }, { "stp", false, 0, true }, { "ldrb", true, 1, false }, { "strb", false, 1, false },
+        { "ldrh", true, 2, false }, { "strh", false, 2, false },
+    };
+    for (size_t k = 0; k < sizeof(scalar) / sizeof(scalar[0]); k++)
+    {
+        if (mn != scalar[k].name)
+        {
+            continue;
+        }
+        const size_t nregs = scalar[k].pair ? 2 : 1;
+        if (!expect_args(nregs + 1, nregs + 2) || !is(nregs, Arg::MEM))
+        {
+            return fail("'" + mn + "' needs register(s) and an address");
+        }
+        const Arg& r0 = args[0];
+        const bool fp = r0.kind == Arg::FREG;
+        if ((!fp && !is_x(0)) || (fp && scalar[k].size))
+        {
+            return fail("'" + mn + "': bad register '" + (fp ? "fp" : "operand") + "'");
+        }
+        if (scalar[k].pair && (args[1].kind != r0.kind || args[1].esize != r0.esize || args[1].wide != r0.wide))
+        {
+            return fail("'" + mn + "' needs two registers of one size");
+        }
+        if (!fp && scalar[k].size && r0.wide)
+        {
+            return fail("'" + mn + "' needs a w register");
+        }
+        op.d = (uint8_t)r0.reg;
+        op.a = scalar[k].pair ? (uint8_t)args[1].reg : NO_REG;
+        op.count = (uint8_t)nregs;
+        op.wide = r0.wide;
+        op.esize = (uint8_t)(fp ? r0.esize : scalar[k].size ? scalar[k].size : (r0.wide ? 8 : 4));
+        op.fn = fp ? (scalar[k].load ? &h_ldr_v : &h_str_v) : (scalar[k].load ? &h_ldr_x : &h_str_x);
+        const Arg& mem = args[nregs];
+        op.n = (uint8_t)mem.reg;
+        op.imm = mem.imm;
+        if (mem.offset_reg >= 0)
+        {
+            if (scalar[k].pair || args.size() > nregs + 1 || (mem.shift != 0 && (1 << mem.shift) != op.esize))
+            {
+                return fail("'" + mn + "': register offset shift must be 0 or the access size");
+            }
+            op.mode = MODE_REG;
+            op.m = (uint8_t)mem.offset_reg;
+            op.index2 = (uint8_t)mem.shift;
+        }
+        else if (args.size() > nregs + 1)
+        {
+            if (!is(nregs + 1, Arg::IMM) || mem.pre || mem.imm != 0)
+            {
+                return fail("'" + mn + "': post-index must be [xn], #imm");
+            }
+            op.mode = MODE_POST;
+            op.imm = args[nregs + 1].imm;
+        }
+        else
+        {
+            op.mode = mem.pre ? MODE_PRE : MODE_OFFSET;
+        }
+        return true;
+    }
+    if (mn == "prfm" || mn == "prfum")
+    {
+        op.fn = &h_nop;
+        return true;
+    }
+    return false;
+}
+
+struct Same3
+{
+    const char* name;
+    Picker same;
+    Picker elem; ///< by element form, NULL if none
+};
+
+static const Same3 kSame3[] = {
+    { "add", &pick_u<Binary, OpAdd>, NULL },
+    { "sub", &pick_u<Binary, OpSub>, NULL },
+    { "mul", &pick_u<Binary, OpMul>, &pick_u<BinaryElem, OpMul> },
+    { "mla", &pick_u<Ternary, OpMla>, &pick_u<TernaryElem, OpMla> },
+    { "mls", &pick_u<Ternary, OpMls>, &pick_u<TernaryElem, OpMls> },
+    { "and", &pick_b<Binary, OpAnd>, NULL },
+    { "orr", &pick_b<Binary, OpOrr>, NULL },
+    { "eor", &pick_b<Binary, OpEor>, NULL },
+    { "bic", &pick_b<Binary, OpBic>, NULL },
+    { "orn", &pick_b<Binary, OpOrn>, NULL },
+    { "bsl", &pick_b<Ternary, OpBsl>, NULL },
+    { "bit", &pick_b<Ternary, OpBit>, NULL },
+    { "bif", &pick_b<Ternary, OpBif>, NULL },
+    { "umax", &pick_u<Binary, OpMax>, NULL },
+    { "umin", &pick_u<Binary, OpMin>, NULL },
+    { "smax", &pick_s<Binary, OpMax>, NULL },
+    { "smin", &pick_s<Binary, OpMin>, NULL },
+    { "uabd", &pick_u<Binary, OpAbd>, NULL },
+    { "sabd", &pick_s<Binary, OpAbd>, NULL },
+    { "cmeq", &pick_u<Binary, OpCmeq>, NULL },
+    { "cmhi", &pick_u<Binary, OpCmgt>, NULL },
+    { "cmhs", &pick_u<Binary, OpCmge>, NULL },
+    { "cmgt", &pick_s<Binary, OpCmgt>, NULL },
+    { "cmge", &pick_s<Binary, OpCmge>, NULL },
+    { "cmtst", &pick_u<Binary, OpCmtst>, NULL },
+    { "uqadd", &pick_u<Binary, OpQAdd>, NULL },
+    { "sqadd", &pick_s<Binary, OpQAdd>, NULL },
+    { "uqsub", &pick_u<Binary, OpQSub>, NULL },
+    { "sqsub", &pick_s<Binary, OpQSub>, NULL },
+    { "addp", &pick_u<Pairwise, OpAdd>, NULL },
+    { "fadd", &pick_f<Binary, OpFAdd>, NULL },
+    { "fsub", &pick_f<Binary, OpFSub>, NULL },
+    { "fmul", &pick_f<Binary, OpFMul>, &pick_f<BinaryElem, OpFMul> },
+    { "fdiv", &pick_f<Binary, OpFDiv>, NULL },
+    { "fmax", &pick_f<Binary, OpFMax>, NULL },
+    { "fmin", &pick_f<Binary, OpFMin>, NULL },
+    { "fabd", &pick_f<Binary, OpFAbd>, NULL },
+    { "fmla", &pick_f<Ternary, OpFmla>, &pick_f<TernaryElem, OpFmla> },
+    { "fmls", &pick_f<Ternary, OpFmls>, &pick_f<TernaryElem, OpFmls> },
+    { "faddp", &pick_f<Pairwise, OpFAdd>, NULL },
+    { "fcmeq", &pick_f<Binary, OpFCmeq>, NULL },
+    { "fcmge", &pick_f<Binary, OpFCmge>, NULL },
+    { "fcmgt", &pick_f<Binary, OpFCmgt>, NULL },
+};
+
+struct Same2
+{
+    const char* name;
+    Picker pick;
+};
+
+static const Same2 kUnary[] = {
+    { "not", &pick_b<Unary, OpNot> },
+    { "mvn", &pick_b<Unary, OpNot> },
+    { "neg", &pick_s<Unary, OpNeg> },
+    { "abs", &pick_s<Unary, OpAbs> },
+    { "fneg", &pick_f<Unary, OpFNeg> },
+    { "fabs", &pick_f<Unary, OpFAbs> },
+    { "fsqrt", &pick_f<Unary, OpFSqrt> },
+    { "scvtf", &pick_scvtf },
+    { "ucvtf", &pick_ucvtf },
+    { "fcvtzs", &pick_fcvtzs },
+    { "fcvtzu", &pick_fcvtzu },
+};
+
+static const Same2 kShift[] = {
+    { "shl", &pick_u<ShiftImm, OpShl> },
+    { "ushr", &pick_u<ShiftImm, OpShr> },
+    { "sshr", &pick_s<ShiftImm, OpShr> },
+    { "urshr", &pick_u<ShiftImm, OpRshr> },
+    { "srshr", &pick_s<ShiftImm, OpRshr> },
+    { "usra", &pick_u<ShiftImm, OpSra> },
+    { "ssra", &pick_s<ShiftImm, OpSra> },
+};
+
+static const Same2 kReduce[] = {
+    { "addv", &pick_u<Reduce, OpAdd> },
+    { "umaxv", &pick_u<Reduce, OpMax> },
+    { "uminv", &pick_u<Reduce, OpMin> },
+    { "smaxv", &pick_s<Reduce, OpMax> },
+    { "sminv", &pick_s<Reduce, OpMin> },
+    { "fmaxv", &pick_f<Reduce, OpFMax> },
+    { "fminv", &pick_f<Reduce, OpFMin> },
+    { "faddp", &pick_f<Reduce, OpFAdd> },
+};
+
+struct WidenInfo
+{
+    const char* name;
+    SignedPicker pick;
+    SignedPicker elem; ///< by element form, NULL if none
+    bool is_signed;
+    bool wide_n;
+};
+
+static const WidenInfo kWiden[] = {
+    { "umull", &pick_widen<WMul, false>, &pick_widen_elem<WMul>, false, false },
+    { "smull", &pick_widen<WMul, false>, &pick_widen_elem<WMul>, true, false },
+    { "umlal", &pick_widen<WMla, false>, &pick_widen_elem<WMla>, false, false },
+    { "smlal", &pick_widen<WMla, false>, &pick_widen_elem<WMla>, true, false },
+    { "umlsl", &pick_widen<WMls, false>, &pick_widen_elem<WMls>, false, false },
+    { "smlsl", &pick_widen<WMls, false>, &pick_widen_elem<WMls>, true, false },
+    { "uaddl", &pick_widen<WAdd, false>, NULL, false, false },
+    { "saddl", &pick_widen<WAdd, false>, NULL, true, false },
+    { "usubl", &pick_widen<WSub, false>, NULL, false, false },
+    { "ssubl", &pick_widen<WSub, false>, NULL, true, false },
+    { "uaddw", &pick_widen<WAdd, true>, NULL, false, true },
+    { "saddw", &pick_widen<WAdd, true>, NULL, true, true },
+    { "usubw", &pick_widen<WSub, true>, NULL, false, true },
+    { "ssubw", &pick_widen<WSub, true>, NULL, true, true },
+};
+
+struct NarrowInfo
+{
+    const char* name;
+    SignedPicker pick;
+    bool is_signed;
+    bool shift;
+};
+
+static const NarrowInfo kNarrow[] = {
+    { "xtn", &pick_narrow<NXtn>, false, false },
+    { "sqxtn", &pick_narrow<NSat>, true, false },
+    { "uqxtn", &pick_narrow<NSat>, false, false },
+    { "shrn", &pick_narrow<NShrn>, false, true },
+    { "rshrn", &pick_narrow<NRshrn>, false, true },
+};
+
+// 64-bit pattern of `lane` repeated over esize-byte elements
+static uint64_t replicate(uint64_t lane, int esize)
+{
+    if (esize == 8)
+    {
+        return lane;
+    }
+    const int bits = esize * 8;
+    lane &= (1ull << bits) - 1;
+    uint64_t r = 0;
+    for (int i = 0; i < 64; i += bits)
+    {
+        r |= lane << i;
+    }
+    return r;
+}
+
+bool Builder::build_vector()
+{
+    const size_t n = args.size();
+
+    // "2" forms of widen / narrow / shll
+    std::string base = mn;
+    int part = 0;
+    if (mn.size() > 1 && mn[mn.size() - 1] == '2' && mn != "zip2" && mn != "uzp2" && mn != "trn2")
+    {
+        base = mn.substr(0, mn.size() - 1);
+        part = 1;
+    }
+
+    for (size_t k = 0; k < sizeof(kWiden) / sizeof(kWiden[0]); k++)
+    {
+        const WidenInfo& w = kWiden[k];
+        if (base != w.name)
+        {
+            continue;
+        }
+        const bool by_elem = is(2, Arg::VELEM) && w.elem && args[2].index >= 0;
+        if (!expect_args(3, 3) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !(is(2, Arg::VREG) || by_elem))
+        {
+            return fail("'" + mn + "' needs three vector registers");
+        }
+        const Arg& d = args[0];
+        const Arg& m = args[2];
+        const int src = d.esize / 2;
+        if (by_elem)
+        {
+            const Arg& n = args[1];
+            if (d.lanes * d.esize != 16 || n.esize != src || n.lanes * src != (part ? 16 : 8) || m.esize != src ||
+                (src == 2 && m.reg >= 16))
+            {
+                return fail("'" + mn + "': arrangements do not match");
+            }
+            op.d = (uint8_t)d.reg;
+            op.n = (uint8_t)n.reg;
+            op.m = (uint8_t)m.reg;
+            op.esize = (uint8_t)d.esize;
+            op.lanes = (uint8_t)d.lanes;
+            op.index = (uint8_t)part;
+            op.index2 = (uint8_t)m.index;
+            return vector_op(w.elem(src, w.is_signed));
+        }
+        const bool narrow_ok = m.esize == src && m.lanes * src == (part ? 16 : 8);
+        const bool n_ok = w.wide_n ? same_arrangement(0, 1) : (args[1].esize == m.esize && args[1].lanes == m.lanes);
+        if (d.lanes * d.esize != 16 || !narrow_ok || !n_ok)
+        {
+            return fail("'" + mn + "': arrangements do not match");
+        }
+        op.d = (uint8_t)d.reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)m.reg;
+        op.esize = (uint8_t)d.esize;
+        op.lanes = (uint8_t)d.lanes;
+        op.index = (uint8_t)part;
+        return vector_op(w.pick(src, w.is_signed));
+    }
+
+    for (size_t k = 0; k < sizeof(kNarrow) / sizeof(kNarrow[0]); k++)
+    {
+        const NarrowInfo& w = kNarrow[k];
+        if (base != w.name)
+        {
+            continue;
+        }
+        if (!expect_args(w.shift ? 3 : 2, w.shift ? 3 : 2) || !is(0, Arg::VREG) || !is(1, Arg::VREG))
+        {
+            return fail("'" + mn + "' needs two vector registers" + (w.shift ? " and a shift" : ""));
+        }
+        const Arg& d = args[0];
+        const Arg& s = args[1];
+        if (s.esize != 2 * d.esize || s.lanes * s.esize != 16 || d.lanes * d.esize != (part ? 16 : 8))
+        {
+            return fail("'" + mn + "': arrangements do not match");
+        }
+        if (w.shift && (!is(2, Arg::IMM) || args[2].imm < 1 || args[2].imm > d.esize * 8))
+        {
+            return fail(format("'%s': shift must be #1..#%d", mn.c_str(), d.esize * 8));
+        }
+        op.d = (uint8_t)d.reg;
+        op.n = (uint8_t)s.reg;
+        op.esize = (uint8_t)d.esize;
+        op.lanes = (uint8_t)d.lanes;
+        op.index = (uint8_t)part;
+        op.imm = w.shift ? args[2].imm : 0;
+        return vector_op(w.pick(d.esize, w.is_signed));
+    }
+
+    if (base == "ushll" || base == "sshll" || base == "uxtl" || base == "sxtl")
+    {
+        const bool shift = base[1] == 's';
+        if (!expect_args(shift ? 3 : 2, shift ? 3 : 2) || !is(0, Arg::VREG) || !is(1, Arg::VREG))
+        {
+            return fail("'" + mn + "' needs two vector registers");
+        }
+        const Arg& d = args[0];
+        const Arg& s = args[1];
+        if (d.esize != 2 * s.esize || d.lanes * d.esize != 16 || s.lanes * s.esize != (part ? 16 : 8))
+        {
+            return fail("'" + mn + "': arrangements do not match");
+        }
+        if (shift && (!is(2, Arg::IMM) || args[2].imm < 0 || args[2].imm >= s.esize * 8))
+        {
+            return fail(format("'%s': shift must be #0..#%d", mn.c_str(), s.esize * 8 - 1));
+        }
+        op.d = (uint8_t)d.reg;
+        op.n = (uint8_t)s.reg;
+        op.esize = (uint8_t)d.esize;
+        op.lanes = (uint8_t)d.lanes;
+        op.index = (uint8_t)part;
+        op.imm = shift ? args[2].imm : 0;
+        return vector_op(pick_widen_shift(s.esize, base[0] == 's'));
+    }
+    if (part)
+    {
+        return false;
+    }
+
+    // dup, ins, umov, mov, movi, mvni
+    if (mn == "dup")
+    {
+        if (!expect_args(2, 2) || !is(0, Arg::VREG))
+        {
+            return fail("'dup' needs a vector register and an element or general register");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        if (is(1, Arg::VELEM) && args[1].index >= 0 && args[1].esize == args[0].esize)
+        {
+            op.fn = &h_dup_elem;
+            op.n = (uint8_t)args[1].reg;
+            op.index = (uint8_t)args[1].index;
+            return true;
+        }
+        if (is_x(1))
+        {
+            op.fn = &h_dup_gen;
+            op.n = (uint8_t)args[1].reg;
+            return true;
+        }
+        return fail("'dup': bad source operand");
+    }
+    if ((mn == "ins" || mn == "mov") && is(0, Arg::VELEM))
+    {
+        if (!expect_args(2, 2) || args[0].index < 0)
+        {
+            return fail("'" + mn + "' needs an element and a source");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.index = (uint8_t)args[0].index;
+        if (is(1, Arg::VELEM) && args[1].index >= 0 && args[1].esize == args[0].esize)
+        {
+            op.fn = &h_ins_elem;
+            op.n = (uint8_t)args[1].reg;
+            op.index2 = (uint8_t)args[1].index;
+            return true;
+        }
+        if (is_x(1))
+        {
+            op.fn = &h_ins_gen;
+            op.n = (uint8_t)args[1].reg;
+            return true;
+        }
+        return fail("'" + mn + "': bad source operand");
+    }
+    if ((mn == "umov" || mn == "mov") && is(0, Arg::XREG) && is(1, Arg::VELEM))
+    {
+        if (!expect_args(2, 2) || !is_x(0) || args[1].index < 0 || (args[0].wide != (args[1].esize == 8)) ||
+            (mn == "mov" && args[1].esize < 4))
+        {
+            return fail("'" + mn + "': bad operands");
+        }
+        op.fn = &h_umov;
+        op.d = (uint8_t)args[0].reg;
+        op.wide = args[0].wide;
+        op.n = (uint8_t)args[1].reg;
+        op.esize = (uint8_t)args[1].esize;
+        op.index = (uint8_t)args[1].index;
+        return true;
+    }
+    if (mn == "mov" && is(0, Arg::VREG))
+    {
+        if (!expect_args(2, 2) || !is(1, Arg::VREG) || !same_arrangement(0, 1))
+        {
+            return fail("'mov' needs two vector registers of one arrangement");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.n = op.m = (uint8_t)args[1].reg;
+        op.esize = 1;
+        op.lanes = (uint8_t)(args[0].lanes * args[0].esize);
+        op.fn = &Binary<uint8_t, OpOrr<uint8_t> >::run;
+        return true;
+    }
+    if (mn == "movi" || mn == "mvni")
+    {
+        if (!expect_args(2, 3) || !(is(0, Arg::VREG) || (is(0, Arg::FREG) && args[0].esize == 8)) || !is(1, Arg::IMM) ||
+            args[1].is_float)
+        {
+            return fail("'" + mn + "' needs a vector register and an immediate");
+        }
+        const Arg& d = args[0];
+        op.fn = &h_movi;
+        op.d = (uint8_t)d.reg;
+        op.esize = (uint8_t)d.esize;
+        op.lanes = (uint8_t)(d.kind == Arg::FREG ? 1 : d.lanes);
+        const uint64_t imm = (uint64_t)args[1].imm;
+        if (d.esize == 8)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                const uint64_t byte = (imm >> (8 * i)) & 0xFF;
+                if (byte != 0 && byte != 0xFF)
+                {
+                    return fail("'" + mn + "': 64-bit immediate bytes must be 0x00 or 0xff");
+                }
+            }
+            op.imm = (int64_t)imm;
+            return mn == "movi" && n == 2 ? true : fail("'" + mn + "': bad 64-bit form");
+        }
+        if (imm > 0xFF)
+        {
+            return fail("'" + mn + "': immediate must be 8 bits");
+        }
+        uint64_t value = imm;
+        if (n == 3)
+        {
+            if (!is(2, Arg::SHIFT) || d.esize == 1 || (args[2].shift != SHIFT_LSL && args[2].shift != 4) ||
+                args[2].imm % 8 || args[2].imm >= d.esize * 8 ||
+                (args[2].shift == 4 && (d.esize != 4 || (args[2].imm != 8 && args[2].imm != 16))))
+            {
+                return fail("'" + mn + "': bad shift");
+            }
+            value <<= args[2].imm;
+            if (args[2].shift == 4)
+            {
+                value |= (1ull << args[2].imm) - 1; // msl shifts ones in
+            }
+        }
+        if (mn == "mvni" && d.esize == 1)
+        {
+            return fail("'mvni' does not take 8b / 16b");
+        }
+        op.imm = (int64_t)replicate(mn == "mvni" ? ~value : value, d.esize);
+        return true;
+    }
+
+    // reductions: addv s0, v1.4s
+    for (size_t k = 0; k < sizeof(kReduce) / sizeof(kReduce[0]); k++)
+    {
+        if (mn != kReduce[k].name || !is(0, Arg::FREG))
+        {
+            continue;
+        }
+        if (!expect_args(2, 2) || !is(1, Arg::VREG) || args[0].esize != args[1].esize)
+        {
+            return fail("'" + mn + "' needs a scalar register and a vector of its element size");
+        }
+        if (mn == "faddp" && args[1].lanes != 2)
+        {
+            return fail("scalar 'faddp' takes a 2s / 2d vector");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.esize = (uint8_t)args[1].esize;
+        op.lanes = (uint8_t)args[1].lanes;
+        return vector_op(kReduce[k].pick(args[1].esize));
+    }
+
+    for (size_t k = 0; k < sizeof(kUnary) / sizeof(kUnary[0]); k++)
+    {
+        if (mn != kUnary[k].name)
+        {
+            continue;
+        }
+        if (!expect_args(2, 2) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !same_arrangement(0, 1))
+        {
+            return fail("'" + mn + "' needs two vector registers of one arrangement");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        return vector_op(kUnary[k].pick(args[0].esize));
+    }
+
+    if (mn == "rev16" || mn == "rev32" || mn == "rev64")
+    {
+        if (!expect_args(2, 2) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !same_arrangement(0, 1))
+        {
+            return fail("'" + mn + "' needs two vector registers of one arrangement");
+        }
+        op.count = mn == "rev16" ? 2 : mn == "rev32" ? 4 : 8;
+        if (args[0].esize >= op.count)
+        {
+            return fail("'" + mn + "': element size must be below the container size");
+        }
+        op.fn = &h_rev;
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        return true;
+    }
+
+    for (size_t k = 0; k < sizeof(kShift) / sizeof(kShift[0]); k++)
+    {
+        if (mn != kShift[k].name)
+        {
+            continue;
+        }
+        if (!expect_args(3, 3) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !same_arrangement(0, 1) ||
+            !is(2, Arg::IMM))
+        {
+            return fail("'" + mn + "' needs two vector registers and a shift");
+        }
+        const int bits = args[0].esize * 8;
+        const bool left = mn == "shl";
+        if (left ? (args[2].imm < 0 || args[2].imm >= bits) : (args[2].imm < 1 || args[2].imm > bits))
+        {
+            return fail(format("'%s': shift must be #%d..#%d", mn.c_str(), left ? 0 : 1, left ? bits - 1 : bits));
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        op.imm = args[2].imm;
+        return vector_op(kShift[k].pick(args[0].esize));
+    }
+
+    static const char* permutes[] = { "zip1", "zip2", "uzp1", "uzp2", "trn1", "trn2" };
+    for (int k = 0; k < 6; k++)
+    {
+        if (mn != permutes[k])
+        {
+            continue;
+        }
+        if (!expect_args(3, 3) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !is(2, Arg::VREG) ||
+            !same_arrangement(0, 1) || !same_arrangement(0, 2) || args[0].lanes < 2)
+        {
+            return fail("'" + mn + "' needs three vector registers of one arrangement");
+        }
+        op.fn = &h_permute;
+        op.kind = (uint8_t)k;
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        return true;
+    }
+    if (mn == "ext")
+    {
+        if (!expect_args(4, 4) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !is(2, Arg::VREG) ||
+            !same_arrangement(0, 1) || !same_arrangement(0, 2) || args[0].esize != 1 || !is(3, Arg::IMM) ||
+            args[3].imm < 0 || args[3].imm >= args[0].lanes)
+        {
+            return fail("'ext' needs three 8b / 16b registers and a byte index");
+        }
+        op.fn = &h_ext;
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        op.esize = 1;
+        op.lanes = (uint8_t)args[0].lanes;
+        op.imm = args[3].imm;
+        return true;
+    }
+    if (mn == "tbl" || mn == "tbx")
+    {
+        if (!expect_args(3, 3) || !is(0, Arg::VREG) || !is(1, Arg::VLIST) || !is(2, Arg::VREG) ||
+            args[0].esize != 1 || !same_arrangement(0, 2) || args[1].esize != 1 || args[1].lanes != 16)
+        {
+            return fail("'" + mn + "' needs an 8b / 16b register, a 16b table list and an index register");
+        }
+        op.fn = &h_tbl;
+        op.kind = mn == "tbx";
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.count = (uint8_t)args[1].count;
+        op.m = (uint8_t)args[2].reg;
+        op.esize = 1;
+        op.lanes = (uint8_t)args[0].lanes;
+        return true;
+    }
+
+    for (size_t k = 0; k < sizeof(kSame3) / sizeof(kSame3[0]); k++)
+    {
+        const Same3& e = kSame3[k];
+        if (mn != e.name)
+        {
+            continue;
+        }
+        if (!expect_args(3, 3) || !is(0, Arg::VREG) || !is(1, Arg::VREG) || !same_arrangement(0, 1))
+        {
+            return fail("'" + mn + "' needs vector registers of one arrangement");
+        }
+        op.d = (uint8_t)args[0].reg;
+        op.n = (uint8_t)args[1].reg;
+        op.m = (uint8_t)args[2].reg;
+        op.esize = (uint8_t)args[0].esize;
+        op.lanes = (uint8_t)args[0].lanes;
+        if (is(2, Arg::VREG) && same_arrangement(0, 2))
+        {
+            return vector_op(e.same(args[0].esize));
+        }
+        if (is(2, Arg::VELEM) && e.elem && args[2].index >= 0 && args[2].esize == args[0].esize &&
+            (args[2].esize != 2 || args[2].reg < 16))
+        {
+            op.index = (uint8_t)args[2].index;
+            return vector_op(e.elem(args[0].esize));
+        }
+        return fail("'" + mn + "': bad third operand");
+    }
+    return false;
+}
+
+bool Builder::build()
+{
+    if (mn == "nop")
+    {
+        op.fn = &h_nop;
+        return expect_args(0, 0);
+    }
+    const bool vector_form = is(0, Arg::VREG) || is(0, Arg::VELEM) ||
+                             (is(0, Arg::FREG) && mn != "ldr" && mn != "str" && mn != "ldp" && mn != "stp" &&
+                              mn != "ldur" && mn != "stur") ||
+                             (is(1, Arg::VELEM) && is(0, Arg::XREG));
+    if (!vector_form)
+    {
+        if (build_branch() || !error.empty())
+        {
+            return error.empty();
+        }
+        if (build_load_store() || !error.empty())
+        {
+            return error.empty();
+        }
+        if (build_scalar() || !error.empty())
+        {
+            return error.empty();
+        }
+    }
+    if (build_vector() || !error.empty())
+    {
+        return error.empty();
+    }
+    return fail("unsupported instruction '" + mn + "'");
+}
+
+} // namespace neon_sim_asm_detail
+
+//----------------------------------------------------------------------
+// 8. AsmProgram
+//----------------------------------------------------------------------
+
+bool AsmProgram::assemble(const std::string& text)
+{
+    return assemble(text, NULL);
+}
+
+bool AsmProgram::assemble(const std::string& text, const uint32_t* words)
+{
+    using namespace neon_sim_asm_detail;
+
+    struct LabelDef
+    {
+        std::string name;
+        size_t pos; ///< index of the next micro-op
+    };
+    struct Fixup
+    {
+        size_t op;
+        std::string name;
+        size_t defs_before; ///< label definitions seen before the reference
+        int64_t relative;
+    };
+
+    ops_.clear();
+    error_.clear();
+    ok_ = false;
+    std::vector<LabelDef> defs;
+    std::vector<Fixup> fixups;
+    int line = 1;
+
+    // location of a message: source line, or word index for decode()
+    struct Where
+    {
+        static std::string at(const uint32_t* words, int line)
+        {
+            return words ? format("word %d (0x%08x)", line - 1, words[line - 1]) : format("line %d", line);
+        }
+    };
+
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find_first_of("\n;", start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        std::string stmt = text.substr(start, end - start);
+        const size_t comment = stmt.find("//");
+        if (comment != std::string::npos)
+        {
+            stmt = stmt.substr(0, comment);
+        }
+        stmt = trim(stmt);
+
+        // labels: `name:` / `1:`, several may precede one instruction
+        for (;;)
+        {
+            size_t i = 0;
+            while (i < stmt.size() && (isalnum((unsigned char)stmt[i]) || stmt[i] == '_' || stmt[i] == '.' || stmt[i] == '$'))
+            {
+                i++;
+            }
+            if (i == 0 || i >= stmt.size() || stmt[i] != ':')
+            {
+                break;
+            }
+            LabelDef def;
+            def.name = lower(stmt.substr(0, i));
+            def.pos = ops_.size();
+            const bool numeric = isdigit((unsigned char)def.name[0]) != 0;
+            for (size_t k = 0; k < defs.size() && !numeric; k++)
+            {
+                if (defs[k].name == def.name)
+                {
+                    error_ = Where::at(words, line) + ": label '" + def.name + "' defined twice";
+                    return false;
+                }
+            }
+            defs.push_back(def);
+            stmt = trim(stmt.substr(i + 1));
+        }
+
+        if (!stmt.empty())
+        {
+            size_t sp = 0;
+            while (sp < stmt.size() && !isspace((unsigned char)stmt[sp]))
+            {
+                sp++;
+            }
+            Builder b;
+            b.mn = lower(stmt.substr(0, sp));
+            const std::vector<std::string> parts = split_operands(trim(stmt.substr(sp)));
+            for (size_t i = 0; i < parts.size() && b.error.empty(); i++)
+            {
+                Arg a;
+                if (parse_arg(parts[i], a, b.error))
+                {
+                    b.args.push_back(a);
+                }
+            }
+            if (!b.error.empty() || !b.build())
+            {
+                error_ = Where::at(words, line) + ": " + b.error + " in '" + stmt + "'";
+                return false;
+            }
+            b.op.line = line;
+            if (b.branch)
+            {
+                Fixup f;
+                f.op = ops_.size();
+                f.name = b.label;
+                f.defs_before = defs.size();
+                f.relative = b.relative;
+                fixups.push_back(f);
+            }
+            ops_.push_back(b.op);
+        }
+        if (end < text.size() && text[end] == '\n')
+        {
+            line++;
+        }
+        start = end + 1;
+    }
+
+    for (size_t i = 0; i < fixups.size(); i++)
+    {
+        const Fixup& f = fixups[i];
+        AsmOp& op = ops_[f.op];
+        int64_t target = -1;
+        if (f.name.empty())
+        {
+            target = (int64_t)f.op + f.relative / 4;
+        }
+        else if (f.name == ".end")
+        {
+            target = (int64_t)ops_.size();
+        }
+        else if (isdigit((unsigned char)f.name[0]))
+        {
+            // 1b: the last `1:` before the reference, 1f: the first one after it
+            const std::string num = f.name.substr(0, f.name.size() - 1);
+            if (f.name[f.name.size() - 1] == 'b')
+            {
+                for (size_t k = f.defs_before; k-- > 0;)
+                {
+                    if (defs[k].name == num)
+                    {
+                        target = (int64_t)defs[k].pos;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                for (size_t k = f.defs_before; k < defs.size(); k++)
+                {
+                    if (defs[k].name == num)
+                    {
+                        target = (int64_t)defs[k].pos;
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (size_t k = 0; k < defs.size(); k++)
+            {
+                if (defs[k].name == f.name)
+                {
+                    target = (int64_t)defs[k].pos;
+                }
+            }
+        }
+        if (target < 0 || target > (int64_t)ops_.size())
+        {
+            error_ = Where::at(words, op.line) + ": " +
+                     (f.name.empty() ? format("branch offset %lld leaves the block", (long long)f.relative)
+                                     : "undefined label '" + f.name + "'");
+            ops_.clear();
+            return false;
+        }
+        op.target = (uint32_t)target;
+    }
+    ok_ = true;
+    return true;
+}
+
+bool AsmProgram::decode(const uint32_t* words, size_t count)
+{
+    std::string text;
+    for (size_t i = 0; i < count; i++)
+    {
+        const std::string line = asm_disassemble(words[i]);
+        if (line.empty())
+        {
+            ops_.clear();
+            ok_ = false;
+            error_ = neon_sim_asm_detail::format("word %d (0x%08x): unsupported instruction", (int)i, words[i]);
+            return false;
+        }
+        text += line;
+        text += '\n';
+    }
+    return assemble(text, words);
+}
+
+void AsmProgram::run(AsmState& s) const
+{
+    if (!ok_)
+    {
+        fprintf(stderr, "%s: program did not assemble: %s\n", __FUNCTION__, error_.c_str());
+        abort();
+    }
+    const neon_sim_asm_detail::AsmOp* ops = ops_.data();
+    const size_t n = ops_.size();
+    size_t pc = 0;
+    while (pc < n)
+    {
+        const neon_sim_asm_detail::AsmOp& op = ops[pc];
+        pc = op.fn(op, s) ? op.target : pc + 1;
+    }
+}
+
+//----------------------------------------------------------------------
+// 9. disassembler
+//----------------------------------------------------------------------
+
+namespace neon_sim_asm_detail {
+
+static inline uint32_t field(uint32_t w, int hi, int lo)
+{
+    return (w >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+static inline int64_t sfield(uint32_t w, int hi, int lo)
+{
+    const int bits = hi - lo + 1;
+    const int64_t v = field(w, hi, lo);
+    return (v ^ (1ll << (bits - 1))) - (1ll << (bits - 1));
+}
+
+// size 0..3, q 0/1 -> 8b 16b 4h 8h 2s 4s 1d 2d
+static const char* arrangement(int size, int q)
+{
+    static const char* names[4][2] = { { "8b", "16b" }, { "4h", "8h" }, { "2s", "4s" }, { "1d", "2d" } };
+    return names[size & 3][q & 1];
+}
+
+static std::string vreg(int r, int size, int q)
+{
+    return format("v%d.%s", r, arrangement(size, q));
+}
+
+static std::string xreg(int r, bool wide, bool sp = false)
+{
+    if (r == 31)
+    {
+        return sp ? (wide ? "sp" : "wsp") : (wide ? "xzr" : "wzr");
+    }
+    return format("%c%d", wide ? 'x' : 'w', r);
+}
+
+static const char kElem[] = "bhsdq";
+
+static std::string dis_load_store_vector(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int load = field(w, 22, 22);
+    const int post = field(w, 23, 23);
+    const int rm = field(w, 20, 16);
+    const int rn = field(w, 9, 5);
+    const int rt = field(w, 4, 0);
+    const int size = field(w, 11, 10);
+    std::string list;
+    std::string name;
+    int bytes;
+    if (field(w, 24, 24) == 0)
+    {
+        // multiple structures
+        if (!post && rm != 0)
+        {
+            return "";
+        }
+        int regs;
+        int structure;
+        switch (field(w, 15, 12))
+        {
+        case 0x0: regs = 4; structure = 4; break;
+        case 0x2: regs = 4; structure = 1; break;
+        case 0x4: regs = 3; structure = 3; break;
+        case 0x6: regs = 3; structure = 1; break;
+        case 0x7: regs = 1; structure = 1; break;
+        case 0x8: regs = 2; structure = 2; break;
+        case 0xa: regs = 2; structure = 1; break;
+        default: return "";
+        }
+        if (size == 3 && !q && structure > 1)
+        {
+            return "";
+        }
+        name = format("%s%d", load ? "ld" : "st", structure);
+        list = "{";
+        for (int i = 0; i < regs; i++)
+        {
+            list += (i ? ", " : "") + vreg((rt + i) & 31, size, q);
+        }
+        list += "}";
+        bytes = regs * (q ? 16 : 8);
+    }
+    else
+    {
+        // single structure: ld1r and single register lanes
+        if (field(w, 21, 21) || (!post && rm != 0))
+        {
+            return "";
+        }
+        const int opcode = field(w, 15, 13);
+        const int s = field(w, 12, 12);
+        if (opcode == 6 && load && !s)
+        {
+            name = "ld1r";
+            list = "{" + vreg(rt, size, q) + "}";
+            bytes = 1 << size;
+        }
+        else
+        {
+            int esize;
+            int index;
+            if (opcode == 0)
+            {
+                esize = 0;
+                index = (q << 3) | (s << 2) | size;
+            }
+            else if (opcode == 2 && (size & 1) == 0)
+            {
+                esize = 1;
+                index = (q << 2) | (s << 1) | (size >> 1);
+            }
+            else if (opcode == 4 && size == 0)
+            {
+                esize = 2;
+                index = (q << 1) | s;
+            }
+            else if (opcode == 4 && size == 1 && !s)
+            {
+                esize = 3;
+                index = q;
+            }
+            else
+            {
+                return "";
+            }
+            name = load ? "ld1" : "st1";
+            list = format("{v%d.%c}[%d]", rt, kElem[esize], index);
+            bytes = 1 << esize;
+        }
+    }
+    std::string r = name + " " + list + ", [" + xreg(rn, true, true) + "]";
+    if (post)
+    {
+        r += rm == 31 ? format(", #%d", bytes) : ", " + xreg(rm, true);
+    }
+    return r;
+}
+
+// ldr / str / ldur / stur / ldrb / ldrh / strb / strh
+static std::string dis_load_store_reg(uint32_t w)
+{
+    const int size = field(w, 31, 30);
+    const int v = field(w, 26, 26);
+    const int opc = field(w, 23, 22);
+    const int rn = field(w, 9, 5);
+    const int rt = field(w, 4, 0);
+    std::string reg;
+    int bytes;
+    std::string name;
+    if (v)
+    {
+        if (opc >> 1)
+        {
+            if (size != 0)
+            {
+                return "";
+            }
+            bytes = 16;
+        }
+        else
+        {
+            bytes = 1 << size;
+        }
+        reg = format("%c%d", kElem[bytes == 16 ? 4 : size], rt);
+        name = (opc & 1) ? "ldr" : "str";
+    }
+    else
+    {
+        if (opc > 1)
+        {
+            return "";
+        }
+        bytes = 1 << size;
+        reg = xreg(rt, size == 3);
+        name = opc ? "ldr" : "str";
+        if (size == 0)
+        {
+            name += "b";
+        }
+        else if (size == 1)
+        {
+            name += "h";
+        }
+    }
+    const std::string base = xreg(rn, true, true);
+    if (field(w, 24, 24))
+    {
+        const int64_t off = (int64_t)field(w, 21, 10) * bytes;
+        return off ? format("%s %s, [%s, #%lld]", name.c_str(), reg.c_str(), base.c_str(), (long long)off)
+                   : format("%s %s, [%s]", name.c_str(), reg.c_str(), base.c_str());
+    }
+    if (field(w, 21, 21))
+    {
+        // register offset, lsl / uxtx only
+        if (field(w, 11, 10) != 2 || field(w, 15, 13) != 3)
+        {
+            return "";
+        }
+        const int shift = field(w, 12, 12) ? (bytes == 16 ? 4 : size) : 0;
+        const std::string rm = xreg(field(w, 20, 16), true);
+        return shift ? format("%s %s, [%s, %s, lsl #%d]", name.c_str(), reg.c_str(), base.c_str(), rm.c_str(), shift)
+                     : format("%s %s, [%s, %s]", name.c_str(), reg.c_str(), base.c_str(), rm.c_str());
+    }
+    const long long imm = (long long)sfield(w, 20, 12);
+    switch (field(w, 11, 10))
+    {
+    case 0:
+        if (name.size() > 3)
+        {
+            return "";
+        }
+        return format("%s %s, [%s, #%lld]", (name[0] == 'l' ? "ldur" : "stur"), reg.c_str(), base.c_str(), imm);
+    case 1:
+        return format("%s %s, [%s], #%lld", name.c_str(), reg.c_str(), base.c_str(), imm);
+    case 3:
+        return format("%s %s, [%s, #%lld]!", name.c_str(), reg.c_str(), base.c_str(), imm);
+    }
+    return "";
+}
+
+static std::string dis_load_store_pair(uint32_t w)
+{
+    const int opc = field(w, 31, 30);
+    const int v = field(w, 26, 26);
+    const int mode = field(w, 25, 23);
+    const int load = field(w, 22, 22);
+    const int rt2 = field(w, 14, 10);
+    const int rn = field(w, 9, 5);
+    const int rt = field(w, 4, 0);
+    int bytes;
+    std::string r1;
+    std::string r2;
+    if (v)
+    {
+        if (opc == 3)
+        {
+            return "";
+        }
+        bytes = 4 << opc;
+        const char c = kElem[2 + opc];
+        r1 = format("%c%d", c, rt);
+        r2 = format("%c%d", c, rt2);
+    }
+    else
+    {
+        if (opc & 1)
+        {
+            return "";
+        }
+        bytes = opc ? 8 : 4;
+        r1 = xreg(rt, opc != 0);
+        r2 = xreg(rt2, opc != 0);
+    }
+    const long long off = (long long)sfield(w, 21, 15) * bytes;
+    const char* name = load ? "ldp" : "stp";
+    const std::string base = xreg(rn, true, true);
+    switch (mode)
+    {
+    case 1:
+        return format("%s %s, %s, [%s], #%lld", name, r1.c_str(), r2.c_str(), base.c_str(), off);
+    case 2:
+        return format("%s %s, %s, [%s, #%lld]", name, r1.c_str(), r2.c_str(), base.c_str(), off);
+    case 3:
+        return format("%s %s, %s, [%s, #%lld]!", name, r1.c_str(), r2.c_str(), base.c_str(), off);
+    }
+    return "";
+}
+
+// DecodeBitMasks for logical immediates
+static bool bit_mask(int n, int imms, int immr, bool wide, uint64_t& out)
+{
+    const int combined = (n << 6) | (~imms & 0x3f);
+    int len = -1;
+    for (int i = 6; i >= 0; i--)
+    {
+        if (combined & (1 << i))
+        {
+            len = i;
+            break;
+        }
+    }
+    if (len < 1 || (!wide && len == 6))
+    {
+        return false;
+    }
+    const int size = 1 << len;
+    const int levels = size - 1;
+    const int s = imms & levels;
+    const int r = immr & levels;
+    if (s == levels)
+    {
+        return false;
+    }
+    const uint64_t elem_mask = size == 64 ? ~0ull : (1ull << size) - 1;
+    const uint64_t welem = (1ull << (s + 1)) - 1;
+    const uint64_t elem = r == 0 ? welem : ((welem >> r) | (welem << (size - r))) & elem_mask;
+    out = replicate(elem, size / 8 ? size / 8 : 1);
+    if (size < 8)
+    {
+        out = 0;
+        for (int i = 0; i < 64; i += size)
+        {
+            out |= elem << i;
+        }
+    }
+    if (!wide)
+    {
+        out &= 0xFFFFFFFFull;
+    }
+    return true;
+}
+
+static std::string dis_scalar(uint32_t w)
+{
+    const bool wide = field(w, 31, 31) != 0;
+    const int rd = field(w, 4, 0);
+    const int rn = field(w, 9, 5);
+    const int rm = field(w, 20, 16);
+    static const char* shifts[] = { "lsl", "lsr", "asr", "ror" };
+
+    if ((w & 0x1F800000) == 0x11000000)
+    {
+        // add / sub immediate
+        const int sub = field(w, 30, 30);
+        const int flags = field(w, 29, 29);
+        const unsigned imm = field(w, 21, 10);
+        const std::string sh = field(w, 22, 22) ? ", lsl #12" : "";
+        if (flags && rd == 31)
+        {
+            return format("%s %s, #%u%s", sub ? "cmp" : "cmn", xreg(rn, wide, true).c_str(), imm, sh.c_str());
+        }
+        return format("%s%s %s, %s, #%u%s", sub ? "sub" : "add", flags ? "s" : "", xreg(rd, wide, !flags).c_str(),
+                      xreg(rn, wide, true).c_str(), imm, sh.c_str());
+    }
+    if ((w & 0x1F800000) == 0x12000000)
+    {
+        // logical immediate
+        uint64_t imm;
+        if (!bit_mask(field(w, 22, 22), field(w, 15, 10), field(w, 21, 16), wide, imm))
+        {
+            return "";
+        }
+        static const char* names[] = { "and", "orr", "eor", "ands" };
+        const int opc = field(w, 30, 29);
+        if (opc == 3 && rd == 31)
+        {
+            return format("tst %s, #0x%llx", xreg(rn, wide).c_str(), (unsigned long long)imm);
+        }
+        if (opc == 1 && rn == 31)
+        {
+            return format("mov %s, #0x%llx", xreg(rd, wide, true).c_str(), (unsigned long long)imm);
+        }
+        return format("%s %s, %s, #0x%llx", names[opc], xreg(rd, wide, opc != 3).c_str(), xreg(rn, wide).c_str(),
+                      (unsigned long long)imm);
+    }
+    if ((w & 0x1F800000) == 0x12800000)
+    {
+        // move wide
+        static const char* names[] = { "movn", "", "movz", "movk" };
+        const int opc = field(w, 30, 29);
+        const int hw = field(w, 22, 21);
+        if (opc == 1 || (!wide && hw > 1))
+        {
+            return "";
+        }
+        return format("%s %s, #%u, lsl #%d", names[opc], xreg(rd, wide).c_str(), field(w, 20, 5), hw * 16);
+    }
+    if ((w & 0x1F800000) == 0x13000000)
+    {
+        // bitfield: only the lsl / lsr / asr aliases
+        const int opc = field(w, 30, 29);
+        const int immr = field(w, 21, 16);
+        const int imms = field(w, 15, 10);
+        const int bits = wide ? 64 : 32;
+        if (field(w, 22, 22) != (wide ? 1u : 0u))
+        {
+            return "";
+        }
+        if (opc == 2 && imms == bits - 1)
+        {
+            return format("lsr %s, %s, #%d", xreg(rd, wide).c_str(), xreg(rn, wide).c_str(), immr);
+        }
+        if (opc == 2 && imms + 1 == immr)
+        {
+            return format("lsl %s, %s, #%d", xreg(rd, wide).c_str(), xreg(rn, wide).c_str(), bits - 1 - imms);
+        }
+        if (opc == 0 && imms == bits - 1)
+        {
+            return format("asr %s, %s, #%d", xreg(rd, wide).c_str(), xreg(rn, wide).c_str(), immr);
+        }
+        return "";
+    }
+    if ((w & 0x1F000000) == 0x0A000000)
+    {
+        // logical shifted register
+        static const char* names[2][4] = { { "and", "orr", "eor", "ands" }, { "bic", "orn", "eon", "bics" } };
+        const int opc = field(w, 30, 29);
+        const int neg = field(w, 21, 21);
+        const int amount = field(w, 15, 10);
+        if (!wide && amount >= 32)
+        {
+            return "";
+        }
+        const std::string sh = amount ? format(", %s #%d", shifts[field(w, 23, 22)], amount) : "";
+        if (opc == 3 && !neg && rd == 31)
+        {
+            return format("tst %s, %s%s", xreg(rn, wide).c_str(), xreg(rm, wide).c_str(), sh.c_str());
+        }
+        return format("%s %s, %s, %s%s", names[neg][opc], xreg(rd, wide).c_str(), xreg(rn, wide).c_str(),
+                      xreg(rm, wide).c_str(), sh.c_str());
+    }
+    if ((w & 0x1F200000) == 0x0B000000)
+    {
+        // add / sub shifted register
+        const int sub = field(w, 30, 30);
+        const int flags = field(w, 29, 29);
+        const int type = field(w, 23, 22);
+        const int amount = field(w, 15, 10);
+        if (type == 3 || (!wide && amount >= 32))
+        {
+            return "";
+        }
+        const std::string sh = amount ? format(", %s #%d", shifts[type], amount) : "";
+        if (flags && rd == 31)
+        {
+            return format("%s %s, %s%s", sub ? "cmp" : "cmn", xreg(rn, wide).c_str(), xreg(rm, wide).c_str(), sh.c_str());
+        }
+        return format("%s%s %s, %s, %s%s", sub ? "sub" : "add", flags ? "s" : "", xreg(rd, wide).c_str(),
+                      xreg(rn, wide).c_str(), xreg(rm, wide).c_str(), sh.c_str());
+    }
+    if ((w & 0x7FE00000) == 0x1B000000)
+    {
+        // madd / msub
+        return format("%s %s, %s, %s, %s", field(w, 15, 15) ? "msub" : "madd", xreg(rd, wide).c_str(),
+                      xreg(rn, wide).c_str(), xreg(rm, wide).c_str(), xreg(field(w, 14, 10), wide).c_str());
+    }
+    if ((w & 0x7FE00000) == 0x1AC00000)
+    {
+        static const char* names[] = { "", "", "udiv", "sdiv", "", "", "", "", "lsl", "lsr", "asr", "ror" };
+        const unsigned opcode = field(w, 15, 10);
+        if (opcode >= 12 || !names[opcode][0])
+        {
+            return "";
+        }
+        return format("%s %s, %s, %s", names[opcode], xreg(rd, wide).c_str(), xreg(rn, wide).c_str(),
+                      xreg(rm, wide).c_str());
+    }
+    return "";
+}
+
+static std::string dis_three_same(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int size = field(w, 23, 22);
+    const int opcode = field(w, 15, 11);
+    const int rm = field(w, 20, 16);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    const char* name = NULL;
+    int asize = size;
+    if (opcode >= 0x18)
+    {
+        // floating point: size<1> is part of the opcode, size<0> the precision
+        const int a = size >> 1;
+        static const struct
+        {
+            int u, a, opcode;
+            const char* name;
+        } fp[] = {
+            { 0, 0, 0x1a, "fadd" }, { 0, 1, 0x1a, "fsub" }, { 1, 0, 0x1b, "fmul" }, { 1, 0, 0x1f, "fdiv" },
+            { 0, 0, 0x1e, "fmax" }, { 0, 1, 0x1e, "fmin" }, { 0, 0, 0x19, "fmla" }, { 0, 1, 0x19, "fmls" },
+            { 1, 0, 0x1a, "faddp" }, { 1, 1, 0x1a, "fabd" }, { 0, 0, 0x1c, "fcmeq" }, { 1, 0, 0x1c, "fcmge" },
+            { 1, 1, 0x1c, "fcmgt" },
+        };
+        for (size_t k = 0; k < sizeof(fp) / sizeof(fp[0]); k++)
+        {
+            if (fp[k].u == u && fp[k].a == a && fp[k].opcode == opcode)
+            {
+                name = fp[k].name;
+            }
+        }
+        asize = 2 + (size & 1);
+        if (asize == 3 && !q)
+        {
+            return "";
+        }
+    }
+    else if (opcode == 0x03)
+    {
+        static const char* logic[2][4] = { { "and", "bic", "orr", "orn" }, { "eor", "bsl", "bit", "bif" } };
+        name = logic[u][size];
+        asize = 0;
+    }
+    else
+    {
+        static const struct
+        {
+            int opcode;
+            const char* name[2];
+        } in[] = {
+            { 0x01, { "sqadd", "uqadd" } }, { 0x05, { "sqsub", "uqsub" } }, { 0x06, { "cmgt", "cmhi" } },
+            { 0x07, { "cmge", "cmhs" } },   { 0x0c, { "smax", "umax" } },   { 0x0d, { "smin", "umin" } },
+            { 0x0e, { "sabd", "uabd" } },   { 0x10, { "add", "sub" } },     { 0x11, { "cmtst", "cmeq" } },
+            { 0x12, { "mla", "mls" } },     { 0x13, { "mul", NULL } },      { 0x17, { "addp", NULL } },
+        };
+        for (size_t k = 0; k < sizeof(in) / sizeof(in[0]); k++)
+        {
+            if (in[k].opcode == opcode)
+            {
+                name = in[k].name[u];
+            }
+        }
+        if (size == 3 && !q)
+        {
+            return "";
+        }
+    }
+    if (!name)
+    {
+        return "";
+    }
+    if (opcode == 0x03 && !u && size == 2 && rn == rm)
+    {
+        return format("mov %s, %s", vreg(rd, 0, q).c_str(), vreg(rn, 0, q).c_str());
+    }
+    return format("%s %s, %s, %s", name, vreg(rd, asize, q).c_str(), vreg(rn, asize, q).c_str(),
+                  vreg(rm, asize, q).c_str());
+}
+
+static std::string dis_three_diff(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int size = field(w, 23, 22);
+    const int opcode = field(w, 15, 12);
+    static const struct
+    {
+        int opcode;
+        const char* name[2];
+        bool wide_n;
+    } table[] = {
+        { 0x0, { "saddl", "uaddl" }, false }, { 0x1, { "saddw", "uaddw" }, true },
+        { 0x2, { "ssubl", "usubl" }, false }, { 0x3, { "ssubw", "usubw" }, true },
+        { 0x8, { "smlal", "umlal" }, false }, { 0xa, { "smlsl", "umlsl" }, false },
+        { 0xc, { "smull", "umull" }, false },
+    };
+    if (size == 3)
+    {
+        return "";
+    }
+    for (size_t k = 0; k < sizeof(table) / sizeof(table[0]); k++)
+    {
+        if (table[k].opcode == opcode)
+        {
+            const std::string n = table[k].wide_n ? vreg(field(w, 9, 5), size + 1, 1) : vreg(field(w, 9, 5), size, q);
+            return format("%s%s %s, %s, %s", table[k].name[u], q ? "2" : "", vreg(field(w, 4, 0), size + 1, 1).c_str(),
+                          n.c_str(), vreg(field(w, 20, 16), size, q).c_str());
+        }
+    }
+    return "";
+}
+
+static std::string dis_two_misc(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int size = field(w, 23, 22);
+    const int opcode = field(w, 16, 12);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    const char* name = NULL;
+    if (opcode == 0x00 || (opcode == 0x01 && !u))
+    {
+        name = opcode ? "rev16" : u ? "rev32" : "rev64";
+        const int container = opcode ? 1 : u ? 2 : 3;
+        if (size >= container)
+        {
+            return "";
+        }
+    }
+    else if (opcode == 0x05 && u && size == 0)
+    {
+        name = "mvn";
+    }
+    else if (opcode == 0x0b)
+    {
+        name = u ? "neg" : "abs";
+        if (size == 3 && !q)
+        {
+            return "";
+        }
+    }
+    else if (opcode == 0x12 || opcode == 0x14)
+    {
+        if (size == 3 || (opcode == 0x12 && u))
+        {
+            return "";
+        }
+        const char* narrow = opcode == 0x12 ? "xtn" : u ? "uqxtn" : "sqxtn";
+        return format("%s%s %s, %s", narrow, q ? "2" : "", vreg(rd, size, q).c_str(), vreg(rn, size + 1, 1).c_str());
+    }
+    else
+    {
+        const int a = size >> 1;
+        static const struct
+        {
+            int u, a, opcode;
+            const char* name;
+        } fp[] = {
+            { 0, 0, 0x1d, "scvtf" }, { 1, 0, 0x1d, "ucvtf" }, { 0, 1, 0x1b, "fcvtzs" }, { 1, 1, 0x1b, "fcvtzu" },
+            { 0, 1, 0x0f, "fabs" },  { 1, 1, 0x0f, "fneg" },  { 1, 1, 0x1f, "fsqrt" },
+        };
+        for (size_t k = 0; k < sizeof(fp) / sizeof(fp[0]); k++)
+        {
+            if (fp[k].u == u && fp[k].a == a && fp[k].opcode == opcode)
+            {
+                if ((size & 1) && !q)
+                {
+                    return "";
+                }
+                return format("%s %s, %s", fp[k].name, vreg(rd, 2 + (size & 1), q).c_str(),
+                              vreg(rn, 2 + (size & 1), q).c_str());
+            }
+        }
+        return "";
+    }
+    return format("%s %s, %s", name, vreg(rd, size, q).c_str(), vreg(rn, size, q).c_str());
+}
+
+static std::string dis_across(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int size = field(w, 23, 22);
+    const int opcode = field(w, 16, 12);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    if (opcode == 0x0f && u)
+    {
+        if ((size & 1) || !q)
+        {
+            return "";
+        }
+        return format("%s s%d, %s", size ? "fminv" : "fmaxv", rd, vreg(rn, 2, 1).c_str());
+    }
+    const char* name = NULL;
+    if (opcode == 0x1b && !u)
+    {
+        name = "addv";
+    }
+    else if (opcode == 0x0a)
+    {
+        name = u ? "umaxv" : "smaxv";
+    }
+    else if (opcode == 0x1a)
+    {
+        name = u ? "uminv" : "sminv";
+    }
+    if (!name || size == 3 || (size == 2 && !q))
+    {
+        return "";
+    }
+    return format("%s %c%d, %s", name, kElem[size], rd, vreg(rn, size, q).c_str());
+}
+
+static std::string dis_copy(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int op = field(w, 29, 29);
+    const int imm5 = field(w, 20, 16);
+    const int imm4 = field(w, 14, 11);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    int size = 0;
+    while (size < 4 && !(imm5 & (1 << size)))
+    {
+        size++;
+    }
+    if (size == 4)
+    {
+        return "";
+    }
+    const int index = imm5 >> (size + 1);
+    const char e = kElem[size];
+    if (op)
+    {
+        if (!q)
+        {
+            return "";
+        }
+        return format("mov v%d.%c[%d], v%d.%c[%d]", rd, e, index, rn, e, imm4 >> size);
+    }
+    switch (imm4)
+    {
+    case 0:
+        if (size == 3 && !q)
+        {
+            return "";
+        }
+        return format("dup %s, v%d.%c[%d]", vreg(rd, size, q).c_str(), rn, e, index);
+    case 1:
+        if (size == 3 && !q)
+        {
+            return "";
+        }
+        return format("dup %s, %s", vreg(rd, size, q).c_str(), xreg(rn, size == 3).c_str());
+    case 3:
+        if (!q)
+        {
+            return "";
+        }
+        return format("mov v%d.%c[%d], %s", rd, e, index, xreg(rn, size == 3).c_str());
+    case 7:
+        if (q != (size == 3))
+        {
+            return "";
+        }
+        return format("umov %s, v%d.%c[%d]", xreg(rd, size == 3).c_str(), rn, e, index);
+    }
+    return "";
+}
+
+static std::string dis_modified_imm(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int op = field(w, 29, 29);
+    const int cmode = field(w, 15, 12);
+    const unsigned imm8 = (field(w, 18, 16) << 5) | field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    if (field(w, 11, 11))
+    {
+        return "";
+    }
+    if (cmode == 0xe)
+    {
+        if (!op)
+        {
+            return format("movi %s, #0x%x", vreg(rd, 0, q).c_str(), imm8);
+        }
+        uint64_t imm = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            if (imm8 & (1u << i))
+            {
+                imm |= 0xFFull << (8 * i);
+            }
+        }
+        return q ? format("movi %s, #0x%llx", vreg(rd, 3, 1).c_str(), (unsigned long long)imm)
+                 : format("movi d%d, #0x%llx", rd, (unsigned long long)imm);
+    }
+    const char* name = op ? "mvni" : "movi";
+    if ((cmode & 0x9) == 0x0)
+    {
+        return format("%s %s, #0x%x, lsl #%d", name, vreg(rd, 2, q).c_str(), imm8, ((cmode >> 1) & 3) * 8);
+    }
+    if ((cmode & 0xd) == 0x8)
+    {
+        return format("%s %s, #0x%x, lsl #%d", name, vreg(rd, 1, q).c_str(), imm8, ((cmode >> 1) & 1) * 8);
+    }
+    if ((cmode & 0xe) == 0xc)
+    {
+        return format("%s %s, #0x%x, msl #%d", name, vreg(rd, 2, q).c_str(), imm8, (cmode & 1) ? 16 : 8);
+    }
+    return "";
+}
+
+static std::string dis_shift_imm(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int immh = field(w, 22, 19);
+    const int immhb = field(w, 22, 16);
+    const int opcode = field(w, 15, 11);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    int hsb = 3;
+    while (!(immh & (1 << hsb)))
+    {
+        hsb--;
+    }
+    const int esize = 8 << hsb;
+    const char* name = NULL;
+    switch (opcode)
+    {
+    case 0x00: name = u ? "ushr" : "sshr"; break;
+    case 0x02: name = u ? "usra" : "ssra"; break;
+    case 0x04: name = u ? "urshr" : "srshr"; break;
+    case 0x0a: name = u ? NULL : "shl"; break;
+    case 0x10:
+    case 0x11:
+        if (u || hsb == 3)
+        {
+            return "";
+        }
+        return format("%s%s %s, %s, #%d", opcode == 0x10 ? "shrn" : "rshrn", q ? "2" : "", vreg(rd, hsb, q).c_str(),
+                      vreg(rn, hsb + 1, 1).c_str(), 2 * esize - immhb);
+    case 0x14:
+        if (hsb == 3)
+        {
+            return "";
+        }
+        return format("%s%s %s, %s, #%d", u ? "ushll" : "sshll", q ? "2" : "", vreg(rd, hsb + 1, 1).c_str(),
+                      vreg(rn, hsb, q).c_str(), immhb - esize);
+    }
+    if (!name || (hsb == 3 && !q))
+    {
+        return "";
+    }
+    const int shift = opcode == 0x0a ? immhb - esize : 2 * esize - immhb;
+    return format("%s %s, %s, #%d", name, vreg(rd, hsb, q).c_str(), vreg(rn, hsb, q).c_str(), shift);
+}
+
+static std::string dis_by_element(uint32_t w)
+{
+    const int q = field(w, 30, 30);
+    const int u = field(w, 29, 29);
+    const int size = field(w, 23, 22);
+    const int l = field(w, 21, 21);
+    const int m = field(w, 20, 20);
+    const int rm = field(w, 19, 16);
+    const int opcode = field(w, 15, 12);
+    const int h = field(w, 11, 11);
+    const int rn = field(w, 9, 5);
+    const int rd = field(w, 4, 0);
+    if (size >> 1)
+    {
+        const char* name = NULL;
+        if (!u && opcode == 0x1)
+        {
+            name = "fmla";
+        }
+        else if (!u && opcode == 0x5)
+        {
+            name = "fmls";
+        }
+        else if (!u && opcode == 0x9)
+        {
+            name = "fmul";
+        }
+        const int dbl = size & 1;
+        if (!name || (dbl && (l || !q)))
+        {
+            return "";
+        }
+        const int index = dbl ? h : (h << 1) | l;
+        return format("%s %s, %s, v%d.%c[%d]", name, vreg(rd, 2 + dbl, q).c_str(), vreg(rn, 2 + dbl, q).c_str(),
+                      (m << 4) | rm, dbl ? 'd' : 's', index);
+    }
+    static const struct
+    {
+        int opcode;
+        const char* name[2];
+    } widen[] = {
+        { 0x2, { "smlal", "umlal" } }, { 0x6, { "smlsl", "umlsl" } }, { 0xa, { "smull", "umull" } },
+    };
+    for (size_t k = 0; k < sizeof(widen) / sizeof(widen[0]); k++)
+    {
+        if (widen[k].opcode == opcode && (size == 1 || size == 2))
+        {
+            const int index = size == 1 ? (h << 2) | (l << 1) | m : (h << 1) | l;
+            const int reg = size == 1 ? rm : (m << 4) | rm;
+            return format("%s%s %s, %s, v%d.%c[%d]", widen[k].name[u], q ? "2" : "", vreg(rd, size + 1, 1).c_str(),
+                          vreg(rn, size, q).c_str(), reg, kElem[size], index);
+        }
+    }
+    const char* name = NULL;
+    if (u && opcode == 0x0)
+    {
+        name = "mla";
+    }
+    else if (u && opcode == 0x4)
+    {
+        name = "mls";
+    }
+    else if (!u && opcode == 0x8)
+    {
+        name = "mul";
+    }
+    if (!name || size == 0)
+    {
+        return "";
+    }
+    const int index = size == 1 ? (h << 2) | (l << 1) | m : (h << 1) | l;
+    const int reg = size == 1 ? rm : (m << 4) | rm;
+    return format("%s %s, %s, v%d.%c[%d]", name, vreg(rd, size, q).c_str(), vreg(rn, size, q).c_str(), reg,
+                  kElem[size], index);
+}
+
+} // namespace neon_sim_asm_detail
+
+std::string asm_disassemble(uint32_t w)
+{
+    using namespace neon_sim_asm_detail;
+
+    if (w == 0xD503201F || (w & 0xFFC00000) == 0xF9800000)
+    {
+        return "nop"; // nop, prfm
+    }
+    if ((w & 0xFFFFFC1F) == 0xD65F0000)
+    {
+        return format("ret x%d", field(w, 9, 5));
+    }
+    if ((w & 0xFC000000) == 0x14000000)
+    {
+        return format("b #%lld", (long long)sfield(w, 25, 0) * 4);
+    }
+    if ((w & 0xFF000010) == 0x54000000)
+    {
+        return format("b.%s #%lld", kConditions[field(w, 3, 0)], (long long)sfield(w, 23, 5) * 4);
+    }
+    if ((w & 0x7E000000) == 0x34000000)
+    {
+        return format("%s %s, #%lld", field(w, 24, 24) ? "cbnz" : "cbz", xreg(field(w, 4, 0), field(w, 31, 31) != 0).c_str(),
+                      (long long)sfield(w, 23, 5) * 4);
+    }
+    if ((w & 0x7E000000) == 0x36000000)
+    {
+        const int bit = (field(w, 31, 31) << 5) | field(w, 23, 19);
+        return format("%s %s, #%d, #%lld", field(w, 24, 24) ? "tbnz" : "tbz", xreg(field(w, 4, 0), bit >= 32).c_str(),
+                      bit, (long long)sfield(w, 18, 5) * 4);
+    }
+    if ((w & 0xBF000000) == 0x0C000000 || (w & 0xBF000000) == 0x0D000000)
+    {
+        return dis_load_store_vector(w);
+    }
+    if ((w & 0x3B000000) == 0x39000000 || (w & 0x3B200000) == 0x38000000 || (w & 0x3B200000) == 0x38200000)
+    {
+        return dis_load_store_reg(w);
+    }
+    if ((w & 0x3A000000) == 0x28000000)
+    {
+        return dis_load_store_pair(w);
+    }
+    if ((w & 0x1C000000) == 0x10000000 || (w & 0x0E000000) == 0x0A000000)
+    {
+        return dis_scalar(w);
+    }
+    if ((w & 0xFFBFFC00) == 0x7E30D800)
+    {
+        const int dbl = field(w, 22, 22);
+        return format("faddp %c%d, %s", dbl ? 'd' : 's', field(w, 4, 0), vreg(field(w, 9, 5), 2 + dbl, dbl).c_str());
+    }
+    if ((w & 0x9F200400) == 0x0E200400)
+    {
+        return dis_three_same(w);
+    }
+    if ((w & 0x9F200C00) == 0x0E200000)
+    {
+        return dis_three_diff(w);
+    }
+    if ((w & 0x9F3E0C00) == 0x0E200800)
+    {
+        return dis_two_misc(w);
+    }
+    if ((w & 0x9F3E0C00) == 0x0E300800)
+    {
+        return dis_across(w);
+    }
+    if ((w & 0x9FE08400) == 0x0E000400)
+    {
+        return dis_copy(w);
+    }
+    if ((w & 0xBF208C00) == 0x0E000800)
+    {
+        static const char* names[] = { NULL, "uzp1", "trn1", "zip1", NULL, "uzp2", "trn2", "zip2" };
+        const char* name = names[field(w, 14, 12)];
+        const int q = field(w, 30, 30);
+        const int size = field(w, 23, 22);
+        if (!name || (size == 3 && !q))
+        {
+            return "";
+        }
+        return format("%s %s, %s, %s", name, vreg(field(w, 4, 0), size, q).c_str(), vreg(field(w, 9, 5), size, q).c_str(),
+                      vreg(field(w, 20, 16), size, q).c_str());
+    }
+    if ((w & 0xBFE08400) == 0x2E000000)
+    {
+        const int q = field(w, 30, 30);
+        const int imm4 = field(w, 14, 11);
+        if (!q && imm4 >= 8)
+        {
+            return "";
+        }
+        return format("ext %s, %s, %s, #%d", vreg(field(w, 4, 0), 0, q).c_str(), vreg(field(w, 9, 5), 0, q).c_str(),
+                      vreg(field(w, 20, 16), 0, q).c_str(), imm4);
+    }
+    if ((w & 0xBFE08C00) == 0x0E000000)
+    {
+        const int q = field(w, 30, 30);
+        const int rn = field(w, 9, 5);
+        std::string list = "{";
+        for (int i = 0; i <= (int)field(w, 14, 13); i++)
+        {
+            list += format("%sv%d.16b", i ? ", " : "", (rn + i) & 31);
+        }
+        list += "}";
+        return format("%s %s, %s, %s", field(w, 12, 12) ? "tbx" : "tbl", vreg(field(w, 4, 0), 0, q).c_str(), list.c_str(),
+                      vreg(field(w, 20, 16), 0, q).c_str());
+    }
+    if ((w & 0x9FF80400) == 0x0F000400)
+    {
+        return dis_modified_imm(w);
+    }
+    if ((w & 0x9F800400) == 0x0F000400)
+    {
+        return dis_shift_imm(w);
+    }
+    if ((w & 0x9F000400) == 0x0F000000)
+    {
+        return dis_by_element(w);
+    }
+    return "";
+}
+
+//----------------------------------------------------------------------
+// 10. neon_sim_asm: operand binding and the predecode cache
+//----------------------------------------------------------------------
+
+namespace neon_sim_asm_detail {
+
+struct CachedBlock
+{
+    AsmProgram program;
+    std::vector<int> regs; ///< register assigned to each operand
+};
+
+struct BlockCache
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<CachedBlock> > blocks;
+    size_t lookups = 0;
+    size_t decodes = 0;
+};
+
+static BlockCache& block_cache()
+{
+    static BlockCache cache;
+    return cache;
+}
+
+// registers the text names itself: x0-x30 / w0-w30, v0-v31 / q d s h b
+static void scan_registers(const char* text, bool used_x[32], bool used_v[32])
+{
+    const char* p = text;
+    while (*p)
+    {
+        if (isalpha((unsigned char)*p) && (p == text || !(isalnum((unsigned char)p[-1]) || p[-1] == '%' || p[-1] == '_')))
+        {
+            const char* q = p;
+            while (isalnum((unsigned char)*q) || *q == '_')
+            {
+                q++;
+            }
+            const std::string word = lower(std::string(p, q));
+            int r;
+            if ((word[0] == 'x' || word[0] == 'w') && parse_regnum(word, 1, r))
+            {
+                used_x[r] = true;
+            }
+            else if ((word[0] == 'v' || element_size(word[0])) && parse_regnum(word, 1, r))
+            {
+                used_v[r] = true;
+            }
+            p = q;
+        }
+        else
+        {
+            p++;
+        }
+    }
+}
+
+static bool bind_block(const char* text, const std::vector<AsmOperand>& operands, CachedBlock& block)
+{
+    bool used_x[32] = { false };
+    bool used_v[32] = { false };
+    scan_registers(text, used_x, used_v);
+    used_x[31] = true;
+    // operands take the highest free registers, away from the low ones kernels name themselves
+    for (size_t i = 0; i < operands.size(); i++)
+    {
+        bool* used = operands[i].vector ? used_v : used_x;
+        int r = operands[i].vector ? 31 : 28;
+        while (r >= 0 && used[r])
+        {
+            r--;
+        }
+        if (r < 0)
+        {
+            block.program = AsmProgram();
+            return false;
+        }
+        used[r] = true;
+        block.regs.push_back(r);
+    }
+
+    std::string out;
+    for (const char* p = text; *p; p++)
+    {
+        if (*p != '%')
+        {
+            out += *p;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out += '%';
+            p++;
+            continue;
+        }
+        const char* q = p + 1;
+        char modifier = 0;
+        if (isalpha((unsigned char)*q))
+        {
+            modifier = (char)tolower((unsigned char)*q);
+            q++;
+        }
+        if (!isdigit((unsigned char)*q))
+        {
+            out += *p;
+            continue;
+        }
+        size_t k = 0;
+        while (isdigit((unsigned char)*q))
+        {
+            k = k * 10 + (*q - '0');
+            q++;
+        }
+        if (k >= operands.size())
+        {
+            out += format("%%%zu", k); // left for the assembler to reject
+        }
+        else if (operands[k].vector)
+        {
+            out += format("%c%d", modifier ? modifier : 'v', block.regs[k]);
+        }
+        else
+        {
+            out += format("%c%d", modifier == 'w' ? 'w' : 'x', block.regs[k]);
+        }
+        p = q - 1;
+    }
+    return block.program.assemble(out);
+}
+
+} // namespace neon_sim_asm_detail
+
+void neon_sim_asm(const char* text, std::initializer_list<AsmOperand> operands)
+{
+    using namespace neon_sim_asm_detail;
+
+    std::string key;
+    for (const AsmOperand& o : operands)
+    {
+        key += o.vector ? 'w' : 'r';
+    }
+    key += '\n';
+    key += text;
+
+    BlockCache& cache = block_cache();
+    CachedBlock* block;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.lookups++;
+        std::unique_ptr<CachedBlock>& slot = cache.blocks[key];
+        if (!slot)
+        {
+            slot.reset(new CachedBlock());
+            cache.decodes++;
+            if (!bind_block(text, std::vector<AsmOperand>(operands), *slot) && slot->program.error().empty())
+            {
+                fprintf(stderr, "%s: out of registers for %zu operands\n", __FUNCTION__, operands.size());
+                abort();
+            }
+        }
+        block = slot.get();
+    }
+    if (!block->program.ok())
+    {
+        fprintf(stderr, "%s: %s\n", __FUNCTION__, block->program.error().c_str());
+        abort();
+    }
+
+    AsmState s;
+    size_t k = 0;
+    for (const AsmOperand& o : operands)
+    {
+        const int r = block->regs[k++];
+        if (!o.input)
+        {
+            continue;
+        }
+        if (o.vector)
+        {
+            memcpy(s.v[r], o.ptr, o.size);
+        }
+        else
+        {
+            uint64_t v = 0;
+            memcpy(&v, o.ptr, o.size);
+            s.x[r] = v;
+        }
+    }
+    block->program.run(s);
+    k = 0;
+    for (const AsmOperand& o : operands)
+    {
+        const int r = block->regs[k++];
+        if (o.output)
+        {
+            memcpy(o.ptr, o.vector ? (const void*)s.v[r] : (const void*)&s.x[r], o.size);
+        }
+    }
+}
+
+AsmCacheStats asm_cache_stats()
+{
+    neon_sim_asm_detail::BlockCache& cache = neon_sim_asm_detail::block_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    AsmCacheStats st;
+    st.lookups = cache.lookups;
+    st.decodes = cache.decodes;
+    return st;
+}
+
+#endif // NEON_SIM_IMPLEMENTATION
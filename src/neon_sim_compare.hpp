@@ -0,0 +1,293 @@
+#pragma once
+
+//
+// Bulk comparison of registers, arrays and strided images, with
+// absolute / relative / ULP tolerance and mismatch statistics.
+//
+// usage:
+// #include "neon_sim_compare.hpp"
+//
+// CompareTolerance tol;
+// tol.max_ulp = 2;
+// CompareResult res = compare_image(expected, expected_step, actual, actual_step, height, width, channels, tol);
+// if (!res.ok()) std::cerr << res << std::endl;
+//
+// An element passes when any enabled tolerance accepts it:
+//   |e - a| <= abs_eps, or |e - a| <= rel_eps * max(|e|, |a|), or ulp(e, a) <= max_ulp (float types only).
+// Two NaNs compare equal. Every row is first checked by a branch-free counting
+// pass (memcmp for exact integer rows); only rows that contain mismatches are
+// walked again to collect locations.
+//
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+struct CompareTolerance
+{
+    double abs_eps = 0;
+    double rel_eps = 0;
+    uint64_t max_ulp = 0;
+};
+
+struct CompareLocation
+{
+    size_t y;
+    size_t x;
+    size_t c;
+    double expected;
+    double actual;
+    double error;
+};
+
+struct CompareResult
+{
+    size_t count = 0;          // number of compared elements
+    size_t mismatches = 0;
+    double max_abs_error = 0;  // over all elements
+    uint64_t max_ulp_error = 0; // over all elements, float types only
+    std::vector<CompareLocation> locations; // the first mismatches, in scan order
+
+    bool ok() const
+    {
+        return mismatches == 0;
+    }
+};
+
+static inline std::ostream& operator <<(std::ostream& os, const CompareResult& res)
+{
+    os << res.mismatches << "/" << res.count << " mismatches, max_abs_error = " << res.max_abs_error
+       << ", max_ulp_error = " << res.max_ulp_error;
+    for (size_t i = 0; i < res.locations.size(); i++)
+    {
+        const CompareLocation& loc = res.locations[i];
+        os << std::endl << "  [" << loc.y << "," << loc.x << "," << loc.c << "] actual = " << loc.actual
+           << ", expected = " << loc.expected << ", error = " << loc.error;
+    }
+    return os;
+}
+
+namespace neon_sim_compare_detail {
+
+// Maps float bits onto a monotonic integer line, so the ULP distance of two
+// floats is the difference of their keys.
+static inline int64_t ulp_key(float v)
+{
+    int32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits < 0 ? (int64_t)INT32_MIN - bits : (int64_t)bits;
+}
+
+static inline uint64_t ulp_distance(float e, float a)
+{
+    const int64_t d = ulp_key(e) - ulp_key(a);
+    return (uint64_t)(d < 0 ? -d : d);
+}
+
+static inline uint64_t ulp_distance(double e, double a)
+{
+    int64_t be;
+    int64_t ba;
+    memcpy(&be, &e, sizeof(be));
+    memcpy(&ba, &a, sizeof(ba));
+    const uint64_t ke = be < 0 ? (uint64_t)INT64_MIN - ((uint64_t)be & INT64_MAX) : (uint64_t)be + (uint64_t)INT64_MIN;
+    const uint64_t ka = ba < 0 ? (uint64_t)INT64_MIN - ((uint64_t)ba & INT64_MAX) : (uint64_t)ba + (uint64_t)INT64_MIN;
+    return ke > ka ? ke - ka : ka - ke;
+}
+
+template<typename T, bool IsFloat = std::is_floating_point<T>::value>
+struct Element;
+
+// Integers: |e - a| is taken exactly in an unsigned type at least as wide as
+// T (the wrap-around subtraction of the larger minus the smaller value), so
+// the counting pass and the per-element verdict agree for every width.
+template<typename T>
+struct Element<T, false>
+{
+    typedef typename std::conditional<(sizeof(T) < 4), uint32_t, uint64_t>::type diff_t;
+
+    static inline diff_t abs_diff(T e, T a)
+    {
+        return e > a ? (diff_t)e - (diff_t)a : (diff_t)a - (diff_t)e;
+    }
+
+    // abs_eps as a bound on abs_diff; false when no difference can pass it
+    static inline bool abs_bound(const CompareTolerance& tol, diff_t& bound)
+    {
+        if (!(tol.abs_eps >= 0))
+        {
+            return false;
+        }
+        const double limit = (double)std::numeric_limits<diff_t>::max();
+        bound = tol.abs_eps >= limit ? std::numeric_limits<diff_t>::max() : (diff_t)floor(tol.abs_eps);
+        return true;
+    }
+
+    static inline double error(T e, T a)
+    {
+        return (double)abs_diff(e, a);
+    }
+
+    static inline uint64_t ulp(T, T)
+    {
+        return 0;
+    }
+
+    static inline bool pass(T e, T a, const CompareTolerance& tol)
+    {
+        diff_t bound;
+        if (abs_bound(tol, bound) && abs_diff(e, a) <= bound)
+        {
+            return true;
+        }
+        return error(e, a) <= tol.rel_eps * std::max(fabs((double)e), fabs((double)a));
+    }
+
+    static size_t count_row(const T* e, const T* a, size_t n, const CompareTolerance& tol, double& max_err, uint64_t&)
+    {
+        diff_t bound;
+        if (tol.rel_eps > 0 || !abs_bound(tol, bound))
+        {
+            size_t bad = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                bad += !pass(e[i], a[i], tol);
+                max_err = std::max(max_err, error(e[i], a[i]));
+            }
+            return bad;
+        }
+
+        diff_t row_max = 0;
+        size_t bad = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const diff_t ad = abs_diff(e[i], a[i]);
+            bad += ad > bound;
+            row_max = ad > row_max ? ad : row_max;
+        }
+        max_err = std::max(max_err, (double)row_max);
+        return bad;
+    }
+};
+
+template<typename T>
+struct Element<T, true>
+{
+    static inline double error(T e, T a)
+    {
+        return fabs((double)e - (double)a);
+    }
+
+    static inline uint64_t ulp(T e, T a)
+    {
+        return ulp_distance(e, a);
+    }
+
+    static inline bool pass(T e, T a, const CompareTolerance& tol)
+    {
+        const bool e_nan = e != e;
+        const bool a_nan = a != a;
+        const double err = error(e, a);
+        const bool within = (err <= tol.abs_eps) | (err <= tol.rel_eps * std::max(fabs((double)e), fabs((double)a)))
+                            | (ulp(e, a) <= tol.max_ulp);
+        return (e_nan & a_nan) | (!(e_nan | a_nan) & within);
+    }
+
+    static size_t count_row(const T* e, const T* a, size_t n, const CompareTolerance& tol, double& max_err,
+                            uint64_t& max_ulp)
+    {
+        size_t bad = 0;
+        double row_err = 0;
+        uint64_t row_ulp = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            bad += !pass(e[i], a[i], tol);
+            // NaN errors compare false and never raise the maxima
+            const double err = error(e[i], a[i]);
+            const uint64_t u = (e[i] == e[i] && a[i] == a[i]) ? ulp(e[i], a[i]) : 0;
+            row_err = err > row_err ? err : row_err;
+            row_ulp = u > row_ulp ? u : row_ulp;
+        }
+        max_err = std::max(max_err, row_err);
+        max_ulp = std::max(max_ulp, row_ulp);
+        return bad;
+    }
+};
+
+} // namespace neon_sim_compare_detail
+
+/// @brief compare two strided images of `height` rows x `width` pixels x `channels` interleaved channels
+/// @param expected_step, actual_step row strides in bytes
+/// @param max_locations how many mismatch locations to keep in the result
+template<typename T>
+static CompareResult compare_image(const T* expected, size_t expected_step, const T* actual, size_t actual_step,
+                                   size_t height, size_t width, size_t channels,
+                                   const CompareTolerance& tol = CompareTolerance(), size_t max_locations = 8)
+{
+    typedef neon_sim_compare_detail::Element<T> E;
+    const bool exact_bits = !std::is_floating_point<T>::value && tol.abs_eps < 1 && tol.rel_eps == 0;
+    const size_t row_len = width * channels;
+
+    CompareResult res;
+    res.count = height * row_len;
+    for (size_t y = 0; y < height; y++)
+    {
+        const T* e = (const T*)((const uint8_t*)expected + y * expected_step);
+        const T* a = (const T*)((const uint8_t*)actual + y * actual_step);
+        if (exact_bits && memcmp(e, a, row_len * sizeof(T)) == 0)
+        {
+            continue;
+        }
+
+        const size_t bad = E::count_row(e, a, row_len, tol, res.max_abs_error, res.max_ulp_error);
+        if (bad == 0)
+        {
+            continue;
+        }
+        res.mismatches += bad;
+        for (size_t i = 0; i < row_len && res.locations.size() < max_locations; i++)
+        {
+            if (!E::pass(e[i], a[i], tol))
+            {
+                CompareLocation loc;
+                loc.y = y;
+                loc.x = i / channels;
+                loc.c = i % channels;
+                loc.expected = (double)e[i];
+                loc.actual = (double)a[i];
+                loc.error = E::error(e[i], a[i]);
+                res.locations.push_back(loc);
+            }
+        }
+    }
+    return res;
+}
+
+/// @brief compare two contiguous arrays of n elements
+template<typename T>
+static CompareResult compare_array(const T* expected, const T* actual, size_t n,
+                                   const CompareTolerance& tol = CompareTolerance(), size_t max_locations = 8)
+{
+    return compare_image(expected, n * sizeof(T), actual, n * sizeof(T), 1, n, 1, tol, max_locations);
+}
+
+/// @brief compare two vector registers lane by lane
+/// Works for both the simulated TxN registers and native arm_neon.h vector types.
+template<typename V>
+static CompareResult compare_register(const V& expected, const V& actual,
+                                      const CompareTolerance& tol = CompareTolerance(), size_t max_locations = 8)
+{
+    typedef typename std::decay<decltype(expected[0])>::type lane_t;
+    const size_t lanes = sizeof(V) / sizeof(lane_t);
+    lane_t e[sizeof(V) / sizeof(lane_t)];
+    lane_t a[sizeof(V) / sizeof(lane_t)];
+    memcpy(e, &expected, sizeof(V));
+    memcpy(a, &actual, sizeof(V));
+    return compare_array(e, a, lanes, tol, max_locations);
+}
@@ -0,0 +1,47 @@
+//
+// NEON_SIM_FAST_SSE bridge: the intrinsics listed in neon_sim_sse.inc,
+// implemented by NEON_2_SSE.h and exported with untyped register pointers.
+//
+// This file is compiled on its own and never sees arm_neon_sim.hpp: both
+// headers define the same intrinsic and vector type names. Registers cross the
+// boundary as raw bytes, which works because a TxN register and its
+// NEON_2_SSE counterpart have the same size and lane layout.
+//
+
+#include <string.h>
+#include "NEON_2_SSE.h"
+
+#define NEON_SIM_SSE_1(name, R, A) \
+    void neon_sim_sse_##name(const void* a, void* r) \
+    { \
+        A va; \
+        memcpy(&va, a, sizeof(va)); \
+        R vr = name(va); \
+        memcpy(r, &vr, sizeof(vr)); \
+    }
+
+#define NEON_SIM_SSE_2(name, R, A, B) \
+    void neon_sim_sse_##name(const void* a, const void* b, void* r) \
+    { \
+        A va; \
+        B vb; \
+        memcpy(&va, a, sizeof(va)); \
+        memcpy(&vb, b, sizeof(vb)); \
+        R vr = name(va, vb); \
+        memcpy(r, &vr, sizeof(vr)); \
+    }
+
+#define NEON_SIM_SSE_3(name, R, A, B, C) \
+    void neon_sim_sse_##name(const void* a, const void* b, const void* c, void* r) \
+    { \
+        A va; \
+        B vb; \
+        C vc; \
+        memcpy(&va, a, sizeof(va)); \
+        memcpy(&vb, b, sizeof(vb)); \
+        memcpy(&vc, c, sizeof(vc)); \
+        R vr = name(va, vb, vc); \
+        memcpy(r, &vr, sizeof(vr)); \
+    }
+
+#include "neon_sim_sse.inc"
@@ -0,0 +1,228 @@
+//
+// Differential run behind NEON_SIM_FAST_SSE: feeds random and edge-value
+// registers to every intrinsic of neon_sim_sse.inc, once through the sim and
+// once through NEON_2_SSE.h, and prints the routing table.
+//
+// usage:
+// ./neon_sim_sse_table [--trials=N] [--seed=S] > ../src/neon_sim_sse_routes.inc
+//
+// An intrinsic is routed only when every trial gives the same result bytes as
+// the sim. The others are listed as comments with their mismatch statistics
+// and the first failing input.
+//
+
+#define NEON_SIM_IMPLEMENTATION
+#define NEON_SIM_SSE_NO_ROUTES
+#include "arm_neon_sim.hpp"
+#include "neon_sim_compare.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+std::mt19937 rng;
+
+template<typename T>
+T edge_value(size_t k, std::true_type /* is_float */)
+{
+    const T values[] = {
+        0, -(T)0, 1, -1, (T)0.5, std::numeric_limits<T>::max(), -std::numeric_limits<T>::max(),
+        std::numeric_limits<T>::min(), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::infinity(),
+        -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::quiet_NaN(),
+    };
+    return values[k % (sizeof(values) / sizeof(values[0]))];
+}
+
+template<typename T>
+T edge_value(size_t k, std::false_type /* is_float */)
+{
+    const T values[] = {
+        0, 1, (T)-1, std::numeric_limits<T>::max(), std::numeric_limits<T>::min(),
+        (T)(std::numeric_limits<T>::max() - 1), (T)(std::numeric_limits<T>::min() + 1),
+    };
+    return values[k % (sizeof(values) / sizeof(values[0]))];
+}
+
+template<typename T>
+T random_value(std::true_type /* is_float */)
+{
+    std::uniform_real_distribution<double> d(-1000.0, 1000.0);
+    return (T)d(rng);
+}
+
+template<typename T>
+T random_value(std::false_type /* is_float */)
+{
+    T v;
+    uint64_t bits = ((uint64_t)rng() << 32) | rng();
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+// Trials cycle through: all random lanes, lanes mixed with edge values, small
+// values that make saturation / carries / rounding ties likely.
+template<typename T, size_t N>
+void fill(TxN<T, N>& v, size_t trial)
+{
+    typedef typename std::is_floating_point<T>::type is_float;
+    for (size_t i = 0; i < N; i++)
+    {
+        switch (trial % 3)
+        {
+        case 0:
+            v[i] = random_value<T>(is_float());
+            break;
+        case 1:
+            v[i] = (rng() & 1) ? edge_value<T>(rng(), is_float()) : random_value<T>(is_float());
+            break;
+        default:
+            v[i] = (T)((int)(rng() % 9) - (std::is_signed<T>::value ? 4 : 0));
+            break;
+        }
+    }
+}
+
+template<typename V>
+std::string to_string(const V& v)
+{
+    std::ostringstream os;
+    os << "{" << v << "}";
+    return os.str();
+}
+
+struct Entry
+{
+    const char* intrinsic;
+    size_t trials = 0;
+    size_t mismatches = 0;   // trials whose result bytes differ
+    CompareResult worst;     // lane statistics over all mismatching trials
+    std::string first_input;
+    std::string first_sim;
+    std::string first_sse;
+};
+
+template<typename R>
+void record(Entry& e, const R& sim, const R& sse, const std::string& input)
+{
+    e.trials++;
+    if (memcmp(&sim, &sse, sizeof(R)) == 0)
+    {
+        return;
+    }
+    if (e.mismatches++ == 0)
+    {
+        e.first_input = input;
+        e.first_sim = to_string(sim);
+        e.first_sse = to_string(sse);
+    }
+    const CompareResult res = compare_register(sim, sse, CompareTolerance(), 0);
+    e.worst.count += res.count;
+    e.worst.mismatches += res.mismatches;
+    e.worst.max_abs_error = std::max(e.worst.max_abs_error, res.max_abs_error);
+    e.worst.max_ulp_error = std::max(e.worst.max_ulp_error, res.max_ulp_error);
+}
+
+void print(const Entry& e, const char* params)
+{
+    if (e.mismatches == 0)
+    {
+        printf("#define %s(%s) neon_sim_fast_%s(%s)\n", e.intrinsic, params, e.intrinsic, params);
+        return;
+    }
+    printf("// %s: %zu/%zu trials differ, %zu lanes, max_abs_error = %g, max_ulp_error = %llu\n", e.intrinsic,
+           e.mismatches, e.trials, e.worst.mismatches, e.worst.max_abs_error,
+           (unsigned long long)e.worst.max_ulp_error);
+    printf("//   input %s\n//   sim   %s\n//   sse   %s\n", e.first_input.c_str(), e.first_sim.c_str(),
+           e.first_sse.c_str());
+}
+
+size_t g_trials = 2000;
+
+} // namespace
+
+#define NEON_SIM_SSE_1(name, R, A) \
+    { \
+        Entry e; \
+        e.intrinsic = #name; \
+        for (size_t t = 0; t < g_trials; t++) \
+        { \
+            A a; \
+            fill(a, t); \
+            record(e, R((name)(a)), R(neon_sim_fast_##name(a)), to_string(a)); \
+        } \
+        print(e, "a"); \
+    }
+
+#define NEON_SIM_SSE_2(name, R, A, B) \
+    { \
+        Entry e; \
+        e.intrinsic = #name; \
+        for (size_t t = 0; t < g_trials; t++) \
+        { \
+            A a; \
+            B b; \
+            fill(a, t); \
+            fill(b, t); \
+            record(e, R((name)(a, b)), R(neon_sim_fast_##name(a, b)), to_string(a) + " " + to_string(b)); \
+        } \
+        print(e, "a, b"); \
+    }
+
+#define NEON_SIM_SSE_3(name, R, A, B, C) \
+    { \
+        Entry e; \
+        e.intrinsic = #name; \
+        for (size_t t = 0; t < g_trials; t++) \
+        { \
+            A a; \
+            B b; \
+            C c; \
+            fill(a, t); \
+            fill(b, t); \
+            fill(c, t); \
+            record(e, R((name)(a, b, c)), R(neon_sim_fast_##name(a, b, c)), \
+                   to_string(a) + " " + to_string(b) + " " + to_string(c)); \
+        } \
+        print(e, "a, b, c"); \
+    }
+
+int main(int argc, char** argv)
+{
+    unsigned seed = 20240601;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--trials=", 9) == 0)
+        {
+            g_trials = (size_t)atol(argv[i] + 9);
+        }
+        else if (strncmp(argv[i], "--seed=", 7) == 0)
+        {
+            seed = (unsigned)atol(argv[i] + 7);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--trials=N] [--seed=S]\n", argv[0]);
+            return 2;
+        }
+    }
+    rng.seed(seed);
+
+    printf("//\n");
+    printf("// Generated by neon_sim_sse_table (%zu trials per intrinsic, seed %u); do not edit.\n", g_trials, seed);
+    printf("//\n");
+    printf("// With NEON_SIM_FAST_SSE, the intrinsics #defined below run through\n");
+    printf("// NEON_2_SSE.h: they gave the same result bytes as the sim on every\n");
+    printf("// trial. The commented ones differ and keep the sim implementation.\n");
+    printf("//\n\n");
+
+#include "neon_sim_sse.inc"
+
+    return 0;
+}
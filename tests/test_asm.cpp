@@ -0,0 +1,379 @@
+#include "test_util.hpp"
+#include "neon_sim_asm.hpp"
+
+#include <random>
+#include <string>
+
+namespace {
+
+template<typename V>
+static V random_register(std::mt19937& rng)
+{
+    V v;
+    for (size_t i = 0; i < sizeof(V); i++)
+    {
+        ((uint8_t*)&v)[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+template<typename V>
+static bool same_bytes(const V& expected, const V& actual)
+{
+    return memcmp((const void*)&expected, (const void*)&actual, sizeof(V)) == 0;
+}
+
+static AsmProgram assembled(const char* text)
+{
+    AsmProgram p;
+    if (!p.assemble(text))
+    {
+        std::cerr << p.error() << std::endl;
+    }
+    return p;
+}
+
+// `text` reads v1 (A) and v2 (B) and writes v0 (R), which starts out as `acc`
+template<typename R, typename A, typename B, typename F>
+static bool matches(const char* text, F intrinsic, std::mt19937& rng)
+{
+    const AsmProgram p = assembled(text);
+    if (!p.ok())
+    {
+        return false;
+    }
+    for (int t = 0; t < 64; t++)
+    {
+        const R acc = random_register<R>(rng);
+        const A a = random_register<A>(rng);
+        const B b = random_register<B>(rng);
+        AsmState s;
+        s.set_v(0, acc);
+        s.set_v(1, a);
+        s.set_v(2, b);
+        p.run(s);
+        if (!same_bytes(intrinsic(acc, a, b), s.get_v<R>(0)))
+        {
+            std::cerr << text << ": differs from the intrinsic" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// llvm-mc -triple=aarch64 -mattr=+neon -show-encoding of kMixedText
+const uint32_t kMixedWords[] = {
+    0x4cdfa800, 0x4c408422, 0x4f811804, 0x6e61dc05, 0x4e228406, 0x6e21c007,
+    0x0f532048, 0x0e614909, 0x4f1b8ce9, 0x2f0ba40a, 0x4f39042b, 0x4e43384c,
+    0x4e81580d, 0x4e01280e, 0x6e01280f, 0x4e022010, 0x4e600851, 0x4e1c0432,
+    0x4e020c73, 0x4e0c1c94, 0x6e1a3454, 0x0e133c05, 0x4e183c26, 0x4f0127f5,
+    0x6f05e4d6, 0x6f008657, 0x4eb1b818, 0x6e30a819, 0x6e30f83a, 0x7e30d83b,
+    0x4e21d85c, 0x4ea1b83d, 0x6e611c1e, 0x4ea01c1f, 0x6e63344a, 0x3dc00841,
+    0xfc237842, 0x2cc11043, 0xadbf1805, 0x39400c47, 0xf85fb048, 0x913ffd29,
+    0x4b0c0d6a, 0xf1000463, 0x92781d2b, 0x32000bec, 0xcac31d2d, 0xd2a2468e,
+    0xf297ddee, 0x9b03392f, 0x1ac30930, 0xd349fd31, 0x1ac32932, 0xf100007f,
+    0x4d40c420, 0x4d9f9001, 0x0c840000, 0xd28000b4, 0x4e2284c6, 0xf1000694,
+    0x54ffffc1, 0x34000043, 0xd503201f, 0xb7400029, 0x14000001, 0xd65f03c0,
+};
+
+const char* const kMixedText =
+    "    ld1 {v0.4s, v1.4s}, [x0], #32\n"
+    "    ld2 {v2.8h, v3.8h}, [x1]\n"
+    "    fmla v4.4s, v0.4s, v1.s[2]\n"
+    "    fmul v5.2d, v0.2d, v1.2d\n"
+    "    add v6.16b, v0.16b, v2.16b\n"
+    "    umull2 v7.8h, v0.16b, v1.16b\n"
+    "    smlal v8.4s, v2.4h, v3.h[1]\n"
+    "    sqxtn v9.4h, v8.4s\n"
+    "    rshrn2 v9.8h, v7.4s, #5\n"
+    "    ushll v10.8h, v0.8b, #3\n"
+    "    sshr v11.4s, v1.4s, #7\n"
+    "    zip1 v12.8h, v2.8h, v3.8h\n"
+    "    uzp2 v13.4s, v0.4s, v1.4s\n"
+    "    trn1 v14.16b, v0.16b, v1.16b\n"
+    "    ext v15.16b, v0.16b, v1.16b, #5\n"
+    "    tbl v16.16b, {v0.16b, v1.16b}, v2.16b\n"
+    "    rev64 v17.8h, v2.8h\n"
+    "    dup v18.4s, v1.s[3]\n"
+    "    dup v19.8h, w3\n"
+    "    mov v20.s[1], w4\n"
+    "    mov v20.h[6], v2.h[3]\n"
+    "    umov w5, v0.b[9]\n"
+    "    mov x6, v1.d[1]\n"
+    "    movi v21.4s, #0x3f, lsl #8\n"
+    "    movi v22.2d, #0xff00ff0000ffff00\n"
+    "    mvni v23.8h, #0x12\n"
+    "    addv s24, v0.4s\n"
+    "    umaxv b25, v0.16b\n"
+    "    fmaxv s26, v1.4s\n"
+    "    faddp s27, v1.2s\n"
+    "    scvtf v28.4s, v2.4s\n"
+    "    fcvtzs v29.4s, v1.4s\n"
+    "    bsl v30.16b, v0.16b, v1.16b\n"
+    "    mov v31.16b, v0.16b\n"
+    "    cmhi v10.8h, v2.8h, v3.8h\n"
+    "    ldr q1, [x2, #32]\n"
+    "    str d2, [x2, x3, lsl #3]\n"
+    "    ldp s3, s4, [x2], #8\n"
+    "    stp q5, q6, [x0, #-32]!\n"
+    "    ldrb w7, [x2, #3]\n"
+    "    ldur x8, [x2, #-5]\n"
+    "    add x9, x9, #4095\n"
+    "    sub w10, w11, w12, lsl #3\n"
+    "    subs x3, x3, #1\n"
+    "    and x11, x9, #0xff00\n"
+    "    orr w12, wzr, #0x7\n"
+    "    eor x13, x9, x3, ror #7\n"
+    "    movz x14, #0x1234, lsl #16\n"
+    "    movk x14, #0xbeef\n"
+    "    madd x15, x9, x3, x14\n"
+    "    udiv w16, w9, w3\n"
+    "    lsr x17, x9, #9\n"
+    "    asr w18, w9, w3\n"
+    "    cmp x3, #0\n"
+    "    ld1r {v0.8h}, [x1]\n"
+    "    st1 {v1.s}[3], [x0], #4\n"
+    "    st4 {v0.8b, v1.8b, v2.8b, v3.8b}, [x0], x4\n"
+    "    movz x20, #5\n"
+    "2:  add v6.16b, v6.16b, v2.16b\n"
+    "    subs x20, x20, #1\n"
+    "    b.ne 2b\n"
+    "    cbz w3, 3f\n"
+    "    nop\n"
+    "3:  tbnz x9, #40, 4f\n"
+    "4:  b 5f\n"
+    "5:  ret\n";
+
+} // namespace
+
+TEST(asm, vector_ops_match_intrinsics)
+{
+    std::mt19937 rng(60);
+    EXPECT_TRUE((matches<uint8x16_t, uint8x16_t, uint8x16_t>(
+        "add v0.16b, v1.16b, v2.16b", [](uint8x16_t, uint8x16_t a, uint8x16_t b) { return vaddq_u8(a, b); }, rng)));
+    EXPECT_TRUE((matches<int16x8_t, int16x8_t, int16x8_t>(
+        "sqsub v0.8h, v1.8h, v2.8h", [](int16x8_t, int16x8_t a, int16x8_t b) { return vqsubq_s16(a, b); }, rng)));
+    EXPECT_TRUE((matches<uint8x16_t, uint8x16_t, uint8x16_t>(
+        "cmhi v0.16b, v1.16b, v2.16b", [](uint8x16_t, uint8x16_t a, uint8x16_t b) { return vcgtq_u8(a, b); }, rng)));
+    EXPECT_TRUE((matches<uint8x16_t, uint8x16_t, uint8x16_t>(
+        "bsl v0.16b, v1.16b, v2.16b", [](uint8x16_t m, uint8x16_t a, uint8x16_t b) { return vbslq_u8(m, a, b); }, rng)));
+    EXPECT_TRUE((matches<uint16x8_t, uint8x8_t, uint8x8_t>(
+        "umlal v0.8h, v1.8b, v2.8b", [](uint16x8_t acc, uint8x8_t a, uint8x8_t b) { return vmlal_u8(acc, a, b); }, rng)));
+    EXPECT_TRUE((matches<int32x4_t, int16x4_t, int16x4_t>(
+        "smull v0.4s, v1.4h, v2.4h", [](int32x4_t, int16x4_t a, int16x4_t b) { return vmull_s16(a, b); }, rng)));
+    EXPECT_TRUE((matches<uint8x8_t, uint16x8_t, uint8x8_t>(
+        "shrn v0.8b, v1.8h, #3", [](uint8x8_t, uint16x8_t a, uint8x8_t) { return vshrn_n_u16(a, 3); }, rng)));
+    EXPECT_TRUE((matches<uint8x8_t, uint16x8_t, uint8x8_t>(
+        "uqxtn v0.8b, v1.8h", [](uint8x8_t, uint16x8_t a, uint8x8_t) { return vqmovn_u16(a); }, rng)));
+    EXPECT_TRUE((matches<uint16x4_t, uint32x4_t, uint8x8_t>(
+        "xtn v0.4h, v1.4s", [](uint16x4_t, uint32x4_t a, uint8x8_t) { return vmovn_u32(a); }, rng)));
+    EXPECT_TRUE((matches<uint16x8_t, uint16x8_t, uint8x8_t>(
+        "urshr v0.8h, v1.8h, #5", [](uint16x8_t, uint16x8_t a, uint8x8_t) { return vrshrq_n_u16(a, 5); }, rng)));
+    EXPECT_TRUE((matches<uint16x8_t, uint8x8_t, uint8x8_t>(
+        "ushll v0.8h, v1.8b, #2", [](uint16x8_t, uint8x8_t a, uint8x8_t) { return vshll_n_u8(a, 2); }, rng)));
+    EXPECT_TRUE((matches<uint16x8_t, uint16x8_t, uint16x8_t>(
+        "trn2 v0.8h, v1.8h, v2.8h", [](uint16x8_t, uint16x8_t a, uint16x8_t b) { return vtrnq_u16(a, b).val[1]; }, rng)));
+    EXPECT_TRUE((matches<uint8x16_t, uint8x16_t, uint8x16_t>(
+        "umax v0.16b, v1.16b, v2.16b", [](uint8x16_t, uint8x16_t a, uint8x16_t b) { return vmaxq_u8(a, b); }, rng)));
+}
+
+TEST(asm, float_and_lane_ops)
+{
+    AsmState s;
+    const float32x4_t acc = { 1.0f, 2.0f, 3.0f, 4.0f };
+    const float32x4_t a = { 0.5f, -1.0f, 2.0f, 8.0f };
+    const float32x4_t b = { 10.0f, 100.0f, -1.0f, 0.25f };
+    s.set_v(0, acc);
+    s.set_v(1, a);
+    s.set_v(2, b);
+    const AsmProgram p = assembled("fmla v0.4s, v1.4s, v2.s[1]\n"
+                                   "fcvtzs v3.4s, v0.4s\n"
+                                   "addv s4, v3.4s\n"
+                                   "umov w5, v4.s[0]\n"
+                                   "fmaxv s6, v0.4s\n"
+                                   "dup v7.4s, v0.s[3]\n"
+                                   "ext v8.16b, v1.16b, v2.16b, #4");
+    EXPECT_TRUE(p.ok());
+    p.run(s);
+    const float32x4_t expected = { 51.0f, -98.0f, 203.0f, 804.0f };
+    EXPECT_TRUE(almostEqual(expected, s.get_v<float32x4_t>(0)));
+    EXPECT_EQ(s.x[5], (uint64_t)(51 - 98 + 203 + 804));
+    EXPECT_EQ(s.get_v<float32x4_t>(6)[0], 804.0f);
+    EXPECT_EQ(s.get_v<float32x4_t>(6)[1], 0.0f);
+    EXPECT_EQ(s.get_v<float32x4_t>(7)[2], 804.0f);
+    const float32x4_t shifted = { -1.0f, 2.0f, 8.0f, 10.0f };
+    EXPECT_TRUE(almostEqual(shifted, s.get_v<float32x4_t>(8)));
+}
+
+TEST(asm, loads_stores_and_flags)
+{
+    uint16_t src[16];
+    for (int i = 0; i < 16; i++)
+    {
+        src[i] = (uint16_t)(i * 3);
+    }
+    uint16_t dst[16] = { 0 };
+    AsmState s;
+    s.x[0] = (uint64_t)(uintptr_t)src;
+    s.x[1] = (uint64_t)(uintptr_t)dst;
+    const AsmProgram p = assembled("ld2 {v0.8h, v1.8h}, [x0], #32  // deinterleave\n"
+                                   "st1 {v1.8h}, [x1], #16; st1 {v0.8h}, [x1]\n"
+                                   "ldrh w2, [x0, #-2]\n"
+                                   "mov x3, #7\n"
+                                   "cmp x3, x2\n"
+                                   "b.hi done\n"
+                                   "mov x4, #1\n"
+                                   "done:");
+    EXPECT_TRUE(p.ok());
+    p.run(s);
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(dst[i], src[2 * i + 1]);
+        EXPECT_EQ(dst[8 + i], src[2 * i]);
+    }
+    EXPECT_EQ(s.x[0], (uint64_t)(uintptr_t)(src + 16));
+    EXPECT_EQ(s.x[2], 45u);
+    // 7 - 45 borrows: C clear, N set, b.hi not taken
+    EXPECT_FALSE(s.flag_c);
+    EXPECT_TRUE(s.flag_n);
+    EXPECT_EQ(s.x[4], 1u);
+}
+
+TEST(asm, ncnn_style_loop)
+{
+    // y[i] = y[i] + x[i] * k, four floats per iteration, like an ncnn inner loop
+    const int n = 37;
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+    std::vector<float> expected(n);
+    std::mt19937 rng(600);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = dist(rng);
+        y[i] = dist(rng);
+    }
+    const float k = 1.75f;
+    for (int i = 0; i < n; i++)
+    {
+        expected[i] = std::fma(x[i], k, y[i]);
+    }
+
+    const float* px = x.data();
+    float* py = y.data();
+    int nn = n / 4;
+    const float32x4_t vk = vdupq_n_f32(k);
+    neon_sim_asm("0:                              \n"
+                 "prfm   pldl1keep, [%0, #128]    \n"
+                 "ld1    {v0.4s}, [%0], #16       \n"
+                 "ld1    {v1.4s}, [%1]            \n"
+                 "fmla   v1.4s, v0.4s, %3.s[0]    \n"
+                 "st1    {v1.4s}, [%1], #16       \n"
+                 "subs   %w2, %w2, #1             \n"
+                 "bne    0b                       \n",
+                 { asm_inout(px), asm_inout(py), asm_inout(nn), asm_in(vk) });
+    for (int i = n / 4 * 4; i < n; i++)
+    {
+        *py++ = std::fma(*px++, k, y[i]);
+    }
+    EXPECT_EQ(nn, 0);
+    EXPECT_TRUE(px == x.data() + n);
+    EXPECT_EQ(memcmp(expected.data(), y.data(), n * sizeof(float)), 0);
+}
+
+TEST(asm, blocks_are_decoded_once)
+{
+    const AsmCacheStats before = asm_cache_stats();
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        const uint32x4_t step = vdupq_n_u32(i);
+        neon_sim_asm("add %0.4s, %0.4s, %1.4s", { asm_inout(acc), asm_in(step) });
+    }
+    const AsmCacheStats after = asm_cache_stats();
+    EXPECT_EQ(after.lookups - before.lookups, 10u);
+    EXPECT_EQ(after.decodes - before.decodes, 1u);
+    EXPECT_EQ(vgetq_lane_u32(acc, 3), 45u);
+}
+
+TEST(asm, decoded_words_match_text)
+{
+    AsmProgram from_words;
+    AsmProgram from_text;
+    EXPECT_TRUE(from_words.decode(kMixedWords, sizeof(kMixedWords) / sizeof(kMixedWords[0])));
+    EXPECT_TRUE(from_text.assemble(kMixedText));
+    EXPECT_EQ(from_words.size(), from_text.size());
+    if (!from_words.ok() || !from_text.ok())
+    {
+        std::cerr << from_words.error() << from_text.error() << std::endl;
+        return;
+    }
+
+    std::mt19937 rng(6060);
+    for (int t = 0; t < 20; t++)
+    {
+        std::vector<uint8_t> memory(3 * 1024);
+        for (size_t i = 0; i < memory.size(); i++)
+        {
+            memory[i] = (uint8_t)rng();
+        }
+        AsmState init;
+        for (int r = 0; r < 32; r++)
+        {
+            init.set_v(r, random_register<uint8x16_t>(rng));
+            init.x[r] = ((uint64_t)rng() << 32) | rng();
+        }
+        for (int r = 0; r < 3; r++)
+        {
+            init.x[r] = (uint64_t)(uintptr_t)(memory.data() + 512 + 1024 * r);
+        }
+        init.x[3] = rng() % 8;
+        init.x[4] = 32;
+
+        std::vector<uint8_t> memory_text = memory;
+        AsmState s_words = init;
+        from_words.run(s_words);
+        std::vector<uint8_t> memory_words = memory;
+        for (int r = 0; r < 3; r++)
+        {
+            init.x[r] = (uint64_t)(uintptr_t)(memory_text.data() + 512 + 1024 * r);
+        }
+        AsmState s_text = init;
+        from_text.run(s_text);
+
+        EXPECT_EQ(memcmp(s_words.v, s_text.v, sizeof(s_words.v)), 0);
+        for (int r = 3; r < 32; r++)
+        {
+            EXPECT_EQ(s_words.x[r], s_text.x[r]);
+        }
+        EXPECT_TRUE(memory_words == memory_text);
+    }
+}
+
+TEST(asm, disassemble_round_trip)
+{
+    EXPECT_TRUE(asm_disassemble(0x4cdf7000) == "ld1 {v0.16b}, [x0], #16");
+    EXPECT_TRUE(asm_disassemble(0x4fa21020) == "fmla v0.4s, v1.4s, v2.s[1]");
+    EXPECT_TRUE(asm_disassemble(0xf1000442) == "subs x2, x2, #1");
+    EXPECT_TRUE(asm_disassemble(0x54ffffc1) == "b.ne #-8");
+    // crc32b: not in the supported subset
+    EXPECT_TRUE(asm_disassemble(0x1ac24020).empty());
+}
+
+TEST(asm, errors)
+{
+    AsmProgram p;
+    EXPECT_FALSE(p.assemble("add v0.4s, v1.4s, v2.4s\nfrobnicate v0.4s, v1.4s"));
+    EXPECT_TRUE(p.error() == "line 2: unsupported instruction 'frobnicate' in 'frobnicate v0.4s, v1.4s'");
+    EXPECT_FALSE(p.ok());
+
+    EXPECT_FALSE(p.assemble("add v0.4s, v1.4s, v2.8h"));
+    EXPECT_TRUE(p.error().find("line 1") == 0);
+
+    EXPECT_FALSE(p.assemble("b.ne 1b"));
+    EXPECT_TRUE(p.error() == "line 1: undefined label '1b'");
+
+    const uint32_t crc[] = { 0xd503201f, 0x1ac24020 };
+    EXPECT_FALSE(p.decode(crc, 2));
+    EXPECT_TRUE(p.error() == "word 1 (0x1ac24020): unsupported instruction");
+}
@@ -0,0 +1,179 @@
+#include "test_util.hpp"
+#include "neon_sim_audio.hpp"
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+// a windowed-sinc-like low pass with a gain above one, so long sums saturate
+std::vector<int16_t> lowpass_taps(int n)
+{
+    std::vector<int16_t> taps(n);
+    for (int i = 0; i < n; i++)
+    {
+        const int d = 2 * i - (n - 1);
+        taps[i] = (int16_t)(24000 / (1 + d * d / 8));
+    }
+    return taps;
+}
+
+} // namespace
+
+TEST(audio, fir_resample_matches_ref)
+{
+    const int ratios[][2] = { { 1, 1 }, { 3, 2 }, { 2, 3 }, { 160, 147 }, { 1, 4 } };
+    const int lengths[] = { 1, 7, 8, 9, 31, 64 };
+    for (const auto& r : ratios)
+    {
+        for (int len : lengths)
+        {
+            const std::vector<int16_t> taps = lowpass_taps(len * r[0]);
+            const audio::PolyphaseQ15 f = audio::make_polyphase_q15(taps.data(), (int)taps.size(), r[0], r[1]);
+            EXPECT_EQ(f.taps_per_phase % 8, 0);
+            const size_t hist = audio::polyphase_history(f);
+            const size_t n = 301;
+            const std::vector<int16_t> in = random_with_rails<int16_t>(hist + n, len, 16);
+            const size_t out_n = audio::resample_output_size(f, n);
+            std::vector<int16_t> expected(out_n), actual(out_n);
+            EXPECT_EQ(audio::ref::fir_resample_q15(f, in.data() + hist, n, expected.data()), out_n);
+            EXPECT_EQ(audio::fir_resample_q15(f, in.data() + hist, n, actual.data()), out_n);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+}
+
+TEST(audio, fir_impulse_response)
+{
+    // x = 0.5 at t = 0: y[k] = round(h[k] / 2), rounding half up
+    const int16_t taps[5] = { 1001, -3, 20000, -32768, 7 };
+    const audio::PolyphaseQ15 f = audio::make_polyphase_q15(taps, 5, 1, 1);
+    const size_t hist = audio::polyphase_history(f);
+    std::vector<int16_t> in(hist + 8, 0);
+    in[hist] = 16384;
+    std::vector<int16_t> out(8);
+    EXPECT_EQ(audio::fir_resample_q15(f, in.data() + hist, 8, out.data()), (size_t)8);
+    const int16_t expected[8] = { 501, -1, 10000, -16384, 4, 0, 0, 0 };
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(out[i], expected[i]);
+    }
+}
+
+TEST(audio, fir_resample_streams_in_blocks)
+{
+    // blocks that are multiples of `down` give the same output as one call
+    const std::vector<int16_t> taps = lowpass_taps(48);
+    const audio::PolyphaseQ15 f = audio::make_polyphase_q15(taps.data(), (int)taps.size(), 3, 2);
+    const size_t hist = audio::polyphase_history(f);
+    const std::vector<int16_t> in = random_with_rails<int16_t>(hist + 200, 7, 16);
+    std::vector<int16_t> whole(audio::resample_output_size(f, 200));
+    audio::fir_resample_q15(f, in.data() + hist, 200, whole.data());
+
+    std::vector<int16_t> blocks(whole.size());
+    size_t written = 0;
+    for (size_t pos = 0; pos < 200; pos += 50)
+    {
+        written += audio::fir_resample_q15(f, in.data() + hist + pos, 50, blocks.data() + written);
+    }
+    EXPECT_EQ(written, whole.size());
+    EXPECT_TRUE(same(whole, blocks));
+}
+
+TEST(audio, biquad_q15_matches_ref)
+{
+    const audio::BiquadQ15 stages[3] = {
+        { 4096, 8192, 4096, -23170, 9830 },   // low pass
+        { 15000, -30000, 15000, -29000, 13500 },
+        { 32767, -32768, 32767, 32767, -32768 }, // extreme, saturates
+    };
+    const int channels[] = { 1, 2, 3, 4, 5, 8 };
+    for (int ch : channels)
+    {
+        for (int num_stages = 1; num_stages <= 3; num_stages++)
+        {
+            const size_t frames = 157;
+            const std::vector<int16_t> in = random_with_rails<int16_t>(frames * ch, ch * 10 + num_stages, 16);
+            std::vector<int16_t> state_ref(audio::biquad_state_size(num_stages, ch), 0);
+            std::vector<int16_t> state(state_ref.size(), 0);
+            std::vector<int16_t> expected(in.size()), actual(in.size());
+            audio::ref::biquad_cascade_q15(stages, num_stages, state_ref.data(), in.data(), expected.data(), frames, ch);
+            // two calls, the second in place, to carry the state over
+            audio::biquad_cascade_q15(stages, num_stages, state.data(), in.data(), actual.data(), 100, ch);
+            std::copy(in.begin() + 100 * ch, in.end(), actual.begin() + 100 * ch);
+            audio::biquad_cascade_q15(stages, num_stages, state.data(), actual.data() + 100 * ch,
+                                      actual.data() + 100 * ch, frames - 100, ch);
+            EXPECT_TRUE(same(expected, actual));
+            EXPECT_TRUE(same(state_ref, state));
+        }
+    }
+}
+
+TEST(audio, biquad_q31_matches_ref)
+{
+    const audio::BiquadQ31 stages[2] = {
+        { 268435456, 536870912, 268435456, -1518500250, 644245094 },
+        { 2147483647, INT32_MIN, 2147483647, 2147483647, INT32_MIN },
+    };
+    const int channels[] = { 1, 2, 3, 4, 6 };
+    for (int ch : channels)
+    {
+        for (int num_stages = 1; num_stages <= 2; num_stages++)
+        {
+            const size_t frames = 93;
+            const std::vector<int32_t> in = random_with_rails<int32_t>(frames * ch, ch + 100 * num_stages, 16);
+            std::vector<int32_t> state_ref(audio::biquad_state_size(num_stages, ch), 0);
+            std::vector<int32_t> state(state_ref.size(), 0);
+            std::vector<int32_t> expected(in.size()), actual(in.size());
+            audio::ref::biquad_cascade_q31(stages, num_stages, state_ref.data(), in.data(), expected.data(), frames, ch);
+            audio::biquad_cascade_q31(stages, num_stages, state.data(), in.data(), actual.data(), frames, ch);
+            EXPECT_TRUE(same(expected, actual));
+            EXPECT_TRUE(same(state_ref, state));
+        }
+    }
+}
+
+TEST(audio, biquad_unity_passes_through)
+{
+    // b0 = 1.0 is exact in both formats
+    const audio::BiquadQ15 q15 = { 16384, 0, 0, 0, 0 };
+    const audio::BiquadQ31 q31 = { 1 << 30, 0, 0, 0, 0 };
+    const std::vector<int16_t> in16 = random_with_rails<int16_t>(64, 1, 16);
+    const std::vector<int32_t> in32 = random_with_rails<int32_t>(64, 2, 16);
+    std::vector<int16_t> state16(audio::biquad_state_size(1, 2), 0), out16(64);
+    std::vector<int32_t> state32(audio::biquad_state_size(1, 2), 0), out32(64);
+    audio::biquad_cascade_q15(&q15, 1, state16.data(), in16.data(), out16.data(), 32, 2);
+    audio::biquad_cascade_q31(&q31, 1, state32.data(), in32.data(), out32.data(), 32, 2);
+    EXPECT_TRUE(same(in16, out16));
+    EXPECT_TRUE(same(in32, out32));
+}
+
+TEST(audio, mix_q15)
+{
+    const std::vector<int16_t> a = random_with_rails<int16_t>(77, 1, 16);
+    const std::vector<int16_t> b = random_with_rails<int16_t>(77, 2, 16);
+    const std::vector<int16_t> c = random_with_rails<int16_t>(77, 3, 16);
+    const int16_t* srcs[3] = { a.data(), b.data(), c.data() };
+    const int16_t gains[3] = { 32767, -32768, 9000 };
+    for (int num_srcs = 0; num_srcs <= 3; num_srcs++)
+    {
+        for (size_t n : { (size_t)1, (size_t)8, (size_t)15, (size_t)77 })
+        {
+            std::vector<int16_t> expected(n, 123), actual(n, 123);
+            audio::ref::mix_q15(srcs, gains, num_srcs, expected.data(), n);
+            audio::mix_q15(srcs, gains, num_srcs, actual.data(), n);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+
+    // rails: sqrdmulh(-1, -1) and the running sum saturate
+    const int16_t lo[8] = { -32768, -32768, 32767, 32767, 100, -100, 0, 1 };
+    const int16_t* rails[2] = { lo, lo };
+    const int16_t rail_gains[2] = { -32768, -32768 };
+    int16_t out[8];
+    audio::mix_q15(rails, rail_gains, 2, out, 8);
+    const int16_t expected[8] = { 32767, 32767, -32768, -32768, -200, 200, 0, -2 };
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(out[i], expected[i]);
+    }
+}
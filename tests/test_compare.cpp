@@ -1,5 +1,7 @@
 #include "test_util.hpp"
 
+#include <limits>
+
 TEST(vcltq, f32)
 {
     float32x4_t v1 = { 1.0, 0.0, 1.0, 0.0 };
@@ -10,4 +12,24 @@ TEST(vcltq, f32)
     float32x4_t actual = vbslq_f32(mask, ones, twos);  // will select first if mask 0, second if mask 1
     float32x4_t expected = { 20.0, 10.0, 20.0, 20.0 };
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vcgtq, f32_all_conditions)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    float32x4_t a = { 1.0f, 2.0f, -0.0f, nan };
+    float32x4_t b = { 2.0f, 2.0f, 0.0f, 1.0f };
+    uint32x4_t gt = vcgtq_f32(a, b), ge = vcgeq_f32(a, b), le = vcleq_f32(a, b), eq = vceqq_f32(a, b);
+    // -0 == +0; every comparison with a NaN is false
+    const uint32_t expected_gt[4] = { 0, 0, 0, 0 };
+    const uint32_t expected_ge[4] = { 0, 0xffffffffu, 0xffffffffu, 0 };
+    const uint32_t expected_le[4] = { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0 };
+    const uint32_t expected_eq[4] = { 0, 0xffffffffu, 0xffffffffu, 0 };
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(gt[i], expected_gt[i]);
+        EXPECT_EQ(ge[i], expected_ge[i]);
+        EXPECT_EQ(le[i], expected_le[i]);
+        EXPECT_EQ(eq[i], expected_eq[i]);
+    }
+    EXPECT_EQ(vcgtq_f32(b, a)[0], 0xffffffffu);
+}
@@ -0,0 +1,60 @@
+#include "test_util.hpp"
+#include "arm_acle_sim.hpp"
+
+#include <random>
+
+namespace {
+
+// bit-serial reflected CRC, independent of the intrinsics' tables
+uint32_t crc_bitwise(uint32_t poly, uint32_t crc, uint64_t data, int bits)
+{
+    for (int i = 0; i < bits; i++)
+    {
+        const uint32_t bit = (crc ^ (uint32_t)(data >> i)) & 1;
+        crc = (crc >> 1) ^ (bit ? poly : 0);
+    }
+    return crc;
+}
+
+const uint32_t kCrc32Poly = 0xedb88320u;
+const uint32_t kCrc32cPoly = 0x82f63b78u;
+
+} // namespace
+
+TEST(crc32, check_values)
+{
+    // the standard "123456789" check: initial value and final xor all ones
+    const char* msg = "123456789";
+    uint32_t crc = 0xffffffffu, crcc = 0xffffffffu;
+    for (const char* p = msg; *p; p++)
+    {
+        crc = __crc32b(crc, (uint8_t)*p);
+        crcc = __crc32cb(crcc, (uint8_t)*p);
+    }
+    EXPECT_EQ(~crc, 0xcbf43926u);
+    EXPECT_EQ(~crcc, 0xe3069283u);
+
+    // the wide forms take the bytes little-endian
+    uint64_t d = 0;
+    memcpy(&d, msg, 8);
+    EXPECT_EQ(~__crc32b(__crc32d(0xffffffffu, d), '9'), 0xcbf43926u);
+    EXPECT_EQ(~__crc32cb(__crc32cd(0xffffffffu, d), '9'), 0xe3069283u);
+}
+
+TEST(crc32, matches_bitwise)
+{
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 1000; i++)
+    {
+        const uint32_t a = (uint32_t)rng();
+        const uint64_t d = rng();
+        EXPECT_EQ(__crc32b(a, (uint8_t)d), crc_bitwise(kCrc32Poly, a, d, 8));
+        EXPECT_EQ(__crc32h(a, (uint16_t)d), crc_bitwise(kCrc32Poly, a, d, 16));
+        EXPECT_EQ(__crc32w(a, (uint32_t)d), crc_bitwise(kCrc32Poly, a, d, 32));
+        EXPECT_EQ(__crc32d(a, d), crc_bitwise(kCrc32Poly, a, d, 64));
+        EXPECT_EQ(__crc32cb(a, (uint8_t)d), crc_bitwise(kCrc32cPoly, a, d, 8));
+        EXPECT_EQ(__crc32ch(a, (uint16_t)d), crc_bitwise(kCrc32cPoly, a, d, 16));
+        EXPECT_EQ(__crc32cw(a, (uint32_t)d), crc_bitwise(kCrc32cPoly, a, d, 32));
+        EXPECT_EQ(__crc32cd(a, d), crc_bitwise(kCrc32cPoly, a, d, 64));
+    }
+}
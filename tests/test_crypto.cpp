@@ -0,0 +1,205 @@
+#include "test_util.hpp"
+
+#include <string.h>
+
+namespace {
+
+void expand_key_128(const uint8_t key[16], uint8x16_t rk[11])
+{
+    static const uint8_t rcon[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+    uint32_t w[44];
+    memcpy(w, key, 16);
+    for (int i = 4; i < 44; i++)
+    {
+        uint32_t t = w[i - 1];
+        if (i % 4 == 0)
+        {
+            // SubWord through AESE with a zero key: ShiftRows only moves bytes between equal lanes
+            const uint8x16_t s = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(t)), vdupq_n_u8(0));
+            t = vgetq_lane_u32(vreinterpretq_u32_u8(s), 0);
+            t = ((t >> 8) | (t << 24)) ^ rcon[i / 4 - 1];
+        }
+        w[i] = w[i - 4] ^ t;
+    }
+    for (int i = 0; i < 11; i++)
+    {
+        rk[i] = vld1q_u8((const uint8_t*)(w + 4 * i));
+    }
+}
+
+uint8x16_t aes128_encrypt(uint8x16_t s, const uint8x16_t rk[11])
+{
+    for (int i = 0; i < 9; i++)
+    {
+        s = vaesmcq_u8(vaeseq_u8(s, rk[i]));
+    }
+    return veorq_u8(vaeseq_u8(s, rk[9]), rk[10]);
+}
+
+// equivalent inverse cipher: the middle round keys go through InvMixColumns
+uint8x16_t aes128_decrypt(uint8x16_t s, const uint8x16_t rk[11])
+{
+    s = vaesimcq_u8(vaesdq_u8(s, rk[10]));
+    for (int i = 9; i > 1; i--)
+    {
+        s = vaesimcq_u8(vaesdq_u8(s, vaesimcq_u8(rk[i])));
+    }
+    return veorq_u8(vaesdq_u8(s, vaesimcq_u8(rk[1])), rk[0]);
+}
+
+uint32x4_t load_be32x4(const uint8_t* p)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+void sha256_block(uint32_t state[8], const uint8_t block[64])
+{
+    static const uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+    const uint32x4_t abcd0 = abcd, efgh0 = efgh;
+    uint32x4_t w[4];
+    for (int i = 0; i < 4; i++)
+    {
+        w[i] = load_be32x4(block + 16 * i);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        const uint32x4_t wk = vaddq_u32(w[i % 4], vld1q_u32(k + 4 * i));
+        if (i < 12)
+        {
+            w[i % 4] = vsha256su1q_u32(vsha256su0q_u32(w[i % 4], w[(i + 1) % 4]), w[(i + 2) % 4], w[(i + 3) % 4]);
+        }
+        const uint32x4_t abcd_in = abcd;
+        abcd = vsha256hq_u32(abcd, efgh, wk);
+        efgh = vsha256h2q_u32(efgh, abcd_in, wk);
+    }
+    vst1q_u32(state, vaddq_u32(abcd, abcd0));
+    vst1q_u32(state + 4, vaddq_u32(efgh, efgh0));
+}
+
+void sha1_block(uint32_t state[5], const uint8_t block[64])
+{
+    static const uint32_t k[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32_t e = state[4];
+    const uint32x4_t abcd0 = abcd;
+    const uint32_t e0 = e;
+    uint32x4_t w[4];
+    for (int i = 0; i < 4; i++)
+    {
+        w[i] = load_be32x4(block + 16 * i);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        const uint32x4_t wk = vaddq_u32(w[i % 4], vdupq_n_u32(k[i / 5]));
+        const uint32_t e_next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+        if (i < 5)
+        {
+            abcd = vsha1cq_u32(abcd, e, wk);
+        }
+        else if (i < 10 || i >= 15)
+        {
+            abcd = vsha1pq_u32(abcd, e, wk);
+        }
+        else
+        {
+            abcd = vsha1mq_u32(abcd, e, wk);
+        }
+        e = e_next;
+        if (i < 16)
+        {
+            w[i % 4] = vsha1su1q_u32(vsha1su0q_u32(w[i % 4], w[(i + 1) % 4], w[(i + 2) % 4]), w[(i + 3) % 4]);
+        }
+    }
+    vst1q_u32(state, vaddq_u32(abcd, abcd0));
+    state[4] = e + e0;
+}
+
+// one padded block holding "abc"
+void abc_block(uint8_t block[64])
+{
+    memset(block, 0, 64);
+    memcpy(block, "abc", 3);
+    block[3] = 0x80;
+    block[63] = 24;
+}
+
+} // namespace
+
+TEST(crypto, aes128_fips197)
+{
+    uint8_t key[16], pt[16];
+    for (int i = 0; i < 16; i++)
+    {
+        key[i] = (uint8_t)i;
+        pt[i] = (uint8_t)(i * 0x11);
+    }
+    const uint8_t expected[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                   0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+    uint8x16_t rk[11];
+    expand_key_128(key, rk);
+    const uint8x16_t ct = aes128_encrypt(vld1q_u8(pt), rk);
+    EXPECT_TRUE(almostEqual(vld1q_u8(expected), ct));
+    EXPECT_TRUE(almostEqual(vld1q_u8(pt), aes128_decrypt(ct, rk)));
+}
+
+TEST(crypto, aes_steps_are_inverse)
+{
+    uint8_t bytes[16];
+    for (int i = 0; i < 16; i++)
+    {
+        bytes[i] = (uint8_t)(i * 37 + 5);
+    }
+    const uint8x16_t x = vld1q_u8(bytes);
+    const uint8x16_t k = vdupq_n_u8(0x5c);
+    EXPECT_TRUE(almostEqual(x, vaesimcq_u8(vaesmcq_u8(x))));
+    // AESD undoes AESE once the key is added back
+    EXPECT_TRUE(almostEqual(x, veorq_u8(vaesdq_u8(vaeseq_u8(x, k), vdupq_n_u8(0)), k)));
+
+    // FIPS-197 MixColumns example column db 13 53 45 -> 8e 4d a1 bc
+    const uint8_t col[16] = { 0xdb, 0x13, 0x53, 0x45 };
+    const uint8x16_t mc = vaesmcq_u8(vld1q_u8(col));
+    EXPECT_EQ(vgetq_lane_u8(mc, 0), 0x8e);
+    EXPECT_EQ(vgetq_lane_u8(mc, 1), 0x4d);
+    EXPECT_EQ(vgetq_lane_u8(mc, 2), 0xa1);
+    EXPECT_EQ(vgetq_lane_u8(mc, 3), 0xbc);
+}
+
+TEST(crypto, sha256_abc)
+{
+    uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    uint8_t block[64];
+    abc_block(block);
+    sha256_block(state, block);
+    const uint32_t expected[8] = { 0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223,
+                                   0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad };
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(state[i], expected[i]);
+    }
+}
+
+TEST(crypto, sha1_abc)
+{
+    uint32_t state[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+    uint8_t block[64];
+    abc_block(block);
+    sha1_block(state, block);
+    const uint32_t expected[5] = { 0xa9993e36, 0x4706816a, 0xba3e2571, 0x7850c26c, 0x9cd0d89d };
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(state[i], expected[i]);
+    }
+    EXPECT_EQ(vsha1h_u32(0x80000001u), 0x60000000u);
+}
@@ -0,0 +1,188 @@
+#include "test_util.hpp"
+#include "neon_sim_filter.hpp"
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+// widths around the 8 and 16 pixel vectors, narrower than some kernels
+const int kShapes[][2] = { { 1, 1 }, { 2, 5 }, { 7, 3 }, { 16, 9 }, { 17, 16 }, { 33, 4 }, { 40, 21 } };
+const filter::Border kBorders[] = { filter::BORDER_REPLICATE, filter::BORDER_REFLECT_101, filter::BORDER_CONSTANT };
+
+} // namespace
+
+TEST(filter, border_index)
+{
+    EXPECT_EQ(filter::border_index(-2, 5, filter::BORDER_REPLICATE), 0);
+    EXPECT_EQ(filter::border_index(6, 5, filter::BORDER_REPLICATE), 4);
+    EXPECT_EQ(filter::border_index(-2, 5, filter::BORDER_REFLECT_101), 2);
+    EXPECT_EQ(filter::border_index(6, 5, filter::BORDER_REFLECT_101), 2);
+    EXPECT_EQ(filter::border_index(-7, 3, filter::BORDER_REFLECT_101), 1);
+    EXPECT_EQ(filter::border_index(-1, 1, filter::BORDER_REFLECT_101), 0);
+    EXPECT_EQ(filter::border_index(5, 5, filter::BORDER_CONSTANT), -1);
+    EXPECT_EQ(filter::border_index(3, 5, filter::BORDER_CONSTANT), 3);
+}
+
+TEST(filter, gaussian_kernel_q8)
+{
+    for (int ksize = 3; ksize <= 15; ksize += 2)
+    {
+        for (double sigma : { 0.0, 0.1, 0.8, 2.0, 10.0 })
+        {
+            uint8_t k[15];
+            filter::gaussian_kernel_q8(ksize, sigma, k);
+            int sum = 0;
+            for (int i = 0; i < ksize; i++)
+            {
+                sum += k[i];
+                EXPECT_EQ(k[i], k[ksize - 1 - i]);
+            }
+            EXPECT_EQ(sum, 256);
+        }
+    }
+    uint8_t k3[3];
+    filter::gaussian_kernel_q8(3, 0.0, k3); // sigma 0.8
+    EXPECT_EQ(k3[0], 61);
+    EXPECT_EQ(k3[1], 134);
+}
+
+TEST(filter, separable_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const size_t step = w + 3;
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>(step * h, w * 100 + h);
+        for (filter::Border border : kBorders)
+        {
+            for (int ksize = 3; ksize <= 7; ksize += 2)
+            {
+                uint8_t kx[7], ky[7];
+                filter::gaussian_kernel_q8(ksize, 0.0, kx);
+                filter::gaussian_kernel_q8(ksize, 3.0, ky);
+                std::vector<uint8_t> expected(step * h, 7), actual(step * h, 7);
+                filter::ref::separable_filter(src.data(), step, expected.data(), step, w, h, kx, ky, ksize, border);
+                filter::separable_filter(src.data(), step, actual.data(), step, w, h, kx, ky, ksize, border);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+
+    // a flat image stays flat, at the top of the range too
+    const std::vector<uint8_t> flat(64 * 5, 255);
+    std::vector<uint8_t> out(flat.size());
+    filter::gaussian_blur(flat.data(), 64, out.data(), 64, 64, 5, 5, 0.0, filter::BORDER_REPLICATE);
+    EXPECT_TRUE(same(flat, out));
+}
+
+TEST(filter, box_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>((size_t)w * h, w + h);
+        for (filter::Border border : kBorders)
+        {
+            for (int ksize = 1; ksize <= 15; ksize += 2)
+            {
+                std::vector<uint8_t> expected(src.size()), actual(src.size());
+                filter::ref::box_filter(src.data(), w, expected.data(), w, w, h, ksize, border);
+                filter::box_filter(src.data(), w, actual.data(), w, w, h, ksize, border);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+
+    // all-255 windows hit the largest sum of each size
+    const std::vector<uint8_t> white(24 * 20, 255);
+    for (int ksize = 1; ksize <= 15; ksize += 2)
+    {
+        std::vector<uint8_t> out(white.size());
+        filter::box_filter(white.data(), 24, out.data(), 24, 24, 20, ksize, filter::BORDER_REFLECT_101);
+        EXPECT_TRUE(same(white, out));
+    }
+}
+
+TEST(filter, sobel_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>((size_t)w * h, w * 3 + h);
+        const size_t step = (w + 1) * sizeof(int16_t);
+        for (filter::Border border : kBorders)
+        {
+            std::vector<int16_t> dx_ref((w + 1) * h), dy_ref(dx_ref.size()), dx(dx_ref.size()), dy(dx_ref.size());
+            filter::ref::sobel3x3(src.data(), w, dx_ref.data(), step, dy_ref.data(), step, w, h, border);
+            filter::sobel3x3(src.data(), w, dx.data(), step, dy.data(), step, w, h, border);
+            EXPECT_TRUE(same(dx_ref, dx));
+            EXPECT_TRUE(same(dy_ref, dy));
+
+            std::vector<int16_t> dy_only(dx_ref.size());
+            filter::sobel3x3(src.data(), w, NULL, 0, dy_only.data(), step, w, h, border);
+            EXPECT_TRUE(same(dy_ref, dy_only));
+        }
+    }
+
+    // a vertical step edge: dx = 4 * 255 on it, dy = 0
+    std::vector<uint8_t> edge(20 * 3, 0);
+    for (int y = 0; y < 3; y++)
+    {
+        std::fill(edge.begin() + y * 20 + 10, edge.begin() + y * 20 + 20, 255);
+    }
+    std::vector<int16_t> dx(edge.size()), dy(edge.size());
+    filter::sobel3x3(edge.data(), 20, dx.data(), 40, dy.data(), 40, 20, 3, filter::BORDER_REPLICATE);
+    EXPECT_EQ(dx[20 + 9], 1020);
+    EXPECT_EQ(dx[20 + 10], 1020);
+    EXPECT_EQ(dx[20 + 8], 0);
+    EXPECT_EQ(dy[20 + 10], 0);
+}
+
+TEST(filter, morphology_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>((size_t)w * h, w * 7 + h);
+        for (filter::Border border : kBorders)
+        {
+            for (int ksize = 1; ksize <= 5; ksize += 2)
+            {
+                std::vector<uint8_t> expected(src.size()), actual(src.size());
+                filter::ref::erode(src.data(), w, expected.data(), w, w, h, ksize, border);
+                filter::erode(src.data(), w, actual.data(), w, w, h, ksize, border);
+                EXPECT_TRUE(same(expected, actual));
+                filter::ref::dilate(src.data(), w, expected.data(), w, w, h, ksize, border);
+                filter::dilate(src.data(), w, actual.data(), w, w, h, ksize, border);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+}
+
+TEST(filter, resize_matches_ref)
+{
+    const int sizes[][4] = {
+        { 1, 1, 5, 3 }, { 8, 8, 4, 4 }, { 16, 9, 33, 17 }, { 37, 21, 19, 11 }, { 40, 30, 40, 30 }, { 5, 40, 61, 7 },
+    };
+    for (const auto& s : sizes)
+    {
+        const int sw = s[0], sh = s[1], dw = s[2], dh = s[3];
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>((size_t)sw * sh, sw + dw);
+        std::vector<uint8_t> expected((size_t)dw * dh), actual(expected.size());
+        filter::ref::resize_bilinear(src.data(), sw, sw, sh, expected.data(), dw, dw, dh);
+        filter::resize_bilinear(src.data(), sw, sw, sh, actual.data(), dw, dw, dh);
+        EXPECT_TRUE(same(expected, actual));
+        if (sw == dw && sh == dh)
+        {
+            EXPECT_TRUE(same(src, actual));
+        }
+    }
+
+    // halving averages 2x2 blocks: (a + b + c + d + 2) / 4
+    const uint8_t quad[4 * 2] = { 0, 10, 100, 101, 20, 31, 255, 255 };
+    uint8_t half[2];
+    filter::resize_bilinear(quad, 4, 4, 2, half, 2, 2, 1);
+    EXPECT_EQ(half[0], 15);
+    EXPECT_EQ(half[1], 178);
+}
@@ -0,0 +1,121 @@
+#include "test_util.hpp"
+
+#include <cmath>
+#include <thread>
+
+namespace {
+
+uint32_t bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+float from_bits(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// kept out of reach of constant folding
+volatile float g_denormal = 1e-40f;
+volatile float g_tiny = 1e-20f;
+
+} // namespace
+
+#if defined(NEON_SIM_AARCH32_FP)
+TEST(fpcr, aarch32_profile)
+{
+    // every thread starts with the standard value and cannot leave it
+    EXPECT_EQ(neon_sim_get_fpcr(), (uint64_t)NEON_SIM_FPCR_AARCH32);
+    NeonSimFpcrScope scope(NEON_SIM_FPCR_RZ);
+    EXPECT_EQ(neon_sim_get_fpcr(), (uint64_t)NEON_SIM_FPCR_AARCH32);
+    float product = 1.0f;
+    std::thread t([&] { product = vmulq_f32(vdupq_n_f32(g_denormal), vdupq_n_f32(1.0f))[0]; });
+    t.join();
+    EXPECT_EQ(bits(product), 0u);
+}
+#else
+TEST(fpcr, flush_to_zero)
+{
+    EXPECT_EQ(neon_sim_get_fpcr(), 0u);
+    const float32x4_t d = vdupq_n_f32(g_denormal);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t tiny = vdupq_n_f32(g_tiny);
+    EXPECT_EQ(vmulq_f32(d, one)[0], g_denormal);
+    EXPECT_TRUE(vmulq_f32(tiny, tiny)[1] > 0.0f);
+    {
+        NeonSimFpcrScope fz(NEON_SIM_FPCR_FZ);
+        EXPECT_EQ(neon_sim_get_fpcr(), (uint64_t)NEON_SIM_FPCR_FZ);
+        // subnormal inputs and results are zero
+        EXPECT_EQ(bits(vmulq_f32(d, one)[0]), 0u);
+        EXPECT_EQ(bits(vaddq_f32(d, d)[2]), 0u);
+        EXPECT_EQ(bits(vmulq_f32(tiny, vdupq_n_f32(-g_tiny))[3]), 0x80000000u);
+        // min/max and the estimates do not go through host arithmetic
+        EXPECT_EQ(bits(vmaxq_f32(d, vdupq_n_f32(-1.0f))[0]), 0u);
+        EXPECT_TRUE(std::isinf(vrecpeq_f32(d)[0]));
+        EXPECT_TRUE(std::isinf(vrsqrteq_f32(d)[1]));
+        EXPECT_EQ(vrecpeq_f32(vdupq_n_f32(1e38f))[0], 0.0f);
+    }
+    EXPECT_EQ(neon_sim_get_fpcr(), 0u);
+    EXPECT_EQ(vmulq_f32(d, one)[0], g_denormal);
+    EXPECT_TRUE(vrecpeq_f32(vdupq_n_f32(1e38f))[0] > 0.0f);
+}
+
+TEST(fpcr, default_nan)
+{
+    // a NaN with a payload is passed on, or replaced by the default NaN with DN
+    const float32x4_t n = vdupq_n_f32(from_bits(0xffc01234u));
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    EXPECT_EQ(bits(vaddq_f32(n, one)[0]), 0xffc01234u);
+    NeonSimFpcrScope dn(NEON_SIM_FPCR_DN);
+    EXPECT_EQ(bits(vaddq_f32(n, one)[0]), 0x7fc00000u);
+    EXPECT_EQ(bits(vmulq_f32(one, n)[1]), 0x7fc00000u);
+    EXPECT_EQ(bits(vsqrtq_f32(n)[2]), 0x7fc00000u);
+    EXPECT_EQ(bits(vrecpeq_f32(n)[3]), 0x7fc00000u);
+    EXPECT_EQ(vaddq_f32(one, one)[0], 2.0f);
+}
+
+TEST(fpcr, rounding_mode)
+{
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t three = vdupq_n_f32(3.0f);
+    const float nearest = vdivq_f32(one, three)[0];
+    float up, down, zero;
+    {
+        NeonSimFpcrScope rp(NEON_SIM_FPCR_RP);
+        up = vdivq_f32(one, three)[0];
+    }
+    {
+        NeonSimFpcrScope rm(NEON_SIM_FPCR_RM);
+        down = vdivq_f32(one, three)[0];
+        // below 2^-128 the estimate overflows to the largest float, not inf
+        EXPECT_EQ(vrecpeq_f32(vdupq_n_f32(g_denormal))[0], std::numeric_limits<float>::max());
+    }
+    {
+        NeonSimFpcrScope rz(NEON_SIM_FPCR_RZ);
+        zero = vdivq_f32(vdupq_n_f32(-1.0f), three)[0];
+    }
+    EXPECT_EQ(bits(up), bits(down) + 1);
+    EXPECT_EQ(nearest, up); // 0x3eaaaaab
+    EXPECT_EQ(zero, -down);
+    EXPECT_EQ(vdivq_f32(one, three)[0], nearest);
+}
+
+TEST(fpcr, per_thread)
+{
+    NeonSimFpcrScope fz(NEON_SIM_FPCR_FZ | NEON_SIM_FPCR_DN);
+    uint64_t other = 1;
+    float product = 0.0f;
+    std::thread t([&] {
+        other = neon_sim_get_fpcr();
+        product = vmulq_f32(vdupq_n_f32(g_denormal), vdupq_n_f32(1.0f))[0];
+    });
+    t.join();
+    EXPECT_EQ(other, 0u);
+    EXPECT_EQ(product, g_denormal);
+    EXPECT_EQ(neon_sim_get_fpcr(), (uint64_t)(NEON_SIM_FPCR_FZ | NEON_SIM_FPCR_DN));
+}
+#endif // NEON_SIM_AARCH32_FP
@@ -0,0 +1,185 @@
+#include "test_util.hpp"
+#include "neon_sim_gemm.hpp"
+
+#include <random>
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+std::vector<float> random_floats(size_t n, unsigned seed)
+{
+    std::vector<float> v(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = dist(rng);
+    }
+    return v;
+}
+
+const int kDims[] = { 1, 7, 8, 13, 25 };
+
+} // namespace
+
+TEST(gemm, sgemm_matches_ref)
+{
+    for (int m : kDims)
+    {
+        for (int n : kDims)
+        {
+            for (int k : kDims)
+            {
+                // rows padded by 3 elements, so the steps are not multiples of the panels
+                const size_t a_step = (k + 3) * sizeof(float);
+                const size_t b_step = (n + 3) * sizeof(float);
+                const size_t c_step = (n + 3) * sizeof(float);
+                const std::vector<float> a = random_floats((size_t)m * (k + 3), m * 100 + k);
+                const std::vector<float> b = random_floats((size_t)k * (n + 3), n * 100 + k);
+                std::vector<float> expected((size_t)m * (n + 3), 7.0f), actual(expected.size(), 7.0f);
+                gemm::ref::sgemm(m, n, k, a.data(), a_step, b.data(), b_step, expected.data(), c_step);
+                gemm::sgemm(m, n, k, a.data(), a_step, b.data(), b_step, actual.data(), c_step);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+}
+
+TEST(gemm, sgemm_packed_reuses_a)
+{
+    const int m = 17, n = 30, k = 9;
+    const std::vector<float> a = random_floats((size_t)m * k, 1);
+    std::vector<float> packed_a(gemm::sgemm_packed_a_size(m, k));
+    EXPECT_EQ(packed_a.size(), (size_t)24 * k);
+    gemm::sgemm_pack_a(a.data(), k * sizeof(float), m, k, packed_a.data());
+    for (unsigned seed = 2; seed < 5; seed++)
+    {
+        const std::vector<float> b = random_floats((size_t)k * n, seed);
+        std::vector<float> packed_b(gemm::sgemm_packed_b_size(k, n));
+        EXPECT_EQ(packed_b.size(), (size_t)36 * k);
+        gemm::sgemm_pack_b(b.data(), n * sizeof(float), k, n, packed_b.data());
+        std::vector<float> expected((size_t)m * n), actual(expected.size());
+        gemm::ref::sgemm(m, n, k, a.data(), k * sizeof(float), b.data(), n * sizeof(float), expected.data(),
+                         n * sizeof(float));
+        gemm::sgemm_packed(m, n, k, packed_a.data(), packed_b.data(), actual.data(), n * sizeof(float));
+        EXPECT_TRUE(same(expected, actual));
+    }
+}
+
+TEST(gemm, sgemm_identity)
+{
+    const int n = 12;
+    std::vector<float> eye((size_t)n * n, 0.0f);
+    for (int i = 0; i < n; i++)
+    {
+        eye[i * n + i] = 1.0f;
+    }
+    const std::vector<float> b = random_floats((size_t)n * n, 3);
+    std::vector<float> c((size_t)n * n);
+    gemm::sgemm(n, n, n, eye.data(), n * sizeof(float), b.data(), n * sizeof(float), c.data(), n * sizeof(float));
+    EXPECT_TRUE(same(b, c));
+}
+
+TEST(gemm, igemm_matches_ref)
+{
+    for (int m : kDims)
+    {
+        for (int n : kDims)
+        {
+            for (int k : kDims)
+            {
+                const size_t c_step = (n + 1) * sizeof(int32_t);
+                const std::vector<int8_t> a = random_with_rails<int8_t>((size_t)m * (k + 5), m * 100 + k, 4);
+                const std::vector<int8_t> b = random_with_rails<int8_t>((size_t)k * (n + 5), n * 100 + k, 4);
+                std::vector<int32_t> expected((size_t)m * (n + 1), 7), actual(expected.size(), 7);
+                gemm::ref::igemm(m, n, k, a.data(), k + 5, b.data(), n + 5, expected.data(), c_step);
+                gemm::igemm(m, n, k, a.data(), k + 5, b.data(), n + 5, actual.data(), c_step);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+
+    // the largest magnitude: k products of -128 * -128
+    const int k = 300;
+    const std::vector<int8_t> a(8 * k, -128), b(k * 8, -128);
+    std::vector<int32_t> c(64);
+    gemm::igemm(8, 8, k, a.data(), k, b.data(), 8, c.data(), 8 * sizeof(int32_t));
+    EXPECT_EQ(c[0], 16384 * k);
+    EXPECT_EQ(c[63], 16384 * k);
+}
+
+TEST(gemm, conv3x3_direct_matches_ref)
+{
+    const int shapes[][4] = {
+        // channels, height, width, out_channels
+        { 1, 3, 3, 1 }, { 1, 3, 6, 2 }, { 3, 7, 9, 4 }, { 4, 10, 13, 3 }, { 2, 5, 16, 5 },
+    };
+    for (const auto& s : shapes)
+    {
+        const int c = s[0], h = s[1], w = s[2], oc = s[3];
+        const std::vector<float> in = random_floats((size_t)c * h * w, c + h);
+        const std::vector<float> weights = random_floats((size_t)oc * c * 9, w);
+        const std::vector<float> bias = random_floats(oc, oc);
+        const size_t out_size = (size_t)oc * (h - 2) * (w - 2);
+        for (const float* b : { (const float*)NULL, bias.data() })
+        {
+            std::vector<float> expected(out_size), actual(out_size);
+            gemm::ref::conv3x3(in.data(), c, h, w, weights.data(), b, expected.data(), oc);
+            gemm::conv3x3_direct(in.data(), c, h, w, weights.data(), b, actual.data(), oc);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+}
+
+TEST(gemm, conv3x3_winograd_close_to_ref)
+{
+    const int shapes[][4] = {
+        { 1, 3, 3, 1 }, { 1, 4, 4, 1 }, { 3, 7, 9, 4 }, { 4, 10, 13, 3 }, { 8, 16, 16, 2 }, { 2, 6, 5, 5 },
+    };
+    for (const auto& s : shapes)
+    {
+        const int c = s[0], h = s[1], w = s[2], oc = s[3];
+        const std::vector<float> in = random_floats((size_t)c * h * w, c + h);
+        const std::vector<float> weights = random_floats((size_t)oc * c * 9, w);
+        const std::vector<float> bias = random_floats(oc, oc);
+        std::vector<float> transformed(gemm::winograd_weights_size(c, oc));
+        EXPECT_EQ(transformed.size(), (size_t)16 * c * oc);
+        gemm::winograd_transform_weights(weights.data(), c, oc, transformed.data());
+        const size_t out_size = (size_t)oc * (h - 2) * (w - 2);
+        std::vector<float> expected(out_size), actual(out_size, 1e30f);
+        gemm::ref::conv3x3(in.data(), c, h, w, weights.data(), bias.data(), expected.data(), oc);
+        gemm::conv3x3_winograd(in.data(), c, h, w, transformed.data(), bias.data(), actual.data(), oc);
+        // sums of up to 9c terms of magnitude one: a few ulp of the sum each
+        EXPECT_TRUE(almostEqual(expected, actual, 1e-5 * c));
+    }
+}
+
+TEST(gemm, conv3x3_box_filter)
+{
+    // all-ones weights on a ramp: the 3x3 box sum of x + y is 9 (x + y + 2)
+    const int h = 6, w = 7;
+    std::vector<float> in((size_t)h * w);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            in[y * w + x] = (float)(x + y);
+        }
+    }
+    const std::vector<float> ones(9, 1.0f);
+    const float bias = 0.5f;
+    std::vector<float> direct((size_t)(h - 2) * (w - 2)), winograd(direct.size());
+    std::vector<float> transformed(gemm::winograd_weights_size(1, 1));
+    gemm::winograd_transform_weights(ones.data(), 1, 1, transformed.data());
+    gemm::conv3x3_direct(in.data(), 1, h, w, ones.data(), &bias, direct.data(), 1);
+    gemm::conv3x3_winograd(in.data(), 1, h, w, transformed.data(), &bias, winograd.data(), 1);
+    for (int y = 0; y < h - 2; y++)
+    {
+        for (int x = 0; x < w - 2; x++)
+        {
+            EXPECT_EQ(direct[y * (w - 2) + x], 9.0f * (x + y + 2) + 0.5f);
+            EXPECT_EQ(winograd[y * (w - 2) + x], 9.0f * (x + y + 2) + 0.5f);
+        }
+    }
+}
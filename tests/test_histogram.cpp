@@ -0,0 +1,88 @@
+#include "test_util.hpp"
+#include "neon_sim_histogram.hpp"
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+// widths on both sides of the 8 and 16 pixel vectors
+const int kShapes[][2] = { { 1, 1 }, { 7, 3 }, { 8, 2 }, { 16, 5 }, { 23, 4 }, { 33, 9 }, { 64, 17 } };
+
+} // namespace
+
+TEST(histogram, matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const size_t step = w + 3;
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>(step * h, w * 10 + h);
+        std::vector<uint32_t> expected(256);
+        histogram::ref::histogram_u8(src.data(), step, w, h, expected.data());
+        for (int banks : { 1, 2, 4, 8 })
+        {
+            std::vector<uint32_t> actual(256, 7);
+            histogram::histogram_u8(src.data(), step, w, h, actual.data(), banks);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+}
+
+TEST(histogram, flat_and_extremes)
+{
+    // every pixel in one bin, and the two end bins
+    const int w = 37, h = 11;
+    std::vector<uint8_t> src((size_t)w * h, 200);
+    for (int banks : { 1, 2, 4, 8 })
+    {
+        uint32_t hist[256];
+        histogram::histogram_u8(src.data(), w, w, h, hist, banks);
+        EXPECT_EQ(hist[200], (uint32_t)(w * h));
+        EXPECT_EQ(hist[199], 0u);
+        EXPECT_EQ(hist[201], 0u);
+    }
+
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        src[i] = (i & 1) ? 255 : 0;
+    }
+    uint32_t hist[256];
+    histogram::histogram_u8(src.data(), w, w, h, hist, 4);
+    EXPECT_EQ(hist[0] + hist[255], (uint32_t)(w * h));
+    EXPECT_EQ(hist[0], (uint32_t)(w * h + 1) / 2);
+}
+
+TEST(integral, matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const size_t src_step = w + 5;
+        const size_t sum_step = (w + 3) * sizeof(uint32_t);
+        const std::vector<uint8_t> src = random_with_rails<uint8_t>(src_step * h, w + h * 10);
+        std::vector<uint32_t> expected(sum_step / 4 * (h + 1), 7), actual(expected.size(), 7);
+        histogram::ref::integral(src.data(), src_step, expected.data(), sum_step, w, h);
+        histogram::integral(src.data(), src_step, actual.data(), sum_step, w, h);
+        EXPECT_TRUE(same(expected, actual));
+    }
+}
+
+TEST(integral, known_values)
+{
+    const uint8_t src[3 * 3] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    uint32_t sum[4 * 4];
+    histogram::integral(src, 3, sum, 4 * sizeof(uint32_t), 3, 3);
+    const uint32_t expected[4 * 4] = { 0, 0, 0, 0, 0, 1, 3, 6, 0, 5, 12, 21, 0, 12, 27, 45 };
+    for (int i = 0; i < 16; i++)
+    {
+        EXPECT_EQ(sum[i], expected[i]);
+    }
+
+    // all-255 rows: the 16 bit prefix and the 32 bit carries at their largest
+    const int w = 1000, h = 20;
+    const std::vector<uint8_t> white((size_t)w * h, 255);
+    std::vector<uint32_t> total((size_t)(w + 1) * (h + 1));
+    histogram::integral(white.data(), w, total.data(), (w + 1) * sizeof(uint32_t), w, h);
+    EXPECT_EQ(total.back(), 255u * w * h);
+    EXPECT_EQ(total[(w + 1) + 8], 255u * 8);
+}
@@ -0,0 +1,170 @@
+#include "test_util.hpp"
+#include "neon_sim_image_io.hpp"
+#include "neon_sim_kernels.hpp"
+
+#include <stdio.h>
+
+using namespace neon_sim_kernels;
+
+static std::vector<uint8_t> pattern(size_t n, int seed)
+{
+    std::vector<uint8_t> v(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = (uint8_t)(i * 31 + seed);
+    }
+    return v;
+}
+
+static void write_file(const char* path, const std::string& bytes)
+{
+    FILE* fp = fopen(path, "wb");
+    fwrite(bytes.data(), 1, bytes.size(), fp);
+    fclose(fp);
+}
+
+TEST(image_io, ppm_roundtrip_is_aligned)
+{
+    const int w = 13;
+    const int h = 7;
+    // a padded source view
+    const size_t step = w * 3 + 9;
+    std::vector<uint8_t> buf = pattern(step * h, 1);
+    ImageView src;
+    src.data = buf.data();
+    src.step = step;
+    src.width = w;
+    src.height = h;
+    src.channels = 3;
+    const char* path = "test_image_io_roundtrip.ppm";
+    EXPECT_TRUE(save_pnm(path, src));
+
+    MappedImage img;
+    EXPECT_TRUE(img.open_pnm(path));
+    const ImageView& v = img.view();
+    EXPECT_EQ(v.width, w);
+    EXPECT_EQ(v.height, h);
+    EXPECT_EQ(v.channels, 3);
+    EXPECT_EQ(img.frame_count(), 1);
+    EXPECT_FALSE(img.writable());
+    EXPECT_EQ((uintptr_t)v.data % 64, (uintptr_t)0);
+    EXPECT_TRUE(compare_image(src.data, src.step, v.data, v.step, h, w, 3).ok());
+
+    // already 64-aligned data, but the step is not: aligned() copies
+    AlignedImage tmp;
+    ImageView a = aligned(v, 16, tmp);
+    EXPECT_TRUE(a.data != v.data);
+    EXPECT_EQ(a.step % 16, (size_t)0);
+    EXPECT_EQ((uintptr_t)a.data % 16, (uintptr_t)0);
+    EXPECT_TRUE(compare_image(v.data, v.step, a.data, a.step, h, w, 3).ok());
+    remove(path);
+}
+
+TEST(image_io, pgm_with_comments_and_kernel_on_view)
+{
+    const char* path = "test_image_io_comments.pgm";
+    std::string bytes = "P5\n# made by hand\n4 # width\n2\n255\n";
+    const uint8_t px[8] = { 0, 10, 60, 61, 100, 200, 255, 59 };
+    bytes.append((const char*)px, 8);
+    write_file(path, bytes);
+
+    MappedImage img;
+    EXPECT_TRUE(img.open_pnm(path));
+    EXPECT_EQ(img.view().width, 4);
+    EXPECT_EQ(img.view().height, 2);
+    EXPECT_EQ(img.view().channels, 1);
+
+    uint8_t dst[8];
+    threshold(img.view().data, img.view().step, dst, 4, 4, 2, 60, 0, 255);
+    const uint8_t expected[8] = { 0, 0, 0, 255, 255, 255, 255, 0 };
+    EXPECT_EQ(memcmp(dst, expected, 8), 0);
+    img.close();
+    remove(path);
+}
+
+TEST(image_io, bad_files)
+{
+    MappedImage img;
+    EXPECT_FALSE(img.open_pnm("test_image_io_does_not_exist.pgm"));
+    EXPECT_FALSE(img.error().empty());
+
+    const char* path = "test_image_io_bad.pgm";
+    write_file(path, "P2\n4 2\n255\n0 0 0 0 0 0 0 0\n");
+    EXPECT_FALSE(img.open_pnm(path));
+    write_file(path, "P5\n4 2\n65535\n");
+    EXPECT_FALSE(img.open_pnm(path));
+    write_file(path, "P5\n4 2\n255\nabc");
+    EXPECT_FALSE(img.open_pnm(path));
+    EXPECT_TRUE(img.view().empty());
+    remove(path);
+}
+
+TEST(image_io, raw_and_nv21_frames)
+{
+    const int w = 8;
+    const int h = 4;
+    const size_t frame_size = w * h * 3 / 2;
+    const std::vector<uint8_t> data = pattern(frame_size * 3, 5);
+    const char* path = "test_image_io_frames.nv21";
+    write_file(path, std::string((const char*)data.data(), data.size()));
+
+    MappedImage img;
+    EXPECT_TRUE(img.open_nv21(path, w, h, 2));
+    EXPECT_EQ(img.frame_count(), 3);
+    EXPECT_EQ(img.plane_count(), 2);
+    EXPECT_EQ(img.plane(0).data[0], data[frame_size * 2]);
+    EXPECT_EQ(img.plane(1).width, w / 2);
+    EXPECT_EQ(img.plane(1).height, h / 2);
+    EXPECT_EQ(img.plane(1).channels, 2);
+    EXPECT_EQ(img.plane(1).row(1)[1], data[frame_size * 2 + w * h + w + 1]);
+    EXPECT_FALSE(img.open_nv21(path, w, h, 3));
+    EXPECT_FALSE(img.open_nv21(path, 7, h));
+
+    // the same bytes as a raw Y file
+    EXPECT_TRUE(img.open_raw(path, w, h, 1, 1));
+    EXPECT_EQ(img.frame_count(), (int)(data.size() / (w * h)));
+    EXPECT_EQ(img.view().data[0], data[w * h]);
+    EXPECT_EQ((uintptr_t)img.view().data % 16, (uintptr_t)0);
+    img.close();
+    remove(path);
+}
+
+TEST(image_io, create_pnm_writes_through)
+{
+    const char* path = "test_image_io_created.pgm";
+    {
+        MappedImage out;
+        EXPECT_TRUE(out.create_pnm(path, 5, 3, 1));
+        EXPECT_TRUE(out.writable());
+        const MutableImageView v = out.mutable_view();
+        EXPECT_FALSE(v.empty());
+        for (int y = 0; y < 3; y++)
+        {
+            for (int x = 0; x < 5; x++)
+            {
+                v.row(y)[x] = (uint8_t)(y * 5 + x);
+            }
+        }
+    }
+    MappedImage in;
+    EXPECT_TRUE(in.open_pnm(path));
+    EXPECT_EQ(in.view().row(2)[4], 14);
+    // a file opened for reading is mapped read only: no mutable view
+    EXPECT_TRUE(in.mutable_view().empty());
+    in.close();
+    remove(path);
+
+    // save_raw drops the row padding
+    std::vector<uint8_t> buf = pattern(2 * 10, 0);
+    ImageView v;
+    v.data = buf.data();
+    v.step = 10;
+    v.width = 3;
+    v.height = 2;
+    v.channels = 2;
+    EXPECT_TRUE(save_raw("test_image_io_saved.raw", v));
+    EXPECT_TRUE(in.open_raw("test_image_io_saved.raw", 3, 2, 2));
+    EXPECT_TRUE(compare_image(v.data, v.step, in.view().data, in.view().step, 2, 3, 2).ok());
+    in.close();
+    remove("test_image_io_saved.raw");
+}
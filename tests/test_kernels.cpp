@@ -0,0 +1,212 @@
+#include "test_util.hpp"
+#include "neon_sim_kernels.hpp"
+
+#include <random>
+
+namespace {
+
+// A padded image: rows are `step` bytes apart, the padding is filled with a
+// marker so that writes past `width * channels` are caught.
+struct Image
+{
+    int width;
+    int height;
+    int channels;
+    size_t step;
+    std::vector<uint8_t> data;
+
+    Image(int w, int h, int c, int pad = 5, uint8_t fill = 0xCD)
+        : width(w), height(h), channels(c), step(w * c + pad), data(step * h, fill)
+    {
+    }
+
+    uint8_t* ptr() { return data.data(); }
+    const uint8_t* ptr() const { return data.data(); }
+};
+
+static Image random_image(int w, int h, int c, unsigned seed)
+{
+    Image img(w, h, c);
+    std::mt19937 rng(seed);
+    for (int y = 0; y < h; y++)
+    {
+        for (int i = 0; i < w * c; i++)
+        {
+            img.data[y * img.step + i] = (uint8_t)rng();
+        }
+    }
+    return img;
+}
+
+// bit-exact, including the padding bytes
+static bool same(const Image& expected, const Image& actual)
+{
+    CompareResult res = compare_array(expected.data.data(), actual.data.data(), expected.data.size());
+    if (!res.ok())
+    {
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
+}
+
+// widths around the 8 and 16 lane boundaries
+const int kWidths[] = { 1, 7, 8, 15, 16, 17, 33, 64 };
+const int kHeights[] = { 1, 7, 9 };
+
+} // namespace
+
+TEST(kernels, rgb2gray)
+{
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image src = random_image(w, h, 3, w * 100 + h);
+            Image expected(w, h, 1);
+            Image actual(w, h, 1);
+            neon_sim_kernels::ref::rgb2gray(src.ptr(), src.step, expected.ptr(), expected.step, w, h);
+            neon_sim_kernels::rgb2gray(src.ptr(), src.step, actual.ptr(), actual.step, w, h);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+
+    // (77 * R + 151 * G + 28 * B) >> 8
+    const uint8_t rgb[3] = { 255, 255, 255 };
+    uint8_t gray = 0;
+    neon_sim_kernels::rgb2gray(rgb, 3, &gray, 1, 1, 1);
+    EXPECT_EQ(gray, 255);
+}
+
+TEST(kernels, rgb2bgr)
+{
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image src = random_image(w, h, 3, w * 100 + h);
+            Image expected(w, h, 3);
+            Image actual(w, h, 3);
+            neon_sim_kernels::ref::rgb2bgr(src.ptr(), src.step, expected.ptr(), expected.step, w, h);
+            neon_sim_kernels::rgb2bgr(src.ptr(), src.step, actual.ptr(), actual.step, w, h);
+            EXPECT_TRUE(same(expected, actual));
+
+            // swapping twice restores the input
+            neon_sim_kernels::rgb2bgr(actual.ptr(), actual.step, actual.ptr(), actual.step, w, h);
+            EXPECT_TRUE(compare_image(src.ptr(), src.step, actual.ptr(), actual.step, h, w, 3).ok());
+        }
+    }
+}
+
+TEST(kernels, threshold)
+{
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image src = random_image(w, h, 1, w * 100 + h);
+            Image expected(w, h, 1);
+            Image actual(w, h, 1);
+            neon_sim_kernels::ref::threshold(src.ptr(), src.step, expected.ptr(), expected.step, w, h, 60, 255, 0);
+            neon_sim_kernels::threshold(src.ptr(), src.step, actual.ptr(), actual.step, w, h, 60, 255, 0);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+
+    const uint8_t src[3] = { 59, 60, 61 };
+    uint8_t dst[3];
+    neon_sim_kernels::threshold(src, 3, dst, 3, 3, 1, 60, 10, 200);
+    EXPECT_EQ(dst[0], 10);
+    EXPECT_EQ(dst[1], 10);
+    EXPECT_EQ(dst[2], 200);
+}
+
+TEST(kernels, transpose)
+{
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image src = random_image(w, h, 1, w * 100 + h);
+            Image expected(h, w, 1);
+            Image actual(h, w, 1);
+            neon_sim_kernels::ref::transpose(src.ptr(), src.step, expected.ptr(), expected.step, w, h);
+            neon_sim_kernels::transpose(src.ptr(), src.step, actual.ptr(), actual.step, w, h);
+            EXPECT_TRUE(same(expected, actual));
+            EXPECT_EQ(actual.data[(w - 1) * actual.step + (h - 1)], src.data[(h - 1) * src.step + (w - 1)]);
+        }
+    }
+}
+
+TEST(kernels, alpha_blend)
+{
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image fg = random_image(w, h, 3, w * 100 + h);
+            Image bg = random_image(w, h, 3, w * 100 + h + 1);
+            Image alpha = random_image(w, h, 3, w * 100 + h + 2);
+            Image expected(w, h, 3);
+            Image actual(w, h, 3);
+            neon_sim_kernels::ref::alpha_blend(fg.ptr(), fg.step, bg.ptr(), bg.step, alpha.ptr(), alpha.step,
+                                               expected.ptr(), expected.step, w * 3, h);
+            neon_sim_kernels::alpha_blend(fg.ptr(), fg.step, bg.ptr(), bg.step, alpha.ptr(), alpha.step,
+                                          actual.ptr(), actual.step, w * 3, h);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+
+    // the fixed point division by 255 is exact for every product
+    std::vector<uint8_t> fg(256 * 256);
+    std::vector<uint8_t> bg(256 * 256, 0);
+    std::vector<uint8_t> alpha(256 * 256);
+    std::vector<uint8_t> dst(256 * 256);
+    for (int a = 0; a < 256; a++)
+    {
+        for (int v = 0; v < 256; v++)
+        {
+            fg[a * 256 + v] = (uint8_t)v;
+            alpha[a * 256 + v] = (uint8_t)a;
+        }
+    }
+    neon_sim_kernels::alpha_blend(fg.data(), 256, bg.data(), 256, alpha.data(), 256, dst.data(), 256, 256, 256);
+    int bad = 0;
+    for (int i = 0; i < 256 * 256; i++)
+    {
+        bad += dst[i] != (uint8_t)lround(fg[i] * alpha[i] / 255.0);
+    }
+    EXPECT_EQ(bad, 0);
+}
+
+TEST(kernels, lut)
+{
+    uint8_t table[256];
+    std::mt19937 rng(256);
+    for (int i = 0; i < 256; i++)
+    {
+        table[i] = (uint8_t)rng();
+    }
+
+    for (int w : kWidths)
+    {
+        for (int h : kHeights)
+        {
+            Image src = random_image(w, h, 1, w * 100 + h);
+            Image expected(w, h, 1);
+            Image actual(w, h, 1);
+            neon_sim_kernels::ref::lut(src.ptr(), src.step, expected.ptr(), expected.step, w, h, table);
+            neon_sim_kernels::lut(src.ptr(), src.step, actual.ptr(), actual.step, w, h, table);
+            EXPECT_TRUE(same(expected, actual));
+        }
+    }
+
+    // every index
+    uint8_t src[256];
+    uint8_t dst[256];
+    for (int i = 0; i < 256; i++)
+    {
+        src[i] = (uint8_t)i;
+    }
+    neon_sim_kernels::lut(src, 256, dst, 256, 256, 1, table);
+    EXPECT_EQ(memcmp(dst, table, 256), 0);
+}
@@ -0,0 +1,13 @@
+#define NEON_SIM_IMPLEMENTATION
+#include "test_util.hpp"
+#include "neon_sim_asm.hpp"
+#include "arm_sve_sim.hpp"
+#include "arm_sme_sim.hpp"
+#include "utest_parallel.h"
+
+UTEST_STATE();
+
+int main(int argc, const char* const argv[])
+{
+    return utest_parallel_main(argc, argv);
+}
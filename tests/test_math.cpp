@@ -0,0 +1,171 @@
+#include "test_util.hpp"
+#include "neon_sim_math.hpp"
+#include "neon_sim_parallel.hpp"
+
+#include <limits>
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+const float kInf = std::numeric_limits<float>::infinity();
+const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+float eval(const math::Function& f, float x)
+{
+    float in[4] = { x, x, x, x }, out[4];
+    vst1q_f32(out, f.vec(vld1q_f32(in)));
+    return out[0];
+}
+
+float eval(const char* name, float x)
+{
+    return eval(*math::find_function(name), x);
+}
+
+bool same_bits(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// ULP of the exact result; -1 when NaN or inf do not match the reference
+double ulp_error(const math::Function& f, float x, float y)
+{
+    const double exact = f.reference(x);
+    const float rounded = (float)exact;
+    if (std::isnan(exact) || std::isinf(rounded) || !std::isfinite(y))
+    {
+        const bool same = std::isnan(exact) ? std::isnan(y) : y == rounded;
+        return same ? 0.0 : -1.0;
+    }
+    int e;
+    frexp(exact, &e);
+    return fabs((double)y - exact) / ldexp(1.0, std::max(e - 24, -149));
+}
+
+} // namespace
+
+TEST(math, special_values)
+{
+    EXPECT_EQ(eval("exp", 0.0f), 1.0f);
+    EXPECT_EQ(eval("exp", -kInf), 0.0f);
+    EXPECT_EQ(eval("exp", kInf), kInf);
+    EXPECT_EQ(eval("exp", 88.8f), kInf);
+    EXPECT_EQ(eval("exp", -104.0f), 0.0f);
+    EXPECT_TRUE(std::isnan(eval("exp", kNaN)));
+    // subnormal results are not flushed
+    EXPECT_GT(eval("exp", -100.0f), 0.0f);
+
+    EXPECT_EQ(eval("log", 1.0f), 0.0f);
+    EXPECT_EQ(eval("log", 0.0f), -kInf);
+    EXPECT_EQ(eval("log", -0.0f), -kInf);
+    EXPECT_EQ(eval("log", kInf), kInf);
+    EXPECT_TRUE(std::isnan(eval("log", -1.0f)));
+    EXPECT_TRUE(std::isnan(eval("log", -kInf)));
+    EXPECT_TRUE(std::isnan(eval("log", kNaN)));
+    EXPECT_NEAR(eval("log", std::numeric_limits<float>::denorm_min()), -103.2789f, 1e-4f);
+
+    EXPECT_EQ(eval("sin", 0.0f), 0.0f);
+    EXPECT_TRUE(std::signbit(eval("sin", -0.0f)));
+    EXPECT_EQ(eval("cos", 0.0f), 1.0f);
+    EXPECT_TRUE(std::isnan(eval("sin", kInf)));
+    EXPECT_TRUE(std::isnan(eval("cos", -kInf)));
+
+    EXPECT_EQ(eval("tanh", kInf), 1.0f);
+    EXPECT_EQ(eval("tanh", -kInf), -1.0f);
+    EXPECT_EQ(eval("tanh", 20.0f), 1.0f);
+    EXPECT_TRUE(std::signbit(eval("tanh", -0.0f)));
+    EXPECT_TRUE(std::isnan(eval("tanh", kNaN)));
+
+    EXPECT_EQ(eval("sigmoid", 0.0f), 0.5f);
+    EXPECT_EQ(eval("sigmoid", kInf), 1.0f);
+    EXPECT_EQ(eval("sigmoid", -kInf), 0.0f);
+    EXPECT_GT(eval("sigmoid", -100.0f), 0.0f);
+    EXPECT_TRUE(std::isnan(eval("sigmoid", kNaN)));
+
+    EXPECT_EQ(eval("erf", 0.0f), 0.0f);
+    EXPECT_TRUE(std::signbit(eval("erf", -0.0f)));
+    EXPECT_EQ(eval("erf", kInf), 1.0f);
+    EXPECT_EQ(eval("erf", -kInf), -1.0f);
+    EXPECT_EQ(eval("erf", 5.0f), 1.0f);
+    EXPECT_TRUE(std::isnan(eval("erf", kNaN)));
+}
+
+// every 65521st bit pattern; neon_sim_math_accuracy visits all of them
+TEST(math, strided_sweep_within_bounds)
+{
+    const uint64_t stride = 65521;
+    const uint64_t total = (1ull << 32) / stride;
+    ThreadPool pool(4);
+    const std::vector<math::Function>& table = math::functions();
+    for (size_t f = 0; f < table.size(); f++)
+    {
+        struct Worst
+        {
+            double ulp = 0;
+            float input = 0;
+        };
+        PerThread<Worst> worst(pool);
+        pool.run(64, [&](size_t task, int w) {
+            Worst& st = worst.local(w);
+            for (uint64_t k = task * total / 64; k < (task + 1) * total / 64; k++)
+            {
+                const uint32_t bits = (uint32_t)(k * stride);
+                float x;
+                memcpy(&x, &bits, sizeof(x));
+                double err = ulp_error(table[f], x, eval(table[f], x));
+                err = err < 0 ? 1e9 : err;
+                if (err > st.ulp)
+                {
+                    st.ulp = err;
+                    st.input = x;
+                }
+            }
+        });
+        const Worst w = worst.merge(Worst(), [](Worst acc, const Worst& s) { return s.ulp > acc.ulp ? s : acc; });
+        if (w.ulp > table[f].max_ulp)
+        {
+            std::cerr << table[f].name << "(" << w.input << "): " << w.ulp << " ulp" << std::endl;
+        }
+        EXPECT_LE(w.ulp, table[f].max_ulp);
+    }
+}
+
+TEST(math, trig_large_arguments)
+{
+    // past the vector reduction the lanes are passed to libm
+    const float xs[4] = { 1e6f, -3.5e10f, 1e30f, 100.0f };
+    float s[4], c[4];
+    vst1q_f32(s, math::sinq_f32(vld1q_f32(xs)));
+    vst1q_f32(c, math::cosq_f32(vld1q_f32(xs)));
+    const math::Function& sin_f = *math::find_function("sin");
+    const math::Function& cos_f = *math::find_function("cos");
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_LE(ulp_error(sin_f, xs[i], s[i]), sin_f.max_ulp);
+        EXPECT_LE(ulp_error(cos_f, xs[i], c[i]), cos_f.max_ulp);
+    }
+}
+
+TEST(math, arrays_match_vectors)
+{
+    std::vector<float> src(103);
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        src[i] = -6.0f + 0.117f * i;
+    }
+    const std::vector<math::Function>& table = math::functions();
+    for (size_t f = 0; f < table.size(); f++)
+    {
+        // an odd length leaves a tail of three; the second run is in place
+        std::vector<float> dst(src.size(), kNaN);
+        table[f].array(src.data(), dst.data(), src.size());
+        std::vector<float> inplace = src;
+        table[f].array(inplace.data(), inplace.data(), inplace.size());
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            EXPECT_TRUE(same_bits(dst[i], eval(table[f], src[i])));
+            EXPECT_TRUE(same_bits(inplace[i], dst[i]));
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include "test_util.hpp"
+
+TEST(compare_image, u8_strided)
+{
+    const int height = 3;
+    const int width = 5;
+    const int channels = 3;
+    const int expected_step = 16;
+    const int actual_step = 20;
+    std::vector<uint8_t> expected(height * expected_step, 0xAA);
+    std::vector<uint8_t> actual(height * actual_step, 0x55);
+    for (int y = 0; y < height; y++)
+    {
+        for (int i = 0; i < width * channels; i++)
+        {
+            expected[y * expected_step + i] = (uint8_t)(y * 50 + i);
+            actual[y * actual_step + i] = (uint8_t)(y * 50 + i);
+        }
+    }
+    CompareResult res = compare_image(expected.data(), expected_step, actual.data(), actual_step, height, width, channels);
+    EXPECT_TRUE(res.ok());
+    EXPECT_EQ(res.count, (size_t)(height * width * channels));
+
+    // pixel (x=4, y=2), channel 1
+    actual[2 * actual_step + 4 * channels + 1] += 3;
+    res = compare_image(expected.data(), expected_step, actual.data(), actual_step, height, width, channels);
+    EXPECT_EQ(res.mismatches, (size_t)1);
+    EXPECT_EQ(res.max_abs_error, 3.0);
+    EXPECT_EQ(res.locations.size(), (size_t)1);
+    EXPECT_EQ(res.locations[0].y, (size_t)2);
+    EXPECT_EQ(res.locations[0].x, (size_t)4);
+    EXPECT_EQ(res.locations[0].c, (size_t)1);
+
+    CompareTolerance tol;
+    tol.abs_eps = 3;
+    res = compare_image(expected.data(), expected_step, actual.data(), actual_step, height, width, channels, tol);
+    EXPECT_TRUE(res.ok());
+    EXPECT_EQ(res.max_abs_error, 3.0);
+}
+
+TEST(compare_array, s16_first_n_locations)
+{
+    std::vector<int16_t> expected(100, -32768);
+    std::vector<int16_t> actual(100, 32767);
+    CompareResult res = compare_array(expected.data(), actual.data(), expected.size(), CompareTolerance(), 4);
+    EXPECT_EQ(res.mismatches, (size_t)100);
+    EXPECT_EQ(res.locations.size(), (size_t)4);
+    EXPECT_EQ(res.locations[3].x, (size_t)3);
+    EXPECT_EQ(res.max_abs_error, 65535.0);
+}
+
+TEST(compare_array, f32_ulp)
+{
+    const float one_up = nextafterf(1.0f, 2.0f);
+    const float expected[4] = { 1.0f, -0.0f, NAN, 1e-3f };
+    const float actual[4] = { nextafterf(one_up, 2.0f), 0.0f, NAN, 1.001e-3f };
+
+    CompareTolerance tol;
+    tol.max_ulp = 1;
+    CompareResult res = compare_array(expected, actual, 4, tol);
+    EXPECT_EQ(res.mismatches, (size_t)2);
+    EXPECT_EQ(res.locations[0].x, (size_t)0);
+    EXPECT_EQ(res.locations[1].x, (size_t)3);
+
+    tol.max_ulp = 2;
+    tol.rel_eps = 1e-3;
+    res = compare_array(expected, actual, 4, tol);
+    EXPECT_TRUE(res.ok());
+    EXPECT_EQ(compare_array(&one_up, &one_up, 1).max_ulp_error, (uint64_t)0);
+
+    const float nan = NAN;
+    const float zero = 0.0f;
+    EXPECT_FALSE(compare_array(&nan, &zero, 1).ok());
+}
+
+TEST(compare_register, f32x4)
+{
+    float32x4_t expected = { 1.0, 2.0, 3.0, 4.0 };
+    float32x4_t actual = { 1.0, 2.0, 3.5, 4.0 };
+    CompareResult res = compare_register(expected, actual);
+    EXPECT_EQ(res.count, (size_t)4);
+    EXPECT_EQ(res.mismatches, (size_t)1);
+    EXPECT_EQ(res.locations[0].x, (size_t)2);
+
+    CompareTolerance tol;
+    tol.abs_eps = 0.5;
+    EXPECT_TRUE(compare_register(expected, actual, tol).ok());
+}
+
+TEST(compare_array, integer_tolerance_beyond_type_range)
+{
+    // a tolerance wider than the type's max still accepts the full difference
+    const int8_t expected[3] = { -100, 100, -128 };
+    const int8_t actual[3] = { 100, -100, 127 };
+    CompareTolerance tol;
+    tol.abs_eps = 200;
+    CompareResult res = compare_array(expected, actual, 3, tol);
+    EXPECT_EQ(res.mismatches, (size_t)1);
+    EXPECT_EQ(res.locations.size(), (size_t)1);
+    EXPECT_EQ(res.locations[0].x, (size_t)2);
+    EXPECT_EQ(res.max_abs_error, 255.0);
+
+    // 64 bit differences beyond 2^53 are taken exactly
+    const int64_t big_e[2] = { INT64_MAX, INT64_MIN };
+    const int64_t big_a[2] = { INT64_MAX - 1, INT64_MAX };
+    tol.abs_eps = 1;
+    res = compare_array(big_e, big_a, 2, tol);
+    EXPECT_EQ(res.mismatches, (size_t)1);
+    EXPECT_EQ(res.locations[0].x, (size_t)1);
+
+    const uint64_t u_e[2] = { (1ull << 60) + 1, 0 };
+    const uint64_t u_a[2] = { 1ull << 60, UINT64_MAX };
+    tol.abs_eps = 0;
+    res = compare_array(u_e, u_a, 2, tol);
+    EXPECT_EQ(res.mismatches, (size_t)2);
+    tol.abs_eps = 1;
+    res = compare_array(u_e, u_a, 2, tol);
+    EXPECT_EQ(res.mismatches, (size_t)1);
+    EXPECT_EQ(res.locations[0].x, (size_t)1);
+}
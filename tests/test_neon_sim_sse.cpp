@@ -0,0 +1,92 @@
+#include "test_util.hpp"
+
+#include <random>
+
+// With NEON_SIM_FAST_SSE, `name(...)` may expand to the NEON_2_SSE route while
+// `(name)(...)` always calls the sim (or the native intrinsic on ARM). The two
+// must agree for every routed intrinsic; without fast mode this is trivially true.
+
+template<typename V>
+static V random_register(std::mt19937& rng)
+{
+    V v;
+    for (size_t i = 0; i < sizeof(V); i++)
+    {
+        ((uint8_t*)&v)[i] = (uint8_t)rng();
+    }
+    return v;
+}
+
+#define EXPECT_ROUTE_2(name, V) \
+    for (int t = 0; t < 200; t++) \
+    { \
+        const V a = random_register<V>(rng); \
+        const V b = random_register<V>(rng); \
+        EXPECT_TRUE(almostEqual((name)(a, b), name(a, b))); \
+    }
+
+TEST(neon_sim_sse, routed_matches_sim)
+{
+    std::mt19937 rng(58);
+    EXPECT_ROUTE_2(vaddq_u8, uint8x16_t);
+    EXPECT_ROUTE_2(vqsubq_s16, int16x8_t);
+    EXPECT_ROUTE_2(vsubq_s32, int32x4_t);
+    EXPECT_ROUTE_2(vmaxq_u8, uint8x16_t);
+    EXPECT_ROUTE_2(vminq_u16, uint16x8_t);
+    EXPECT_ROUTE_2(vandq_u32, uint32x4_t);
+    EXPECT_ROUTE_2(vhsub_u8, uint8x8_t);
+    EXPECT_ROUTE_2(vmulq_s16, int16x8_t);
+}
+
+#if NEON_SIM_FAST_SSE
+TEST(neon_sim_sse, routes_only_bit_exact)
+{
+    // routed
+#ifndef vaddq_u8
+    EXPECT_TRUE(false);
+#endif
+    // differs from the sim in neon_sim_sse_routes.inc, must keep the sim implementation
+#ifdef vhsub_s8
+    EXPECT_TRUE(false);
+#endif
+    const int8x8_t a = { -39, 93, -42, 48, 97, -80, 104, -115 };
+    const int8x8_t b = { 59, -122, -87, -66, -86, -123, -1, -22 };
+    EXPECT_TRUE(almostEqual((vhsub_s8)(a, b), vhsub_s8(a, b)));
+}
+#endif // NEON_SIM_FAST_SSE
+
+// Float arithmetic reads the FPCR and is never routed, so DN and FZ hold in fast mode too.
+TEST(neon_sim_sse, float_follows_fpcr)
+{
+#if NEON_SIM_FAST_SSE && (defined(vaddq_f32) || defined(vmulq_f32) || defined(vmaxq_f32) || defined(vmlaq_f32))
+    EXPECT_TRUE(false);
+#endif
+    float payload_nan, denormal;
+    const uint32_t payload_bits = 0xffc01234u, denormal_bits = 0x000116c2u;
+    memcpy(&payload_nan, &payload_bits, sizeof(float));
+    memcpy(&denormal, &denormal_bits, sizeof(float));
+    const float32x4_t n = { payload_nan, 1.0f, -2.0f, payload_nan };
+    const float32x4_t d = { denormal, denormal, 1.0f, -denormal };
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    NeonSimFpcrScope scope(NEON_SIM_FPCR_DN | NEON_SIM_FPCR_FZ);
+    const float32x4_t sum = vaddq_f32(n, d);
+    const float32x4_t product = vmulq_f32(d, one);
+    const float32x4_t acc = vmlaq_f32(n, d, one);
+    const float32x4_t maximum = vmaxq_f32(d, vdupq_n_f32(-1.0f));
+
+    const uint32_t default_nan = 0x7fc00000u;
+    uint32_t lanes[4];
+    memcpy(lanes, &sum, sizeof(lanes));
+    EXPECT_EQ(lanes[0], default_nan);
+    memcpy(lanes, &product, sizeof(lanes));
+    EXPECT_EQ(lanes[0], 0u);
+    EXPECT_EQ(lanes[3], 0x80000000u);
+    memcpy(lanes, &acc, sizeof(lanes));
+    EXPECT_EQ(lanes[3], default_nan);
+    memcpy(lanes, &maximum, sizeof(lanes));
+    EXPECT_EQ(lanes[0], 0u);
+
+    EXPECT_TRUE(almostEqual((vaddq_f32)(n, d), sum));
+    EXPECT_TRUE(almostEqual((vmulq_f32)(d, one), product));
+}
@@ -0,0 +1,137 @@
+#include "test_util.hpp"
+#include "neon_sim_kernels.hpp"
+#include "neon_sim_parallel.hpp"
+
+#include <random>
+#include <stdexcept>
+
+using namespace neon_sim_kernels;
+
+TEST(parallel, rows_cover_each_row_once)
+{
+    ThreadPool pool(4);
+    const int heights[] = { 1, 3, 17, 100 };
+    const int grains[] = { 0, 1, 7, 1000 };
+    for (int h : heights)
+    {
+        for (int grain : grains)
+        {
+            std::vector<int> hits(h, 0);
+            std::atomic<int> bad_worker(0);
+            ParallelStats stats;
+            parallel_rows(pool, h, grain, [&](int y0, int y1, int worker) {
+                bad_worker += !(worker >= 0 && worker < pool.num_threads());
+                for (int y = y0; y < y1; y++)
+                {
+                    hits[y]++;
+                }
+            }, &stats);
+            EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), h);
+            EXPECT_EQ(bad_worker.load(), 0);
+            EXPECT_EQ(stats.workers.size(), (size_t)4);
+            const int g = grain > 0 ? grain : std::max(1, h / 32);
+            EXPECT_EQ(stats.tasks(), (size_t)((h + g - 1) / g));
+        }
+    }
+}
+
+TEST(parallel, tiles_cover_each_pixel_once)
+{
+    ThreadPool pool(3);
+    const int w = 37;
+    const int h = 19;
+    std::vector<int> hits(w * h, 0);
+    std::atomic<int> oversized(0);
+    parallel_tiles(pool, w, h, 8, 5, [&](int x0, int y0, int x1, int y1, int) {
+        oversized += !(x1 - x0 <= 8 && y1 - y0 <= 5);
+        for (int y = y0; y < y1; y++)
+        {
+            for (int x = x0; x < x1; x++)
+            {
+                hits[y * w + x]++;
+            }
+        }
+    });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), w * h);
+    EXPECT_EQ(oversized.load(), 0);
+}
+
+TEST(parallel, rgb2gray_matches_serial)
+{
+    const int w = 67;
+    const int h = 45;
+    std::vector<uint8_t> rgb(w * h * 3);
+    std::mt19937 rng(55);
+    for (size_t i = 0; i < rgb.size(); i++)
+    {
+        rgb[i] = (uint8_t)rng();
+    }
+    std::vector<uint8_t> expected(w * h);
+    std::vector<uint8_t> actual(w * h);
+    rgb2gray(rgb.data(), w * 3, expected.data(), w, w, h);
+
+    ThreadPool pool(4);
+    parallel_rows(pool, h, 4, [&](int y0, int y1, int) {
+        rgb2gray(rgb.data() + y0 * w * 3, w * 3, actual.data() + y0 * w, w, w, y1 - y0);
+    });
+    EXPECT_TRUE(compare_array(expected.data(), actual.data(), expected.size()).ok());
+
+    // transpose by tiles writes disjoint destination blocks
+    std::vector<uint8_t> t_expected(w * h);
+    std::vector<uint8_t> t_actual(w * h);
+    transpose(expected.data(), w, t_expected.data(), h, w, h);
+    parallel_tiles(pool, w, h, 16, 16, [&](int x0, int y0, int x1, int y1, int) {
+        transpose(expected.data() + y0 * w + x0, w, t_actual.data() + x0 * h + y0, h, x1 - x0, y1 - y0);
+    });
+    EXPECT_TRUE(compare_array(t_expected.data(), t_actual.data(), t_expected.size()).ok());
+}
+
+TEST(parallel, per_thread_counters_merge)
+{
+    ThreadPool pool(4);
+    PerThread<size_t> counts(pool, 0);
+    parallel_rows(pool, 1000, 3, [&](int y0, int y1, int worker) {
+        counts.local(worker) += y1 - y0;
+    });
+    EXPECT_EQ(counts.merge((size_t)0, [](size_t a, size_t b) { return a + b; }), (size_t)1000);
+}
+
+TEST(parallel, uneven_tasks_are_stolen)
+{
+    // all the slow tasks start in worker 0's range
+    ThreadPool pool(2);
+    ParallelStats stats;
+    pool.run(64, [](size_t task, int) {
+        if (task < 32)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }, &stats);
+    EXPECT_EQ(stats.tasks(), (size_t)64);
+    EXPECT_TRUE(stats.steals() > 0);
+}
+
+TEST(parallel, exception_is_rethrown)
+{
+    ThreadPool pool(3);
+    bool caught = false;
+    try
+    {
+        pool.run(100, [](size_t task, int) {
+            if (task == 42)
+            {
+                throw std::runtime_error("task 42");
+            }
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    EXPECT_TRUE(caught);
+
+    // the pool is still usable
+    ParallelStats stats;
+    pool.run(10, [](size_t, int) {}, &stats);
+    EXPECT_EQ(stats.tasks(), (size_t)10);
+}
@@ -0,0 +1,175 @@
+#include "test_util.hpp"
+#include "neon_sim_kernels.hpp"
+#include "neon_sim_pipeline.hpp"
+
+#include <stdio.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace neon_sim_kernels;
+
+TEST(pipeline, bounded_queue_blocks_and_drains)
+{
+    BoundedQueue<int> q(2);
+    EXPECT_TRUE(q.push(1));
+    EXPECT_TRUE(q.push(2));
+
+    // a third push waits until the consumer makes room
+    std::atomic<bool> pushed(false);
+    std::thread producer([&] {
+        q.push(3);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());
+
+    int v = 0;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+
+    q.close();
+    EXPECT_FALSE(q.push(4));
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 2);
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 3);
+    EXPECT_FALSE(q.pop(v));
+}
+
+static std::vector<std::string> write_dataset(int n, int w, int h)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < n; i++)
+    {
+        const std::string path = "test_pipeline_" + std::to_string(i) + ".pgm";
+        std::vector<uint8_t> px(w * h);
+        for (size_t k = 0; k < px.size(); k++)
+        {
+            px[k] = (uint8_t)(k * 7 + i * 13);
+        }
+        ImageView v;
+        v.data = px.data();
+        v.step = w;
+        v.width = w;
+        v.height = h;
+        v.channels = 1;
+        save_pnm(path, v);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+static DatasetKernel threshold_kernel()
+{
+    DatasetKernel k;
+    k.name = "threshold";
+    k.output_channels = 1;
+    k.sim = [](const ImageView& in, const MutableImageView& out) {
+        threshold(in.data, in.step, out.data, out.step, in.width, in.height, 100, 0, 255);
+    };
+    k.ref = [](const ImageView& in, const MutableImageView& out) {
+        ref::threshold(in.data, in.step, out.data, out.step, in.width, in.height, 100, 0, 255);
+    };
+    return k;
+}
+
+TEST(pipeline, dataset_passes)
+{
+    std::vector<std::string> paths = write_dataset(12, 37, 9);
+    PipelineOptions opt;
+    opt.load_threads = 2;
+    opt.sim_threads = 3;
+    opt.queue_capacity = 2;
+
+    std::atomic<int> callbacks(0);
+    DatasetReport rep = run_dataset(paths, threshold_kernel(), opt, [&](const DatasetResult& r) {
+        callbacks += r.compare.ok();
+    });
+    EXPECT_TRUE(rep.ok());
+    EXPECT_EQ(rep.images, (size_t)12);
+    EXPECT_EQ(callbacks.load(), 12);
+    EXPECT_EQ(rep.stages.size(), (size_t)4);
+    EXPECT_TRUE(rep.stages[1].name == "sim");
+    EXPECT_EQ(rep.stages[1].threads, 3);
+    for (size_t i = 0; i < rep.stages.size(); i++)
+    {
+        EXPECT_EQ(rep.stages[i].items, (size_t)12);
+    }
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        remove(paths[i].c_str());
+    }
+}
+
+TEST(pipeline, mismatches_and_load_errors_are_reported)
+{
+    std::vector<std::string> paths = write_dataset(4, 16, 4);
+    paths.insert(paths.begin() + 2, "test_pipeline_missing.pgm");
+
+    DatasetKernel k = threshold_kernel();
+    k.sim = [](const ImageView& in, const MutableImageView& out) {
+        threshold(in.data, in.step, out.data, out.step, in.width, in.height, 100, 0, 255);
+        out.row(1)[3] ^= 1;
+    };
+    DatasetReport rep = run_dataset(paths, k, PipelineOptions());
+    EXPECT_FALSE(rep.ok());
+    EXPECT_EQ(rep.images, (size_t)5);
+    EXPECT_EQ(rep.load_errors, (size_t)1);
+    EXPECT_EQ(rep.mismatched_images, (size_t)4);
+    EXPECT_EQ(rep.failures.size(), (size_t)5);
+    EXPECT_FALSE(rep.failures[2].loaded);
+    EXPECT_EQ(rep.failures[0].compare.mismatches, (size_t)1);
+    EXPECT_EQ(rep.failures[0].compare.locations[0].y, (size_t)1);
+    EXPECT_EQ(rep.failures[0].compare.locations[0].x, (size_t)3);
+
+    // within tolerance
+    k.tolerance.abs_eps = 1;
+    rep = run_dataset(paths, k, PipelineOptions());
+    EXPECT_EQ(rep.mismatched_images, (size_t)0);
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        remove(paths[i].c_str());
+    }
+}
+
+TEST(pipeline, throwing_kernel_fails_only_its_image)
+{
+    std::vector<std::string> paths = write_dataset(6, 16, 4);
+    DatasetKernel k = threshold_kernel();
+    k.sim = [](const ImageView& in, const MutableImageView& out) {
+        if (in.data[0] == 13)  // first pixel of image 1
+        {
+            throw std::runtime_error("sim failed");
+        }
+        threshold(in.data, in.step, out.data, out.step, in.width, in.height, 100, 0, 255);
+    };
+    const DatasetKernel good_ref = k;
+    k.ref = [&](const ImageView& in, const MutableImageView& out) {
+        if (in.data[0] == 52)  // image 4
+        {
+            throw 4;
+        }
+        good_ref.ref(in, out);
+    };
+    PipelineOptions opt;
+    opt.sim_threads = 2;
+    opt.queue_capacity = 1;
+    DatasetReport rep = run_dataset(paths, k, opt);
+    EXPECT_FALSE(rep.ok());
+    EXPECT_EQ(rep.images, (size_t)6);
+    EXPECT_EQ(rep.kernel_errors, (size_t)2);
+    EXPECT_EQ(rep.mismatched_images, (size_t)0);
+    EXPECT_EQ(rep.failures.size(), (size_t)2);
+    EXPECT_EQ(rep.failures[0].index, (size_t)1);
+    EXPECT_TRUE(rep.failures[0].kernel_failed);
+    EXPECT_TRUE(rep.failures[0].error == paths[1] + ": threshold sim: sim failed");
+    EXPECT_EQ(rep.failures[1].index, (size_t)4);
+    EXPECT_TRUE(rep.failures[1].error == paths[4] + ": threshold ref: unknown exception");
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        remove(paths[i].c_str());
+    }
+}
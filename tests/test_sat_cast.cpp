@@ -0,0 +1,197 @@
+#include "test_util.hpp"
+#include "sat_cast_array.h"
+
+#include <limits>
+#include <stdio.h>
+#include <string.h>
+
+// The bulk sat_cast of legacy/neon_pedal/cast against the scalar sat_cast,
+// element by element (bitwise). 8/16 bit inputs are exhaustive; 32 bit and
+// float inputs are the seed values of sat_cast_*_test.cpp, dense ranges
+// around the boundaries and a strided sweep of the whole range.
+
+template<typename Dst, typename Src>
+static size_t count_mismatch(const std::vector<Src>& input)
+{
+    std::vector<Dst> bulk(input.size());
+    sat_cast<Dst>(input.data(), bulk.data(), input.size());
+
+    size_t mismatch = 0;
+    for (size_t i = 0; i < input.size(); i++)
+    {
+        const Dst expected = sat_cast<Dst>(input[i]);
+        if (memcmp(&expected, &bulk[i], sizeof(Dst)) != 0)
+        {
+            if (mismatch == 0)
+            {
+                printf("first mismatch at %zu, input=%.17g\n", i, (double)input[i]);
+            }
+            mismatch++;
+        }
+    }
+    return mismatch;
+}
+
+// mismatches over every destination type
+template<typename Src>
+static size_t count_mismatch_all(const std::vector<Src>& input)
+{
+    return count_mismatch<uchar>(input) + count_mismatch<schar>(input) + count_mismatch<ushort>(input) +
+           count_mismatch<short>(input) + count_mismatch<int>(input) + count_mismatch<unsigned>(input) +
+           count_mismatch<float>(input) + count_mismatch<double>(input);
+}
+
+template<typename Src>
+static std::vector<Src> exhaustive_input()
+{
+    std::vector<Src> input;
+    for (int64 v = std::numeric_limits<Src>::min(); v <= std::numeric_limits<Src>::max(); v++)
+    {
+        input.push_back((Src)v);
+    }
+    return input;
+}
+
+TEST(sat_cast_array, uchar)
+{
+    EXPECT_EQ(0u, count_mismatch_all(exhaustive_input<uchar>()));
+}
+
+TEST(sat_cast_array, schar)
+{
+    EXPECT_EQ(0u, count_mismatch_all(exhaustive_input<schar>()));
+}
+
+TEST(sat_cast_array, ushort)
+{
+    EXPECT_EQ(0u, count_mismatch_all(exhaustive_input<ushort>()));
+}
+
+TEST(sat_cast_array, short)
+{
+    EXPECT_EQ(0u, count_mismatch_all(exhaustive_input<short>()));
+}
+
+TEST(sat_cast_array, int)
+{
+    std::vector<int> input = { 100, -100, 257, -257, 65536, -65536, INT_MAX, INT_MIN, INT_MAX - 1, INT_MIN + 1 };
+    for (int64 v = INT_MIN; v <= INT_MAX; v += 65537)
+    {
+        input.push_back((int)v);
+    }
+    for (int v = -70000; v <= 70000; v++)
+    {
+        input.push_back(v);
+    }
+    EXPECT_EQ(0u, count_mismatch_all(input));
+}
+
+TEST(sat_cast_array, unsigned)
+{
+    std::vector<unsigned> input = { 100, 257, 65536, UINT_MAX, UINT_MAX - 1, (unsigned)INT_MAX, (unsigned)INT_MAX + 1 };
+    for (uint64 v = 0; v <= UINT_MAX; v += 65537)
+    {
+        input.push_back((unsigned)v);
+    }
+    for (unsigned v = 0; v <= 140000; v++)
+    {
+        input.push_back(v);
+    }
+    EXPECT_EQ(0u, count_mismatch_all(input));
+}
+
+// the scalar version is undefined for NaN and floats outside the int range,
+// so only |v| < 2^31 is compared; the bit sweep is strided to keep the run short
+template<typename Src>
+static std::vector<Src> float_input()
+{
+    std::vector<Src> input = { 100.4f, 100.5f, -100.5f, 257.f, -257.f, 0.49999997f, -0.49999997f, 2.5f, -2.5f };
+    for (uint64 bits = 0; bits <= UINT_MAX; bits += 9973)
+    {
+        const unsigned u = (unsigned)bits;
+        float v;
+        memcpy(&v, &u, sizeof(v));
+        if (fabsf(v) < 2147483520.f)
+        {
+            input.push_back(v);
+        }
+    }
+    // every quarter step around the 8/16 bit ranges, plus both float neighbours
+    for (int k = -280000; k < 280000; k++)
+    {
+        const float v = k * 0.25f;
+        input.push_back(v);
+        input.push_back(nextafterf(v, -1e9f));
+        input.push_back(nextafterf(v, 1e9f));
+    }
+    return input;
+}
+
+TEST(sat_cast_array, float)
+{
+    const std::vector<float> input = float_input<float>();
+    EXPECT_EQ(0u, count_mismatch<uchar>(input));
+    EXPECT_EQ(0u, count_mismatch<schar>(input));
+    EXPECT_EQ(0u, count_mismatch<ushort>(input));
+    EXPECT_EQ(0u, count_mismatch<short>(input));
+    EXPECT_EQ(0u, count_mismatch<int>(input));
+    EXPECT_EQ(0u, count_mismatch<unsigned>(input));
+    EXPECT_EQ(0u, count_mismatch<double>(input));
+}
+
+TEST(sat_cast_array, double)
+{
+    std::vector<float> seeds = float_input<float>();
+    std::vector<double> input(seeds.begin(), seeds.end());
+    input.push_back(2147483647.0);
+    input.push_back(2147483646.5);
+    input.push_back(-2147483648.0);
+    EXPECT_EQ(0u, count_mismatch<uchar>(input));
+    EXPECT_EQ(0u, count_mismatch<schar>(input));
+    EXPECT_EQ(0u, count_mismatch<ushort>(input));
+    EXPECT_EQ(0u, count_mismatch<short>(input));
+    EXPECT_EQ(0u, count_mismatch<int>(input));
+    EXPECT_EQ(0u, count_mismatch<unsigned>(input));
+    EXPECT_EQ(0u, count_mismatch<float>(input));
+}
+
+TEST(sat_cast_array, out_of_range_saturates)
+{
+    const float input[4] = { 1e10f, -1e10f, 3e9f, -3e9f };
+    uchar u8[4];
+    int s32[4];
+    sat_cast<uchar>(input, u8, 4);
+    sat_cast<int>(input, s32, 4);
+    EXPECT_EQ(255, u8[0]);
+    EXPECT_EQ(0, u8[1]);
+    EXPECT_EQ(INT_MAX, s32[2]);
+    EXPECT_EQ(INT_MIN, s32[3]);
+}
+
+TEST(sat_cast_array, image)
+{
+    // 3 channels with row padding on both sides: only width * 3 elements per
+    // row are written
+    const int width = 37;
+    const int height = 5;
+    const size_t src_stride = (width + 3) * 3;
+    const size_t dst_stride = (width + 2) * 3;
+    std::vector<float> src(src_stride * height);
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        src[i] = (float)((int)(i * 7919 % 6000) - 3000) * 0.1f;
+    }
+    std::vector<uchar> dst(dst_stride * height, 7);
+    const float* src_roi = src.data() + 3;
+    sat_cast<uchar>(src_roi, src_stride * sizeof(float), dst.data(), dst_stride, width * 3, height);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width * 3; x++)
+        {
+            EXPECT_EQ(sat_cast<uchar>(src_roi[y * src_stride + x]), dst[y * dst_stride + x]);
+        }
+        // padding untouched
+        EXPECT_EQ(7, dst[y * dst_stride + width * 3]);
+    }
+}
@@ -0,0 +1,269 @@
+#include "test_util.hpp"
+#include "arm_sme_sim.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+const int kStreamingLengths[] = { 128, 256, 512, 2048 };
+
+// restores the thread's streaming vector length at scope exit
+struct ScopedSVL
+{
+    int saved;
+    explicit ScopedSVL(int bits) : saved(sme_sim_get_svl())
+    {
+        sme_sim_set_svl(bits);
+    }
+    ~ScopedSVL()
+    {
+        sme_sim_set_svl(saved);
+    }
+};
+
+// C = A * B with FMOPA into ZA0.S; At is A transposed (K x M), the tail tiles predicated
+static void sme_sgemm(const float* At, const float* B, float* C, int M, int N, int K)
+{
+    SmeStreamingScope streaming;
+    const int dim = (int)svcntsw();
+    for (int i0 = 0; i0 < M; i0 += dim)
+    {
+        const svbool_t pn = svwhilelt_b32_s32(i0, M);
+        for (int j0 = 0; j0 < N; j0 += dim)
+        {
+            const svbool_t pm = svwhilelt_b32_s32(j0, N);
+            svzero_za();
+            for (int k = 0; k < K; k++)
+            {
+                svmopa_za32_f32_m(0, pn, pm, svld1_f32(pn, At + k * M + i0), svld1_f32(pm, B + k * N + j0));
+            }
+            for (int r = 0; r < dim && i0 + r < M; r++)
+            {
+                svst1_hor_za32(0, (uint32_t)r, pm, C + (i0 + r) * N + j0);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(sme, streaming_vector_length)
+{
+    ScopedSVL svl(512);
+    sve_sim_set_vl(256);
+    EXPECT_EQ(svcntsw(), 16u);
+    EXPECT_FALSE(__arm_in_streaming_mode());
+    EXPECT_EQ(svcntw(), 8u);
+    {
+        SmeStreamingScope streaming;
+        EXPECT_TRUE(__arm_in_streaming_mode());
+        EXPECT_EQ(svcntw(), 16u);
+        EXPECT_EQ(sve_sim_get_vl(), 512);
+    }
+    EXPECT_FALSE(__arm_in_streaming_mode());
+    EXPECT_EQ(sve_sim_get_vl(), 256);
+    sve_sim_set_vl(128);
+}
+
+TEST(sme, za_tile_layout)
+{
+    ScopedSVL svl(256);
+    SmeStreamingScope streaming;
+    const uint32_t dim = (uint32_t)svcntsw();
+    const svbool_t all = svptrue_b32();
+
+    // rows of ZA1.S are slices of columns of the same tile read vertically
+    for (uint32_t r = 0; r < dim; r++)
+    {
+        svwrite_hor_za32_u32_m(1, r, all, svindex_u32(r * 100, 1));
+    }
+    const svuint32_t col3 = svread_ver_za32_u32_m(svdup_n_u32(0), all, 1, 3);
+    for (uint32_t r = 0; r < dim; r++)
+    {
+        EXPECT_EQ(col3.val[r], r * 100 + 3);
+    }
+    // other tiles untouched
+    EXPECT_EQ(svread_hor_za32_u32_m(svdup_n_u32(7), all, 0, 2).val[0], 0u);
+
+    // ZA1.S row i is ZA row 4 i + 1: ZA1.D holds its even rows, ZA5.D the odd ones
+    svzero_mask_za(1u << 1);
+    for (uint32_t r = 0; r < dim; r++)
+    {
+        const svuint32_t row = svread_hor_za32_u32_m(svdup_n_u32(0), all, 1, r);
+        EXPECT_EQ(row.val[0], r % 2 ? r * 100 : 0u);
+    }
+
+    // LDR / STR move whole ZA rows
+    std::vector<uint8_t> bytes(svcntsb());
+    svstr_za(4 * 3 + 1, bytes.data());
+    uint32_t first;
+    memcpy(&first, bytes.data(), sizeof(first));
+    EXPECT_EQ(first, 300u);
+}
+
+TEST(sme, load_store_slices)
+{
+    ScopedSVL svl(128);
+    SmeStreamingScope streaming;
+    const float src[4] = { 1, 2, 3, 4 };
+    const svbool_t first3 = svwhilelt_b32_s32(0, 3);
+
+    svld1_ver_za32(2, 1, first3, src);
+    float out[4] = { -1, -1, -1, -1 };
+    svst1_ver_za32(2, 1, svptrue_b32(), out);
+    EXPECT_EQ(out[0], 1.0f);
+    EXPECT_EQ(out[2], 3.0f);
+    EXPECT_EQ(out[3], 0.0f); // inactive lanes load as zero
+
+    float row[4] = { -1, -1, -1, -1 };
+    svst1_hor_za32(2, 2, first3, row);
+    EXPECT_EQ(row[1], 3.0f);
+    EXPECT_EQ(row[3], -1.0f); // and are not stored
+
+    const uint64_t d[2] = { 5, 6 };
+    svld1_hor_za64(7, 0, svptrue_b64(), d);
+    EXPECT_EQ(svread_hor_za64_u64_m(svdup_n_u64(0), svptrue_b64(), 7, 0).val[1], 6u);
+}
+
+TEST(sme, fmopa_gemm_matches_reference)
+{
+    const int M = 37, N = 29, K = 23;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> A(M * K), B(K * N), At(K * M);
+    for (float& v : A)
+    {
+        v = dist(rng);
+    }
+    for (float& v : B)
+    {
+        v = dist(rng);
+    }
+    for (int i = 0; i < M; i++)
+    {
+        for (int k = 0; k < K; k++)
+        {
+            At[k * M + i] = A[i * K + k];
+        }
+    }
+    // same fused multiply-add order as FMOPA: k ascending from zero
+    std::vector<float> expected(M * N, 0.0f);
+    for (int i = 0; i < M; i++)
+    {
+        for (int k = 0; k < K; k++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                expected[i * N + j] = std::fma(A[i * K + k], B[k * N + j], expected[i * N + j]);
+            }
+        }
+    }
+
+    for (int bits : kStreamingLengths)
+    {
+        ScopedSVL svl(bits);
+        std::vector<float> C(M * N, -99.0f);
+        sme_sgemm(At.data(), B.data(), C.data(), M, N, K);
+        EXPECT_EQ(memcmp(C.data(), expected.data(), C.size() * sizeof(float)), 0);
+    }
+}
+
+TEST(sme, fmops_and_addha)
+{
+    ScopedSVL svl(128);
+    SmeStreamingScope streaming;
+    const svbool_t all = svptrue_b32();
+    const svbool_t first2 = svwhilelt_b32_s32(0, 2);
+
+    svzero_za();
+    svmopa_za32_f32_m(3, all, first2, svdup_n_f32(2.0f), svdup_n_f32(3.0f));
+    svmops_za32_m(3, first2, all, svdup_n_f32(1.0f), svdup_n_f32(1.0f));
+    const svfloat32_t r0 = svread_hor_za32_f32_m(svdup_n_f32(0), all, 3, 0);
+    const svfloat32_t r3 = svread_hor_za32_f32_m(svdup_n_f32(0), all, 3, 3);
+    EXPECT_EQ(r0.val[0], 5.0f);
+    EXPECT_EQ(r0.val[3], -1.0f);
+    EXPECT_EQ(r3.val[1], 6.0f);
+    EXPECT_EQ(r3.val[2], 0.0f);
+
+    svzero_za();
+    svaddha_za32_s32_m(0, all, all, svindex_s32(0, 1));
+    svaddva_za32_s32_m(0, all, first2, svindex_s32(10, 10));
+    const svint32_t h = svread_hor_za32_s32_m(svdup_n_s32(0), all, 0, 2);
+    EXPECT_EQ(h.val[0], 30);
+    EXPECT_EQ(h.val[1], 31);
+    EXPECT_EQ(h.val[2], 2);
+}
+
+TEST(sme, widening_mopa)
+{
+    ScopedSVL svl(256);
+    SmeStreamingScope streaming;
+    const size_t lanes = svcntsb();
+    std::mt19937 rng(5);
+    std::vector<int8_t> a(lanes), b(lanes);
+    for (size_t i = 0; i < lanes; i++)
+    {
+        a[i] = (int8_t)rng();
+        b[i] = (int8_t)rng();
+    }
+    const svint8_t za = svld1_s8(svptrue_b8(), a.data());
+    const svint8_t zb = svld1_s8(svptrue_b8(), b.data());
+    const svuint8_t ua = svld1_u8(svptrue_b8(), (const uint8_t*)a.data());
+    const svuint8_t ub = svld1_u8(svptrue_b8(), (const uint8_t*)b.data());
+    // the last byte of every row group inactive
+    svbool_t pn = svptrue_b8();
+    for (size_t i = 3; i < lanes; i += 4)
+    {
+        pn.val[i] = false;
+    }
+    const svbool_t all = svptrue_b8();
+
+    svzero_za();
+    svmopa_za32_s8_m(0, pn, all, za, zb);
+    svmopa_za32_u8_m(1, all, all, ua, ub);
+    svsumopa_za32_s8_m(2, all, all, za, ub);
+    svusmopa_za32_u8_m(3, all, all, ua, zb);
+    const uint32_t dim = (uint32_t)svcntsw();
+    for (uint32_t i = 0; i < dim; i++)
+    {
+        const svint32_t s = svread_hor_za32_s32_m(svdup_n_s32(0), svptrue_b32(), 0, i);
+        const svuint32_t u = svread_hor_za32_u32_m(svdup_n_u32(0), svptrue_b32(), 1, i);
+        const svint32_t su = svread_hor_za32_s32_m(svdup_n_s32(0), svptrue_b32(), 2, i);
+        const svint32_t us = svread_hor_za32_s32_m(svdup_n_s32(0), svptrue_b32(), 3, i);
+        for (uint32_t j = 0; j < dim; j++)
+        {
+            int32_t es = 0, esu = 0, eus = 0;
+            uint32_t eu = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                const int8_t x = a[4 * i + k], y = b[4 * j + k];
+                es += k < 3 ? x * y : 0;
+                eu += (uint32_t)(uint8_t)x * (uint8_t)y;
+                esu += x * (uint8_t)y;
+                eus += (uint8_t)x * y;
+            }
+            EXPECT_EQ(s.val[j], es);
+            EXPECT_EQ(u.val[j], eu);
+            EXPECT_EQ(su.val[j], esu);
+            EXPECT_EQ(us.val[j], eus);
+        }
+    }
+
+    // BFMOPA: pairs of bf16 products summed in fp32
+    std::vector<bfloat16_t> x(svcntsh()), y(svcntsh());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        x[i] = bfloat16_t(0.25f * (float)i);
+        y[i] = bfloat16_t(1.0f + 0.5f * (float)(i % 3));
+    }
+    svzero_za();
+    svmopa_za32_bf16_m(1, svptrue_b16(), svptrue_b16(), svld1_bf16(svptrue_b16(), x.data()),
+                       svld1_bf16(svptrue_b16(), y.data()));
+    const svfloat32_t r = svread_hor_za32_f32_m(svdup_n_f32(0), svptrue_b32(), 1, 2);
+    EXPECT_EQ(r.val[1], (float)x[4] * (float)y[2] + (float)x[5] * (float)y[3]);
+
+    EXPECT_EQ(bfloat16_t(1.0f).bits, 0x3f80);
+    EXPECT_EQ(bfloat16_t(1.00390625f).bits, 0x3f80); // tie rounds to even
+    EXPECT_EQ(bfloat16_t(1.01171875f).bits, 0x3f82);
+}
@@ -0,0 +1,223 @@
+#include "test_util.hpp"
+#include "arm_sve_sim.hpp"
+
+#include <random>
+#include <thread>
+
+namespace {
+
+// every vector length a kernel should be checked at: the common 128 / 256 / 512
+// fast paths, a non power of two and the maximum
+const int kVectorLengths[] = { 128, 256, 384, 512, 2048 };
+
+// restores the thread's vector length at scope exit
+struct ScopedVL
+{
+    int saved;
+    explicit ScopedVL(int bits) : saved(sve_sim_get_vl())
+    {
+        sve_sim_set_vl(bits);
+    }
+    ~ScopedVL()
+    {
+        sve_sim_set_vl(saved);
+    }
+};
+
+// y = a * x + y with a whilelt loop; returns the iteration count
+static int saxpy(float a, const float* x, float* y, int64_t n)
+{
+    int iterations = 0;
+    for (int64_t i = 0; i < n; i += svcntw())
+    {
+        const svbool_t pg = svwhilelt_b32_s64(i, n);
+        const svfloat32_t vx = svld1_f32(pg, x + i);
+        svst1_f32(pg, y + i, svmla_n_f32_x(pg, svld1_f32(pg, y + i), vx, a));
+        iterations++;
+    }
+    return iterations;
+}
+
+} // namespace
+
+TEST(sve, vector_length)
+{
+    for (int vl : kVectorLengths)
+    {
+        ScopedVL scoped(vl);
+        EXPECT_EQ(sve_sim_get_vl(), vl);
+        EXPECT_EQ(svcntb(), (uint64_t)vl / 8);
+        EXPECT_EQ(svcnth(), (uint64_t)vl / 16);
+        EXPECT_EQ(svcntw(), (uint64_t)vl / 32);
+        EXPECT_EQ(svcntd(), (uint64_t)vl / 64);
+        EXPECT_EQ(svcntp_b32(svptrue_b8(), svptrue_b32()), (uint64_t)vl / 32);
+    }
+}
+
+TEST(sve, vector_length_is_per_thread)
+{
+    ScopedVL scoped(512);
+    int other = 0;
+    std::thread t([&]() {
+        sve_sim_set_vl(256);
+        other = (int)svcntb();
+    });
+    t.join();
+    EXPECT_EQ(other, 32);
+    EXPECT_EQ(svcntb(), 64u);
+}
+
+TEST(sve, whilelt_loop_matches_scalar)
+{
+    const int64_t n = 103;
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+    std::mt19937 rng(61);
+    std::uniform_real_distribution<float> dist(-8.0f, 8.0f);
+    for (int64_t i = 0; i < n; i++)
+    {
+        x[i] = dist(rng);
+        y[i] = dist(rng);
+    }
+    for (int vl : kVectorLengths)
+    {
+        ScopedVL scoped(vl);
+        std::vector<float> actual = y;
+        const int iterations = saxpy(0.75f, x.data(), actual.data(), n);
+        const int lanes = vl / 32;
+        EXPECT_EQ(iterations, (int)((n + lanes - 1) / lanes));
+        for (int64_t i = 0; i < n; i++)
+        {
+            EXPECT_EQ(actual[i], std::fma(0.75f, x[i], y[i]));
+        }
+    }
+}
+
+TEST(sve, predication_modes)
+{
+    ScopedVL scoped(256);
+    const svint32_t a = svindex_s32(10, 10); // 10 20 ... 80
+    const svint32_t b = svdup_n_s32(3);
+    const svbool_t pg = svwhilelt_b32_s32(0, 5);
+    const svint32_t m = svsub_s32_m(pg, a, b);
+    const svint32_t x = svsub_s32_x(pg, a, b);
+    const svint32_t z = svsub_n_s32_z(pg, a, 3);
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(m[i], i < 5 ? 10 * (i + 1) - 3 : 10 * (i + 1));
+        EXPECT_EQ(x[i], 10 * (i + 1) - 3);
+        EXPECT_EQ(z[i], i < 5 ? 10 * (i + 1) - 3 : 0);
+    }
+    // lanes past the vector length stay zero
+    for (size_t i = 8; i < svint32_t().size(); i++)
+    {
+        EXPECT_EQ(a[i], 0);
+        EXPECT_EQ(x[i], 0);
+    }
+    const svint32_t neg = svneg_s32_m(b, pg, a);
+    EXPECT_EQ(neg[0], -10);
+    EXPECT_EQ(neg[7], 3);
+    const svint32_t sel = svsel_s32(svcmpgt_n_s32(svptrue_b32(), a, 45), a, b);
+    EXPECT_EQ(sel[3], 3);
+    EXPECT_EQ(sel[4], 50);
+}
+
+TEST(sve, predicates)
+{
+    ScopedVL scoped(128);
+    const svbool_t p = svwhilelt_b16_u64(5, 9); // 4 of 8 halfword lanes
+    EXPECT_EQ(svcntp_b16(svptrue_b16(), p), 4u);
+    EXPECT_TRUE(svptest_first(svptrue_b16(), p));
+    EXPECT_FALSE(svptest_last(svptrue_b16(), p));
+    EXPECT_TRUE(svptest_any(svptrue_b16(), p));
+    EXPECT_FALSE(svptest_any(svptrue_b16(), svwhilelt_b16_s32(7, 7)));
+    EXPECT_EQ(svcntp_b16(svptrue_b16(), svnot_b_z(svptrue_b16(), p)), 4u);
+    // a b32 predicate seen as b16 has every other lane active
+    EXPECT_EQ(svcntp_b16(svptrue_b16(), svptrue_b32()), 4u);
+}
+
+TEST(sve, gather_scatter)
+{
+    for (int vl : kVectorLengths)
+    {
+        ScopedVL scoped(vl);
+        std::vector<float> table(1024);
+        for (size_t i = 0; i < table.size(); i++)
+        {
+            table[i] = (float)i * 0.5f;
+        }
+        const svuint32_t idx = svmul_n_u32_x(svptrue_b32(), svindex_u32(0, 1), 7);
+        const svbool_t pg = svwhilelt_b32_s32(0, 6);
+        const svfloat32_t g = svld1_gather_u32index_f32(pg, table.data(), idx);
+        const svfloat32_t go = svld1_gather_u32offset_f32(pg, table.data(), svmul_n_u32_x(svptrue_b32(), idx, 4));
+        for (int i = 0; i < (int)svcntw(); i++)
+        {
+            EXPECT_EQ(g[i], i < 6 ? (float)(7 * i) * 0.5f : 0.0f);
+            EXPECT_EQ(go[i], g[i]);
+        }
+        std::vector<float> out(1024, -1.0f);
+        svst1_scatter_u32index_f32(pg, out.data(), idx, g);
+        EXPECT_EQ(out[14], 7.0f);
+        EXPECT_EQ(out[42], -1.0f);
+    }
+}
+
+TEST(sve, reductions)
+{
+    for (int vl : kVectorLengths)
+    {
+        ScopedVL scoped(vl);
+        const svbool_t all = svptrue_b8();
+        const uint64_t bytes = svcntb();
+        // 255 in every lane: the sum widens to 64 bits
+        EXPECT_EQ(svaddv_u8(all, svdup_n_u8(255)), 255 * bytes);
+        EXPECT_EQ(svaddv_s8(all, svdup_n_s8(-128)), -128 * (int64_t)bytes);
+        const svint16_t ramp = svindex_s16(-5, 3);
+        EXPECT_EQ(svmaxv_s16(svptrue_b16(), ramp), (int16_t)(-5 + 3 * (svcnth() - 1)));
+        EXPECT_EQ(svminv_s16(svnot_b_z(svptrue_b16(), svwhilelt_b16_s32(0, 2)), ramp), 1);
+    }
+    ScopedVL scoped(128);
+    const svfloat32_t v = svdup_n_f32(0.0f);
+    svfloat32_t w = v;
+    w[0] = 1e8f;
+    w[1] = 1.0f;
+    w[2] = -1e8f;
+    w[3] = 1.0f;
+    // FADDV: (1e8 + 1) + (-1e8 + 1) = 0, FADDA: ((0 + 1e8) + 1) - 1e8 + 1 = 1
+    EXPECT_EQ(svaddv_f32(svptrue_b32(), w), 0.0f);
+    EXPECT_EQ(svadda_f32(svptrue_b32(), 0.0f, w), 1.0f);
+}
+
+TEST(sve, integer_corner_cases)
+{
+    ScopedVL scoped(128);
+    const svbool_t all = svptrue_b32();
+    const svint32_t a = svdup_n_s32(INT32_MIN);
+    EXPECT_EQ(svdiv_n_s32_x(all, a, -1)[0], INT32_MIN);
+    EXPECT_EQ(svdiv_n_s32_x(all, a, 0)[0], 0);
+    EXPECT_EQ(svqadd_n_s32(a, -1)[0], INT32_MIN);
+    EXPECT_EQ(svqsub_n_u32(svdup_n_u32(3), 5)[0], 0u);
+    EXPECT_EQ(svadd_n_s32_x(all, svdup_n_s32(INT32_MAX), 1)[0], INT32_MIN);
+    EXPECT_EQ(svabs_s32_x(all, a)[0], INT32_MIN);
+    EXPECT_EQ(svcvt_s32_f32_x(all, svdup_n_f32(3e9f))[0], INT32_MAX);
+    EXPECT_EQ(svcvt_s32_f32_x(all, svdup_n_f32(-2.7f))[0], -2);
+}
+
+TEST(sve, sve2_widening)
+{
+    ScopedVL scoped(256);
+    const svint8_t a = svindex_s8(-8, 1);
+    const svint8_t b = svdup_n_s8(100);
+    const svint16_t lo = svmullb_s16(a, b);
+    const svint16_t hi = svmullt_s16(a, b);
+    for (int i = 0; i < (int)svcnth(); i++)
+    {
+        EXPECT_EQ(lo[i], (int16_t)((2 * i - 8) * 100));
+        EXPECT_EQ(hi[i], (int16_t)((2 * i + 1 - 8) * 100));
+    }
+    const svint32_t p = svaddp_s32_x(svptrue_b32(), svindex_s32(0, 1), svdup_n_s32(5));
+    EXPECT_EQ(p[0], 1);
+    EXPECT_EQ(p[1], 10);
+    EXPECT_EQ(p[2], 5);
+    EXPECT_EQ(p[3], 10);
+}
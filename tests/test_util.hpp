@@ -5,11 +5,14 @@
 #define TEST UTEST
 
 #include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
 #include <vector>
 #include <cmath>
 
-#define NEON_SIM_IMPLEMENTATION
-
+// NEON_SIM_IMPLEMENTATION is defined only in test_main.cpp, all test_*.cpp
+// files are linked into the same executable.
 #if __ARM_NEON
 #include <arm_neon.h>
 #include "arm_neon_helper.hpp"
@@ -17,80 +20,41 @@
 #include "arm_neon_sim.hpp"
 #endif // __ARM_NEON
 
-static bool almostEqual(const uint8x8_t& expected, const uint8x8_t& actual, double eps=0)
-{
-    for (int i = 0; i < 8; i++)
-    {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
-    }
-    return true;
-}
+#include "neon_sim_compare.hpp"
 
-static bool almostEqual(const int8x8_t& expected, const int8x8_t& actual, double eps=0)
+template<typename V>
+static bool almostEqualLanes(const V& expected, const V& actual, double eps)
 {
-    for (int i = 0; i < 8; i++)
+    CompareTolerance tol;
+    tol.abs_eps = eps;
+    const CompareResult res = compare_register(expected, actual, tol);
+    if (!res.ok())
     {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
+        std::cerr << res << ", EPS = " << eps << std::endl;
     }
-    return true;
+    return res.ok();
 }
 
-static bool almostEqual(const uint16x8_t& expected, const uint16x8_t& actual, double eps=0)
-{
-    for (int i = 0; i < 8; i++)
-    {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
-    }
-    return true;
-}
+static bool almostEqual(const uint8x8_t& expected, const uint8x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int8x8_t& expected, const int8x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const uint16x4_t& expected, const uint16x4_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int16x4_t& expected, const int16x4_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const uint32x2_t& expected, const uint32x2_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int32x2_t& expected, const int32x2_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const float32x2_t& expected, const float32x2_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
 
-static bool almostEqual(const int16x8_t& expected, const int16x8_t& actual, double eps=0)
-{
-    for (int i = 0; i < 8; i++)
-    {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
-    }
-    return true;
-}
+static bool almostEqual(const uint8x16_t& expected, const uint8x16_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int8x16_t& expected, const int8x16_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const uint16x8_t& expected, const uint16x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int16x8_t& expected, const int16x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const uint32x4_t& expected, const uint32x4_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const int32x4_t& expected, const int32x4_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const float32x4_t& expected, const float32x4_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
 
-static bool almostEqual(const int8x16_t& expected, const int8x16_t& actual, double eps=0)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
-    }
-    return true;
-}
+static bool almostEqual(const poly8x8_t& expected, const poly8x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const poly8x16_t& expected, const poly8x16_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const poly16x8_t& expected, const poly16x8_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
+static bool almostEqual(const poly64x2_t& expected, const poly64x2_t& actual, double eps=0) { return almostEqualLanes(expected, actual, eps); }
 
 static bool almostEqual(const uint8x8x2_t& expected, const uint8x8x2_t& actual)
 {
@@ -104,49 +68,60 @@ static bool almostEqual(const uint8x8x2_t& expected, const uint8x8x2_t& actual)
     return true;
 }
 
-static bool almostEqual(const float32x4_t& expected, const float32x4_t& actual, double eps=0)
+static bool almostEqual(const std::vector<float>& expected, const std::vector<float>& actual, double eps=0)
 {
-    for (int i = 0; i < 4; i++)
+    if (expected.size() != actual.size())
     {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
+        std::cerr << "size (" << actual.size() << ") != expected size (" << expected.size() << ")" << std::endl;
+        return false;
     }
-    return true;
+    CompareTolerance tol;
+    tol.abs_eps = eps;
+    const CompareResult res = compare_array(expected.data(), actual.data(), expected.size(), tol);
+    if (!res.ok())
+    {
+        std::cerr << res << ", EPS = " << eps << std::endl;
+    }
+    return res.ok();
 }
 
-static bool almostEqual(const int16x4_t& expected, const int16x4_t& actual, double eps=0)
+/// @brief exact element-wise match of two buffers of the same size, printing the mismatches
+template<typename T>
+static bool same(const std::vector<T>& expected, const std::vector<T>& actual)
 {
-    for (int i = 0; i < 4; i++)
+    if (expected.size() != actual.size())
     {
-        const double diff = std::fabs((double)expected[i] - (double)actual[i]);
-        if (diff > eps)
-        {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
-        }
+        std::cerr << "size (" << actual.size() << ") != expected size (" << expected.size() << ")" << std::endl;
+        return false;
     }
-    return true;
+    const CompareResult res = compare_array(expected.data(), actual.data(), expected.size());
+    if (!res.ok())
+    {
+        std::cerr << res << std::endl;
+    }
+    return res.ok();
 }
 
-static bool almostEqual(const std::vector<float>& expected, const std::vector<float>& actual, double eps=0)
+/// @brief n integers of full-range noise from a seeded generator. About one in
+/// `rail_period` (a power of two, 0 for none) is pinned at the min or max of T,
+/// so saturating sums and widened products reach their extremes.
+template<typename T>
+static std::vector<T> random_with_rails(size_t n, unsigned seed, unsigned rail_period = 8)
 {
-    for (int i = 0; i < 4; i++)
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "8 to 32 bit integers");
+    std::vector<T> v(n);
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < n; i++)
     {
-        const double diff = std::fabs(expected[i] - actual[i]);
-        if (diff > eps)
+        const uint64_t r = rng();
+        if (rail_period != 0 && (r & (rail_period - 1)) == 0)
         {
-            std::cerr << "array[" << i << "] (" << (int)actual[i] << ") != expected[" << i << "] (" << (int)expected[i] 
-                      << "), diff = " << diff << ", EPS = " << eps << std::endl;
-            return false;
+            v[i] = (r & rail_period) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+        }
+        else
+        {
+            v[i] = (T)(r >> 16);
         }
     }
-    return true;
+    return v;
 }
-
-UTEST_MAIN()
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "test_util.hpp"
+
+#include <cmath>
+#include <random>
+
+TEST(vcmla, rotations)
+{
+    // r = 1+2j, a = 3+4j, b = 5+6j
+    float32x2_t r = { 1.0f, 2.0f };
+    float32x2_t a = { 3.0f, 4.0f };
+    float32x2_t b = { 5.0f, 6.0f };
+
+    // r + a.re * b = 1+15, 2+18
+    float32x2_t expected0 = { 16.0f, 20.0f };
+    EXPECT_TRUE(almostEqual(expected0, vcmla_f32(r, a, b)));
+    // r.re - a.im*b.im, r.im + a.im*b.re
+    float32x2_t expected90 = { -23.0f, 22.0f };
+    EXPECT_TRUE(almostEqual(expected90, vcmla_rot90_f32(r, a, b)));
+    float32x2_t expected180 = { -14.0f, -16.0f };
+    EXPECT_TRUE(almostEqual(expected180, vcmla_rot180_f32(r, a, b)));
+    float32x2_t expected270 = { 25.0f, -18.0f };
+    EXPECT_TRUE(almostEqual(expected270, vcmla_rot270_f32(r, a, b)));
+
+    // rot0 + rot90 is the full product, rot0 + rot270 the one with conj(a)
+    float32x2_t product = { 1.0f + (15.0f - 24.0f), 2.0f + (18.0f + 20.0f) };
+    EXPECT_TRUE(almostEqual(product, vcmla_rot90_f32(vcmla_f32(r, a, b), a, b)));
+    float32x2_t conj_product = { 1.0f + (15.0f + 24.0f), 2.0f + (18.0f - 20.0f) };
+    EXPECT_TRUE(almostEqual(conj_product, vcmla_rot270_f32(vcmla_f32(r, a, b), a, b)));
+}
+
+TEST(vcmla, q_matches_fused_reference)
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+    for (int t = 0; t < 200; t++)
+    {
+        float32x4_t r, a, b;
+        float64x2_t rd, ad, bd;
+        for (int i = 0; i < 4; i++)
+        {
+            r[i] = dist(rng);
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            rd[i] = dist(rng);
+            ad[i] = dist(rng) / 3.0;
+            bd[i] = dist(rng) / 7.0;
+        }
+        const float32x4_t out[4] = { vcmlaq_f32(r, a, b), vcmlaq_rot90_f32(r, a, b), vcmlaq_rot180_f32(r, a, b),
+                                     vcmlaq_rot270_f32(r, a, b) };
+        const float64x2_t outd[4] = { vcmlaq_f64(rd, ad, bd), vcmlaq_rot90_f64(rd, ad, bd), vcmlaq_rot180_f64(rd, ad, bd),
+                                      vcmlaq_rot270_f64(rd, ad, bd) };
+        for (int i = 0; i < 4; i += 2)
+        {
+            EXPECT_EQ(out[0][i], std::fma(a[i], b[i], r[i]));
+            EXPECT_EQ(out[0][i + 1], std::fma(a[i], b[i + 1], r[i + 1]));
+            EXPECT_EQ(out[1][i], std::fma(a[i + 1], -b[i + 1], r[i]));
+            EXPECT_EQ(out[1][i + 1], std::fma(a[i + 1], b[i], r[i + 1]));
+            EXPECT_EQ(out[2][i], std::fma(a[i], -b[i], r[i]));
+            EXPECT_EQ(out[2][i + 1], std::fma(a[i], -b[i + 1], r[i + 1]));
+            EXPECT_EQ(out[3][i], std::fma(a[i + 1], b[i + 1], r[i]));
+            EXPECT_EQ(out[3][i + 1], std::fma(a[i + 1], -b[i], r[i + 1]));
+        }
+        EXPECT_EQ(outd[0][0], std::fma(ad[0], bd[0], rd[0]));
+        EXPECT_EQ(outd[1][0], std::fma(ad[1], -bd[1], rd[0]));
+        EXPECT_EQ(outd[2][1], std::fma(ad[0], -bd[1], rd[1]));
+        EXPECT_EQ(outd[3][1], std::fma(ad[1], -bd[0], rd[1]));
+    }
+}
+
+TEST(vcmla, lane)
+{
+    float32x4_t r = { 0.0f, 0.0f, 1.0f, 1.0f };
+    float32x4_t a = { 1.0f, 2.0f, 3.0f, 4.0f };
+    float32x4_t b = { 9.0f, 9.0f, 2.0f, -1.0f };
+    // every complex number of a times b[1] = 2-1j
+    float32x4_t full = vcmlaq_rot90_laneq_f32(vcmlaq_laneq_f32(r, a, b, 1), a, b, 1);
+    float32x4_t expected = { 1.0f * 2.0f + 2.0f * 1.0f, -1.0f + 2.0f * 2.0f, 1.0f + 6.0f + 4.0f, 1.0f - 3.0f + 8.0f };
+    EXPECT_TRUE(almostEqual(expected, full));
+
+    float32x2_t b2 = { 2.0f, -1.0f };
+    EXPECT_TRUE(almostEqual(full, vcmlaq_rot90_lane_f32(vcmlaq_lane_f32(r, a, b2, 0), a, b2, 0)));
+    float32x2_t expected2 = { 4.0f, 3.0f };
+    EXPECT_TRUE(almostEqual(expected2, vcmla_rot90_laneq_f32(vcmla_laneq_f32(float32x2_t(), vget_low_f32(a), b, 1),
+                                                             vget_low_f32(a), b, 1)));
+    float32x4_t expected180 = { -2.0f, 1.0f, -5.0f, 4.0f };
+    EXPECT_TRUE(almostEqual(expected180, vcmlaq_rot180_laneq_f32(r, a, b, 1)));
+    float32x4_t expected270 = { -2.0f, -4.0f, -3.0f, -7.0f };
+    EXPECT_TRUE(almostEqual(expected270, vcmlaq_rot270_laneq_f32(r, a, b, 1)));
+}
+
+TEST(vcadd, rotations)
+{
+    float32x4_t a = { 1.0f, 2.0f, -3.0f, 0.5f };
+    float32x4_t b = { 10.0f, 20.0f, 4.0f, -8.0f };
+    // a + j*b
+    float32x4_t expected90 = { -19.0f, 12.0f, 5.0f, 4.5f };
+    EXPECT_TRUE(almostEqual(expected90, vcaddq_rot90_f32(a, b)));
+    // a - j*b
+    float32x4_t expected270 = { 21.0f, -8.0f, -11.0f, -3.5f };
+    EXPECT_TRUE(almostEqual(expected270, vcaddq_rot270_f32(a, b)));
+
+    float32x2_t expected90_d = { -19.0f, 12.0f };
+    EXPECT_TRUE(almostEqual(expected90_d, vcadd_rot90_f32(vget_low_f32(a), vget_low_f32(b))));
+    float32x2_t expected270_d = { -11.0f, -3.5f };
+    EXPECT_TRUE(almostEqual(expected270_d, vcadd_rot270_f32(vget_high_f32(a), vget_high_f32(b))));
+
+    float64x2_t ad = { 1.5, -2.0 };
+    float64x2_t bd = { 0.25, 3.0 };
+    EXPECT_EQ(vcaddq_rot90_f64(ad, bd)[0], -1.5);
+    EXPECT_EQ(vcaddq_rot90_f64(ad, bd)[1], -1.75);
+    EXPECT_EQ(vcaddq_rot270_f64(ad, bd)[0], 4.5);
+    EXPECT_EQ(vcaddq_rot270_f64(ad, bd)[1], -2.25);
+}
@@ -0,0 +1,99 @@
+#include "test_util.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace {
+
+uint32_t bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+uint64_t bits(double d)
+{
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+} // namespace
+
+TEST(vdivq, correctly_rounded)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    for (int t = 0; t < 500; t++)
+    {
+        float32x4_t a, b, c;
+        float64x2_t ad, bd, cd;
+        for (int i = 0; i < 4; i++)
+        {
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+            c[i] = std::fabs(a[i]);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            ad[i] = (double)a[i] / 7.0;
+            bd[i] = (double)b[i] * 3.0;
+            cd[i] = std::fabs(ad[i]);
+        }
+        const float32x4_t q = vdivq_f32(a, b);
+        const float32x4_t s = vsqrtq_f32(c);
+        const float64x2_t qd = vdivq_f64(ad, bd);
+        const float64x2_t sd = vsqrtq_f64(cd);
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_EQ(q[i], a[i] / b[i]);
+            EXPECT_EQ(s[i], std::sqrt(c[i]));
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            EXPECT_EQ(qd[i], ad[i] / bd[i]);
+            EXPECT_EQ(sd[i], std::sqrt(cd[i]));
+        }
+        EXPECT_EQ(vdiv_f32(vget_high_f32(a), vget_high_f32(b))[1], q[3]);
+        EXPECT_EQ(vsqrt_f32(vget_low_f32(c))[0], s[0]);
+        float64x1_t a1, b1, c1;
+        a1[0] = ad[1];
+        b1[0] = bd[1];
+        c1[0] = cd[1];
+        EXPECT_EQ(vdiv_f64(a1, b1)[0], qd[1]);
+        EXPECT_EQ(vsqrt_f64(c1)[0], sd[1]);
+    }
+}
+
+TEST(vdivq, special_values)
+{
+    float32x4_t a = { 1.0f, -1.0f, 0.0f, INFINITY };
+    float32x4_t b = { 0.0f, 0.0f, 0.0f, INFINITY };
+    float32x4_t q = vdivq_f32(a, b);
+    EXPECT_TRUE(std::isinf(q[0]) && q[0] > 0.0f);
+    EXPECT_TRUE(std::isinf(q[1]) && q[1] < 0.0f);
+    // invalid operations give the positive default NaN, as on ARM
+    EXPECT_EQ(bits(q[2]), 0x7fc00000u);
+    EXPECT_EQ(bits(q[3]), 0x7fc00000u);
+    EXPECT_EQ(bits(vdiv_f32(vget_high_f32(a), vget_high_f32(b))[0]), 0x7fc00000u);
+
+    float32x4_t r = { -4.0f, -0.0f, INFINITY, 16.0f };
+    float32x4_t s = vsqrtq_f32(r);
+    EXPECT_EQ(bits(s[0]), 0x7fc00000u);
+    EXPECT_EQ(bits(s[1]), 0x80000000u);
+    EXPECT_TRUE(std::isinf(s[2]));
+    EXPECT_EQ(s[3], 4.0f);
+    EXPECT_EQ(bits(vsqrt_f32(vget_low_f32(r))[0]), 0x7fc00000u);
+
+    float64x2_t rd = { -1.0, 0.0 };
+    EXPECT_EQ(bits(vsqrtq_f64(rd)[0]), 0x7ff8000000000000ull);
+    EXPECT_EQ(bits(vdivq_f64(rd, rd)[1]), 0x7ff8000000000000ull);
+
+#if !defined(NEON_SIM_AARCH32_FP) // DN replaces every NaN
+    // a NaN operand is passed on, not replaced
+    float32x4_t n = { -NAN, 1.0f, 1.0f, 1.0f };
+    EXPECT_EQ(bits(vdivq_f32(n, b)[0]) & 0x80000000u, 0x80000000u);
+    EXPECT_EQ(bits(vsqrtq_f32(n)[0]) & 0x80000000u, 0x80000000u);
+#endif // NEON_SIM_AARCH32_FP
+}
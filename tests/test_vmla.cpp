@@ -1,5 +1,7 @@
 #include "test_util.hpp"
 
+#include <limits>
+
 TEST(vmlaq, f32)
 {
     float32x4_t v1 = { 1.0, 2.0, 3.0, 4.0 };
@@ -19,4 +21,99 @@ TEST(vmlaq_n, f32)
     float32x4_t actual = vmlaq_n_f32(v1, v2, s);
     float32x4_t expected = { 4.0, 5.0, 6.0, 7.0 };
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vfmaq, f32_single_rounding)
+{
+    // 1 + 2^-12 squared: the 2^-24 term is lost by vmla, kept by vfma
+    const float e = 1.0f / 4096.0f;
+    float32x4_t a = { -1.0f, -1.0f, 0.0f, 1.0f };
+    float32x4_t b = { 1.0f + e, 1.0f - e, 0.0f, 3.0f };
+    float32x4_t c = { 1.0f + e, 1.0f + e, std::numeric_limits<float>::infinity(), 2.0f };
+    float32x4_t fma = vfmaq_f32(a, b, c);
+    float32x4_t fms = vfmsq_f32(a, b, c);
+    EXPECT_EQ(fma[0], std::fma(1.0f + e, 1.0f + e, -1.0f));
+    EXPECT_EQ(fma[1], -e * e);
+    EXPECT_EQ(fma[3], 7.0f);
+    EXPECT_EQ(fms[3], -5.0f);
+    // 0 * inf is an invalid operation: the positive default NaN
+    EXPECT_TRUE(std::isnan(fma[2]) && !std::signbit(fma[2]));
+    EXPECT_TRUE(std::isnan(fms[2]) && !std::signbit(fms[2]));
+
+    float64x2_t ad = { -1.0, 0.5 };
+    float64x2_t bd = { 1.0 + 1e-9, 2.0 };
+    float64x2_t cd = { 1.0 - 1e-9, 0.25 };
+    EXPECT_EQ(vfmaq_f64(ad, bd, cd)[0], std::fma(1.0 + 1e-9, 1.0 - 1e-9, -1.0));
+    EXPECT_EQ(vfmsq_f64(ad, bd, cd)[1], 0.0);
+}
+TEST(vfmaq_lane, f32)
+{
+    float32x4_t a = { 1.0f, 2.0f, 3.0f, 4.0f };
+    float32x4_t b = { 1.0f, -1.0f, 0.5f, 2.0f };
+    float32x4_t v = { 10.0f, 20.0f, 30.0f, 40.0f };
+    float32x2_t v2 = { 5.0f, 6.0f };
+    float32x4_t expected_laneq = { 31.0f, -28.0f, 18.0f, 64.0f };
+    float32x4_t expected_lane = { 7.0f, -4.0f, 6.0f, 16.0f };
+    float32x4_t expected_n = { -1.0f, 4.0f, 2.0f, 0.0f };
+    EXPECT_TRUE(almostEqual(expected_laneq, vfmaq_laneq_f32(a, b, v, 2)));
+    EXPECT_TRUE(almostEqual(expected_lane, vfmaq_lane_f32(a, b, v2, 1)));
+    EXPECT_TRUE(almostEqual(expected_n, vfmaq_n_f32(a, b, -2.0f)));
+}
+
+TEST(vmlal_lane, s16)
+{
+    int32x4_t a = { 1, 2, 3, 4 };
+    int16x4_t b = { 32767, -32768, 100, -1 };
+    int16x4_t v = { 0, -32768, 3, 0 };
+    int32x4_t expected = { 1 - 1073709056, 2 + 1073741824, 3 - 3276800, 4 + 32768 };
+    EXPECT_TRUE(almostEqual(expected, vmlal_lane_s16(a, b, v, 1)));
+}
+
+TEST(vmlal_n, u16_widen_and_narrow)
+{
+    // the vertical step of a Q8 x Q8 filter: 32 bit sums, rounded back by 16
+    uint16x4_t r0 = { 65280, 0, 300, 128 };
+    uint16x4_t r1 = { 65280, 65535, 200, 128 };
+    uint32x4_t acc = vmlal_n_u16(vmull_n_u16(r0, 56), r1, 200);
+    uint32x4_t expected_acc = { 16711680, 13107000, 56800, 32768 };
+    EXPECT_TRUE(almostEqual(expected_acc, acc));
+    uint16x4_t expected = { 255, 200, 1, 1 };
+    EXPECT_TRUE(almostEqual(expected, vrshrn_n_u32(acc, 16)));
+
+    int32x4_t shift = { -16, 0, 4, -40 };
+    uint32x4_t expected_shifted = { 255, 13107000, 908800, 0 };
+    EXPECT_TRUE(almostEqual(expected_shifted, vshlq_u32(acc, shift)));
+
+    int16x8_t v = { 1, -1, 16384, -16384, 0, 3, -3, 255 };
+    int16x8_t doubled = { 2, -2, -32768, -32768, 0, 6, -6, 510 };
+    EXPECT_TRUE(almostEqual(doubled, vshlq_n_s16(v, 1)));
+}
+
+TEST(vmlal_n, s16_signed_narrow)
+{
+    int32x4_t acc = { 1 << 19, 0, -100, 2000000000 };
+    int16x4_t m = { 100, -7, 3, 1 };
+    int32x4_t expected_acc = { (1 << 19) - 30000, 2100, -1000, 1999999700 };
+    acc = vmlal_n_s16(acc, m, -300);
+    EXPECT_TRUE(almostEqual(expected_acc, acc));
+
+    int32x4_t b = { 1, -1, 2, 0 };
+    int32x4_t expected_mla = { (1 << 19) - 29000, 1100, 1000, 1999999700 };
+    EXPECT_TRUE(almostEqual(expected_mla, vmlaq_n_s32(acc, b, 1000)));
+
+    // unsigned saturation of signed values: negative lanes clamp to 0,
+    // large ones to 65535; only the "r" form rounds
+    int32x4_t v = { 23, -5, 0x7fffffff, 40 };
+    uint16x4_t truncated = { 2, 0, 65535, 5 };
+    uint16x4_t rounded = { 3, 0, 65535, 5 };
+    EXPECT_TRUE(almostEqual(truncated, vqshrun_n_s32(v, 3)));
+    EXPECT_TRUE(almostEqual(rounded, vqrshrun_n_s32(v, 3)));
+
+    // the rounding constant must not overflow the 16 bit lane
+    int16x8_t w = { 32767, -32768, 255, 256, 0, 1, 2, 3 };
+    uint8x8_t narrowed = { 255, 0, 128, 128, 0, 1, 1, 2 };
+    EXPECT_TRUE(almostEqual(narrowed, vqrshrun_n_s16(w, 1)));
+
+    uint16x8_t p010 = { 0xffc0, 0x0040, 0x8000, 0, 1, 63, 64, 0x1000 };
+    uint16x8_t ten_bit = { 1023, 1, 512, 0, 0, 0, 1, 64 };
+    EXPECT_TRUE(almostEqual(ten_bit, vshrq_n_u16(p010, 6)));
+}
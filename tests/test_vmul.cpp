@@ -34,4 +34,46 @@ TEST(mul, vmul_n_s16)
     int16x4_t actual = vmul_n_s16(v1, s);
     int16x4_t expected = {2, 4, 6, 8};
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(mul, q15_q31_saturation)
+{
+    // -1 * -1 is the one product that does not fit the doubled result
+    {
+        int16x4_t a = {INT16_MIN, INT16_MIN, 16384, -3};
+        int16x4_t b = {INT16_MIN, INT16_MAX, 16384, 5};
+        int32x4_t expected = {INT32_MAX, -2147418112, 536870912, -30};
+        EXPECT_TRUE(almostEqual(expected, vqdmull_s16(a, b)));
+        int32x4_t acc = {1, INT32_MIN, INT32_MAX, 30};
+        int32x4_t expected_mlal = {INT32_MAX, INT32_MIN, INT32_MAX, 0};
+        EXPECT_TRUE(almostEqual(expected_mlal, vqdmlal_s16(acc, a, b)));
+        int32x4_t expected_mlsl = {-2147483646, -65536, 1610612735, 60};
+        EXPECT_TRUE(almostEqual(expected_mlsl, vqdmlsl_s16(acc, a, b)));
+    }
+    {
+        int32x2_t a = {INT32_MIN, 3};
+        int32x2_t b = {INT32_MIN, -7};
+        int64x2_t expected = {INT64_MAX, -42};
+        EXPECT_TRUE(almostEqualLanes(expected, vqdmull_s32(a, b), 0));
+        int64x2_t acc = {INT64_MIN, INT64_MIN + 10};
+        int64x2_t expected_mlal = {-1, INT64_MIN};
+        EXPECT_TRUE(almostEqualLanes(expected_mlal, vqdmlal_s32(acc, a, b), 0));
+    }
+    {
+        // 1 * 0.5 is half an lsb, rounded up
+        int16x8_t a = {INT16_MIN, INT16_MAX, 1, 1, 100, -100, 16384, 0};
+        int16x8_t b = {INT16_MIN, INT16_MAX, INT16_MIN, 16384, INT16_MIN, INT16_MIN, 16384, 5};
+        int16x8_t expected = {INT16_MAX, 32766, -1, 1, -100, 100, 8192, 0};
+        EXPECT_TRUE(almostEqual(expected, vqrdmulhq_s16(a, b)));
+        int16x8_t sum = {INT16_MAX, INT16_MIN, INT16_MIN, -1, 0, 0, 0, 0};
+        int16x8_t expected_sum = {INT16_MAX, -2, INT16_MIN, 0, -100, 100, 8192, 0};
+        EXPECT_TRUE(almostEqual(expected_sum, vqaddq_s16(sum, vqrdmulhq_s16(a, b))));
+    }
+    {
+        int32x4_t a = {INT32_MAX, -16385 * 2, 16383 * 2 + 1, INT32_MIN};
+        int16x4_t expected = {INT16_MAX, -1, 1, INT16_MIN};
+        EXPECT_TRUE(almostEqual(expected, vqrshrn_n_s32(a, 15)));
+        int64x2_t b = {INT64_MAX, -(3ll << 30)};
+        int32x2_t expected_64 = {INT32_MAX, -1};
+        EXPECT_TRUE(almostEqual(expected_64, vqrshrn_n_s64(b, 31)));
+    }
+}
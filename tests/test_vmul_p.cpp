@@ -0,0 +1,112 @@
+#include "test_util.hpp"
+
+#include <random>
+#include <type_traits>
+
+// carry-less product of 64-bit values from 8-bit pieces, independent of vmull_p64
+static void clmul64_by_bytes(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi)
+{
+    lo = 0;
+    hi = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            poly8x8_t va = vdup_n_p8((poly8_t)(a >> (8 * i)));
+            poly8x8_t vb = vdup_n_p8((poly8_t)(b >> (8 * j)));
+            const uint64_t p = vmull_p8(va, vb)[0];
+            const int shift = 8 * (i + j);
+            if (shift < 64)
+            {
+                lo ^= p << shift;
+                hi ^= shift ? p >> (64 - shift) : 0;
+            }
+            else
+            {
+                hi ^= p << (shift - 64);
+            }
+        }
+    }
+}
+
+TEST(poly, distinct_register_types)
+{
+    EXPECT_FALSE((std::is_same<poly8x8_t, uint8x8_t>::value));
+    EXPECT_FALSE((std::is_same<poly8x16_t, uint8x16_t>::value));
+    EXPECT_FALSE((std::is_same<poly16x8_t, uint16x8_t>::value));
+    EXPECT_FALSE((std::is_same<poly64x2_t, uint64x2_t>::value));
+    EXPECT_EQ(sizeof(poly8x16_t), sizeof(uint8x16_t));
+    EXPECT_EQ(sizeof(poly64x2_t), sizeof(uint64x2_t));
+
+    // reinterpret keeps the bits
+    const uint8x16_t bytes = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 0xff };
+    const poly8x16_t p = vreinterpretq_p8_u8(bytes);
+    EXPECT_EQ(vgetq_lane_p8(p, 15), 0xff);
+    EXPECT_TRUE(almostEqual(bytes, vreinterpretq_u8_p8(p)));
+}
+
+TEST(vmul, p8)
+{
+    poly8x8_t a = { 0x03, 0xff, 0x80, 0x01, 0x00, 0x53, 0x02, 0x0f };
+    poly8x8_t b = { 0x03, 0xff, 0x02, 0xaa, 0x77, 0xca, 0x80, 0x0f };
+    poly8x8_t actual = vmul_p8(a, b);
+    // 3*3 = x^2+1; 0xff*0xff = 0x5555; 0x80*2 = 0x100 drops out of the low byte
+    poly8x8_t expected = { 0x05, 0x55, 0x00, 0xaa, 0x00, 0x7e, 0x00, 0x55 };
+    EXPECT_TRUE(almostEqual(expected, actual));
+
+    poly8x16_t q = vmulq_p8(vcombine_p8(a, a), vcombine_p8(b, b));
+    EXPECT_EQ(vgetq_lane_p8(q, 13), 0x7e);
+}
+
+TEST(vmull, p8)
+{
+    poly8x8_t a = { 0x03, 0xff, 0x80, 0x01, 0x00, 0x53, 0x02, 0x0f };
+    poly8x8_t b = { 0x03, 0xff, 0x02, 0xaa, 0x77, 0xca, 0x80, 0x0f };
+    poly16x8_t actual = vmull_p8(a, b);
+    poly16x8_t expected = { 0x0005, 0x5555, 0x0100, 0x00aa, 0x0000, 0x3f7e, 0x0100, 0x0055 };
+    EXPECT_TRUE(almostEqual(expected, actual));
+
+    poly8x16_t qa = vcombine_p8(vdup_n_p8(0), a);
+    poly8x16_t qb = vcombine_p8(vdup_n_p8(0), b);
+    EXPECT_TRUE(almostEqual(expected, vmull_high_p8(qa, qb)));
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(vmull, p64)
+{
+    const poly128_t ones = vmull_p64(~0ull, ~0ull);
+    EXPECT_EQ((uint64_t)ones, 0x5555555555555555ull);
+    EXPECT_EQ((uint64_t)(ones >> 64), 0x5555555555555555ull);
+    // x^63 * x^63 = x^126
+    const poly128_t top = vmull_p64(1ull << 63, 1ull << 63);
+    EXPECT_EQ((uint64_t)top, 0ull);
+    EXPECT_EQ((uint64_t)(top >> 64), 1ull << 62);
+
+    std::mt19937_64 rng(9);
+    for (int i = 0; i < 64; i++)
+    {
+        const uint64_t a = rng();
+        const uint64_t b = rng();
+        uint64_t lo, hi;
+        clmul64_by_bytes(a, b, lo, hi);
+        const uint64x2_t r = vreinterpretq_u64_p128(vmull_p64(a, b));
+        EXPECT_EQ(r[0], lo);
+        EXPECT_EQ(r[1], hi);
+
+        const poly64_t pair[2] = { b, a };
+        const poly64x2_t va = vld1q_p64(pair);
+        const poly64x2_t vb = vdupq_n_p64(b);
+        EXPECT_TRUE(vmull_high_p64(va, vb) == vmull_p64(a, b));
+    }
+}
+
+TEST(vreinterpretq, p128)
+{
+    const uint8x16_t bytes = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    const poly128_t p = vreinterpretq_p128_u8(bytes);
+    EXPECT_EQ((uint64_t)p, 0x0706050403020100ull);
+    EXPECT_TRUE(almostEqual(bytes, vreinterpretq_u8_p128(p)));
+    EXPECT_TRUE(vreinterpretq_p128_u64(vreinterpretq_u64_p128(p)) == p);
+    EXPECT_TRUE(vaddq_p128(p, p) == 0);
+}
+#endif // __SIZEOF_INT128__
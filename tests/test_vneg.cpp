@@ -0,0 +1,82 @@
+#include "test_util.hpp"
+
+#include <limits>
+
+TEST(vneg, s8)
+{
+    int8x8_t a = { 0, 1, -1, 5, -100, 127, -127, -128 };
+    int8x8_t expected = { 0, -1, 1, -5, 100, -127, 127, -128 };
+    EXPECT_TRUE(almostEqual(expected, vneg_s8(a)));
+
+    int8x16_t q = vcombine_s8(a, expected);
+    int8x16_t expected_q = vcombine_s8(expected, a);
+    EXPECT_TRUE(almostEqual(expected_q, vnegq_s8(q)));
+}
+
+TEST(vneg, s16)
+{
+    int16x4_t a = { 0, 300, -32767, -32768 };
+    int16x4_t expected = { 0, -300, 32767, -32768 };
+    EXPECT_TRUE(almostEqual(expected, vneg_s16(a)));
+
+    int16x8_t q = { 1, -1, 2, -2, 32767, -32768, 1000, -1000 };
+    int16x8_t expected_q = { -1, 1, -2, 2, -32767, -32768, -1000, 1000 };
+    EXPECT_TRUE(almostEqual(expected_q, vnegq_s16(q)));
+}
+
+TEST(vneg, s32)
+{
+    const int32_t min = std::numeric_limits<int32_t>::min();
+    int32x2_t a = { 7, min };
+    int32x2_t expected = { -7, min };
+    EXPECT_TRUE(almostEqual(expected, vneg_s32(a)));
+
+    int32x4_t q = { 0, -123456, 2147483647, min };
+    int32x4_t expected_q = { 0, 123456, -2147483647, min };
+    EXPECT_TRUE(almostEqual(expected_q, vnegq_s32(q)));
+}
+
+TEST(vneg, s64)
+{
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    int64x1_t a = { min };
+    EXPECT_EQ(vneg_s64(a)[0], min);
+    int64x1_t b = { 1ll << 40 };
+    EXPECT_EQ(vneg_s64(b)[0], -(1ll << 40));
+
+    int64x2_t q = { -5, std::numeric_limits<int64_t>::max() };
+    int64x2_t r = vnegq_s64(q);
+    EXPECT_EQ(r[0], 5);
+    EXPECT_EQ(r[1], min + 1);
+}
+
+TEST(vneg, f32)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    float32x2_t a = { 1.5f, -inf };
+    float32x2_t expected = { -1.5f, inf };
+    EXPECT_TRUE(almostEqual(expected, vneg_f32(a)));
+
+    // the sign bit flips for zeros and NaNs too
+    float32x4_t q = { 0.0f, -0.0f, std::numeric_limits<float>::quiet_NaN(), 2.0f };
+    float32x4_t r = vnegq_f32(q);
+    uint32_t bits[4];
+    memcpy(bits, &r, sizeof(bits));
+    EXPECT_EQ(bits[0], 0x80000000u);
+    EXPECT_EQ(bits[1], 0x00000000u);
+    EXPECT_EQ(bits[2], 0xffc00000u);
+    EXPECT_EQ(r[3], -2.0f);
+}
+
+TEST(vneg, f64)
+{
+    float64x1_t a = { -0.25 };
+    EXPECT_EQ(vneg_f64(a)[0], 0.25);
+
+    float64x2_t q = { 0.0, 1e300 };
+    float64x2_t r = vnegq_f64(q);
+    uint64_t bits[2];
+    memcpy(bits, &r, sizeof(bits));
+    EXPECT_EQ(bits[0], 0x8000000000000000ull);
+    EXPECT_EQ(r[1], -1e300);
+}
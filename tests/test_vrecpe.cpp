@@ -1,5 +1,8 @@
 #include "test_util.hpp"
 
+#include <cmath>
+#include <random>
+
 //- invert (needed for division): **vrecpeq_f32** or **vrecpeq_f64**
 TEST(vrecpeq, f32)
 {
@@ -18,4 +21,111 @@ TEST(vrecpeq, f32_more_precise)
     float32x4_t actual = vmulq_f32(vrecpsq_f32(v, reciprocal), reciprocal);
     float32x4_t expected = { 0.999996185, 0.499998093, 0.333333015, 0.249999046 };
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vrsqrteq, f32)
+{
+    // 8-bit estimates of the ARMv8 RecipSqrtEstimate table
+    float32x4_t v = { 1.0f, 4.0f, 2.0f, 0.25f };
+    float32x4_t actual = vrsqrteq_f32(v);
+    EXPECT_EQ(actual[0], 0.998046875f);
+    EXPECT_EQ(actual[1], 0.4990234375f);
+    EXPECT_EQ(actual[3], 1.99609375f);
+    EXPECT_TRUE(fabsf(actual[2] - 0.70710678f) < 0.004f);
+
+    float32x2_t special = { 0.0f, INFINITY };
+    float32x2_t estimate = vrsqrte_f32(special);
+    EXPECT_TRUE(std::isinf(estimate[0]) && estimate[0] > 0.0f);
+    EXPECT_EQ(estimate[1], 0.0f);
+    float32x2_t negative = { -1.0f, -0.0f };
+    estimate = vrsqrte_f32(negative);
+    EXPECT_TRUE(std::isnan(estimate[0]));
+    EXPECT_TRUE(std::isinf(estimate[1]) && estimate[1] < 0.0f);
+}
+
+TEST(vrecps, fused)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(0.5f, 8.0f);
+    for (int t = 0; t < 500; t++)
+    {
+        float32x4_t a, b;
+        float64x2_t ad, bd;
+        for (int i = 0; i < 4; i++)
+        {
+            a[i] = dist(rng);
+            b[i] = 1.0f / a[i] * (1.0f + (dist(rng) - 4.0f) * 1e-3f);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            ad[i] = a[i] / 3.0;
+            bd[i] = b[i] * 3.0;
+        }
+        const float32x4_t r = vrecpsq_f32(a, b);
+        const float32x4_t s = vrsqrtsq_f32(a, b);
+        for (int i = 0; i < 4; i++)
+        {
+            // one rounding of the exact 2 - a*b, not of a rounded product
+            EXPECT_EQ(r[i], std::fma(-a[i], b[i], 2.0f));
+            EXPECT_EQ(s[i], std::fma(-a[i], b[i], 3.0f) / 2.0f);
+        }
+        EXPECT_EQ(vrecps_f32(vget_low_f32(a), vget_low_f32(b))[1], r[1]);
+        EXPECT_EQ(vrsqrts_f32(vget_high_f32(a), vget_high_f32(b))[0], s[2]);
+        EXPECT_EQ(vrecpsq_f64(ad, bd)[1], std::fma(-ad[1], bd[1], 2.0));
+        EXPECT_EQ(vrsqrtsq_f64(ad, bd)[0], std::fma(-ad[0], bd[0], 3.0) / 2.0);
+    }
+}
+
+TEST(vrecps, zero_times_infinity)
+{
+    float32x4_t a = { 0.0f, -INFINITY, 2.0f, INFINITY };
+    float32x4_t b = { INFINITY, -0.0f, INFINITY, 1.0f };
+    float32x4_t r = vrecpsq_f32(a, b);
+    EXPECT_EQ(r[0], 2.0f);
+    EXPECT_EQ(r[1], 2.0f);
+    EXPECT_TRUE(std::isinf(r[2]) && r[2] < 0.0f);
+    EXPECT_TRUE(std::isinf(r[3]) && r[3] < 0.0f);
+    float32x4_t s = vrsqrtsq_f32(a, b);
+    EXPECT_EQ(s[0], 1.5f);
+    EXPECT_EQ(s[1], 1.5f);
+    float64x2_t ad = { 0.0, 1.0 };
+    float64x2_t bd = { -INFINITY, 4.0 };
+    EXPECT_EQ(vrecpsq_f64(ad, bd)[0], 2.0);
+    EXPECT_EQ(vrsqrtsq_f64(ad, bd)[0], 1.5);
+    EXPECT_EQ(vrsqrtsq_f64(ad, bd)[1], -0.5);
+}
+
+TEST(vrsqrtsq, newton_steps)
+{
+    // two steps take the 8-bit estimate to within a few float ulps
+    float32x4_t v = { 1.0f, 2.0f, 3.0f, 1000.0f };
+    float32x4_t x = vrsqrteq_f32(v);
+    for (int step = 0; step < 2; step++)
+    {
+        x = vmulq_f32(x, vrsqrtsq_f32(vmulq_f32(v, x), x));
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(fabsf(x[i] * sqrtf(v[i]) - 1.0f) < 1e-6f);
+    }
+}
+
+TEST(vrecpeq, special_values)
+{
+    // infinities give zero, operands below 2^-128 overflow to infinity and
+    // operands above 2^126 give subnormal estimates
+    float32x4_t v = { INFINITY, -0.0f, 1e-39f, -1e38f };
+    float32x4_t actual = vrecpeq_f32(v);
+    EXPECT_EQ(actual[0], 0.0f);
+    EXPECT_TRUE(std::isinf(actual[1]) && actual[1] < 0.0f);
+    EXPECT_TRUE(std::isinf(actual[2]) && actual[2] > 0.0f);
+#if !defined(NEON_SIM_AARCH32_FP) // FZ flushes subnormal operands and estimates
+    EXPECT_TRUE(actual[3] < 0.0f && std::fpclassify(actual[3]) == FP_SUBNORMAL);
+    EXPECT_TRUE(fabsf(actual[3] * -1e38f - 1.0f) < 0.004f);
+
+    // a subnormal operand at or above 2^-128 still has a finite estimate
+    float32x2_t tiny = { 6e-39f, 1e-40f };
+    float32x2_t estimate = vrecpe_f32(tiny);
+    EXPECT_TRUE(fabsf(estimate[0] * 6e-39f - 1.0f) < 0.004f);
+    EXPECT_TRUE(std::isinf(estimate[1]));
+#endif // NEON_SIM_AARCH32_FP
+}
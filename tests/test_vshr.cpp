@@ -0,0 +1,20 @@
+#include "test_util.hpp"
+
+TEST(vrshr_n, u16)
+{
+    // rounds half up; the rounding constant does not wrap at 0xFFFF
+    uint16x4_t a = {0xFFFF, 0xFFFE, 1, 2};
+    uint16x4_t expected1 = {0x8000, 0x7FFF, 1, 1};
+    EXPECT_TRUE(almostEqual(expected1, vrshr_n_u16(a, 1)));
+    uint16x4_t expected16 = {1, 1, 0, 0};
+    EXPECT_TRUE(almostEqual(expected16, vrshr_n_u16(a, 16)));
+}
+
+TEST(vrshrq_n, u16)
+{
+    uint16x8_t a = {0xFFFF, 0x8000, 0x7FFF, 127, 128, 383, 384, 0};
+    uint16x8_t expected8 = {0x100, 0x80, 0x80, 0, 1, 1, 2, 0};
+    EXPECT_TRUE(almostEqual(expected8, vrshrq_n_u16(a, 8)));
+    uint16x8_t expected16 = {1, 1, 0, 0, 0, 0, 0, 0};
+    EXPECT_TRUE(almostEqual(expected16, vrshrq_n_u16(a, 16)));
+}
@@ -18,4 +18,48 @@ TEST(vtbl2, u8)
     uint8x8_t actual = vtbl2_u8(src, src2);
     uint8x8_t expected = {1, 1, 2, 2, 3, 3, 9, 11};
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vtbx1, u8_out_of_range_keeps_a)
+{
+    uint8x8_t a = {100, 101, 102, 103, 104, 105, 106, 107};
+    uint8x8_t table = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8x8_t idx = {0, 7, 8, 255, 3, 9, 128, 1};
+    uint8x8_t expected = {1, 8, 102, 103, 4, 105, 106, 2};
+    EXPECT_TRUE(almostEqual(expected, vtbx1_u8(a, table, idx)));
+}
+
+TEST(vtbx2, u8_out_of_range_keeps_a)
+{
+    uint8x8_t a = {100, 101, 102, 103, 104, 105, 106, 107};
+    uint8x8x2_t table;
+    table.val[0] = uint8x8_t{1, 2, 3, 4, 5, 6, 7, 8};
+    table.val[1] = uint8x8_t{9, 10, 11, 12, 13, 14, 15, 16};
+    uint8x8_t idx = {0, 8, 15, 16, 255, 7, 200, 9};
+    uint8x8_t expected = {1, 9, 16, 103, 104, 8, 106, 10};
+    EXPECT_TRUE(almostEqual(expected, vtbx2_u8(a, table, idx)));
+}
+
+TEST(vtbx3, u8_out_of_range_keeps_a)
+{
+    uint8x8_t a = {100, 101, 102, 103, 104, 105, 106, 107};
+    uint8x8x3_t table;
+    table.val[0] = uint8x8_t{1, 2, 3, 4, 5, 6, 7, 8};
+    table.val[1] = uint8x8_t{9, 10, 11, 12, 13, 14, 15, 16};
+    table.val[2] = uint8x8_t{17, 18, 19, 20, 21, 22, 23, 24};
+    uint8x8_t idx = {23, 16, 24, 25, 255, 0, 15, 32};
+    uint8x8_t expected = {24, 17, 102, 103, 104, 1, 16, 107};
+    EXPECT_TRUE(almostEqual(expected, vtbx3_u8(a, table, idx)));
+}
+
+TEST(vtbx4, u8_out_of_range_keeps_a)
+{
+    uint8x8_t a = {100, 101, 102, 103, 104, 105, 106, 107};
+    uint8x8x4_t table;
+    table.val[0] = uint8x8_t{1, 2, 3, 4, 5, 6, 7, 8};
+    table.val[1] = uint8x8_t{9, 10, 11, 12, 13, 14, 15, 16};
+    table.val[2] = uint8x8_t{17, 18, 19, 20, 21, 22, 23, 24};
+    table.val[3] = uint8x8_t{25, 26, 27, 28, 29, 30, 31, 32};
+    uint8x8_t idx = {31, 24, 32, 33, 255, 0, 23, 64};
+    uint8x8_t expected = {32, 25, 102, 103, 104, 1, 24, 107};
+    EXPECT_TRUE(almostEqual(expected, vtbx4_u8(a, table, idx)));
+}
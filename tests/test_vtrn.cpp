@@ -11,4 +11,17 @@ TEST(vtrn, u8)
     expected.val[1] = uint8x8_t{2, 10, 4, 12, 6, 14, 8, 16};
 
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vtrnq, f32)
+{
+    float32x4_t a = { 1.0f, 2.0f, 3.0f, 4.0f };
+    float32x4_t b = { 5.0f, 6.0f, 7.0f, 8.0f };
+    float32x4x2_t actual = vtrnq_f32(a, b);
+    float32x4_t expected0 = { 1.0f, 5.0f, 3.0f, 7.0f };
+    float32x4_t expected1 = { 2.0f, 6.0f, 4.0f, 8.0f };
+    EXPECT_TRUE(almostEqual(expected0, actual.val[0]));
+    EXPECT_TRUE(almostEqual(expected1, actual.val[1]));
+
+    float32x4_t combined = { 1.0f, 2.0f, 7.0f, 8.0f };
+    EXPECT_TRUE(almostEqual(combined, vcombine_f32(vget_low_f32(a), vget_high_f32(b))));
+}
@@ -11,4 +11,14 @@ TEST(vzip, u8)
     expected.val[1] = uint8x8_t{5, 13, 6, 14, 7, 15, 8, 16};
 
     EXPECT_TRUE(almostEqual(expected, actual));
-}
\ No newline at end of file
+}
+TEST(vzipq, s32)
+{
+    int32x4_t a = { 1, 2, 3, 4 };
+    int32x4_t b = { -1, -2, -3, -4 };
+    int32x4x2_t actual = vzipq_s32(a, b);
+    int32x4_t expected_lo = { 1, -1, 2, -2 };
+    int32x4_t expected_hi = { 3, -3, 4, -4 };
+    EXPECT_TRUE(almostEqual(expected_lo, actual.val[0]));
+    EXPECT_TRUE(almostEqual(expected_hi, actual.val[1]));
+}
@@ -0,0 +1,340 @@
+#include "test_util.hpp"
+#include "neon_sim_yuv.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace neon_sim_kernels;
+
+namespace {
+
+// odd sizes, and widths on both sides of the 16 pixel vectors
+const int kShapes[][2] = { { 1, 1 }, { 2, 2 }, { 3, 5 }, { 16, 2 }, { 17, 3 }, { 32, 7 }, { 45, 10 } };
+const yuv::Layout kLayouts[] = { yuv::LAYOUT_BGR, yuv::LAYOUT_RGB, yuv::LAYOUT_BGRA, yuv::LAYOUT_RGBA };
+const yuv::ColorSpace kSpaces[] = { yuv::BT601_LIMITED, yuv::BT601_FULL, yuv::BT709_LIMITED, yuv::BT709_FULL };
+
+} // namespace
+
+TEST(yuv, decode_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+        // padded rows; planar chroma in one buffer, U then V
+        const size_t y_step = w + 5, uv_step = 2 * cw + 3;
+        const std::vector<uint8_t> y = random_with_rails<uint8_t>(y_step * h, w * 10 + h);
+        const std::vector<uint8_t> uv = random_with_rails<uint8_t>(uv_step * ch * 2, w + h * 10);
+        for (yuv::Layout layout : kLayouts)
+        {
+            const size_t dst_step = w * yuv::layout_channels(layout) + 2;
+            for (yuv::ColorSpace cs : kSpaces)
+            {
+                std::vector<uint8_t> expected(dst_step * h, 7), actual(dst_step * h, 7);
+
+                yuv::ref::yuv420_to_rgb(y.data(), y_step, uv.data() + 1, uv.data(), uv_step, 2, expected.data(),
+                                        dst_step, w, h, layout, cs);
+                yuv::nv21_to_rgb(y.data(), y_step, uv.data(), uv_step, actual.data(), dst_step, w, h, layout, cs);
+                EXPECT_TRUE(same(expected, actual));
+
+                yuv::ref::yuv420_to_rgb(y.data(), y_step, uv.data(), uv.data() + 1, uv_step, 2, expected.data(),
+                                        dst_step, w, h, layout, cs);
+                yuv::nv12_to_rgb(y.data(), y_step, uv.data(), uv_step, actual.data(), dst_step, w, h, layout, cs);
+                EXPECT_TRUE(same(expected, actual));
+
+                const uint8_t* u = uv.data();
+                const uint8_t* v = uv.data() + uv_step * ch;
+                yuv::ref::yuv420_to_rgb(y.data(), y_step, u, v, uv_step, 1, expected.data(), dst_step, w, h, layout,
+                                        cs);
+                yuv::i420_to_rgb(y.data(), y_step, u, v, uv_step, actual.data(), dst_step, w, h, layout, cs);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+}
+
+TEST(yuv, decode_bt601_matches_opencv)
+{
+    // OpenCV's COLOR_YUV2RGB_NV21 arithmetic (the ITUR_BT_601_* constants)
+    // on flat 2x2 frames: black, white, the limited range primaries and
+    // gray, and out-of-range samples that clip
+    const uint8_t yuv_rgb[][6] = {
+        { 16, 128, 128, 0, 0, 0 },    { 235, 128, 128, 255, 255, 255 }, { 81, 90, 240, 254, 0, 0 },
+        { 145, 54, 34, 0, 255, 1 },   { 41, 240, 110, 0, 0, 255 },      { 128, 128, 128, 130, 130, 130 },
+        { 0, 0, 255, 203, 0, 0 },     { 255, 255, 0, 74, 255, 255 },
+    };
+    for (const auto& t : yuv_rgb)
+    {
+        const uint8_t y[4] = { t[0], t[0], t[0], t[0] };
+        const uint8_t vu[2] = { t[2], t[1] };
+        uint8_t rgb[12];
+        yuv::nv21_to_rgb(y, 2, vu, 2, rgb, 6, 2, 2, yuv::LAYOUT_RGB, yuv::BT601_LIMITED);
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_EQ(rgb[i * 3 + 0], t[3]);
+            EXPECT_EQ(rgb[i * 3 + 1], t[4]);
+            EXPECT_EQ(rgb[i * 3 + 2], t[5]);
+        }
+    }
+
+    // the same arithmetic written out as in OpenCV's YUV420sp2RGB8Invoker, on
+    // a noise frame wide enough for the vector path
+    const int w = 40, h = 6;
+    const std::vector<uint8_t> y = random_with_rails<uint8_t>(w * h, 11);
+    const std::vector<uint8_t> vu = random_with_rails<uint8_t>(w * h / 2, 12);
+    std::vector<uint8_t> expected(w * h * 3), actual(w * h * 3);
+    for (int j = 0; j < h; j++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            const int v = vu[(j / 2) * w + (x / 2) * 2] - 128, u = vu[(j / 2) * w + (x / 2) * 2 + 1] - 128;
+            const int ruv = (1 << 19) + 1673527 * v;
+            const int guv = (1 << 19) - 852492 * v - 409993 * u;
+            const int buv = (1 << 19) + 2116026 * u;
+            const int yy = std::max(0, y[j * w + x] - 16) * 1220542;
+            uint8_t* d = &expected[(j * w + x) * 3];
+            d[0] = (uint8_t)std::min(std::max((yy + buv) >> 20, 0), 255);
+            d[1] = (uint8_t)std::min(std::max((yy + guv) >> 20, 0), 255);
+            d[2] = (uint8_t)std::min(std::max((yy + ruv) >> 20, 0), 255);
+        }
+    }
+    yuv::nv21_to_rgb(y.data(), w, vu.data(), w, actual.data(), w * 3, w, h, yuv::LAYOUT_BGR, yuv::BT601_LIMITED);
+    EXPECT_TRUE(same(expected, actual));
+}
+
+TEST(yuv, p010_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+        const size_t y_step = (w + 3) * sizeof(uint16_t), uv_step = (2 * cw + 1) * sizeof(uint16_t);
+        std::vector<uint16_t> y(y_step / 2 * h), uv(uv_step / 2 * ch);
+        std::mt19937 rng(w * 31 + h);
+        for (uint16_t& p : y)
+        {
+            p = (uint16_t)(rng() & 0xffc0);
+        }
+        for (uint16_t& p : uv)
+        {
+            p = (uint16_t)(rng() & 0xffc0);
+        }
+        for (yuv::Layout layout : kLayouts)
+        {
+            const size_t dst_step = w * yuv::layout_channels(layout);
+            for (yuv::ColorSpace cs : kSpaces)
+            {
+                std::vector<uint8_t> expected(dst_step * h), actual(dst_step * h);
+                yuv::ref::p010_to_rgb(y.data(), y_step, uv.data(), uv_step, expected.data(), dst_step, w, h, layout,
+                                      cs);
+                yuv::p010_to_rgb(y.data(), y_step, uv.data(), uv_step, actual.data(), dst_step, w, h, layout, cs);
+                EXPECT_TRUE(same(expected, actual));
+            }
+        }
+    }
+
+    // 8 bit samples shifted up to 10 bits land within 1 of the 8 bit path
+    const int w = 32, h = 4;
+    const std::vector<uint8_t> y8 = random_with_rails<uint8_t>(w * h, 5);
+    const std::vector<uint8_t> uv8 = random_with_rails<uint8_t>(w * h / 2, 6);
+    std::vector<uint16_t> y10(y8.size()), uv10(uv8.size());
+    for (size_t i = 0; i < y8.size(); i++)
+    {
+        y10[i] = (uint16_t)(y8[i] << 8);
+    }
+    for (size_t i = 0; i < uv8.size(); i++)
+    {
+        uv10[i] = (uint16_t)(uv8[i] << 8);
+    }
+    for (yuv::ColorSpace cs : kSpaces)
+    {
+        std::vector<uint8_t> rgb8(w * h * 3), rgb10(w * h * 3);
+        yuv::nv12_to_rgb(y8.data(), w, uv8.data(), w, rgb8.data(), w * 3, w, h, yuv::LAYOUT_RGB, cs);
+        yuv::p010_to_rgb(y10.data(), w * 2, uv10.data(), w * 2, rgb10.data(), w * 3, w, h, yuv::LAYOUT_RGB, cs);
+        for (size_t i = 0; i < rgb8.size(); i++)
+        {
+            EXPECT_LE(abs(rgb8[i] - rgb10[i]), 1);
+        }
+    }
+}
+
+TEST(yuv, encode_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+        const size_t y_step = w + 3, uv_step = 2 * cw + 5;
+        for (yuv::Layout layout : kLayouts)
+        {
+            const size_t src_step = w * yuv::layout_channels(layout) + 1;
+            const std::vector<uint8_t> src = random_with_rails<uint8_t>(src_step * h, w * 3 + h + layout);
+            for (yuv::ColorSpace cs : kSpaces)
+            {
+                std::vector<uint8_t> y_ref(y_step * h, 7), y(y_ref.size(), 7);
+                std::vector<uint8_t> uv_ref(uv_step * ch * 2, 7), uv(uv_ref.size(), 7);
+
+                yuv::ref::rgb_to_yuv420(src.data(), src_step, layout, y_ref.data(), y_step, uv_ref.data() + 1,
+                                        uv_ref.data(), uv_step, 2, w, h, cs);
+                yuv::rgb_to_nv21(src.data(), src_step, layout, y.data(), y_step, uv.data(), uv_step, w, h, cs);
+                EXPECT_TRUE(same(y_ref, y));
+                EXPECT_TRUE(same(uv_ref, uv));
+
+                yuv::ref::rgb_to_yuv420(src.data(), src_step, layout, y_ref.data(), y_step, uv_ref.data(),
+                                        uv_ref.data() + 1, uv_step, 2, w, h, cs);
+                yuv::rgb_to_nv12(src.data(), src_step, layout, y.data(), y_step, uv.data(), uv_step, w, h, cs);
+                EXPECT_TRUE(same(y_ref, y));
+                EXPECT_TRUE(same(uv_ref, uv));
+
+                uint8_t* u = uv.data();
+                uint8_t* v = uv.data() + uv_step * ch;
+                yuv::ref::rgb_to_yuv420(src.data(), src_step, layout, y_ref.data(), y_step, uv_ref.data(),
+                                        uv_ref.data() + uv_step * ch, uv_step, 1, w, h, cs);
+                yuv::rgb_to_i420(src.data(), src_step, layout, y.data(), y_step, u, v, uv_step, w, h, cs);
+                EXPECT_TRUE(same(y_ref, y));
+                EXPECT_TRUE(same(uv_ref, uv));
+            }
+        }
+    }
+}
+
+TEST(yuv, p010_encode_matches_ref)
+{
+    for (const auto& s : kShapes)
+    {
+        const int w = s[0], h = s[1];
+        const int cw = (w + 1) / 2, ch = (h + 1) / 2;
+        const size_t y_step = (w + 3) * sizeof(uint16_t), uv_step = (2 * cw + 1) * sizeof(uint16_t);
+        for (yuv::Layout layout : kLayouts)
+        {
+            const size_t src_step = w * yuv::layout_channels(layout) + 1;
+            const std::vector<uint8_t> src = random_with_rails<uint8_t>(src_step * h, w * 5 + h + layout);
+            for (yuv::ColorSpace cs : kSpaces)
+            {
+                std::vector<uint16_t> y_ref(y_step / 2 * h, 7), y(y_ref.size(), 7);
+                std::vector<uint16_t> uv_ref(uv_step / 2 * ch, 7), uv(uv_ref.size(), 7);
+                yuv::ref::rgb_to_p010(src.data(), src_step, layout, y_ref.data(), y_step, uv_ref.data(), uv_step, w,
+                                      h, cs);
+                yuv::rgb_to_p010(src.data(), src_step, layout, y.data(), y_step, uv.data(), uv_step, w, h, cs);
+                EXPECT_TRUE(same(y_ref, y));
+                EXPECT_TRUE(same(uv_ref, uv));
+            }
+        }
+    }
+}
+
+TEST(yuv, encode_matches_bt601_bt709)
+{
+    // OpenCV has no BGR to NV21 encoder (convert_bgr_to_nv21 in
+    // opencv_helper.hpp is a stub), so the golden values are the BT.601 /
+    // BT.709 equations in exact arithmetic, rounded half up, for flat frames
+    // of black, white, the primaries, the secondaries and mid gray. P010 is
+    // 4 times the 8 bit equations, full range included (Y up to 1020).
+    const uint8_t rgb[9][3] = {
+        { 0, 0, 0 },     { 255, 255, 255 }, { 255, 0, 0 },   { 0, 255, 0 },     { 0, 0, 255 },
+        { 255, 255, 0 }, { 0, 255, 255 },   { 255, 0, 255 }, { 128, 128, 128 },
+    };
+    // Y, U, V per color, kSpaces order
+    const uint8_t yuv8[4][9][3] = {
+        { { 16, 128, 128 }, { 235, 128, 128 }, { 81, 90, 240 }, { 145, 54, 34 }, { 41, 240, 110 }, { 210, 16, 146 },
+          { 170, 166, 16 }, { 106, 202, 222 }, { 126, 128, 128 } },
+        { { 0, 128, 128 }, { 255, 128, 128 }, { 76, 85, 255 }, { 150, 44, 21 }, { 29, 255, 107 }, { 226, 1, 149 },
+          { 179, 171, 1 }, { 105, 212, 235 }, { 128, 128, 128 } },
+        { { 16, 128, 128 }, { 235, 128, 128 }, { 63, 102, 240 }, { 173, 42, 26 }, { 32, 240, 118 }, { 219, 16, 138 },
+          { 188, 154, 16 }, { 78, 214, 230 }, { 126, 128, 128 } },
+        { { 0, 128, 128 }, { 255, 128, 128 }, { 54, 99, 255 }, { 182, 30, 12 }, { 18, 255, 116 }, { 237, 1, 140 },
+          { 201, 157, 1 }, { 73, 226, 244 }, { 128, 128, 128 } },
+    };
+    const uint16_t yuv10[4][9][3] = {
+        { { 64, 512, 512 }, { 940, 512, 512 }, { 326, 361, 960 }, { 578, 215, 137 }, { 164, 960, 439 },
+          { 840, 64, 585 }, { 678, 663, 64 }, { 426, 809, 887 }, { 504, 512, 512 } },
+        { { 0, 512, 512 }, { 1020, 512, 512 }, { 305, 340, 1022 }, { 599, 174, 85 }, { 116, 1022, 429 },
+          { 904, 2, 595 }, { 715, 684, 2 }, { 421, 850, 939 }, { 512, 512, 512 } },
+        { { 64, 512, 512 }, { 940, 512, 512 }, { 250, 409, 960 }, { 691, 167, 105 }, { 127, 960, 471 },
+          { 877, 64, 553 }, { 754, 615, 64 }, { 313, 857, 919 }, { 504, 512, 512 } },
+        { { 0, 512, 512 }, { 1020, 512, 512 }, { 217, 395, 1022 }, { 730, 119, 49 }, { 74, 1022, 465 },
+          { 946, 2, 559 }, { 803, 629, 2 }, { 290, 905, 975 }, { 512, 512, 512 } },
+    };
+    // 16 pixels for the vector path and 2 for the scalar one
+    const int w = 18, h = 2;
+    for (int s = 0; s < 4; s++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            std::vector<uint8_t> bgr(w * h * 3);
+            for (int i = 0; i < w * h; i++)
+            {
+                bgr[i * 3 + 0] = rgb[c][2];
+                bgr[i * 3 + 1] = rgb[c][1];
+                bgr[i * 3 + 2] = rgb[c][0];
+            }
+            std::vector<uint8_t> y8(w * h), vu(w);
+            yuv::rgb_to_nv21(bgr.data(), w * 3, yuv::LAYOUT_BGR, y8.data(), w, vu.data(), w, w, h, kSpaces[s]);
+            std::vector<uint16_t> y10(w * h), uv10(w);
+            yuv::rgb_to_p010(bgr.data(), w * 3, yuv::LAYOUT_BGR, y10.data(), w * 2, uv10.data(), w * 2, w, h,
+                             kSpaces[s]);
+            for (int i = 0; i < w * h; i++)
+            {
+                EXPECT_EQ(y8[i], yuv8[s][c][0]);
+                EXPECT_EQ(y10[i], yuv10[s][c][0] << 6);
+            }
+            for (int i = 0; i < w; i += 2)
+            {
+                EXPECT_EQ(vu[i], yuv8[s][c][2]);
+                EXPECT_EQ(vu[i + 1], yuv8[s][c][1]);
+                EXPECT_EQ(uv10[i], yuv10[s][c][1] << 6);
+                EXPECT_EQ(uv10[i + 1], yuv10[s][c][2] << 6);
+            }
+        }
+    }
+}
+
+TEST(yuv, round_trip)
+{
+    // flat 2x2 blocks of random colors survive encode + decode within the
+    // quantization of each range; limited range has fewer levels
+    const int w = 34, h = 6;
+    std::vector<uint8_t> rgb(w * h * 3);
+    std::mt19937 rng(3);
+    for (int by = 0; by < h; by += 2)
+    {
+        for (int bx = 0; bx < w; bx += 2)
+        {
+            const uint8_t c[3] = { (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng() };
+            for (int i = 0; i < 4; i++)
+            {
+                memcpy(&rgb[((by + i / 2) * w + bx + i % 2) * 3], c, 3);
+            }
+        }
+    }
+    for (yuv::ColorSpace cs : kSpaces)
+    {
+        const int tolerance = cs == yuv::BT601_FULL || cs == yuv::BT709_FULL ? 2 : 3;
+        std::vector<uint8_t> y(w * h), vu(w * h / 2), back(rgb.size());
+        yuv::rgb_to_nv21(rgb.data(), w * 3, yuv::LAYOUT_RGB, y.data(), w, vu.data(), w, w, h, cs);
+        yuv::nv21_to_rgb(y.data(), w, vu.data(), w, back.data(), w * 3, w, h, yuv::LAYOUT_RGB, cs);
+        for (size_t i = 0; i < rgb.size(); i++)
+        {
+            EXPECT_LE(abs(rgb[i] - back[i]), tolerance);
+        }
+
+        // P010 keeps two more bits each way
+        std::vector<uint16_t> y10(w * h), uv10(w * h / 2);
+        yuv::rgb_to_p010(rgb.data(), w * 3, yuv::LAYOUT_RGB, y10.data(), w * 2, uv10.data(), w * 2, w, h, cs);
+        yuv::p010_to_rgb(y10.data(), w * 2, uv10.data(), w * 2, back.data(), w * 3, w, h, yuv::LAYOUT_RGB, cs);
+        for (size_t i = 0; i < rgb.size(); i++)
+        {
+            EXPECT_LE(abs(rgb[i] - back[i]), 1);
+        }
+    }
+
+    // gray stays gray: every chroma row of the matrices sums to zero
+    const uint8_t gray[2 * 2 * 4] = { 90, 90, 90, 0, 90, 90, 90, 0, 90, 90, 90, 0, 90, 90, 90, 0 };
+    uint8_t y[4], u, v;
+    yuv::rgb_to_i420(gray, 8, yuv::LAYOUT_BGRA, y, 2, &u, &v, 1, 2, 2, yuv::BT709_LIMITED);
+    EXPECT_EQ(u, 128);
+    EXPECT_EQ(v, 128);
+    EXPECT_EQ(y[3], 93); // 16 + 90 * 219 / 255
+}
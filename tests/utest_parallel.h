@@ -0,0 +1,500 @@
+/*
+ * Parallel / sharded driver for utest.h test cases.
+ *
+ * All test_*.cpp files are linked into one executable; this header replaces
+ * UTEST_MAIN() with a runner that can split the registered test cases across
+ * worker threads (or forked worker processes) and across ctest shards.
+ *
+ * Usage, in exactly one source file:
+ *
+ *     UTEST_STATE();
+ *     int main(int argc, const char* const argv[])
+ *     {
+ *         return utest_parallel_main(argc, argv);
+ *     }
+ *
+ * Command line options:
+ *     --jobs=<n>          run test cases on n workers (0: one per hardware thread)
+ *     --fork              run every test case in its own child process (POSIX only),
+ *                         a crashing case is then reported as failed instead of
+ *                         taking the whole run down
+ *     --shard=<i>/<n>     only run the i-th of n interleaved slices of the test cases
+ *     --filter=<filter>   same syntax as utest.h
+ *     --list-tests        print selected test names, one per line
+ *     --junit=<file>      write a JUnit XML report (--output=<file> is an alias)
+ *     --json=<file>       write a JSON report
+ */
+
+#pragma once
+
+#include "utest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define UTEST_PARALLEL_HAS_FORK 1
+#else
+#define UTEST_PARALLEL_HAS_FORK 0
+#endif
+
+struct utest_parallel_result
+{
+    size_t test;  // index into utest_state.tests
+    int status;   // UTEST_TEST_PASSED / UTEST_TEST_FAILURE / UTEST_TEST_SKIPPED
+    utest_int64_t ns;
+    std::string message;
+};
+
+struct utest_parallel_options
+{
+    const char* filter = UTEST_NULL;
+    const char* junit = UTEST_NULL;
+    const char* json = UTEST_NULL;
+    unsigned jobs = 1;
+    unsigned shard_index = 0;
+    unsigned shard_count = 1;
+    bool use_fork = false;
+    bool list_only = false;
+};
+
+static inline bool utest_parallel_starts_with(const char* s, const char* prefix)
+{
+    return 0 == strncmp(s, prefix, strlen(prefix));
+}
+
+/// @return 0 on success, otherwise a non-zero value and a message on stderr
+static inline int utest_parallel_parse(int argc, const char* const argv[], utest_parallel_options& opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (utest_parallel_starts_with(arg, "--help"))
+        {
+            printf("Command line Options:\n"
+                   "  --jobs=<n>          Run test cases on n workers (0: one per hardware thread).\n"
+                   "  --fork              Run every test case in its own child process.\n"
+                   "  --shard=<i>/<n>     Only run the i-th of n slices of the test cases.\n"
+                   "  --filter=<filter>   Filter the test cases to run (EG. vadd* or vadd.s8).\n"
+                   "  --list-tests        List selected test names, one per line.\n"
+                   "  --junit=<file>      Write a JUnit XML report (alias: --output=<file>).\n"
+                   "  --json=<file>       Write a JSON report.\n");
+            return 1;
+        }
+        else if (utest_parallel_starts_with(arg, "--jobs="))
+        {
+            opt.jobs = (unsigned)strtoul(arg + strlen("--jobs="), UTEST_NULL, 10);
+            if (opt.jobs == 0)
+            {
+                opt.jobs = std::max(1u, std::thread::hardware_concurrency());
+            }
+        }
+        else if (utest_parallel_starts_with(arg, "--fork"))
+        {
+#if UTEST_PARALLEL_HAS_FORK
+            opt.use_fork = true;
+#else
+            fprintf(stderr, "--fork is not supported on this platform, using threads\n");
+#endif
+        }
+        else if (utest_parallel_starts_with(arg, "--shard="))
+        {
+            unsigned index = 0;
+            unsigned count = 0;
+            if (2 != sscanf(arg + strlen("--shard="), "%u/%u", &index, &count) || count == 0 || index >= count)
+            {
+                fprintf(stderr, "invalid %s, expected --shard=<i>/<n> with 0 <= i < n\n", arg);
+                return 2;
+            }
+            opt.shard_index = index;
+            opt.shard_count = count;
+        }
+        else if (utest_parallel_starts_with(arg, "--filter="))
+        {
+            opt.filter = arg + strlen("--filter=");
+        }
+        else if (utest_parallel_starts_with(arg, "--list-tests"))
+        {
+            opt.list_only = true;
+        }
+        else if (utest_parallel_starts_with(arg, "--junit="))
+        {
+            opt.junit = arg + strlen("--junit=");
+        }
+        else if (utest_parallel_starts_with(arg, "--output="))
+        {
+            opt.junit = arg + strlen("--output=");
+        }
+        else if (utest_parallel_starts_with(arg, "--json="))
+        {
+            opt.json = arg + strlen("--json=");
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s, see --help\n", arg);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+static inline int utest_parallel_run_one(size_t test, std::string& message)
+{
+    int result = UTEST_TEST_PASSED;
+    try
+    {
+        utest_state.tests[test].func(&result, utest_state.tests[test].index);
+    }
+    catch (const std::exception& err)
+    {
+        message = std::string("exception: ") + err.what();
+        result = UTEST_TEST_FAILURE;
+    }
+    catch (...)
+    {
+        message = "exception: unknown";
+        result = UTEST_TEST_FAILURE;
+    }
+    return result;
+}
+
+static inline const char* utest_parallel_status_name(int status)
+{
+    switch (status)
+    {
+    case UTEST_TEST_PASSED: return "passed";
+    case UTEST_TEST_SKIPPED: return "skipped";
+    default: return "failed";
+    }
+}
+
+static inline void utest_parallel_report(const utest_parallel_result& r)
+{
+    const char* tag = "[       OK ]";
+    if (r.status == UTEST_TEST_FAILURE)
+    {
+        tag = "[  FAILED  ]";
+    }
+    else if (r.status == UTEST_TEST_SKIPPED)
+    {
+        tag = "[  SKIPPED ]";
+    }
+    printf("%s %s (%" UTEST_PRId64 "ns)%s%s\n", tag, utest_state.tests[r.test].name, r.ns,
+           r.message.empty() ? "" : " ", r.message.c_str());
+    fflush(stdout);
+}
+
+/// Threads share one queue; each test case result only ever touches its own slot.
+static inline void utest_parallel_run_threads(std::vector<utest_parallel_result>& results, unsigned jobs)
+{
+    std::atomic<size_t> next(0);
+    std::mutex print_mutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < results.size(); i = next++)
+        {
+            utest_parallel_result& r = results[i];
+            const utest_int64_t start = utest_ns();
+            r.status = utest_parallel_run_one(r.test, r.message);
+            r.ns = utest_ns() - start;
+            std::lock_guard<std::mutex> lock(print_mutex);
+            utest_parallel_report(r);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < jobs; t++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+}
+
+#if UTEST_PARALLEL_HAS_FORK
+/// The parent stays single threaded and keeps at most `jobs` children alive,
+/// each child runs exactly one test case and reports through its exit status.
+static inline void utest_parallel_run_forked(std::vector<utest_parallel_result>& results, unsigned jobs)
+{
+    std::vector<pid_t> pids(results.size(), -1);
+    std::vector<utest_int64_t> starts(results.size(), 0);
+    size_t launched = 0;
+    size_t running = 0;
+
+    while (launched < results.size() || running > 0)
+    {
+        while (running < jobs && launched < results.size())
+        {
+            fflush(stdout);
+            fflush(stderr);
+            starts[launched] = utest_ns();
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                std::string message;
+                const int status = utest_parallel_run_one(results[launched].test, message);
+                if (!message.empty())
+                {
+                    printf("%s\n", message.c_str());
+                }
+                fflush(stdout);
+                _exit(status);
+            }
+            if (pid < 0)
+            {
+                results[launched].status = UTEST_TEST_FAILURE;
+                results[launched].message = "fork() failed";
+                utest_parallel_report(results[launched]);
+            }
+            else
+            {
+                pids[launched] = pid;
+                running++;
+            }
+            launched++;
+        }
+
+        int wstatus = 0;
+        const pid_t done = waitpid(-1, &wstatus, 0);
+        if (done < 0)
+        {
+            break;
+        }
+        const size_t i = std::find(pids.begin(), pids.end(), done) - pids.begin();
+        if (i == pids.size())
+        {
+            continue;
+        }
+        running--;
+        utest_parallel_result& r = results[i];
+        r.ns = utest_ns() - starts[i];
+        if (WIFEXITED(wstatus))
+        {
+            r.status = WEXITSTATUS(wstatus);
+        }
+        else
+        {
+            r.status = UTEST_TEST_FAILURE;
+            r.message = "crashed with signal " + std::to_string(WIFSIGNALED(wstatus) ? WTERMSIG(wstatus) : 0);
+        }
+        utest_parallel_report(r);
+    }
+}
+#endif // UTEST_PARALLEL_HAS_FORK
+
+// Test names and exception text can hold any character: escape them for an
+// XML attribute or a JSON string.
+static inline std::string utest_parallel_xml_escape(const std::string& s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        switch (s[i])
+        {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        case '\'': out += "&apos;"; break;
+        case '\n': out += "&#10;"; break;
+        default: out += s[i]; break;
+        }
+    }
+    return out;
+}
+
+static inline std::string utest_parallel_json_escape(const std::string& s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        const unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += (char)c;
+        }
+        else if (c < 0x20)
+        {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else
+        {
+            out += (char)c;
+        }
+    }
+    return out;
+}
+
+static inline void utest_parallel_write_junit(const char* path, const std::vector<utest_parallel_result>& results,
+                                              size_t failed, size_t skipped, utest_int64_t total_ns)
+{
+    FILE* fp = utest_fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "failed to open %s\n", path);
+        return;
+    }
+    fprintf(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(fp, "<testsuites tests=\"%zu\" failures=\"%zu\" skipped=\"%zu\" time=\"%.6f\">\n", results.size(), failed,
+            skipped, total_ns * 1e-9);
+    fprintf(fp, "<testsuite name=\"neon_sim\" tests=\"%zu\" failures=\"%zu\" skipped=\"%zu\" time=\"%.6f\">\n",
+            results.size(), failed, skipped, total_ns * 1e-9);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const utest_parallel_result& r = results[i];
+        const std::string name = utest_state.tests[r.test].name;
+        const size_t dot = name.find('.');
+        fprintf(fp, "  <testcase classname=\"%s\" name=\"%s\" time=\"%.6f\"",
+                utest_parallel_xml_escape(name.substr(0, dot)).c_str(),
+                utest_parallel_xml_escape(name.substr(dot + 1)).c_str(), r.ns * 1e-9);
+        if (r.status == UTEST_TEST_FAILURE)
+        {
+            const std::string message = r.message.empty() ? "failed" : utest_parallel_xml_escape(r.message);
+            fprintf(fp, "><failure message=\"%s\"/></testcase>\n", message.c_str());
+        }
+        else if (r.status == UTEST_TEST_SKIPPED)
+        {
+            fprintf(fp, "><skipped/></testcase>\n");
+        }
+        else
+        {
+            fprintf(fp, "/>\n");
+        }
+    }
+    fprintf(fp, "</testsuite>\n</testsuites>\n");
+    fclose(fp);
+}
+
+static inline void utest_parallel_write_json(const char* path, const std::vector<utest_parallel_result>& results,
+                                             size_t failed, size_t skipped, utest_int64_t total_ns)
+{
+    FILE* fp = utest_fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "failed to open %s\n", path);
+        return;
+    }
+    fprintf(fp, "{\n  \"tests\": %zu,\n  \"failed\": %zu,\n  \"skipped\": %zu,\n  \"time_ns\": %" UTEST_PRId64 ",\n",
+            results.size(), failed, skipped, total_ns);
+    fprintf(fp, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const utest_parallel_result& r = results[i];
+        const std::string name = utest_parallel_json_escape(utest_state.tests[r.test].name);
+        fprintf(fp, "    {\"name\": \"%s\", \"status\": \"%s\", \"time_ns\": %" UTEST_PRId64 "}%s\n", name.c_str(),
+                utest_parallel_status_name(r.status), r.ns, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+}
+
+static inline int utest_parallel_main(int argc, const char* const argv[])
+{
+    utest_parallel_options opt;
+    const int parse_ret = utest_parallel_parse(argc, argv, opt);
+    if (parse_ret != 0)
+    {
+        return parse_ret == 1 ? 0 : parse_ret;
+    }
+
+    // Registration order follows link order, sort by name so shards are stable.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < utest_state.tests_length; i++)
+    {
+        order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [](size_t a, size_t b) { return strcmp(utest_state.tests[a].name, utest_state.tests[b].name) < 0; });
+
+    std::vector<utest_parallel_result> results;
+    size_t position = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (utest_should_filter_test(opt.filter, utest_state.tests[order[i]].name))
+        {
+            continue;
+        }
+        if (position++ % opt.shard_count != opt.shard_index)
+        {
+            continue;
+        }
+        utest_parallel_result r;
+        r.test = order[i];
+        r.status = UTEST_TEST_PASSED;
+        r.ns = 0;
+        results.push_back(r);
+    }
+
+    if (opt.list_only)
+    {
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            printf("%s\n", utest_state.tests[results[i].test].name);
+        }
+        return 0;
+    }
+
+    const unsigned jobs = std::max(1u, std::min<unsigned>(opt.jobs, (unsigned)std::max<size_t>(1, results.size())));
+    printf("[==========] Running %zu test cases (shard %u/%u, %u %s).\n", results.size(), opt.shard_index,
+           opt.shard_count, jobs, opt.use_fork ? "processes" : "threads");
+
+    const utest_int64_t start = utest_ns();
+#if UTEST_PARALLEL_HAS_FORK
+    if (opt.use_fork)
+    {
+        utest_parallel_run_forked(results, jobs);
+    }
+    else
+#endif
+    {
+        utest_parallel_run_threads(results, jobs);
+    }
+    const utest_int64_t total_ns = utest_ns() - start;
+
+    size_t failed = 0;
+    size_t skipped = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        failed += results[i].status == UTEST_TEST_FAILURE;
+        skipped += results[i].status == UTEST_TEST_SKIPPED;
+    }
+
+    printf("[==========] %zu test cases ran (%.3f ms).\n", results.size(), total_ns * 1e-6);
+    printf("[  PASSED  ] %zu tests.\n", results.size() - failed - skipped);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i].status == UTEST_TEST_FAILURE)
+        {
+            printf("[  FAILED  ] %s\n", utest_state.tests[results[i].test].name);
+        }
+    }
+
+    if (opt.junit)
+    {
+        utest_parallel_write_junit(opt.junit, results, failed, skipped, total_ns);
+    }
+    if (opt.json)
+    {
+        utest_parallel_write_json(opt.json, results, failed, skipped, total_ns);
+    }
+
+    for (size_t i = 0; i < utest_state.tests_length; i++)
+    {
+        free(UTEST_PTR_CAST(void*, utest_state.tests[i].name));
+    }
+    free(UTEST_PTR_CAST(void*, utest_state.tests));
+
+    return failed == 0 ? 0 : 1;
+}